@@ -50,19 +50,25 @@
 #if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
 #include <stdint.h>
 extern uint32_t SystemCoreClock;
+void configureTimerForRunTimeStats(void);
+unsigned long getRunTimeCounterValue(void);
+void sys_Stat_Queue_Trace(unsigned long number, unsigned long waiting);
+void sys_Stat_Heap_Trace(void);
 #endif
 #define configUSE_PREEMPTION 1
 #define configSUPPORT_STATIC_ALLOCATION 1
 #define configSUPPORT_DYNAMIC_ALLOCATION 1
+#define configUSE_TICKLESS_IDLE 2
 #define configUSE_IDLE_HOOK 0
 #define configUSE_TICK_HOOK 0
 #define configCPU_CLOCK_HZ (SystemCoreClock)
 #define configTICK_RATE_HZ ((TickType_t)1000)
 #define configMAX_PRIORITIES (9)
 #define configMINIMAL_STACK_SIZE ((uint16_t)128)
-#define configTOTAL_HEAP_SIZE ((size_t)20480)
+#define configTOTAL_HEAP_SIZE ((size_t)1024)
 #define configMAX_TASK_NAME_LEN (16)
 #define configUSE_TRACE_FACILITY 1
+#define configGENERATE_RUN_TIME_STATS 1
 #define configUSE_16_BIT_TICKS 0
 #define configUSE_MUTEXES 1
 #define configQUEUE_REGISTRY_SIZE 8
@@ -147,8 +153,15 @@ standard names. */
 
 #define xPortSysTickHandler SysTick_Handler
 
+/* Definitions needed when configGENERATE_RUN_TIME_STATS is on */
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS configureTimerForRunTimeStats
+#define portGET_RUN_TIME_COUNTER_VALUE getRunTimeCounterValue
+
 /* USER CODE BEGIN Defines */
 /* Section where parameter definitions can be added (for instance, to override default ones in FreeRTOS.h) */
+#define traceQUEUE_SEND(pxQueue) sys_Stat_Queue_Trace((pxQueue)->uxQueueNumber, (pxQueue)->uxMessagesWaiting)          /* 队列峰值深度 */
+#define traceQUEUE_SEND_FROM_ISR(pxQueue) sys_Stat_Queue_Trace((pxQueue)->uxQueueNumber, (pxQueue)->uxMessagesWaiting) /* 队列峰值深度 */
+#define traceMALLOC(pvAddress, uiSize) sys_Stat_Heap_Trace()                                                          /* 堆历史最小剩余 heap_2 无此统计 */
 /* USER CODE END Defines */
 
 #endif /* FREERTOS_CONFIG_H */
@@ -69,6 +69,12 @@ eBarcodeState barcode_Motor_Init(void);
 uint8_t barcode_Motor_Reset_Pos(void);
 
 eBarcodeState barcode_Motor_Run_By_Index(eBarcodeIndex index);
+eBarcodeState barcode_Motor_Run_By_Index_Start(eBarcodeIndex index);
+eBarcodeState barcode_Motor_Run_Wait(void);
+
+void barcode_Serial_RX_Cplt_FromISR(void);
+void barcode_Serial_IRQ_RX_Deal(void);
+void barcode_Serial_RX_Error_FromISR(void);
 
 eBarcodeState barcode_Scan_By_Index(eBarcodeIndex index);
 eBarcodeState barcode_Scan_QR(void);
@@ -0,0 +1,38 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __BOOT_H
+#define __BOOT_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Private includes ----------------------------------------------------------*/
+
+/* Exported macro ------------------------------------------------------------*/
+#define BOOT_TAG_STAT 0x10 /* 调试系统控制 启动统计 回应标识 */
+
+#define BOOT_BIT_PARAM (1 << 0)   /* 存储任务 外部Flash初始化 参数加载完成 */
+#define BOOT_BIT_TEMP (1 << 1)    /* 杂项任务 温度ADC首次转换完成 */
+#define BOOT_BIT_HEATER (1 << 2)  /* 加热定时器 过冲参数初始化 加热输出启动 */
+#define BOOT_BIT_BARCODE (1 << 3) /* 杂项任务 扫码模块配置完成 */
+#define BOOT_BIT_MOTOR (1 << 4)   /* 电机任务 电机驱动初始化 复位完成 */
+#define BOOT_BIT_NUM 5            /* 就绪事件数 */
+
+#define BOOT_BITS_READY (BOOT_BIT_PARAM | BOOT_BIT_TEMP) /* 可上送就绪帧 温度与参数有效 其余在后台继续 */
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported functions prototypes ---------------------------------------------*/
+void boot_Init(void);
+void boot_Scheduler_Mark(void);
+
+void boot_Mark(EventBits_t bits);
+uint8_t boot_Is_Ready(EventBits_t bits);
+EventBits_t boot_Wait(EventBits_t bits, TickType_t timeout);
+
+uint8_t boot_Stat_Pack(uint8_t * pBuffer);
+
+/* Private defines -----------------------------------------------------------*/
+
+#endif
@@ -18,11 +18,21 @@
 #define COMM_DATA_SER_TX_RETRY_WT ((COMM_DATA_SER_TX_RETRY_INT) / (COMM_DATA_SER_TX_RETRY_WC))
 #define COMM_DATA_SER_TX_RETRY_SUM ((COMM_DATA_SER_TX_RETRY_NUM) * (COMM_DATA_SER_TX_RETRY_INT))
 
-#define COMM_DATA_WH_TIMER_PRESCALER (54000 - 1) /* TIMER 6 主频切半 1 mS */
-#define COMM_DATA_WH_TIMER_PERIOD (10000 - 1)    /* 10000C 10 S */
-
-#define COMM_DATA_PD_TIMER_PRESCALER (54000 - 1) /* TIMER 7 主频切半 1 mS */
-#define COMM_DATA_PD_TIMER_PERIOD (400 - 1)      /* 400C 400 mS */
+#define COMM_DATA_WH_TIMER_PRESCALER (54000 - 1)                    /* TIMER 6 主频切半 1 mS */
+#define COMM_DATA_WH_TIMER_PERIOD (COMM_DATA_WH_PERIOD_DEFAULT - 1) /* 10000C 10 S */
+
+#define COMM_DATA_PD_TIMER_PRESCALER (54000 - 1)                   /* TIMER 7 主频切半 1 mS */
+#define COMM_DATA_PD_TIMER_PERIOD (COMM_DATA_PD_DELAY_DEFAULT - 1) /* 400C 400 mS */
+
+#define COMM_DATA_WH_PERIOD_DEFAULT 10000 /* 采样节奏 白板周期 默认 mS */
+#define COMM_DATA_WH_PERIOD_MIN 2000      /* 采样节奏 白板周期 下限 mS */
+#define COMM_DATA_WH_PERIOD_MAX 60000     /* 采样节奏 白板周期 上限 mS 16位定时器 */
+#define COMM_DATA_PD_DELAY_DEFAULT 400    /* 采样节奏 白板至PD间隔 默认 mS */
+#define COMM_DATA_PD_DELAY_MIN 100        /* 采样节奏 白板至PD间隔 下限 mS */
+#define COMM_DATA_PRE_LIGHT_DEFAULT 15000 /* 采样节奏 预先点灯 默认 mS */
+#define COMM_DATA_PRE_LIGHT_MAX 60000     /* 采样节奏 预先点灯 上限 mS */
+#define COMM_DATA_STABLE_POINTS_MAX 10    /* 采样节奏 提前结束 连续稳定点数 上限 */
+#define COMM_DATA_CADENCE_PACK_LEN 9      /* 采样节奏 单项打包长度 */
 
 #define COMM_DATA_LED_VOLTAGE_INIT_610 160 /* 200 */
 #define COMM_DATA_LED_VOLTAGE_INIT_550 700 /* 710 */
@@ -36,6 +46,11 @@
 #define COMM_DATA_LED_VOLTAGE_MAX_550 1000
 #define COMM_DATA_LED_VOLTAGE_MAX_405 80
 
+#define COMM_DATA_LED_TARGET 13000000   /* LED电压校正 白板PD目标值 */
+#define COMM_DATA_LED_TOLERANCE 20000   /* LED电压校正 各通道偏差之和 收敛容差 */
+#define COMM_DATA_LED_OVERFLOW 15000000 /* LED电压校正 白板PD值越限 */
+#define COMM_DATA_LED_SEARCH_MAX 12     /* LED电压校正 每个波长测试次数上限 */
+
 /* Exported types ------------------------------------------------------------*/
 /* 采集板串口 接收数据定义*/
 typedef struct {
@@ -71,6 +86,15 @@ typedef struct {
     uint8_t points_num;
 } sComm_Data_Sample_Conf_Unit;
 
+/* 采样节奏 按测试方法配置 */
+typedef struct {
+    uint16_t wh_period;      /* 白板周期 mS */
+    uint16_t pd_delay;       /* 白板至PD间隔 mS */
+    uint16_t pre_light;      /* 预先点灯 mS */
+    uint8_t stable_points;   /* 提前结束 连续稳定点数 0 不提前结束 */
+    uint8_t stable_permille; /* 提前结束 相邻点相对偏差 千分比 */
+} sComm_Data_Sample_Cadence;
+
 typedef struct {
     sComm_Data_Sample_Conf_Unit conf;
     uint8_t num;
@@ -154,12 +178,17 @@ void gComm_Data_Sample_Max_Point_Clear(void);
 void comm_Data_RecordInit(void);
 uint8_t comm_Data_Get_LED_Voltage();
 uint8_t comm_Data_Set_LED_Voltage(eComm_Data_Sample_Radiant radiant, uint16_t voltage);
+uint16_t comm_Data_LED_Voltage_Seed(eComm_Data_Sample_Radiant radiant);
 uint8_t comm_Data_Check_LED(eComm_Data_Sample_Radiant radiant, uint16_t dac, uint8_t idx);
 uint8_t comm_Data_Wait_Data(uint8_t mask, uint32_t timeout);
 uint8_t comm_Data_Copy_Data_U32(uint8_t mask, uint32_t * pBuffer);
 int16_t gComm_Data_LED_Voltage_Interval_Get(void);
 uint8_t gComm_Data_LED_Voltage_Points_Get(void);
 
+uint8_t comm_Data_Sample_Cadence_Set(eComm_Data_Sample_Assay assay, uint8_t const * pData);
+uint8_t comm_Data_Sample_Cadence_Pack(uint8_t * pBuffer);
+uint32_t comm_Data_Sample_Pre_Light_Get(void);
+
 uint8_t comm_Data_Sample_Start(void);
 uint8_t comm_Data_sample_Start_PD(void);
 uint8_t comm_Data_Sample_Force_Stop(void);
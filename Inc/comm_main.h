@@ -56,8 +56,8 @@ UBaseType_t comm_Main_SendTask_Queue_GetFree(void);
 UBaseType_t comm_Main_SendTask_Queue_GetWaiting_FromISR(void);
 UBaseType_t comm_Main_SendTask_Queue_GetFree_FromISR(void);
 
-BaseType_t comm_Main_SendTask_ErrorInfoQueueEmit(uint16_t * pErrorCode, uint32_t timeout);
-BaseType_t comm_Main_SendTask_ErrorInfoQueueEmitFromISR(uint16_t * pErrorCode);
+BaseType_t comm_Main_SendTask_ErrorInfoQueueEmit(sError_Info * pErrorInfo, uint32_t timeout);
+BaseType_t comm_Main_SendTask_ErrorInfoQueueEmitFromISR(sError_Info * pErrorInfo);
 
 BaseType_t comm_Main_SendTask_ACK_QueueEmitFromISR(uint8_t * pPackIndex);
 
@@ -48,6 +48,7 @@ BaseType_t comm_Out_DMA_TX_Enter_From_ISR(void);
 void comm_Out_DMA_TX_Error_From_ISR(void);
 
 UBaseType_t comm_Out_SendTask_Queue_GetWaiting(void);
+UBaseType_t comm_Out_SendTask_Queue_GetFree_FromISR(void);
 
 BaseType_t comm_Out_SendTask_QueueEmit(uint8_t * pdata, uint8_t length, uint32_t timeout);
 #define comm_Out_SendTask_QueueEmitCover(pdata, length) comm_Out_SendTask_QueueEmit((pdata), (length), (COMM_OUT_SER_TX_RETRY_SUM))
@@ -61,8 +62,8 @@ BaseType_t comm_Out_SendTask_QueueEmitWithBuild(uint8_t cmdType, uint8_t * pData
 
 BaseType_t comm_Out_SendTask_QueueEmitWithBuild_FromISR(uint8_t cmdType, uint8_t * pData, uint8_t length);
 
-BaseType_t comm_Out_SendTask_ErrorInfoQueueEmit(uint16_t * pErrorCode, uint32_t timeout);
-BaseType_t comm_Out_SendTask_ErrorInfoQueueEmitFromISR(uint16_t * pErrorCode);
+BaseType_t comm_Out_SendTask_ErrorInfoQueueEmit(sError_Info * pErrorInfo, uint32_t timeout);
+BaseType_t comm_Out_SendTask_ErrorInfoQueueEmitFromISR(sError_Info * pErrorInfo);
 
 BaseType_t comm_Out_SendTask_ACK_QueueEmitFromISR(uint8_t * pPackIndex);
 BaseType_t comm_Out_Send_ACK_Give_From_ISR(uint8_t packIndex);
@@ -8,6 +8,7 @@
 #include "protocol.h"
 
 /* Exported macro ------------------------------------------------------------*/
+#define ERROR_TAG_STAT 0x0E /* 调试系统控制 故障上送统计 回应标识 */
 
 /* Exported types ------------------------------------------------------------*/
 typedef enum {
@@ -49,6 +50,7 @@ typedef enum {
     eError_Sample_Normailly_Exit = 123,   /* 正常退出测试 */
     eError_Tray_Motor_POS2_Error = 124,   /* 出仓位置异常 */
     eError_Barcode_Content_Empty = 125,   /* 没有任何条码信息 */
+    eError_Scan_UART = 126,               /* 扫码串口DMA中断处理发生串口异常 附加错误码 (硬件故障码 << 10 + eError_Scan_UART) */
 
     /* 执行异常 */
     eError_Motor_Heater_Timeout_Up = 200,             /* 上加热体电机运动超时 上升方向 */
@@ -98,6 +100,8 @@ typedef enum {
     eError_LED_Correct_Max_Retry_610 = 244,           /* 校正 610 LED 时达到最大尝试次数 */
     eError_LED_Correct_Max_Retry_550 = 245,           /* 校正 550 LED 时达到最大尝试次数 */
     eError_LED_Correct_Max_Retry_405 = 246,           /* 校正 405 LED 时达到最大尝试次数 */
+    eError_Motor_Interlock = 247,                     /* 电机运动位置联锁条件不满足 */
+    eError_Tray_Motor_Pos_Mismatch = 248,             /* 托盘原点光耦状态与记录位置不符 */
 
     /* 周期性上送异常 */
     eError_Temperature_Top_Abnormal = 300, /* 上加热体温度异常 */
@@ -112,11 +116,23 @@ typedef enum {
     eError_Out_Flash_Unknow = 401,   /* 外部Flash型号无法识别 */
 } eError_Code;
 
+/* 故障上送信息 串口错误信息队列单元 */
+typedef struct {
+    uint16_t code;  /* 错误码 */
+    uint16_t count; /* 合并次数 1 为单次上送 */
+    uint16_t span;  /* 合并时段 mS */
+} sError_Info;
+
 /* Exported constants --------------------------------------------------------*/
 
 /* Exported functions prototypes ---------------------------------------------*/
 void error_Emit(eError_Code code);
 void error_Emit_FromISR(eError_Code code);
+void error_Rate_Deal(void);
+uint8_t error_Info_Pack(sError_Info const * pInfo, uint8_t * pBuffer);
+
+uint8_t error_Stat_Pack(uint8_t * pBuffer);
+void error_Stat_Clear(void);
 
 /* Private defines -----------------------------------------------------------*/
 
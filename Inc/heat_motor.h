@@ -18,6 +18,8 @@
 /* Exported functions prototypes ---------------------------------------------*/
 eMotorDir gHeat_Motor_Dir_Get(void);
 
+void heat_Motor_Profile_Init(void);
+
 void heat_Motor_Active(void);
 void heat_Motor_Deactive(void);
 
@@ -27,6 +29,7 @@ uint8_t heat_Motor_Run(eMotorDir dir, uint32_t timeout);
 uint8_t heat_Motor_Wait_Stop(uint32_t timeout);
 uint8_t heat_Motor_PWM_Gen_Up(void);
 uint8_t heat_Motor_PWM_Gen_Down(void);
+void heat_Motor_OPT_ISR_Deal(void);
 
 /* Private defines -----------------------------------------------------------*/
 
@@ -80,6 +80,8 @@ void heater_Overshoot_Flag_Set(eHeater_Index idx, uint8_t flag);
 uint8_t heater_Outdoor_Flag_Get(eHeater_Index idx);
 void heater_Outdoor_Flag_Set(eHeater_Index idx, uint8_t flag);
 
+void heater_Output_Release(void);
+
 float heater_BTM_Setpoint_Get(void);
 void heater_BTM_Setpoint_Set(float setpoint);
 void heater_BTM_Output_Ctl(float pr);
@@ -40,6 +40,7 @@ void led_Mode_Set(eLED_Mode mode);
 eLED_Mode led_Mode_Get(void);
 
 void led_Out_Deal(TickType_t inTick);
+uint32_t led_Out_Next(TickType_t inTick);
 
 /* Private defines -----------------------------------------------------------*/
 
@@ -13,7 +13,10 @@
 #define STEP_TIM_RCR (1 - 1)
 #define STEP_TIM_PUL (0xFFF)
 
+#define M_DRV8824_STAT_LEN (2 * 5 * 4) /* PWM资源占用统计 打包长度 */
+
 /* Exported types ------------------------------------------------------------*/
+/* 两路驱动共用 STEP 管脚 PE9(TIM1_CH1) 由使能管脚选择 同一时刻只能驱动其中一路 */
 typedef enum {
     eM_DRV8824_Index_0 = 0,
     eM_DRV8824_Index_1 = 1,
@@ -31,6 +34,11 @@ uint8_t m_drv8824_release(void);
 uint8_t m_drv8824_release_ISR(void);
 uint8_t m_drv8824_Index_Switch(eM_DRV8824_Index index, uint32_t timeout);
 uint8_t m_drv8824_Clear_Flag(void);
+uint8_t m_drv8824_Wait_Done(uint32_t timeout);
+uint8_t m_drv8824_Stop_ISR(eM_DRV8824_Index index);
+
+uint8_t m_drv8824_Stat_Pack(uint8_t * pBuffer);
+void m_drv8824_Stat_Clear(void);
 
 uint32_t gPWM_TEST_AW_CNT_Get(void);
 void gPWM_TEST_AW_CNT_Inc(void);
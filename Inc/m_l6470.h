@@ -399,12 +399,18 @@ uint8_t dSPIN_Write_Byte(uint8_t byte);
 
 /** @} */
 
+#define M_L6470_STAT_LEN (2 * 4 * 4) /* SPI总线使用统计 打包长度 */
+
 void m_l6470_Params_Init(void);
 uint8_t m_l6470_Init(void);
 uint8_t m_l6470_release(void);
 uint8_t m_l6470_Index_Switch(eM_L6470_Index index, uint32_t tiemout);
 void m_l6470_Reset_HW(void);
 
+uint8_t m_l6470_Set_Param(dSPIN_Registers_TypeDef param, uint32_t value);
+uint8_t m_l6470_Stat_Pack(uint8_t * pBuffer);
+void m_l6470_Stat_Clear(void);
+
 #endif /* __DSPIN_H */
 
 /******************* (C) COPYRIGHT 2013 STMicroelectronics *****END OF FILE****/
@@ -72,7 +72,6 @@ void Error_Handler(void);
 
 /* USER CODE BEGIN EFP */
 BaseType_t Miscellaneous_Task_Notify(uint32_t notify);
-uint8_t Miscellaneous_Task_Is_Busy(void);
 void FL_Error_Handler(char * file, int line);
 uint8_t GetHardwareVersion(void);
 
@@ -84,6 +83,7 @@ uint8_t GetHardwareVersion(void);
 #define OPTSW_OUT2_EXTI_IRQn EXTI2_IRQn
 #define OPTSW_OUT3_Pin GPIO_PIN_3
 #define OPTSW_OUT3_GPIO_Port GPIOE
+#define OPTSW_OUT3_EXTI_IRQn EXTI3_IRQn
 #define OPTSW_OUT4_Pin GPIO_PIN_4
 #define OPTSW_OUT4_GPIO_Port GPIOE
 #define BUZZ_ON_Pin GPIO_PIN_6
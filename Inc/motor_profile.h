@@ -0,0 +1,59 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MOTOR_PROFILE_H
+#define __MOTOR_PROFILE_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Private includes ----------------------------------------------------------*/
+
+/* Exported macro ------------------------------------------------------------*/
+#define MOTOR_PROFILE_TIM_CLK (108000000.0)                     /* TIM1 计数时钟 */
+#define MOTOR_PROFILE_TABLE_LEN (320)                           /* 单条曲线最大burst数目 */
+#define MOTOR_PROFILE_FREQ_MIN (MOTOR_PROFILE_TIM_CLK / 0xFFFF) /* 周期不超过16位ARR */
+#define MOTOR_PROFILE_FREQ_MAX (MOTOR_PROFILE_TIM_CLK / 1000)   /* 周期下限 */
+#define MOTOR_PROFILE_CONF_LEN (3 + 4 * 4)                      /* 协议中单条曲线配置长度 */
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum {
+    eMotor_Profile_Type_Sigmoid,   /* 原有S型函数曲线 默认 */
+    eMotor_Profile_Type_Trapezoid, /* 梯形 恒加速度 */
+    eMotor_Profile_Type_SCurve,    /* S曲线 加加速度受限 */
+    eMotor_Profile_Type_Num,
+} eMotor_Profile_Type;
+
+typedef enum {
+    eMotor_Profile_Index_White_PD,  /* 白板电机 PD方向 */
+    eMotor_Profile_Index_White_WH,  /* 白板电机 白板方向 */
+    eMotor_Profile_Index_Heat_Up,   /* 上加热体电机 向上 */
+    eMotor_Profile_Index_Heat_Down, /* 上加热体电机 向下 */
+    eMotor_Profile_Index_Num,
+} eMotor_Profile_Index;
+
+/* 运动曲线配置 速度单位 步/秒 */
+typedef struct {
+    uint8_t type;   /* 曲线类型 eMotor_Profile_Type */
+    uint8_t dec;    /* 0 不减速 1 在规划长度末端对称减速 */
+    float freq_min; /* 起步/停止频率 */
+    float freq_max; /* 最大频率 */
+    float acc;      /* 最大加速度 步/秒^2 */
+    float jerk;     /* 加加速度 步/秒^3 仅S曲线使用 */
+} sMotor_Profile_Conf;
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported functions prototypes ---------------------------------------------*/
+void motor_Profile_Register(eMotor_Profile_Index idx, sMotor_Profile_Conf const * pConf, uint16_t unt, uint16_t sum);
+uint8_t motor_Profile_Conf_Set(eMotor_Profile_Index idx, sMotor_Profile_Conf const * pConf);
+uint8_t motor_Profile_Conf_Get(eMotor_Profile_Index idx, sMotor_Profile_Conf * pConf);
+uint8_t motor_Profile_Conf_Pack(eMotor_Profile_Index idx, uint8_t * pBuffer);
+uint8_t motor_Profile_Conf_Unpack(uint8_t * pBuffer, uint8_t length);
+
+void motor_Profile_Prepare(eMotor_Profile_Index idx);
+uint8_t motor_Profile_Is_Sigmoid(eMotor_Profile_Index idx);
+uint16_t motor_Profile_Period(eMotor_Profile_Index idx, uint16_t cnt);
+uint32_t motor_Profile_Duration(eMotor_Profile_Index idx);
+
+/* Private defines -----------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,50 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MOTOR_SCHED_H
+#define __MOTOR_SCHED_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Private includes ----------------------------------------------------------*/
+
+/* Exported macro ------------------------------------------------------------*/
+#define MOTOR_SCHED_RES_PWM (1 << 0)    /* TIM1 PWM DMA 白板电机与上加热体电机共用 */
+#define MOTOR_SCHED_RES_SPI (1 << 1)    /* L6470 SPI总线 托盘电机与扫码电机共用 */
+#define MOTOR_SCHED_RES_HEATER (1 << 2) /* 上加热体位置 托盘运动期间不可改变 */
+#define MOTOR_SCHED_RES_TRAY (1 << 3)   /* 托盘位置 上加热体砸下期间不可改变 */
+#define MOTOR_SCHED_RES_ALL (MOTOR_SCHED_RES_PWM | MOTOR_SCHED_RES_SPI | MOTOR_SCHED_RES_HEATER | MOTOR_SCHED_RES_TRAY)
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum {
+    eMotor_Sched_Job_Tray,        /* 托盘电机 仅前台占用 */
+    eMotor_Sched_Job_White_PD,    /* 白板电机 PD位置 */
+    eMotor_Sched_Job_White_WH,    /* 白板电机 白板位置 */
+    eMotor_Sched_Job_White_Cycle, /* 白板电机 PD位置后回到白板位置 */
+    eMotor_Sched_Job_Heat_Up,     /* 上加热体电机 抬起 */
+    eMotor_Sched_Job_Heat_Down,   /* 上加热体电机 砸下 */
+    eMotor_Sched_Job_Num,
+} eMotor_Sched_Job;
+
+typedef enum {
+    eMotor_Sched_Result_OK,        /* 执行完成 */
+    eMotor_Sched_Result_Timeout,   /* 等待资源超时 */
+    eMotor_Sched_Result_Interlock, /* 位置联锁条件不满足 */
+    eMotor_Sched_Result_Failed,    /* 运动执行失败 */
+} eMotor_Sched_Result;
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported functions prototypes ---------------------------------------------*/
+void motor_Sched_Init(void);
+
+eMotor_Sched_Result motor_Sched_Claim(eMotor_Sched_Job job, uint32_t timeout);
+void motor_Sched_Release(eMotor_Sched_Job job);
+
+eMotor_Sched_Result motor_Sched_Run(eMotor_Sched_Job job, uint32_t timeout);
+eMotor_Sched_Result motor_Sched_Start(eMotor_Sched_Job job, uint32_t timeout);
+eMotor_Sched_Result motor_Sched_Wait(uint8_t res, uint32_t timeout);
+uint8_t motor_Sched_Is_Busy(uint8_t res);
+
+/* Private defines -----------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,29 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __POWER_H
+#define __POWER_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Private includes ----------------------------------------------------------*/
+
+/* Exported macro ------------------------------------------------------------*/
+#define POWER_TAG_STAT 0x0D       /* 调试系统控制 休眠统计 回应标识 */
+#define POWER_SLEEP_TICK_MAX 1000 /* 单次休眠 节拍数上限 */
+
+/* Exported types ------------------------------------------------------------*/
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported functions prototypes ---------------------------------------------*/
+void power_Init(void);
+
+void power_Wake_IRQ_Handler(void);
+void power_Heater_Trace(void);
+
+uint8_t power_Stat_Pack(uint8_t * pBuffer);
+void power_Stat_Clear(void);
+
+/* Private defines -----------------------------------------------------------*/
+
+#endif
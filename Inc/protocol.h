@@ -42,6 +42,7 @@ typedef enum {
     eProtocolEmitPack_Client_CMD_Correct = 0xC0, /* 校正数据 */
 
     eProtocolEmitPack_Client_CMD_Debug_Motor = 0xD0,        /* 调试用 电机控制 */
+    eProtocolEmitPack_Client_CMD_Debug_Profile = 0xD1,      /* 调试用 电机运动曲线 */
     eProtocolEmitPack_Client_CMD_Debug_Correct = 0xD2,      /* 调试用 循环定标 */
     eProtocolEmitPack_Client_CMD_Debug_Heater = 0xD3,       /* 调试用 加热控制 */
     eProtocolEmitPack_Client_CMD_Debug_Flag = 0xD4,         /* 调试用 标志位设置 */
@@ -134,4 +135,5 @@ void protocol_Temp_Upload_Pause(void);
 void protocol_Temp_Upload_Comm_Set(eProtocol_COMM_Index comm_index, uint8_t sw);
 void protocol_Temp_Upload_Deal(void);
 void protocol_Self_Check_Temp_ALL(void);
+void protocol_Get_Version(uint8_t * pBuff);
 #endif
@@ -6,6 +6,8 @@
 /* Private includes ----------------------------------------------------------*/
 
 /* Exported macro ------------------------------------------------------------*/
+#define SE2707_PACK_MAX_LENGTH (255 + 2) /* 长度字节最大值 + 校验码 */
+#define SE2707_RX_BUFFER_LENGTH 64       /* 异步接收 DMA缓存长度 */
 
 /* Exported types ------------------------------------------------------------*/
 /* CMD list */
@@ -114,12 +116,34 @@ typedef struct {
     uint8_t data;
 } sSE2707_Image_Capture_Param;
 
+/* 完整报文回调 */
+typedef void (*pfSE2707_Pack_Callback)(uint8_t * pPack, uint16_t length);
+
+/* 报文解析器 */
+typedef struct {
+    uint8_t buffer[SE2707_PACK_MAX_LENGTH]; /* 组包缓存 */
+    uint16_t index;                         /* 缓存已有长度 */
+} sSE2707_Parser;
+
+/* 异步接收 */
+typedef struct {
+    UART_HandleTypeDef * volatile puart;        /* 串口句柄 NULL 未启动 */
+    sSE2707_Parser parser;                      /* 报文解析器 */
+    uint8_t rx_buffer[SE2707_RX_BUFFER_LENGTH]; /* DMA 接收缓存 */
+    uint16_t rx_index;                          /* DMA 接收缓存已解析位置 */
+    pfSE2707_Pack_Callback pfCallback;          /* 收到完整报文回调 */
+} sSE2707_Async;
+
 /* Exported constants --------------------------------------------------------*/
 
 /* Exported functions prototypes ---------------------------------------------*/
 uint16_t se2707_checksum_gen(uint8_t * pData, uint16_t length);
 uint8_t se2707_checksum_check(uint8_t * pData, uint16_t length);
 
+void se2707_parser_reset(sSE2707_Parser * pParser);
+uint16_t se2707_parser_feed(sSE2707_Parser * pParser, uint8_t const * pData, uint16_t length, pfSE2707_Pack_Callback pfCallback);
+uint16_t se2707_parser_idle(sSE2707_Parser * pParser, pfSE2707_Pack_Callback pfCallback);
+
 uint16_t se2707_build_pack(uint8_t cmd, eSE2707_Set_Param_status status, uint8_t * pPayload, uint8_t payload_length, uint8_t * pResult);
 uint16_t se2707_build_pack_ack(uint8_t * pResult);
 uint16_t se2707_build_pack_beep_conf(uint8_t beep_code, eSE2707_Set_Param_status status, uint8_t * pResult);
@@ -139,6 +163,13 @@ uint8_t se2707_reset_param(UART_HandleTypeDef * puart, uint32_t timeout, uint8_t
 
 uint8_t se2707_send_cmd(UART_HandleTypeDef * puart, eSE2707_CMD cmd, uint8_t * pPayload, uint8_t payload_length, uint32_t timeout, uint8_t retry);
 
+uint8_t se2707_async_start(UART_HandleTypeDef * puart, pfSE2707_Pack_Callback pfCallback);
+void se2707_async_stop(void);
+uint8_t se2707_async_is_active(UART_HandleTypeDef * puart);
+void se2707_async_rx_idle_FromISR(void);
+void se2707_async_rx_cplt_FromISR(void);
+void se2707_async_rx_error_FromISR(void);
+
 #define se2707_abort_macro_pdf(puart, timeout, retry) se2707_send_cmd((puart), ABORT_MACRO_PDF, NULL, 0, (timeout), (retry))
 
 #define se2707_aim_off(puart, timeout, retry) se2707_send_cmd((puart), AIM_OFF, NULL, 0, (timeout), (retry))
@@ -438,8 +438,10 @@ uint8_t stroge_Conf_CC_O_Data(uint8_t * pBuffer);
 uint8_t stroge_Conf_CC_O_Data_From_B3(uint8_t * pBuffer, uint8_t length);
 eStorgeParamIndex storge_Param_Illumine_CC_Get_Index(uint8_t channel, eComm_Data_Sample_Radiant wave);
 void storge_Param_Illumine_CC_Set_Single(eStorgeParamIndex idx, uint32_t data);
+void storge_Param_Illumine_CC_Set_Stage(uint8_t stage, uint32_t const * pValues);
 
 void storge_Sample_LED_PD_Set(eComm_Data_Sample_Radiant radian, uint8_t idx, uint32_t pd_data, uint16_t dac);
+uint16_t storge_Sample_LED_DAC_Get(eComm_Data_Sample_Radiant radian);
 
 void gStorgeIllumineCnt_Clr(void);
 uint8_t gStorgeIllumineCnt_Check(uint8_t target);
@@ -0,0 +1,93 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SYS_STAT_H
+#define __SYS_STAT_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "protocol.h"
+
+/* Private includes ----------------------------------------------------------*/
+
+/* Exported macro ------------------------------------------------------------*/
+#define SYS_STAT_RUN_TIME_PRESCALER (540 - 1) /* TIMER 5 主频切半 10 uS */
+#define SYS_STAT_RUN_TIME_US 10               /* 运行时间统计 计数单位 uS */
+
+#define SYS_STAT_TAG_TASK 0x0A /* 调试系统控制 任务统计 回应标识 */
+#define SYS_STAT_TAG_IRQ 0x0B  /* 调试系统控制 中断统计 回应标识 */
+#define SYS_STAT_TAG_RES 0x0C  /* 调试系统控制 资源余量 回应标识 */
+
+#define SYS_STAT_IRQ_EN 1     /* 中断统计 使能 */
+#define SYS_STAT_IRQ_BUCKET 8 /* 中断统计 直方图分档数 */
+
+#if SYS_STAT_IRQ_EN
+#define SYS_STAT_IRQ_ENTER(irq) uint32_t sys_stat_irq_start = sys_Stat_IRQ_Enter(irq) /* 中断入口 须在中断函数开头 */
+#define SYS_STAT_IRQ_EXIT(irq) sys_Stat_IRQ_Exit((irq), sys_stat_irq_start)           /* 中断出口 */
+#else
+#define SYS_STAT_IRQ_ENTER(irq)
+#define SYS_STAT_IRQ_EXIT(irq)
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+typedef enum {
+    eSys_Stat_IRQ_EXTI2,
+    eSys_Stat_IRQ_EXTI3,
+    eSys_Stat_IRQ_EXTI4,
+    eSys_Stat_IRQ_DMA1_Stream0,
+    eSys_Stat_IRQ_DMA1_Stream1,
+    eSys_Stat_IRQ_DMA1_Stream5,
+    eSys_Stat_IRQ_DMA1_Stream6,
+    eSys_Stat_IRQ_TIM1_UP_TIM10,
+    eSys_Stat_IRQ_USART1,
+    eSys_Stat_IRQ_USART2,
+    eSys_Stat_IRQ_USART3,
+    eSys_Stat_IRQ_TIM8_TRG_COM_TIM14,
+    eSys_Stat_IRQ_DMA1_Stream7,
+    eSys_Stat_IRQ_TIM5,
+    eSys_Stat_IRQ_UART5,
+    eSys_Stat_IRQ_TIM6_DAC,
+    eSys_Stat_IRQ_TIM7,
+    eSys_Stat_IRQ_DMA2_Stream0,
+    eSys_Stat_IRQ_DMA2_Stream2,
+    eSys_Stat_IRQ_DMA2_Stream5,
+    eSys_Stat_IRQ_DMA2_Stream7,
+    eSys_Stat_IRQ_Num,
+} eSys_Stat_IRQ;
+
+typedef enum {
+    eSys_Stat_Queue_None, /* 队列编号 0 为不统计 */
+    eSys_Stat_Queue_Out_Send,
+    eSys_Stat_Queue_Out_Error,
+    eSys_Stat_Queue_Out_ACK,
+    eSys_Stat_Queue_Main_Send,
+    eSys_Stat_Queue_Main_Error,
+    eSys_Stat_Queue_Main_ACK,
+    eSys_Stat_Queue_Data_Send,
+    eSys_Stat_Queue_Data_ACK,
+    eSys_Stat_Queue_Num,
+} eSys_Stat_Queue;
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported functions prototypes ---------------------------------------------*/
+void sys_Stat_Run_Time_Init(void);
+uint32_t sys_Stat_Run_Time_Get(void);
+
+uint8_t sys_Stat_Task_Pack(uint8_t * pBuffer, uint8_t size);
+BaseType_t sys_Stat_Task_Report_FromISR(eProtocol_COMM_Index index);
+
+void sys_Stat_IRQ_Init(void);
+uint32_t sys_Stat_IRQ_Enter(eSys_Stat_IRQ irq);
+void sys_Stat_IRQ_Exit(eSys_Stat_IRQ irq, uint32_t start);
+void sys_Stat_IRQ_Clear(void);
+BaseType_t sys_Stat_IRQ_Report_FromISR(eProtocol_COMM_Index index);
+
+void sys_Stat_Queue_Register(QueueHandle_t xQueue, eSys_Stat_Queue queue);
+void sys_Stat_Queue_Trace(unsigned long number, unsigned long waiting);
+void sys_Stat_Heap_Trace(void);
+void sys_Stat_Resource_Period_Set(uint8_t period);
+void sys_Stat_Resource_Upload_Deal(void);
+BaseType_t sys_Stat_Resource_Report_FromISR(eProtocol_COMM_Index index);
+
+/* Private defines -----------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,39 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __TIME_WHEEL_H
+#define __TIME_WHEEL_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Private includes ----------------------------------------------------------*/
+
+/* Exported macro ------------------------------------------------------------*/
+#define TIME_WHEEL_TAG_STAT 0x0F /* 调试系统控制 时间轮统计 回应标识 */
+
+/* Exported types ------------------------------------------------------------*/
+/* 任务回调 返回下次间隔 mS 0 停止 */
+typedef uint32_t (*time_Wheel_Fun)(TickType_t now);
+
+/* 时间轮任务 由调用者静态分配 */
+typedef struct sTime_Wheel_Job {
+    struct sTime_Wheel_Job * pNext; /* 同槽链表 */
+    time_Wheel_Fun fun;             /* 回调 */
+    TickType_t expire;              /* 到期时刻 */
+    uint8_t active;                 /* 是否在时间轮中 */
+} sTime_Wheel_Job;
+
+/* Exported constants --------------------------------------------------------*/
+
+/* Exported functions prototypes ---------------------------------------------*/
+void time_Wheel_Init(TickType_t now);
+void time_Wheel_Add(sTime_Wheel_Job * pJob, time_Wheel_Fun fun, uint32_t delay);
+void time_Wheel_Cancel(sTime_Wheel_Job * pJob);
+void time_Wheel_Run(TickType_t now);
+TickType_t time_Wheel_Next(TickType_t now);
+
+uint8_t time_Wheel_Stat_Pack(uint8_t * pBuffer);
+void time_Wheel_Stat_Clear(void);
+
+/* Private defines -----------------------------------------------------------*/
+
+#endif
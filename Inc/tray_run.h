@@ -44,6 +44,13 @@ void tray_Motor_ISR_Deal(void);
 
 void tray_Motor_Scan_Reverse_Clear(void);
 uint8_t tray_Motor_Scan_Reverse_Get(void);
+
+uint8_t tray_Motor_Home(void);
+void tray_Motor_Pos_Confidence_Lost(void);
+uint8_t tray_Motor_Pos_Confidence_Check(uint8_t opt);
+void tray_Motor_Home_Skip_Record(void);
+void tray_Motor_Home_Stat_Test_Clear(void);
+uint8_t tray_Motor_Home_Stat_Pack(uint8_t * pBuffer);
 /* Private defines -----------------------------------------------------------*/
 
 #endif
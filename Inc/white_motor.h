@@ -18,6 +18,8 @@
 /* Exported functions prototypes ---------------------------------------------*/
 eMotorDir gWhite_Motor_Dir_Get(void);
 
+void white_Motor_Profile_Init(void);
+
 void white_Motor_Active(void);
 void white_Motor_Deactive(void);
 
@@ -63,6 +63,12 @@ typedef struct {
 #define BARCODE_UART huart3 /* 扫码串口 */
 #define BARCODE_MOTOR_MAX_GO_UNTIL_SPEED 40000 /* 扫码电机归零最大速度 */
 
+#define BARCODE_RX_FIRST_BIT (1 << 0)                     /* 收到首字节 扫码头已完成解码 */
+#define BARCODE_RX_DONE_BIT (1 << 1)                      /* 帧结束 空闲中断或接收满 */
+#define BARCODE_RX_ERROR_BIT (1 << 2)                     /* 串口异常 */
+#define BARCODE_RX_GUARD_TIME 3                           /* 空闲中断后确认帧结束的等待时间 mS 约3个字符 */
+#define BARCODE_RX_FRAME_TIME(len) ((len)*105 / 100 + 10) /* 9600波特率下帧传输时间上限 mS */
+
 /* Private variables ---------------------------------------------------------*/
 static sMotorRunStatus gBarcodeMotorRunStatus;
 static sMoptorRunCmdInfo gBarcodeMotorRunCmdInfo;
@@ -82,6 +88,15 @@ TaskHandle_t barcodeTaskHandle = NULL;
 
 static uint8_t gBarcodeInterrupt = 0;           /* 打断标志 */
 static sBarcodeCorrectInfo gBarcodeCorrectInfo; /* 条码中抽取的校正点信息 */
+static uint8_t gBarcodeMotorRunPending = 0;     /* 扫码电机运动已启动 未等待完成 */
+static uint8_t gBarcodeMotorRunFast = 0;        /* 按索引运动 两道之内加快运动速度 */
+
+static EventGroupHandle_t barcode_rx_flags = NULL; /* 扫码串口接收事件 */
+static StaticEventGroup_t barcode_rx_flags_Buffer; /* 扫码串口接收事件 静态内存 */
+static uint8_t * gBarcodeRxBuffer = NULL;          /* 接收目标缓存 */
+static uint8_t gBarcodeRxLength = 0;               /* 接收目标长度 */
+static uint8_t gBarcodeRxCount = 0;                /* 接收满或中止时的接收长度 */
+static volatile uint8_t gBarcodeRxStage = 0;       /* 0 未启动 1 等待首字节 2 接收剩余部分 3 接收结束 */
 
 /* Private constants ---------------------------------------------------------*/
 const char BAR_SAM_LDH_[] = "1419190801";
@@ -280,6 +295,32 @@ eBarcodeState barcode_Motor_Enter(void)
     }
 }
 
+/**
+ * @brief  电机运动前回调 按索引运动 配置速度参数
+ * @note   与运动指令在同一次总线占用内完成 参数与影子寄存器相同时不写入
+ * @param  None
+ * @retval 运动结果 0 正常 1 异常
+ */
+static eBarcodeState barcode_Motor_Enter_With_Speed(void)
+{
+    eBarcodeState result;
+
+    result = barcode_Motor_Enter();
+    if (result != eBarcodeState_OK) {
+        return result;
+    }
+    if (gBarcodeMotorRunFast) {
+        m_l6470_Set_Param(dSPIN_ACC, Index_0_dSPIN_CONF_PARAM_ACC * 8 / 4);
+        m_l6470_Set_Param(dSPIN_DEC, Index_0_dSPIN_CONF_PARAM_DEC * 8 / 4);
+        m_l6470_Set_Param(dSPIN_MAX_SPEED, Index_0_dSPIN_CONF_PARAM_MAX_SPEED * 10 / 8);
+    } else {
+        m_l6470_Set_Param(dSPIN_ACC, Index_0_dSPIN_CONF_PARAM_ACC);
+        m_l6470_Set_Param(dSPIN_DEC, Index_0_dSPIN_CONF_PARAM_DEC);
+        m_l6470_Set_Param(dSPIN_MAX_SPEED, Index_0_dSPIN_CONF_PARAM_MAX_SPEED);
+    }
+    return eBarcodeState_OK;
+}
+
 /**
  * @brief  电机运动后回调 光耦位置硬件检测停车
  * @note   光耦位置处重置电机状态记录中步数值 重置电机驱动中步数记录值
@@ -323,11 +364,12 @@ eBarcodeState barcode_Motor_Leave_On_Busy_Bit(void)
 }
 
 /**
- * @brief  扫码电机运动
- * @param  runInfo 运动信息
- * @retval 运动结果 0 正常 1 异常
+ * @brief  扫码电机运动 启动
+ * @note   向驱动发送运动指令后即返回 SPI总线资源保持占用 由 barcode_Motor_Run_Wait 等待完成并释放
+ * @param  None
+ * @retval 启动结果
  */
-eBarcodeState barcode_Motor_Run(void)
+eBarcodeState barcode_Motor_Run_Start(void)
 {
     eBarcodeState result;
 
@@ -363,13 +405,45 @@ eBarcodeState barcode_Motor_Run(void)
     } else {
         dSPIN_Go_Until(ACTION_RESET, FWD, BARCODE_MOTOR_MAX_GO_UNTIL_SPEED);
     }
+    gBarcodeMotorRunPending = 1;
+    return eBarcodeState_OK;
+}
+
+/**
+ * @brief  扫码电机运动 等待完成
+ * @param  None
+ * @retval 运动结果 没有已启动的运动时直接返回正常
+ */
+eBarcodeState barcode_Motor_Run_Wait(void)
+{
+    eBarcodeState result;
 
+    if (gBarcodeMotorRunPending == 0) {
+        return eBarcodeState_OK;
+    }
+    gBarcodeMotorRunPending = 0;
     result = gBarcodeMotorRunCmdInfo.pfLeave(); /* 出口回调 */
     barcode_Motor_Deal_Status();                /* 读取电机驱动状态清除标志 */
     m_l6470_release();                          /* 释放SPI总线资源*/
     return result;
 }
 
+/**
+ * @brief  扫码电机运动
+ * @param  runInfo 运动信息
+ * @retval 运动结果 0 正常 1 异常
+ */
+eBarcodeState barcode_Motor_Run(void)
+{
+    eBarcodeState result;
+
+    result = barcode_Motor_Run_Start();
+    if (result != eBarcodeState_OK) {
+        return result;
+    }
+    return barcode_Motor_Run_Wait();
+}
+
 /**
  * @brief  重置电机状态位置
  * @param  timeout 停车等待超时
@@ -455,11 +529,7 @@ void barcode_Motor_Calculate(uint32_t target_step)
 {
     int32_t current_position;
 
-    current_position = target_step;
-    if (barcode_Motor_Enter() != eBarcodeState_Tiemout) {
-        current_position = motor_Status_Get_Position(&gBarcodeMotorRunStatus);
-        m_l6470_release(); /* 释放SPI总线资源*/
-    }
+    current_position = motor_Status_Get_Position(&gBarcodeMotorRunStatus); /* 电机状态记录 不需要访问驱动 */
     if (target_step >= current_position) {
         motor_CMD_Info_Set_Step(&gBarcodeMotorRunCmdInfo, (target_step - current_position));
         motor_CMD_Info_Set_Dir(&gBarcodeMotorRunCmdInfo, eMotorDir_FWD);
@@ -498,10 +568,15 @@ void barcode_sn2707_Init(void)
     HAL_Delay(5);
     HAL_GPIO_WritePin(BC_AIM_WK_N_GPIO_Port, BC_AIM_WK_N_Pin, GPIO_PIN_SET);
 
+    if (se2707_async_start(&BARCODE_UART, NULL)) { /* 异步接收应答 等待期间不占用CPU */
+        error_Emit(eError_Scan_UART);
+    }
+
     icParam.param = Decode_Aiming_Pattern;
     icParam.data = 0;
     if (barcode_se2707_Param_Sync(icParam)) {  /* 存在错误 */
         error_Emit(eError_Scan_Config_Failed); /* 报错 */
+        se2707_async_stop();
         return;
     }
 
@@ -509,6 +584,7 @@ void barcode_sn2707_Init(void)
     icParam.data = 1;
     if (barcode_se2707_Param_Sync(icParam)) {  /* 存在错误 */
         error_Emit(eError_Scan_Config_Failed); /* 报错 */
+        se2707_async_stop();
         return;
     }
 
@@ -516,6 +592,7 @@ void barcode_sn2707_Init(void)
     icParam.data = 0;
     if (barcode_se2707_Param_Sync(icParam)) {  /* 存在错误 */
         error_Emit(eError_Scan_Config_Failed); /* 报错 */
+        se2707_async_stop();
         return;
     }
 
@@ -523,6 +600,7 @@ void barcode_sn2707_Init(void)
     icParam.data = 105;
     if (barcode_se2707_Param_Sync(icParam)) {  /* 存在错误 */
         error_Emit(eError_Scan_Config_Failed); /* 报错 */
+        se2707_async_stop();
         return;
     }
 
@@ -533,6 +611,8 @@ void barcode_sn2707_Init(void)
     //     esrror_Emit(eError_Scan_Config_Failed); /* 报错 */
     //     return;
     // }
+
+    se2707_async_stop();
 }
 
 /**
@@ -542,154 +622,366 @@ void barcode_sn2707_Init(void)
  */
 void barcode_Init(void)
 {
+    barcode_rx_flags = xEventGroupCreateStatic(&barcode_rx_flags_Buffer);
+    if (barcode_rx_flags == NULL) {
+        Error_Handler();
+    }
     barcode_Result_Init(); /* 扫码结果初始化 */
     barcode_sn2707_Init(); /* 扫码模块硬件初始化 */
 }
 
 /**
- * @brief  扫码
- * @param  pOut_length 读取到的数据长度
- * @param  pdata   结果存放指针
- * @param  timeout 等待时间
- * @param  max_read_length 读取长度
- * @retval 扫码结果
+ * @brief  扫码串口接收事件 置位 中断版本
+ * @param  flag_bits 事件位
+ * @retval None
  */
-eBarcodeState barcode_Read_From_Serial(uint8_t * pOut_length, uint8_t * pData, uint8_t max_read_length, uint32_t timeout)
+static void barcode_Serial_Flags_Set_FromISR(EventBits_t flag_bits)
 {
-    HAL_StatusTypeDef status;
-    eBarcodeState result;
-    uint8_t max_retry = 20;
+    BaseType_t xResult, xHigherPriorityTaskWoken = pdFALSE;
 
-    while (HAL_UART_Receive(&BARCODE_UART, pData, 1, 1) == HAL_OK && max_retry > 0) { /* 清理残余内容 */
-        --max_retry;
+    xResult = xEventGroupSetBitsFromISR(barcode_rx_flags, flag_bits, &xHigherPriorityTaskWoken);
+    if (xResult) {
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
     }
+}
 
-    HAL_GPIO_WritePin(BC_TRIG_N_GPIO_Port, BC_TRIG_N_Pin, GPIO_PIN_RESET);
-    status = HAL_UART_Receive(&BARCODE_UART, pData, max_read_length, pdMS_TO_TICKS(timeout));
-    *pOut_length = max_read_length - BARCODE_UART.RxXferCount;
-    switch (status) {
-        case HAL_TIMEOUT: /* 接收超时 */
-            *pOut_length = max_read_length - BARCODE_UART.RxXferCount - 1;
-            result = eBarcodeState_Tiemout;
+/**
+ * @brief  扫码串口 DMA接收完成中断回调
+ * @note   首字节单独接收 收到即表示扫码头已完成解码 随后在中断内启动剩余部分的接收
+ * @param  None
+ * @retval None
+ */
+void barcode_Serial_RX_Cplt_FromISR(void)
+{
+    if (se2707_async_is_active(&BARCODE_UART)) { /* 模块配置中 */
+        se2707_async_rx_cplt_FromISR();
+        return;
+    }
+    switch (gBarcodeRxStage) {
+        case 1: /* 首字节 */
+            if (gBarcodeRxLength > 1 && HAL_UART_Receive_DMA(&BARCODE_UART, gBarcodeRxBuffer + 1, gBarcodeRxLength - 1) == HAL_OK) {
+                gBarcodeRxStage = 2;
+                barcode_Serial_Flags_Set_FromISR(BARCODE_RX_FIRST_BIT);
+            } else {
+                gBarcodeRxCount = 1;
+                gBarcodeRxStage = 3;
+                barcode_Serial_Flags_Set_FromISR(BARCODE_RX_FIRST_BIT | BARCODE_RX_DONE_BIT);
+            }
             break;
-        case HAL_OK: /* 接收到足够字符串 */
-            *pOut_length = max_read_length;
-            result = eBarcodeState_OK;
+        case 2: /* 接收满 */
+            gBarcodeRxCount = gBarcodeRxLength;
+            gBarcodeRxStage = 3;
+            barcode_Serial_Flags_Set_FromISR(BARCODE_RX_DONE_BIT);
             break;
         default:
-            *pOut_length = 0; /* 故障 HAL_ERROR HAL_BUSY */
-            result = eBarcodeState_Error;
             break;
     }
+}
+
+/**
+ * @brief  扫码串口 空闲中断回调
+ * @note   接收剩余部分期间出现空闲 帧结束或帧内间隔 由任务确认
+ * @param  None
+ * @retval None
+ */
+void barcode_Serial_IRQ_RX_Deal(void)
+{
+    if (se2707_async_is_active(&BARCODE_UART)) { /* 模块配置中 */
+        se2707_async_rx_idle_FromISR();
+        return;
+    }
+    if (gBarcodeRxStage == 2) {
+        barcode_Serial_Flags_Set_FromISR(BARCODE_RX_DONE_BIT);
+    }
+}
+
+/**
+ * @brief  扫码串口 接收异常回调
+ * @note   DMA模式下串口异常时HAL已中止接收
+ * @param  None
+ * @retval None
+ */
+void barcode_Serial_RX_Error_FromISR(void)
+{
+    if (se2707_async_is_active(&BARCODE_UART)) { /* 模块配置中 */
+        se2707_async_rx_error_FromISR();
+        return;
+    }
+    if (gBarcodeRxStage != 0) {
+        barcode_Serial_Flags_Set_FromISR(BARCODE_RX_ERROR_BIT);
+    }
+}
+
+/**
+ * @brief  扫码串口 启动接收并触发扫码
+ * @param  pData   结果存放指针
+ * @param  max_read_length 读取长度
+ * @retval 启动结果
+ */
+static eBarcodeState barcode_Serial_Start(uint8_t * pData, uint8_t max_read_length)
+{
+    HAL_UART_AbortReceive(&BARCODE_UART);
+    xEventGroupClearBits(barcode_rx_flags, BARCODE_RX_FIRST_BIT | BARCODE_RX_DONE_BIT | BARCODE_RX_ERROR_BIT);
+    __HAL_UART_CLEAR_OREFLAG(&BARCODE_UART); /* 清理残余内容 同时清除空闲标志 */
+
+    gBarcodeRxBuffer = pData;
+    gBarcodeRxLength = max_read_length;
+    gBarcodeRxCount = 0;
+    gBarcodeRxStage = 1;
+    if (HAL_UART_Receive_DMA(&BARCODE_UART, pData, 1) != HAL_OK) {
+        gBarcodeRxStage = 0;
+        return eBarcodeState_Error;
+    }
+    __HAL_UART_ENABLE_IT(&BARCODE_UART, UART_IT_IDLE);
+    HAL_GPIO_WritePin(BC_TRIG_N_GPIO_Port, BC_TRIG_N_Pin, GPIO_PIN_RESET);
+    return eBarcodeState_OK;
+}
+
+/**
+ * @brief  扫码串口 等待接收事件
+ * @param  flag_bits 事件位 串口异常总会结束等待
+ * @param  timeout 等待时间 mS
+ * @retval 事件位状态
+ */
+static EventBits_t barcode_Serial_Wait(EventBits_t flag_bits, uint32_t timeout)
+{
+    return xEventGroupWaitBits(barcode_rx_flags, flag_bits | BARCODE_RX_ERROR_BIT, pdFALSE, pdFALSE, pdMS_TO_TICKS(timeout));
+}
+
+/**
+ * @brief  扫码串口 结束接收
+ * @note   已收到首字节时等待帧结束 空闲中断后再等待 BARCODE_RX_GUARD_TIME 无新数据才认为帧结束
+ * @param  pOut_length 读取到的数据长度
+ * @retval 扫码结果
+ */
+static eBarcodeState barcode_Serial_Finish(uint8_t * pOut_length)
+{
+    EventBits_t uxBits;
+    uint8_t stage;
+
+    uxBits = xEventGroupGetBits(barcode_rx_flags);
+    if ((uxBits & (BARCODE_RX_FIRST_BIT | BARCODE_RX_ERROR_BIT)) == BARCODE_RX_FIRST_BIT) {
+        uxBits = barcode_Serial_Wait(BARCODE_RX_DONE_BIT, BARCODE_RX_FRAME_TIME(gBarcodeRxLength));
+        while (gBarcodeRxStage == 2 && (uxBits & BARCODE_RX_DONE_BIT)) { /* 帧内间隔确认 */
+            xEventGroupClearBits(barcode_rx_flags, BARCODE_RX_DONE_BIT);
+            uxBits = barcode_Serial_Wait(BARCODE_RX_DONE_BIT, BARCODE_RX_GUARD_TIME);
+        }
+    }
+
     HAL_GPIO_WritePin(BC_TRIG_N_GPIO_Port, BC_TRIG_N_Pin, GPIO_PIN_SET);
-    return result;
+    __HAL_UART_DISABLE_IT(&BARCODE_UART, UART_IT_IDLE);
+    HAL_UART_AbortReceive(&BARCODE_UART); /* 停止DMA 计数值保持 */
+    stage = gBarcodeRxStage;
+    gBarcodeRxStage = 0;
+
+    switch (stage) {
+        case 2: /* 接收剩余部分中 首字节 + 已接收部分 */
+            *pOut_length = gBarcodeRxLength - __HAL_DMA_GET_COUNTER(BARCODE_UART.hdmarx);
+            break;
+        case 3:
+            *pOut_length = gBarcodeRxCount;
+            break;
+        default:
+            *pOut_length = 0;
+            break;
+    }
+    if (xEventGroupGetBits(barcode_rx_flags) & BARCODE_RX_ERROR_BIT) {
+        *pOut_length = 0; /* 故障 */
+        return eBarcodeState_Error;
+    }
+    return (*pOut_length == gBarcodeRxLength) ? (eBarcodeState_OK) : (eBarcodeState_Tiemout);
 }
 
 /**
- * @brief  扫码执行 按索引 移动电机
+ * @brief  扫码
+ * @note   DMA接收 空闲中断判断帧结束 timeout 为等待扫码头完成解码(首字节)的时间
+ * @param  pOut_length 读取到的数据长度
+ * @param  pdata   结果存放指针
+ * @param  timeout 等待时间
+ * @param  max_read_length 读取长度
+ * @retval 扫码结果
+ */
+eBarcodeState barcode_Read_From_Serial(uint8_t * pOut_length, uint8_t * pData, uint8_t max_read_length, uint32_t timeout)
+{
+    if (barcode_Serial_Start(pData, max_read_length) != eBarcodeState_OK) {
+        *pOut_length = 0; /* 故障 HAL_BUSY */
+        return eBarcodeState_Error;
+    }
+    barcode_Serial_Wait(BARCODE_RX_FIRST_BIT, timeout);
+    return barcode_Serial_Finish(pOut_length);
+}
+
+/**
+ * @brief  扫码执行 按索引 启动电机运动
+ * @note   启动成功后需调用 barcode_Motor_Run_Wait 等待完成
  * @param  index   条码位置索引
- * @retval 扫码结果数据长度
+ * @retval 启动结果
  */
-eBarcodeState barcode_Motor_Run_By_Index(eBarcodeIndex index)
+eBarcodeState barcode_Motor_Run_By_Index_Start(eBarcodeIndex index)
 {
-    motor_CMD_Info_Set_PF_Enter(&gBarcodeMotorRunCmdInfo, barcode_Motor_Enter); /* 配置启动前回调 */
-    motor_CMD_Info_Set_Tiemout(&gBarcodeMotorRunCmdInfo, 1500);                 /* 运动超时时间 1500mS */
+    motor_CMD_Info_Set_PF_Enter(&gBarcodeMotorRunCmdInfo, barcode_Motor_Enter_With_Speed); /* 配置启动前回调 获取总线后配置速度 */
+    motor_CMD_Info_Set_Tiemout(&gBarcodeMotorRunCmdInfo, 1500);                            /* 运动超时时间 1500mS */
     if (index != eBarcodeIndex_0) {
-        barcode_Motor_Calculate((index >> 5) << 3);                                            /* 计算运动距离 及方向 32细分转8细分 */
-        if (gBarcodeMotorRunCmdInfo.step <= ((eBarcodeIndex_1 - eBarcodeIndex_0) >> 5) << 4) { /* 两道之内加快运动速度 */
-            dSPIN_Set_Param(dSPIN_ACC, Index_0_dSPIN_CONF_PARAM_ACC * 8 / 4);
-            dSPIN_Set_Param(dSPIN_DEC, Index_0_dSPIN_CONF_PARAM_DEC * 8 / 4);
-            dSPIN_Set_Param(dSPIN_MAX_SPEED, Index_0_dSPIN_CONF_PARAM_MAX_SPEED * 10 / 8);
-        } else {
-            dSPIN_Set_Param(dSPIN_ACC, Index_0_dSPIN_CONF_PARAM_ACC);
-            dSPIN_Set_Param(dSPIN_DEC, Index_0_dSPIN_CONF_PARAM_DEC);
-            dSPIN_Set_Param(dSPIN_MAX_SPEED, Index_0_dSPIN_CONF_PARAM_MAX_SPEED);
-        }
-        motor_CMD_Info_Set_PF_Leave(&gBarcodeMotorRunCmdInfo, barcode_Motor_Leave_On_Busy_Bit); /* 等待驱动状态位空闲 */
+        barcode_Motor_Calculate((index >> 5) << 3);                                                               /* 计算运动距离 及方向 32细分转8细分 */
+        gBarcodeMotorRunFast = (gBarcodeMotorRunCmdInfo.step <= ((eBarcodeIndex_1 - eBarcodeIndex_0) >> 5) << 4); /* 两道之内加快运动速度 */
+        motor_CMD_Info_Set_PF_Leave(&gBarcodeMotorRunCmdInfo, barcode_Motor_Leave_On_Busy_Bit);                   /* 等待驱动状态位空闲 */
     } else {
-        dSPIN_Set_Param(dSPIN_ACC, Index_0_dSPIN_CONF_PARAM_ACC);
-        dSPIN_Set_Param(dSPIN_DEC, Index_0_dSPIN_CONF_PARAM_DEC);
-        dSPIN_Set_Param(dSPIN_MAX_SPEED, Index_0_dSPIN_CONF_PARAM_MAX_SPEED);
+        gBarcodeMotorRunFast = 0;
         motor_CMD_Info_Set_PF_Leave(&gBarcodeMotorRunCmdInfo, barcode_Motor_Leave_On_OPT); /* 等待驱动状态位空闲 */
         motor_CMD_Info_Set_Step(&gBarcodeMotorRunCmdInfo, 0xFFFFFF);
     }
-    return barcode_Motor_Run(); /* 执行电机运动 */
+    return barcode_Motor_Run_Start(); /* 启动电机运动 */
 }
 
 /**
- * @brief  扫码执行 按索引操作
+ * @brief  扫码执行 按索引 移动电机
  * @param  index   条码位置索引
  * @retval 扫码结果数据长度
  */
-eBarcodeState barcode_Scan_By_Index(eBarcodeIndex index)
+eBarcodeState barcode_Motor_Run_By_Index(eBarcodeIndex index)
 {
     eBarcodeState result;
-    sBarcoderesult * pResult;
-    uint8_t max_read_length, idx, buffer[80];
 
+    result = barcode_Motor_Run_By_Index_Start(index);
+    if (result != eBarcodeState_OK) {
+        return result;
+    }
+    return barcode_Motor_Run_Wait(); /* 等待电机运动完成 */
+}
+
+/**
+ * @brief  扫码结果缓存 按索引获取
+ * @param  index   条码位置索引
+ * @param  pMax_read_length 读取长度
+ * @param  pIdx 上送报文中的位置编号
+ * @retval 扫码结果缓存 NULL 索引非法
+ */
+static sBarcoderesult * barcode_Result_Get_By_Index(eBarcodeIndex index, uint8_t * pMax_read_length, uint8_t * pIdx)
+{
     switch (index) {
         case eBarcodeIndex_0:
-            pResult = &(gBarcodeDecodeResult[6]);
-            max_read_length = BARCODE_BA_LENGTH;
-            idx = 1;
-            break;
+            *pMax_read_length = BARCODE_BA_LENGTH;
+            *pIdx = 1;
+            return &(gBarcodeDecodeResult[6]);
         case eBarcodeIndex_1:
-            pResult = &(gBarcodeDecodeResult[5]);
-            max_read_length = BARCODE_BA_LENGTH;
-            idx = 2;
-            break;
+            *pMax_read_length = BARCODE_BA_LENGTH;
+            *pIdx = 2;
+            return &(gBarcodeDecodeResult[5]);
         case eBarcodeIndex_2:
-            pResult = &(gBarcodeDecodeResult[4]);
-            max_read_length = BARCODE_BA_LENGTH;
-            idx = 3;
-            break;
+            *pMax_read_length = BARCODE_BA_LENGTH;
+            *pIdx = 3;
+            return &(gBarcodeDecodeResult[4]);
         case eBarcodeIndex_3:
-            pResult = &(gBarcodeDecodeResult[3]);
-            max_read_length = BARCODE_BA_LENGTH;
-            idx = 4;
-            break;
+            *pMax_read_length = BARCODE_BA_LENGTH;
+            *pIdx = 4;
+            return &(gBarcodeDecodeResult[3]);
         case eBarcodeIndex_4:
-            pResult = &(gBarcodeDecodeResult[2]);
-            max_read_length = BARCODE_BA_LENGTH;
-            idx = 5;
-            break;
+            *pMax_read_length = BARCODE_BA_LENGTH;
+            *pIdx = 5;
+            return &(gBarcodeDecodeResult[2]);
         case eBarcodeIndex_5:
-            pResult = &(gBarcodeDecodeResult[1]);
-            max_read_length = BARCODE_BA_LENGTH;
-            idx = 6;
-            break;
+            *pMax_read_length = BARCODE_BA_LENGTH;
+            *pIdx = 6;
+            return &(gBarcodeDecodeResult[1]);
         case eBarcodeIndex_6:
-            pResult = &(gBarcodeDecodeResult[0]);
-            max_read_length = BARCODE_QR_LENGTH;
-            idx = 7;
-            break;
+            *pMax_read_length = BARCODE_QR_LENGTH;
+            *pIdx = 7;
+            return &(gBarcodeDecodeResult[0]);
         default:
-            return eBarcodeState_Error;
+            return NULL;
     }
-    result = barcode_Motor_Run_By_Index(index); /* 执行电机运动 */
-    if (result != eBarcodeState_OK) {
-        pResult->length = 0;
-        pResult->state = eBarcodeState_Error;
+}
+
+/**
+ * @brief  扫码结果上送
+ * @param  index   条码位置索引
+ * @param  pResult 扫码结果
+ * @param  idx 上送报文中的位置编号
+ * @retval None
+ */
+static void barcode_Result_Emit(eBarcodeIndex index, sBarcoderesult * pResult, uint8_t idx)
+{
+    uint8_t buffer[80];
+
+    if (pResult->state == eBarcodeState_Error || (index == eBarcodeIndex_6 && pResult->length == 0)) {
+        return;
+    }
+    buffer[0] = idx;
+    buffer[1] = pResult->length;
+    memcpy(buffer + 2, pResult->pData, pResult->length);
+    if (comm_Main_SendTask_Queue_GetWaiting() <= COMM_MAIN_SEND_QUEU_LENGTH - 6) {
+        comm_Main_SendTask_QueueEmitWithBuild(eProtocolRespPack_Client_BARCODE, buffer, pResult->length + 2, 0);
+        comm_Out_SendTask_QueueEmitWithModify(buffer, pResult->length + 2 + 7, 0);
     } else {
-        pResult->state = barcode_Read_From_Serial(&(pResult->length), pResult->pData, max_read_length, 800);     /* 第一次扫描 */
-        if (pResult->length < 10) {                                                                              /* 扫描结果为空 */
-            vTaskDelay(100);                                                                                     /* 延时 */
-            pResult->state = barcode_Read_From_Serial(&(pResult->length), pResult->pData, max_read_length, 400); /* 第二次扫描 */
+        comm_Out_SendTask_QueueEmitWithBuild(eProtocolRespPack_Client_BARCODE, buffer, pResult->length + 2, 0);
+    }
+}
+
+/**
+ * @brief  扫码执行 当前位置扫码
+ * @note   扫码电机已位于 index 位置
+ *         收到首字节即表示扫码头已完成解码 若有下一位置则立即启动运动 帧剩余部分由DMA在运动中接收 结果在运动中上送
+ *         结果长度不足时 回到 index 位置按原有流程延时100mS后再扫描一次
+ *         返回时下一位置的运动可能仍在进行 由 barcode_Motor_Run_Wait 等待完成
+ * @param  index   条码位置索引
+ * @param  pNext   下一条码位置索引 NULL 无后续位置
+ * @retval 扫码结果
+ */
+static eBarcodeState barcode_Scan_On_Position(eBarcodeIndex index, eBarcodeIndex const * pNext)
+{
+    sBarcoderesult * pResult;
+    uint8_t max_read_length, idx;
+    EventBits_t uxBits;
+
+    pResult = barcode_Result_Get_By_Index(index, &max_read_length, &idx);
+    if (pResult == NULL) {
+        return eBarcodeState_Error;
+    }
+
+    pResult->state = eBarcodeState_Error;
+    pResult->length = 0;
+    if (barcode_Serial_Start(pResult->pData, max_read_length) == eBarcodeState_OK) {                             /* 第一次扫描 */
+        uxBits = barcode_Serial_Wait(BARCODE_RX_FIRST_BIT, 800);                                                 /* 等待完成解码 */
+        if (pNext != NULL && (uxBits & (BARCODE_RX_FIRST_BIT | BARCODE_RX_ERROR_BIT)) == BARCODE_RX_FIRST_BIT) { /* 已完成解码 */
+            barcode_Motor_Run_By_Index_Start(*pNext);                                                            /* 提前运动到下一位置 */
         }
-        if (pResult->state != eBarcodeState_Error) {
-            if (index != eBarcodeIndex_6 || pResult->length > 0) {
-                buffer[0] = idx;
-                buffer[1] = pResult->length;
-                memcpy(buffer + 2, pResult->pData, pResult->length);
-                if (comm_Main_SendTask_Queue_GetWaiting() <= COMM_MAIN_SEND_QUEU_LENGTH - 6) {
-                    comm_Main_SendTask_QueueEmitWithBuild(eProtocolRespPack_Client_BARCODE, buffer, pResult->length + 2, 0);
-                    comm_Out_SendTask_QueueEmitWithModify(buffer, pResult->length + 2 + 7, 0);
-                } else {
-                    comm_Out_SendTask_QueueEmitWithBuild(eProtocolRespPack_Client_BARCODE, buffer, pResult->length + 2, 0);
-                }
+        pResult->state = barcode_Serial_Finish(&(pResult->length));
+    }
+    if (pResult->length < 10) {        /* 扫描结果为空 */
+        if (gBarcodeMotorRunPending) { /* 已离开当前位置 */
+            if (barcode_Motor_Run_Wait() != eBarcodeState_OK || barcode_Motor_Run_By_Index(index) != eBarcodeState_OK) {
+                pResult->length = 0;
+                pResult->state = eBarcodeState_Error;
+                return eBarcodeState_Error;
             }
         }
+        vTaskDelay(100);                                                                                     /* 延时 */
+        pResult->state = barcode_Read_From_Serial(&(pResult->length), pResult->pData, max_read_length, 400); /* 第二次扫描 */
+    }
+    barcode_Result_Emit(index, pResult, idx); /* 下一位置运动中上送 */
+    return pResult->state;
+}
+
+/**
+ * @brief  扫码执行 按索引操作
+ * @param  index   条码位置索引
+ * @retval 扫码结果数据长度
+ */
+eBarcodeState barcode_Scan_By_Index(eBarcodeIndex index)
+{
+    sBarcoderesult * pResult;
+    uint8_t max_read_length, idx;
+
+    pResult = barcode_Result_Get_By_Index(index, &max_read_length, &idx);
+    if (pResult == NULL) {
+        return eBarcodeState_Error;
+    }
+    if (barcode_Motor_Run_By_Index(index) != eBarcodeState_OK) { /* 执行电机运动 */
+        pResult->length = 0;
+        pResult->state = eBarcodeState_Error;
+        return pResult->state;
     }
+    barcode_Scan_On_Position(index, NULL);
 
     //    if (index == eBarcodeIndex_6) {
     //		pResult->length = 65;
@@ -727,17 +1019,30 @@ eBarcodeState barcode_Scan_QR(void)
  */
 eBarcodeState barcode_Scan_Bar(void)
 {
-    uint8_t i;
+    uint8_t i, max_read_length, idx;
     eBarcodeState result;
+    sBarcoderesult * pResult;
 
     for (i = 0; i < ARRAY_LEN(cBarCodeIndex); ++i) { /* 不存在有效QR Code */
         if (barcode_Interrupt_Flag_Get()) {
+            barcode_Motor_Run_Wait(); /* 释放SPI总线资源 */
             return eBarcodeState_Interrupt;
         }
-        vTaskDelay(10);
-        result = barcode_Scan_By_Index(cBarCodeIndex[i]); /* 扫码位置索引倒序 */
-        if (result == eBarcodeState_Error) {              /* 扫码电机故障 */
-            return eBarcodeState_Error;                   /* 提前返回 */
+        if (gBarcodeMotorRunPending) { /* 上一位置解码完成后已启动运动 */
+            result = barcode_Motor_Run_Wait();
+        } else {
+            result = barcode_Motor_Run_By_Index(cBarCodeIndex[i]); /* 扫码位置索引倒序 */
+        }
+        if (result != eBarcodeState_OK) { /* 扫码电机故障 */
+            pResult = barcode_Result_Get_By_Index(cBarCodeIndex[i], &max_read_length, &idx);
+            pResult->length = 0;
+            pResult->state = eBarcodeState_Error;
+            return eBarcodeState_Error; /* 提前返回 */
+        }
+        result = barcode_Scan_On_Position(cBarCodeIndex[i], (i + 1 < ARRAY_LEN(cBarCodeIndex)) ? (&cBarCodeIndex[i + 1]) : (NULL));
+        if (result == eBarcodeState_Error) { /* 扫码电机故障 */
+            barcode_Motor_Run_Wait();        /* 释放SPI总线资源 */
+            return eBarcodeState_Error;      /* 提前返回 */
         }
     }
     return eBarcodeState_OK;
@@ -884,61 +1189,78 @@ void barcode_Scan_Bantch(uint8_t pos_mark, uint8_t scan_mark)
 }
 
 /**
- * @brief  字符串转换成整数 10进制
- * @param  pBuffer 数据指针
- * @param  length 数据长度
- * @note   '1234' -> 1234
- * @retval 整数
+ * @brief  字符转换成数值 16进制
+ * @param  c 字符
+ * @note   '0' ~ '9' 'a' ~ 'f' 'A' ~ 'F'
+ * @retval 数值 0xFF 非法字符
  */
-static uint32_t barcode_Str_2_Int_Base_10(uint8_t * pBuffer, uint8_t length)
+static uint8_t barcode_Char_2_Hex(uint8_t c)
 {
-    uint8_t i;
-    uint32_t result = 0;
+    uint8_t digit;
 
-    if (pBuffer == NULL || length == 0) {
-        return 0;
+    digit = c - '0';
+    if (digit <= 9) {
+        return digit;
     }
-
-    for (i = 0; i < length; ++i) {
-        result *= 10;
-        if (pBuffer[i] >= '0' && pBuffer[i] <= '9') {
-            result += pBuffer[i] - '0';
-        } else {
-            return 0;
-        }
+    digit = (c | 0x20) - 'a'; /* 大写转小写 */
+    if (digit <= 5) {
+        return digit + 10;
     }
-    return result;
+    return 0xFF;
 }
 
 /**
- * @brief  字符串转换成整数 16进制
- * @param  pBuffer 数据指针
+ * @brief  字符串转换成整数 指针后移
+ * @param  ppBuffer 数据指针的指针 转换后指向下一字段
  * @param  length 数据长度
- * @note   '1234' -> 4660
- * @retval 整数
+ * @param  base 进制 10 或 16
+ * @param  pResult 转换结果
+ * @note   '1234' -> 1234 / 4660
+ * @retval 0 成功 1 非法字符
  */
-static uint32_t barcode_Str_2_Int_Base_16(uint8_t * pBuffer, uint8_t length)
+static uint8_t barcode_Str_2_Int(uint8_t const ** ppBuffer, uint8_t length, uint8_t base, uint32_t * pResult)
 {
-    uint8_t i;
+    uint8_t digit;
     uint32_t result = 0;
+    uint8_t const * p = *ppBuffer;
 
-    if (pBuffer == NULL || length == 0) {
-        return 0;
+    while (length-- > 0) {
+        digit = barcode_Char_2_Hex(*p++);
+        if (digit >= base) {
+            return 1;
+        }
+        result = result * base + digit;
     }
+    *ppBuffer = p;
+    *pResult = result;
+    return 0;
+}
 
-    for (i = 0; i < length; ++i) {
-        result *= 16;
-        if (pBuffer[i] >= '0' && pBuffer[i] <= '9') {
-            result += pBuffer[i] - '0';
-        } else if (pBuffer[i] >= 'a' && pBuffer[i] <= 'f') {
-            result += pBuffer[i] - 'a' + 10;
-        } else if (pBuffer[i] >= 'A' && pBuffer[i] <= 'F') {
-            result += pBuffer[i] - 'A' + 10;
-        } else {
-            return 0;
+/**
+ * @brief  定标二维码解析 单次遍历
+ * @param  pBuffer 数据指针 长度为 BARCODE_QR_LENGTH
+ * @param  pInfo 解析结果暂存
+ * @note   4位批号 6位日期 1位定标段索引 10进制 13个定标点 每个4位 2位校验位 16进制
+ * @note   逐字段顺序转换 同时检查字符合法性
+ * @retval 0 成功 1 非法字符
+ */
+static uint8_t barcode_Correct_Info_Parse(uint8_t const * pBuffer, sBarcodeCorrectInfo * pInfo)
+{
+    uint8_t i;
+    uint32_t value;
+
+    if (barcode_Str_2_Int(&pBuffer, 4, 10, &pInfo->branch) || barcode_Str_2_Int(&pBuffer, 6, 10, &pInfo->date) || /* 4位批号 6位日期 */
+        barcode_Str_2_Int(&pBuffer, 1, 10, &value)) {                                                          /* 1位定标段索引 */
+        return 1;
+    }
+    pInfo->stage = value;
+    for (i = 0; i < ARRAY_LEN(pInfo->i_values); ++i) { /* 13个定标点 每个4位 */
+        if (barcode_Str_2_Int(&pBuffer, 4, 16, &value)) {
+            return 1;
         }
+        pInfo->i_values[i] = value;
     }
-    return result;
+    return barcode_Str_2_Int(&pBuffer, 2, 16, &pInfo->check); /* 2位校验位 */
 }
 
 /**
@@ -948,47 +1270,42 @@ static uint32_t barcode_Str_2_Int_Base_16(uint8_t * pBuffer, uint8_t length)
  * @note   数据包长度应等同 sBarcodeCorrectInfo 数据类型
  * @note   只支持整条 校正段索引只有一个
  * @note   杂散光条码 定标点应全为0 校正段应为9
+ * @note   先解析到暂存 校验通过后整段提交校正标准值 405 只有1个定标点 各通道共用
  * @retval 0 成功 1 数据包异常 2 参数异常 0xFf 杂散光条码
  */
 uint8_t barcode_Scan_Decode_Correct_Info(uint8_t * pBuffer, uint8_t length)
 {
     uint8_t i, ao = 0;
-    eStorgeParamIndex idx;
-    eComm_Data_Sample_Radiant wave;
+    uint32_t values[3 * 6];
+    sBarcodeCorrectInfo info;
 
-    if (pBuffer == NULL || length != 65) {
+    if (pBuffer == NULL || length != BARCODE_QR_LENGTH) {
         return 1;
     }
-
-    gBarcodeCorrectInfo.branch = barcode_Str_2_Int_Base_10(pBuffer, 4);     /* 4位批号 */
-    gBarcodeCorrectInfo.date = barcode_Str_2_Int_Base_10(pBuffer + 4, 6);   /* 6位日期 */
-    gBarcodeCorrectInfo.stage = barcode_Str_2_Int_Base_10(pBuffer + 10, 1); /* 1位定标段索引 0 ~ 5 */
-
-    for (i = 0; i < 13; ++i) {                                                                /* 13个定标点 */
-        gBarcodeCorrectInfo.i_values[i] = barcode_Str_2_Int_Base_16(pBuffer + 11 + 4 * i, 4); /* 每个4位 */
-        if (ao == 0 && gBarcodeCorrectInfo.i_values[i] > 0) {                                 /* 全为0标志检查 */
-            ao = 1;
-        }
+    if (barcode_Correct_Info_Parse(pBuffer, &info) != 0) { /* 非法字符 */
+        return 1;
     }
-    gBarcodeCorrectInfo.check = barcode_Str_2_Int_Base_16(pBuffer + 63, 2); /* 2位校验位 */
-
-    if (CRC8(pBuffer, length - 2) != gBarcodeCorrectInfo.check) { /* CRC异常 */
+    if (CRC8(pBuffer, length - 2) != info.check) { /* CRC异常 */
         return 2;
     }
-    if (gBarcodeCorrectInfo.stage == 9 && ao == 0) { /* 杂散光校正段 */
+
+    for (i = 0; i < ARRAY_LEN(info.i_values); ++i) { /* 全为0标志检查 */
+        ao |= (info.i_values[i] > 0);
+    }
+    if (info.stage == 9 && ao == 0) { /* 杂散光校正段 */
+        gBarcodeCorrectInfo = info;
         return 0xFF;
-    } else if (gBarcodeCorrectInfo.stage > 5) {
+    } else if (info.stage > 5) {
         return 2;
     }
 
-    for (i = 0; i < 6; ++i) {                                                                       /* 6个通道 */
-        for (wave = eComm_Data_Sample_Radiant_610; wave <= eComm_Data_Sample_Radiant_405; ++wave) { /* 610 550 405 */
-            idx = storge_Param_Illumine_CC_Get_Index(i + 1, wave) - 6;           /* 根据通道和波长 得出校正参数标准值索引 */
-            storge_Param_Illumine_CC_Set_Single(idx + gBarcodeCorrectInfo.stage, /* 段索引偏移 */
-                                                gBarcodeCorrectInfo.i_values[(wave - eComm_Data_Sample_Radiant_610) * 6 + i]); /* 设置校正标准值 */
-        }
+    for (i = 0; i < 6; ++i) {                 /* 6个通道 */
+        values[i] = info.i_values[i];         /* 610 */
+        values[6 + i] = info.i_values[6 + i]; /* 550 */
+        values[12 + i] = info.i_values[12];   /* 405 */
     }
-
+    storge_Param_Illumine_CC_Set_Stage(info.stage, values); /* 整段设置校正标准值 */
+    gBarcodeCorrectInfo = info;
     return 0;
 }
 
@@ -0,0 +1,170 @@
+/**
+ * @file    boot.c
+ * @brief   启动就绪事件组 启动耗时统计
+ *
+ * 各启动步骤在所属任务中并行执行 完成后置位就绪事件
+ *     存储任务   外部Flash初始化 参数加载                BOOT_BIT_PARAM
+ *     杂项任务   温度ADC首次转换 扫码模块配置            BOOT_BIT_TEMP BOOT_BIT_BARCODE
+ *     加热定时器 参数与温度就绪后 过冲初始化 启动加热输出 BOOT_BIT_HEATER
+ *     电机任务   电机驱动初始化 复位                     BOOT_BIT_MOTOR
+ * 依赖关系通过事件组等待表达 参数与温度就绪后立即向主板及外串口上送就绪帧 (版本信息帧) 电机复位等在后台继续
+ *
+ * 启动统计 各事件完成时刻与就绪帧入队时刻 单位 mS 自复位 (HAL 节拍) 起算
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "boot.h"
+#include "comm_main.h"
+#include "comm_out.h"
+
+/* Extern variables ----------------------------------------------------------*/
+
+/* Private includes ----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+static EventGroupHandle_t gBoot_Event = NULL;
+static StaticEventGroup_t gBoot_Event_Buffer;
+
+static uint32_t gBoot_Scheduler_Time = 0;      /* 调度器启动时刻 mS */
+static uint32_t gBoot_Mark_Time[BOOT_BIT_NUM]; /* 各就绪事件完成时刻 mS 0 为未完成 */
+static uint32_t gBoot_Ready_Time = 0;          /* 就绪帧入队时刻 mS 0 为未上送 */
+static uint8_t gBoot_Ready_Sent = 0;           /* 就绪帧已上送标志 */
+
+/* Private constants ---------------------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+
+/**
+ * @brief  启动就绪事件组 初始化
+ * @note   在创建各任务前调用
+ * @param  None
+ * @retval None
+ */
+void boot_Init(void)
+{
+    gBoot_Event = xEventGroupCreateStatic(&gBoot_Event_Buffer);
+    if (gBoot_Event == NULL) {
+        FL_Error_Handler(__FILE__, __LINE__);
+    }
+    memset(gBoot_Mark_Time, 0, sizeof(gBoot_Mark_Time));
+    gBoot_Ready_Time = 0;
+    gBoot_Ready_Sent = 0;
+}
+
+/**
+ * @brief  记录调度器启动时刻
+ * @note   在 vTaskStartScheduler 前调用 此前为外设初始化耗时
+ * @param  None
+ * @retval None
+ */
+void boot_Scheduler_Mark(void)
+{
+    gBoot_Scheduler_Time = HAL_GetTick();
+}
+
+/**
+ * @brief  就绪帧上送
+ * @note   版本信息帧 主板与外串口各一帧 不等待队列
+ * @param  None
+ * @retval None
+ */
+static void boot_Ready_Send(void)
+{
+    uint8_t buffer[4];
+
+    protocol_Get_Version(buffer);
+    comm_Main_SendTask_QueueEmitWithBuild(eProtocolRespPack_Client_VER, buffer, sizeof(buffer), 0);
+    comm_Out_SendTask_QueueEmitWithBuild(eProtocolRespPack_Client_VER, buffer, sizeof(buffer), 0);
+}
+
+/**
+ * @brief  置位就绪事件
+ * @note   任务上下文调用 记录完成时刻 就绪条件满足后上送一次就绪帧
+ * @param  bits 就绪事件
+ * @retval None
+ */
+void boot_Mark(EventBits_t bits)
+{
+    EventBits_t result;
+    uint32_t now;
+    uint8_t i, send = 0;
+
+    now = HAL_GetTick();
+    for (i = 0; i < BOOT_BIT_NUM; ++i) {
+        if ((bits & (1 << i)) && gBoot_Mark_Time[i] == 0) {
+            gBoot_Mark_Time[i] = now;
+        }
+    }
+    result = xEventGroupSetBits(gBoot_Event, bits);
+
+    taskENTER_CRITICAL();
+    if ((result & BOOT_BITS_READY) == BOOT_BITS_READY && gBoot_Ready_Sent == 0) { /* 多个任务同时满足条件时 只上送一次 */
+        gBoot_Ready_Sent = 1;
+        send = 1;
+    }
+    taskEXIT_CRITICAL();
+
+    if (send) {
+        boot_Ready_Send();
+        gBoot_Ready_Time = HAL_GetTick();
+    }
+}
+
+/**
+ * @brief  就绪事件是否全部完成
+ * @note   不阻塞 可在定时器回调中调用
+ * @param  bits 就绪事件
+ * @retval 1 完成 0 未完成
+ */
+uint8_t boot_Is_Ready(EventBits_t bits)
+{
+    return (xEventGroupGetBits(gBoot_Event) & bits) == bits;
+}
+
+/**
+ * @brief  等待就绪事件全部完成
+ * @param  bits 就绪事件
+ * @param  timeout 超时时间
+ * @retval 返回时的事件组状态
+ */
+EventBits_t boot_Wait(EventBits_t bits, TickType_t timeout)
+{
+    return xEventGroupWaitBits(gBoot_Event, bits, pdFALSE, pdTRUE, timeout);
+}
+
+/**
+ * @brief  启动统计 打包
+ * @note   标识 + 已完成事件位 + 调度器启动 参数 温度 加热 扫码 电机 就绪帧 时刻 各4字节 mS 0 为未完成
+ * @note   可在中断中调用
+ * @param  pBuffer 输出指针
+ * @retval 输出长度
+ */
+uint8_t boot_Stat_Pack(uint8_t * pBuffer)
+{
+    uint32_t data[BOOT_BIT_NUM + 2];
+    uint8_t i, length = 0;
+
+    data[0] = gBoot_Scheduler_Time;
+    for (i = 0; i < BOOT_BIT_NUM; ++i) {
+        data[1 + i] = gBoot_Mark_Time[i];
+    }
+    data[BOOT_BIT_NUM + 1] = gBoot_Ready_Time;
+
+    pBuffer[length++] = BOOT_TAG_STAT;
+    pBuffer[length++] = xEventGroupGetBitsFromISR(gBoot_Event) & 0xFF;
+    for (i = 0; i < ARRAY_LEN(data); ++i) {
+        pBuffer[length++] = data[i] >> 0;
+        pBuffer[length++] = data[i] >> 8;
+        pBuffer[length++] = data[i] >> 16;
+        pBuffer[length++] = data[i] >> 24;
+    }
+    return length;
+}
@@ -20,6 +20,7 @@
 #include "sample.h"
 #include "heater.h"
 #include "storge_task.h"
+#include "sys_stat.h"
 
 /* Extern variables ----------------------------------------------------------*/
 extern UART_HandleTypeDef huart2;
@@ -36,11 +37,22 @@ extern TIM_HandleTypeDef htim7;
 #define COMM_DATA_SEND_QUEU_LENGTH 2
 #define COMM_DATA_ACK_SEND_QUEU_LENGTH 6
 
+#define COMM_DATA_SER_MERGE_SIZE (COMM_DATA_SER_RX_SIZE + COMM_DATA_DMA_RX_SIZE / 2) /* 拼包缓存 未完整帧 + DMA 半满一次 连续大帧不丢弃 */
+
+#define COMM_DATA_SAMPLE_EVENT_ALL (0x3F) /* 采样数据到达事件 通道1～6 */
+
 /* Private typedef -----------------------------------------------------------*/
+/* LED电压搜索 目标值两侧的测试点 */
 typedef struct {
-    int16_t dac;
-    int32_t adc_avg;
-} sComm_Data_LED_SP_Record;
+    int16_t lo_dac;      /* 下界 低于目标值的测试点 -1 未测试 */
+    int16_t hi_dac;      /* 上界 高于目标值的测试点 -1 未测试 */
+    int16_t last_dac;    /* 上一测试点 -1 无 */
+    uint8_t hi_overflow; /* 上界PD值越限 */
+    uint8_t side_repeat; /* 同侧连续更新次数 */
+    int32_t lo_bias;     /* 下界偏差 */
+    int32_t hi_bias;     /* 上界偏差 */
+    int32_t last_bias;   /* 上一测试点偏差 */
+} sComm_Data_LED_Search;
 
 /* Private variables ---------------------------------------------------------*/
 
@@ -54,26 +66,40 @@ static sSerialRecord vComm_Data_Serial_Record;
 static uint8_t gComm_Data_RX_dma_buffer[COMM_DATA_DMA_RX_SIZE];
 
 /* DMA 接收后 提交到串口拼包缓存 */
-static uint8_t gComm_Data_RX_serial_buffer[COMM_DATA_SER_RX_SIZE];
+static uint8_t gComm_Data_RX_serial_buffer[COMM_DATA_SER_MERGE_SIZE];
 
 /* 串口接收队列 */
 static xQueueHandle comm_Data_RecvQueue = NULL;
+static StaticQueue_t comm_Data_RecvQueue_Buffer;
+static uint8_t comm_Data_RecvQueue_Storage[3 * sizeof(sComm_Data_RecvInfo)];
 
 /* 串口接收ACK记录 */
 static sProcol_COMM_ACK_Record gComm_Data_ACK_Records[12];
 
 /* 串口发送队列 */
 static xQueueHandle comm_Data_SendQueue = NULL;
+static StaticQueue_t comm_Data_SendQueue_Buffer;
+static uint8_t comm_Data_SendQueue_Storage[COMM_DATA_SEND_QUEU_LENGTH * sizeof(sComm_Data_SendInfo)];
 static xQueueHandle comm_Data_ACK_SendQueue = NULL;
+static StaticQueue_t comm_Data_ACK_SendQueue_Buffer;
+static uint8_t comm_Data_ACK_SendQueue_Storage[COMM_DATA_ACK_SEND_QUEU_LENGTH * sizeof(uint8_t)];
 
 /* 串口DMA发送资源信号量 */
 static xSemaphoreHandle comm_Data_Send_Sem = NULL;
+static StaticSemaphore_t comm_Data_Send_Sem_Buffer;
 
 /* 串口收发任务句柄 */
 static xTaskHandle comm_Data_Send_Task_Handle = NULL;
+static StackType_t comm_Data_Send_Task_Stack[256];
+static StaticTask_t comm_Data_Send_Task_TCB;
 
 /* 测试配置项信号量 */
 static xSemaphoreHandle comm_Data_Conf_Sem = NULL;
+static StaticSemaphore_t comm_Data_Conf_Sem_Buffer;
+
+/* 采样数据到达事件 */
+static EventGroupHandle_t comm_Data_Sample_Event = NULL;
+static StaticEventGroup_t comm_Data_Sample_Event_Buffer;
 
 static sComm_Data_SendInfo gComm_Data_SendInfo;         /* 提交发送任务到队列用缓存 */
 static sComm_Data_SendInfo gComm_Data_SendInfo_FromISR; /* 提交发送任务到队列用缓存 中断用 */
@@ -103,7 +129,21 @@ static uint8_t gComm_Data_Correct_stages[6] = {0, 0, 0, 0, 0, 0}; /* 定标段
 static uint8_t gComm_Data_Lamp_BP_Flag = 0;   /* 灯BP状态标志 */
 static uint8_t gComm_Data_AgingLoop_Mode = 0; /* 老化测试 配置状态 */
 
-static sComm_Data_LED_SP_Record gComm_Data_LED_SP_Record[3];
+static sComm_Data_LED_Search gComm_Data_LED_Search; /* LED电压搜索 */
+
+/* 采样节奏 按测试方法 速率法 终点法 两点终点法 */
+static sComm_Data_Sample_Cadence gComm_Data_Sample_Cadences[3] = {
+    {COMM_DATA_WH_PERIOD_DEFAULT, COMM_DATA_PD_DELAY_DEFAULT, COMM_DATA_PRE_LIGHT_DEFAULT, 0, 0},
+    {COMM_DATA_WH_PERIOD_DEFAULT, COMM_DATA_PD_DELAY_DEFAULT, COMM_DATA_PRE_LIGHT_DEFAULT, 0, 0},
+    {COMM_DATA_WH_PERIOD_DEFAULT, COMM_DATA_PD_DELAY_DEFAULT, COMM_DATA_PRE_LIGHT_DEFAULT, 0, 0},
+};
+
+/* 本次采样生效节奏 */
+static sComm_Data_Sample_Cadence gComm_Data_Sample_Cadence = {COMM_DATA_WH_PERIOD_DEFAULT, COMM_DATA_PD_DELAY_DEFAULT, COMM_DATA_PRE_LIGHT_DEFAULT, 0, 0};
+
+static uint8_t gComm_Data_Sample_Stable_Need = 0; /* 提前结束 需稳定通道掩码 */
+static uint8_t gComm_Data_Sample_Stable_Mask = 0; /* 提前结束 已稳定通道掩码 */
+static uint8_t gComm_Data_Sample_Early_Stop = 0;  /* 提前结束 标志 */
 
 /* Private constants ---------------------------------------------------------*/
 
@@ -289,6 +329,24 @@ void comm_Data_RecordInit(void)
         gComm_Data_Samples[i].wave = 0;
         memset(gComm_Data_Samples[i].raw_datas, 0, 240);
     }
+    if (comm_Data_Sample_Event != NULL) {
+        xEventGroupClearBits(comm_Data_Sample_Event, COMM_DATA_SAMPLE_EVENT_ALL); /* 清除采样数据到达事件 */
+    }
+}
+
+/**
+ * @brief  采样数据到达 通知等待任务 中断版本
+ * @param  channel 通道索引 1～6
+ * @retval None
+ */
+static void comm_Data_Sample_Event_Set_FromISR(uint8_t channel)
+{
+    BaseType_t xResult, xHigherPriorityTaskWoken = pdFALSE;
+
+    xResult = xEventGroupSetBitsFromISR(comm_Data_Sample_Event, 1 << (channel - 1), &xHigherPriorityTaskWoken);
+    if (xResult) {
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    }
 }
 
 /**
@@ -438,6 +496,129 @@ void gComm_Data_Sample_Max_Point_Update(uint8_t data)
     }
 }
 
+/**
+ * @brief  采样节奏 恢复默认
+ * @note   定标 自检 LED校正 使用默认节奏
+ * @param  None
+ * @retval None
+ */
+static void comm_Data_Sample_Cadence_Reset(void)
+{
+    gComm_Data_Sample_Cadence.wh_period = COMM_DATA_WH_PERIOD_DEFAULT;
+    gComm_Data_Sample_Cadence.pd_delay = COMM_DATA_PD_DELAY_DEFAULT;
+    gComm_Data_Sample_Cadence.pre_light = COMM_DATA_PRE_LIGHT_DEFAULT;
+    gComm_Data_Sample_Cadence.stable_points = 0;
+    gComm_Data_Sample_Cadence.stable_permille = 0;
+    gComm_Data_Sample_Stable_Need = 0;
+}
+
+/**
+ * @brief  采样节奏 按测试配置生效
+ * @note   各通道测试方法不同时 周期 间隔 预先点灯取最长者 全部通道均允许提前结束时才提前结束
+ * @param  None
+ * @retval None
+ */
+static void comm_Data_Sample_Cadence_Apply(void)
+{
+    sComm_Data_Sample_Cadence result = {0, 0, 0, 0, 0xFF};
+    sComm_Data_Sample_Cadence const * pCadence;
+    uint8_t i, need = 0, early = 1;
+
+    for (i = 0; i < ARRAY_LEN(gComm_Data_Samples); ++i) {
+        if (gComm_Data_Samples[i].conf.points_num == 0 ||                            /* 无测试点 */
+            gComm_Data_Samples[i].conf.assay < eComm_Data_Sample_Assay_Continuous || /* or */
+            gComm_Data_Samples[i].conf.assay > eComm_Data_Sample_Assay_Fixed) {      /* 无测试方法 */
+            continue;
+        }
+        pCadence = &gComm_Data_Sample_Cadences[gComm_Data_Samples[i].conf.assay - eComm_Data_Sample_Assay_Continuous];
+        need |= 1 << i;
+        result.wh_period = (pCadence->wh_period > result.wh_period) ? (pCadence->wh_period) : (result.wh_period);
+        result.pd_delay = (pCadence->pd_delay > result.pd_delay) ? (pCadence->pd_delay) : (result.pd_delay);
+        result.pre_light = (pCadence->pre_light > result.pre_light) ? (pCadence->pre_light) : (result.pre_light);
+        if (pCadence->stable_points == 0) { /* 不允许提前结束 */
+            early = 0;
+        }
+        result.stable_points = (pCadence->stable_points > result.stable_points) ? (pCadence->stable_points) : (result.stable_points);
+        result.stable_permille = (pCadence->stable_permille < result.stable_permille) ? (pCadence->stable_permille) : (result.stable_permille);
+    }
+    if (need == 0) { /* 无有效测试项 */
+        comm_Data_Sample_Cadence_Reset();
+        return;
+    }
+    if (early == 0) { /* 存在不允许提前结束的通道 */
+        result.stable_points = 0;
+        result.stable_permille = 0;
+    }
+    gComm_Data_Sample_Cadence = result;
+    gComm_Data_Sample_Stable_Need = need;
+}
+
+/**
+ * @brief  采样节奏 设置
+ * @note   下次下达测试配置时生效
+ * @param  assay 测试方法
+ * @param  pData 白板周期 白板至PD间隔 预先点灯 各2字节小端 mS + 连续稳定点数 + 相对偏差千分比
+ * @retval 0 成功 1 参数非法
+ */
+uint8_t comm_Data_Sample_Cadence_Set(eComm_Data_Sample_Assay assay, uint8_t const * pData)
+{
+    sComm_Data_Sample_Cadence cadence;
+
+    if (assay < eComm_Data_Sample_Assay_Continuous || assay > eComm_Data_Sample_Assay_Fixed) {
+        return 1;
+    }
+    cadence.wh_period = pData[0] + (pData[1] << 8);
+    cadence.pd_delay = pData[2] + (pData[3] << 8);
+    cadence.pre_light = pData[4] + (pData[5] << 8);
+    cadence.stable_points = pData[6];
+    cadence.stable_permille = pData[7];
+    if (cadence.wh_period < COMM_DATA_WH_PERIOD_MIN || cadence.wh_period > COMM_DATA_WH_PERIOD_MAX || /* 白板周期越限 */
+        cadence.pd_delay < COMM_DATA_PD_DELAY_MIN || cadence.pd_delay > cadence.wh_period / 2 ||      /* 白板至PD间隔越限 */
+        cadence.pre_light > COMM_DATA_PRE_LIGHT_MAX ||                                                /* 预先点灯越限 */
+        cadence.stable_points > COMM_DATA_STABLE_POINTS_MAX ||                                        /* 连续稳定点数越限 */
+        (cadence.stable_points > 0 && cadence.stable_permille == 0)) {                                /* 偏差为0 */
+        return 1;
+    }
+    gComm_Data_Sample_Cadences[assay - eComm_Data_Sample_Assay_Continuous] = cadence;
+    return 0;
+}
+
+/**
+ * @brief  采样节奏 打包
+ * @note   每测试方法 测试方法 + 白板周期 白板至PD间隔 预先点灯 各2字节小端 + 连续稳定点数 + 相对偏差千分比
+ * @param  pBuffer 输出指针
+ * @retval 输出长度
+ */
+uint8_t comm_Data_Sample_Cadence_Pack(uint8_t * pBuffer)
+{
+    sComm_Data_Sample_Cadence const * pCadence;
+    uint8_t i, length = 0;
+
+    for (i = 0; i < ARRAY_LEN(gComm_Data_Sample_Cadences); ++i) {
+        pCadence = &gComm_Data_Sample_Cadences[i];
+        pBuffer[length++] = eComm_Data_Sample_Assay_Continuous + i;
+        pBuffer[length++] = pCadence->wh_period & 0xFF;
+        pBuffer[length++] = pCadence->wh_period >> 8;
+        pBuffer[length++] = pCadence->pd_delay & 0xFF;
+        pBuffer[length++] = pCadence->pd_delay >> 8;
+        pBuffer[length++] = pCadence->pre_light & 0xFF;
+        pBuffer[length++] = pCadence->pre_light >> 8;
+        pBuffer[length++] = pCadence->stable_points;
+        pBuffer[length++] = pCadence->stable_permille;
+    }
+    return length;
+}
+
+/**
+ * @brief  本次采样 预先点灯时间 获取
+ * @param  None
+ * @retval 预先点灯时间 mS
+ */
+uint32_t comm_Data_Sample_Pre_Light_Get(void)
+{
+    return gComm_Data_Sample_Cadence.pre_light;
+}
+
 /**
  * @brief  采样启动标志 清除
  * @param  None
@@ -602,26 +783,18 @@ uint8_t comm_Data_Set_LED_Voltage(eComm_Data_Sample_Radiant radiant, uint16_t vo
  * @brief  等待采样板数据
  * @param  mask 通道掩码 0x01->通道1 0x3F->通道1～6
  * @param  timeout 超时时间 毫秒
+ * @note   采样数据帧处理中置位到达事件 全部通道到达即唤醒 comm_Data_RecordInit 清除
  * @retval 0 等待时间内接收完成 1 超时
  */
 uint8_t comm_Data_Wait_Data(uint8_t mask, uint32_t timeout)
 {
-    uint8_t i, check;
-    TickType_t xTick;
+    EventBits_t uxBits;
 
-    xTick = xTaskGetTickCount();
-    do {
-        check = 1;
-        for (i = 0; i < ARRAY_LEN(gComm_Data_Samples); ++i) {
-            if (((1 << i) & mask) && gComm_Data_Samples[i].num == 0) {
-                check = 0;
-            }
-        }
-        if (check) {
-            return 0;
-        }
-        vTaskDelay(200);
-    } while (check == 0 && xTick + timeout < xTaskGetTickCount());
+    mask &= COMM_DATA_SAMPLE_EVENT_ALL;
+    uxBits = xEventGroupWaitBits(comm_Data_Sample_Event, mask, pdFALSE, pdTRUE, pdMS_TO_TICKS(timeout));
+    if ((uxBits & mask) == mask) {
+        return 0;
+    }
     return 1;
 }
 
@@ -688,13 +861,103 @@ void gComm_Data_LED_Voltage_Points_Set(uint8_t points)
     gComm_Data_LED_Voltage_Points = points;
 }
 
+/**
+ * @brief  LED电压搜索 起始值
+ * @param  radiant 波长
+ * @note   优先使用上次校正结果 (外部Flash LED校正结果区 STORGE_APP_SAPLED_ADDR) 超出范围时使用默认值
+ * @note   调用前需等待存储任务加载记录完成
+ * @retval LED输出电压DAC值
+ */
+uint16_t comm_Data_LED_Voltage_Seed(eComm_Data_Sample_Radiant radiant)
+{
+    uint16_t dac;
+
+    dac = storge_Sample_LED_DAC_Get(radiant);
+    switch (radiant) {
+        case eComm_Data_Sample_Radiant_610:
+            return (dac > 0 && dac <= COMM_DATA_LED_VOLTAGE_MAX_610) ? (dac) : (COMM_DATA_LED_VOLTAGE_INIT_610);
+        case eComm_Data_Sample_Radiant_550:
+            return (dac > 0 && dac <= COMM_DATA_LED_VOLTAGE_MAX_550) ? (dac) : (COMM_DATA_LED_VOLTAGE_INIT_550);
+        case eComm_Data_Sample_Radiant_405:
+        default:
+            return (dac > 0 && dac <= COMM_DATA_LED_VOLTAGE_MAX_405) ? (dac) : (COMM_DATA_LED_VOLTAGE_INIT_405);
+    }
+}
+
+/**
+ * @brief  LED电压搜索 下一测试点
+ * @param  radiant 波长
+ * @param  dac 当前LED输出电压DAC值
+ * @param  bias 当前白板PD值与目标值偏差 通道均值
+ * @param  overflow PD值越限标志
+ * @note   最近两点割线估算 无可用两点时 目标值两侧均已测试用区间端点割线 只有一点按PD值与DAC值成正比估算
+ * @note   目标值两侧均已测试时 估算值限制在区间内 同侧连续更新或当前PD值越限时二分
+ * @retval 下一测试点 与当前值相同表示无法继续调整
+ */
+static int16_t comm_Data_LED_Search_Next(eComm_Data_Sample_Radiant radiant, int16_t dac, int32_t bias, uint8_t overflow)
+{
+    int16_t next, limit;
+    uint8_t bracket;
+    float slope, estimate;
+    sComm_Data_LED_Search * pSearch = &gComm_Data_LED_Search;
+
+    switch (radiant) {
+        case eComm_Data_Sample_Radiant_610:
+            limit = COMM_DATA_LED_VOLTAGE_MAX_610;
+            break;
+        case eComm_Data_Sample_Radiant_550:
+            limit = COMM_DATA_LED_VOLTAGE_MAX_550;
+            break;
+        case eComm_Data_Sample_Radiant_405:
+        default:
+            limit = COMM_DATA_LED_VOLTAGE_MAX_405;
+            break;
+    }
+
+    bracket = (pSearch->lo_dac >= 0 && pSearch->hi_dac >= 0); /* 目标值两侧均已测试 */
+    if (bracket && pSearch->hi_dac - pSearch->lo_dac <= 1) {  /* 区间已无法缩小 */
+        return dac;
+    }
+
+    if (overflow == 0 && pSearch->last_dac >= 0 && pSearch->last_dac != dac && pSearch->last_bias != bias &&
+        ((bias > pSearch->last_bias) == (dac > pSearch->last_dac))) { /* 最近两点割线 斜率为正 */
+        slope = (float)(bias - pSearch->last_bias) / (dac - pSearch->last_dac);
+        estimate = dac - bias / slope;
+    } else if (bracket && pSearch->hi_overflow == 0) { /* 区间端点割线 */
+        slope = (float)(pSearch->hi_bias - pSearch->lo_bias) / (pSearch->hi_dac - pSearch->lo_dac);
+        estimate = pSearch->lo_dac - pSearch->lo_bias / slope;
+    } else if (overflow) { /* PD值越限 减半 */
+        estimate = dac / 2;
+    } else { /* 单点 按正比估算 */
+        estimate = (float)dac * COMM_DATA_LED_TARGET / (COMM_DATA_LED_TARGET + bias);
+    }
+    if (bracket && (overflow || pSearch->side_repeat >= 2)) { /* 二分 */
+        estimate = (pSearch->lo_dac + pSearch->hi_dac) / 2;
+    }
+
+    if (estimate > limit) {
+        next = limit;
+    } else if (estimate < 1) {
+        next = 1;
+    } else {
+        next = estimate + 0.5;
+    }
+    if (pSearch->lo_dac >= 0 && next <= pSearch->lo_dac) {
+        next = pSearch->lo_dac + 1;
+    } else if (pSearch->hi_dac >= 0 && next >= pSearch->hi_dac) {
+        next = pSearch->hi_dac - 1;
+    }
+    return next;
+}
+
 /**
  * @brief  检查LED测试数据
  * @param  radiant 波长
  * @param  dac LED输出电压DAC值
- * @param  idx 次数索引
- * @note   白板PD值应在 1000万～1400万之间
- * @note   根据测试值调整电压增量间隔 gComm_Data_LED_Voltage_Interval
+ * @param  idx 次数索引 0 开始新的搜索
+ * @note   白板PD值应在 1000万～1400万之间 目标 COMM_DATA_LED_TARGET
+ * @note   根据测试值计算下一测试点 以电压增量间隔 gComm_Data_LED_Voltage_Interval 给出
+ * @note   结束时电压增量间隔指向测试过的最优点
  * @note 610
  * 30  8602768
  * 34  9926537
@@ -712,16 +975,15 @@ void gComm_Data_LED_Voltage_Points_Set(uint8_t points)
  * 480  10901802
  * 496  11307418
  * 528  11716487
- * @retval 0 结束检查 1 继续检查
+ * @retval 0 结束检查 1 继续检查 2 数据类型错误 3 电压越限
  */
 uint8_t comm_Data_Check_LED(eComm_Data_Sample_Radiant radiant, uint16_t dac, uint8_t idx)
 {
-    uint8_t i, j, result = 1;
-    uint32_t sums[6] = {0, 0, 0, 0, 0, 0}, temp_32 = 0, min = 0xFFFFFFFF, max = 0;
-    int16_t sign;
-    int32_t bias_1300 = 0;
-    float cal_inter;
-    static int32_t last_bias_1300 = 0x80000000;
+    uint8_t i, j, overflow;
+    uint32_t sums[6] = {0, 0, 0, 0, 0, 0}, temp_32 = 0, max = 0;
+    int16_t next;
+    int32_t bias = 0;
+    sComm_Data_LED_Search * pSearch = &gComm_Data_LED_Search;
 
     /* 计算总和 */
     for (i = 0; i < ARRAY_LEN(gComm_Data_Samples); ++i) {
@@ -749,110 +1011,55 @@ uint8_t comm_Data_Check_LED(eComm_Data_Sample_Radiant radiant, uint16_t dac, uin
         if (temp_32 > max) {
             max = temp_32;
         }
-        if (temp_32 < min) {
-            min = temp_32;
-        }
-        if (temp_32 >= 13000000) {
-            bias_1300 += temp_32 - 13000000;
-        } else {
-            bias_1300 -= 13000000 - temp_32;
-        }
+        bias += (int32_t)(temp_32) - COMM_DATA_LED_TARGET;
     }
 
-    if (idx < ARRAY_LEN(gComm_Data_LED_SP_Record)) {
-        gComm_Data_LED_SP_Record[idx % 3].dac = dac;
-        gComm_Data_LED_SP_Record[idx % 3].adc_avg = temp_32;
-    } else {
-        memcpy(gComm_Data_LED_SP_Record, gComm_Data_LED_SP_Record + 1, sizeof(sComm_Data_LED_SP_Record));
-        memcpy(gComm_Data_LED_SP_Record + 1, gComm_Data_LED_SP_Record + 2, sizeof(sComm_Data_LED_SP_Record));
-        gComm_Data_LED_SP_Record[2].dac = dac;
-        gComm_Data_LED_SP_Record[2].adc_avg = temp_32;
+    if (idx == 0) { /* 新的搜索 */
+        pSearch->lo_dac = -1;
+        pSearch->hi_dac = -1;
+        pSearch->last_dac = -1;
+        pSearch->side_repeat = 0;
     }
 
-    if (j == 0 || (-20000 < bias_1300 && bias_1300 < 20000)) { /* 没有有效值 或者误差已经足够小 */
-        gComm_Data_LED_Voltage_Interval_Set(0);                /* 不修改间隔结束流程 */
-        last_bias_1300 = 0x80000000;                           /* 初始化历史值 */
-        gComm_Data_LED_Voltage_Points_Set(1);                  /* 点数设为 1 */
+    if (j == 0 || (-COMM_DATA_LED_TOLERANCE < bias && bias < COMM_DATA_LED_TOLERANCE)) { /* 没有有效值 或者误差已经足够小 */
+        gComm_Data_LED_Voltage_Interval_Set(0);                                          /* 不修改间隔结束流程 */
+        gComm_Data_LED_Voltage_Points_Set(1);                                            /* 点数设为 1 */
         return 0;
     }
 
-    bias_1300 = bias_1300 / j;
-    if (max >= 15000000) { /* 最大值越限 */
-        sign = gComm_Data_LED_Voltage_Interval_Get() / 2;
-        if (sign == 0) {
-            gComm_Data_LED_Voltage_Interval_Set(-1);
-            last_bias_1300 = 0x80000000;          /* 初始化历史值 */
-            gComm_Data_LED_Voltage_Points_Set(1); /* 点数设为 1 */
-            if (max != 0xFFFFFF) {
-                return 0;
-            }
-            return 1;
-        } else {
-            if (sign > 0) {
-                sign *= -1;
-            }
-            gComm_Data_LED_Voltage_Interval_Set(sign);
-            bias_1300 = 0x7fffffff;
-            last_bias_1300 = bias_1300;
-            return 1;
-        }
+    bias = bias / j;
+    overflow = (max >= COMM_DATA_LED_OVERFLOW); /* 最大值越限 */
+    if (bias < 0 && overflow == 0) {            /* 低于目标 更新下界 */
+        pSearch->side_repeat = (pSearch->lo_dac >= 0 && pSearch->last_dac == pSearch->lo_dac) ? (pSearch->side_repeat + 1) : (0);
+        pSearch->lo_dac = dac;
+        pSearch->lo_bias = bias;
+    } else { /* 高于目标 更新上界 */
+        pSearch->side_repeat = (pSearch->hi_dac >= 0 && pSearch->last_dac == pSearch->hi_dac) ? (pSearch->side_repeat + 1) : (0);
+        pSearch->hi_dac = dac;
+        pSearch->hi_bias = bias;
+        pSearch->hi_overflow = overflow;
     }
 
-    if (idx == 0) { /* 首次进入 */
-        if (bias_1300 < 0) {
-            sign = 1;
-        } else {
-            sign = -1;
-        }
-        switch (radiant) {
-            case eComm_Data_Sample_Radiant_610:
-                gComm_Data_LED_Voltage_Interval_Set(sign * COMM_DATA_LED_VOLTAGE_UNIT_610);
-                break;
-            case eComm_Data_Sample_Radiant_550:
-                gComm_Data_LED_Voltage_Interval_Set(sign * COMM_DATA_LED_VOLTAGE_UNIT_550);
-                break;
-            case eComm_Data_Sample_Radiant_405:
-                gComm_Data_LED_Voltage_Interval_Set(sign * COMM_DATA_LED_VOLTAGE_UNIT_405);
-                break;
-        }
-        last_bias_1300 = bias_1300;
+    next = comm_Data_LED_Search_Next(radiant, dac, bias, overflow);
+    pSearch->last_dac = (overflow) ? (-1) : (dac); /* 越限点不参与割线估算 */
+    pSearch->last_bias = bias;
+    if (next != dac) {
+        gComm_Data_LED_Voltage_Interval_Set(next - dac);
         return 1;
     }
-    if ((bias_1300 ^ last_bias_1300) < 0) { /* 符号不同 */
-        sign = -1 * gComm_Data_LED_Voltage_Interval_Get() / 2;
-        if (-1.5 < sign && sign < 1.5) {
-            gComm_Data_LED_Voltage_Interval_Set(-1);
-            last_bias_1300 = 0x80000000;          /* 初始化历史值 */
-            gComm_Data_LED_Voltage_Points_Set(1); /* 点数设为 1 */
-            result = 0;
+
+    if (pSearch->lo_dac >= 0 && pSearch->hi_dac >= 0) { /* 区间已无法缩小 取偏差较小一侧 */
+        if (pSearch->hi_overflow == 0 && pSearch->hi_bias < -1 * pSearch->lo_bias) {
+            next = pSearch->hi_dac;
         } else {
-            gComm_Data_LED_Voltage_Interval_Set(sign);
-            result = 1;
-        }
-    } else if (idx >= 2) {
-        cal_inter =
-            (gComm_Data_LED_SP_Record[2].adc_avg - gComm_Data_LED_SP_Record[1].adc_avg) / (gComm_Data_LED_SP_Record[2].dac - gComm_Data_LED_SP_Record[1].dac);
-        cal_inter = (-1 * bias_1300) / cal_inter;
-
-        cal_inter *= 0.8;
-        cal_inter += (cal_inter > 0) ? (0.5) : (-0.5);
-
-        if (fabs(cal_inter) > 2) {
-            if (cal_inter > 200) {
-                cal_inter = 200;
-            } else if (cal_inter < -200) {
-                cal_inter = -200;
-            }
-            gComm_Data_LED_Voltage_Interval_Set(cal_inter);
-        } else if (fabs(cal_inter) < 1) {
-            gComm_Data_LED_Voltage_Interval_Set(0); /* 不修改间隔结束流程 */
-            last_bias_1300 = 0x80000000;            /* 初始化历史值 */
-            gComm_Data_LED_Voltage_Points_Set(1);   /* 点数设为 1 */
-            return 0;
+            next = pSearch->lo_dac;
         }
+        gComm_Data_LED_Voltage_Interval_Set(next - dac);
+        gComm_Data_LED_Voltage_Points_Set(1); /* 点数设为 1 */
+        return 0;
     }
-    last_bias_1300 = bias_1300;
-    return result;
+    gComm_Data_LED_Voltage_Interval_Set(0); /* 已到调整范围边缘 */
+    return 3;
 }
 
 /**
@@ -904,12 +1111,15 @@ uint8_t comm_Data_Sample_Start(void)
     if (gComm_Data_TIM_StartFlag_Check()) { /* 定时器未停止 采样进行中 */
         return 1;
     }
-    gComm_Data_TIM_StartFlag_Set();                       /* 标记定时器启动 */
-    gComm_Data_Sample_Pair_Cnt_Clear();                   /* 清零 采样对次数 */
-    __HAL_TIM_CLEAR_IT(&COMM_DATA_TIM_WH, TIM_IT_UPDATE); /* 清除更新事件标志位 */
-    __HAL_TIM_SET_COUNTER(&COMM_DATA_TIM_WH, 0);          /* 清零定时器计数寄存器 */
-    HAL_TIM_Base_Start_IT(&COMM_DATA_TIM_WH);             /* 启动白板定时器 开始测试 */
-    comm_Data_WH_Time_Deal();                             /* 首次发送 */
+    gComm_Data_TIM_StartFlag_Set();                                                       /* 标记定时器启动 */
+    gComm_Data_Sample_Pair_Cnt_Clear();                                                   /* 清零 采样对次数 */
+    gComm_Data_Sample_Stable_Mask = 0;                                                    /* 清除已稳定通道 */
+    gComm_Data_Sample_Early_Stop = 0;                                                     /* 清除提前结束标志 */
+    __HAL_TIM_SET_AUTORELOAD(&COMM_DATA_TIM_WH, gComm_Data_Sample_Cadence.wh_period - 1); /* 白板周期 */
+    __HAL_TIM_CLEAR_IT(&COMM_DATA_TIM_WH, TIM_IT_UPDATE);                                 /* 清除更新事件标志位 */
+    __HAL_TIM_SET_COUNTER(&COMM_DATA_TIM_WH, 0);                                          /* 清零定时器计数寄存器 */
+    HAL_TIM_Base_Start_IT(&COMM_DATA_TIM_WH);                                             /* 启动白板定时器 开始测试 */
+    comm_Data_WH_Time_Deal();                                                             /* 首次发送 */
     return 0;
 }
 
@@ -934,9 +1144,10 @@ uint8_t comm_Data_sample_Stop(void)
  */
 uint8_t comm_Data_sample_Start_PD(void)
 {
-    __HAL_TIM_CLEAR_IT(&COMM_DATA_TIM_PD, TIM_IT_UPDATE); /* 清除更新事件标志位 */
-    __HAL_TIM_SET_COUNTER(&COMM_DATA_TIM_PD, 0);          /* 清零定时器计数寄存器 */
-    HAL_TIM_Base_Start_IT(&COMM_DATA_TIM_PD);             /* 启动PD定时器 开始测试 */
+    __HAL_TIM_SET_AUTORELOAD(&COMM_DATA_TIM_PD, gComm_Data_Sample_Cadence.pd_delay - 1); /* 白板至PD间隔 */
+    __HAL_TIM_CLEAR_IT(&COMM_DATA_TIM_PD, TIM_IT_UPDATE);                                /* 清除更新事件标志位 */
+    __HAL_TIM_SET_COUNTER(&COMM_DATA_TIM_PD, 0);                                         /* 清零定时器计数寄存器 */
+    HAL_TIM_Base_Start_IT(&COMM_DATA_TIM_PD);                                            /* 启动PD定时器 开始测试 */
     return 0;
 }
 
@@ -1024,7 +1235,8 @@ static BaseType_t comm_Data_Sample_Apply_Conf(uint8_t * pData)
             gComm_Data_Samples[i].conf.points_num = 0; /* 点数清零 */
         }
     }
-    comm_Data_Conf_Sem_Give(); /* 通知电机任务 配置项已下达 */
+    comm_Data_Sample_Cadence_Apply(); /* 采样节奏生效 */
+    comm_Data_Conf_Sem_Give();        /* 通知电机任务 配置项已下达 */
     if (result > 0) {
         return pdPASS;
     }
@@ -1064,6 +1276,7 @@ static BaseType_t comm_Data_Sample_Apply_Conf_FromISR(uint8_t * pData)
             gComm_Data_Samples[i].conf.points_num = 0; /* 点数清零 */
         }
     }
+    comm_Data_Sample_Cadence_Apply();  /* 采样节奏生效 */
     comm_Data_Conf_Sem_Give_FromISR(); /* 通知电机任务 配置项已下达 */
     if (result > 0) {
         return pdPASS;
@@ -1171,6 +1384,7 @@ BaseType_t comm_Data_Sample_Send_Conf_Correct(uint8_t * pData, eComm_Data_Sample
     uint8_t i, sendLength = 0;
 
     gComm_Data_Sample_Max_Point_Clear(); /* 清除最大点数 */
+    comm_Data_Sample_Cadence_Reset();    /* 默认采样节奏 */
     for (i = 0; i < 6; ++i) {
         if (wave == eComm_Data_Sample_Radiant_405 && i > 0) { /* 通道2～6没有405 */
             pData[0 + 3 * i] = eComm_Data_Sample_Assay_None;  /* 测试方法 */
@@ -1285,6 +1499,7 @@ BaseType_t comm_Data_Sample_Send_Conf_Re(void)
         pData[3 * i + 2] = gComm_Data_Samples[i].conf.points_num; /* 测试点数 */
         gComm_Data_Sample_Max_Point_Update(pData[3 * i + 2]);     /* 更新最大点数 */
     }
+    comm_Data_Sample_Cadence_Apply(); /* 采样节奏生效 */
     if (gComm_Data_AgingLoop_Mode_Get() == 0) {
         sendLength = buildPackOrigin(eComm_Data, eComm_Data_Outbound_CMD_CONF, pData, 18); /* 构造测试配置包 */
     } else {
@@ -1514,6 +1729,62 @@ uint8_t comm_Data_Sample_Data_Fetch(uint8_t channel, uint8_t * pBuffer, uint8_t
     return 0;
 }
 
+/**
+ * @brief  采样数据 单点读数
+ * @param  pSample 采样数据记录
+ * @param  idx 点索引
+ * @retval 读数 u16 u32 混合类型取校正值
+ */
+static uint32_t comm_Data_Sample_Point_Value(sComm_Data_Sample const * pSample, uint8_t idx)
+{
+    switch (pSample->data_type) {
+        case 2:
+            return *((uint16_t *)(pSample->raw_datas + 2 * idx));
+        case 4:
+            return *((uint32_t *)(pSample->raw_datas + 4 * idx));
+        case 12:
+            return *((uint16_t *)(pSample->raw_datas + 12 * idx + 10));
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief  采样数据 提前结束判断
+ * @note   最近 stable_points 组相邻点相对偏差均不超过 stable_permille 千分比 视为稳定
+ * @note   需稳定通道全部稳定后 最大点数截至当前采样对次数 下一次采样完成时结束
+ * @param  channel 通道索引 1～6
+ * @retval None
+ */
+static void comm_Data_Sample_Stable_Check(uint8_t channel)
+{
+    sComm_Data_Sample const * pSample = &gComm_Data_Samples[channel - 1];
+    uint8_t i, points = gComm_Data_Sample_Cadence.stable_points;
+    uint32_t prev, curr, diff;
+
+    if (points == 0 || gComm_Data_TIM_StartFlag_Check() == 0 || (gComm_Data_Sample_Stable_Need & (1 << (channel - 1))) == 0) {
+        return;
+    }
+    gComm_Data_Sample_Stable_Mask &= ~(1 << (channel - 1));
+    if (pSample->num <= points || pSample->data_type < 2 || pSample->num * pSample->data_type > sizeof(pSample->raw_datas)) { /* 点数不足 或 类型异常 */
+        return;
+    }
+    for (i = pSample->num - points; i < pSample->num; ++i) {
+        prev = comm_Data_Sample_Point_Value(pSample, i - 1);
+        curr = comm_Data_Sample_Point_Value(pSample, i);
+        diff = (curr > prev) ? (curr - prev) : (prev - curr);
+        if ((uint64_t)(diff) * 1000 > (uint64_t)(prev) * gComm_Data_Sample_Cadence.stable_permille) { /* 偏差超限 */
+            return;
+        }
+    }
+    gComm_Data_Sample_Stable_Mask |= (1 << (channel - 1));
+    if (gComm_Data_Sample_Stable_Mask == gComm_Data_Sample_Stable_Need &&       /* 全部通道稳定 */
+        gComm_Data_Sample_Pair_Cnt_Get() < gComm_Data_Sample_Max_Point_Get()) { /* 尚未到达最大点数 */
+        gComm_Data_Sample_Max_Point = gComm_Data_Sample_Pair_Cnt_Get();         /* 截至当前采样对次数 */
+        gComm_Data_Sample_Early_Stop = 1;                                       /* 标记提前结束 */
+    }
+}
+
 /**
  * @brief  采样数据记录
  * @param  channel 通道索引 1～6 pBuffer 数据输入指针 length 数据输入长度
@@ -1532,6 +1803,10 @@ eComm_Data_Sample_Data comm_Data_Sample_Data_Commit(uint8_t channel, uint8_t * p
     if (replace == 0 && gComm_Data_Samples[channel - 1].num > 0) {
         return eComm_Data_Sample_Data_ERROR;
     }
+    if (length > sizeof(gComm_Data_Samples[0].raw_datas) ||                                           /* 超出记录缓存 */
+        (length == pBuffer[6] * 10 && pBuffer[6] * 12 > sizeof(gComm_Data_Samples[0].raw_datas))) { /* 混合类型 补充校正值后超出 */
+        return eComm_Data_Sample_Data_ERROR;
+    }
 
     gComm_Data_Samples[channel - 1].num = pBuffer[6]; /* 数据个数 u16 | u32 */
 
@@ -1554,12 +1829,16 @@ eComm_Data_Sample_Data comm_Data_Sample_Data_Commit(uint8_t channel, uint8_t * p
             memcpy(gComm_Data_Samples[channel - 1].raw_datas + 12 * result + 10, (uint8_t *)(&buffer16[result]), 2); /* 补充校正值 */
         }
         memcpy(pBuffer + 8, gComm_Data_Samples[channel - 1].raw_datas, length / 10 * 12);
+        comm_Data_Sample_Stable_Check(channel);      /* 提前结束判断 */
+        comm_Data_Sample_Event_Set_FromISR(channel); /* 通知等待任务 */
         return eComm_Data_Sample_Data_MIX;
     } else {                                           /* 异常长度 */
         gComm_Data_Samples[channel - 1].data_type = 1; /* 数据类型标识 */
         result = eComm_Data_Sample_Data_UNKNOW;
     }
     memcpy(gComm_Data_Samples[channel - 1].raw_datas, pBuffer + 8, length); /* 原封不动复制 */
+    comm_Data_Sample_Stable_Check(channel);                                /* 提前结束判断 */
+    comm_Data_Sample_Event_Set_FromISR(channel);                           /* 通知等待任务 */
     return result;
 }
 
@@ -1618,42 +1897,48 @@ uint8_t comm_Data_Sample_Data_Correct(uint8_t channel, uint8_t * pBuffer, uint8_
  */
 void comm_Data_Init(void)
 {
-    BaseType_t xResult;
-
     comm_Data_ConfInit();
     comm_Data_RecordInit();
     comm_Data_GPIO_Init();
 
     /* 接收队列 */
-    comm_Data_RecvQueue = xQueueCreate(3, sizeof(sComm_Data_RecvInfo));
+    comm_Data_RecvQueue = xQueueCreateStatic(3, sizeof(sComm_Data_RecvInfo), comm_Data_RecvQueue_Storage, &comm_Data_RecvQueue_Buffer);
     if (comm_Data_RecvQueue == NULL) {
         FL_Error_Handler(__FILE__, __LINE__);
     }
 
     /* DMA 发送资源信号量*/
-    comm_Data_Send_Sem = xSemaphoreCreateBinary();
+    comm_Data_Send_Sem = xSemaphoreCreateBinaryStatic(&comm_Data_Send_Sem_Buffer);
     if (comm_Data_Send_Sem == NULL) {
         FL_Error_Handler(__FILE__, __LINE__);
     }
     xSemaphoreGive(comm_Data_Send_Sem);
 
     /* 测试配置项信号量 */
-    comm_Data_Conf_Sem = xSemaphoreCreateBinary();
+    comm_Data_Conf_Sem = xSemaphoreCreateBinaryStatic(&comm_Data_Conf_Sem_Buffer);
     if (comm_Data_Conf_Sem == NULL) {
         FL_Error_Handler(__FILE__, __LINE__);
     }
     xSemaphoreTake(comm_Data_Conf_Sem, 0);
 
+    /* 采样数据到达事件 */
+    comm_Data_Sample_Event = xEventGroupCreateStatic(&comm_Data_Sample_Event_Buffer);
+    if (comm_Data_Sample_Event == NULL) {
+        FL_Error_Handler(__FILE__, __LINE__);
+    }
+
     /* 发送队列 */
-    comm_Data_SendQueue = xQueueCreate(COMM_DATA_SEND_QUEU_LENGTH, sizeof(sComm_Data_SendInfo));
+    comm_Data_SendQueue = xQueueCreateStatic(COMM_DATA_SEND_QUEU_LENGTH, sizeof(sComm_Data_SendInfo), comm_Data_SendQueue_Storage, &comm_Data_SendQueue_Buffer);
     if (comm_Data_SendQueue == NULL) {
         FL_Error_Handler(__FILE__, __LINE__);
     }
+    sys_Stat_Queue_Register(comm_Data_SendQueue, eSys_Stat_Queue_Data_Send);
     /* 发送队列 ACK专用 */
-    comm_Data_ACK_SendQueue = xQueueCreate(COMM_DATA_ACK_SEND_QUEU_LENGTH, sizeof(uint8_t));
+    comm_Data_ACK_SendQueue = xQueueCreateStatic(COMM_DATA_ACK_SEND_QUEU_LENGTH, sizeof(uint8_t), comm_Data_ACK_SendQueue_Storage, &comm_Data_ACK_SendQueue_Buffer);
     if (comm_Data_ACK_SendQueue == NULL) {
         FL_Error_Handler(__FILE__, __LINE__);
     }
+    sys_Stat_Queue_Register(comm_Data_ACK_SendQueue, eSys_Stat_Queue_Data_ACK);
 
     /* Start DMA */
     if (HAL_UART_Receive_DMA(&COMM_DATA_UART_HANDLE, gComm_Data_RX_dma_buffer, ARRAY_LEN(gComm_Data_RX_dma_buffer)) != HAL_OK) {
@@ -1661,8 +1946,8 @@ void comm_Data_Init(void)
     }
 
     /* 创建串口发送任务 */
-    xResult = xTaskCreate(comm_Data_Send_Task, "CommDataTX", 256, NULL, TASK_PRIORITY_COMM_DATA_TX, &comm_Data_Send_Task_Handle);
-    if (xResult != pdPASS) {
+    comm_Data_Send_Task_Handle = xTaskCreateStatic(comm_Data_Send_Task, "CommDataTX", ARRAY_LEN(comm_Data_Send_Task_Stack), NULL, TASK_PRIORITY_COMM_DATA_TX, comm_Data_Send_Task_Stack, &comm_Data_Send_Task_TCB);
+    if (comm_Data_Send_Task_Handle == NULL) {
         FL_Error_Handler(__FILE__, __LINE__);
     }
 
@@ -1948,6 +2233,9 @@ void comm_Data_ISR_Deal(void)
                 comm_Data_sample_Stop();                                                 /* 停止白板定时器 终止测试 */
                 comm_Data_sample_Stop_PD();                                              /* 停止PD定时器 终止测试 */
                 gComm_Data_TIM_StartFlag_Clear();                                        /* 清除测试中标志位 */
+                if (gComm_Data_Sample_Early_Stop) {                                      /* 读数稳定 提前结束 */
+                    comm_Data_Sample_Send_Clear_Conf_FromISR();                          /* 通知采样板 */
+                }
             }
             motor_Sample_Info_From_ISR(eMotorNotifyValue_TG); /* 通知电机任务采样完成 */
             if (gComm_Data_Sample_PD_WH_Idx_Get() == 1) {     /* 当前检测白物质 */
@@ -12,6 +12,7 @@
 #include "stdio.h"
 #include "comm_main.h"
 #include "soft_timer.h"
+#include "sys_stat.h"
 
 /* Extern variables ----------------------------------------------------------*/
 extern UART_HandleTypeDef huart1;
@@ -39,14 +40,23 @@ static uint8_t gComm_Main_RX_serial_buffer[COMM_MAIN_SER_RX_SIZE];
 
 /* 串口发送队列 */
 static xQueueHandle comm_Main_SendQueue = NULL;
+static StaticQueue_t comm_Main_SendQueue_Buffer;
+static uint8_t comm_Main_SendQueue_Storage[COMM_MAIN_SEND_QUEU_LENGTH * sizeof(sComm_Main_SendInfo)];
 static xQueueHandle comm_Main_Error_Info_SendQueue = NULL;
+static StaticQueue_t comm_Main_Error_Info_SendQueue_Buffer;
+static uint8_t comm_Main_Error_Info_SendQueue_Storage[COMM_MAIN_ERROR_SEND_QUEU_LENGTH * sizeof(sError_Info)];
 static xQueueHandle comm_Main_ACK_SendQueue = NULL;
+static StaticQueue_t comm_Main_ACK_SendQueue_Buffer;
+static uint8_t comm_Main_ACK_SendQueue_Storage[COMM_MAIN_ACK_SEND_QUEU_LENGTH * sizeof(uint8_t)];
 
 /* 串口DMA发送资源信号量 */
 static xSemaphoreHandle comm_Main_Send_Sem = NULL;
+static StaticSemaphore_t comm_Main_Send_Sem_Buffer;
 
 /* 串口收发任务句柄 */
 static xTaskHandle comm_Main_Send_Task_Handle = NULL;
+static StackType_t comm_Main_Send_Task_Stack[256];
+static StaticTask_t comm_Main_Send_Task_TCB;
 
 /* 串口接收ACK记录 */
 static sProcol_COMM_ACK_Record gComm_Main_ACK_Records[COMM_MAIN_SEND_QUEU_LENGTH];
@@ -207,32 +217,33 @@ void comm_Main_DMA_RX_Restore(void)
  */
 void comm_Main_Init(void)
 {
-    BaseType_t xResult;
-
     comm_Main_ConfInit();
 
     /* DMA 发送资源信号量*/
-    comm_Main_Send_Sem = xSemaphoreCreateBinary();
+    comm_Main_Send_Sem = xSemaphoreCreateBinaryStatic(&comm_Main_Send_Sem_Buffer);
     if (comm_Main_Send_Sem == NULL) {
         FL_Error_Handler(__FILE__, __LINE__);
     }
     xSemaphoreGive(comm_Main_Send_Sem);
 
     /* 发送队列 */
-    comm_Main_SendQueue = xQueueCreate(COMM_MAIN_SEND_QUEU_LENGTH, sizeof(sComm_Main_SendInfo));
+    comm_Main_SendQueue = xQueueCreateStatic(COMM_MAIN_SEND_QUEU_LENGTH, sizeof(sComm_Main_SendInfo), comm_Main_SendQueue_Storage, &comm_Main_SendQueue_Buffer);
     if (comm_Main_SendQueue == NULL) {
         FL_Error_Handler(__FILE__, __LINE__);
     }
+    sys_Stat_Queue_Register(comm_Main_SendQueue, eSys_Stat_Queue_Main_Send);
     /* 发送队列 错误信息专用 */
-    comm_Main_Error_Info_SendQueue = xQueueCreate(COMM_MAIN_ERROR_SEND_QUEU_LENGTH, sizeof(uint16_t));
+    comm_Main_Error_Info_SendQueue = xQueueCreateStatic(COMM_MAIN_ERROR_SEND_QUEU_LENGTH, sizeof(sError_Info), comm_Main_Error_Info_SendQueue_Storage, &comm_Main_Error_Info_SendQueue_Buffer);
     if (comm_Main_Error_Info_SendQueue == NULL) {
         FL_Error_Handler(__FILE__, __LINE__);
     }
+    sys_Stat_Queue_Register(comm_Main_Error_Info_SendQueue, eSys_Stat_Queue_Main_Error);
     /* 发送队列 ACK专用 */
-    comm_Main_ACK_SendQueue = xQueueCreate(COMM_MAIN_ACK_SEND_QUEU_LENGTH, sizeof(uint8_t));
+    comm_Main_ACK_SendQueue = xQueueCreateStatic(COMM_MAIN_ACK_SEND_QUEU_LENGTH, sizeof(uint8_t), comm_Main_ACK_SendQueue_Storage, &comm_Main_ACK_SendQueue_Buffer);
     if (comm_Main_ACK_SendQueue == NULL) {
         FL_Error_Handler(__FILE__, __LINE__);
     }
+    sys_Stat_Queue_Register(comm_Main_ACK_SendQueue, eSys_Stat_Queue_Main_ACK);
 
     /* Start DMA */
     if (HAL_UART_Receive_DMA(&COMM_MAIN_UART_HANDLE, gComm_Main_RX_dma_buffer, ARRAY_LEN(gComm_Main_RX_dma_buffer)) != HAL_OK) {
@@ -240,8 +251,8 @@ void comm_Main_Init(void)
     }
 
     /* 创建串口发送任务 */
-    xResult = xTaskCreate(comm_Main_Send_Task, "CommMainTX", 256, NULL, TASK_PRIORITY_COMM_MAIN_TX, &comm_Main_Send_Task_Handle);
-    if (xResult != pdPASS) {
+    comm_Main_Send_Task_Handle = xTaskCreateStatic(comm_Main_Send_Task, "CommMainTX", ARRAY_LEN(comm_Main_Send_Task_Stack), NULL, TASK_PRIORITY_COMM_MAIN_TX, comm_Main_Send_Task_Stack, &comm_Main_Send_Task_TCB);
+    if (comm_Main_Send_Task_Handle == NULL) {
         FL_Error_Handler(__FILE__, __LINE__);
     }
 
@@ -430,26 +441,26 @@ BaseType_t comm_Main_SendTask_QueueEmitWithBuild_FromISR(uint8_t cmdType, uint8_
 
 /**
  * @brief  加入串口发送队列
- * @param  pErrorCode   错误码指针
+ * @param  pErrorInfo   故障上送信息指针
  * @param  timeout      超时时间
  * @retval 加入发送队列结果
  */
-BaseType_t comm_Main_SendTask_ErrorInfoQueueEmit(uint16_t * pErrorCode, uint32_t timeout)
+BaseType_t comm_Main_SendTask_ErrorInfoQueueEmit(sError_Info * pErrorInfo, uint32_t timeout)
 {
     BaseType_t xResult;
-    xResult = xQueueSendToBack(comm_Main_Error_Info_SendQueue, pErrorCode, pdMS_TO_TICKS(timeout));
+    xResult = xQueueSendToBack(comm_Main_Error_Info_SendQueue, pErrorInfo, pdMS_TO_TICKS(timeout));
     return xResult;
 }
 
 /**
  * @brief  加入串口发送队列 中断版本
- * @param  pErrorCode   错误码指针
+ * @param  pErrorInfo   故障上送信息指针
  * @retval 加入发送队列结果
  */
-BaseType_t comm_Main_SendTask_ErrorInfoQueueEmitFromISR(uint16_t * pErrorCode)
+BaseType_t comm_Main_SendTask_ErrorInfoQueueEmitFromISR(sError_Info * pErrorInfo)
 {
     BaseType_t xResult, xHigherPriorityTaskWoken = pdFALSE;
-    xResult = xQueueSendToBackFromISR(comm_Main_Error_Info_SendQueue, pErrorCode, &xHigherPriorityTaskWoken);
+    xResult = xQueueSendToBackFromISR(comm_Main_Error_Info_SendQueue, pErrorInfo, &xHigherPriorityTaskWoken);
     if (xResult == pdTRUE) {
         portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
     }
@@ -554,7 +565,7 @@ BaseType_t comm_Main_Send_ACK_Wait(uint8_t packIndex)
 static void comm_Main_Send_Task(void * argument)
 {
     sComm_Main_SendInfo sendInfo;
-    uint16_t errorCode;
+    sError_Info errorInfo;
     uint8_t i, ucResult;
     static uint8_t last_result = 0;
 
@@ -566,10 +577,10 @@ static void comm_Main_Send_Task(void * argument)
 
         comm_Main_SendTask_ACK_Consume(10); /* 处理 ACK发送需求 */
 
-        if (xQueueReceive(comm_Main_Error_Info_SendQueue, &errorCode, 0) == pdPASS) {                      /* 查看错误信息队列 */
-            memcpy(sendInfo.buff, (uint8_t *)(&errorCode), 2);                                             /* 错误代码 */
-            sendInfo.length = buildPackOrigin(eComm_Main, eProtocolRespPack_Client_ERR, sendInfo.buff, 2); /* 构造数据包 */
-        } else if (xQueueReceive(comm_Main_SendQueue, &sendInfo, pdMS_TO_TICKS(10)) != pdPASS) {           /* 发送队列为空 */
+        if (xQueueReceive(comm_Main_Error_Info_SendQueue, &errorInfo, 0) == pdPASS) {                                    /* 查看错误信息队列 */
+            sendInfo.length = error_Info_Pack(&errorInfo, sendInfo.buff);                                                /* 错误代码 [合并次数 时段] */
+            sendInfo.length = buildPackOrigin(eComm_Main, eProtocolRespPack_Client_ERR, sendInfo.buff, sendInfo.length); /* 构造数据包 */
+        } else if (xQueueReceive(comm_Main_SendQueue, &sendInfo, pdMS_TO_TICKS(10)) != pdPASS) {                         /* 发送队列为空 */
             continue;
         }
         ucResult = 0; /* 发送结果初始化 */
@@ -16,6 +16,7 @@
 #include "tray_run.h"
 #include "m_drv8824.h"
 #include "soft_timer.h"
+#include "sys_stat.h"
 
 /* Extern variables ----------------------------------------------------------*/
 extern UART_HandleTypeDef huart5;
@@ -47,14 +48,23 @@ static uint8_t gComm_Out_RX_serial_buffer[COMM_OUT_SER_RX_SIZE];
 
 /* 串口发送队列 */
 static xQueueHandle comm_Out_SendQueue = NULL;
+static StaticQueue_t comm_Out_SendQueue_Buffer;
+static uint8_t comm_Out_SendQueue_Storage[COMM_OUT_SEND_QUEU_LENGTH * sizeof(sComm_Out_SendInfo)];
 static xQueueHandle comm_Out_Error_Info_SendQueue = NULL;
+static StaticQueue_t comm_Out_Error_Info_SendQueue_Buffer;
+static uint8_t comm_Out_Error_Info_SendQueue_Storage[COMM_OUT_ERROR_SEND_QUEU_LENGTH * sizeof(sError_Info)];
 static xQueueHandle comm_Out_ACK_SendQueue = NULL;
+static StaticQueue_t comm_Out_ACK_SendQueue_Buffer;
+static uint8_t comm_Out_ACK_SendQueue_Storage[COMM_OUT_ACK_SEND_QUEU_LENGTH * sizeof(uint8_t)];
 
 /* 串口DMA发送资源信号量 */
 static xSemaphoreHandle comm_Out_Send_Sem = NULL;
+static StaticSemaphore_t comm_Out_Send_Sem_Buffer;
 
 /* 串口发送任务句柄 */
 static xTaskHandle comm_Out_Send_Task_Handle = NULL;
+static StackType_t comm_Out_Send_Task_Stack[256];
+static StaticTask_t comm_Out_Send_Task_TCB;
 
 /* 串口接收ACK记录 */
 static sProcol_COMM_ACK_Record gComm_Out_ACK_Records[COMM_OUT_SEND_QUEU_LENGTH];
@@ -213,32 +223,33 @@ void comm_Out_DMA_RX_Restore(void)
  */
 void comm_Out_Init(void)
 {
-    BaseType_t xResult;
-
     comm_Out_ConfInit();
 
     /* DMA 发送资源信号量*/
-    comm_Out_Send_Sem = xSemaphoreCreateBinary();
+    comm_Out_Send_Sem = xSemaphoreCreateBinaryStatic(&comm_Out_Send_Sem_Buffer);
     if (comm_Out_Send_Sem == NULL) {
         FL_Error_Handler(__FILE__, __LINE__);
     }
     xSemaphoreGive(comm_Out_Send_Sem);
 
     /* 发送队列 */
-    comm_Out_SendQueue = xQueueCreate(COMM_OUT_SEND_QUEU_LENGTH, sizeof(sComm_Out_SendInfo));
+    comm_Out_SendQueue = xQueueCreateStatic(COMM_OUT_SEND_QUEU_LENGTH, sizeof(sComm_Out_SendInfo), comm_Out_SendQueue_Storage, &comm_Out_SendQueue_Buffer);
     if (comm_Out_SendQueue == NULL) {
         FL_Error_Handler(__FILE__, __LINE__);
     }
+    sys_Stat_Queue_Register(comm_Out_SendQueue, eSys_Stat_Queue_Out_Send);
     /* 发送队列 错误信息专用 */
-    comm_Out_Error_Info_SendQueue = xQueueCreate(COMM_OUT_ERROR_SEND_QUEU_LENGTH, sizeof(uint16_t));
+    comm_Out_Error_Info_SendQueue = xQueueCreateStatic(COMM_OUT_ERROR_SEND_QUEU_LENGTH, sizeof(sError_Info), comm_Out_Error_Info_SendQueue_Storage, &comm_Out_Error_Info_SendQueue_Buffer);
     if (comm_Out_Error_Info_SendQueue == NULL) {
         FL_Error_Handler(__FILE__, __LINE__);
     }
+    sys_Stat_Queue_Register(comm_Out_Error_Info_SendQueue, eSys_Stat_Queue_Out_Error);
     /* 发送队列 ACK专用 */
-    comm_Out_ACK_SendQueue = xQueueCreate(COMM_OUT_ACK_SEND_QUEU_LENGTH, sizeof(uint8_t));
+    comm_Out_ACK_SendQueue = xQueueCreateStatic(COMM_OUT_ACK_SEND_QUEU_LENGTH, sizeof(uint8_t), comm_Out_ACK_SendQueue_Storage, &comm_Out_ACK_SendQueue_Buffer);
     if (comm_Out_ACK_SendQueue == NULL) {
         FL_Error_Handler(__FILE__, __LINE__);
     }
+    sys_Stat_Queue_Register(comm_Out_ACK_SendQueue, eSys_Stat_Queue_Out_ACK);
 
     /* Start DMA */
     if (HAL_UART_Receive_DMA(&COMM_OUT_UART_HANDLE, gComm_Out_RX_dma_buffer, ARRAY_LEN(gComm_Out_RX_dma_buffer)) != HAL_OK) {
@@ -246,8 +257,8 @@ void comm_Out_Init(void)
     }
 
     /* 创建串口发送任务 */
-    xResult = xTaskCreate(comm_Out_Send_Task, "CommOutTX", 256, NULL, TASK_PRIORITY_COMM_OUT_TX, &comm_Out_Send_Task_Handle);
-    if (xResult != pdPASS) {
+    comm_Out_Send_Task_Handle = xTaskCreateStatic(comm_Out_Send_Task, "CommOutTX", ARRAY_LEN(comm_Out_Send_Task_Stack), NULL, TASK_PRIORITY_COMM_OUT_TX, comm_Out_Send_Task_Stack, &comm_Out_Send_Task_TCB);
+    if (comm_Out_Send_Task_Handle == NULL) {
         FL_Error_Handler(__FILE__, __LINE__);
     }
 
@@ -265,6 +276,16 @@ UBaseType_t comm_Out_SendTask_Queue_GetWaiting(void)
     return uxQueueMessagesWaiting(comm_Out_SendQueue);
 }
 
+/**
+ * @brief  串口发送队列 空闲 中断版本
+ * @param  None
+ * @retval 串口发送队列 空闲
+ */
+UBaseType_t comm_Out_SendTask_Queue_GetFree_FromISR(void)
+{
+    return COMM_OUT_SEND_QUEU_LENGTH - uxQueueMessagesWaitingFromISR(comm_Out_SendQueue);
+}
+
 /**
  * @brief  加入串口发送队列
  * @param  pData   数据指针
@@ -423,23 +444,23 @@ BaseType_t comm_Out_SendTask_QueueEmitWithBuild_FromISR(uint8_t cmdType, uint8_t
 
 /**
  * @brief  加入串口发送队列
- * @param  pErrorCode   错误码指针
+ * @param  pErrorInfo   故障上送信息指针
  * @param  timeout      超时时间
  * @retval 加入发送队列结果
  */
-BaseType_t comm_Out_SendTask_ErrorInfoQueueEmit(uint16_t * pErrorCode, uint32_t timeout)
+BaseType_t comm_Out_SendTask_ErrorInfoQueueEmit(sError_Info * pErrorInfo, uint32_t timeout)
 {
     BaseType_t xResult;
-    xResult = xQueueSendToBack(comm_Out_Error_Info_SendQueue, pErrorCode, pdMS_TO_TICKS(timeout));
+    xResult = xQueueSendToBack(comm_Out_Error_Info_SendQueue, pErrorInfo, pdMS_TO_TICKS(timeout));
     return xResult;
 }
 
 /**
  * @brief  加入串口发送队列 中断版本
- * @param  pErrorCode   错误码指针
+ * @param  pErrorInfo   故障上送信息指针
  * @retval 加入发送队列结果
  */
-BaseType_t comm_Out_SendTask_ErrorInfoQueueEmitFromISR(uint16_t * pErrorCode)
+BaseType_t comm_Out_SendTask_ErrorInfoQueueEmitFromISR(sError_Info * pErrorInfo)
 {
     BaseType_t xResult, xHigherPriorityTaskWoken = pdFALSE;
 
@@ -447,7 +468,7 @@ BaseType_t comm_Out_SendTask_ErrorInfoQueueEmitFromISR(uint16_t * pErrorCode)
         return pdFALSE;
     }
 
-    xResult = xQueueSendToBackFromISR(comm_Out_Error_Info_SendQueue, pErrorCode, &xHigherPriorityTaskWoken);
+    xResult = xQueueSendToBackFromISR(comm_Out_Error_Info_SendQueue, pErrorInfo, &xHigherPriorityTaskWoken);
     if (xResult) {
         portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
     }
@@ -547,7 +568,7 @@ BaseType_t comm_Out_Send_ACK_Wait(uint8_t packIndex)
  */
 static void comm_Out_Send_Task(void * argument)
 {
-    uint16_t errorCode;
+    sError_Info errorInfo;
     sComm_Out_SendInfo sendInfo;
     uint8_t i, ucResult;
     static uint8_t last_result = 0;
@@ -560,10 +581,10 @@ static void comm_Out_Send_Task(void * argument)
 
         comm_Out_SendTask_ACK_Consume(10); /* 处理 ACK发送需求 */
 
-        if (xQueueReceive(comm_Out_Error_Info_SendQueue, &errorCode, 0) == pdPASS) {                      /* 查看错误信息队列 */
-            memcpy(sendInfo.buff, (uint8_t *)(&errorCode), 2);                                            /* 错误代码 */
-            sendInfo.length = buildPackOrigin(eComm_Out, eProtocolRespPack_Client_ERR, sendInfo.buff, 2); /* 构造数据包 */
-        } else if (xQueueReceive(comm_Out_SendQueue, &sendInfo, pdMS_TO_TICKS(10)) != pdPASS) {           /* 发送队列为空 */
+        if (xQueueReceive(comm_Out_Error_Info_SendQueue, &errorInfo, 0) == pdPASS) {                                    /* 查看错误信息队列 */
+            sendInfo.length = error_Info_Pack(&errorInfo, sendInfo.buff);                                               /* 错误代码 [合并次数 时段] */
+            sendInfo.length = buildPackOrigin(eComm_Out, eProtocolRespPack_Client_ERR, sendInfo.buff, sendInfo.length); /* 构造数据包 */
+        } else if (xQueueReceive(comm_Out_SendQueue, &sendInfo, pdMS_TO_TICKS(10)) != pdPASS) {                         /* 发送队列为空 */
             continue;
         }
         ucResult = 0; /* 发送结果初始化 */
@@ -15,12 +15,33 @@
 /* Private includes ----------------------------------------------------------*/
 
 /* Private typedef -----------------------------------------------------------*/
+/* 限流记录 每个错误码一个窗口 */
+typedef struct {
+    uint16_t code;    /* 错误码 0 为空闲 */
+    uint16_t count;   /* 窗口内合并次数 */
+    TickType_t start; /* 窗口起始时间 */
+} sError_Rate_Slot;
+
+/* 故障上送统计 */
+typedef struct {
+    uint32_t emit;      /* 提交次数 */
+    uint32_t coalesced; /* 合并次数 */
+    uint32_t summary;   /* 合并帧数 */
+    uint32_t dropped;   /* 错误信息队列满丢弃次数 */
+    uint32_t untracked; /* 限流记录槽满 不限流次数 */
+} sError_Stat;
 
 /* Private define ------------------------------------------------------------*/
+#define ERROR_RATE_SLOT_NUM 16                  /* 限流记录槽数 同时限流的错误码种类上限 */
+#define ERROR_RATE_WINDOW (pdMS_TO_TICKS(1000)) /* 限流窗口 同一错误码窗口内只上送一次 其余合并 */
+#define ERROR_INFO_PACK_LEN_SINGLE (2)          /* 单次上送 错误码 */
+#define ERROR_INFO_PACK_LEN_SUMMARY (6)         /* 合并上送 错误码 + 次数 + 时段 */
 
 /* Private macro -------------------------------------------------------------*/
 
 /* Private variables ---------------------------------------------------------*/
+static sError_Rate_Slot gError_Rate_Slots[ERROR_RATE_SLOT_NUM];
+static sError_Stat gError_Stat;
 
 /* Private constants ---------------------------------------------------------*/
 
@@ -29,23 +50,19 @@
 /* Private user code ---------------------------------------------------------*/
 
 /**
- * @brief  发送故障信息到串口任务
+ * @brief  故障信息上送串口
  * @param  code 错误码
- * @retval None
+ * @retval 0b10 主串口 0b01 外串口 0 不上送
  */
-void error_Emit(eError_Code code)
+static uint8_t error_Out_Mark(uint16_t code)
 {
-    uint16_t errorCode;
-    uint8_t out_mark = 0b11;
-
     switch (code) {
         case eError_Comm_Main_Send_Failed: /* 主串口发送失败 */
         case eError_Comm_Main_Not_ACK:     /* 主串口没有收到ACK */
         case eError_Comm_Main_Wrong_ID:    /* 主串口异常ID */
         case eError_Comm_Main_Unknow_CMD:  /* 主串口异常功能码 */
         case eError_Comm_Main_Param_Error: /* 主串口报文参数异常 */
-            out_mark = 0b10;
-            break;
+            return 0b10;
         /* 外串口故障不能发送到主串口 */
         case eError_Comm_Main_Busy:       /* 主串口发送忙 */
         case eError_Comm_Out_Busy:        /* 外串口发送忙 */
@@ -54,84 +71,252 @@ void error_Emit(eError_Code code)
         case eError_Comm_Out_Wrong_ID:    /* 外串口异常ID */
         case eError_Comm_Out_Unknow_CMD:  /* 外串口异常功能码 */
         case eError_Comm_Out_Param_Error: /* 外串口报文参数异常 */
-            out_mark = 0b01;
-            break;
+            return 0b01;
         /* 错误调试不发送到主串口 */
         case eError_Motor_Heater_Debug: /* 上加热体电机错误调试 */
         case eError_Motor_White_Debug:  /* 白板电机错误调试 */
         case eError_Motor_Tray_Debug:   /* 托盘电机错误调试 */
         case eError_Motor_Scan_Debug:   /* 扫码电机错误调试 */
         case eError_Scan_Debug:         /* 扫码枪错误调试 */
-            out_mark = 0b00;
-            break;
+            return 0b00;
         default:
+            return 0b11;
+    }
+}
+
+/**
+ * @brief  限流判断
+ * @note   须在临界区内调用
+ * @note   窗口内首次直接上送 其余计数合并 由 error_Rate_Deal 窗口结束时合并上送
+ * @param  code 错误码
+ * @param  now 当前时间
+ * @retval 0 已合并 1 需上送
+ */
+static uint8_t error_Rate_Check(uint16_t code, TickType_t now)
+{
+    sError_Rate_Slot * pSlot = NULL;
+    uint8_t i;
+
+    ++gError_Stat.emit;
+    for (i = 0; i < ARRAY_LEN(gError_Rate_Slots); ++i) {
+        if (gError_Rate_Slots[i].code == code) { /* 窗口内已上送过 */
+            pSlot = &gError_Rate_Slots[i];
             break;
+        }
+        if (pSlot == NULL && gError_Rate_Slots[i].code == 0) { /* 记录首个空闲槽 */
+            pSlot = &gError_Rate_Slots[i];
+        }
+    }
+    if (pSlot == NULL) { /* 记录槽满 不限流 */
+        ++gError_Stat.untracked;
+        return 1;
     }
+    if (pSlot->code == code && (pSlot->count > 0 || now - pSlot->start < ERROR_RATE_WINDOW)) { /* 窗口内重复 */
+        if (pSlot->count < UINT16_MAX) {
+            ++pSlot->count;
+        }
+        ++gError_Stat.coalesced;
+        return 0;
+    }
+    pSlot->code = code; /* 开启新窗口 */
+    pSlot->count = 0;
+    pSlot->start = now;
+    return 1;
+}
 
-    if (out_mark == 0) {
-        return; /* 直接返回 */
+/**
+ * @brief  故障信息 加入串口错误信息队列
+ * @param  pInfo 故障上送信息
+ * @param  out_mark 上送串口
+ * @retval None
+ */
+static void error_Info_Send(sError_Info * pInfo, uint8_t out_mark)
+{
+    uint8_t dropped = 0;
+
+    if ((out_mark & 0b10) && comm_Main_SendTask_ErrorInfoQueueEmit(pInfo, 0) != pdPASS) { /* 发送给主板串口 */
+        ++dropped;
     }
+    if (protocol_Debug_ErrorReport() && (out_mark & 0b01) && comm_Out_SendTask_ErrorInfoQueueEmit(pInfo, 0) != pdPASS) { /* 发送给外串口 */
+        ++dropped;
+    }
+    if (dropped > 0) {
+        taskENTER_CRITICAL(); /* 任务与中断均会累加 与限流判断同样在临界区内修改统计 */
+        gError_Stat.dropped += dropped;
+        taskEXIT_CRITICAL();
+    }
+}
 
-    errorCode = code;
+/**
+ * @brief  故障信息 加入串口错误信息队列 中断版本
+ * @param  pInfo 故障上送信息
+ * @param  out_mark 上送串口
+ * @retval None
+ */
+static void error_Info_Send_FromISR(sError_Info * pInfo, uint8_t out_mark)
+{
+    uint8_t dropped = 0;
+    UBaseType_t uxSavedInterruptStatus;
 
-    if (out_mark & 0b10) {                                    /* 主串口标志 */
-        comm_Main_SendTask_ErrorInfoQueueEmit(&errorCode, 0); /* 发送给主板串口 */
+    if ((out_mark & 0b10) && comm_Main_SendTask_ErrorInfoQueueEmitFromISR(pInfo) != pdPASS) { /* 发送给主板串口 */
+        ++dropped;
     }
-    if (protocol_Debug_ErrorReport() && (out_mark & 0b01)) { /* 外串口标志 */
-        comm_Out_SendTask_ErrorInfoQueueEmit(&errorCode, 0); /* 发送给外串口 */
+    if (protocol_Debug_ErrorReport() && (out_mark & 0b01) && comm_Out_SendTask_ErrorInfoQueueEmitFromISR(pInfo) != pdPASS) { /* 发送给外串口 */
+        ++dropped;
+    }
+    if (dropped > 0) {
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR(); /* 可被更高优先级中断抢占 */
+        gError_Stat.dropped += dropped;
+        taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
     }
 }
 
 /**
- * @brief  发送故障信息到串口任务 中断版本
+ * @brief  发送故障信息到串口任务
+ * @note   同一错误码 ERROR_RATE_WINDOW 内只上送一次 重复部分合并为一帧上送
  * @param  code 错误码
  * @retval None
  */
-void error_Emit_FromISR(eError_Code code)
+void error_Emit(eError_Code code)
 {
-    uint16_t errorCode;
-    uint8_t out_mark = 0b11;
+    sError_Info info = {code, 1, 0};
+    uint8_t out_mark, pass;
 
-    switch (code) {
-        case eError_Comm_Main_Send_Failed: /* 主串口发送失败 */
-        case eError_Comm_Main_Not_ACK:     /* 主串口没有收到ACK */
-        case eError_Comm_Main_Wrong_ID:    /* 主串口异常ID */
-        case eError_Comm_Main_Unknow_CMD:  /* 主串口异常功能码 */
-        case eError_Comm_Main_Param_Error: /* 主串口报文参数异常 */
-            out_mark = 0b10;
-            break;
-        /* 外串口故障不能发送到主串口 */
-        case eError_Comm_Main_Busy:       /* 主串口发送忙 */
-        case eError_Comm_Out_Busy:        /* 外串口发送忙 */
-        case eError_Comm_Out_Send_Failed: /* 外串口发送失败 */
-        case eError_Comm_Out_Not_ACK:     /* 外串口没有收到ACK */
-        case eError_Comm_Out_Wrong_ID:    /* 外串口异常ID */
-        case eError_Comm_Out_Unknow_CMD:  /* 外串口异常功能码 */
-        case eError_Comm_Out_Param_Error: /* 外串口报文参数异常 */
-            out_mark = 0b01;
-            break;
-        /* 错误调试不发送到主串口 */
-        case eError_Motor_Heater_Debug: /* 上加热体电机错误调试 */
-        case eError_Motor_White_Debug:  /* 白板电机错误调试 */
-        case eError_Motor_Tray_Debug:   /* 托盘电机错误调试 */
-        case eError_Motor_Scan_Debug:   /* 扫码电机错误调试 */
-        case eError_Scan_Debug:         /* 扫码枪错误调试 */
-            out_mark = 0b00;
-            break;
-        default:
-            break;
+    out_mark = error_Out_Mark(code);
+    if (out_mark == 0) {
+        return; /* 直接返回 */
     }
 
+    taskENTER_CRITICAL();
+    pass = error_Rate_Check(code, xTaskGetTickCount());
+    taskEXIT_CRITICAL();
+    if (pass) {
+        error_Info_Send(&info, out_mark);
+    }
+}
+
+/**
+ * @brief  发送故障信息到串口任务 中断版本
+ * @param  code 错误码
+ * @retval None
+ */
+void error_Emit_FromISR(eError_Code code)
+{
+    sError_Info info = {code, 1, 0};
+    uint8_t out_mark, pass;
+    UBaseType_t uxSavedInterruptStatus;
+
+    out_mark = error_Out_Mark(code);
     if (out_mark == 0) {
         return; /* 直接返回 */
     }
 
-    errorCode = code;
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    pass = error_Rate_Check(code, xTaskGetTickCountFromISR());
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+    if (pass) {
+        error_Info_Send_FromISR(&info, out_mark);
+    }
+}
 
-    if (out_mark & 0b10) {                                        /* 主串口标志 */
-        comm_Main_SendTask_ErrorInfoQueueEmitFromISR(&errorCode); /* 发送给主板串口 */
+/**
+ * @brief  限流窗口处理 合并上送
+ * @note   周期调用 软定时器 100mS 窗口结束时 有合并次数则上送合并帧并开启下一窗口 否则释放记录槽
+ * @param  None
+ * @retval None
+ */
+void error_Rate_Deal(void)
+{
+    sError_Info info;
+    TickType_t now;
+    uint8_t i;
+
+    for (i = 0; i < ARRAY_LEN(gError_Rate_Slots); ++i) {
+        info.count = 0;
+        taskENTER_CRITICAL();
+        now = xTaskGetTickCount();
+        if (gError_Rate_Slots[i].code != 0 && now - gError_Rate_Slots[i].start >= ERROR_RATE_WINDOW) { /* 窗口结束 */
+            if (gError_Rate_Slots[i].count > 0) {                                                        /* 存在合并次数 */
+                info.code = gError_Rate_Slots[i].code;
+                info.count = gError_Rate_Slots[i].count;
+                info.span = ((now - gError_Rate_Slots[i].start) * portTICK_PERIOD_MS > UINT16_MAX) ? (UINT16_MAX) : ((now - gError_Rate_Slots[i].start) * portTICK_PERIOD_MS);
+                gError_Rate_Slots[i].count = 0;   /* 开启下一窗口 持续重复时每窗口一帧 */
+                gError_Rate_Slots[i].start = now;
+                ++gError_Stat.summary;
+            } else {
+                gError_Rate_Slots[i].code = 0; /* 释放记录槽 */
+            }
+        }
+        taskEXIT_CRITICAL();
+        if (info.count > 0) {
+            error_Info_Send(&info, error_Out_Mark(info.code));
+        }
     }
-    if (protocol_Debug_ErrorReport() && (out_mark & 0b01)) {     /* 外串口标志 */
-        comm_Out_SendTask_ErrorInfoQueueEmitFromISR(&errorCode); /* 发送给外串口 */
+}
+
+/**
+ * @brief  故障上送信息 打包
+ * @note   单次上送 错误码 2字节 合并上送 错误码 + 次数 + 时段mS 各2字节
+ * @param  pInfo 故障上送信息
+ * @param  pBuffer 输出指针
+ * @retval 输出长度
+ */
+uint8_t error_Info_Pack(sError_Info const * pInfo, uint8_t * pBuffer)
+{
+    pBuffer[0] = pInfo->code & 0xFF;
+    pBuffer[1] = pInfo->code >> 8;
+    if (pInfo->count <= 1) {
+        return ERROR_INFO_PACK_LEN_SINGLE;
     }
+    pBuffer[2] = pInfo->count & 0xFF;
+    pBuffer[3] = pInfo->count >> 8;
+    pBuffer[4] = pInfo->span & 0xFF;
+    pBuffer[5] = pInfo->span >> 8;
+    return ERROR_INFO_PACK_LEN_SUMMARY;
+}
+
+/**
+ * @brief  故障上送统计 打包
+ * @note   标识 + 提交次数 + 合并次数 + 合并帧数 + 队列满丢弃次数 + 记录槽满不限流次数 各4字节
+ * @note   可在中断中调用 统计值为清零以来
+ * @param  pBuffer 输出指针
+ * @retval 输出长度
+ */
+uint8_t error_Stat_Pack(uint8_t * pBuffer)
+{
+    uint32_t data[5];
+    UBaseType_t uxSavedInterruptStatus;
+    uint8_t i, length = 0;
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    data[0] = gError_Stat.emit;
+    data[1] = gError_Stat.coalesced;
+    data[2] = gError_Stat.summary;
+    data[3] = gError_Stat.dropped;
+    data[4] = gError_Stat.untracked;
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+
+    pBuffer[length++] = ERROR_TAG_STAT;
+    for (i = 0; i < ARRAY_LEN(data); ++i) {
+        pBuffer[length++] = data[i] >> 0;
+        pBuffer[length++] = data[i] >> 8;
+        pBuffer[length++] = data[i] >> 16;
+        pBuffer[length++] = data[i] >> 24;
+    }
+    return length;
+}
+
+/**
+ * @brief  故障上送统计 清零
+ * @note   可在中断中调用
+ * @param  None
+ * @retval None
+ */
+void error_Stat_Clear(void)
+{
+    UBaseType_t uxSavedInterruptStatus;
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    memset(&gError_Stat, 0, sizeof(gError_Stat));
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
 }
@@ -25,7 +25,7 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */     
-
+#include "sys_stat.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -53,6 +53,23 @@
    
 /* USER CODE END FunctionPrototypes */
 
+/* Hook prototypes */
+void configureTimerForRunTimeStats(void);
+unsigned long getRunTimeCounterValue(void);
+
+/* USER CODE BEGIN 1 */
+/* Functions needed when configGENERATE_RUN_TIME_STATS is on */
+void configureTimerForRunTimeStats(void)
+{
+    sys_Stat_Run_Time_Init();
+}
+
+unsigned long getRunTimeCounterValue(void)
+{
+    return sys_Stat_Run_Time_Get();
+}
+/* USER CODE END 1 */
+
 /* Private application code --------------------------------------------------*/
 /* USER CODE BEGIN Application */
      
@@ -7,6 +7,7 @@
 #include "main.h"
 #include "motor.h"
 #include "m_drv8824.h"
+#include "motor_profile.h"
 #include <math.h>
 
 /* Extern variables ----------------------------------------------------------*/
@@ -39,6 +40,23 @@ static uint32_t gHeat_Motor_Position = 0xFFFFFFFF;
 static uint32_t gHeat_Motor_SRC_Buffer[3] = {0, 0, 0};
 
 /* Private constants ---------------------------------------------------------*/
+/* 可配置运动曲线默认值 默认仍使用原有S型函数曲线 向上运动依靠光耦停止 不做减速 */
+static const sMotor_Profile_Conf cHeat_Motor_Profile_Up = {
+    .type = eMotor_Profile_Type_Sigmoid,
+    .dec = 0,
+    .freq_min = HEAT_MOTOR_UP_FREQ_MIN,
+    .freq_max = HEAT_MOTOR_UP_FREQ_MAX,
+    .acc = 20000.0,
+    .jerk = 2000000.0,
+};
+static const sMotor_Profile_Conf cHeat_Motor_Profile_Down = {
+    .type = eMotor_Profile_Type_Sigmoid,
+    .dec = 1,
+    .freq_min = HEAT_MOTOR_DOWN_FREQ_MIN,
+    .freq_max = HEAT_MOTOR_DOWN_FREQ_MAX,
+    .acc = 20000.0,
+    .jerk = 2000000.0,
+};
 
 /* Private function prototypes -----------------------------------------------*/
 static void gHeat_Motor_Position_Set(uint32_t position);
@@ -77,6 +95,17 @@ uint32_t gHeat_Motor_Position_Get(void)
     return gHeat_Motor_Position;
 }
 
+/**
+ * @brief  加热体电机 运动曲线注册
+ * @param  None
+ * @retval None
+ */
+void heat_Motor_Profile_Init(void)
+{
+    motor_Profile_Register(eMotor_Profile_Index_Heat_Up, &cHeat_Motor_Profile_Up, HEAT_MOTOR_UP_PCS_UNT, HEAT_MOTOR_UP_PCS_SUM);
+    motor_Profile_Register(eMotor_Profile_Index_Heat_Down, &cHeat_Motor_Profile_Down, HEAT_MOTOR_DOWN_PCS_UNT, HEAT_MOTOR_DOWN_PCS_SUM);
+}
+
 /**
  * @brief  加热体电机位置 使能
  * @param  None
@@ -164,6 +193,7 @@ static void gHeat_Motor_Position_Rst(void)
 
 /**
  * @brief 加热体电机 停车确认
+ * @note   先等待运动完成通知 再确认位置 光耦中断停车后软定时器消抖仍需数个周期
  * @param  None
  * @retval None
  */
@@ -172,6 +202,7 @@ uint8_t heat_Motor_Wait_Stop(uint32_t timeout)
     TickType_t xTick;
 
     xTick = xTaskGetTickCount();
+    m_drv8824_Wait_Done(timeout); /* 等待运动完成通知 */
     switch (gHeat_Motor_Dir_Get()) {
         case eMotorDir_FWD:
             do {
@@ -200,6 +231,23 @@ uint8_t heat_Motor_Wait_Stop(uint32_t timeout)
     return 2;
 }
 
+/**
+ * @brief  上加热体光耦中断处理
+ * @note   向上运动时光耦被遮挡即停止PWM输出 不等待下一个burst及软定时器消抖
+ * @param  None
+ * @retval None
+ */
+void heat_Motor_OPT_ISR_Deal(void)
+{
+    if (HAL_GPIO_ReadPin(OPTSW_OUT3_GPIO_Port, OPTSW_OUT3_Pin) != GPIO_PIN_RESET) { /* 光耦未遮挡 */
+        return;
+    }
+    if (gHeat_Motor_Dir_Get() != eMotorDir_FWD) { /* 仅向上运动以光耦停车 */
+        return;
+    }
+    m_drv8824_Stop_ISR(eM_DRV8824_Index_1); /* 停车并失能驱动 */
+}
+
 /**
  * @brief  启动DMA PWM输出
  * @param  None
@@ -220,6 +268,7 @@ uint8_t heat_Motor_Run(eMotorDir dir, uint32_t timeout)
 
     gHeat_Motor_Position_Rst();                                /* 重置位置记录置非法值 0xFFFFFFFF */
     m_drv8824_Index_Switch(eM_DRV8824_Index_1, portMAX_DELAY); /* 等待PWM资源 */
+    motor_Profile_Prepare((dir == eMotorDir_FWD) ? (eMotor_Profile_Index_Heat_Up) : (eMotor_Profile_Index_Heat_Down)); /* 运动曲线生效 */
     m_drv8824_Clear_Flag();                                    /* 清理故障标志 */
     m_drv8824_SetDir(dir);                                     /* 运动方向设置 硬件管脚 */
     gHeat_Motor_Dir_Set(dir);                                  /* 运动方向设置 目标方向 */
@@ -260,6 +309,10 @@ uint16_t heat_Motor_PWM_Period_Up(uint16_t idx)
 {
     float freq;
 
+    if (motor_Profile_Is_Sigmoid(eMotor_Profile_Index_Heat_Up) == 0) { /* 可配置曲线 查表 */
+        return motor_Profile_Period(eMotor_Profile_Index_Heat_Up, idx);
+    }
+
     freq = HEAT_MOTOR_UP_FREQ_MIN + (HEAT_MOTOR_UP_FREQ_MAX - HEAT_MOTOR_UP_FREQ_MIN) / (1 + expf(-HEAT_MOTOR_UP_E_K * idx + HEAT_MOTOR_UP_E_B));
     return 108000000 / freq;
 }
@@ -303,6 +356,10 @@ uint16_t heat_Motor_PWM_Period_Down(uint16_t idx)
 {
     float freq;
 
+    if (motor_Profile_Is_Sigmoid(eMotor_Profile_Index_Heat_Down) == 0) { /* 可配置曲线 查表 */
+        return motor_Profile_Period(eMotor_Profile_Index_Heat_Down, idx);
+    }
+
     freq = HEAT_MOTOR_DOWN_FREQ_MIN + (HEAT_MOTOR_DOWN_FREQ_MAX - HEAT_MOTOR_DOWN_FREQ_MIN) / (1 + expf(-HEAT_MOTOR_DOWN_E_K * idx + HEAT_MOTOR_DOWN_E_B));
     return 108000000 / freq;
 }
@@ -66,6 +66,8 @@ static sPID_Ctrl_Conf gHeater_TOP_PID_Conf;
 
 static uint8_t gHeater_Overshoot_Flag = 0;
 static uint8_t gHeater_Outdoor_Flag = 0;
+static uint8_t gHeater_Output_Hold = 1;            /* 加热输出未启动 此前的使能请求只记录 */
+static uint8_t gHeater_Output_Request[2] = {1, 1}; /* 启动时的输出请求 下加热体 上加热体 缺省使能 */
 
 // Control loop input,output and setpoint variables
 static float btm_input = 0, btm_output = 0, btm_setpoint = HEATER_BTM_DEFAULT_SETPOINT;
@@ -581,15 +583,38 @@ void heater_BTM_Output_Ctl(float pr)
     __HAL_TIM_SET_COMPARE(&HEATER_BTM_TIM, HEATER_BTM_CHN, ccr);
 }
 
+/**
+ * @brief  加热输出 启动
+ * @note   参数与温度就绪后调用一次 按此前记录的使能/失能请求启动 启动前收到的失能命令不被覆盖
+ * @param  None
+ * @retval None
+ */
+void heater_Output_Release(void)
+{
+    taskENTER_CRITICAL(); /* 与串口中断中的加热使能/失能命令互斥 */
+    gHeater_Output_Hold = 0;
+    if (gHeater_Output_Request[eHeater_BTM]) {
+        HAL_TIM_PWM_Start(&HEATER_BTM_TIM, HEATER_BTM_CHN);
+    }
+    if (gHeater_Output_Request[eHeater_TOP]) {
+        HAL_TIM_PWM_Start(&HEATER_TOP_TIM, HEATER_TOP_CHN);
+    }
+    taskEXIT_CRITICAL();
+}
+
 /**
  * @brief  下加热体 PWM 输出 启动
+ * @note   加热输出启动前只记录请求 由 heater_Output_Release 统一启动
  * @param  None
  * @retval None
  */
 
 void heater_BTM_Output_Start(void)
 {
-    HAL_TIM_PWM_Start(&HEATER_BTM_TIM, HEATER_BTM_CHN);
+    gHeater_Output_Request[eHeater_BTM] = 1;
+    if (gHeater_Output_Hold == 0) {
+        HAL_TIM_PWM_Start(&HEATER_BTM_TIM, HEATER_BTM_CHN);
+    }
 }
 
 /**
@@ -599,6 +624,7 @@ void heater_BTM_Output_Start(void)
  */
 void heater_BTM_Output_Stop(void)
 {
+    gHeater_Output_Request[eHeater_BTM] = 0;
     HAL_TIM_PWM_Stop(&HEATER_BTM_TIM, HEATER_BTM_CHN);
 }
 
@@ -687,13 +713,17 @@ void heater_TOP_Output_Ctl(float pr)
 
 /**
  * @brief  上加热体 PWM 输出 启动
+ * @note   加热输出启动前只记录请求 由 heater_Output_Release 统一启动
  * @param  None
  * @retval None
  */
 
 void heater_TOP_Output_Start(void)
 {
-    HAL_TIM_PWM_Start(&HEATER_TOP_TIM, HEATER_TOP_CHN);
+    gHeater_Output_Request[eHeater_TOP] = 1;
+    if (gHeater_Output_Hold == 0) {
+        HAL_TIM_PWM_Start(&HEATER_TOP_TIM, HEATER_TOP_CHN);
+    }
 }
 
 /**
@@ -703,6 +733,7 @@ void heater_TOP_Output_Start(void)
  */
 void heater_TOP_Output_Stop(void)
 {
+    gHeater_Output_Request[eHeater_TOP] = 0;
     HAL_TIM_PWM_Stop(&HEATER_TOP_TIM, HEATER_TOP_CHN);
 }
 
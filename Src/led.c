@@ -171,3 +171,29 @@ void led_Out_Deal(TickType_t inTick)
             break;
     }
 }
+
+/**
+ * @brief  外接LED板 距下次输出变化的时间
+ * @note   闪烁模式对齐到相位边界 常亮模式 500mS 后检查模式变化
+ * @param  inTick 系统时刻
+ * @retval 间隔 mS
+ */
+uint32_t led_Out_Next(TickType_t inTick)
+{
+    uint32_t phase = inTick % 1000;
+
+    switch (led_Mode_Get()) {
+        case eLED_Mode_Kirakira_Green:
+        case eLED_Mode_Kirakira_Red:
+            return (phase < 500) ? (500 - phase) : (1000 - phase);
+        case eLED_Mode_Red_Green:
+            if (phase < 300) {
+                return 300 - phase;
+            } else if (phase < 600) {
+                return 600 - phase;
+            }
+            return 1000 - phase;
+        default:
+            return 500 - phase % 500;
+    }
+}
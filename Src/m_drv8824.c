@@ -11,6 +11,7 @@ extern TIM_HandleTypeDef htim1;
 /* Private includes ----------------------------------------------------------*/
 
 /* Private define ------------------------------------------------------------*/
+#define M_DRV8824_STAT_NUM (2) /* 占用统计通道数目 */
 
 /* Private macro -------------------------------------------------------------*/
 
@@ -22,13 +23,32 @@ typedef struct {
     uint16_t dup;
 } sPWM_AW_Conf;
 
+/* PWM资源占用统计 单位 tick */
+typedef struct {
+    uint32_t cnt;      /* 获取次数 */
+    uint32_t contend;  /* 需要等待的次数 */
+    uint32_t wait_sum; /* 累计等待时间 */
+    uint32_t wait_max; /* 最长等待时间 */
+    uint32_t hold_sum; /* 累计占用时间 */
+} sM_DRV8824_Stat;
+
 /* Private variables ---------------------------------------------------------*/
 static eM_DRV8824_Index gMDRV8824Index = eM_DRV8824_Index_0;
 static uint32_t gPWM_TEST_AW_CNT = 0;
 static SemaphoreHandle_t m_drv8824_spi_sem = NULL;
+static StaticSemaphore_t m_drv8824_spi_sem_Buffer;  /* SPI 信号量静态内存 */
+static SemaphoreHandle_t m_drv8824_done_sem = NULL; /* 运动完成通知 */
+static StaticSemaphore_t m_drv8824_done_sem_Buffer; /* 运动完成通知 静态内存 */
+static uint8_t gM_DRV8824_Stop_Flag = 0;            /* 光耦中断已停车 禁止继续输出PWM */
+
+static sM_DRV8824_Stat gM_DRV8824_Stats[M_DRV8824_STAT_NUM]; /* PWM资源占用统计 */
+static TickType_t gM_DRV8824_Hold_Tick = 0;                  /* 本次获取时刻 */
+static uint8_t gM_DRV8824_Hold_Flag = 0;                     /* 资源占用中 */
 
 /* Private function prototypes -----------------------------------------------*/
 static uint8_t m_drv8824_acquire(uint32_t timeout);
+static void m_drv8824_Stat_Hold_Start(eM_DRV8824_Index index, TickType_t start);
+static void m_drv8824_Stat_Hold_End(TickType_t now);
 
 /* Private user code ---------------------------------------------------------*/
 
@@ -105,10 +125,16 @@ void m_drv8824_Init(void)
 {
     m_drv8824_Deactive_All();
     m_drv8824_Reset_All();
-    m_drv8824_spi_sem = xSemaphoreCreateBinary();
+    m_drv8824_spi_sem = xSemaphoreCreateBinaryStatic(&m_drv8824_spi_sem_Buffer);
     if (m_drv8824_spi_sem == NULL || xSemaphoreGive(m_drv8824_spi_sem) != pdPASS) {
         Error_Handler();
     }
+    m_drv8824_done_sem = xSemaphoreCreateBinaryStatic(&m_drv8824_done_sem_Buffer);
+    if (m_drv8824_done_sem == NULL) {
+        Error_Handler();
+    }
+    heat_Motor_Profile_Init();  /* 上加热体电机 运动曲线注册 */
+    white_Motor_Profile_Init(); /* 白板电机 运动曲线注册 */
     heat_Motor_Up();
 }
 
@@ -168,6 +194,9 @@ static uint8_t m_drv8824_acquire(uint32_t timeout)
 uint8_t m_drv8824_release(void)
 {
     m_drv8824_Deactive_All();
+    taskENTER_CRITICAL();
+    m_drv8824_Stat_Hold_End(xTaskGetTickCount());
+    taskEXIT_CRITICAL();
     if (xSemaphoreGive(m_drv8824_spi_sem) == pdPASS) {
         return 0;
     }
@@ -182,6 +211,8 @@ uint8_t m_drv8824_release(void)
 uint8_t m_drv8824_release_ISR(void)
 {
     m_drv8824_Deactive_All();
+    m_drv8824_Stat_Hold_End(xTaskGetTickCountFromISR());
+    xSemaphoreGiveFromISR(m_drv8824_done_sem, NULL); /* 通知等待任务 */
     if (xSemaphoreGiveFromISR(m_drv8824_spi_sem, NULL) == pdPASS) {
         return 0;
     }
@@ -196,7 +227,12 @@ uint8_t m_drv8824_release_ISR(void)
  */
 uint8_t m_drv8824_Index_Switch(eM_DRV8824_Index index, uint32_t timeout)
 {
+    TickType_t start = xTaskGetTickCount();
+
     if (m_drv8824_acquire(timeout) == 0) {
+        m_drv8824_Stat_Hold_Start(index, start);
+        xSemaphoreTake(m_drv8824_done_sem, 0); /* 清除上次运动完成通知 */
+        gM_DRV8824_Stop_Flag = 0;
         gMDRV8824Index = index;
         switch (gMDRV8824Index) {
             case eM_DRV8824_Index_0:
@@ -214,6 +250,124 @@ uint8_t m_drv8824_Index_Switch(eM_DRV8824_Index index, uint32_t timeout)
     return 1;
 }
 
+/**
+ * @brief  PWM资源占用统计 获取资源后记录
+ * @note   白板电机与上加热体电机共用 STEP 管脚(PE9 TIM1_CH1) 仅靠使能管脚区分 无法同时运动
+ *         等待时间即两电机互相阻塞的时间 用于评估拆分PWM的收益
+ * @param  index 索引值
+ * @param  start 开始等待时刻
+ * @retval None
+ */
+static void m_drv8824_Stat_Hold_Start(eM_DRV8824_Index index, TickType_t start)
+{
+    sM_DRV8824_Stat * pStat;
+    TickType_t now = xTaskGetTickCount();
+    uint32_t wait = now - start;
+
+    if (index >= M_DRV8824_STAT_NUM) {
+        return;
+    }
+    pStat = &gM_DRV8824_Stats[index];
+    taskENTER_CRITICAL();
+    ++pStat->cnt;
+    if (wait > 0) {
+        ++pStat->contend;
+        pStat->wait_sum += wait;
+        if (wait > pStat->wait_max) {
+            pStat->wait_max = wait;
+        }
+    }
+    gM_DRV8824_Hold_Tick = now;
+    gM_DRV8824_Hold_Flag = 1;
+    taskEXIT_CRITICAL();
+}
+
+/**
+ * @brief  PWM资源占用统计 释放资源时记录
+ * @note   运动完成中断与任务中均会释放 仅首次释放计入
+ * @param  now 当前时刻
+ * @retval None
+ */
+static void m_drv8824_Stat_Hold_End(TickType_t now)
+{
+    if (gM_DRV8824_Hold_Flag == 0 || gMDRV8824Index >= M_DRV8824_STAT_NUM) {
+        return;
+    }
+    gM_DRV8824_Hold_Flag = 0;
+    gM_DRV8824_Stats[gMDRV8824Index].hold_sum += now - gM_DRV8824_Hold_Tick;
+}
+
+/**
+ * @brief  PWM资源占用统计 打包
+ * @note   每通道 获取次数 + 等待次数 + 累计等待 + 最长等待 + 累计占用 各4字节 小端 时间单位 ms
+ * @param  pBuffer 输出指针
+ * @retval 输出长度
+ */
+uint8_t m_drv8824_Stat_Pack(uint8_t * pBuffer)
+{
+    sM_DRV8824_Stat const * pStat;
+    uint32_t data[5];
+    uint8_t i, j, length = 0;
+
+    for (i = 0; i < M_DRV8824_STAT_NUM; ++i) {
+        pStat = &gM_DRV8824_Stats[i];
+        data[0] = pStat->cnt;
+        data[1] = pStat->contend;
+        data[2] = pStat->wait_sum * portTICK_PERIOD_MS;
+        data[3] = pStat->wait_max * portTICK_PERIOD_MS;
+        data[4] = pStat->hold_sum * portTICK_PERIOD_MS;
+        for (j = 0; j < ARRAY_LEN(data); ++j) {
+            pBuffer[length++] = data[j] >> 0;
+            pBuffer[length++] = data[j] >> 8;
+            pBuffer[length++] = data[j] >> 16;
+            pBuffer[length++] = data[j] >> 24;
+        }
+    }
+    return length;
+}
+
+/**
+ * @brief  PWM资源占用统计 清零
+ * @param  None
+ * @retval None
+ */
+void m_drv8824_Stat_Clear(void)
+{
+    memset(gM_DRV8824_Stats, 0, sizeof(gM_DRV8824_Stats));
+}
+
+/**
+ * @brief  等待运动完成通知
+ * @note   运动完成中断或光耦中断停车后通知 取代轮询等待
+ * @param  timeout 等待超时时间
+ * @retval 0 已完成 1 超时
+ */
+uint8_t m_drv8824_Wait_Done(uint32_t timeout)
+{
+    if (xSemaphoreTake(m_drv8824_done_sem, timeout) == pdPASS) {
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief  光耦中断 立即停车
+ * @note   仅当指定电机正在占用PWM时停止DMA及PWM输出 并通知等待任务
+ * @note   光耦中断 EXTI3 与 TIM1 突发传输 DMA2_Stream5 同为优先级 6 不会插入在回调检查停车标志与重启DMA之间
+ * @param  index 索引值
+ * @retval 0 已停车 1 指定电机未运动
+ */
+uint8_t m_drv8824_Stop_ISR(eM_DRV8824_Index index)
+{
+    if (gM_DRV8824_Hold_Flag == 0 || gMDRV8824Index != index || gM_DRV8824_Stop_Flag) {
+        return 1;
+    }
+    gM_DRV8824_Stop_Flag = 1; /* 已在队列中的DMA完成回调不再重启输出 */
+    PWM_AW_Stop();
+    m_drv8824_release_ISR();
+    return 0;
+}
+
 /**
  * @brief  清理故障情况
  * @param  index       索引值
@@ -308,10 +462,13 @@ void PWM_AW_Stop(void)
 /**
  * @brief  PWM输出回调
  * @param  None
- * @retval 0 输出完成 1 输出未完成
+ * @retval 0 输出完成 1 输出未完成 2 光耦中断已停车 资源已释放
  */
 uint8_t PWM_AW_IRQ_CallBcak(void)
 {
+    if (gM_DRV8824_Stop_Flag) { /* 光耦中断已停车 m_drv8824_Stop_ISR 中已释放 不再重复释放 */
+        return 2;
+    }
     switch (gMDRV8824Index) {
         case eM_DRV8824_Index_0: /* 白板电机 */
             switch (gWhite_Motor_Dir_Get()) {
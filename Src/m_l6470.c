@@ -37,14 +37,33 @@
 extern SPI_HandleTypeDef hspi2;
 
 /* Private typedef -----------------------------------------------------------*/
+/* 影子寄存器 按寄存器地址索引 */
+typedef struct {
+    uint32_t value[dSPIN_CONFIG + 1]; /* 最近一次写入值 */
+    uint32_t valid;                   /* 有效标志 按寄存器地址置位 */
+} sM_L6470_Shadow;
+
+/* SPI总线使用统计 */
+typedef struct {
+    uint32_t acquire;    /* 获取SPI总线次数 */
+    uint32_t spi;        /* SPI传输次数 非菊花链 每字节一次片选 */
+    uint32_t param;      /* 参数写入次数 */
+    uint32_t param_skip; /* 与影子寄存器相同而跳过的参数写入次数 */
+} sM_L6470_Stat;
 
 /* Private define ------------------------------------------------------------*/
+#define M_L6470_NUM (2) /* 驱动数目 */
 
 /* Private macro -------------------------------------------------------------*/
+/* 可缓存的配置寄存器 位置 速度 ADC 状态寄存器由驱动自行改变 不缓存 */
+#define M_L6470_SHADOW_CACHED(param) ((param) >= dSPIN_ACC && (param) <= dSPIN_CONFIG && (param) != dSPIN_ADC_OUT)
 
 /* Private variables ---------------------------------------------------------*/
 static eM_L6470_Index gML6470Index = eM_L6470_Index_0;
 static SemaphoreHandle_t m_l6470_spi_sem = NULL;
+static StaticSemaphore_t m_l6470_spi_sem_Buffer;    /* SPI 信号量静态内存 */
+static sM_L6470_Shadow gML6470Shadows[M_L6470_NUM]; /* 影子寄存器 */
+static sM_L6470_Stat gML6470Stats[M_L6470_NUM];     /* SPI总线使用统计 */
 
 /* Private function prototypes -----------------------------------------------*/
 static uint8_t m_l6470_acquire(uint32_t timeout);
@@ -91,11 +110,90 @@ uint8_t m_l6470_Index_Switch(eM_L6470_Index index, uint32_t timeout)
 {
     if (m_l6470_acquire(timeout) == 0) {
         gML6470Index = index;
+        if (gML6470Index < M_L6470_NUM) {
+            ++gML6470Stats[gML6470Index].acquire;
+        }
         return 0;
     }
     return 1;
 }
 
+/**
+ * @brief  影子寄存器 全部失效
+ * @note   两个驱动共用复位管脚 硬件重置后寄存器均恢复默认值
+ * @param  None
+ * @retval None
+ */
+static void m_l6470_Shadow_Invalidate_All(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < M_L6470_NUM; ++i) {
+        gML6470Shadows[i].valid = 0;
+    }
+}
+
+/**
+ * @brief  参数写入 与影子寄存器比较
+ * @note   值与最近一次写入相同时跳过 省去SPI传输 非缓存寄存器总是写入
+ *         需在获取SPI总线资源后调用
+ * @param  param 寄存器地址
+ * @param  value 参数值
+ * @retval 0 已跳过 1 已写入
+ */
+uint8_t m_l6470_Set_Param(dSPIN_Registers_TypeDef param, uint32_t value)
+{
+    sM_L6470_Shadow * pShadow;
+
+    if (gML6470Index < M_L6470_NUM && M_L6470_SHADOW_CACHED(param)) {
+        pShadow = &gML6470Shadows[gML6470Index];
+        if ((pShadow->valid & (1 << param)) && pShadow->value[param] == value) {
+            ++gML6470Stats[gML6470Index].param_skip;
+            return 0;
+        }
+    }
+    dSPIN_Set_Param(param, value);
+    return 1;
+}
+
+/**
+ * @brief  SPI总线使用统计 打包
+ * @note   每驱动 获取次数 + SPI传输次数 + 参数写入次数 + 跳过写入次数 各4字节 小端
+ * @param  pBuffer 输出指针
+ * @retval 输出长度
+ */
+uint8_t m_l6470_Stat_Pack(uint8_t * pBuffer)
+{
+    sM_L6470_Stat const * pStat;
+    uint32_t data[4];
+    uint8_t i, j, length = 0;
+
+    for (i = 0; i < M_L6470_NUM; ++i) {
+        pStat = &gML6470Stats[i];
+        data[0] = pStat->acquire;
+        data[1] = pStat->spi;
+        data[2] = pStat->param;
+        data[3] = pStat->param_skip;
+        for (j = 0; j < ARRAY_LEN(data); ++j) {
+            pBuffer[length++] = data[j] & 0xFF;
+            pBuffer[length++] = (data[j] >> 8) & 0xFF;
+            pBuffer[length++] = (data[j] >> 16) & 0xFF;
+            pBuffer[length++] = (data[j] >> 24) & 0xFF;
+        }
+    }
+    return length;
+}
+
+/**
+ * @brief  SPI总线使用统计 清零
+ * @param  None
+ * @retval None
+ */
+void m_l6470_Stat_Clear(void)
+{
+    memset(gML6470Stats, 0, sizeof(gML6470Stats));
+}
+
 /**
  * @brief  Reads dSPIN internal writable registers and compares with the values in the code
  * @param  dSPIN_RegsStruct Configuration structure address (pointer to configuration structure)
@@ -290,7 +388,7 @@ uint8_t m_l6470_Init(void)
 {
     uint8_t result = 0;
 
-    m_l6470_spi_sem = xSemaphoreCreateBinary();
+    m_l6470_spi_sem = xSemaphoreCreateBinaryStatic(&m_l6470_spi_sem_Buffer);
     if (m_l6470_spi_sem == NULL || xSemaphoreGive(m_l6470_spi_sem) != pdPASS) {
         Error_Handler();
     }
@@ -359,6 +457,7 @@ void m_l6470_NCS_GPIO_Deactive(void)
  */
 void m_l6470_Reset_HW(void)
 {
+    m_l6470_Shadow_Invalidate_All(); /* 寄存器恢复默认值 */
     m_l6470_NCS_GPIO_Active();
     HAL_GPIO_WritePin(MOT_NRST_GPIO_Port, MOT_NRST_Pin, GPIO_PIN_RESET); /* 重置托盘电机 */
     vTaskDelay(2);                                                       /* t-STBY-min 10uS t-lobicwu 38~45 usS t-cpwu 650 uS */
@@ -562,6 +661,13 @@ void dSPIN_Set_Param(dSPIN_Registers_TypeDef param, uint32_t value)
             /* Send parameter - byte 0 to dSPIN */
             dSPIN_Write_Byte((uint8_t)(value));
     }
+    if (gML6470Index < M_L6470_NUM) {
+        ++gML6470Stats[gML6470Index].param;
+        if (M_L6470_SHADOW_CACHED(param)) { /* 更新影子寄存器 */
+            gML6470Shadows[gML6470Index].value[param] = value;
+            gML6470Shadows[gML6470Index].valid |= (1 << param);
+        }
+    }
 }
 
 /**
@@ -762,6 +868,9 @@ void dSPIN_Reset_Device(void)
 {
     /* Send ResetDevice operation code to dSPIN */
     dSPIN_Write_Byte(dSPIN_RESET_DEVICE);
+    if (gML6470Index < M_L6470_NUM) {
+        gML6470Shadows[gML6470Index].valid = 0;
+    }
 }
 
 /**
@@ -878,6 +987,10 @@ uint8_t dSPIN_Write_Byte(uint8_t byte)
 {
     uint8_t result = 0xA5;
 
+    if (gML6470Index < M_L6470_NUM) {
+        ++gML6470Stats[gML6470Index].spi;
+    }
+
     /* nSS signal activation - low */
     m_l6470_NCS_GPIO_Active();
 
@@ -39,11 +39,15 @@
 #include "fan.h"
 #include "beep.h"
 #include "led.h"
-#include "white_motor.h"
+#include "sys_stat.h"
+#include "power.h"
+#include "time_wheel.h"
+#include "boot.h"
 
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
+typedef StaticTask_t osStaticThreadDef_t;
 /* USER CODE BEGIN PTD */
 
 /* USER CODE END PTD */
@@ -89,6 +93,7 @@ DMA_HandleTypeDef hdma_usart1_rx;
 DMA_HandleTypeDef hdma_usart1_tx;
 DMA_HandleTypeDef hdma_usart2_rx;
 DMA_HandleTypeDef hdma_usart2_tx;
+DMA_HandleTypeDef hdma_usart3_rx;
 
 /* Definitions for defaultTask */
 osThreadId_t defaultTaskHandle;
@@ -124,7 +129,10 @@ void StartDefaultTask(void * argument);
 /* USER CODE BEGIN PFP */
 static void Miscellaneous_Task(void * argument);
 static TaskHandle_t Miscellaneous_Task_Handle = NULL;
-static uint8_t Miscellaneous_Task_State = 0;
+static StackType_t Miscellaneous_Task_Stack[192];
+static StaticTask_t Miscellaneous_Task_TCB;
+static sTime_Wheel_Job gMisc_Job_Board_LED, gMisc_Job_Out_LED, gMisc_Job_Fan, gMisc_Job_Temp_Upload, gMisc_Job_Pre_Light;
+static uint8_t gMisc_Pre_Light_Buffer[16];
 
 /* USER CODE END PFP */
 
@@ -156,7 +164,7 @@ int main(void)
     SystemClock_Config();
 
     /* USER CODE BEGIN SysInit */
-
+    sys_Stat_IRQ_Init(); /* 中断统计 DWT 周期计数 */
     /* USER CODE END SysInit */
 
     /* Initialize all configured peripherals */
@@ -182,6 +190,9 @@ int main(void)
     MX_ADC2_Init();
     /* USER CODE BEGIN 2 */
 
+    /* boot ready event */
+    boot_Init();
+
     /* soft timer task */
     soft_timer_Init();
 
@@ -195,10 +206,14 @@ int main(void)
     /* storge task */
     storgeTaskInit();
 
-    if (xTaskCreate(Miscellaneous_Task, "TASK_MISC", 160, NULL, 1, &Miscellaneous_Task_Handle) != pdPASS) {
+    Miscellaneous_Task_Handle = xTaskCreateStatic(Miscellaneous_Task, "TASK_MISC", ARRAY_LEN(Miscellaneous_Task_Stack), NULL, 1, Miscellaneous_Task_Stack, &Miscellaneous_Task_TCB);
+    if (Miscellaneous_Task_Handle == NULL) {
         FL_Error_Handler(__FILE__, __LINE__);
     }
 
+    power_Init();          /* 无节拍空闲 */
+    boot_Scheduler_Mark(); /* 外设初始化耗时 */
+
     /* Start the scheduler. */
     vTaskStartScheduler();
 #if 0
@@ -1109,6 +1124,9 @@ static void MX_DMA_Init(void)
     /* DMA1_Stream0_IRQn interrupt configuration */
     HAL_NVIC_SetPriority(DMA1_Stream0_IRQn, 5, 0);
     HAL_NVIC_EnableIRQ(DMA1_Stream0_IRQn);
+    /* DMA1_Stream1_IRQn interrupt configuration */
+    HAL_NVIC_SetPriority(DMA1_Stream1_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Stream1_IRQn);
     /* DMA1_Stream5_IRQn interrupt configuration */
     HAL_NVIC_SetPriority(DMA1_Stream5_IRQn, 5, 0);
     HAL_NVIC_EnableIRQ(DMA1_Stream5_IRQn);
@@ -1182,8 +1200,14 @@ static void MX_GPIO_Init(void)
     GPIO_InitStruct.Pull = GPIO_NOPULL;
     HAL_GPIO_Init(OPTSW_OUT2_GPIO_Port, &GPIO_InitStruct);
 
-    /*Configure GPIO pins : OPTSW_OUT3_Pin OPTSW_OUT4_Pin OPTSW_OUT0_Pin OPTSW_OUT1_Pin */
-    GPIO_InitStruct.Pin = OPTSW_OUT3_Pin | OPTSW_OUT4_Pin | OPTSW_OUT0_Pin | OPTSW_OUT1_Pin;
+    /*Configure GPIO pin : OPTSW_OUT3_Pin */
+    GPIO_InitStruct.Pin = OPTSW_OUT3_Pin;
+    GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
+    GPIO_InitStruct.Pull = GPIO_PULLUP;
+    HAL_GPIO_Init(OPTSW_OUT3_GPIO_Port, &GPIO_InitStruct);
+
+    /*Configure GPIO pins : OPTSW_OUT4_Pin OPTSW_OUT0_Pin OPTSW_OUT1_Pin */
+    GPIO_InitStruct.Pin = OPTSW_OUT4_Pin | OPTSW_OUT0_Pin | OPTSW_OUT1_Pin;
     GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
     GPIO_InitStruct.Pull = GPIO_PULLUP;
     HAL_GPIO_Init(GPIOE, &GPIO_InitStruct);
@@ -1268,6 +1292,9 @@ static void MX_GPIO_Init(void)
     HAL_NVIC_SetPriority(EXTI2_IRQn, 5, 0);
     HAL_NVIC_EnableIRQ(EXTI2_IRQn);
 
+    HAL_NVIC_SetPriority(EXTI3_IRQn, 6, 0); /* 与 DMA2_Stream5 同级 */
+    HAL_NVIC_EnableIRQ(EXTI3_IRQn);
+
     HAL_NVIC_SetPriority(EXTI4_IRQn, 5, 0);
     HAL_NVIC_EnableIRQ(EXTI4_IRQn);
 }
@@ -1346,74 +1373,120 @@ BaseType_t Miscellaneous_Task_Notify(uint32_t notify)
 }
 
 /**
- * @brief  杂项任务 是否处于忙状态
- * @param  None
- * @retval 0 空闲 1 忙碌
+ * @brief  杂项任务 板上运行灯闪烁
+ * @param  now 当前时刻
+ * @retval 下次间隔 mS
+ */
+static uint32_t misc_Job_Board_LED(TickType_t now)
+{
+    led_Board_Green_Toggle();
+    return 500;
+}
+
+/**
+ * @brief  杂项任务 外接LED板处理
+ * @note   下次间隔按当前时刻计算 自行重新加入 不按到期时刻累加 延后执行时不多唤醒一次
+ * @param  now 当前时刻
+ * @retval 0 已重新加入
+ */
+static uint32_t misc_Job_Out_LED(TickType_t now)
+{
+    led_Out_Deal(now);
+    time_Wheel_Add(&gMisc_Job_Out_LED, misc_Job_Out_LED, led_Out_Next(now)); /* 到下一个闪烁相位边界 */
+    return 0;
+}
+
+/**
+ * @brief  杂项任务 风扇处理
+ * @param  now 当前时刻
+ * @retval 下次间隔 mS
+ */
+static uint32_t misc_Job_Fan(TickType_t now)
+{
+    fan_Ctrl_Deal(temp_Get_Temp_Data_ENV()); /* 根据环境温度调整风扇输出 */
+    fan_IC_Error_Deal();                     /* 风扇转速监控 */
+    return 1000;
+}
+
+/**
+ * @brief  杂项任务 温度信息上送处理
+ * @param  now 当前时刻
+ * @retval 下次间隔 mS 调试温度上送时 200mS
  */
-uint8_t Miscellaneous_Task_Is_Busy(void)
+static uint32_t misc_Job_Temp_Upload(TickType_t now)
 {
-    return Miscellaneous_Task_State > 0;
+    protocol_Temp_Upload_Deal();
+    if (protocol_Debug_Factory_Temp() == 0 && protocol_Debug_Temperature()) {
+        return 200;
+    }
+    return 1000;
+}
+
+/**
+ * @brief  杂项任务 预先点灯 停止
+ * @param  now 当前时刻
+ * @retval 0 单次
+ */
+static uint32_t misc_Job_Pre_Light_Stop(TickType_t now)
+{
+    comm_Data_Pre_Light_Stop(gMisc_Pre_Light_Buffer);
+    return 0;
+}
+
+/**
+ * @brief  杂项任务 预先点灯 启动 5S 后停止
+ * @param  now 当前时刻
+ * @retval 0 单次
+ */
+static uint32_t misc_Job_Pre_Light_Start(TickType_t now)
+{
+    comm_Data_Pre_Light_Start(gMisc_Pre_Light_Buffer);
+    time_Wheel_Add(&gMisc_Job_Pre_Light, misc_Job_Pre_Light_Stop, 5000);
+    return 0;
 }
 
 /**
  * @brief  杂项任务
+ * @note   周期事务挂在时间轮上 任务阻塞到最近一个到期时刻或收到通知
  * @param  argument: Not used
  * @retval None
  */
 static void Miscellaneous_Task(void * argument)
 {
-    TickType_t xTick;
-    uint32_t cnt = 0, notify, pre_light_start, pre_light_stop;
+    TickType_t now;
+    uint32_t notify, align;
     BaseType_t xResult;
-    uint8_t buffer[16];
 
     temp_Start_ADC_DMA();                         /* 启动ADC转换 */
     fan_Init();                                   /* 风扇初始化 */
     protocol_Temp_Upload_Comm_Set(eComm_Out, 0);  /* 关闭外串口发送 */
     protocol_Temp_Upload_Comm_Set(eComm_Main, 0); /* 关闭主板发送 */
-    xTick = xTaskGetTickCount();                  /* 获取系统时刻 */
     vTaskDelay(30);                               /* ADC 转换完成 */
-    pre_light_start = 0;
-    pre_light_stop = 0;
+    boot_Mark(BOOT_BIT_TEMP);                     /* 温度有效 */
+    protocol_Temp_Upload_Deal();                  /* 首次温度处理 上电时温度异常立即报错 不等待扫码枪初始化 */
+    barcode_Init();                               /* 扫码枪初始化 与电机复位并行 */
+    boot_Mark(BOOT_BIT_BARCODE);
+
+    now = xTaskGetTickCount();
+    align = 500 - now % 500; /* 对齐到 500mS 边界 各周期事务与LED闪烁相位合并唤醒 */
+    time_Wheel_Init(now);
+    time_Wheel_Add(&gMisc_Job_Temp_Upload, misc_Job_Temp_Upload, align);
+    time_Wheel_Add(&gMisc_Job_Fan, misc_Job_Fan, align);
+    time_Wheel_Add(&gMisc_Job_Out_LED, misc_Job_Out_LED, align);
+    time_Wheel_Add(&gMisc_Job_Board_LED, misc_Job_Board_LED, align);
 
     for (;;) {
-        xResult = xTaskNotifyWait(0, 0xFFFFFFFF, &notify, 80);
+        xResult = xTaskNotifyWait(0, 0xFFFFFFFF, &notify, time_Wheel_Next(xTaskGetTickCount()));
         if (xResult) {
             switch (notify) {
-                case 0:
-                default:
-                    Miscellaneous_Task_State = 1;
-                    white_Motor_PD(); /* 运动白板电机 PD位置 */
-                    white_Motor_WH(); /* 运动白板电机 白物质位置 */
-                    Miscellaneous_Task_State = 0;
-                    break;
                 case 1:
-                    pre_light_start = xTick;
+                    time_Wheel_Add(&gMisc_Job_Pre_Light, misc_Job_Pre_Light_Start, 100); /* 启动预先点灯 */
+                    break;
+                default:
                     break;
             }
         }
-
-        if (pre_light_start && xTick - pre_light_start > 100) {
-            pre_light_start = 0;
-            comm_Data_Pre_Light_Start(buffer);
-            pre_light_stop = xTick;
-        }
-        if (pre_light_stop && xTick - pre_light_stop > 5000) {
-            pre_light_stop = 0;
-            comm_Data_Pre_Light_Stop(buffer);
-        }
-
-        fan_Ctrl_Deal(temp_Get_Temp_Data_ENV()); /* 根据环境温度调整风扇输出 */
-        fan_IC_Error_Deal();                     /* 风扇转速监控 */
-        led_Out_Deal(xTick);                     /* 外接LED板处理 */
-        protocol_Temp_Upload_Deal();             /* 温度信息上送处理 */
-
-        if (cnt % 5 == 0) {           /* 500mS */
-            led_Board_Green_Toggle(); /* 板上运行灯闪烁 */
-        }
-
-        vTaskDelayUntil(&xTick, 100);
-        ++cnt;
+        time_Wheel_Run(xTaskGetTickCount());
     }
 }
 
@@ -1458,7 +1531,7 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef * htim)
 {
     /* USER CODE BEGIN Callback 0 */
     if (htim->Instance == TIM1) {
-        if (PWM_AW_IRQ_CallBcak() == 0) { /* 运动完成 */
+        if (PWM_AW_IRQ_CallBcak() == 0) { /* 运动完成 光耦停车时已释放 */
             m_drv8824_release_ISR();      /* 释放PWM资源 */
         }
     }
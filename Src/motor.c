@@ -10,6 +10,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
 #include "motor.h"
+#include "motor_sched.h"
 #include "barcode_scan.h"
 #include "m_l6470.h"
 #include "m_drv8824.h"
@@ -27,6 +28,7 @@
 #include "temperature.h"
 #include "heater.h"
 #include "fan.h"
+#include "boot.h"
 
 /* Extern variables ----------------------------------------------------------*/
 extern TIM_HandleTypeDef htim6;
@@ -49,8 +51,12 @@ typedef struct {
 /* Private macro -------------------------------------------------------------*/
 
 /* Private variables ---------------------------------------------------------*/
-xQueueHandle motor_Fun_Queue_Handle = NULL; /* 电机功能队列 */
-xTaskHandle motor_Task_Handle = NULL;       /* 电机任务句柄 */
+xQueueHandle motor_Fun_Queue_Handle = NULL;                 /* 电机功能队列 */
+static StaticQueue_t motor_Fun_Queue_Buffer;                /* 电机功能队列 静态内存 */
+static uint8_t motor_Fun_Queue_Storage[sizeof(sMotor_Fun)]; /* 电机功能队列 存储区 */
+xTaskHandle motor_Task_Handle = NULL;                       /* 电机任务句柄 */
+static StackType_t motor_Task_Stack[288];                   /* 电机任务 栈 */
+static StaticTask_t motor_Task_TCB;                         /* 电机任务 控制块 */
 
 static sMotor_OPT_Record gMotor_OPT_Records[eMotor_OPT_Index_NUM];   /* 光耦记录 */
 static uint8_t gMotorPressureStopBits = 0xFF;                        /* 压力测试停止标志位 */
@@ -61,6 +67,7 @@ static uint8_t gMotor_Aging_Sleep = 10;                              /* 老化
 /* Private function prototypes -----------------------------------------------*/
 static void motor_Task(void * argument);
 static void motor_Tray_Move_By_Index(eTrayIndex index);
+static void motor_Tray_Move_Deal(eTrayIndex index, uint8_t flag, uint8_t opt);
 
 static uint8_t motor_Sample_Deal(uint8_t normal_report);
 
@@ -499,13 +506,15 @@ void motor_Resource_Init(void)
  */
 void motor_Init(void)
 {
-    motor_Fun_Queue_Handle = xQueueCreate(1, sizeof(sMotor_Fun));
+    motor_Fun_Queue_Handle = xQueueCreateStatic(1, sizeof(sMotor_Fun), motor_Fun_Queue_Storage, &motor_Fun_Queue_Buffer);
     if (motor_Fun_Queue_Handle == NULL) {
         Error_Handler();
     }
-    if (xTaskCreate(motor_Task, "Motor Task", 288, NULL, TASK_PRIORITY_MOTOR, &motor_Task_Handle) != pdPASS) {
+    motor_Task_Handle = xTaskCreateStatic(motor_Task, "Motor Task", ARRAY_LEN(motor_Task_Stack), NULL, TASK_PRIORITY_MOTOR, motor_Task_Stack, &motor_Task_TCB);
+    if (motor_Task_Handle == NULL) {
         Error_Handler();
     }
+    motor_Sched_Init(); /* 电机运动调度初始化 */
 }
 
 /**
@@ -627,12 +636,33 @@ static void motor_Tray_Move_By_Index(eTrayIndex index)
     } else {
         flag = 0; /* 上加热体电机处于抬升状态 */
     }
-    if (flag && heat_Motor_Up() != 0) { /* 上加热体光耦位置未被阻挡 则抬起上加热体电机 */
-        buffer[0] = 0x00;               /* 抬起上加热体失败 */
+    if (flag && motor_Sched_Run(eMotor_Sched_Job_Heat_Up, 5000) != eMotor_Sched_Result_OK) {  /* 上加热体处于砸下状态 则抬起上加热体电机 */
+        buffer[0] = 0x00;                                                                     /* 抬起上加热体失败 */
+        comm_Main_SendTask_QueueEmitWithBuildCover(eProtocolRespPack_Client_DISH, buffer, 1); /* 上报失败报文 */
+        comm_Out_SendTask_QueueEmitWithModify(buffer, 8, 0);                                  /* 转发至外串口但不允许阻塞 */
+        return;
+    }
+
+    if (motor_Sched_Claim(eMotor_Sched_Job_Tray, 5000) != eMotor_Sched_Result_OK) {           /* 获取托盘运动资源 检查上加热体联锁 */
+        buffer[0] = 0x00;                                                                     /* 托盘电机运动失败 */
         comm_Main_SendTask_QueueEmitWithBuildCover(eProtocolRespPack_Client_DISH, buffer, 1); /* 上报失败报文 */
         comm_Out_SendTask_QueueEmitWithModify(buffer, 8, 0);                                  /* 转发至外串口但不允许阻塞 */
         return;
     }
+    motor_Tray_Move_Deal(index, flag, opt);     /* 运动托盘电机 */
+    motor_Sched_Release(eMotor_Sched_Job_Tray); /* 释放托盘运动资源 */
+}
+
+/**
+ * @brief  电机任务 托盘运动 上加热体已处理
+ * @param  index 托盘位置索引
+ * @param  flag 运动前上加热体是否处于砸下状态
+ * @param  opt 运动前托盘光耦状态
+ * @retval None
+ */
+static void motor_Tray_Move_Deal(eTrayIndex index, uint8_t flag, uint8_t opt)
+{
+    uint8_t buffer[8];
 
     switch (index) {
         case eTrayIndex_2: /* 出仓方向使能温度调整 */
@@ -646,7 +676,7 @@ static void motor_Tray_Move_By_Index(eTrayIndex index)
             break;
     }
 
-    /* 托盘保持力矩不足 托盘容易位置会发生变化 实际位置与驱动记录位置不匹配 每次移动托盘电机必须重置 */
+    /* 托盘保持力矩不足 托盘容易位置会发生变化 实际位置与驱动记录位置可能不匹配 位置置信丢失时必须重置 */
     if ((index == eTrayIndex_0 && opt == 0)                        /* 从光耦外回到原点 */
         || (index == eTrayIndex_2 && opt && flag)) {               /* 或者 起点时上加热体砸下 从光耦处离开 */
     } else if ((index == eTrayIndex_1 && flag == 0 && opt == 0)) { /* 从出仓位移动到扫码位置 */
@@ -661,9 +691,16 @@ static void motor_Tray_Move_By_Index(eTrayIndex index)
             comm_Out_SendTask_QueueEmitWithModify(buffer, 8, 0);                                  /* 转发至外串口但不允许阻塞 */
         }
         return;
+    } else if (tray_Motor_Pos_Confidence_Check(opt)) { /* 位置可信 省略复归 */
+        tray_Motor_Home_Skip_Record();                 /* 记录省略复归 */
+        if (index == eTrayIndex_0) {                   /* 已在原点 */
+            buffer[0] = 0x01;
+            comm_Main_SendTask_QueueEmitWithBuildCover(eProtocolRespPack_Client_DISH, buffer, 1);
+            comm_Out_SendTask_QueueEmitWithModify(buffer, 8, 0); /* 转发至外串口但不允许阻塞 */
+            return;
+        }
     } else {                                                                                      /* 其他情况需要回到原点 */
-        tray_Motor_Init();                                                                        /* 托盘电机初始化 */
-        if (tray_Motor_Reset_Pos() != 0) {                                                        /* 重置托盘电机位置 */
+        if (tray_Motor_Home() != 0) {                                                             /* 复归 重置托盘电机位置 */
             buffer[0] = 0x00;                                                                     /* 托盘电机运动失败 */
             comm_Main_SendTask_QueueEmitWithBuildCover(eProtocolRespPack_Client_DISH, buffer, 1); /* 上报失败报文 */
             comm_Out_SendTask_QueueEmitWithModify(buffer, 8, 0);                                  /* 转发至外串口但不允许阻塞 */
@@ -737,33 +774,35 @@ void motor_Sample_Owari_Correct(void)
 
 /**
  * @brief  采样完成清理
+ * @note   运动失败时错误已由电机调度或电机模块上报 其余清理照常进行
  * @param  None
  * @retval None
  */
 void motor_Sample_Owari(void)
 {
-    uint8_t cnt = 0;
+    eMotor_Sched_Result white;
 
-    heater_Overshoot_Flag_Set(eHeater_BTM, 0);           /* 取消下加热体过冲加热标志 */
-    heater_Overshoot_Flag_Set(eHeater_TOP, 0);           /* 取消上加热体过冲加热标志 */
-    while (++cnt < 10 && Miscellaneous_Task_Is_Busy()) { /* 白板电机未完成 */
-        vTaskDelay(500);                                 /* 轮询等待 释放白板电机资源 */
-    }
-    white_Motor_WH();                            /* 运动白板电机 白板位置 */
+    heater_Overshoot_Flag_Set(eHeater_BTM, 0);   /* 取消下加热体过冲加热标志 */
+    heater_Overshoot_Flag_Set(eHeater_TOP, 0);   /* 取消上加热体过冲加热标志 */
+    motor_Sched_Wait(MOTOR_SCHED_RES_ALL, 5000); /* 等待后台运动完成 释放白板电机资源 超时已上报 */
     if (protocol_Debug_SampleMotorTray() == 0) { /* 非托盘电机调试 */
         motor_Tray_Move_By_Index(eTrayIndex_2);  /* 出仓 */
     }
-    heat_Motor_Up();                             /* 采样结束 抬起加热体电机 */
-    barcode_Motor_Run_By_Index(eBarcodeIndex_0); /* 复位 */
-    barcode_Motor_Run_By_Index(eBarcodeIndex_6); /* 二维码位置就位 */
-    gComm_Data_Sample_Max_Point_Clear();         /* 清除需要测试点数 */
-    protocol_Temp_Upload_Resume();               /* 恢复温度上送 */
-    led_Mode_Set(eLED_Mode_Keep_Green);          /* LED 绿灯常亮 */
-    barcode_Interrupt_Flag_Clear();              /* 清除打断标志位 */
-    comm_Data_Sample_Owari();                    /* 上送采样结束报文 */
-    comm_Data_GPIO_Init();                       /* 初始化通讯管脚 */
-    gMotor_Sampl_Comm_Init();                    /* 复位来源标记 */
-    heater_BTM_Output_Start();                   /* 恢复下加热体 */
+    motor_Sched_Run(eMotor_Sched_Job_Heat_Up, 5000);            /* 采样结束 抬起加热体电机 失败已上报 */
+    white = motor_Sched_Start(eMotor_Sched_Job_White_WH, 5000); /* 后台运动白板电机 白板位置 与扫码电机复位同时进行 */
+    barcode_Motor_Run_By_Index(eBarcodeIndex_0);                /* 复位 */
+    barcode_Motor_Run_By_Index(eBarcodeIndex_6);                /* 二维码位置就位 */
+    if (white == eMotor_Sched_Result_OK) {                      /* 白板电机已提交 */
+        motor_Sched_Wait(MOTOR_SCHED_RES_ALL, 5000);            /* 等待白板电机完成 超时已上报 */
+    }
+    gComm_Data_Sample_Max_Point_Clear(); /* 清除需要测试点数 */
+    protocol_Temp_Upload_Resume();       /* 恢复温度上送 */
+    led_Mode_Set(eLED_Mode_Keep_Green);  /* LED 绿灯常亮 */
+    barcode_Interrupt_Flag_Clear();      /* 清除打断标志位 */
+    comm_Data_Sample_Owari();            /* 上送采样结束报文 */
+    comm_Data_GPIO_Init();               /* 初始化通讯管脚 */
+    gMotor_Sampl_Comm_Init();            /* 复位来源标记 */
+    heater_BTM_Output_Start();           /* 恢复下加热体 */
 }
 
 /**
@@ -855,36 +894,47 @@ static void motor_Sample_Temperature_Check(void)
 
 /**
  * @brief  测试过程中扫码处理
+ * @note   提前结束时已清理
  * @param  None
- * @retval 0 正常 1 中途被打断
+ * @retval 0 正常 1 中途被打断或电机运动失败 提前结束
  */
 static uint8_t motor_Sample_Barcode_Scan(void)
 {
     eBarcodeState barcode_result = eBarcodeState_OK;
 
+    tray_Motor_Home_Stat_Test_Clear();         /* 新测试 清零本次测试托盘复归统计 */
     if (protocol_Debug_SampleBarcode() == 0) { /* 非调试模式 */
         if (protocol_Debug_SampleMotorTray() == 0) {
             motor_Tray_Move_By_Index(eTrayIndex_1); /* 扫码位置 */
         }
+        if (motor_Sched_Start(eMotor_Sched_Job_White_Cycle, 5000) != eMotor_Sched_Result_OK) { /* 后台运动白板电机 与扫码及入仓同时进行 */
+            motor_Sample_Owari();                                                               /* 白板电机资源超时 已上报 清理 */
+            return 1;                                                                           /* 提前结束 */
+        }
         barcode_result = barcode_Scan_QR();              /* 扫描二维条码 */
-        if (barcode_result == eBarcodeState_Interrupt) { /* 中途打断 */
-            error_Emit(eError_Sample_Initiative_Break);  /* 主动打断 */
-            motor_Sample_Owari();                        /* 清理 */
-            return 1;                                    /* 提前结束 */
+        if (barcode_result == eBarcodeState_Interrupt) {       /* 中途打断 */
+            error_Emit(eError_Sample_Initiative_Break);        /* 主动打断 */
+            motor_Sample_Owari();                              /* 清理 */
+            return 1;                                          /* 提前结束 */
         }
     }
-    if (protocol_Debug_SampleMotorTray() == 0) { /* 非调试模式 */
-        motor_Tray_Move_By_Index(eTrayIndex_0);  /* 入仓 */
-        heat_Motor_Down();                       /* 砸下上加热体 */
+    if (protocol_Debug_SampleMotorTray() == 0) {                                             /* 非调试模式 */
+        motor_Tray_Move_By_Index(eTrayIndex_0);                                              /* 入仓 */
+        if (motor_Sched_Start(eMotor_Sched_Job_Heat_Down, 5000) != eMotor_Sched_Result_OK) { /* 白板电机完成后 后台砸下上加热体 检查托盘联锁 */
+            motor_Sample_Owari();                                                            /* 资源超时或联锁不满足 已上报 清理 */
+            return 1;                                                                        /* 提前结束 */
+        }
     }
-    if (protocol_Debug_SampleBarcode() || Miscellaneous_Task_Notify(0) != pdPASS) { /* 通知杂项任务同步运动白板电机 通知失败即亲自运动 */
-        white_Motor_PD();                                                           /* 运动白板电机 PD位置 */
-        white_Motor_WH();                                                           /* 运动白板电机 白物质位置 */
+    if (protocol_Debug_SampleBarcode()) {                                                     /* 扫码调试模式 */
+        if (motor_Sched_Run(eMotor_Sched_Job_White_Cycle, 5000) != eMotor_Sched_Result_OK) { /* 运动白板电机 PD位置后回到白物质位置 */
+            motor_Sample_Owari();                                                             /* 清理 */
+            return 1;                                                                         /* 提前结束 */
+        }
     }
 
     if (protocol_Debug_SampleBarcode() == 0) {           /* 非调试模式 */
         if (barcode_result == eBarcodeState_OK) {        /* 二维条码扫描成功 */
-            barcode_Motor_Run_By_Index(eBarcodeIndex_0); /* 回归原点 */
+            barcode_Motor_Run_By_Index(eBarcodeIndex_0); /* 回归原点 与上加热体砸下同时进行 */
         } else {
             /* tray_Move_By_Relative(eMotorDir_REV, 800, 500);  //进仓10毫米 */
             barcode_result = barcode_Scan_Bar();             /* 扫描一维条码 */
@@ -913,12 +963,12 @@ static void motor_Task(void * argument)
     TickType_t xTick;
     eComm_Data_Sample_Radiant radiant = eComm_Data_Sample_Radiant_610;
 
-    led_Mode_Set(eLED_Mode_Keep_Green);    /* LED 绿灯常亮 */
-    motor_OPT_Status_Init_Wait_Complete(); /* 等待光耦结果完成 */
-    motor_Resource_Init();                 /* 电机驱动、位置初始化 */
-    barcode_Init();                        /* 扫码枪初始化 */
-    tray_Motor_EE_Clear();                 /* 清除托盘丢步标志位 */
-    heater_Overshoot_Init(0);              /* 初始化过冲参数 */
+    led_Mode_Set(eLED_Mode_Keep_Green);         /* LED 绿灯常亮 */
+    motor_OPT_Status_Init_Wait_Complete();      /* 等待光耦结果完成 */
+    motor_Resource_Init();                      /* 电机驱动、位置初始化 */
+    tray_Motor_EE_Clear();                      /* 清除托盘丢步标志位 */
+    boot_Mark(BOOT_BIT_MOTOR);                  /* 电机复位完成 */
+    boot_Wait(BOOT_BIT_BARCODE, portMAX_DELAY); /* 扫码枪初始化在杂项任务中并行 */
 
     for (;;) {
         xResult = xQueuePeek(motor_Fun_Queue_Handle, &mf, portMAX_DELAY);
@@ -932,8 +982,8 @@ static void motor_Task(void * argument)
                 if (heat_Motor_Up() != 0) { /* 抬起上加热体电机 失败 */
                     break;
                 };
-                motor_Tray_Move_By_Index(eTrayIndex_0); /* 入仓 */
-                heat_Motor_Down();                      /* 砸下上加热体 */
+                motor_Tray_Move_By_Index(eTrayIndex_0);            /* 入仓 */
+                motor_Sched_Run(eMotor_Sched_Job_Heat_Down, 5000); /* 托盘在原点时砸下上加热体 */
                 break;
             case eMotor_Fun_Out:                        /* 出仓 */
                 motor_Tray_Move_By_Index(eTrayIndex_2); /* 出仓 */
@@ -973,9 +1023,8 @@ static void motor_Task(void * argument)
                 Miscellaneous_Task_Notify(1);                     /* 启动预先点灯 */
 
                 motor_Sample_Temperature_Check();      /* 采样前温度检查 */
-                if (motor_Sample_Barcode_Scan() > 0) { /* 扫码处理 */
-                    motor_Sample_Owari();              /* 清理 */
-                    break;                             /* 收到打断信息 提前结束 */
+                if (motor_Sample_Barcode_Scan() > 0) { /* 扫码处理 已清理 */
+                    break;                             /* 收到打断信息或电机运动失败 提前结束 */
                 }
                 if (protocol_Debug_SampleBarcode() == 0) {                      /* 非调试模式 */
                     if (barcode_Result_Valid_Cnt() == 0) {                      /* 有效条码数量为0 */
@@ -1004,15 +1053,19 @@ static void motor_Task(void * argument)
                     motor_Sample_Owari();                       /* 清理 */
                     break;                                      /* 提前结束 */
                 }
-                cnt = HAL_GetTick() - xTick;                                                                 /* 耗时时间 */
-                if (cnt < pdMS_TO_TICKS(15 * 1000)) {                                                        /* 等待补全15秒 预先点灯 */
-                    xResult = xTaskNotifyWait(0, 0xFFFFFFFF, &xNotifyValue, pdMS_TO_TICKS(15 * 1000) - cnt); /* 等待任务通知 */
-                    if (xResult == pdPASS && xNotifyValue == eMotorNotifyValue_BR) {                         /* 收到中终止命令 */
-                        error_Emit(eError_Sample_Initiative_Break);                                          /* 主动打断 */
-                        motor_Sample_Owari();                                                                /* 清理 */
+                cnt = HAL_GetTick() - xTick;                                                                                        /* 耗时时间 */
+                if (cnt < pdMS_TO_TICKS(comm_Data_Sample_Pre_Light_Get())) {                                                        /* 等待补全 预先点灯 */
+                    xResult = xTaskNotifyWait(0, 0xFFFFFFFF, &xNotifyValue, pdMS_TO_TICKS(comm_Data_Sample_Pre_Light_Get()) - cnt); /* 等待任务通知 */
+                    if (xResult == pdPASS && xNotifyValue == eMotorNotifyValue_BR) {                                                /* 收到中终止命令 */
+                        error_Emit(eError_Sample_Initiative_Break);                                                                 /* 主动打断 */
+                        motor_Sample_Owari();                                                                                       /* 清理 */
                         break;
                     }
                 }
+                if (motor_Sched_Wait(MOTOR_SCHED_RES_ALL, 5000) != eMotor_Sched_Result_OK) { /* 等待后台运动完成 白板电机与上加热体就位 */
+                    motor_Sample_Owari();                                                    /* 超时或运动失败 已上报 清理 */
+                    break;                                                                   /* 提前结束 */
+                }
                 comm_Data_RecordInit(); /* 初始化数据记录 */
                 motor_Sample_Deal(1);   /* 启动采样并控制白板电机 */
                 motor_Sample_Owari();   /* 清理 */
@@ -1027,8 +1080,8 @@ static void motor_Task(void * argument)
                     led_Mode_Set(eLED_Mode_Kirakira_Green);           /* LED 绿灯闪烁 */
 
                     motor_Sample_Temperature_Check();      /* 采样前温度检查 */
-                    if (motor_Sample_Barcode_Scan() > 0) { /* 扫码处理 */
-                        break;                             /* 收到打断信息 提前结束 */
+                    if (motor_Sample_Barcode_Scan() > 0) { /* 扫码处理 已清理 */
+                        break;                             /* 收到打断信息或电机运动失败 提前结束 */
                     }
                     if (comm_Data_Conf_Sem_Wait(pdMS_TO_TICKS(400)) != pdPASS) { /* 等待配置信息 */
                         if (cnt == 0) {                                          /* 首次配置信息 */
@@ -1050,8 +1103,12 @@ static void motor_Task(void * argument)
                         error_Emit(eError_Sample_Initiative_Break); /* 主动打断 */
                         break;                                      /* 提前结束 */
                     }
-                    if (protocol_Debug_SampleBarcode() == 0) {             /* 非调试模式 */
-                        vTaskDelayUntil(&xTick, pdMS_TO_TICKS(15 * 1000)); /* 等待补全15秒 */
+                    if (protocol_Debug_SampleBarcode() == 0) {                                   /* 非调试模式 */
+                        vTaskDelayUntil(&xTick, pdMS_TO_TICKS(comm_Data_Sample_Pre_Light_Get())); /* 等待补全 预先点灯 */
+                    }
+                    if (motor_Sched_Wait(MOTOR_SCHED_RES_ALL, 5000) != eMotor_Sched_Result_OK) { /* 等待后台运动完成 白板电机与上加热体就位 */
+                        motor_Sample_Owari();                                                    /* 超时或运动失败 已上报 清理 */
+                        break;                                                                   /* 提前结束 */
                     }
                     comm_Data_RecordInit(); /* 初始化数据记录 */
                     motor_Sample_Deal(0);   /* 启动采样并控制白板电机 */
@@ -1329,50 +1386,40 @@ static void motor_Task(void * argument)
                 comm_Data_Get_LED_Voltage();                                                                         /* 获取采样板LED电压配置 */
                 gStorgeTaskInfoLockWait(3000);                                                                       /* 等待存储任务空闲 */
                 storgeTaskNotification(eStorgeNotifyConf_Load_Sample_LED, eComm_Data);                               /* 通知存储任务 加载记录 */
+                gStorgeTaskInfoLockWait(3000);                                                                       /* 等待加载记录完成 */
                 led_Mode_Set(eLED_Mode_Red_Green);                                                                   /* 红绿交替 */
                 for (radiant = eComm_Data_Sample_Radiant_610; radiant <= eComm_Data_Sample_Radiant_405; ++radiant) { /* 逐个波长校正 */
-                    switch (radiant) {
-                        case eComm_Data_Sample_Radiant_610:
-                            gComm_Data_LED_Voltage_Interval_Set(COMM_DATA_LED_VOLTAGE_UNIT_610); /* 调整间隔初始化 */
-                            cnt = COMM_DATA_LED_VOLTAGE_INIT_610;                                /* 初始化电压值 */
-                            break;
-                        case eComm_Data_Sample_Radiant_550:
-                            gComm_Data_LED_Voltage_Interval_Set(COMM_DATA_LED_VOLTAGE_UNIT_550); /* 调整间隔初始化 */
-                            cnt = COMM_DATA_LED_VOLTAGE_INIT_550;                                /* 初始化电压值 */
-                            break;
-                        case eComm_Data_Sample_Radiant_405:
-                            gComm_Data_LED_Voltage_Interval_Set(COMM_DATA_LED_VOLTAGE_UNIT_405); /* 调整间隔初始化 */
-                            cnt = COMM_DATA_LED_VOLTAGE_INIT_405;                                /* 初始化电压值 */
-                            break;
-                    }
-                    comm_Data_Set_LED_Voltage(radiant, cnt);                                    /* 设置初始化电压值 */
-                    for (uint8_t i = 0; i < 30; ++i) {                                          /* 循环测试-检测-调整电压 */
-                        comm_Data_RecordInit();                                                 /* 初始化数据记录 */
-                        gComm_Data_SP_LED_Flag_Mark(radiant);                                   /* 标记校正采样板LED电压状态 */
-                        comm_Data_Sample_Send_Conf_Correct(buffer, radiant,                     /* 配置波长 */
-                                                           gComm_Data_LED_Voltage_Points_Get(), /* 点数 */
-                                                           eComm_Data_Outbound_CMD_TEST);       /* 上送 PD 值 */
-                        vTaskDelay(300);                                                        /* 等待回应报文 */
-                        white_Motor_WH();                                                       /* 运动白板电机 白板位置 */
-                        if (motor_Sample_Deal(0)) {                                             /* 启动采样并控制白板电机 */
-                            break;                                                              /* 定标异常 */
+                    cnt = comm_Data_LED_Voltage_Seed(radiant);                                                       /* 初始化电压值 上次校正结果 */
+                    comm_Data_Set_LED_Voltage(radiant, cnt);                                                         /* 设置初始化电压值 */
+                    for (uint8_t i = 0; i < COMM_DATA_LED_SEARCH_MAX; ++i) {                                         /* 循环测试-检测-调整电压 */
+                        comm_Data_RecordInit();                                                                      /* 初始化数据记录 */
+                        gComm_Data_SP_LED_Flag_Mark(radiant);                                                        /* 标记校正采样板LED电压状态 */
+                        comm_Data_Sample_Send_Conf_Correct(buffer, radiant,                                          /* 配置波长 */
+                                                           gComm_Data_LED_Voltage_Points_Get(),                      /* 点数 */
+                                                           eComm_Data_Outbound_CMD_TEST);                            /* 上送 PD 值 */
+                        vTaskDelay(300);                                                                             /* 等待回应报文 */
+                        white_Motor_WH();                                                                            /* 运动白板电机 白板位置 */
+                        if (motor_Sample_Deal(0)) {                                                                  /* 启动采样并控制白板电机 */
+                            break;                                                                                   /* 定标异常 */
                         }
                         white_Motor_WH();                                                                        /* 运动白板电机 白板位置 */
                         comm_Data_Wait_Data((radiant != eComm_Data_Sample_Radiant_405) ? (0x3F) : (0x01), 1200); /* 等待采样结果上送 */
-                        stage = comm_Data_Check_LED(radiant, cnt, i);                                            /* 检查采样值 */
-                        cnt += gComm_Data_LED_Voltage_Interval_Get();                                            /* 回退电压值 */
-                        if (cnt > 1200) {                                                                        /* 电压越限 */
+                        stage = comm_Data_Check_LED(radiant, cnt, i);                                            /* 检查采样值 计算下一测试点 */
+                        if (stage == 3) {                                                                        /* 电压越限 */
                             error_Emit(eError_LED_Correct_Out_Of_Range_610 + radiant - eComm_Data_Sample_Radiant_610);
                             error |= (1 << (radiant - 1));
                             break;
                         }
-                        comm_Data_Set_LED_Voltage(radiant, cnt);                                  /* 调整电压值 */
+                        if (gComm_Data_LED_Voltage_Interval_Get() != 0) { /* 电压值有变化 */
+                            cnt += gComm_Data_LED_Voltage_Interval_Get(); /* 调整电压值 */
+                            comm_Data_Set_LED_Voltage(radiant, cnt);
+                        }
                         if (stage == 0) {                                                         /* 合格即跳出 */
                             gStorgeTaskInfoLockWait(3000);                                        /* 等待存储任务空闲 */
                             storgeTaskNotification(eStorgeNotifyConf_Dump_Sample_LED, eComm_Out); /* 通知存储任务 保存记录 */
                             break;
                         }
-                        if (i == 20 - 1) {
+                        if (i == COMM_DATA_LED_SEARCH_MAX - 1) {
                             error_Emit(eError_LED_Correct_Max_Retry_610 + radiant - eComm_Data_Sample_Radiant_610);
                             error |= (8 << (radiant - 1));
                         }
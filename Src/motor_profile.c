@@ -0,0 +1,295 @@
+/**
+ * @file    motor_profile.c
+ * @brief   DRV8824 步进电机运动曲线生成
+ *
+ * 按 最大速度/加速度/加加速度 生成梯形或S曲线 预先计算每个DMA burst的ARR值
+ * 电机中断中只做查表 配置可通过调试串口在运行时修改 下次运动前生效
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "motor_profile.h"
+#include <math.h>
+#include <string.h>
+
+/* Extern variables ----------------------------------------------------------*/
+
+/* Private includes ----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    sMotor_Profile_Conf conf;                /* 生效中的配置 中断查表使用 */
+    sMotor_Profile_Conf pending;             /* 待生效配置 */
+    uint8_t dirty;                           /* 待生效配置已修改 */
+    uint16_t unt;                            /* 单个burst脉冲数 */
+    uint16_t sum;                            /* 规划burst数目 */
+    uint32_t duration;                       /* 规划运动时长 us */
+    uint16_t table[MOTOR_PROFILE_TABLE_LEN]; /* 加速段ARR表 */
+} sMotor_Profile_Info;
+
+/* Private variables ---------------------------------------------------------*/
+static sMotor_Profile_Info gMotor_Profile_Infos[eMotor_Profile_Index_Num];
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t motor_Profile_Conf_Check(sMotor_Profile_Conf const * pConf);
+static void motor_Profile_Build(eMotor_Profile_Index idx);
+
+/* Private user code ---------------------------------------------------------*/
+
+/**
+ * @brief  运动曲线配置 合法性检查
+ * @param  pConf 配置指针
+ * @retval 0 合法 1 非法
+ */
+static uint8_t motor_Profile_Conf_Check(sMotor_Profile_Conf const * pConf)
+{
+    if (pConf->type >= eMotor_Profile_Type_Num) {
+        return 1;
+    }
+    if (pConf->type == eMotor_Profile_Type_Sigmoid) { /* 原有曲线 不使用其余参数 */
+        return 0;
+    }
+    if (!(pConf->freq_min >= MOTOR_PROFILE_FREQ_MIN) || !(pConf->freq_max >= pConf->freq_min) || !(pConf->freq_max <= MOTOR_PROFILE_FREQ_MAX)) {
+        return 1;
+    }
+    if (!(pConf->acc > 0)) {
+        return 1;
+    }
+    if (pConf->type == eMotor_Profile_Type_SCurve && !(pConf->jerk > 0)) {
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief  运动曲线 注册
+ * @note   由各电机模块在初始化时调用 提供默认配置及机械行程
+ * @param  idx 曲线索引
+ * @param  pConf 默认配置
+ * @param  unt 单个burst脉冲数
+ * @param  sum 规划burst数目
+ * @retval None
+ */
+void motor_Profile_Register(eMotor_Profile_Index idx, sMotor_Profile_Conf const * pConf, uint16_t unt, uint16_t sum)
+{
+    sMotor_Profile_Info * pInfo;
+
+    if (idx >= eMotor_Profile_Index_Num) {
+        return;
+    }
+    pInfo = &gMotor_Profile_Infos[idx];
+    pInfo->unt = unt;
+    pInfo->sum = (sum > MOTOR_PROFILE_TABLE_LEN) ? (MOTOR_PROFILE_TABLE_LEN) : (sum);
+    memcpy(&pInfo->pending, pConf, sizeof(sMotor_Profile_Conf));
+    pInfo->dirty = 1;
+    motor_Profile_Prepare(idx);
+}
+
+/**
+ * @brief  运动曲线配置 设置
+ * @note   可在中断中调用 仅记录待生效配置 下次运动前生效
+ * @param  idx 曲线索引
+ * @param  pConf 配置指针
+ * @retval 0 成功 1 参数非法
+ */
+uint8_t motor_Profile_Conf_Set(eMotor_Profile_Index idx, sMotor_Profile_Conf const * pConf)
+{
+    if (idx >= eMotor_Profile_Index_Num || motor_Profile_Conf_Check(pConf)) {
+        return 1;
+    }
+    memcpy(&gMotor_Profile_Infos[idx].pending, pConf, sizeof(sMotor_Profile_Conf));
+    gMotor_Profile_Infos[idx].dirty = 1;
+    return 0;
+}
+
+/**
+ * @brief  运动曲线配置 获取
+ * @param  idx 曲线索引
+ * @param  pConf 配置指针
+ * @retval 0 成功 1 索引非法
+ */
+uint8_t motor_Profile_Conf_Get(eMotor_Profile_Index idx, sMotor_Profile_Conf * pConf)
+{
+    if (idx >= eMotor_Profile_Index_Num) {
+        return 1;
+    }
+    memcpy(pConf, &gMotor_Profile_Infos[idx].pending, sizeof(sMotor_Profile_Conf));
+    return 0;
+}
+
+/**
+ * @brief  运动曲线配置 打包
+ * @note   索引 + 类型 + 减速标志 + 4个浮点参数 + 最近一次生效曲线的运动时长 us
+ * @param  idx 曲线索引
+ * @param  pBuffer 输出指针
+ * @retval 输出长度 0 索引非法
+ */
+uint8_t motor_Profile_Conf_Pack(eMotor_Profile_Index idx, uint8_t * pBuffer)
+{
+    sMotor_Profile_Conf conf;
+    uint32_t duration;
+
+    if (motor_Profile_Conf_Get(idx, &conf)) {
+        return 0;
+    }
+    pBuffer[0] = idx;
+    pBuffer[1] = conf.type;
+    pBuffer[2] = conf.dec;
+    memcpy(pBuffer + 3, &conf.freq_min, 4);
+    memcpy(pBuffer + 7, &conf.freq_max, 4);
+    memcpy(pBuffer + 11, &conf.acc, 4);
+    memcpy(pBuffer + 15, &conf.jerk, 4);
+    duration = motor_Profile_Duration(idx);
+    memcpy(pBuffer + MOTOR_PROFILE_CONF_LEN, &duration, 4);
+    return MOTOR_PROFILE_CONF_LEN + 4;
+}
+
+/**
+ * @brief  运动曲线配置 解包并设置
+ * @param  pBuffer 输入指针 格式同 motor_Profile_Conf_Pack 不含运动时长
+ * @param  length 输入长度
+ * @retval 0 成功 1 参数非法
+ */
+uint8_t motor_Profile_Conf_Unpack(uint8_t * pBuffer, uint8_t length)
+{
+    sMotor_Profile_Conf conf;
+
+    if (length != MOTOR_PROFILE_CONF_LEN) {
+        return 1;
+    }
+    conf.type = pBuffer[1];
+    conf.dec = pBuffer[2];
+    memcpy(&conf.freq_min, pBuffer + 3, 4);
+    memcpy(&conf.freq_max, pBuffer + 7, 4);
+    memcpy(&conf.acc, pBuffer + 11, 4);
+    memcpy(&conf.jerk, pBuffer + 15, 4);
+    return motor_Profile_Conf_Set((eMotor_Profile_Index)pBuffer[0], &conf);
+}
+
+/**
+ * @brief  运动曲线 生成加速段ARR表
+ * @note   逐步积分 梯形曲线 v^2 = v0^2 + 2a 每步 S曲线 加速度按加加速度增减
+ *         减速段由查表时对称取值得到
+ * @param  idx 曲线索引
+ * @retval None
+ */
+static void motor_Profile_Build(eMotor_Profile_Index idx)
+{
+    sMotor_Profile_Info * pInfo = &gMotor_Profile_Infos[idx];
+    sMotor_Profile_Conf * pConf = &pInfo->conf;
+    float freq, acc = 0, dt;
+    uint16_t i, j;
+
+    pInfo->duration = 0;
+    if (pConf->type == eMotor_Profile_Type_Sigmoid || pInfo->sum == 0) {
+        return;
+    }
+
+    freq = pConf->freq_min;
+    for (i = 0; i < pInfo->sum; ++i) {
+        pInfo->table[i] = MOTOR_PROFILE_TIM_CLK / freq;
+        for (j = 0; j < pInfo->unt; ++j) {
+            if (freq >= pConf->freq_max) {
+                freq = pConf->freq_max;
+                break;
+            }
+            if (pConf->type == eMotor_Profile_Type_Trapezoid) {
+                freq = sqrtf(freq * freq + 2 * pConf->acc);
+                continue;
+            }
+            dt = 1 / freq;
+            if (acc * acc / (2 * pConf->jerk) >= pConf->freq_max - freq) { /* 剩余速度差不足 开始收敛加速度 */
+                acc -= pConf->jerk * dt;
+                if (acc < 0) {
+                    acc = 0;
+                }
+            } else {
+                acc += pConf->jerk * dt;
+                if (acc > pConf->acc) {
+                    acc = pConf->acc;
+                }
+            }
+            freq += acc * dt;
+        }
+    }
+
+    for (i = 0; i < pInfo->sum; ++i) {
+        pInfo->duration += pInfo->unt * motor_Profile_Period(idx, i) / (MOTOR_PROFILE_TIM_CLK / 1000000);
+    }
+}
+
+/**
+ * @brief  运动曲线 运动前准备
+ * @note   任务中调用 获取PWM资源后启动PWM前 若配置已修改则重新生成ARR表
+ * @param  idx 曲线索引
+ * @retval None
+ */
+void motor_Profile_Prepare(eMotor_Profile_Index idx)
+{
+    sMotor_Profile_Info * pInfo;
+
+    if (idx >= eMotor_Profile_Index_Num) {
+        return;
+    }
+    pInfo = &gMotor_Profile_Infos[idx];
+    if (pInfo->dirty == 0) {
+        return;
+    }
+    taskENTER_CRITICAL();
+    memcpy(&pInfo->conf, &pInfo->pending, sizeof(sMotor_Profile_Conf));
+    pInfo->dirty = 0;
+    taskEXIT_CRITICAL();
+    motor_Profile_Build(idx);
+}
+
+/**
+ * @brief  运动曲线 是否为原有S型函数曲线
+ * @param  idx 曲线索引
+ * @retval 1 原有曲线 0 可配置曲线
+ */
+uint8_t motor_Profile_Is_Sigmoid(eMotor_Profile_Index idx)
+{
+    if (idx >= eMotor_Profile_Index_Num || gMotor_Profile_Infos[idx].sum == 0) {
+        return 1;
+    }
+    return gMotor_Profile_Infos[idx].conf.type == eMotor_Profile_Type_Sigmoid;
+}
+
+/**
+ * @brief  运动曲线 查表获取周期
+ * @note   中断中调用 超出规划长度后 减速曲线保持起步频率 否则保持最大频率
+ * @param  idx 曲线索引
+ * @param  cnt burst计数
+ * @retval 周期长度 ARR
+ */
+uint16_t motor_Profile_Period(eMotor_Profile_Index idx, uint16_t cnt)
+{
+    sMotor_Profile_Info * pInfo = &gMotor_Profile_Infos[idx];
+    uint16_t period_acc, period_dec;
+
+    if (cnt >= pInfo->sum) {
+        return (pInfo->conf.dec) ? (pInfo->table[0]) : (pInfo->table[pInfo->sum - 1]);
+    }
+    period_acc = pInfo->table[cnt];
+    if (pInfo->conf.dec == 0) {
+        return period_acc;
+    }
+    period_dec = pInfo->table[pInfo->sum - 1 - cnt];
+    return (period_acc > period_dec) ? (period_acc) : (period_dec);
+}
+
+/**
+ * @brief  运动曲线 规划运动时长
+ * @param  idx 曲线索引
+ * @retval 最近一次生效曲线的规划运动时长 us 原有曲线返回0
+ */
+uint32_t motor_Profile_Duration(eMotor_Profile_Index idx)
+{
+    if (idx >= eMotor_Profile_Index_Num) {
+        return 0;
+    }
+    return gMotor_Profile_Infos[idx].duration;
+}
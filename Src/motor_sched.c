@@ -0,0 +1,293 @@
+/**
+ * @file    motor_sched.c
+ * @brief   电机运动调度
+ *
+ * 各运动声明占用的资源及位置联锁条件 资源不冲突的运动可以同时进行
+ * PWM组(白板电机 上加热体电机) 可由后台任务执行 同时前台执行SPI组(托盘电机 扫码电机)运动
+ * 资源使用事件组管理 置位表示空闲 提交时获取 运动完成后释放
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "motor_sched.h"
+#include "heat_motor.h"
+#include "white_motor.h"
+#include "tray_run.h"
+
+/* Extern variables ----------------------------------------------------------*/
+
+/* Private includes ----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+#define MOTOR_SCHED_QUEUE_LENGTH 4 /* 后台运动队列深度 */
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    uint8_t res;              /* 占用资源 */
+    uint8_t (*pfCheck)(void); /* 位置联锁检查 0 允许运动 */
+    uint8_t (*pfRun)(void);   /* 运动执行 0 成功 NULL 仅前台占用资源 */
+    eError_Code error;        /* 等待资源超时 上报错误码 */
+} sMotor_Sched_Job_Info;
+
+/* Private function prototypes -----------------------------------------------*/
+static void motor_Sched_Task(void * argument);
+
+static uint8_t motor_Sched_Check_Heater_Up(void);
+static uint8_t motor_Sched_Check_Tray_In(void);
+
+static uint8_t motor_Sched_Run_White_Cycle(void);
+static uint8_t motor_Sched_Run_Heat_Up(void);
+static uint8_t motor_Sched_Run_Heat_Down(void);
+
+/* Private variables ---------------------------------------------------------*/
+static EventGroupHandle_t motor_sched_res_flags = NULL;                                        /* 运动资源标志 置位表示空闲 */
+static StaticEventGroup_t motor_sched_res_flags_Buffer;                                        /* 运动资源标志 静态内存 */
+static xQueueHandle motor_Sched_Queue_Handle = NULL;                                           /* 后台运动队列 */
+static StaticQueue_t motor_Sched_Queue_Buffer;                                                 /* 后台运动队列 静态内存 */
+static uint8_t motor_Sched_Queue_Storage[MOTOR_SCHED_QUEUE_LENGTH * sizeof(eMotor_Sched_Job)]; /* 后台运动队列 存储区 */
+static xTaskHandle motor_Sched_Task_Handle = NULL;                                             /* 后台运动任务 */
+static StackType_t motor_Sched_Task_Stack[192];                                                /* 后台运动任务 栈 */
+static StaticTask_t motor_Sched_Task_TCB;                                                      /* 后台运动任务 控制块 */
+static volatile eMotor_Sched_Job gMotor_Sched_Running = eMotor_Sched_Job_Num;                  /* 后台执行中的运动 */
+static volatile uint8_t gMotor_Sched_Failed = 0;                                               /* 后台运动失败 等待完成时读取并清除 */
+
+/* 运动资源及联锁声明 */
+static const sMotor_Sched_Job_Info cMotor_Sched_Jobs[eMotor_Sched_Job_Num] = {
+    [eMotor_Sched_Job_Tray] = {MOTOR_SCHED_RES_SPI | MOTOR_SCHED_RES_HEATER | MOTOR_SCHED_RES_TRAY, motor_Sched_Check_Heater_Up, NULL, eError_Motor_Tray_Busy},
+    [eMotor_Sched_Job_White_PD] = {MOTOR_SCHED_RES_PWM, NULL, white_Motor_PD, eError_Motor_White_Timeout_PD},
+    [eMotor_Sched_Job_White_WH] = {MOTOR_SCHED_RES_PWM, NULL, white_Motor_WH, eError_Motor_White_Timeout_WH},
+    [eMotor_Sched_Job_White_Cycle] = {MOTOR_SCHED_RES_PWM, NULL, motor_Sched_Run_White_Cycle, eError_Motor_White_Timeout_PD},
+    [eMotor_Sched_Job_Heat_Up] = {MOTOR_SCHED_RES_PWM | MOTOR_SCHED_RES_HEATER, NULL, motor_Sched_Run_Heat_Up, eError_Motor_Heater_Timeout_Up},
+    [eMotor_Sched_Job_Heat_Down] = {MOTOR_SCHED_RES_PWM | MOTOR_SCHED_RES_HEATER | MOTOR_SCHED_RES_TRAY, motor_Sched_Check_Tray_In, motor_Sched_Run_Heat_Down, eError_Motor_Heater_Timeout_Down},
+};
+
+/* Private user code ---------------------------------------------------------*/
+
+/**
+ * @brief  联锁检查 托盘运动前上加热体必须处于抬起位置
+ * @param  None
+ * @retval 0 允许 1 禁止
+ */
+static uint8_t motor_Sched_Check_Heater_Up(void)
+{
+    return heat_Motor_Position_Is_Up() == 0;
+}
+
+/**
+ * @brief  联锁检查 上加热体砸下前托盘必须处于原点位置
+ * @param  None
+ * @retval 0 允许 1 禁止
+ */
+static uint8_t motor_Sched_Check_Tray_In(void)
+{
+    return TRAY_MOTOR_IS_OPT_1 == 0;
+}
+
+/**
+ * @brief  白板电机 PD位置后回到白板位置
+ * @param  None
+ * @retval 0 成功 其他 失败
+ */
+static uint8_t motor_Sched_Run_White_Cycle(void)
+{
+    uint8_t result;
+
+    result = white_Motor_PD();  /* 运动白板电机 PD位置 */
+    result |= white_Motor_WH(); /* 运动白板电机 白物质位置 */
+    return result;
+}
+
+/**
+ * @brief  上加热体电机 抬起
+ * @param  None
+ * @retval 0 成功 其他 失败
+ */
+static uint8_t motor_Sched_Run_Heat_Up(void)
+{
+    return heat_Motor_Up();
+}
+
+/**
+ * @brief  上加热体电机 砸下
+ * @param  None
+ * @retval 0 成功 其他 失败
+ */
+static uint8_t motor_Sched_Run_Heat_Down(void)
+{
+    return heat_Motor_Down();
+}
+
+/**
+ * @brief  电机运动调度初始化
+ * @param  None
+ * @retval None
+ */
+void motor_Sched_Init(void)
+{
+    motor_sched_res_flags = xEventGroupCreateStatic(&motor_sched_res_flags_Buffer);
+    if (motor_sched_res_flags == NULL) {
+        Error_Handler();
+    }
+    xEventGroupSetBits(motor_sched_res_flags, MOTOR_SCHED_RES_ALL); /* 全部资源空闲 */
+
+    motor_Sched_Queue_Handle = xQueueCreateStatic(MOTOR_SCHED_QUEUE_LENGTH, sizeof(eMotor_Sched_Job), motor_Sched_Queue_Storage, &motor_Sched_Queue_Buffer);
+    if (motor_Sched_Queue_Handle == NULL) {
+        Error_Handler();
+    }
+    motor_Sched_Task_Handle = xTaskCreateStatic(motor_Sched_Task, "Motor Sched", ARRAY_LEN(motor_Sched_Task_Stack), NULL, TASK_PRIORITY_MOTOR, motor_Sched_Task_Stack, &motor_Sched_Task_TCB);
+    if (motor_Sched_Task_Handle == NULL) {
+        Error_Handler();
+    }
+}
+
+/**
+ * @brief  运动资源 获取
+ * @note   等待运动声明的全部资源空闲后一次性获取 再检查位置联锁 不满足则归还资源
+ * @note   超时与联锁不满足均上报错误
+ * @param  job 运动
+ * @param  timeout 等待资源最长时间
+ * @retval 获取结果
+ */
+eMotor_Sched_Result motor_Sched_Claim(eMotor_Sched_Job job, uint32_t timeout)
+{
+    sMotor_Sched_Job_Info const * pInfo;
+    EventBits_t uxBits;
+
+    if (job >= eMotor_Sched_Job_Num) {
+        return eMotor_Sched_Result_Failed;
+    }
+    pInfo = &cMotor_Sched_Jobs[job];
+    uxBits = xEventGroupWaitBits(motor_sched_res_flags, pInfo->res, pdTRUE, pdTRUE, timeout); /* 全部置位后清除 */
+    if ((uxBits & pInfo->res) != pInfo->res) {
+        error_Emit(pInfo->error);
+        return eMotor_Sched_Result_Timeout;
+    }
+    if (pInfo->pfCheck != NULL && pInfo->pfCheck() != 0) { /* 位置联锁不满足 */
+        xEventGroupSetBits(motor_sched_res_flags, pInfo->res);
+        error_Emit(eError_Motor_Interlock);
+        return eMotor_Sched_Result_Interlock;
+    }
+    return eMotor_Sched_Result_OK;
+}
+
+/**
+ * @brief  运动资源 释放
+ * @param  job 运动
+ * @retval None
+ */
+void motor_Sched_Release(eMotor_Sched_Job job)
+{
+    if (job >= eMotor_Sched_Job_Num) {
+        return;
+    }
+    xEventGroupSetBits(motor_sched_res_flags, cMotor_Sched_Jobs[job].res);
+}
+
+/**
+ * @brief  运动 前台执行
+ * @note   获取资源后在调用者任务中执行 完成后释放
+ * @param  job 运动
+ * @param  timeout 等待资源最长时间
+ * @retval 执行结果
+ */
+eMotor_Sched_Result motor_Sched_Run(eMotor_Sched_Job job, uint32_t timeout)
+{
+    eMotor_Sched_Result result;
+
+    result = motor_Sched_Claim(job, timeout);
+    if (result != eMotor_Sched_Result_OK) {
+        return result;
+    }
+    if (cMotor_Sched_Jobs[job].pfRun != NULL && cMotor_Sched_Jobs[job].pfRun() != 0) {
+        result = eMotor_Sched_Result_Failed;
+    }
+    motor_Sched_Release(job);
+    return result;
+}
+
+/**
+ * @brief  运动 后台执行
+ * @note   在调用者任务中获取资源及检查联锁 保证与前台运动的先后顺序 运动本身交由后台任务
+ *         后台队列满则在调用者任务中直接执行
+ * @param  job 运动
+ * @param  timeout 等待资源最长时间
+ * @retval 提交结果
+ */
+eMotor_Sched_Result motor_Sched_Start(eMotor_Sched_Job job, uint32_t timeout)
+{
+    eMotor_Sched_Result result;
+
+    if (job >= eMotor_Sched_Job_Num || cMotor_Sched_Jobs[job].pfRun == NULL) {
+        return eMotor_Sched_Result_Failed;
+    }
+    result = motor_Sched_Claim(job, timeout);
+    if (result != eMotor_Sched_Result_OK) {
+        return result;
+    }
+    if (xQueueSendToBack(motor_Sched_Queue_Handle, &job, 0) != pdPASS) { /* 提交失败即亲自运动 */
+        if (cMotor_Sched_Jobs[job].pfRun() != 0) {
+            result = eMotor_Sched_Result_Failed;
+        }
+        motor_Sched_Release(job);
+    }
+    return result;
+}
+
+/**
+ * @brief  等待运动资源空闲
+ * @note   超时上报后台执行中运动的超时错误 后台运动失败的错误已由各电机模块上报
+ * @param  res 资源掩码 MOTOR_SCHED_RES_*
+ * @param  timeout 最长等待时间
+ * @retval 等待结果 OK 空闲 Timeout 超时 Failed 上次等待以来有后台运动失败
+ */
+eMotor_Sched_Result motor_Sched_Wait(uint8_t res, uint32_t timeout)
+{
+    eMotor_Sched_Job job;
+
+    if ((xEventGroupWaitBits(motor_sched_res_flags, res, pdFALSE, pdTRUE, timeout) & res) != res) {
+        job = gMotor_Sched_Running;
+        if (job < eMotor_Sched_Job_Num) {
+            error_Emit(cMotor_Sched_Jobs[job].error);
+        }
+        return eMotor_Sched_Result_Timeout;
+    }
+    if (gMotor_Sched_Failed) {
+        gMotor_Sched_Failed = 0;
+        return eMotor_Sched_Result_Failed;
+    }
+    return eMotor_Sched_Result_OK;
+}
+
+/**
+ * @brief  运动资源是否被占用
+ * @param  res 资源掩码 MOTOR_SCHED_RES_*
+ * @retval 0 空闲 1 占用
+ */
+uint8_t motor_Sched_Is_Busy(uint8_t res)
+{
+    return (xEventGroupGetBits(motor_sched_res_flags) & res) != res;
+}
+
+/**
+ * @brief  后台运动任务
+ * @note   资源已由提交者获取 执行完成后释放
+ * @param  argument: Not used
+ * @retval None
+ */
+static void motor_Sched_Task(void * argument)
+{
+    eMotor_Sched_Job job;
+
+    for (;;) {
+        if (xQueueReceive(motor_Sched_Queue_Handle, &job, portMAX_DELAY) != pdPASS) {
+            continue;
+        }
+        gMotor_Sched_Running = job;
+        if (cMotor_Sched_Jobs[job].pfRun() != 0) { /* 失败信息由各电机模块上报 */
+            gMotor_Sched_Failed = 1;
+        }
+        gMotor_Sched_Running = eMotor_Sched_Job_Num;
+        motor_Sched_Release(job);
+    }
+}
@@ -0,0 +1,237 @@
+/**
+ * @file    power.c
+ * @brief   低功耗 无节拍空闲
+ *
+ * configUSE_TICKLESS_IDLE 2 空闲任务调用 vPortSuppressTicksAndSleep 停止系统节拍 休眠到下一个任务解除阻塞时刻
+ * STM32F207 无低功耗定时器 Stop 模式会停止加热/电机定时器与串口DMA 故只进入 Sleep 模式(WFI) 外设时钟不受影响
+ * 唤醒定时 借用运行时间统计 TIM5 (32位 10uS 自由计数) 比较通道1 不影响计数
+ * 休眠期间暂停 HAL 时基 TIM14 醒来后按 TIM5 经过时间补偿系统节拍与 HAL 节拍 单次补偿误差在 10uS 以内
+ *
+ * 休眠统计 休眠次数 休眠时间(TIM5) WFI 内 DWT 周期数 加热定时器回调间隔最小/最大值 用于确认加热控制节奏不受影响
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "power.h"
+#include "sys_stat.h"
+
+/* Extern variables ----------------------------------------------------------*/
+
+/* Private includes ----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+static uint32_t gPower_Tick_Cycles = 0;  /* 每节拍 SysTick 周期数 */
+static uint32_t gPower_Unit_Cycles = 0;  /* TIM5 每计数 CPU 周期数 */
+static uint32_t gPower_Stat_Start = 0;   /* 统计起始时刻 TIM5 */
+static uint32_t gPower_Sleep_Time = 0;   /* 休眠时间 TIM5 10uS */
+static uint64_t gPower_WFI_Cycles = 0;   /* WFI 内 DWT 周期数 */
+static uint32_t gPower_Sleep_Count = 0;  /* 休眠次数 */
+static uint32_t gPower_Abort_Count = 0;  /* 放弃休眠次数 */
+static uint32_t gPower_Heater_Last = 0;  /* 加热定时器上次回调时刻 TIM5 0 为无 */
+static uint32_t gPower_Heater_Min = 0;   /* 加热定时器回调间隔 最小值 10uS */
+static uint32_t gPower_Heater_Max = 0;   /* 加热定时器回调间隔 最大值 10uS */
+
+/* Private constants ---------------------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+
+/**
+ * @brief  低功耗 初始化
+ * @note   启动调度器前调用 唤醒中断优先级最低 不调用系统接口
+ * @param  None
+ * @retval None
+ */
+void power_Init(void)
+{
+    gPower_Tick_Cycles = configCPU_CLOCK_HZ / configTICK_RATE_HZ;
+    gPower_Unit_Cycles = SystemCoreClock / 1000000 * SYS_STAT_RUN_TIME_US;
+    power_Stat_Clear();
+
+    HAL_NVIC_SetPriority(TIM5_IRQn, configLIBRARY_LOWEST_INTERRUPT_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(TIM5_IRQn);
+}
+
+/**
+ * @brief  无节拍空闲 休眠
+ * @note   空闲任务中调度器挂起时调用 替代移植层默认实现
+ * @param  xExpectedIdleTime 预期空闲节拍数
+ * @retval None
+ */
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime)
+{
+    uint32_t start, stop, elapsed, ticks, crossed, reload, wfi;
+
+    if (xExpectedIdleTime > POWER_SLEEP_TICK_MAX) {
+        xExpectedIdleTime = POWER_SLEEP_TICK_MAX;
+    }
+
+    __disable_irq();
+    __DSB();
+    __ISB();
+    if (eTaskConfirmSleepModeStatus() == eAbortSleep) { /* 关中断期间 有任务就绪 */
+        ++gPower_Abort_Count;
+        __enable_irq();
+        return;
+    }
+
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;    /* 停止系统节拍 */
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) {     /* 停止前节拍已到 交由节拍中断处理 */
+        SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk; /* 恢复系统节拍 */
+        ++gPower_Abort_Count;
+        __enable_irq();
+        return;
+    }
+    elapsed = gPower_Tick_Cycles - 1 - SysTick->VAL; /* 本节拍内已经过周期数 */
+    start = TIM5->CNT;
+
+    TIM5->CCR1 = start + (xExpectedIdleTime * gPower_Tick_Cycles - elapsed) / gPower_Unit_Cycles; /* 预期唤醒时刻 */
+    TIM5->SR = ~TIM_SR_CC1IF;
+    TIM5->DIER |= TIM_DIER_CC1IE;
+    HAL_SuspendTick(); /* 暂停 HAL 时基 */
+
+    wfi = DWT->CYCCNT;
+    __DSB();
+    __WFI();
+    __ISB();
+    gPower_WFI_Cycles += DWT->CYCCNT - wfi;
+
+    TIM5->DIER &= ~TIM_DIER_CC1IE; /* 唤醒定时 不再需要 */
+    TIM5->SR = ~TIM_SR_CC1IF;
+    NVIC_ClearPendingIRQ(TIM5_IRQn);
+    stop = TIM5->CNT;
+
+    gPower_Sleep_Time += stop - start;
+    ++gPower_Sleep_Count;
+
+    elapsed += (stop - start) * gPower_Unit_Cycles; /* 自上个节拍起 经过周期数 */
+    crossed = elapsed / gPower_Tick_Cycles;
+    if (crossed >= xExpectedIdleTime) { /* 定时唤醒 最后一个节拍交由节拍中断处理 保证定时器/延时到期处理 */
+        ticks = xExpectedIdleTime - 1;
+        elapsed -= xExpectedIdleTime * gPower_Tick_Cycles;
+        if (elapsed >= gPower_Tick_Cycles) {
+            elapsed = gPower_Tick_Cycles - 1;
+        }
+        SCB->ICSR = SCB_ICSR_PENDSTSET_Msk;
+    } else { /* 其他中断唤醒 */
+        ticks = crossed;
+        elapsed -= crossed * gPower_Tick_Cycles;
+    }
+
+    reload = gPower_Tick_Cycles - 1 - elapsed; /* 下一节拍 保持原相位 */
+    if (reload == 0) {
+        reload = 1;
+    }
+    SysTick->LOAD = reload;
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD = gPower_Tick_Cycles - 1;
+
+    uwTick += crossed * uwTickFreq; /* HAL 节拍补偿 休眠期间溢出标志丢弃 */
+    TIM14->SR = ~TIM_SR_UIF;
+    HAL_ResumeTick();
+
+    vTaskStepTick(ticks);
+    __enable_irq();
+}
+
+/**
+ * @brief  唤醒定时器 中断处理
+ * @note   休眠中关中断唤醒 中断标志在休眠函数内清除 此处仅防止遗留标志
+ * @param  None
+ * @retval None
+ */
+void power_Wake_IRQ_Handler(void)
+{
+    TIM5->DIER &= ~TIM_DIER_CC1IE;
+    TIM5->SR = ~TIM_SR_CC1IF;
+}
+
+/**
+ * @brief  加热定时器回调间隔 记录
+ * @note   加热定时器回调开头调用
+ * @param  None
+ * @retval None
+ */
+void power_Heater_Trace(void)
+{
+    uint32_t now, period;
+
+    now = TIM5->CNT | 1; /* 0 表示无 */
+    if (gPower_Heater_Last != 0) {
+        period = now - gPower_Heater_Last;
+        if (gPower_Heater_Min == 0 || period < gPower_Heater_Min) {
+            gPower_Heater_Min = period;
+        }
+        if (period > gPower_Heater_Max) {
+            gPower_Heater_Max = period;
+        }
+    }
+    gPower_Heater_Last = now;
+}
+
+/**
+ * @brief  休眠统计 打包
+ * @note   标识 + 统计间隔 + 休眠时间 + WFI 时间 4字节 10uS + 休眠次数 4字节 + 放弃次数 2字节 + 加热定时器回调间隔 最小/最大 2字节 10uS
+ * @note   可在中断中调用 统计值为清零以来
+ * @param  pBuffer 输出指针
+ * @retval 输出长度
+ */
+uint8_t power_Stat_Pack(uint8_t * pBuffer)
+{
+    uint32_t data[4];
+    uint16_t half[3];
+    UBaseType_t uxSavedInterruptStatus;
+    uint8_t i, length = 0;
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    data[0] = TIM5->CNT - gPower_Stat_Start;
+    data[1] = gPower_Sleep_Time;
+    data[2] = gPower_WFI_Cycles / gPower_Unit_Cycles;
+    data[3] = gPower_Sleep_Count;
+    half[0] = (gPower_Abort_Count > UINT16_MAX) ? (UINT16_MAX) : (gPower_Abort_Count);
+    half[1] = (gPower_Heater_Min > UINT16_MAX) ? (UINT16_MAX) : (gPower_Heater_Min);
+    half[2] = (gPower_Heater_Max > UINT16_MAX) ? (UINT16_MAX) : (gPower_Heater_Max);
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+
+    pBuffer[length++] = POWER_TAG_STAT;
+    for (i = 0; i < ARRAY_LEN(data); ++i) {
+        pBuffer[length++] = data[i] >> 0;
+        pBuffer[length++] = data[i] >> 8;
+        pBuffer[length++] = data[i] >> 16;
+        pBuffer[length++] = data[i] >> 24;
+    }
+    for (i = 0; i < ARRAY_LEN(half); ++i) {
+        pBuffer[length++] = half[i] & 0xFF;
+        pBuffer[length++] = half[i] >> 8;
+    }
+    return length;
+}
+
+/**
+ * @brief  休眠统计 清零
+ * @note   可在中断中调用
+ * @param  None
+ * @retval None
+ */
+void power_Stat_Clear(void)
+{
+    UBaseType_t uxSavedInterruptStatus;
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    gPower_Stat_Start = TIM5->CNT;
+    gPower_Sleep_Time = 0;
+    gPower_WFI_Cycles = 0;
+    gPower_Sleep_Count = 0;
+    gPower_Abort_Count = 0;
+    gPower_Heater_Last = 0;
+    gPower_Heater_Min = 0;
+    gPower_Heater_Max = 0;
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+}
@@ -10,6 +10,7 @@
 #include "tray_run.h"
 #include "heat_motor.h"
 #include "white_motor.h"
+#include "motor_profile.h"
 #include "motor.h"
 #include "beep.h"
 #include "soft_timer.h"
@@ -19,6 +20,10 @@
 #include "innate_flash.h"
 #include "heater.h"
 #include "version.h"
+#include "sys_stat.h"
+#include "power.h"
+#include "time_wheel.h"
+#include "boot.h"
 
 /* Extern variables ----------------------------------------------------------*/
 extern TIM_HandleTypeDef htim9;
@@ -36,6 +41,8 @@ extern TIM_HandleTypeDef htim4;
 #define SELF_CHECK_TOP_MAX 38
 #define SELF_CHECK_TOP_MIN 36
 
+#define PROTOCOL_DATA_PARSE_SIZE (COMM_DATA_SER_RX_SIZE + 6 + 2 * 20) /* 采样板解析缓存 原地构造转发帧后移 6 字节 混合类型每点补充 2 字节 */
+
 /* Private typedef -----------------------------------------------------------*/
 typedef struct {
     uint8_t ACK_Out;  /* 向对方发送回应确认帧号 */
@@ -69,6 +76,7 @@ static uint8_t gProtocol_Debug_Flag = eProtocol_Debug_ErrorReport;
 static uint8_t gProtocol_Out_ACK_Pack_Buffer[8];
 static uint8_t gProtocol_Main_ACK_Pack_Buffer[8];
 static uint8_t gProtocol_Data_ACK_Pack_Buffer[8];
+static uint8_t gProtocol_Data_Parse_Buffer[PROTOCOL_DATA_PARSE_SIZE];
 
 /* Private function prototypes -----------------------------------------------*/
 static uint8_t protocol_Is_Debug(eProtocol_Debug_Item item);
@@ -285,10 +293,17 @@ unsigned char CRC8_Check(unsigned char * p, uint16_t len)
  * @brief  串口 1 包头判定
  * @param  pBuff 数据指针
  * @param  length 数据长度
+ * @note   仅剩 1 字节时 0x69 视为不完整包头 拼包时保留
  * @retval 0 非包头 1 包头
  */
 uint8_t protocol_has_head(uint8_t * pBuff, uint16_t length)
 {
+    if (length == 0) {
+        return 0;
+    }
+    if (length == 1) { /* 不读取范围外数据 */
+        return (pBuff[0] == 0x69) ? (1) : (0);
+    }
     if (pBuff[0] == 0x69 && pBuff[1] == 0xAA) {
         return 1;
     }
@@ -303,7 +318,7 @@ uint8_t protocol_has_head(uint8_t * pBuff, uint16_t length)
  */
 uint16_t protocol_has_tail(uint8_t * pBuff, uint16_t length)
 {
-    if (pBuff[2] + 4 > length) { /* 长度不足 */
+    if (length < 3 || pBuff[2] + 4 > length) { /* 长度不足 */
         return 0;
     }
     return pBuff[2] + 4; /* 应有长度 */
@@ -313,10 +328,14 @@ uint16_t protocol_has_tail(uint8_t * pBuff, uint16_t length)
  * @brief  串口 1 完整性判断
  * @param  pBuff 数据指针
  * @param  length 数据长度
+ * @note   长度字节小于 3 时 length - 5 会下溢 CRC 读取 64K 范围外数据 此类包直接判为不完整
  * @retval 包尾位置 无包尾时返回0
  */
 uint8_t protocol_is_comp(uint8_t * pBuff, uint16_t length)
 {
+    if (length < 7) { /* 最短包 无数据 */
+        return 0;
+    }
     if (CRC8(pBuff + 4, length - 5) == pBuff[length - 1]) { /* CRC8 校验完整性 */
         return 1;
     }
@@ -469,6 +488,7 @@ uint8_t protocol_Temp_Upload_Comm_Get(eProtocol_COMM_Index comm_index)
 
 /**
  * @brief  温度主动上送处理 错误信息处理
+ * @note   首次处理时 温度无效立即报错 此后间隔 1 Min
  * @param  temp_btm 下加热体温度
  * @param  temp_top 上加热体温度
  * @param  now 系统时刻
@@ -478,6 +498,7 @@ void protocol_Temp_Upload_Error_Deal(TickType_t now, float temp_btm, float temp_
 {
     static TickType_t xTick_btm_Keep_low = 0, xTick_btm_Keep_Hight = 0, xTick_top_Keep_low = 0, xTick_top_Keep_Hight = 0;
     static TickType_t xTick_btm_Nai = 0, xTick_top_Nai = 0;
+    static uint8_t first = 1; /* 首次处理 */
 
     if (temp_btm < 29) {                                                             /* 温度值低于29 */
         xTick_btm_Keep_Hight = now;                                                  /* 温度过高计数清零 */
@@ -487,7 +508,7 @@ void protocol_Temp_Upload_Error_Deal(TickType_t now, float temp_btm, float temp_
         }
     } else if (temp_btm > 45) {              /* 温度值高于45 */
         if (temp_btm == TEMP_INVALID_DATA) { /* 温度值为无效值 */
-            if (now - xTick_btm_Nai > 60 * pdMS_TO_TICKS(1000) || now < 100) {
+            if (now - xTick_btm_Nai > 60 * pdMS_TO_TICKS(1000) || first) {
                 error_Emit(eError_Temperature_Btm_Abnormal); /* 报错 */
                 xTick_btm_Nai = now;
             }
@@ -512,7 +533,7 @@ void protocol_Temp_Upload_Error_Deal(TickType_t now, float temp_btm, float temp_
         }
     } else if (temp_top > 45) {              /* 温度值高于45 */
         if (temp_top == TEMP_INVALID_DATA) { /* 温度值为无效值 */
-            if (now - xTick_top_Nai > 60 * pdMS_TO_TICKS(1000) || now < 100) {
+            if (now - xTick_top_Nai > 60 * pdMS_TO_TICKS(1000) || first) {
                 error_Emit(eError_Temperature_Top_Abnormal); /* 报错 */
                 xTick_top_Nai = now;
             }
@@ -528,6 +549,7 @@ void protocol_Temp_Upload_Error_Deal(TickType_t now, float temp_btm, float temp_
         xTick_top_Keep_Hight = now; /* 温度过高计数清零 */
         xTick_top_Nai = now;        /* 温度无效计数清零 */
     }
+    first = 0;
 }
 
 /**
@@ -592,6 +614,7 @@ void protocol_Temp_Upload_Out_Deal(float temp_btm, float temp_top)
         if (temp_btm != TEMP_INVALID_DATA || temp_top != TEMP_INVALID_DATA) { /* 温度值都不是无效值 */
             comm_Out_SendTask_QueueEmitCover(buffer, length);                 /* 提交到发送队列 */
         }
+        sys_Stat_Resource_Upload_Deal(); /* 资源余量 按周期上送 */
         if (protocol_Debug_Temperature()) { /* 使能温度调试 */
             for (i = eTemp_NTC_Index_0; i <= eTemp_NTC_Index_8; ++i) {
                 temperature = temp_Get_Temp_Data(i);
@@ -642,26 +665,26 @@ void protocol_Temp_Upload_Deal(void)
     now = xTaskGetTickCount();
     if (protocol_Temp_Upload_Is_Suspend() == 0) { /* 暂停上送标志 */
         protocol_Temp_Upload_Error_Deal(now, temp_btm, temp_top);
-        if (now - xTick_Main > 5 * pdMS_TO_TICKS(1000)) {
+        if (now - xTick_Main >= 5 * pdMS_TO_TICKS(1000)) {
             xTick_Main = now;
             protocol_Temp_Upload_Main_Deal(temp_btm, temp_top, temp_env);
         }
     }
 
     if (protocol_Debug_Factory_Temp()) {
-        if (now - xTick_Out > 2 * pdMS_TO_TICKS(1000)) {
+        if (now - xTick_Out >= 2 * pdMS_TO_TICKS(1000)) {
             xTick_Out = now;
             protocol_Self_Check_Temp_ALL();
         }
     } else {
         if (protocol_Debug_Temperature()) {
-            if (now - xTick_Out > 0.2 * pdMS_TO_TICKS(1000)) {
+            if (now - xTick_Out >= 0.2 * pdMS_TO_TICKS(1000)) {
                 xTick_Out = now;
                 protocol_Temp_Upload_Out_Deal(temp_btm, temp_top);
             }
         } else if (protocol_Temp_Upload_Is_Suspend() == 0) { /* 暂停上送标志 */
             {
-                if (now - xTick_Out > 5 * pdMS_TO_TICKS(1000)) {
+                if (now - xTick_Out >= 5 * pdMS_TO_TICKS(1000)) {
                     xTick_Out = now;
                     protocol_Temp_Upload_Out_Deal(temp_btm, temp_top);
                 }
@@ -1070,6 +1093,23 @@ static void protocol_Parse_Out_Fun_ISR(uint8_t * pInBuff, uint16_t length)
                     break;
             }
             break;
+        case eProtocolEmitPack_Client_CMD_Debug_Profile: /* 电机运动曲线 */
+            if (length == 7 + MOTOR_PROFILE_CONF_LEN) {  /* 修改配置 下次运动前生效 */
+                if (motor_Profile_Conf_Unpack(pInBuff + 6, MOTOR_PROFILE_CONF_LEN)) {
+                    error_Emit_FromISR(eError_Comm_Out_Param_Error);
+                    break;
+                }
+            } else if (length != 8) {
+                error_Emit_FromISR(eError_Comm_Out_Param_Error);
+                break;
+            }
+            result = motor_Profile_Conf_Pack((eMotor_Profile_Index)pInBuff[6], pInBuff); /* 回读配置 */
+            if (result == 0) {
+                error_Emit_FromISR(eError_Comm_Out_Param_Error);
+                break;
+            }
+            comm_Out_SendTask_QueueEmitWithBuild_FromISR(eProtocolEmitPack_Client_CMD_Debug_Profile, pInBuff, result);
+            break;
         case eProtocolEmitPack_Client_CMD_Debug_Correct:
             if (length == 8) {
                 gComm_Data_Correct_Flag_Mark();                   /* 标记进入定标状态 */
@@ -1290,6 +1330,46 @@ static void protocol_Parse_Out_Fun_ISR(uint8_t * pInBuff, uint16_t length)
                     motor_Emit_FromISR(&motor_fun);         /* 提交到任务队列 */
                 } else if (pInBuff[6] == 3) {               /* 读取杂散光 */
                     comm_Data_Conf_Offset_Get_FromISR();
+                } else if (pInBuff[6] == 4) { /* 读取PWM资源占用统计 */
+                    comm_Out_SendTask_QueueEmitWithBuild_FromISR(eProtocolEmitPack_Client_CMD_Debug_System, pInBuff, m_drv8824_Stat_Pack(pInBuff));
+                } else if (pInBuff[6] == 5) { /* 清零PWM资源占用统计 */
+                    m_drv8824_Stat_Clear();
+                } else if (pInBuff[6] == 6) { /* 读取托盘复归统计 */
+                    comm_Out_SendTask_QueueEmitWithBuild_FromISR(eProtocolEmitPack_Client_CMD_Debug_System, pInBuff, tray_Motor_Home_Stat_Pack(pInBuff));
+                } else if (pInBuff[6] == 7) { /* 读取L6470 SPI访问统计 */
+                    comm_Out_SendTask_QueueEmitWithBuild_FromISR(eProtocolEmitPack_Client_CMD_Debug_System, pInBuff, m_l6470_Stat_Pack(pInBuff));
+                } else if (pInBuff[6] == 8) { /* 清零L6470 SPI访问统计 */
+                    m_l6470_Stat_Clear();
+                } else if (pInBuff[6] == 9) { /* 读取采样节奏 */
+                    comm_Out_SendTask_QueueEmitWithBuild_FromISR(eProtocolEmitPack_Client_CMD_Debug_System, pInBuff, comm_Data_Sample_Cadence_Pack(pInBuff));
+                } else if (pInBuff[6] == 10) { /* 读取任务运行统计 定时器服务任务中上送 */
+                    sys_Stat_Task_Report_FromISR(eComm_Out);
+                } else if (pInBuff[6] == 11) { /* 读取中断统计 定时器服务任务中上送 */
+                    sys_Stat_IRQ_Report_FromISR(eComm_Out);
+                } else if (pInBuff[6] == 12) { /* 清零中断统计 */
+                    sys_Stat_IRQ_Clear();
+                } else if (pInBuff[6] == 13) { /* 读取资源余量 定时器服务任务中上送 */
+                    sys_Stat_Resource_Report_FromISR(eComm_Out);
+                } else if (pInBuff[6] == 15) { /* 读取休眠统计 */
+                    comm_Out_SendTask_QueueEmitWithBuild_FromISR(eProtocolEmitPack_Client_CMD_Debug_System, pInBuff, power_Stat_Pack(pInBuff));
+                } else if (pInBuff[6] == 16) { /* 清零休眠统计 */
+                    power_Stat_Clear();
+                } else if (pInBuff[6] == 17) { /* 读取故障上送统计 */
+                    comm_Out_SendTask_QueueEmitWithBuild_FromISR(eProtocolEmitPack_Client_CMD_Debug_System, pInBuff, error_Stat_Pack(pInBuff));
+                } else if (pInBuff[6] == 18) { /* 清零故障上送统计 */
+                    error_Stat_Clear();
+                } else if (pInBuff[6] == 19) { /* 读取时间轮统计 */
+                    comm_Out_SendTask_QueueEmitWithBuild_FromISR(eProtocolEmitPack_Client_CMD_Debug_System, pInBuff, time_Wheel_Stat_Pack(pInBuff));
+                } else if (pInBuff[6] == 20) { /* 清零时间轮统计 */
+                    time_Wheel_Stat_Clear();
+                } else if (pInBuff[6] == 21) { /* 读取启动统计 */
+                    comm_Out_SendTask_QueueEmitWithBuild_FromISR(eProtocolEmitPack_Client_CMD_Debug_System, pInBuff, boot_Stat_Pack(pInBuff));
+                }
+            } else if (length == 9 && pInBuff[6] == 14) { /* 设置资源余量上送周期 秒 0 为不上送 */
+                sys_Stat_Resource_Period_Set(pInBuff[7]);
+            } else if (length == 7 + COMM_DATA_CADENCE_PACK_LEN) {                /* 设置采样节奏 测试方法 + 参数 */
+                if (comm_Data_Sample_Cadence_Set(pInBuff[6], pInBuff + 7) != 0) { /* 参数非法 */
+                    error_Emit_FromISR(eError_Comm_Out_Param_Error);
                 }
             } else {
                 error_Emit_FromISR(eError_Comm_Out_Param_Error);
@@ -1646,6 +1726,46 @@ static void protocol_Parse_Main_Fun_ISR(uint8_t * pInBuff, uint16_t length)
                     motor_Emit_FromISR(&motor_fun);         /* 提交到任务队列 */
                 } else if (pInBuff[6] == 3) {               /* 读取杂散光 */
                     comm_Data_Conf_Offset_Get_FromISR();
+                } else if (pInBuff[6] == 4) { /* 读取PWM资源占用统计 */
+                    comm_Main_SendTask_QueueEmitWithBuild_FromISR(eProtocolEmitPack_Client_CMD_Debug_System, pInBuff, m_drv8824_Stat_Pack(pInBuff));
+                } else if (pInBuff[6] == 5) { /* 清零PWM资源占用统计 */
+                    m_drv8824_Stat_Clear();
+                } else if (pInBuff[6] == 6) { /* 读取托盘复归统计 */
+                    comm_Main_SendTask_QueueEmitWithBuild_FromISR(eProtocolEmitPack_Client_CMD_Debug_System, pInBuff, tray_Motor_Home_Stat_Pack(pInBuff));
+                } else if (pInBuff[6] == 7) { /* 读取L6470 SPI访问统计 */
+                    comm_Main_SendTask_QueueEmitWithBuild_FromISR(eProtocolEmitPack_Client_CMD_Debug_System, pInBuff, m_l6470_Stat_Pack(pInBuff));
+                } else if (pInBuff[6] == 8) { /* 清零L6470 SPI访问统计 */
+                    m_l6470_Stat_Clear();
+                } else if (pInBuff[6] == 9) { /* 读取采样节奏 */
+                    comm_Main_SendTask_QueueEmitWithBuild_FromISR(eProtocolEmitPack_Client_CMD_Debug_System, pInBuff, comm_Data_Sample_Cadence_Pack(pInBuff));
+                } else if (pInBuff[6] == 10) { /* 读取任务运行统计 定时器服务任务中上送 */
+                    sys_Stat_Task_Report_FromISR(eComm_Main);
+                } else if (pInBuff[6] == 11) { /* 读取中断统计 定时器服务任务中上送 */
+                    sys_Stat_IRQ_Report_FromISR(eComm_Main);
+                } else if (pInBuff[6] == 12) { /* 清零中断统计 */
+                    sys_Stat_IRQ_Clear();
+                } else if (pInBuff[6] == 13) { /* 读取资源余量 定时器服务任务中上送 */
+                    sys_Stat_Resource_Report_FromISR(eComm_Main);
+                } else if (pInBuff[6] == 15) { /* 读取休眠统计 */
+                    comm_Main_SendTask_QueueEmitWithBuild_FromISR(eProtocolEmitPack_Client_CMD_Debug_System, pInBuff, power_Stat_Pack(pInBuff));
+                } else if (pInBuff[6] == 16) { /* 清零休眠统计 */
+                    power_Stat_Clear();
+                } else if (pInBuff[6] == 17) { /* 读取故障上送统计 */
+                    comm_Main_SendTask_QueueEmitWithBuild_FromISR(eProtocolEmitPack_Client_CMD_Debug_System, pInBuff, error_Stat_Pack(pInBuff));
+                } else if (pInBuff[6] == 18) { /* 清零故障上送统计 */
+                    error_Stat_Clear();
+                } else if (pInBuff[6] == 19) { /* 读取时间轮统计 */
+                    comm_Main_SendTask_QueueEmitWithBuild_FromISR(eProtocolEmitPack_Client_CMD_Debug_System, pInBuff, time_Wheel_Stat_Pack(pInBuff));
+                } else if (pInBuff[6] == 20) { /* 清零时间轮统计 */
+                    time_Wheel_Stat_Clear();
+                } else if (pInBuff[6] == 21) { /* 读取启动统计 */
+                    comm_Main_SendTask_QueueEmitWithBuild_FromISR(eProtocolEmitPack_Client_CMD_Debug_System, pInBuff, boot_Stat_Pack(pInBuff));
+                }
+            } else if (length == 9 && pInBuff[6] == 14) { /* 设置资源余量上送周期 秒 0 为不上送 */
+                sys_Stat_Resource_Period_Set(pInBuff[7]);
+            } else if (length == 7 + COMM_DATA_CADENCE_PACK_LEN) {                /* 设置采样节奏 测试方法 + 参数 */
+                if (comm_Data_Sample_Cadence_Set(pInBuff[6], pInBuff + 7) != 0) { /* 参数非法 */
+                    error_Emit_FromISR(eError_Comm_Out_Param_Error);
                 }
             } else {
                 error_Emit_FromISR(eError_Comm_Out_Param_Error);
@@ -1698,7 +1818,11 @@ uint8_t protocol_Parse_Data_ISR(uint8_t * pInBuff, uint16_t length)
     }
     last_ack = pInBuff[3]; /* 记录上一帧号 */
 
-    protocol_Parse_Data_Fun_ISR(pInBuff, length);
+    if (length > COMM_DATA_SER_RX_SIZE) { /* 超出拼包缓存 */
+        return 0;
+    }
+    memcpy(gProtocol_Data_Parse_Buffer, pInBuff, length);           /* 入站帧位于 DMA 或拼包缓存 原地构造转发帧会越过帧尾 */
+    protocol_Parse_Data_Fun_ISR(gProtocol_Data_Parse_Buffer, length); /* 在解析缓存中处理 */
     return 0;
 }
 
@@ -32,14 +32,24 @@
 /* 延时函数定义 */
 #define SE2707_DELAY HAL_Delay /* use vTaskDelay cause HAL_BUSY*/
 
+/* 异步接收 */
+#define SE2707_PACK_MIN_LENGTH 4 /* 长度字节最小值 长度 命令字 来源 状态 */
+
 /* Private macro -------------------------------------------------------------*/
 
 /* Private variables ---------------------------------------------------------*/
+static sSE2707_Async gSE2707_Async = {0};                  /* 异步接收 */
+static SemaphoreHandle_t se2707_Async_Pack_Sem = NULL;     /* 异步接收 收到完整报文 */
+static StaticSemaphore_t se2707_Async_Pack_Sem_Buffer;     /* 异步接收 信号量静态内存 */
+static uint8_t gSE2707_Async_Pack[SE2707_PACK_MAX_LENGTH]; /* 异步接收 最近一个完整报文 */
+static uint16_t gSE2707_Async_Pack_Length = 0;             /* 异步接收 最近一个完整报文长度 */
 
 /* Private constants ---------------------------------------------------------*/
 const uint8_t cSe2707_ACK_PACK[] = {0x04, 0xD0, 0x00, 0x00, 0xFF, 0x2C};
 
 /* Private function prototypes -----------------------------------------------*/
+static void se2707_async_pack_FromISR(uint8_t * pPack, uint16_t length);
+static void se2707_async_feed_FromISR(uint16_t pos);
 
 /* Private user code ---------------------------------------------------------*/
 
@@ -89,6 +99,110 @@ uint8_t se2707_checksum_check(uint8_t * pData, uint16_t length)
     return 1;
 }
 
+/**
+ * @brief  se2707 ssi 报文解析 复位
+ * @param  pParser 解析器
+ * @retval None
+ */
+void se2707_parser_reset(sSE2707_Parser * pParser)
+{
+    pParser->index = 0;
+}
+
+/**
+ * @brief  se2707 ssi 报文解析 丢弃缓存头部
+ * @param  pParser 解析器
+ * @param  length 丢弃长度
+ * @retval None
+ */
+static void se2707_parser_drop(sSE2707_Parser * pParser, uint16_t length)
+{
+    if (length >= pParser->index) {
+        pParser->index = 0;
+        return;
+    }
+    pParser->index -= length;
+    memmove(pParser->buffer, pParser->buffer + length, pParser->index);
+}
+
+/**
+ * @brief  se2707 ssi 报文解析 处理缓存内容
+ * @param  pParser 解析器
+ * @param  pfCallback 收到完整且校验正确的报文时回调 可为 NULL
+ * @retval 得到的完整报文数目
+ */
+static uint16_t se2707_parser_scan(sSE2707_Parser * pParser, pfSE2707_Pack_Callback pfCallback)
+{
+    uint16_t pack_length, cnt = 0;
+
+    while (pParser->index > 0) {
+        if (pParser->buffer[0] < SE2707_PACK_MIN_LENGTH) { /* 长度字节异常 */
+            se2707_parser_drop(pParser, 1);
+            continue;
+        }
+        pack_length = pParser->buffer[0] + 2;
+        if (pParser->index < pack_length) { /* 报文未完整 */
+            break;
+        }
+        if (se2707_checksum_check(pParser->buffer, pack_length) != 0) { /* 校验失败 重新同步 */
+            se2707_parser_drop(pParser, 1);
+            continue;
+        }
+        if (pfCallback != NULL) {
+            pfCallback(pParser->buffer, pack_length);
+        }
+        ++cnt;
+        se2707_parser_drop(pParser, pack_length);
+    }
+    return cnt;
+}
+
+/**
+ * @brief  se2707 ssi 报文解析 输入数据
+ * @note   数据可任意分段输入 报文格式 长度 命令字 来源 状态 负载 校验码高字节 校验码低字节
+ *         长度字节不含校验码 校验失败时丢弃首字节后在缓存内重新同步
+ * @param  pParser 解析器
+ * @param  pData length 数组描述
+ * @param  pfCallback 收到完整且校验正确的报文时回调 可为 NULL
+ * @retval 本次输入中得到的完整报文数目
+ */
+uint16_t se2707_parser_feed(sSE2707_Parser * pParser, uint8_t const * pData, uint16_t length, pfSE2707_Pack_Callback pfCallback)
+{
+    uint16_t cnt = 0;
+
+    while (length-- > 0) {
+        pParser->buffer[pParser->index++] = *pData++;
+        cnt += se2707_parser_scan(pParser, pfCallback);
+    }
+    return cnt;
+}
+
+/**
+ * @brief  se2707 ssi 报文解析 线路空闲
+ * @note   缓存头部为干扰字节时 其长度字节可能使解析器等待永远不会到来的数据
+ *         线路空闲时在缓存内查找完整且校验正确的报文 找到则丢弃之前的内容 否则保留等待后续数据
+ * @param  pParser 解析器
+ * @param  pfCallback 收到完整且校验正确的报文时回调 可为 NULL
+ * @retval 得到的完整报文数目
+ */
+uint16_t se2707_parser_idle(sSE2707_Parser * pParser, pfSE2707_Pack_Callback pfCallback)
+{
+    uint16_t offset, pack_length, cnt = 0;
+
+    for (offset = 1; offset < pParser->index; ++offset) {
+        pack_length = pParser->buffer[offset] + 2;
+        if (pParser->buffer[offset] < SE2707_PACK_MIN_LENGTH || offset + pack_length > pParser->index) {
+            continue;
+        }
+        if (se2707_checksum_check(pParser->buffer + offset, pack_length) == 0) {
+            se2707_parser_drop(pParser, offset);
+            cnt += se2707_parser_scan(pParser, pfCallback);
+            offset = 0; /* 剩余部分重新查找 */
+        }
+    }
+    return cnt;
+}
+
 /**
  * @brief  se2707 ssi 协议组包
  * @param  cmd 命令字 eSE2707_CMD
@@ -199,10 +313,17 @@ uint16_t se2707_send_pack(UART_HandleTypeDef * puart, uint8_t * pData, uint16_t
 {
     uint8_t nn[2] = {0};
 
+    if (gSE2707_Async.puart == puart) { /* 异步接收中 丢弃之前的应答 */
+        xSemaphoreTake(se2707_Async_Pack_Sem, 0);
+    }
     if (HAL_UART_Transmit(puart, nn, 2, 10) != HAL_OK) {
         return 1;
     }
-    SE2707_DELAY(50);
+    if (gSE2707_Async.puart == puart) {
+        vTaskDelay(pdMS_TO_TICKS(50));
+    } else {
+        SE2707_DELAY(50);
+    }
 
     if (HAL_UART_Transmit(puart, pData, length, 10) != HAL_OK) {
         return 1;
@@ -220,6 +341,13 @@ void se2707_clear_recv(UART_HandleTypeDef * puart)
     uint8_t buffer;
     HAL_StatusTypeDef status = HAL_OK;
 
+    if (gSE2707_Async.puart == puart) { /* 异步接收中 清空解析缓存及未取走的报文 */
+        taskENTER_CRITICAL();
+        se2707_parser_reset(&gSE2707_Async.parser);
+        taskEXIT_CRITICAL();
+        xSemaphoreTake(se2707_Async_Pack_Sem, 0);
+        return;
+    }
     __HAL_UART_FLUSH_DRREGISTER(puart);
     while (status != HAL_OK) {
         status = HAL_UART_Receive(puart, &buffer, 1, 50);
@@ -227,7 +355,8 @@ void se2707_clear_recv(UART_HandleTypeDef * puart)
 }
 
 /**
- * @brief  se2707 ssi 发送操作
+ * @brief  se2707 ssi 接收操作
+ * @note   异步接收中 等待完整且校验正确的报文 收到即返回 不必等待超时
  * @param  puart 串口句柄指针
  * @param  pData length 数组描述
  * @param  timeout 接收超时时间
@@ -238,6 +367,17 @@ uint16_t se2707_recv_pack(UART_HandleTypeDef * puart, uint8_t * pData, uint16_t
     HAL_StatusTypeDef status;
     uint16_t recv_length;
 
+    if (gSE2707_Async.puart == puart) {
+        if (xSemaphoreTake(se2707_Async_Pack_Sem, pdMS_TO_TICKS(timeout)) != pdPASS) {
+            return 0;
+        }
+        taskENTER_CRITICAL();
+        recv_length = (gSE2707_Async_Pack_Length < length) ? (gSE2707_Async_Pack_Length) : (length);
+        memcpy(pData, gSE2707_Async_Pack, recv_length);
+        taskEXIT_CRITICAL();
+        return recv_length;
+    }
+
     status = HAL_UART_Receive(puart, pData, length, timeout);
 
     recv_length = length - puart->RxXferCount;
@@ -416,3 +556,144 @@ uint8_t se2707_send_cmd(UART_HandleTypeDef * puart, eSE2707_CMD cmd, uint8_t * p
     } while (--retry > 0);
     return result;
 }
+
+/**
+ * @brief  se2707 异步接收 收到完整报文 中断内调用
+ * @param  pPack length 报文描述
+ * @retval None
+ */
+static void se2707_async_pack_FromISR(uint8_t * pPack, uint16_t length)
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    memcpy(gSE2707_Async_Pack, pPack, length);
+    gSE2707_Async_Pack_Length = length;
+    if (gSE2707_Async.pfCallback != NULL) {
+        gSE2707_Async.pfCallback(pPack, length);
+    }
+    xSemaphoreGiveFromISR(se2707_Async_Pack_Sem, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+/**
+ * @brief  se2707 异步接收 解析DMA缓存中新收到的数据
+ * @param  pos DMA缓存当前写入位置
+ * @retval None
+ */
+static void se2707_async_feed_FromISR(uint16_t pos)
+{
+    if (pos > gSE2707_Async.rx_index && pos <= SE2707_RX_BUFFER_LENGTH) {
+        se2707_parser_feed(&gSE2707_Async.parser, &gSE2707_Async.rx_buffer[gSE2707_Async.rx_index], pos - gSE2707_Async.rx_index,
+                           se2707_async_pack_FromISR);
+        gSE2707_Async.rx_index = pos;
+    }
+}
+
+/**
+ * @brief  se2707 异步接收 启动
+ * @note   DMA非循环模式接收 空闲中断及接收满时解析 收到完整报文后释放信号量并回调
+ *         启动后 se2707_recv_pack 等 阻塞接口改为等待信号量 不再轮询串口
+ * @param  puart 串口句柄指针
+ * @param  pfCallback 收到完整报文回调 中断内调用 可为 NULL
+ * @retval 0 启动成功 1 启动失败
+ */
+uint8_t se2707_async_start(UART_HandleTypeDef * puart, pfSE2707_Pack_Callback pfCallback)
+{
+    if (se2707_Async_Pack_Sem == NULL) {
+        se2707_Async_Pack_Sem = xSemaphoreCreateBinaryStatic(&se2707_Async_Pack_Sem_Buffer);
+        if (se2707_Async_Pack_Sem == NULL) {
+            return 1;
+        }
+    }
+    se2707_async_stop();
+    HAL_UART_AbortReceive(puart);
+    __HAL_UART_CLEAR_OREFLAG(puart); /* 清理残余内容 同时清除空闲标志 */
+    xSemaphoreTake(se2707_Async_Pack_Sem, 0);
+
+    se2707_parser_reset(&gSE2707_Async.parser);
+    gSE2707_Async.rx_index = 0;
+    gSE2707_Async.pfCallback = pfCallback;
+    if (HAL_UART_Receive_DMA(puart, gSE2707_Async.rx_buffer, SE2707_RX_BUFFER_LENGTH) != HAL_OK) {
+        return 1;
+    }
+    gSE2707_Async.puart = puart;
+    __HAL_UART_ENABLE_IT(puart, UART_IT_IDLE);
+    return 0;
+}
+
+/**
+ * @brief  se2707 异步接收 停止
+ * @param  None
+ * @retval None
+ */
+void se2707_async_stop(void)
+{
+    UART_HandleTypeDef * puart = gSE2707_Async.puart;
+
+    if (puart == NULL) {
+        return;
+    }
+    gSE2707_Async.puart = NULL;
+    __HAL_UART_DISABLE_IT(puart, UART_IT_IDLE);
+    HAL_UART_AbortReceive(puart);
+}
+
+/**
+ * @brief  se2707 异步接收 是否启动
+ * @param  puart 串口句柄指针
+ * @retval 0 未启动 1 已启动
+ */
+uint8_t se2707_async_is_active(UART_HandleTypeDef * puart)
+{
+    return gSE2707_Async.puart == puart;
+}
+
+/**
+ * @brief  se2707 异步接收 空闲中断回调
+ * @param  None
+ * @retval None
+ */
+void se2707_async_rx_idle_FromISR(void)
+{
+    if (gSE2707_Async.puart == NULL) {
+        return;
+    }
+    se2707_async_feed_FromISR(SE2707_RX_BUFFER_LENGTH - __HAL_DMA_GET_COUNTER(gSE2707_Async.puart->hdmarx));
+    se2707_parser_idle(&gSE2707_Async.parser, se2707_async_pack_FromISR);
+}
+
+/**
+ * @brief  se2707 异步接收 DMA接收完成中断回调
+ * @note   非循环模式 解析剩余数据后重新启动接收 RxState 此时已回到 READY
+ * @param  None
+ * @retval None
+ */
+void se2707_async_rx_cplt_FromISR(void)
+{
+    if (gSE2707_Async.puart == NULL) {
+        return;
+    }
+    se2707_async_feed_FromISR(SE2707_RX_BUFFER_LENGTH);
+    gSE2707_Async.rx_index = 0;
+    if (HAL_UART_Receive_DMA(gSE2707_Async.puart, gSE2707_Async.rx_buffer, SE2707_RX_BUFFER_LENGTH) != HAL_OK) {
+        gSE2707_Async.puart = NULL; /* 无法恢复 阻塞接口等待超时 */
+    }
+}
+
+/**
+ * @brief  se2707 异步接收 串口异常回调
+ * @note   DMA模式下串口异常时HAL已中止接收 丢弃半包后重新启动接收
+ * @param  None
+ * @retval None
+ */
+void se2707_async_rx_error_FromISR(void)
+{
+    if (gSE2707_Async.puart == NULL) {
+        return;
+    }
+    se2707_parser_reset(&gSE2707_Async.parser);
+    gSE2707_Async.rx_index = 0;
+    if (HAL_UART_Receive_DMA(gSE2707_Async.puart, gSE2707_Async.rx_buffer, SE2707_RX_BUFFER_LENGTH) != HAL_OK) {
+        gSE2707_Async.puart = NULL;
+    }
+}
@@ -10,6 +10,7 @@
 #include "comm_out.h"
 #include "comm_main.h"
 #include "comm_data.h"
+#include "barcode_scan.h"
 
 /* Extern variables ----------------------------------------------------------*/
 extern UART_HandleTypeDef huart5; /* 外串口 */
@@ -22,6 +23,7 @@ extern UART_HandleTypeDef huart2; /* 采样板 */
 
 /* Private variables ---------------------------------------------------------*/
 static EventGroupHandle_t serial_source_flags = NULL; /* 串口资源标志 */
+static StaticEventGroup_t serial_source_flags_Buffer; /* 串口资源标志 静态内存 */
 
 /* Private constants ---------------------------------------------------------*/
 
@@ -36,7 +38,7 @@ static EventGroupHandle_t serial_source_flags = NULL; /* 串口资源标志 */
  */
 void SerialInit(void)
 {
-    serial_source_flags = xEventGroupCreate();
+    serial_source_flags = xEventGroupCreateStatic(&serial_source_flags_Buffer);
     if (serial_source_flags == NULL) {
         FL_Error_Handler(__FILE__, __LINE__);
         return;
@@ -173,18 +175,19 @@ void serialGenerateCallback(uint8_t * pBuff, uint16_t length, sSerialRecord * ps
     uint8_t first_head;
     uint16_t i, pos = 0, tail = 0, j;
 
-    first_head = psrd->has_head(pBuff, length);   /* 判断是否有包头 */
-    if (first_head) {                             /* 有包头 */
-        tail = psrd->has_tail(pBuff, length);     /* 找到包头后 寻找包尾 */
-        if (tail && psrd->is_cmop(pBuff, tail)) { /* 完整性判断 */
-            psrd->callback(pBuff, tail);          /* 直接中断内处理 */
-            length -= tail;                       /* 更新待处理长度 */
-            if (length == 0) {                    /* 仅此一包 */
-                return;                           /* 提前结束 */
-            }                                     /* 处理剩余部分 */
-            for (i = 0; i < length; ++i) {        /* 平移未处理部分至头部 */
+    first_head = psrd->has_head(pBuff, length);         /* 判断是否有包头 */
+    if (first_head) {                                   /* 有包头 */
+        tail = psrd->has_tail(pBuff, length);           /* 找到包头后 寻找包尾 */
+        if (tail && psrd->is_cmop(pBuff, tail)) {       /* 完整性判断 */
+            psrd->callback(pBuff, tail);                /* 直接中断内处理 */
+            length -= tail;                             /* 更新待处理长度 */
+            if (length == 0) {                          /* 仅此一包 */
+                return;                                 /* 提前结束 */
+            }                                           /* 处理剩余部分 */
+            for (i = 0; i < length; ++i) {              /* 平移未处理部分至头部 */
                 pBuff[i] = pBuff[i + tail];
             }
+            first_head = psrd->has_head(pBuff, length); /* 剩余部分起始 重新判断包头 */
         }
     }
 
@@ -236,17 +239,13 @@ void serialGenerateCallback(uint8_t * pBuff, uint16_t length, sSerialRecord * ps
             pos = i; /* 记录处理位置  */
         }
     }
-    if (pos > 0) {                                 /* 残余数据处理 */
-        psrd->validLength -= pos;                  /* 更新未处理数据长度 */
-        if (psrd->validLength < psrd->minLength) { /* 报文长度不足 */
-            return;
+    if (pos > 0) { /* 残余数据处理 */
+        while (pos < psrd->validLength && psrd->has_head(&psrd->pSerialBuff[pos], psrd->validLength - pos) == 0) {
+            ++pos; /* 跳过非包头数据 末尾不足最小长度的不完整包 需保留 */
         }
-        if (psrd->has_head(&psrd->pSerialBuff[pos], psrd->validLength)) { /* 残余数据起始为包头 */
-            for (j = 0; j < psrd->validLength; ++j) {
-                psrd->pSerialBuff[j] = psrd->pSerialBuff[j + pos];
-            }
-        } else {
-            psrd->validLength = 0; /* 拼包缓存中待处理长度清零 */
+        psrd->validLength -= pos; /* 更新未处理数据长度 */
+        for (j = 0; j < psrd->validLength; ++j) {
+            psrd->pSerialBuff[j] = psrd->pSerialBuff[j + pos];
         }
     }
     return;
@@ -279,7 +278,14 @@ void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef * huart)
  */
 void HAL_UART_RxCpltCallback(UART_HandleTypeDef * huart)
 {
-    HAL_UART_RxHalfCpltCallback(huart);
+    switch ((uint32_t)(huart->Instance)) {
+        case (uint32_t)USART3: /* 扫码串口 非循环模式 */
+            barcode_Serial_RX_Cplt_FromISR();
+            break;
+        default:
+            HAL_UART_RxHalfCpltCallback(huart);
+            break;
+    }
 }
 
 /**
@@ -365,6 +371,14 @@ void HAL_UART_ErrorCallback(UART_HandleTypeDef * huart)
             comm_Out_DMA_TX_Error_From_ISR();
             comm_Out_DMA_RX_Restore();
             break;
+        case (uint32_t)USART3:
+            error_code = HAL_UART_GetError(huart);
+            error_Emit_FromISR(eError_Scan_UART);
+            if (error_code != HAL_UART_ERROR_NONE) {
+                error_Emit_FromISR((error_code << 10) | eError_Scan_UART);
+            }
+            barcode_Serial_RX_Error_FromISR();
+            break;
     }
 }
 
@@ -13,6 +13,8 @@
 #include "beep.h"
 #include "temperature.h"
 #include "i2c_eeprom.h"
+#include "power.h"
+#include "boot.h"
 
 /* Extern variables ----------------------------------------------------------*/
 extern TIM_HandleTypeDef htim4;
@@ -29,6 +31,8 @@ extern TIM_HandleTypeDef htim4;
 
 /* Private variables ---------------------------------------------------------*/
 TimerHandle_t gTimerHandleHeater = NULL;
+static StaticTimer_t gTimerHeater_Buffer;
+static uint8_t gSoft_Timer_Heater_Started = 0; /* 加热输出已启动 */
 
 /* Private constants ---------------------------------------------------------*/
 
@@ -36,6 +40,28 @@ TimerHandle_t gTimerHandleHeater = NULL;
 
 /* Private user code ---------------------------------------------------------*/
 
+/**
+ * @brief  软定时器 加热输出启动
+ * @note   参数加载与温度ADC首次转换完成后 初始化过冲参数并启动加热输出 不等待电机复位
+ * @note   此前收到的加热失能命令保持有效
+ * @param  None
+ * @retval 1 已启动 0 未就绪
+ */
+static uint8_t soft_timer_Heater_Start(void)
+{
+    if (gSoft_Timer_Heater_Started) {
+        return 1;
+    }
+    if (boot_Is_Ready(BOOT_BIT_PARAM | BOOT_BIT_TEMP) == 0) { /* 温度校正参数或温度值无效 */
+        return 0;
+    }
+    heater_Overshoot_Init(0); /* 初始化过冲参数 */
+    heater_Output_Release();  /* 按已记录的使能请求启动加热输出 */
+    gSoft_Timer_Heater_Started = 1;
+    boot_Mark(BOOT_BIT_HEATER);
+    return 1;
+}
+
 /**
  * @brief  软定时器回调 加热控制
  * @param  定时器任务句柄
@@ -46,13 +72,19 @@ void soft_timer_Heater_Call_Back(TimerHandle_t xTimer)
     static uint32_t cnt = 0;
     float env_temp;
 
+    power_Heater_Trace(); /* 回调间隔 无节拍空闲验证 */
     ++cnt;
-    heater_Overshoot_Handle();        /* 过冲控制 */
-    heater_BTM_Output_Keep_Deal();    /* 下加热体PID控制 */
-    heater_TOP_Output_Keep_Deal();    /* 上加热体PID控制 */
+    if (soft_timer_Heater_Start()) {
+        heater_Overshoot_Handle();     /* 过冲控制 */
+        heater_BTM_Output_Keep_Deal(); /* 下加热体PID控制 */
+        heater_TOP_Output_Keep_Deal(); /* 上加热体PID控制 */
+    }
     motor_OPT_Status_Update();        /* 电机光耦位置状态更新 */
     I2C_EEPROM_Card_Status_Update();  /* ID Code 卡插入状态更新 */
     beep_Deal(SOFT_TIMER_HEATER_PER); /* 蜂鸣器处处理 */
+    if (cnt % (pdMS_TO_TICKS(100) / SOFT_TIMER_HEATER_PER) == 0) { /* 每100毫秒处理一次故障上送限流窗口 */
+        error_Rate_Deal();
+    }
 
     if (cnt % (pdMS_TO_TICKS(6 * 1000) / SOFT_TIMER_HEATER_PER) == 0) { /* 每6秒修正一次PID控制参数 */
         env_temp = temp_Get_Temp_Data_ENV();
@@ -70,7 +102,7 @@ void soft_timer_Heater_Call_Back(TimerHandle_t xTimer)
  */
 void soft_timer_Heater_Init(void)
 {
-    gTimerHandleHeater = xTimerCreate("Heater Timer", SOFT_TIMER_HEATER_PER, pdTRUE, (void *)0, soft_timer_Heater_Call_Back);
+    gTimerHandleHeater = xTimerCreateStatic("Heater Timer", SOFT_TIMER_HEATER_PER, pdTRUE, (void *)0, soft_timer_Heater_Call_Back, &gTimerHeater_Buffer);
     if (gTimerHandleHeater == NULL) {
         Error_Handler();
     }
@@ -78,11 +110,8 @@ void soft_timer_Heater_Init(void)
     motor_OPT_Status_Init(); /* 电机光耦检测初始化 */
     beep_Init();             /* 蜂鸣器初始化 */
 
-    heater_BTM_Output_Init();
-    heater_BTM_Output_Start();
-
+    heater_BTM_Output_Init(); /* 输出在回调中 参数与温度就绪后启动 */
     heater_TOP_Output_Init();
-    heater_TOP_Output_Start();
 
     xTimerStart(gTimerHandleHeater, portMAX_DELAY);
 }
@@ -40,6 +40,8 @@ extern DMA_HandleTypeDef hdma_usart2_rx;
 
 extern DMA_HandleTypeDef hdma_usart2_tx;
 
+extern DMA_HandleTypeDef hdma_usart3_rx;
+
 /* Private typedef -----------------------------------------------------------*/
 /* USER CODE BEGIN TD */
 
@@ -1000,6 +1002,27 @@ void HAL_UART_MspInit(UART_HandleTypeDef * huart)
         GPIO_InitStruct.Alternate = GPIO_AF7_USART3;
         HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
 
+        /* USART3 DMA Init */
+        /* USART3_RX Init */
+        hdma_usart3_rx.Instance = DMA1_Stream1;
+        hdma_usart3_rx.Init.Channel = DMA_CHANNEL_4;
+        hdma_usart3_rx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+        hdma_usart3_rx.Init.PeriphInc = DMA_PINC_DISABLE;
+        hdma_usart3_rx.Init.MemInc = DMA_MINC_ENABLE;
+        hdma_usart3_rx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+        hdma_usart3_rx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+        hdma_usart3_rx.Init.Mode = DMA_NORMAL;
+        hdma_usart3_rx.Init.Priority = DMA_PRIORITY_LOW;
+        hdma_usart3_rx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+        if (HAL_DMA_Init(&hdma_usart3_rx) != HAL_OK) {
+            Error_Handler();
+        }
+
+        __HAL_LINKDMA(huart, hdmarx, hdma_usart3_rx);
+
+        /* USART3 interrupt Init */
+        HAL_NVIC_SetPriority(USART3_IRQn, 5, 0);
+        HAL_NVIC_EnableIRQ(USART3_IRQn);
         /* USER CODE BEGIN USART3_MspInit 1 */
 
         /* USER CODE END USART3_MspInit 1 */
@@ -1095,6 +1118,11 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef * huart)
         */
         HAL_GPIO_DeInit(GPIOB, BC_RXD_Pin | BC_TXD_Pin);
 
+        /* USART3 DMA DeInit */
+        HAL_DMA_DeInit(huart->hdmarx);
+
+        /* USART3 interrupt DeInit */
+        HAL_NVIC_DisableIRQ(USART3_IRQn);
         /* USER CODE BEGIN USART3_MspDeInit 1 */
 
         /* USER CODE END USART3_MspDeInit 1 */
@@ -30,6 +30,10 @@
 #include "comm_main.h"
 #include "m_drv8824.h"
 #include "tray_run.h"
+#include "heat_motor.h"
+#include "barcode_scan.h"
+#include "sys_stat.h"
+#include "power.h"
 
 /* USER CODE END Includes */
 
@@ -77,9 +81,11 @@ extern DMA_HandleTypeDef hdma_usart1_rx;
 extern DMA_HandleTypeDef hdma_usart1_tx;
 extern DMA_HandleTypeDef hdma_usart2_rx;
 extern DMA_HandleTypeDef hdma_usart2_tx;
+extern DMA_HandleTypeDef hdma_usart3_rx;
 extern UART_HandleTypeDef huart5;
 extern UART_HandleTypeDef huart1;
 extern UART_HandleTypeDef huart2;
+extern UART_HandleTypeDef huart3;
 extern TIM_HandleTypeDef htim14;
 
 /* USER CODE BEGIN EV */
@@ -185,25 +191,42 @@ void DebugMon_Handler(void)
 void EXTI2_IRQHandler(void)
 {
     /* USER CODE BEGIN EXTI2_IRQn 0 */
+    SYS_STAT_IRQ_ENTER(eSys_Stat_IRQ_EXTI2);
     tray_Motor_ISR_Deal();
     /* USER CODE END EXTI2_IRQn 0 */
     HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_2);
     /* USER CODE BEGIN EXTI2_IRQn 1 */
-
+    SYS_STAT_IRQ_EXIT(eSys_Stat_IRQ_EXTI2);
     /* USER CODE END EXTI2_IRQn 1 */
 }
 
+/**
+ * @brief This function handles EXTI line3 interrupt.
+ */
+void EXTI3_IRQHandler(void)
+{
+    /* USER CODE BEGIN EXTI3_IRQn 0 */
+    SYS_STAT_IRQ_ENTER(eSys_Stat_IRQ_EXTI3);
+    heat_Motor_OPT_ISR_Deal();
+    /* USER CODE END EXTI3_IRQn 0 */
+    HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_3);
+    /* USER CODE BEGIN EXTI3_IRQn 1 */
+    SYS_STAT_IRQ_EXIT(eSys_Stat_IRQ_EXTI3);
+    /* USER CODE END EXTI3_IRQn 1 */
+}
+
 /**
  * @brief This function handles EXTI line4 interrupt.
  */
 void EXTI4_IRQHandler(void)
 {
     /* USER CODE BEGIN EXTI4_IRQn 0 */
+    SYS_STAT_IRQ_ENTER(eSys_Stat_IRQ_EXTI4);
     comm_Data_ISR_Deal();
     /* USER CODE END EXTI4_IRQn 0 */
     HAL_GPIO_EXTI_IRQHandler(GPIO_PIN_4);
     /* USER CODE BEGIN EXTI4_IRQn 1 */
-
+    SYS_STAT_IRQ_EXIT(eSys_Stat_IRQ_EXTI4);
     /* USER CODE END EXTI4_IRQn 1 */
 }
 
@@ -213,25 +236,39 @@ void EXTI4_IRQHandler(void)
 void DMA1_Stream0_IRQHandler(void)
 {
     /* USER CODE BEGIN DMA1_Stream0_IRQn 0 */
-
+    SYS_STAT_IRQ_ENTER(eSys_Stat_IRQ_DMA1_Stream0);
     /* USER CODE END DMA1_Stream0_IRQn 0 */
     HAL_DMA_IRQHandler(&hdma_uart5_rx);
     /* USER CODE BEGIN DMA1_Stream0_IRQn 1 */
-
+    SYS_STAT_IRQ_EXIT(eSys_Stat_IRQ_DMA1_Stream0);
     /* USER CODE END DMA1_Stream0_IRQn 1 */
 }
 
+/**
+ * @brief This function handles DMA1 stream1 global interrupt.
+ */
+void DMA1_Stream1_IRQHandler(void)
+{
+    /* USER CODE BEGIN DMA1_Stream1_IRQn 0 */
+    SYS_STAT_IRQ_ENTER(eSys_Stat_IRQ_DMA1_Stream1);
+    /* USER CODE END DMA1_Stream1_IRQn 0 */
+    HAL_DMA_IRQHandler(&hdma_usart3_rx);
+    /* USER CODE BEGIN DMA1_Stream1_IRQn 1 */
+    SYS_STAT_IRQ_EXIT(eSys_Stat_IRQ_DMA1_Stream1);
+    /* USER CODE END DMA1_Stream1_IRQn 1 */
+}
+
 /**
  * @brief This function handles DMA1 stream5 global interrupt.
  */
 void DMA1_Stream5_IRQHandler(void)
 {
     /* USER CODE BEGIN DMA1_Stream5_IRQn 0 */
-
+    SYS_STAT_IRQ_ENTER(eSys_Stat_IRQ_DMA1_Stream5);
     /* USER CODE END DMA1_Stream5_IRQn 0 */
     HAL_DMA_IRQHandler(&hdma_usart2_rx);
     /* USER CODE BEGIN DMA1_Stream5_IRQn 1 */
-
+    SYS_STAT_IRQ_EXIT(eSys_Stat_IRQ_DMA1_Stream5);
     /* USER CODE END DMA1_Stream5_IRQn 1 */
 }
 
@@ -241,11 +278,11 @@ void DMA1_Stream5_IRQHandler(void)
 void DMA1_Stream6_IRQHandler(void)
 {
     /* USER CODE BEGIN DMA1_Stream6_IRQn 0 */
-
+    SYS_STAT_IRQ_ENTER(eSys_Stat_IRQ_DMA1_Stream6);
     /* USER CODE END DMA1_Stream6_IRQn 0 */
     HAL_DMA_IRQHandler(&hdma_usart2_tx);
     /* USER CODE BEGIN DMA1_Stream6_IRQn 1 */
-
+    SYS_STAT_IRQ_EXIT(eSys_Stat_IRQ_DMA1_Stream6);
     /* USER CODE END DMA1_Stream6_IRQn 1 */
 }
 
@@ -255,12 +292,12 @@ void DMA1_Stream6_IRQHandler(void)
 void TIM1_UP_TIM10_IRQHandler(void)
 {
     /* USER CODE BEGIN TIM1_UP_TIM10_IRQn 0 */
-
+    SYS_STAT_IRQ_ENTER(eSys_Stat_IRQ_TIM1_UP_TIM10);
     /* USER CODE END TIM1_UP_TIM10_IRQn 0 */
     HAL_TIM_IRQHandler(&htim1);
     HAL_TIM_IRQHandler(&htim10);
     /* USER CODE BEGIN TIM1_UP_TIM10_IRQn 1 */
-
+    SYS_STAT_IRQ_EXIT(eSys_Stat_IRQ_TIM1_UP_TIM10);
     /* USER CODE END TIM1_UP_TIM10_IRQn 1 */
 }
 
@@ -270,6 +307,7 @@ void TIM1_UP_TIM10_IRQHandler(void)
 void USART1_IRQHandler(void)
 {
     /* USER CODE BEGIN USART1_IRQn 0 */
+    SYS_STAT_IRQ_ENTER(eSys_Stat_IRQ_USART1);
     if (__HAL_UART_GET_FLAG(&huart1, UART_FLAG_IDLE)) {
         __HAL_UART_CLEAR_IDLEFLAG(&huart1);
         comm_Main_IRQ_RX_Deal(&huart1);
@@ -277,7 +315,7 @@ void USART1_IRQHandler(void)
     /* USER CODE END USART1_IRQn 0 */
     HAL_UART_IRQHandler(&huart1);
     /* USER CODE BEGIN USART1_IRQn 1 */
-
+    SYS_STAT_IRQ_EXIT(eSys_Stat_IRQ_USART1);
     /* USER CODE END USART1_IRQn 1 */
 }
 
@@ -287,6 +325,7 @@ void USART1_IRQHandler(void)
 void USART2_IRQHandler(void)
 {
     /* USER CODE BEGIN USART2_IRQn 0 */
+    SYS_STAT_IRQ_ENTER(eSys_Stat_IRQ_USART2);
     if (__HAL_UART_GET_FLAG(&huart2, UART_FLAG_IDLE)) {
         __HAL_UART_CLEAR_IDLEFLAG(&huart2);
         comm_Data_IRQ_RX_Deal(&huart2);
@@ -294,22 +333,40 @@ void USART2_IRQHandler(void)
     /* USER CODE END USART2_IRQn 0 */
     HAL_UART_IRQHandler(&huart2);
     /* USER CODE BEGIN USART2_IRQn 1 */
-
+    SYS_STAT_IRQ_EXIT(eSys_Stat_IRQ_USART2);
     /* USER CODE END USART2_IRQn 1 */
 }
 
+/**
+ * @brief This function handles USART3 global interrupt.
+ */
+void USART3_IRQHandler(void)
+{
+    /* USER CODE BEGIN USART3_IRQn 0 */
+    SYS_STAT_IRQ_ENTER(eSys_Stat_IRQ_USART3);
+    if (__HAL_UART_GET_IT_SOURCE(&huart3, UART_IT_IDLE) && __HAL_UART_GET_FLAG(&huart3, UART_FLAG_IDLE)) {
+        __HAL_UART_CLEAR_IDLEFLAG(&huart3);
+        barcode_Serial_IRQ_RX_Deal();
+    }
+    /* USER CODE END USART3_IRQn 0 */
+    HAL_UART_IRQHandler(&huart3);
+    /* USER CODE BEGIN USART3_IRQn 1 */
+    SYS_STAT_IRQ_EXIT(eSys_Stat_IRQ_USART3);
+    /* USER CODE END USART3_IRQn 1 */
+}
+
 /**
  * @brief This function handles TIM8 trigger and commutation interrupts and TIM14 global interrupt.
  */
 void TIM8_TRG_COM_TIM14_IRQHandler(void)
 {
     /* USER CODE BEGIN TIM8_TRG_COM_TIM14_IRQn 0 */
-
+    SYS_STAT_IRQ_ENTER(eSys_Stat_IRQ_TIM8_TRG_COM_TIM14);
     /* USER CODE END TIM8_TRG_COM_TIM14_IRQn 0 */
     HAL_TIM_IRQHandler(&htim8);
     HAL_TIM_IRQHandler(&htim14);
     /* USER CODE BEGIN TIM8_TRG_COM_TIM14_IRQn 1 */
-
+    SYS_STAT_IRQ_EXIT(eSys_Stat_IRQ_TIM8_TRG_COM_TIM14);
     /* USER CODE END TIM8_TRG_COM_TIM14_IRQn 1 */
 }
 
@@ -319,11 +376,11 @@ void TIM8_TRG_COM_TIM14_IRQHandler(void)
 void DMA1_Stream7_IRQHandler(void)
 {
     /* USER CODE BEGIN DMA1_Stream7_IRQn 0 */
-
+    SYS_STAT_IRQ_ENTER(eSys_Stat_IRQ_DMA1_Stream7);
     /* USER CODE END DMA1_Stream7_IRQn 0 */
     HAL_DMA_IRQHandler(&hdma_uart5_tx);
     /* USER CODE BEGIN DMA1_Stream7_IRQn 1 */
-
+    SYS_STAT_IRQ_EXIT(eSys_Stat_IRQ_DMA1_Stream7);
     /* USER CODE END DMA1_Stream7_IRQn 1 */
 }
 
@@ -333,6 +390,7 @@ void DMA1_Stream7_IRQHandler(void)
 void UART5_IRQHandler(void)
 {
     /* USER CODE BEGIN UART5_IRQn 0 */
+    SYS_STAT_IRQ_ENTER(eSys_Stat_IRQ_UART5);
     if (__HAL_UART_GET_FLAG(&huart5, UART_FLAG_IDLE)) {
         __HAL_UART_CLEAR_IDLEFLAG(&huart5);
         comm_Out_IRQ_RX_Deal(&huart5);
@@ -340,7 +398,7 @@ void UART5_IRQHandler(void)
     /* USER CODE END UART5_IRQn 0 */
     HAL_UART_IRQHandler(&huart5);
     /* USER CODE BEGIN UART5_IRQn 1 */
-
+    SYS_STAT_IRQ_EXIT(eSys_Stat_IRQ_UART5);
     /* USER CODE END UART5_IRQn 1 */
 }
 
@@ -350,11 +408,12 @@ void UART5_IRQHandler(void)
 void TIM6_DAC_IRQHandler(void)
 {
     /* USER CODE BEGIN TIM6_DAC_IRQn 0 */
+    SYS_STAT_IRQ_ENTER(eSys_Stat_IRQ_TIM6_DAC);
     comm_Data_WH_Time_Deal_FromISR();
     /* USER CODE END TIM6_DAC_IRQn 0 */
     HAL_TIM_IRQHandler(&htim6);
     /* USER CODE BEGIN TIM6_DAC_IRQn 1 */
-
+    SYS_STAT_IRQ_EXIT(eSys_Stat_IRQ_TIM6_DAC);
     /* USER CODE END TIM6_DAC_IRQn 1 */
 }
 
@@ -364,11 +423,12 @@ void TIM6_DAC_IRQHandler(void)
 void TIM7_IRQHandler(void)
 {
     /* USER CODE BEGIN TIM7_IRQn 0 */
+    SYS_STAT_IRQ_ENTER(eSys_Stat_IRQ_TIM7);
     comm_Data_PD_Time_Deal_FromISR();
     /* USER CODE END TIM7_IRQn 0 */
     HAL_TIM_IRQHandler(&htim7);
     /* USER CODE BEGIN TIM7_IRQn 1 */
-
+    SYS_STAT_IRQ_EXIT(eSys_Stat_IRQ_TIM7);
     /* USER CODE END TIM7_IRQn 1 */
 }
 
@@ -378,11 +438,11 @@ void TIM7_IRQHandler(void)
 void DMA2_Stream0_IRQHandler(void)
 {
     /* USER CODE BEGIN DMA2_Stream0_IRQn 0 */
-
+    SYS_STAT_IRQ_ENTER(eSys_Stat_IRQ_DMA2_Stream0);
     /* USER CODE END DMA2_Stream0_IRQn 0 */
     HAL_DMA_IRQHandler(&hdma_adc1);
     /* USER CODE BEGIN DMA2_Stream0_IRQn 1 */
-
+    SYS_STAT_IRQ_EXIT(eSys_Stat_IRQ_DMA2_Stream0);
     /* USER CODE END DMA2_Stream0_IRQn 1 */
 }
 
@@ -392,11 +452,11 @@ void DMA2_Stream0_IRQHandler(void)
 void DMA2_Stream2_IRQHandler(void)
 {
     /* USER CODE BEGIN DMA2_Stream2_IRQn 0 */
-
+    SYS_STAT_IRQ_ENTER(eSys_Stat_IRQ_DMA2_Stream2);
     /* USER CODE END DMA2_Stream2_IRQn 0 */
     HAL_DMA_IRQHandler(&hdma_usart1_rx);
     /* USER CODE BEGIN DMA2_Stream2_IRQn 1 */
-
+    SYS_STAT_IRQ_EXIT(eSys_Stat_IRQ_DMA2_Stream2);
     /* USER CODE END DMA2_Stream2_IRQn 1 */
 }
 
@@ -406,11 +466,11 @@ void DMA2_Stream2_IRQHandler(void)
 void DMA2_Stream5_IRQHandler(void)
 {
     /* USER CODE BEGIN DMA2_Stream5_IRQn 0 */
-
+    SYS_STAT_IRQ_ENTER(eSys_Stat_IRQ_DMA2_Stream5);
     /* USER CODE END DMA2_Stream5_IRQn 0 */
     HAL_DMA_IRQHandler(&hdma_tim1_up);
     /* USER CODE BEGIN DMA2_Stream5_IRQn 1 */
-
+    SYS_STAT_IRQ_EXIT(eSys_Stat_IRQ_DMA2_Stream5);
     /* USER CODE END DMA2_Stream5_IRQn 1 */
 }
 
@@ -420,15 +480,25 @@ void DMA2_Stream5_IRQHandler(void)
 void DMA2_Stream7_IRQHandler(void)
 {
     /* USER CODE BEGIN DMA2_Stream7_IRQn 0 */
-
+    SYS_STAT_IRQ_ENTER(eSys_Stat_IRQ_DMA2_Stream7);
     /* USER CODE END DMA2_Stream7_IRQn 0 */
     HAL_DMA_IRQHandler(&hdma_usart1_tx);
     /* USER CODE BEGIN DMA2_Stream7_IRQn 1 */
-
+    SYS_STAT_IRQ_EXIT(eSys_Stat_IRQ_DMA2_Stream7);
     /* USER CODE END DMA2_Stream7_IRQn 1 */
 }
 
 /* USER CODE BEGIN 1 */
 
+/**
+ * @brief This function handles TIM5 global interrupt.
+ */
+void TIM5_IRQHandler(void)
+{
+    SYS_STAT_IRQ_ENTER(eSys_Stat_IRQ_TIM5);
+    power_Wake_IRQ_Handler(); /* 无节拍空闲 唤醒定时 */
+    SYS_STAT_IRQ_EXIT(eSys_Stat_IRQ_TIM5);
+}
+
 /* USER CODE END 1 */
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
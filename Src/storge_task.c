@@ -9,6 +9,7 @@
 #include "protocol.h"
 #include "soft_timer.h"
 #include "motor.h"
+#include "boot.h"
 
 /* Private includes ----------------------------------------------------------*/
 #include "storge_task.h"
@@ -56,6 +57,8 @@ const uint16_t cStorge_Test_EEPROM_Addrs[3] = {0, 2048, 4080};
 /* Private variables ---------------------------------------------------------*/
 static sStorgeTaskQueueInfo gStorgeTaskInfo;
 static TaskHandle_t storgeTaskHandle = NULL;
+static StackType_t storgeTaskStack[320];
+static StaticTask_t storgeTaskTCB;
 static uint8_t gStorgeTaskInfoLock = 0;
 static sStorgeParamInfo gStorgeParamInfo;
 static uint8_t gStorgeIllumineCnt = 0;
@@ -309,7 +312,8 @@ void storgeTaskNotification_FromISR(eStorgeNotifyConf type, eProtocol_COMM_Index
  */
 void storgeTaskInit(void)
 {
-    if (xTaskCreate(storgeTask, "StorgeTask", 320, NULL, TASK_PRIORITY_STORGE, &storgeTaskHandle) != pdPASS) {
+    storgeTaskHandle = xTaskCreateStatic(storgeTask, "StorgeTask", ARRAY_LEN(storgeTaskStack), NULL, TASK_PRIORITY_STORGE, storgeTaskStack, &storgeTaskTCB);
+    if (storgeTaskHandle == NULL) {
         FL_Error_Handler(__FILE__, __LINE__);
     }
 }
@@ -335,6 +339,7 @@ static void storgeTask(void * argument)
     } else if (result == 2) {
         error_Emit(eError_Out_Flash_Read_Failed); /* 读取失败 */
     }
+    boot_Mark(BOOT_BIT_PARAM); /* 参数加载完成 失败时以默认值继续 */
 
     for (;;) {
         xResult = xTaskNotifyWait(0x00, 0xFFFFFFFF, &ulNotifyValue, portMAX_DELAY);
@@ -722,6 +727,36 @@ void storge_Param_Illumine_CC_Set_Single(eStorgeParamIndex idx, uint32_t data)
     return;
 }
 
+/**
+ * @brief  定标参数标准值 整段设置
+ * @note   6个通道 3个波长 临界区内一次写入 存储任务保存参数时不会读到部分更新
+ * @param  stage 定标段索引 0 ~ 5
+ * @param  pValues 标准值 按 波长 * 6 + 通道 排列 共18个
+ * @retval None
+ */
+void storge_Param_Illumine_CC_Set_Stage(uint8_t stage, uint32_t const * pValues)
+{
+    uint8_t i;
+    eStorgeParamIndex idx;
+    eComm_Data_Sample_Radiant wave;
+    uint32_t * p;
+
+    if (stage > 5 || pValues == NULL) {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    for (wave = eComm_Data_Sample_Radiant_610; wave <= eComm_Data_Sample_Radiant_405; ++wave) { /* 610 550 405 */
+        for (i = 0; i < 6; ++i) {                                                               /* 6个通道 */
+            idx = storge_Param_Illumine_CC_Get_Index(i + 1, wave) - 6 + stage;                  /* 校正参数标准值索引 段索引偏移 */
+            p = &gStorgeParamInfo.illumine_CC_t1_610_i0;
+            p += idx - eStorgeParamIndex_Illumine_CC_t1_610_i0;
+            *p = *pValues++;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
 /**
  * @brief  参数读取
  * @note   全局变量 gStorgeParamInfo -> 缓存
@@ -1127,3 +1162,23 @@ void storge_Sample_LED_PD_Set(eComm_Data_Sample_Radiant radian, uint8_t idx, uin
             break;
     }
 }
+
+/**
+ * @brief  LED校正结果 DAC值 获取
+ * @param  radian 波长
+ * @note   加载记录后为外部Flash中上次校正结果
+ * @retval DAC值
+ */
+uint16_t storge_Sample_LED_DAC_Get(eComm_Data_Sample_Radiant radian)
+{
+    switch (radian) {
+        case eComm_Data_Sample_Radiant_610:
+            return gStorgeFlashSample_LED_DAC_Buffer[0];
+        case eComm_Data_Sample_Radiant_550:
+            return gStorgeFlashSample_LED_DAC_Buffer[1];
+        case eComm_Data_Sample_Radiant_405:
+            return gStorgeFlashSample_LED_DAC_Buffer[2];
+        default:
+            return 0;
+    }
+}
@@ -0,0 +1,629 @@
+/**
+ * @file    sys_stat.c
+ * @brief   系统运行统计
+ *
+ * 任务运行时间 TIM5 32位自由计数 10uS 约11.9小时回绕 占用率取两次查询之间的差值 回绕不影响
+ * 查询由协议解析(中断内)提交 在定时器服务任务中统计并发送
+ *
+ * 中断统计 DWT CYCCNT 周期计数 入口/出口 记录每个中断的执行时长
+ * 执行时长含被更高优先级中断抢占的时间
+ * 延迟为下限估计 其他中断入口时本中断已挂起 则从该时刻计至本中断入口 并记录阻塞者
+ *
+ * 资源余量 堆历史最小剩余(heap_2 无此接口 由 traceMALLOC 记录) 各任务栈余量 通讯队列峰值深度(traceQUEUE_SEND 记录)
+ * 随外串口温度上送 按设定周期上送 或单次查询
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "sys_stat.h"
+#include "comm_out.h"
+#include "comm_main.h"
+#include <string.h>
+
+/* Extern variables ----------------------------------------------------------*/
+
+/* Private includes ----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+#define SYS_STAT_TASK_MAX 16                                 /* 统计任务数上限 */
+#define SYS_STAT_NAME_LEN 10                                 /* 任务名称 上送长度上限 */
+#define SYS_STAT_TASK_HEAD_LEN 6                             /* 标识 + 统计间隔4字节 + 任务数 */
+#define SYS_STAT_TASK_UNIT_LEN 8                             /* 编号 状态 优先级 占用率2字节 栈余量2字节 名称长度 */
+#define SYS_STAT_PAYLOAD_MAX (COMM_OUT_SER_TX_SIZE - 7)      /* 上送数据长度上限 */
+#define SYS_STAT_IRQ_HEAD_LEN 3                              /* 标识 + 帧序号 + 中断数 */
+#define SYS_STAT_IRQ_UNIT_LEN (14 + SYS_STAT_IRQ_BUCKET * 4) /* 单个中断 打包长度 */
+#define SYS_STAT_IRQN_MAX 96                                 /* NVIC 挂起寄存器 3个字 */
+#define SYS_STAT_IRQ_NONE 0xFF                               /* 无对应统计中断 */
+#define SYS_STAT_RES_HEAD_LEN 10                             /* 标识 + 堆剩余4字节 + 堆历史最小4字节 + 任务数 */
+#define SYS_STAT_RES_TASK_LEN 3                              /* 编号 + 栈余量2字节 */
+#define SYS_STAT_RES_QUEUE_LEN 4                             /* 编号 + 长度 + 当前深度 + 峰值深度 */
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    uint32_t count;                         /* 执行次数 */
+    uint32_t dur_min;                       /* 执行时长 最小值 周期 */
+    uint32_t dur_max;                       /* 执行时长 最大值 周期 */
+    uint32_t dur_hist[SYS_STAT_IRQ_BUCKET]; /* 执行时长 直方图 */
+    uint32_t lat_count;                     /* 被阻塞次数 */
+    uint32_t lat_max;                       /* 延迟 最大值 周期 */
+    uint8_t lat_max_by;                     /* 延迟最大值时 阻塞者 */
+    uint32_t lat_hist[SYS_STAT_IRQ_BUCKET]; /* 延迟 直方图 */
+} sSys_Stat_IRQ;
+
+/* Private function prototypes -----------------------------------------------*/
+static void sys_Stat_Report_Send(eProtocol_COMM_Index index, uint8_t length);
+static BaseType_t sys_Stat_Report_Pend_FromISR(PendedFunction_t xFunctionToPend, eProtocol_COMM_Index index);
+static void sys_Stat_Task_Report(void * pvParameter1, uint32_t ulParameter2);
+static void sys_Stat_IRQ_Report(void * pvParameter1, uint32_t ulParameter2);
+static void sys_Stat_Resource_Report(void * pvParameter1, uint32_t ulParameter2);
+
+/* Private variables ---------------------------------------------------------*/
+TIM_HandleTypeDef htim5;
+
+static TaskStatus_t gSys_Stat_Tasks[SYS_STAT_TASK_MAX];         /* 任务状态快照 */
+static uint32_t gSys_Stat_Task_Run_Last[SYS_STAT_TASK_MAX + 1]; /* 上次查询时运行时间 按任务编号 */
+static uint32_t gSys_Stat_Total_Last = 0;                       /* 上次查询时总运行时间 */
+static uint8_t gSys_Stat_Buffer[COMM_OUT_SER_TX_SIZE];          /* 上送缓存 定时器服务任务独占 */
+
+static sSys_Stat_IRQ gSys_Stat_IRQs[eSys_Stat_IRQ_Num];         /* 中断统计 */
+static uint32_t gSys_Stat_IRQ_Pending_Since[eSys_Stat_IRQ_Num]; /* 挂起被观察到的时刻 0 为无 */
+static uint8_t gSys_Stat_IRQ_Pending_By[eSys_Stat_IRQ_Num];     /* 挂起被观察到时 执行中的中断 */
+static uint32_t gSys_Stat_IRQ_Edges[SYS_STAT_IRQ_BUCKET - 1];   /* 直方图分档边界 周期 */
+static uint32_t gSys_Stat_IRQ_Mask[SYS_STAT_IRQN_MAX / 32];     /* 统计中断 挂起寄存器掩码 */
+static uint8_t gSys_Stat_IRQ_Index[SYS_STAT_IRQN_MAX];          /* 中断号 -> 统计索引 */
+
+static QueueHandle_t gSys_Stat_Queues[eSys_Stat_Queue_Num]; /* 统计队列 */
+static uint8_t gSys_Stat_Queue_Length[eSys_Stat_Queue_Num]; /* 队列长度 */
+static uint8_t gSys_Stat_Queue_Peak[eSys_Stat_Queue_Num];   /* 队列峰值深度 */
+static size_t gSys_Stat_Heap_Min = SIZE_MAX;                /* 堆历史最小剩余 */
+static uint8_t gSys_Stat_Resource_Period = 0;               /* 资源余量上送周期 秒 0 为不上送 */
+static TickType_t gSys_Stat_Resource_Tick = 0;              /* 资源余量上次上送时刻 */
+
+/* Private constants ---------------------------------------------------------*/
+static const IRQn_Type cSys_Stat_IRQns[eSys_Stat_IRQ_Num] = { /* 与 eSys_Stat_IRQ 对应 */
+    EXTI2_IRQn, EXTI3_IRQn, EXTI4_IRQn, DMA1_Stream0_IRQn, DMA1_Stream1_IRQn,
+    DMA1_Stream5_IRQn, DMA1_Stream6_IRQn, TIM1_UP_TIM10_IRQn, USART1_IRQn, USART2_IRQn,
+    USART3_IRQn, TIM8_TRG_COM_TIM14_IRQn, DMA1_Stream7_IRQn, TIM5_IRQn, UART5_IRQn,
+    TIM6_DAC_IRQn, TIM7_IRQn, DMA2_Stream0_IRQn, DMA2_Stream2_IRQn, DMA2_Stream5_IRQn,
+    DMA2_Stream7_IRQn,
+};
+static const uint16_t cSys_Stat_IRQ_Edges_US[SYS_STAT_IRQ_BUCKET - 1] = {1, 2, 5, 10, 20, 50, 100}; /* 直方图分档边界 uS */
+
+/* Private user code ---------------------------------------------------------*/
+
+/**
+ * @brief  运行时间统计定时器初始化
+ * @note   portCONFIGURE_TIMER_FOR_RUN_TIME_STATS 启动调度器时调用
+ * @param  None
+ * @retval None
+ */
+void sys_Stat_Run_Time_Init(void)
+{
+    __HAL_RCC_TIM5_CLK_ENABLE();
+
+    htim5.Instance = TIM5;
+    htim5.Init.Prescaler = SYS_STAT_RUN_TIME_PRESCALER;
+    htim5.Init.CounterMode = TIM_COUNTERMODE_UP;
+    htim5.Init.Period = 0xFFFFFFFF;
+    htim5.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    htim5.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+    if (HAL_TIM_Base_Init(&htim5) != HAL_OK) {
+        FL_Error_Handler(__FILE__, __LINE__);
+    }
+    HAL_TIM_Base_Start(&htim5);
+}
+
+/**
+ * @brief  运行时间统计计数值
+ * @note   portGET_RUN_TIME_COUNTER_VALUE
+ * @param  None
+ * @retval 计数值 10uS
+ */
+uint32_t sys_Stat_Run_Time_Get(void)
+{
+    return __HAL_TIM_GET_COUNTER(&htim5);
+}
+
+/**
+ * @brief  任务统计 打包
+ * @note   标识 + 统计间隔 4字节小端 10uS + 任务数
+ * @note   每任务 编号 + 状态 eTaskState + 当前优先级 + 占用率 千分比 2字节 + 栈余量 字 2字节 + 名称长度 + 名称
+ * @note   占用率为距上次查询的间隔内 首次查询为启动以来 调用任务上下文 不可在中断中调用
+ * @param  pBuffer 输出指针
+ * @param  size 输出长度上限
+ * @retval 输出长度
+ */
+uint8_t sys_Stat_Task_Pack(uint8_t * pBuffer, uint8_t size)
+{
+    TaskStatus_t const * pTask;
+    UBaseType_t i, num;
+    uint32_t total, interval, run;
+    uint16_t permille;
+    uint8_t j, name_len, length;
+
+    num = uxTaskGetSystemState(gSys_Stat_Tasks, ARRAY_LEN(gSys_Stat_Tasks), &total);
+    interval = total - gSys_Stat_Total_Last;
+    gSys_Stat_Total_Last = total;
+
+    pBuffer[0] = SYS_STAT_TAG_TASK;
+    pBuffer[1] = interval & 0xFF;
+    pBuffer[2] = (interval >> 8) & 0xFF;
+    pBuffer[3] = (interval >> 16) & 0xFF;
+    pBuffer[4] = (interval >> 24) & 0xFF;
+    pBuffer[5] = 0;
+    length = SYS_STAT_TASK_HEAD_LEN;
+
+    for (i = 0; i < num; ++i) {
+        pTask = &gSys_Stat_Tasks[i];
+        if (pTask->xTaskNumber <= SYS_STAT_TASK_MAX) { /* 按编号记录上次运行时间 */
+            run = pTask->ulRunTimeCounter - gSys_Stat_Task_Run_Last[pTask->xTaskNumber];
+            gSys_Stat_Task_Run_Last[pTask->xTaskNumber] = pTask->ulRunTimeCounter;
+        } else {
+            run = 0;
+        }
+        permille = (interval > 0) ? ((uint64_t)(run)*1000 / interval) : (0);
+        for (name_len = 0; name_len < SYS_STAT_NAME_LEN && pTask->pcTaskName[name_len] != '\0'; ++name_len) {
+        }
+        if (length + SYS_STAT_TASK_UNIT_LEN + name_len > size) { /* 超出长度上限 */
+            break;
+        }
+        pBuffer[length++] = pTask->xTaskNumber;
+        pBuffer[length++] = pTask->eCurrentState;
+        pBuffer[length++] = pTask->uxCurrentPriority;
+        pBuffer[length++] = permille & 0xFF;
+        pBuffer[length++] = permille >> 8;
+        pBuffer[length++] = pTask->usStackHighWaterMark & 0xFF;
+        pBuffer[length++] = pTask->usStackHighWaterMark >> 8;
+        pBuffer[length++] = name_len;
+        for (j = 0; j < name_len; ++j) {
+            pBuffer[length++] = pTask->pcTaskName[j];
+        }
+        ++pBuffer[5];
+    }
+    return length;
+}
+
+/**
+ * @brief  任务统计 上送
+ * @note   定时器服务任务中执行
+ * @param  pvParameter1 未使用
+ * @param  ulParameter2 协议出口类型
+ * @retval None
+ */
+static void sys_Stat_Task_Report(void * pvParameter1, uint32_t ulParameter2)
+{
+    sys_Stat_Report_Send((eProtocol_COMM_Index)(ulParameter2), sys_Stat_Task_Pack(gSys_Stat_Buffer, SYS_STAT_PAYLOAD_MAX));
+}
+
+/**
+ * @brief  任务统计 上送 中断版本
+ * @note   提交到定时器服务任务执行
+ * @param  index 协议出口类型
+ * @retval 提交结果
+ */
+BaseType_t sys_Stat_Task_Report_FromISR(eProtocol_COMM_Index index)
+{
+    return sys_Stat_Report_Pend_FromISR(sys_Stat_Task_Report, index);
+}
+
+/**
+ * @brief  统计上送缓存 发送
+ * @note   定时器服务任务中执行
+ * @param  index 协议出口类型
+ * @param  length 数据长度
+ * @retval None
+ */
+static void sys_Stat_Report_Send(eProtocol_COMM_Index index, uint8_t length)
+{
+    if (index == eComm_Main) {
+        comm_Main_SendTask_QueueEmitWithBuild(eProtocolEmitPack_Client_CMD_Debug_System, gSys_Stat_Buffer, length, 50);
+    } else {
+        comm_Out_SendTask_QueueEmitWithBuild(eProtocolEmitPack_Client_CMD_Debug_System, gSys_Stat_Buffer, length, 50);
+    }
+}
+
+/**
+ * @brief  统计上送 提交到定时器服务任务
+ * @param  xFunctionToPend 上送函数
+ * @param  index 协议出口类型
+ * @retval 提交结果
+ */
+static BaseType_t sys_Stat_Report_Pend_FromISR(PendedFunction_t xFunctionToPend, eProtocol_COMM_Index index)
+{
+    BaseType_t xResult, xHigherPriorityTaskWoken = pdFALSE;
+
+    xResult = xTimerPendFunctionCallFromISR(xFunctionToPend, NULL, index, &xHigherPriorityTaskWoken);
+    if (xResult == pdPASS) {
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    }
+    return xResult;
+}
+
+/**
+ * @brief  中断统计 初始化
+ * @note   系统时钟配置后 外设中断使能前调用 使能 DWT 周期计数
+ * @param  None
+ * @retval None
+ */
+void sys_Stat_IRQ_Init(void)
+{
+    uint8_t i;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    for (i = 0; i < ARRAY_LEN(gSys_Stat_IRQ_Edges); ++i) {
+        gSys_Stat_IRQ_Edges[i] = cSys_Stat_IRQ_Edges_US[i] * (SystemCoreClock / 1000000);
+    }
+    memset(gSys_Stat_IRQ_Index, SYS_STAT_IRQ_NONE, sizeof(gSys_Stat_IRQ_Index));
+    for (i = 0; i < eSys_Stat_IRQ_Num; ++i) {
+        gSys_Stat_IRQ_Index[cSys_Stat_IRQns[i]] = i;
+        gSys_Stat_IRQ_Mask[cSys_Stat_IRQns[i] / 32] |= 1UL << (cSys_Stat_IRQns[i] % 32);
+    }
+    sys_Stat_IRQ_Clear();
+}
+
+/**
+ * @brief  中断统计 直方图分档
+ * @param  cycles 周期数
+ * @retval 分档索引
+ */
+static uint8_t sys_Stat_IRQ_Bucket(uint32_t cycles)
+{
+    uint8_t i;
+
+    for (i = 0; i < ARRAY_LEN(gSys_Stat_IRQ_Edges); ++i) {
+        if (cycles < gSys_Stat_IRQ_Edges[i]) {
+            break;
+        }
+    }
+    return i;
+}
+
+/**
+ * @brief  中断统计 入口
+ * @note   结算本中断的挂起延迟 并记录此刻挂起的其他统计中断
+ * @param  irq 统计中断索引
+ * @retval 入口时刻 周期计数
+ */
+uint32_t sys_Stat_IRQ_Enter(eSys_Stat_IRQ irq)
+{
+    sSys_Stat_IRQ * pStat = &gSys_Stat_IRQs[irq];
+    uint32_t now, since, latency, pending;
+    uint8_t i, bit, other;
+
+    now = DWT->CYCCNT;
+    since = gSys_Stat_IRQ_Pending_Since[irq];
+    if (since != 0) { /* 曾被其他中断阻塞 */
+        gSys_Stat_IRQ_Pending_Since[irq] = 0;
+        latency = now - since;
+        ++pStat->lat_count;
+        ++pStat->lat_hist[sys_Stat_IRQ_Bucket(latency)];
+        if (latency > pStat->lat_max) {
+            pStat->lat_max = latency;
+            pStat->lat_max_by = gSys_Stat_IRQ_Pending_By[irq];
+        }
+    }
+
+    for (i = 0; i < ARRAY_LEN(gSys_Stat_IRQ_Mask); ++i) { /* 此刻已挂起的统计中断 将被本中断阻塞 */
+        pending = NVIC->ISPR[i] & gSys_Stat_IRQ_Mask[i];
+        while (pending) {
+            bit = 31 - __CLZ(pending);
+            pending &= ~(1UL << bit);
+            other = gSys_Stat_IRQ_Index[i * 32 + bit];
+            if (other != irq && gSys_Stat_IRQ_Pending_Since[other] == 0) {
+                gSys_Stat_IRQ_Pending_Since[other] = now | 1; /* 0 表示无 */
+                gSys_Stat_IRQ_Pending_By[other] = irq;
+            }
+        }
+    }
+    return now;
+}
+
+/**
+ * @brief  中断统计 出口
+ * @param  irq 统计中断索引
+ * @param  start 入口时刻
+ * @retval None
+ */
+void sys_Stat_IRQ_Exit(eSys_Stat_IRQ irq, uint32_t start)
+{
+    sSys_Stat_IRQ * pStat = &gSys_Stat_IRQs[irq];
+    uint32_t duration;
+
+    duration = DWT->CYCCNT - start;
+    ++pStat->count;
+    ++pStat->dur_hist[sys_Stat_IRQ_Bucket(duration)];
+    if (duration < pStat->dur_min) {
+        pStat->dur_min = duration;
+    }
+    if (duration > pStat->dur_max) {
+        pStat->dur_max = duration;
+    }
+}
+
+/**
+ * @brief  中断统计 清零
+ * @note   可在中断中调用 与更高优先级中断并发时 个别计数可能丢失
+ * @param  None
+ * @retval None
+ */
+void sys_Stat_IRQ_Clear(void)
+{
+    uint8_t i;
+
+    memset(gSys_Stat_IRQs, 0, sizeof(gSys_Stat_IRQs));
+    memset(gSys_Stat_IRQ_Pending_Since, 0, sizeof(gSys_Stat_IRQ_Pending_Since));
+    for (i = 0; i < eSys_Stat_IRQ_Num; ++i) {
+        gSys_Stat_IRQs[i].dur_min = UINT32_MAX;
+        gSys_Stat_IRQs[i].lat_max_by = SYS_STAT_IRQ_NONE;
+    }
+}
+
+/**
+ * @brief  中断统计 周期数转换 0.1uS 饱和到16位
+ * @param  cycles 周期数
+ * @retval 0.1uS
+ */
+static uint16_t sys_Stat_IRQ_Cycles_To_Tenth_US(uint32_t cycles)
+{
+    uint64_t result;
+
+    result = (uint64_t)(cycles) * 10 / (SystemCoreClock / 1000000);
+    return (result > UINT16_MAX) ? (UINT16_MAX) : (result);
+}
+
+/**
+ * @brief  中断统计 单个中断 打包
+ * @note   索引 + 次数 4字节 + 时长最小/最大 + 阻塞次数 2字节 + 延迟最大 + 阻塞者 + 时长直方图 + 延迟直方图
+ * @note   时长与延迟单位 0.1uS 直方图 2字节 饱和
+ * @param  pBuffer 输出指针
+ * @param  irq 统计中断索引
+ * @retval 输出长度
+ */
+static uint8_t sys_Stat_IRQ_Pack_One(uint8_t * pBuffer, eSys_Stat_IRQ irq)
+{
+    sSys_Stat_IRQ stat;
+    uint16_t value;
+    uint8_t i, length = 0;
+
+    taskENTER_CRITICAL();
+    memcpy(&stat, &gSys_Stat_IRQs[irq], sizeof(stat)); /* 快照 */
+    taskEXIT_CRITICAL();
+
+    pBuffer[length++] = irq;
+    pBuffer[length++] = stat.count & 0xFF;
+    pBuffer[length++] = (stat.count >> 8) & 0xFF;
+    pBuffer[length++] = (stat.count >> 16) & 0xFF;
+    pBuffer[length++] = (stat.count >> 24) & 0xFF;
+    value = sys_Stat_IRQ_Cycles_To_Tenth_US(stat.dur_min);
+    pBuffer[length++] = value & 0xFF;
+    pBuffer[length++] = value >> 8;
+    value = sys_Stat_IRQ_Cycles_To_Tenth_US(stat.dur_max);
+    pBuffer[length++] = value & 0xFF;
+    pBuffer[length++] = value >> 8;
+    value = (stat.lat_count > UINT16_MAX) ? (UINT16_MAX) : (stat.lat_count);
+    pBuffer[length++] = value & 0xFF;
+    pBuffer[length++] = value >> 8;
+    value = sys_Stat_IRQ_Cycles_To_Tenth_US(stat.lat_max);
+    pBuffer[length++] = value & 0xFF;
+    pBuffer[length++] = value >> 8;
+    pBuffer[length++] = stat.lat_max_by;
+    for (i = 0; i < SYS_STAT_IRQ_BUCKET; ++i) {
+        value = (stat.dur_hist[i] > UINT16_MAX) ? (UINT16_MAX) : (stat.dur_hist[i]);
+        pBuffer[length++] = value & 0xFF;
+        pBuffer[length++] = value >> 8;
+    }
+    for (i = 0; i < SYS_STAT_IRQ_BUCKET; ++i) {
+        value = (stat.lat_hist[i] > UINT16_MAX) ? (UINT16_MAX) : (stat.lat_hist[i]);
+        pBuffer[length++] = value & 0xFF;
+        pBuffer[length++] = value >> 8;
+    }
+    return length;
+}
+
+/**
+ * @brief  中断统计 上送
+ * @note   定时器服务任务中执行 仅上送执行过的中断 按长度上限分帧
+ * @note   每帧 标识 + 帧序号 + 中断数 + 中断数据
+ * @param  pvParameter1 未使用
+ * @param  ulParameter2 协议出口类型
+ * @retval None
+ */
+static void sys_Stat_IRQ_Report(void * pvParameter1, uint32_t ulParameter2)
+{
+    uint8_t i, length = SYS_STAT_IRQ_HEAD_LEN, frame = 0;
+
+    gSys_Stat_Buffer[0] = SYS_STAT_TAG_IRQ;
+    gSys_Stat_Buffer[1] = frame;
+    gSys_Stat_Buffer[2] = 0;
+    for (i = 0; i < eSys_Stat_IRQ_Num; ++i) {
+        if (gSys_Stat_IRQs[i].count == 0) {
+            continue;
+        }
+        if (length + SYS_STAT_IRQ_UNIT_LEN > SYS_STAT_PAYLOAD_MAX) { /* 本帧已满 */
+            sys_Stat_Report_Send((eProtocol_COMM_Index)(ulParameter2), length);
+            length = SYS_STAT_IRQ_HEAD_LEN;
+            gSys_Stat_Buffer[0] = SYS_STAT_TAG_IRQ;
+            gSys_Stat_Buffer[1] = ++frame;
+            gSys_Stat_Buffer[2] = 0;
+        }
+        length += sys_Stat_IRQ_Pack_One(gSys_Stat_Buffer + length, (eSys_Stat_IRQ)(i));
+        ++gSys_Stat_Buffer[2];
+    }
+    sys_Stat_Report_Send((eProtocol_COMM_Index)(ulParameter2), length);
+}
+
+/**
+ * @brief  中断统计 上送 中断版本
+ * @note   提交到定时器服务任务执行
+ * @param  index 协议出口类型
+ * @retval 提交结果
+ */
+BaseType_t sys_Stat_IRQ_Report_FromISR(eProtocol_COMM_Index index)
+{
+    return sys_Stat_Report_Pend_FromISR(sys_Stat_IRQ_Report, index);
+}
+
+/**
+ * @brief  队列峰值深度统计 注册
+ * @note   队列创建后调用 设置队列编号 编号为 0 的队列不统计
+ * @param  xQueue 队列
+ * @param  queue 统计编号
+ * @retval None
+ */
+void sys_Stat_Queue_Register(QueueHandle_t xQueue, eSys_Stat_Queue queue)
+{
+    if (queue == eSys_Stat_Queue_None || queue >= eSys_Stat_Queue_Num) {
+        return;
+    }
+    gSys_Stat_Queues[queue] = xQueue;
+    gSys_Stat_Queue_Length[queue] = uxQueueSpacesAvailable(xQueue) + uxQueueMessagesWaiting(xQueue);
+    gSys_Stat_Queue_Peak[queue] = 0;
+    vQueueSetQueueNumber(xQueue, queue);
+}
+
+/**
+ * @brief  队列峰值深度统计 traceQUEUE_SEND 钩子
+ * @note   在队列临界区内调用 入队前深度 覆盖写入时深度不增加
+ * @param  number 队列编号
+ * @param  waiting 入队前深度
+ * @retval None
+ */
+void sys_Stat_Queue_Trace(unsigned long number, unsigned long waiting)
+{
+    if (number == eSys_Stat_Queue_None || number >= eSys_Stat_Queue_Num) {
+        return;
+    }
+    if (waiting < gSys_Stat_Queue_Length[number]) {
+        ++waiting;
+    }
+    if (waiting > gSys_Stat_Queue_Peak[number]) {
+        gSys_Stat_Queue_Peak[number] = waiting;
+    }
+}
+
+/**
+ * @brief  堆历史最小剩余 traceMALLOC 钩子
+ * @note   调度器挂起时调用
+ * @param  None
+ * @retval None
+ */
+void sys_Stat_Heap_Trace(void)
+{
+    size_t remain;
+
+    remain = xPortGetFreeHeapSize();
+    if (remain < gSys_Stat_Heap_Min) {
+        gSys_Stat_Heap_Min = remain;
+    }
+}
+
+/**
+ * @brief  资源余量 打包
+ * @note   标识 + 堆剩余 4字节 + 堆历史最小剩余 4字节 + 任务数 + 每任务 编号 栈余量 字 2字节
+ * @note   + 队列数 + 每队列 编号 长度 当前深度 峰值深度
+ * @note   栈余量取自任务状态快照 与任务统计共用 须在定时器服务任务中调用
+ * @param  pBuffer 输出指针
+ * @param  size 输出长度上限
+ * @retval 输出长度
+ */
+static uint8_t sys_Stat_Resource_Pack(uint8_t * pBuffer, uint8_t size)
+{
+    UBaseType_t i, num;
+    size_t remain, remain_min;
+    uint8_t length, count;
+
+    remain = xPortGetFreeHeapSize();
+    remain_min = (gSys_Stat_Heap_Min < remain) ? (gSys_Stat_Heap_Min) : (remain);
+    num = uxTaskGetSystemState(gSys_Stat_Tasks, ARRAY_LEN(gSys_Stat_Tasks), NULL);
+
+    pBuffer[0] = SYS_STAT_TAG_RES;
+    pBuffer[1] = remain & 0xFF;
+    pBuffer[2] = (remain >> 8) & 0xFF;
+    pBuffer[3] = (remain >> 16) & 0xFF;
+    pBuffer[4] = (remain >> 24) & 0xFF;
+    pBuffer[5] = remain_min & 0xFF;
+    pBuffer[6] = (remain_min >> 8) & 0xFF;
+    pBuffer[7] = (remain_min >> 16) & 0xFF;
+    pBuffer[8] = (remain_min >> 24) & 0xFF;
+    pBuffer[9] = 0;
+    length = SYS_STAT_RES_HEAD_LEN;
+    for (i = 0; i < num && length + SYS_STAT_RES_TASK_LEN < size; ++i) { /* 预留队列数 1字节 */
+        pBuffer[length++] = gSys_Stat_Tasks[i].xTaskNumber;
+        pBuffer[length++] = gSys_Stat_Tasks[i].usStackHighWaterMark & 0xFF;
+        pBuffer[length++] = gSys_Stat_Tasks[i].usStackHighWaterMark >> 8;
+        ++pBuffer[9];
+    }
+
+    count = length++;
+    pBuffer[count] = 0;
+    for (i = eSys_Stat_Queue_None + 1; i < eSys_Stat_Queue_Num && length + SYS_STAT_RES_QUEUE_LEN <= size; ++i) {
+        if (gSys_Stat_Queues[i] == NULL) {
+            continue;
+        }
+        pBuffer[length++] = i;
+        pBuffer[length++] = gSys_Stat_Queue_Length[i];
+        pBuffer[length++] = uxQueueMessagesWaiting(gSys_Stat_Queues[i]);
+        pBuffer[length++] = gSys_Stat_Queue_Peak[i];
+        ++pBuffer[count];
+    }
+    return length;
+}
+
+/**
+ * @brief  资源余量 上送
+ * @note   定时器服务任务中执行
+ * @param  pvParameter1 未使用
+ * @param  ulParameter2 协议出口类型
+ * @retval None
+ */
+static void sys_Stat_Resource_Report(void * pvParameter1, uint32_t ulParameter2)
+{
+    sys_Stat_Report_Send((eProtocol_COMM_Index)(ulParameter2), sys_Stat_Resource_Pack(gSys_Stat_Buffer, SYS_STAT_PAYLOAD_MAX));
+}
+
+/**
+ * @brief  资源余量 上送 中断版本
+ * @note   提交到定时器服务任务执行
+ * @param  index 协议出口类型
+ * @retval 提交结果
+ */
+BaseType_t sys_Stat_Resource_Report_FromISR(eProtocol_COMM_Index index)
+{
+    return sys_Stat_Report_Pend_FromISR(sys_Stat_Resource_Report, index);
+}
+
+/**
+ * @brief  资源余量 上送周期设置
+ * @param  period 上送周期 秒 0 为不上送
+ * @retval None
+ */
+void sys_Stat_Resource_Period_Set(uint8_t period)
+{
+    gSys_Stat_Resource_Period = period;
+}
+
+/**
+ * @brief  资源余量 周期上送处理
+ * @note   外串口温度上送中调用 到达上送周期后提交到定时器服务任务
+ * @param  None
+ * @retval None
+ */
+void sys_Stat_Resource_Upload_Deal(void)
+{
+    TickType_t now;
+
+    if (gSys_Stat_Resource_Period == 0) {
+        return;
+    }
+    now = xTaskGetTickCount();
+    if (now - gSys_Stat_Resource_Tick < pdMS_TO_TICKS(gSys_Stat_Resource_Period * 1000)) {
+        return;
+    }
+    if (xTimerPendFunctionCall(sys_Stat_Resource_Report, NULL, eComm_Out, 0) == pdPASS) {
+        gSys_Stat_Resource_Tick = now;
+    }
+}
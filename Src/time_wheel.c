@@ -0,0 +1,233 @@
+/**
+ * @file    time_wheel.c
+ * @brief   周期事务 哈希时间轮
+ *
+ * 杂项任务中的周期事务 (LED 风扇 温度上送 预先点灯等) 统一挂在时间轮上 各自按周期到期执行
+ * 任务按 到期时刻 >> TIME_WHEEL_SLOT_SHIFT 散列到槽 同槽链表 到期判断按时刻 不计圈数
+ * 杂项任务阻塞到最近一个到期时刻 (或收到通知) 醒来后推进游标 执行到期回调 同一时刻到期的事务合并为一次唤醒
+ * 周期回调按上次到期时刻累加 保持对齐 错过时从当前时刻重新计
+ *
+ * 仅在杂项任务中调用 不加锁
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include "time_wheel.h"
+
+/* Extern variables ----------------------------------------------------------*/
+
+/* Private includes ----------------------------------------------------------*/
+
+/* Private define ------------------------------------------------------------*/
+#define TIME_WHEEL_SLOT_SHIFT 3                                           /* 槽间隔 8 节拍 */
+#define TIME_WHEEL_SLOT_NUM 64                                            /* 槽数 2 的幂 一圈 512 节拍 */
+#define TIME_WHEEL_SLOT_MASK (TIME_WHEEL_SLOT_NUM - 1)                    /* 槽索引掩码 */
+#define TIME_WHEEL_IS_DUE(now, expire) ((int32_t)((now) - (expire)) >= 0) /* 已到期 */
+
+/* Private macro -------------------------------------------------------------*/
+
+/* Private typedef -----------------------------------------------------------*/
+/* 时间轮统计 */
+typedef struct {
+    TickType_t start; /* 统计起始时刻 */
+    uint32_t wake;    /* 唤醒次数 */
+    uint32_t runs;    /* 回调次数 */
+    TickType_t late;  /* 回调延后 最大值 */
+} sTime_Wheel_Stat;
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private variables ---------------------------------------------------------*/
+static sTime_Wheel_Job * gTime_Wheel_Slots[TIME_WHEEL_SLOT_NUM];
+static uint32_t gTime_Wheel_Cursor = 0; /* 当前槽 到期时刻 >> TIME_WHEEL_SLOT_SHIFT */
+static sTime_Wheel_Stat gTime_Wheel_Stat;
+
+/* Private constants ---------------------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+
+/**
+ * @brief  时间轮 初始化
+ * @param  now 当前时刻
+ * @retval None
+ */
+void time_Wheel_Init(TickType_t now)
+{
+    memset(gTime_Wheel_Slots, 0, sizeof(gTime_Wheel_Slots));
+    gTime_Wheel_Cursor = now >> TIME_WHEEL_SLOT_SHIFT;
+    time_Wheel_Stat_Clear();
+}
+
+/**
+ * @brief  时间轮 按到期时刻加入槽
+ * @param  pJob 任务
+ * @retval None
+ */
+static void time_Wheel_Insert(sTime_Wheel_Job * pJob)
+{
+    sTime_Wheel_Job ** ppSlot = &gTime_Wheel_Slots[(pJob->expire >> TIME_WHEEL_SLOT_SHIFT) & TIME_WHEEL_SLOT_MASK];
+
+    pJob->pNext = *ppSlot;
+    *ppSlot = pJob;
+    pJob->active = 1;
+}
+
+/**
+ * @brief  时间轮 取消任务
+ * @param  pJob 任务
+ * @retval None
+ */
+void time_Wheel_Cancel(sTime_Wheel_Job * pJob)
+{
+    sTime_Wheel_Job ** ppLink;
+
+    if (pJob->active == 0) {
+        return;
+    }
+    ppLink = &gTime_Wheel_Slots[(pJob->expire >> TIME_WHEEL_SLOT_SHIFT) & TIME_WHEEL_SLOT_MASK];
+    while (*ppLink != NULL) {
+        if (*ppLink == pJob) {
+            *ppLink = pJob->pNext; /* 摘除 */
+            break;
+        }
+        ppLink = &(*ppLink)->pNext;
+    }
+    pJob->active = 0;
+}
+
+/**
+ * @brief  时间轮 加入任务
+ * @note   已在时间轮中的任务 按新间隔重新加入
+ * @param  pJob 任务
+ * @param  fun 回调 返回下次间隔 mS 0 停止
+ * @param  delay 首次执行间隔 mS
+ * @retval None
+ */
+void time_Wheel_Add(sTime_Wheel_Job * pJob, time_Wheel_Fun fun, uint32_t delay)
+{
+    time_Wheel_Cancel(pJob);
+    pJob->fun = fun;
+    pJob->expire = xTaskGetTickCount() + pdMS_TO_TICKS(delay);
+    time_Wheel_Insert(pJob);
+}
+
+/**
+ * @brief  时间轮 推进游标 执行到期回调
+ * @note   游标停留在当前槽 下次从当前槽继续 阻塞超过一圈时 每槽只处理一次
+ * @param  now 当前时刻
+ * @retval None
+ */
+void time_Wheel_Run(TickType_t now)
+{
+    sTime_Wheel_Job *pJob, **ppLink;
+    uint32_t target, interval;
+
+    ++gTime_Wheel_Stat.wake;
+    target = now >> TIME_WHEEL_SLOT_SHIFT;
+    if (target - gTime_Wheel_Cursor > TIME_WHEEL_SLOT_NUM) { /* 阻塞超过一圈 */
+        gTime_Wheel_Cursor = target - TIME_WHEEL_SLOT_NUM;
+    }
+
+    for (;;) {
+        ppLink = &gTime_Wheel_Slots[gTime_Wheel_Cursor & TIME_WHEEL_SLOT_MASK];
+        while ((pJob = *ppLink) != NULL) {
+            if (TIME_WHEEL_IS_DUE(now, pJob->expire) == 0) { /* 未到期 后续圈 */
+                ppLink = &pJob->pNext;
+                continue;
+            }
+            *ppLink = pJob->pNext; /* 摘除后执行 回调内可重新加入或取消任意任务 */
+            pJob->active = 0;
+            if (now - pJob->expire > gTime_Wheel_Stat.late) {
+                gTime_Wheel_Stat.late = now - pJob->expire;
+            }
+            ++gTime_Wheel_Stat.runs;
+            interval = pJob->fun(now);
+            if (interval > 0 && pJob->active == 0) {       /* 周期任务 回调内未重新加入 */
+                pJob->expire += pdMS_TO_TICKS(interval);   /* 按到期时刻累加 保持对齐 */
+                if (TIME_WHEEL_IS_DUE(now, pJob->expire)) { /* 已错过 */
+                    pJob->expire = now + pdMS_TO_TICKS(interval);
+                }
+                time_Wheel_Insert(pJob);
+            }
+            ppLink = &gTime_Wheel_Slots[gTime_Wheel_Cursor & TIME_WHEEL_SLOT_MASK]; /* 链表可能已改变 从头检查 */
+        }
+        if (gTime_Wheel_Cursor == target) {
+            break;
+        }
+        ++gTime_Wheel_Cursor;
+    }
+}
+
+/**
+ * @brief  时间轮 距最近到期时刻的节拍数
+ * @param  now 当前时刻
+ * @retval 节拍数 0 已有到期任务 portMAX_DELAY 无任务
+ */
+TickType_t time_Wheel_Next(TickType_t now)
+{
+    sTime_Wheel_Job * pJob;
+    TickType_t wait = portMAX_DELAY;
+    uint8_t i;
+
+    for (i = 0; i < TIME_WHEEL_SLOT_NUM; ++i) {
+        for (pJob = gTime_Wheel_Slots[i]; pJob != NULL; pJob = pJob->pNext) {
+            if (TIME_WHEEL_IS_DUE(now, pJob->expire)) {
+                return 0;
+            }
+            if (pJob->expire - now < wait) {
+                wait = pJob->expire - now;
+            }
+        }
+    }
+    return wait;
+}
+
+/**
+ * @brief  时间轮统计 打包
+ * @note   标识 + 统计时长 mS + 唤醒次数 + 回调次数 各4字节 + 回调延后最大值 mS 2字节
+ * @note   可在中断中调用 统计值为清零以来
+ * @param  pBuffer 输出指针
+ * @retval 输出长度
+ */
+uint8_t time_Wheel_Stat_Pack(uint8_t * pBuffer)
+{
+    uint32_t data[3];
+    uint16_t late;
+    UBaseType_t uxSavedInterruptStatus;
+    uint8_t i, length = 0;
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    data[0] = (xTaskGetTickCountFromISR() - gTime_Wheel_Stat.start) * portTICK_PERIOD_MS;
+    data[1] = gTime_Wheel_Stat.wake;
+    data[2] = gTime_Wheel_Stat.runs;
+    late = (gTime_Wheel_Stat.late * portTICK_PERIOD_MS > UINT16_MAX) ? (UINT16_MAX) : (gTime_Wheel_Stat.late * portTICK_PERIOD_MS);
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+
+    pBuffer[length++] = TIME_WHEEL_TAG_STAT;
+    for (i = 0; i < ARRAY_LEN(data); ++i) {
+        pBuffer[length++] = data[i] >> 0;
+        pBuffer[length++] = data[i] >> 8;
+        pBuffer[length++] = data[i] >> 16;
+        pBuffer[length++] = data[i] >> 24;
+    }
+    pBuffer[length++] = late & 0xFF;
+    pBuffer[length++] = late >> 8;
+    return length;
+}
+
+/**
+ * @brief  时间轮统计 清零
+ * @note   可在中断中调用
+ * @param  None
+ * @retval None
+ */
+void time_Wheel_Stat_Clear(void)
+{
+    UBaseType_t uxSavedInterruptStatus;
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    gTime_Wheel_Stat.start = xTaskGetTickCountFromISR();
+    gTime_Wheel_Stat.wake = 0;
+    gTime_Wheel_Stat.runs = 0;
+    gTime_Wheel_Stat.late = 0;
+    taskEXIT_CRITICAL_FROM_ISR(uxSavedInterruptStatus);
+}
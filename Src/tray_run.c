@@ -14,8 +14,17 @@
 /* Private includes ----------------------------------------------------------*/
 
 /* Private typedef -----------------------------------------------------------*/
+/* 托盘复归统计 */
+typedef struct {
+    uint32_t home;  /* 复归次数 */
+    uint32_t skip;  /* 位置可信省略复归次数 */
+    uint32_t lost;  /* 位置置信丢失次数 */
+    uint32_t saved; /* 省略复归节省时间 ms */
+} sTray_Motor_Home_Stat;
 
 /* Private define ------------------------------------------------------------*/
+#define TRAY_MOTOR_OPT_WINDOW (400)      /* 原点光耦遮挡范围 8细分步 */
+#define TRAY_MOTOR_HOME_TIME_INIT (2000) /* 复归耗时初始估计 ms */
 
 /* Private macro -------------------------------------------------------------*/
 #define TRAY_MOTOR_IS_BUSY (dSPIN_Busy_SW()) /* 托盘电机忙碌位读取 */
@@ -27,10 +36,117 @@ static sMoptorRunCmdInfo gTray_Motor_Run_CMD_Info;
 
 static uint8_t gTray_Motor_Scan_EE = 0;
 static uint8_t gTray_Motor_Scan_Reverse = 0;
+
+static uint8_t gTray_Motor_Pos_Confidence = 0;                /* 位置可信标志 复归后置位 */
+static sTray_Motor_Home_Stat gTray_Motor_Home_Stats[2] = {0}; /* 复归统计 0 累计 1 本次测试 */
+static uint32_t gTray_Motor_Home_Time = 0;                    /* 复归耗时平均值 ms */
 /* Private function prototypes -----------------------------------------------*/
+static void tray_Motor_Pos_Confidence_Mark(void);
 
 /* Private user code ---------------------------------------------------------*/
 
+/**
+ * @brief  托盘电机 位置可信标记
+ * @note   光耦处重置驱动步数记录后调用
+ * @param  None
+ * @retval None
+ */
+static void tray_Motor_Pos_Confidence_Mark(void)
+{
+    gTray_Motor_Pos_Confidence = 1;
+}
+
+/**
+ * @brief  托盘电机 位置置信丢失
+ * @note   驱动失步/过流/低压/过温 运动失败 光耦状态与记录位置不符 出仓后托盘被推动 需重新复归
+ * @param  None
+ * @retval None
+ */
+void tray_Motor_Pos_Confidence_Lost(void)
+{
+    if (gTray_Motor_Pos_Confidence) {
+        gTray_Motor_Pos_Confidence = 0;
+        ++gTray_Motor_Home_Stats[0].lost;
+        ++gTray_Motor_Home_Stats[1].lost;
+    }
+}
+
+/**
+ * @brief  托盘电机 位置置信检查
+ * @note   原点光耦遮挡时记录位置必须在遮挡范围内 未遮挡时必须在范围外 否则判定位置丢失
+ * @param  opt 托盘原点光耦状态 1 遮挡 0 未遮挡
+ * @retval 1 位置可信 0 需要复归
+ */
+uint8_t tray_Motor_Pos_Confidence_Check(uint8_t opt)
+{
+    uint8_t in_window;
+
+    if (gTray_Motor_Pos_Confidence == 0) {
+        return 0;
+    }
+    in_window = (motor_Status_Get_Position(&gTray_Motor_Run_Status) < TRAY_MOTOR_OPT_WINDOW) ? (1) : (0);
+    if (in_window != (opt ? 1 : 0)) {               /* 光耦状态与记录位置不符 */
+        tray_Motor_Pos_Confidence_Lost();           /* 位置置信丢失 */
+        error_Emit(eError_Tray_Motor_Pos_Mismatch); /* 提交错误信息 */
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief  托盘电机 省略复归记录
+ * @note   按复归耗时平均值累计节省时间
+ * @param  None
+ * @retval None
+ */
+void tray_Motor_Home_Skip_Record(void)
+{
+    uint32_t home_time = (gTray_Motor_Home_Time > 0) ? (gTray_Motor_Home_Time) : (TRAY_MOTOR_HOME_TIME_INIT);
+
+    for (uint8_t i = 0; i < ARRAY_LEN(gTray_Motor_Home_Stats); ++i) {
+        ++gTray_Motor_Home_Stats[i].skip;
+        gTray_Motor_Home_Stats[i].saved += home_time;
+    }
+}
+
+/**
+ * @brief  托盘电机 复归统计 本次测试清零
+ * @param  None
+ * @retval None
+ */
+void tray_Motor_Home_Stat_Test_Clear(void)
+{
+    memset(&gTray_Motor_Home_Stats[1], 0, sizeof(gTray_Motor_Home_Stats[1]));
+}
+
+/**
+ * @brief  托盘电机 复归统计 打包
+ * @note   位置可信标志 + 复归耗时平均值 + 累计(复归 省略 丢失 节省ms) + 本次测试(同前) 除标志外各4字节 小端
+ * @param  pBuffer 输出指针
+ * @retval 输出长度
+ */
+uint8_t tray_Motor_Home_Stat_Pack(uint8_t * pBuffer)
+{
+    uint32_t data[1 + 4 * ARRAY_LEN(gTray_Motor_Home_Stats)];
+    uint8_t i, length = 0;
+
+    data[0] = gTray_Motor_Home_Time;
+    for (i = 0; i < ARRAY_LEN(gTray_Motor_Home_Stats); ++i) {
+        data[1 + 4 * i] = gTray_Motor_Home_Stats[i].home;
+        data[2 + 4 * i] = gTray_Motor_Home_Stats[i].skip;
+        data[3 + 4 * i] = gTray_Motor_Home_Stats[i].lost;
+        data[4 + 4 * i] = gTray_Motor_Home_Stats[i].saved;
+    }
+    pBuffer[length++] = gTray_Motor_Pos_Confidence;
+    for (i = 0; i < ARRAY_LEN(data); ++i) {
+        pBuffer[length++] = data[i] >> 0;
+        pBuffer[length++] = data[i] >> 8;
+        pBuffer[length++] = data[i] >> 16;
+        pBuffer[length++] = data[i] >> 24;
+    }
+    return length;
+}
+
 /**
  * @brief  托盘电机 丢步异常使能标记
  * @param  None
@@ -139,18 +255,21 @@ void tray_Motor_Deal_Status()
     if (((status & dSPIN_STATUS_STEP_LOSS_A) == 0) || ((status & dSPIN_STATUS_STEP_LOSS_B) == 0)) { /* 发生失步 */
         m_l6470_Reset_HW();                                                                         /* 硬件重置 */
         m_l6470_Params_Init();                                                                      /* 初始化参数 */
+        tray_Motor_Pos_Confidence_Lost();                                                           /* 位置置信丢失 */
         error_Emit(eError_Motor_Tray_Status_Warui);                                                 /* 提交错误信息 */
         return;
     }
     if (((status & dSPIN_STATUS_UVLO)) == 0) {      /* 低压 */
         m_l6470_Reset_HW();                         /* 硬件重置 */
         m_l6470_Params_Init();                      /* 初始化参数 */
+        tray_Motor_Pos_Confidence_Lost();           /* 位置置信丢失 */
         error_Emit(eError_Motor_Tray_Status_Warui); /* 提交错误信息 */
         return;
     }
     if (((status & dSPIN_STATUS_TH_WRN)) == 0 || ((status & dSPIN_STATUS_TH_SD)) == 0 || ((status & dSPIN_STATUS_OCD)) == 0) { /* 高温 超温 过流 */
         m_l6470_Reset_HW();                                                                                                    /* 硬件重置 */
         m_l6470_Params_Init();                                                                                                 /* 初始化参数 */
+        tray_Motor_Pos_Confidence_Lost();                                                                                      /* 位置置信丢失 */
         error_Emit(eError_Motor_Tray_Status_Warui);                                                                            /* 提交错误信息 */
         return;
     }
@@ -194,6 +313,9 @@ eTrayState tray_Motor_Leave_On_OPT(void)
             dSPIN_Reset_Pos();                                /* 重置电机驱动步数记录 */
             tray_Motor_Deal_Status();
             motor_Status_Set_Position(&gTray_Motor_Run_Status, 0); /* 重置电机状态步数记录 */
+            if (TRAY_MOTOR_IS_OPT_1) {                             /* 在光耦处停车 */
+                tray_Motor_Pos_Confidence_Mark();                  /* 位置可信 */
+            }
             return eTrayState_OK;
         }
         vTaskDelay(5); /* 延时 */
@@ -277,14 +399,14 @@ eTrayState tray_Motor_Run(void)
     if (gTray_Motor_Run_CMD_Info.step < 0xFFFFFF) {
         switch (gTray_Motor_Run_CMD_Info.dir) {
             case eMotorDir_REV:
-                tray_Motor_EE_Clear();                                                /* 清除托盘丢步标志位 */
-                dSPIN_Set_Param(dSPIN_MAX_SPEED, Index_1_dSPIN_CONF_PARAM_MAX_SPEED); /* 进仓恢复最大速度 */
-                dSPIN_Move(FWD, gTray_Motor_Run_CMD_Info.step);                       /* 向驱动发送指令 */
+                tray_Motor_EE_Clear();                                                  /* 清除托盘丢步标志位 */
+                m_l6470_Set_Param(dSPIN_MAX_SPEED, Index_1_dSPIN_CONF_PARAM_MAX_SPEED); /* 进仓恢复最大速度 */
+                dSPIN_Move(FWD, gTray_Motor_Run_CMD_Info.step);                         /* 向驱动发送指令 */
                 break;
             case eMotorDir_FWD:
             default:
-                dSPIN_Set_Param(dSPIN_MAX_SPEED, Index_1_dSPIN_CONF_PARAM_MAX_SPEED / 2); /* 出仓速度减半 */
-                dSPIN_Move(REV, gTray_Motor_Run_CMD_Info.step);                           /* 向驱动发送指令 */
+                m_l6470_Set_Param(dSPIN_MAX_SPEED, Index_1_dSPIN_CONF_PARAM_MAX_SPEED / 2); /* 出仓速度减半 */
+                dSPIN_Move(REV, gTray_Motor_Run_CMD_Info.step);                             /* 向驱动发送指令 */
                 break;
         }
     } else {
@@ -300,7 +422,7 @@ eTrayState tray_Motor_Run(void)
         if (TRAY_MOTOR_IS_FLAG) {
             tray_Motor_Deal_Status();
         }
-        dSPIN_Set_Param(dSPIN_MAX_SPEED, Index_1_dSPIN_CONF_PARAM_MAX_SPEED); /* 进仓恢复最大速度 */
+        m_l6470_Set_Param(dSPIN_MAX_SPEED, Index_1_dSPIN_CONF_PARAM_MAX_SPEED); /* 进仓恢复最大速度 */
 
         tray_Motor_EE_Clear(); /* 清除托盘丢步标志位 */
         dSPIN_Move(FWD, (eTrayIndex_2 >> 5) << 3);
@@ -313,6 +435,9 @@ eTrayState tray_Motor_Run(void)
     result = gTray_Motor_Run_CMD_Info.pfLeave(); /* 出口回调 */
     tray_Motor_Deal_Status();                    /* 读取电机驱动状态清除标志 */
     m_l6470_release();                           /* 释放SPI总线资源*/
+    if (result != eTrayState_OK) {               /* 运动失败 */
+        tray_Motor_Pos_Confidence_Lost();        /* 位置置信丢失 */
+    }
     return result;
 }
 
@@ -333,6 +458,7 @@ uint8_t tray_Motor_Reset_Pos()
         dSPIN_Reset_Pos();                                     /* 重置电机驱动步数记录 */
         tray_Motor_Deal_Status();                              /* 状态处理 */
         motor_Status_Set_Position(&gTray_Motor_Run_Status, 0); /* 重置电机状态步数记录 */
+        tray_Motor_Pos_Confidence_Mark();                      /* 位置可信 */
         vTaskDelay(400);                                       /* 延时 */
         m_l6470_release();                                     /* 释放SPI总线资源*/
         return 0;
@@ -352,6 +478,7 @@ eTrayState tray_Motor_Init(void)
     TickType_t xTick;
 
     error_Emit(eError_Motor_Tray_Debug);
+    tray_Motor_Pos_Confidence_Lost(); /* 位置记录在重置前无效 */
     result = tray_Motor_Enter();
     if (result != eTrayState_OK) { /* 入口回调 */
         if (result != eTrayState_Tiemout) {
@@ -391,6 +518,32 @@ eTrayState tray_Motor_Init(void)
     return eTrayState_OK;
 }
 
+/**
+ * @brief  托盘电机 复归
+ * @note   初始化位置后在原点光耦处重置步数记录 记录复归次数及耗时
+ * @param  None
+ * @retval 0 成功 其他 失败 参考 tray_Motor_Reset_Pos
+ */
+uint8_t tray_Motor_Home(void)
+{
+    TickType_t xTick;
+    uint32_t home_time;
+    uint8_t result;
+
+    xTick = xTaskGetTickCount();
+    tray_Motor_Init();               /* 托盘电机初始化 */
+    result = tray_Motor_Reset_Pos(); /* 重置托盘电机位置 */
+    home_time = (xTaskGetTickCount() - xTick) * portTICK_PERIOD_MS;
+
+    for (uint8_t i = 0; i < ARRAY_LEN(gTray_Motor_Home_Stats); ++i) {
+        ++gTray_Motor_Home_Stats[i].home;
+    }
+    if (result == 0) {
+        gTray_Motor_Home_Time = (gTray_Motor_Home_Time == 0) ? (home_time) : ((gTray_Motor_Home_Time * 3 + home_time) / 4); /* 滑动平均 */
+    }
+    return result;
+}
+
 /**
  * @brief  计算需要移动的方向和步数
  * @param  target_step 目标位置距离初始位置运动的步数
@@ -491,6 +644,7 @@ void tray_Motor_ISR_Deal(void)
         if (tray_Motor_EE_Get()) {
             error_Emit_FromISR(eError_Tray_Motor_Lose);
             tray_Motor_Scan_Reverse_Mark();
+            tray_Motor_Pos_Confidence_Lost();
         }
     }
 }
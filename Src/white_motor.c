@@ -8,6 +8,7 @@
 #include "motor.h"
 #include "m_drv8824.h"
 #include "white_motor.h"
+#include "motor_profile.h"
 #include <math.h>
 
 /* Extern variables ----------------------------------------------------------*/
@@ -101,6 +102,23 @@ static eWhite_Motor_Status gWhite_Motor_Status = eWhite_Motor_Undone;
 static uint8_t gWhite_Motor_PD_Failed_Flag = 0; /* PD方向运动失败标志 此标志用于重新清零白板电机位置 白板方向实际距离大于PD方向距离时 PD方向将永远不可达 */
 
 /* Private constants ---------------------------------------------------------*/
+/* 可配置运动曲线默认值 默认仍使用原有S型函数曲线 */
+static const sMotor_Profile_Conf cWhite_Motor_Profile_PD = {
+    .type = eMotor_Profile_Type_Sigmoid,
+    .dec = 1,
+    .freq_min = WHITE_MOTOR_PD_FREQ_MIN,
+    .freq_max = WHITE_MOTOR_PD_FREQ_MAX,
+    .acc = 400000.0,
+    .jerk = 40000000.0,
+};
+static const sMotor_Profile_Conf cWhite_Motor_Profile_WH = {
+    .type = eMotor_Profile_Type_Sigmoid,
+    .dec = 1,
+    .freq_min = WHITE_MOTOR_WH_FREQ_MIN,
+    .freq_max = WHITE_MOTOR_WH_FREQ_MAX,
+    .acc = 40000.0,
+    .jerk = 4000000.0,
+};
 
 /* Private function prototypes -----------------------------------------------*/
 static void gWhite_Motor_Position_Set(uint32_t position);
@@ -180,6 +198,17 @@ uint8_t gWhite_Motor_PD_Failed_Flag_Get(void)
     return gWhite_Motor_PD_Failed_Flag;
 }
 
+/**
+ * @brief  白板电机 运动曲线注册
+ * @param  None
+ * @retval None
+ */
+void white_Motor_Profile_Init(void)
+{
+    motor_Profile_Register(eMotor_Profile_Index_White_PD, &cWhite_Motor_Profile_PD, WHITE_MOTOR_PD_PCS_UNT, WHITE_MOTOR_PD_PCS_SUM);
+    motor_Profile_Register(eMotor_Profile_Index_White_WH, &cWhite_Motor_Profile_WH, WHITE_MOTOR_WH_PCS_UNT, WHITE_MOTOR_WH_PCS_SUM);
+}
+
 /**
  * @brief  白板电机位置 使能
  * @param  None
@@ -278,6 +307,7 @@ static void gWhite_Motor_Position_Rst(void)
 
 /**
  * @brief 白板电机 停车确认
+ * @note   先等待运动完成通知 再确认位置 通知超时后仍按原有方式轮询到超时
  * @param  None
  * @retval 0 正常停车 1 停车超时 2 异常
  */
@@ -286,6 +316,7 @@ uint8_t white_Motor_Wait_Stop(uint32_t timeout)
     TickType_t xTick;
 
     xTick = xTaskGetTickCount();
+    m_drv8824_Wait_Done(timeout); /* 等待运动完成通知 */
     switch (gWhite_Motor_Dir_Get()) {
         case eMotorDir_REV:
             do {
@@ -340,6 +371,7 @@ uint8_t white_Motor_PD()
 
     gWhite_Motor_Position_Rst();                               /* 重置位置记录置非法值 0xFFFFFFFF */
     m_drv8824_Index_Switch(eM_DRV8824_Index_0, portMAX_DELAY); /* 等待PWM资源 */
+    motor_Profile_Prepare(eMotor_Profile_Index_White_PD);      /* 运动曲线生效 */
     m_drv8824_Clear_Flag();                                    /* 清理故障标志 */
     m_drv8824_SetDir(eMotorDir_REV);                           /* 运动方向设置 硬件管脚 */
     gWhite_Motor_Dir_Set(eMotorDir_REV);                       /* 运动方向设置 目标方向 */
@@ -397,6 +429,7 @@ uint8_t white_Motor_WH()
 
     gWhite_Motor_Position_Rst();                               /* 重置位置记录置非法值 0xFFFFFFFF */
     m_drv8824_Index_Switch(eM_DRV8824_Index_0, portMAX_DELAY); /* 等待PWM资源 */
+    motor_Profile_Prepare(eMotor_Profile_Index_White_WH);      /* 运动曲线生效 */
     m_drv8824_Clear_Flag();                                    /* 清理故障标志 */
     m_drv8824_SetDir(eMotorDir_FWD);                           /* 运动方向设置 硬件管脚 */
     gWhite_Motor_Dir_Set(eMotorDir_FWD);                       /* 运动方向设置 目标方向 */
@@ -449,6 +482,10 @@ uint16_t whiteMotor_PWM_Period_In(uint16_t idx)
 {
     float freq;
 
+    if (motor_Profile_Is_Sigmoid(eMotor_Profile_Index_White_PD) == 0) { /* 可配置曲线 查表 */
+        return motor_Profile_Period(eMotor_Profile_Index_White_PD, idx);
+    }
+
     freq = WHITE_MOTOR_PD_FREQ_MIN + (WHITE_MOTOR_PD_FREQ_MAX - WHITE_MOTOR_PD_FREQ_MIN) / (1 + expf(-WHITE_MOTOR_PD_E_K * idx + WHITE_MOTOR_PD_E_B));
 
     return 108000000.0 / freq;
@@ -496,6 +533,10 @@ uint16_t whiteMotor_PWM_Period_Out(uint16_t idx)
 {
     float freq;
 
+    if (motor_Profile_Is_Sigmoid(eMotor_Profile_Index_White_WH) == 0) { /* 可配置曲线 查表 */
+        return motor_Profile_Period(eMotor_Profile_Index_White_WH, idx);
+    }
+
     if (idx < WHITE_MOTOR_WH_PCS_SUM / 2) {
         freq = WHITE_MOTOR_WH_FREQ_MIN + (WHITE_MOTOR_WH_FREQ_MAX - WHITE_MOTOR_WH_FREQ_MIN) / (1 + expf(-WHITE_MOTOR_WH_E_K * idx + WHITE_MOTOR_WH_E_B));
     } else {
@@ -0,0 +1,288 @@
+"""
+完整测试流程 脚本化场景 协议吞吐 与 各阶段耗时 基准
+
+场景与上位机 qt_frame 开始测试一致
+    开始测量 0x01 -> 扫码结果 0xB2 -> 测试项信息 0x03 (6 通道 方法/波长/点数) -> 采集数据 0xB3 (逐通道) -> 采样完成 0xB6
+    测试项信息 在首个扫码结果后发出 电机任务开始测试时清除已收到的配置
+统计 各阶段耗时 (首个条码 各通道完成 采样完成) 收发帧数 字节 有效载荷速率 重复帧 错误帧 命令 ACK 延时
+
+两种对象
+    缺省 主机构建 (CMakeLists.txt) assay_test 实际固件源码 + FreeRTOS 主机移植 + 外设与器件模型 虚拟时间
+         托盘 扫码电机 (L6470) 白板 上加热体电机 (DRV8824) 扫码头 (SE2707) 采样板 均为 Tools/host/model 模型
+         目标板无可用 QEMU 机型 (netduino2 等缺少本板外设) 以主机构建代替
+    --port 实际串口 或 任何 pyserial URL (如 socket://127.0.0.1:4321 /dev/pts/N 将串口映射到主机)
+         真实时间 结束后可选 --stats 读取 任务/中断/资源/休眠 统计 (调试系统控制 0xDC)
+
+python assay_scenario.py                                   # 主机构建 默认配置
+python assay_scenario.py --points 10 --qr 0001200521...    # 10 点 扫到二维码
+python assay_scenario.py --port COM3 --stats               # 实际设备
+"""
+
+import argparse
+import json
+import os
+import statistics
+import struct
+import subprocess
+import threading
+import time
+
+CMD_START = 0x01
+CMD_CONFIG = 0x03
+CMD_DEBUG_SYSTEM = 0xDC
+CMD_ACK = 0xAA
+
+DEVICE_ID_TEST = 0x13
+
+RESP_BARCODE = 0xB2
+RESP_SAMP_DATA = 0xB3
+RESP_ERR = 0xB5
+RESP_SAMP_OVER = 0xB6
+
+STAT_SUBS = {10: "任务统计", 11: "中断统计", 13: "资源余量", 15: "休眠统计"}  # 调试系统控制 子参数
+
+HOST_BIN = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "_gate_build", "assay_test")
+
+
+class Assay:
+    """场景 收发与时间线记录 send(cmd, data) 由后端提供 时间 mS"""
+
+    def __init__(self, conf):
+        self.conf = conf
+        self.t0 = None
+        self.events = []
+        self.rx_frames = 0
+        self.rx_bytes = 0
+        self.payload = 0
+        self.barcodes = 0
+        self.errors = []
+        self.channels = {}
+        self.over = None
+        self.config_due = False  # 收到首个条码 待发测试项信息
+
+    def start(self, now, send):
+        self.t0 = now
+        send(CMD_START, b"")
+
+    def on_frame(self, now, frame):
+        self.rx_frames += 1
+        self.rx_bytes += len(frame)
+        self.payload += len(frame) - 7
+        t = now - self.t0
+        cmd = frame[5]
+        if cmd == RESP_BARCODE:
+            self.config_due = self.barcodes == 0
+            self.barcodes += 1
+            self.events.append((t, f"条码 {frame[6]} {frame[8 : 8 + frame[7]].decode(errors='replace')}"))
+        elif cmd == RESP_SAMP_DATA:
+            self.channels[frame[7]] = (t, frame[6])
+            self.events.append((t, f"通道 {frame[7]} 完成 {frame[6]} 点"))
+        elif cmd == RESP_ERR:
+            code = struct.unpack("<H", frame[6:8])[0]
+            self.errors.append(code)
+            self.events.append((t, f"错误 {code}"))
+        elif cmd == RESP_SAMP_OVER:
+            self.over = t
+            self.events.append((t, "采样完成"))
+
+    def report(self, elapsed, ack_latency, dup, retrans):
+        print("时间线 (S)")
+        for t, text in self.events:
+            print(f"  {t / 1000:9.3f}  {text}")
+        total = self.over if self.over is not None else elapsed
+        expect = sum(1 for i in range(6) if self.conf[i * 3] and self.conf[i * 3 + 2])
+        print(f"结果 {'完成' if self.over is not None else '未完成'} 通道 {len(self.channels)}/{expect} 条码 {self.barcodes} 错误 {self.errors}")
+        print(f"耗时 {total / 1000:.3f} S  收 {self.rx_frames} 帧 {self.rx_bytes} 字节 有效载荷 {self.payload * 1000 / max(total, 1):.1f} 字节/S")
+        if ack_latency:
+            lat = sorted(ack_latency)
+            print(f"命令 ACK 延时 mS 中位 {statistics.median(lat):.2f} 最大 {lat[-1]:.2f}  重发 {retrans}  收到重复帧 {dup}")
+        return 0 if self.over is not None and len(self.channels) == expect else 1
+
+
+def run_host(args, conf):
+    """主机构建 assay_test 运行实际固件 输出一行 JSON"""
+    if len(set(args.points)) > 1:
+        print("主机构建 各通道点数需相同")
+        return 2
+    cmd = [args.host_bin, "-n", str(args.points[0]), "-m", str(args.method), "-w", str(args.wave), "-b", args.bar]
+    if args.qr:
+        cmd += ["-q", args.qr]
+    try:
+        proc = subprocess.run(cmd, capture_output=True, text=True, timeout=args.timeout)
+    except FileNotFoundError:
+        print(f"未找到 {args.host_bin} 先构建 cmake -S . -B _gate_build && cmake --build _gate_build")
+        return 2
+    lines = [line for line in proc.stdout.splitlines() if line.startswith("{")]
+    if not lines:
+        print(proc.stdout + proc.stderr)
+        return 1
+    result = json.loads(lines[-1])
+    print("时间线 (S)")
+    print(f"  {result['barcode_ms'] / 1000:9.3f}  首个条码 (共 {result['barcodes']} 帧 扫码头发出 {result['scans']} 次)")
+    print(f"  {result['first_data_ms'] / 1000:9.3f}  首个采集数据")
+    print(f"  {result['end_ms'] / 1000:9.3f}  {'采样完成' if result['pass'] else '结束 ' + result['reason']}")
+    print(f"结果 {'完成' if result['pass'] else '未完成'} 通道点数 {result['channels']} 错误 {result['errors']}")
+    print(f"采集数据 {result['data_frames']} 帧 采样板 脉冲 {result['board_pulses']} 数据帧 {result['board_frames']} 校验错误 {result['crc_errors']}")
+    return proc.returncode
+
+
+class PortLink:
+    """实际串口 接收线程拼包 自动回应 ACK 发送等待 ACK 重发 (与 comm_Out 参数一致)
+
+    帧格式 69 AA 长度 帧号 设备ID 命令 数据 CRC8 (设备ID 至数据尾 与 protocol.c CRC8 一致)
+    """
+
+    def __init__(self, url, baud, handler, device_id=DEVICE_ID_TEST):
+        import serial  # 仅实际串口需要
+
+        from bytes_helper import crc8
+
+        self.ser = serial.serial_for_url(url, baudrate=baud, timeout=0.01)
+        self.crc8 = crc8
+        self.handler = handler
+        self.device_id = device_id
+        self.index = 0
+        self.buffer = bytearray()
+        self.acked = {}
+        self.lock = threading.Lock()
+        self.last_ack = 0
+        self.dup = 0
+        self.crc_errors = 0
+        self.retrans = 0
+        self.ack_latency = []
+        self.t0 = time.perf_counter()
+        self.alive = True
+        self.reader = threading.Thread(target=self._read, daemon=True)
+        self.reader.start()
+
+    def now(self):
+        return (time.perf_counter() - self.t0) * 1000
+
+    def build(self, cmd, data, index=None):
+        if index is None:
+            self.index = self.index % 255 + 1  # 固件以 0 为初始上一帧号
+            index = self.index
+        body = bytes([self.device_id, cmd]) + bytes(data)
+        return bytes([0x69, 0xAA, len(data) + 3, index]) + body + self.crc8(body)
+
+    def _feed(self, data):
+        self.buffer += data
+        while True:
+            start = self.buffer.find(b"\x69\xAA")
+            if start < 0:
+                del self.buffer[:-1]
+                return
+            del self.buffer[:start]
+            if len(self.buffer) < 3:
+                return
+            need = self.buffer[2] + 4
+            if need < 7:
+                del self.buffer[:2]
+                continue
+            if len(self.buffer) < need:
+                return
+            frame = bytes(self.buffer[:need])
+            del self.buffer[:need]
+            if self.crc8(frame[4:-1])[0] != frame[-1]:
+                self.crc_errors += 1
+                continue
+            self._on_frame(frame)
+
+    def _read(self):
+        while self.alive:
+            data = self.ser.read(256)
+            if data:
+                self._feed(data)
+
+    def _on_frame(self, frame):
+        if frame[4] == self.device_id:
+            return
+        if frame[5] == CMD_ACK:
+            self.acked[frame[6]] = self.now()
+            return
+        with self.lock:
+            self.ser.write(self.build(CMD_ACK, [frame[3]], self.index))  # ACK 不占用帧号
+        if frame[3] == self.last_ack:
+            self.dup += 1
+            return
+        self.last_ack = frame[3]
+        self.handler(self.now(), frame)
+
+    def send(self, cmd, data):
+        frame = self.build(cmd, data)
+        self.acked.pop(frame[3], None)
+        for i in range(3):
+            if i > 0:
+                self.retrans += 1
+            start = self.now()
+            with self.lock:
+                self.ser.write(frame)
+            while self.now() - start < 200:
+                if frame[3] in self.acked:
+                    self.ack_latency.append(self.acked[frame[3]] - start)
+                    return True
+                time.sleep(0.001)
+        return False
+
+    def close(self):
+        self.alive = False
+        self.reader.join()
+        self.ser.close()
+
+
+def run_port(args, conf):
+    assay = Assay(conf)
+    stats = []
+
+    def on_frame(now, frame):
+        if frame[5] == CMD_DEBUG_SYSTEM and len(frame) > 8:
+            stats.append(frame)
+        else:
+            assay.on_frame(now, frame)
+
+    link = PortLink(args.port, args.baud, on_frame)
+    try:
+        assay.start(link.now(), link.send)
+        while assay.over is None and not assay.errors and link.now() < args.timeout * 1000:
+            if assay.config_due:  # 接收线程中不能等待 ACK
+                assay.config_due = False
+                link.send(CMD_CONFIG, bytes(assay.conf))
+            time.sleep(0.05)
+        if args.stats:
+            for sub in STAT_SUBS:
+                link.send(CMD_DEBUG_SYSTEM, bytes([sub]))
+            time.sleep(0.5)
+    finally:
+        link.close()
+    result = assay.report(link.now(), link.ack_latency, link.dup, link.retrans)
+    if link.crc_errors:
+        print(f"校验错误 {link.crc_errors} 帧")
+    for frame in stats:
+        print(f"统计 标识 0x{frame[6]:02X} {len(frame) - 7} 字节 {frame[6:-1].hex(' ')}")
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description="完整测试流程 脚本化场景 基准")
+    parser.add_argument("--port", help="串口名 或 pyserial URL 缺省运行主机构建")
+    parser.add_argument("--baud", type=int, default=115200, help="波特率")
+    parser.add_argument("--method", type=int, default=2, help="测试方法 1 速率法 2 终点法 3 两点终点法 0 不测")
+    parser.add_argument("--wave", type=int, default=1, help="波长 1 610 2 550 3 405")
+    parser.add_argument("--points", type=int, nargs="+", default=[6], help="各通道点数 不足 6 个时循环使用 主机构建需相同")
+    parser.add_argument("--timeout", type=float, default=600, help="场景超时 S")
+    parser.add_argument("--stats", action="store_true", help="实际设备 结束后读取统计")
+    parser.add_argument("--host-bin", default=HOST_BIN, help="主机构建 assay_test 路径")
+    parser.add_argument("--qr", default="", help="主机构建 扫码头模型 二维码内容 缺省无二维码")
+    parser.add_argument("--bar", default="1415190701", help="主机构建 扫码头模型 一维码内容")
+    args = parser.parse_args()
+
+    conf = []
+    for i in range(6):
+        conf += [args.method, args.wave, args.points[i % len(args.points)]]
+    if args.port:
+        return run_port(args, conf)
+    return run_host(args, conf)
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -0,0 +1,248 @@
+"""
+扫码流程 主机端时序仿真 原有串行流程 与 DMA接收流水线 对比
+
+仿真 7 个位置(二维码 + 6 个一维条码)的扫码总耗时 扫码头按预置应答回放
+    原有  barcode_Scan_Bar 每个位置 延时10mS -> 电机运动 -> 清理串口 -> 阻塞接收固定长度 800mS 超时
+          长度不足10 延时100mS 再阻塞接收 400mS 超时 -> 上送
+    流水线 DMA接收 首字节单独接收 收到即表示扫码头已完成解码 立即启动到下一位置的运动
+          帧剩余部分在运动中由DMA接收 空闲中断判断帧结束 结果在运动中上送
+          长度不足10 回到原位置 延时100mS 再扫描 400mS 超时
+
+扫码头模型 触发后经过解码耗时开始以9600波特率连续发送应答 无条码时不发送
+扫码电机 L6470 MAX_SPEED 50 ACC 120 两道之内 ACC * 2 MAX_SPEED * 1.25 (barcode_Motor_Run_By_Index)
+
+python barcode_pipeline_sim.py                      # 预置场景
+python barcode_pipeline_sim.py --decode 0.3 -v      # 解码耗时0.3秒 打印各位置时序
+python barcode_pipeline_sim.py --empty-prob 0.2     # 随机场景 每个位置无条码概率20%
+"""
+
+import argparse
+import random
+
+from motor_schedule_sim import l6470_move_time
+
+BAUD = 9600
+CHAR_TIME = 10 / BAUD  # 8N1 单字符时间
+
+BARCODE_QR_LENGTH = 65
+BARCODE_BA_LENGTH = 10
+RX_GUARD_TIME = 0.003  # BARCODE_RX_GUARD_TIME
+
+# eBarcodeIndex 32细分步
+SLOT_POS = {0: 0, 1: 3156, 2: 6312, 3: 9468, 4: 12624, 5: 15780, 6: 18680}
+SCAN_ORDER = (6, 5, 4, 3, 2, 1, 0)  # barcode_Scan_QR 后 barcode_Scan_Bar 倒序
+
+# 预置应答 与 Src/barcode_scan.c 中样本一致
+BAR_SAM_LDH_ = "1419190801"
+BAR_SAM_HB__ = "1415190701"
+BAR_SAM_AMY_ = "1411190601"
+BAR_SAM_UA__ = "1413190703"
+BAR_SAM_CREA = "1418190602"
+BAR_DEBUG_QR_2 = "000120052110A840A810A790A800A680A7A11C411C011D111D311D911CB0000F0"
+BAR_SAM_QR__ = "6882190918202303039503500200020004500560020000000400001170301020000000008"
+
+CANNED_BARS = (BAR_SAM_LDH_, BAR_SAM_HB__, BAR_SAM_AMY_, BAR_SAM_UA__, BAR_SAM_CREA, BAR_SAM_LDH_)
+
+
+def max_read_length(slot):
+    return BARCODE_QR_LENGTH if slot == 6 else BARCODE_BA_LENGTH
+
+
+def motor_move_time(src, dst, overhead):
+    """扫码电机运动耗时 秒 32细分转8细分 驱动8细分"""
+    step = abs(((SLOT_POS[dst] >> 5) << 3) - ((SLOT_POS[src] >> 5) << 3))
+    if step == 0:
+        return 0.0
+    if step <= ((SLOT_POS[1] - SLOT_POS[0]) >> 5) << 4:  # 两道之内加快运动速度
+        return l6470_move_time(step / 8, 50 * 10 // 8, 120 * 8 // 4) + overhead
+    return l6470_move_time(step / 8, 50, 120) + overhead
+
+
+class Scanner:
+    """扫码头 按位置回放预置应答 每次触发重新解码"""
+
+    def __init__(self, responses, decode, jitter=0.0, rng=None):
+        self.responses = responses  # {slot: [应答 每次触发依次取用 最后一项重复]}
+        self.decode = decode
+        self.jitter = jitter
+        self.rng = rng or random.Random(0)
+        self.count = {}
+
+    def trigger(self, slot):
+        """返回 (首字节到达时间 应答长度) 相对触发时刻 无应答返回 None"""
+        seq = self.responses.get(slot, [""])
+        n = self.count.get(slot, 0)
+        self.count[slot] = n + 1
+        text = seq[min(n, len(seq) - 1)]
+        if not text:
+            return None
+        delay = self.decode * self.rng.uniform(1 - self.jitter, 1 + self.jitter)
+        return delay + CHAR_TIME, len(text)
+
+
+def legacy_read(scanner, slot, timeout):
+    """barcode_Read_From_Serial 原有实现 阻塞接收固定长度 返回 (耗时 长度)"""
+    cost = 0.001  # 清理残余内容 1个tick超时
+    rsp = scanner.trigger(slot)
+    if rsp is None:
+        return cost + timeout, 0
+    first, length = rsp
+    size = max_read_length(slot)
+    if length >= size:
+        done = first + (size - 1) * CHAR_TIME
+        if done <= timeout:
+            return cost + done, size
+    received = min(length, size, int((timeout - first) / CHAR_TIME) + 1) if first <= timeout else 0
+    return cost + timeout, received  # 长度不足 等到超时
+
+
+def dma_frame_end(first, length, size):
+    """DMA接收 首字节后帧结束时刻 接收满即结束 否则空闲中断 + 确认时间"""
+    if length >= size:
+        return first + (size - 1) * CHAR_TIME
+    return first + (length - 1) * CHAR_TIME + CHAR_TIME + RX_GUARD_TIME
+
+
+def dma_read(scanner, slot, timeout):
+    """barcode_Read_From_Serial DMA实现 返回 (首字节时间 帧结束时间 长度) 首字节超时为 None"""
+    rsp = scanner.trigger(slot)
+    if rsp is None or rsp[0] > timeout:
+        return None, timeout, 0
+    first, length = rsp
+    size = max_read_length(slot)
+    return first, dma_frame_end(first, length, size), min(length, size)
+
+
+class Trace:
+    def __init__(self, verbose):
+        self.verbose = verbose
+        self.now = 0.0
+
+    def log(self, text, at=None):
+        if self.verbose:
+            print("  {:7.3f} {}".format(self.now if at is None else at, text))
+
+
+def run_legacy(scanner, args, verbose=False):
+    tr = Trace(verbose)
+    pos = 0
+    for n, slot in enumerate(SCAN_ORDER):
+        if n > 0:
+            tr.now += 0.010  # barcode_Scan_Bar vTaskDelay(10)
+        tr.now += motor_move_time(pos, slot, args.motor_overhead)
+        pos = slot
+        tr.log("到达位置 {}".format(slot))
+        cost, length = legacy_read(scanner, slot, 0.8)
+        tr.now += cost
+        if length < 10:
+            tr.now += 0.100
+            cost, length = legacy_read(scanner, slot, 0.4)
+            tr.now += cost
+        tr.now += args.emit
+        tr.log("位置 {} 结果长度 {}".format(slot, length))
+    return tr.now
+
+
+def run_pipeline(scanner, args, verbose=False):
+    tr = Trace(verbose)
+    pos = 0
+    move_end = None  # 已提前启动的运动完成时刻
+    tr.now += motor_move_time(pos, SCAN_ORDER[0], args.motor_overhead)
+    pos = SCAN_ORDER[0]
+    for n, slot in enumerate(SCAN_ORDER):
+        if move_end is not None:
+            tr.now = max(tr.now, move_end)
+            move_end = None
+        elif pos != slot:
+            tr.now += motor_move_time(pos, slot, args.motor_overhead)
+        pos = slot
+        tr.log("到达位置 {}".format(slot))
+        # 二维码由 barcode_Scan_QR 单独扫描 不提前运动
+        nxt = SCAN_ORDER[n + 1] if 0 < n + 1 < len(SCAN_ORDER) and n > 0 else None
+        first, done, length = dma_read(scanner, slot, 0.8)
+        start = tr.now
+        if first is not None and nxt is not None:
+            move_end = start + first + motor_move_time(slot, nxt, args.motor_overhead)
+            pos = nxt
+            tr.log("位置 {} 完成解码 启动运动到 {}".format(slot, nxt), start + first)
+        tr.now = start + done
+        if length < 10:
+            if move_end is not None:  # 回到原位置
+                tr.now = max(tr.now, move_end) + motor_move_time(nxt, slot, args.motor_overhead)
+                move_end, pos = None, slot
+            tr.now += 0.100
+            first, done, length = dma_read(scanner, slot, 0.4)
+            tr.now += done
+        tr.now += args.emit  # 运动中上送
+        tr.log("位置 {} 结果长度 {}".format(slot, length))
+    if move_end is not None:
+        tr.now = max(tr.now, move_end)
+    return tr.now
+
+
+def scenario_responses(qr, bars):
+    responses = {6: [qr]}
+    for slot, text in zip((5, 4, 3, 2, 1, 0), bars):
+        responses[slot] = [text]
+    return responses
+
+
+SCENARIOS = (
+    ("全部可读", scenario_responses(BAR_DEBUG_QR_2, CANNED_BARS)),
+    ("短二维码", scenario_responses(BAR_DEBUG_QR_2[:40], CANNED_BARS)),
+    ("长二维码", scenario_responses(BAR_SAM_QR__, CANNED_BARS)),
+    ("二维码缺失", scenario_responses("", CANNED_BARS)),
+    ("一维残缺重扫", {**scenario_responses(BAR_DEBUG_QR_2, CANNED_BARS), 3: [BAR_SAM_UA__[:6], BAR_SAM_UA__]}),
+    ("空托盘", scenario_responses("", ("",) * 6)),
+)
+
+
+def random_responses(rng, empty_prob):
+    responses = {}
+    for slot in SCAN_ORDER:
+        text = BAR_DEBUG_QR_2 if slot == 6 else rng.choice(CANNED_BARS)
+        responses[slot] = ["" if rng.random() < empty_prob else text]
+    return responses
+
+
+def main():
+    parser = argparse.ArgumentParser(description="扫码流水线时序仿真")
+    parser.add_argument("--decode", type=float, default=0.2, help="扫码头解码耗时 秒 触发到首字节")
+    parser.add_argument("--jitter", type=float, default=0.0, help="解码耗时相对波动范围")
+    parser.add_argument("--motor-overhead", type=float, default=0.02, help="扫码电机每次运动附加耗时 秒 SPI/轮询")
+    parser.add_argument("--emit", type=float, default=0.0005, help="结果上送耗时 秒 组包入队")
+    parser.add_argument("--empty-prob", type=float, default=0.1, help="随机场景 每个位置无条码概率")
+    parser.add_argument("--runs", type=int, default=1000, help="随机场景仿真次数")
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("-v", "--verbose", action="store_true")
+    args = parser.parse_args()
+
+    print("扫码电机 相邻位置 {:.3f} s  原点到二维码 {:.3f} s  字符 {:.2f} mS  解码 {:.3f} s".format(
+        motor_move_time(5, 4, args.motor_overhead), motor_move_time(0, 6, args.motor_overhead), CHAR_TIME * 1e3, args.decode))
+    for title, responses in SCENARIOS:
+        if args.verbose:
+            print("{} 原有".format(title))
+        t_legacy = run_legacy(Scanner(responses, args.decode), args, args.verbose)
+        if args.verbose:
+            print("{} 流水线".format(title))
+        t_pipe = run_pipeline(Scanner(responses, args.decode), args, args.verbose)
+        print("{:<8s} 7个位置 原有 {:6.3f} s  流水线 {:6.3f} s  缩短 {:6.3f} s ({:+.1f}%)".format(
+            title, t_legacy, t_pipe, t_legacy - t_pipe, 100 * (t_pipe - t_legacy) / t_legacy))
+
+    rng = random.Random(args.seed)
+    legacy, pipe = [], []
+    for _ in range(args.runs):
+        responses = random_responses(rng, args.empty_prob)
+        seed = rng.random()
+        jitter = max(args.jitter, 0.3)
+        legacy.append(run_legacy(Scanner(responses, args.decode, jitter, random.Random(seed)), args))
+        pipe.append(run_pipeline(Scanner(responses, args.decode, jitter, random.Random(seed)), args))
+    if legacy:
+        print("随机场景 {} 次 无条码概率 {:.0%} 平均 原有 {:.3f} s 流水线 {:.3f} s 缩短 {:.3f} s 最大缩短 {:.3f} s".format(
+            args.runs, args.empty_prob, sum(legacy) / len(legacy), sum(pipe) / len(pipe),
+            (sum(legacy) - sum(pipe)) / len(legacy), max(a - b for a, b in zip(legacy, pipe))))
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -0,0 +1,543 @@
+"""
+故障上送 限流合并 主机端测试 (Src/error.c)
+
+以桩代替 FreeRTOS 及串口错误信息队列 将 Src/error.c 编译为动态库 通过 ctypes 调用
+    桩队列 主串口 外串口 各 16 项 (同 COMM_MAIN_ERROR_SEND_QUEU_LENGTH COMM_OUT_ERROR_SEND_QUEU_LENGTH) 记录入队的 sError_Info
+    系统节拍 由测试推进 error_Rate_Deal 按 soft_timer 周期 100 mS 调用
+    直接读取 gError_Stat 与 gError_Rate_Slots 核对统计 窗口 记录槽
+用例
+    单次上送 窗口内合并 窗口滚动 (持续重复每窗口一帧 无重复释放记录槽 窗口结束未处理时的重复) 合并次数与时段饱和
+    记录槽满 不限流直接上送 队列满 丢弃计数 上送串口选择 中断版本 统计打包与清零
+    风暴 持续风暴 周期故障 中断突发 种类溢出 队列按线路速率取出 收到次数 + 丢弃次数 = 提交次数 错误帧数不超过 种类 x 窗口数
+
+python error_storm.py                                   # 全部测试
+python error_storm.py --storm-rate 2000 --duration 60000 --drain 5
+"""
+
+import argparse
+import ctypes
+import os
+import random
+import subprocess
+import sys
+import tempfile
+
+REPO = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+
+STUB_MAIN_H = r"""
+#ifndef __MAIN_H
+#define __MAIN_H
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define ARRAY_LEN(x) (sizeof(x) / sizeof((x)[0]))
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+#define pdFALSE 0
+#define pdFAIL 0
+#define pdPASS 1
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(x) ((TickType_t)(x))
+
+extern TickType_t stub_tick;
+extern int32_t stub_critical;
+extern int32_t stub_critical_max;
+UBaseType_t stub_critical_enter(void);
+void stub_critical_exit(void);
+
+#define xTaskGetTickCount() (stub_tick)
+#define xTaskGetTickCountFromISR() (stub_tick)
+#define taskENTER_CRITICAL() stub_critical_enter()
+#define taskEXIT_CRITICAL() stub_critical_exit()
+#define taskENTER_CRITICAL_FROM_ISR() stub_critical_enter()
+#define taskEXIT_CRITICAL_FROM_ISR(x) ((void)(x), stub_critical_exit())
+
+#define __PROTOCOL_H /* 不引入 protocol.h (依赖 HAL) */
+uint8_t protocol_Debug_ErrorReport(void);
+
+#include "error.h"
+#endif
+"""
+
+STUB_COMM_H = r"""
+#include "main.h"
+BaseType_t comm_Main_SendTask_ErrorInfoQueueEmit(sError_Info * pErrorInfo, uint32_t timeout);
+BaseType_t comm_Main_SendTask_ErrorInfoQueueEmitFromISR(sError_Info * pErrorInfo);
+BaseType_t comm_Out_SendTask_ErrorInfoQueueEmit(sError_Info * pErrorInfo, uint32_t timeout);
+BaseType_t comm_Out_SendTask_ErrorInfoQueueEmitFromISR(sError_Info * pErrorInfo);
+"""
+
+STUB_C = r"""
+#include "error.c" /* 直接访问 gError_Stat gError_Rate_Slots */
+
+#define STUB_QUEUE_LOG 8192
+
+typedef struct {
+    uint16_t capacity; /* 队列长度 */
+    uint16_t pending;  /* 队列中项数 */
+    uint32_t total;    /* 入队项数 */
+    uint32_t isr;      /* 中断版本入队项数 */
+    uint32_t lost;     /* 队列满 丢弃项所含次数 */
+    sError_Info log[STUB_QUEUE_LOG];
+} sStub_Queue;
+
+TickType_t stub_tick = 0;
+int32_t stub_critical = 0;
+int32_t stub_critical_max = 0;
+uint32_t stub_critical_put = 0;
+uint8_t stub_debug = 0;
+sStub_Queue stub_queues[2]; /* 0 主串口 1 外串口 */
+
+UBaseType_t stub_critical_enter(void)
+{
+    if (++stub_critical > stub_critical_max) {
+        stub_critical_max = stub_critical;
+    }
+    return 0;
+}
+
+void stub_critical_exit(void)
+{
+    --stub_critical;
+}
+
+uint8_t protocol_Debug_ErrorReport(void)
+{
+    return stub_debug;
+}
+
+static BaseType_t stub_Queue_Put(sStub_Queue * pQueue, sError_Info * pInfo, uint8_t isr)
+{
+    if (stub_critical != 0) { /* 入队不得在临界区内 */
+        ++stub_critical_put;
+    }
+    if (pQueue->pending >= pQueue->capacity) {
+        pQueue->lost += pInfo->count;
+        return pdFAIL;
+    }
+    pQueue->log[pQueue->total % STUB_QUEUE_LOG] = *pInfo;
+    ++pQueue->total;
+    ++pQueue->pending;
+    pQueue->isr += isr;
+    return pdPASS;
+}
+
+BaseType_t comm_Main_SendTask_ErrorInfoQueueEmit(sError_Info * pErrorInfo, uint32_t timeout)
+{
+    return stub_Queue_Put(&stub_queues[0], pErrorInfo, 0);
+}
+
+BaseType_t comm_Main_SendTask_ErrorInfoQueueEmitFromISR(sError_Info * pErrorInfo)
+{
+    return stub_Queue_Put(&stub_queues[0], pErrorInfo, 1);
+}
+
+BaseType_t comm_Out_SendTask_ErrorInfoQueueEmit(sError_Info * pErrorInfo, uint32_t timeout)
+{
+    return stub_Queue_Put(&stub_queues[1], pErrorInfo, 0);
+}
+
+BaseType_t comm_Out_SendTask_ErrorInfoQueueEmitFromISR(sError_Info * pErrorInfo)
+{
+    return stub_Queue_Put(&stub_queues[1], pErrorInfo, 1);
+}
+
+void * stub_stat(void)
+{
+    return &gError_Stat;
+}
+
+void * stub_slots(void)
+{
+    return gError_Rate_Slots;
+}
+
+uint32_t stub_slot_num(void)
+{
+    return ARRAY_LEN(gError_Rate_Slots);
+}
+
+uint32_t stub_window(void)
+{
+    return ERROR_RATE_WINDOW;
+}
+
+void stub_reset(uint16_t capacity)
+{
+    memset(gError_Rate_Slots, 0, sizeof(gError_Rate_Slots));
+    memset(&gError_Stat, 0, sizeof(gError_Stat));
+    memset(stub_queues, 0, sizeof(stub_queues));
+    stub_queues[0].capacity = capacity;
+    stub_queues[1].capacity = capacity;
+    stub_tick = 0;
+    stub_critical = 0;
+    stub_critical_max = 0;
+    stub_critical_put = 0;
+    stub_debug = 0;
+}
+"""
+
+QUEUE_LENGTH = 16  # COMM_MAIN_ERROR_SEND_QUEU_LENGTH COMM_OUT_ERROR_SEND_QUEU_LENGTH
+QUEUE_LOG = 8192
+DEAL_PERIOD = 100  # soft_timer_Heater_Call_Back 周期 mS
+MAIN, OUT = 0, 1
+
+CODE_STORM = 207  # 托盘电机运动超时 主串口 外串口
+CODE_PERIODIC = (301, 304)  # 上/下加热体温度过高
+CODE_ISR = (3 << 10) | 116  # 主串口DMA异常 附加硬件故障码
+CODE_MAIN_ONLY = 220  # 主串口发送失败 只上送主串口
+CODE_OUT_ONLY = 227  # 外串口发送忙 只上送外串口
+CODE_DEBUG = 1  # 上加热体电机错误调试 不上送
+
+
+class ErrorInfo(ctypes.Structure):
+    _fields_ = [("code", ctypes.c_uint16), ("count", ctypes.c_uint16), ("span", ctypes.c_uint16)]
+
+    def tuple(self):
+        return (self.code, self.count, self.span)
+
+
+class ErrorStat(ctypes.Structure):
+    _fields_ = [(name, ctypes.c_uint32) for name in ("emit", "coalesced", "summary", "dropped", "untracked")]
+
+    def dict(self):
+        return {name: getattr(self, name) for name, _ in self._fields_}
+
+
+class RateSlot(ctypes.Structure):
+    _fields_ = [("code", ctypes.c_uint16), ("count", ctypes.c_uint16), ("start", ctypes.c_uint32)]
+
+
+class StubQueue(ctypes.Structure):
+    _fields_ = [
+        ("capacity", ctypes.c_uint16),
+        ("pending", ctypes.c_uint16),
+        ("total", ctypes.c_uint32),
+        ("isr", ctypes.c_uint32),
+        ("lost", ctypes.c_uint32),
+        ("log", ErrorInfo * QUEUE_LOG),
+    ]
+
+
+def build_library(workdir):
+    with open(os.path.join(workdir, "main.h"), "w") as f:
+        f.write(STUB_MAIN_H)
+    for name in ("comm_main.h", "comm_out.h"):
+        with open(os.path.join(workdir, name), "w") as f:
+            f.write(STUB_COMM_H)
+    stub = os.path.join(workdir, "stub.c")
+    with open(stub, "w") as f:
+        f.write(STUB_C)
+    target = os.path.join(workdir, "liberror.so")
+    cmd = ["gcc", "-shared", "-fPIC", "-fshort-enums", "-Wall", "-Werror", "-I", workdir, "-I", os.path.join(REPO, "Inc"), "-I",
+           os.path.join(REPO, "Src"), stub, "-o", target]
+    subprocess.run(cmd, check=True)
+    return ctypes.CDLL(target)
+
+
+class Harness:
+    def __init__(self, lib):
+        self.lib = lib
+        lib.stub_stat.restype = ctypes.POINTER(ErrorStat)
+        lib.stub_slots.restype = ctypes.POINTER(RateSlot)
+        lib.stub_slot_num.restype = ctypes.c_uint32
+        lib.stub_window.restype = ctypes.c_uint32
+        lib.stub_reset.argtypes = (ctypes.c_uint16,)
+        lib.error_Emit.argtypes = (ctypes.c_uint16,)
+        lib.error_Emit_FromISR.argtypes = (ctypes.c_uint16,)
+        lib.error_Info_Pack.argtypes = (ctypes.POINTER(ErrorInfo), ctypes.POINTER(ctypes.c_uint8))
+        lib.error_Info_Pack.restype = ctypes.c_uint8
+        lib.error_Stat_Pack.restype = ctypes.c_uint8
+        self.stat = lib.stub_stat().contents
+        self.slot_num = lib.stub_slot_num()
+        self.slots = lib.stub_slots()
+        self.window = lib.stub_window()
+        self.queues = (StubQueue * 2).in_dll(lib, "stub_queues")
+        self.tick = ctypes.c_uint32.in_dll(lib, "stub_tick")
+        self.debug = ctypes.c_uint8.in_dll(lib, "stub_debug")
+        self.critical = ctypes.c_int32.in_dll(lib, "stub_critical")
+        self.critical_max = ctypes.c_int32.in_dll(lib, "stub_critical_max")
+        self.critical_put = ctypes.c_uint32.in_dll(lib, "stub_critical_put")
+        self.read = [0, 0]
+
+    def reset(self, capacity=QUEUE_LENGTH, debug=0):
+        self.lib.stub_reset(capacity)
+        self.debug.value = debug
+        self.read = [0, 0]
+
+    def emit(self, code, isr=False):
+        (self.lib.error_Emit_FromISR if isr else self.lib.error_Emit)(code)
+        assert self.critical.value == 0 and self.critical_put.value == 0, "临界区未退出 或在临界区内入队"
+
+    def deal(self):
+        self.lib.error_Rate_Deal()
+        assert self.critical.value == 0 and self.critical_put.value == 0, "临界区未退出 或在临界区内入队"
+
+    def advance(self, ms, deal=True):
+        """推进时间 按 soft_timer 周期调用 error_Rate_Deal"""
+        end = self.tick.value + ms
+        while self.tick.value < end:
+            step = min(DEAL_PERIOD - self.tick.value % DEAL_PERIOD, end - self.tick.value)
+            self.tick.value += step
+            if deal and self.tick.value % DEAL_PERIOD == 0:
+                self.deal()
+
+    def take(self, queue=MAIN, num=None):
+        """取出队列中的项 (串口发送任务)"""
+        q = self.queues[queue]
+        num = q.pending if num is None else min(num, q.pending)
+        items = [q.log[(self.read[queue] + i) % QUEUE_LOG].tuple() for i in range(num)]
+        self.read[queue] += num
+        q.pending -= num
+        return items
+
+    def pack(self, info):
+        buf = (ctypes.c_uint8 * 8)()
+        length = self.lib.error_Info_Pack(ctypes.byref(ErrorInfo(*info)), buf)
+        return bytes(buf[:length])
+
+    def slot(self, code):
+        for i in range(self.slot_num):
+            if self.slots[i].code == code:
+                return self.slots[i]
+        return None
+
+
+def test_single(h):
+    h.reset(debug=1)
+    h.emit(CODE_STORM)
+    assert h.take(MAIN) == [(CODE_STORM, 1, 0)] and h.take(OUT) == [(CODE_STORM, 1, 0)], "首次直接上送 主串口 外串口"
+    assert h.stat.dict() == dict(emit=1, coalesced=0, summary=0, dropped=0, untracked=0), h.stat.dict()
+    assert h.pack((CODE_STORM, 1, 0)) == CODE_STORM.to_bytes(2, "little"), "单次上送 2 字节"
+    slot = h.slot(CODE_STORM)
+    assert slot is not None and slot.count == 0 and slot.start == 0, "开启窗口"
+
+
+def test_coalesce(h):
+    h.reset()
+    h.emit(CODE_STORM)
+    for _ in range(9):
+        h.advance(50)
+        h.emit(CODE_STORM)
+    assert h.take() == [(CODE_STORM, 1, 0)], "窗口内重复不上送"
+    assert h.stat.coalesced == 9 and h.slot(CODE_STORM).count == 9
+    h.advance(h.window - h.tick.value - DEAL_PERIOD)
+    assert h.take() == [], "窗口结束前不上送合并帧"
+    h.advance(DEAL_PERIOD)
+    summary = h.take()
+    assert summary == [(CODE_STORM, 9, h.window)], "窗口结束 合并帧 {}".format(summary)
+    assert h.stat.summary == 1 and h.stat.emit == 10
+    expect = b"".join(v.to_bytes(2, "little") for v in summary[0])
+    assert h.pack(summary[0]) == expect, "合并上送 错误码 + 次数 + 时段 6 字节"
+
+
+def test_rollover(h):
+    h.reset()
+    h.emit(CODE_STORM)
+    h.advance(10)
+    h.emit(CODE_STORM)
+    h.advance(h.window - 10)
+    assert h.take() == [(CODE_STORM, 1, 0), (CODE_STORM, 1, h.window)], "第一窗口"
+    for _ in range(4):  # 第二窗口 持续重复
+        h.advance(200)
+        h.emit(CODE_STORM)
+    h.advance(2 * h.window - h.tick.value)
+    assert h.take() == [(CODE_STORM, 4, h.window)], "第二窗口 下一窗口起于合并上送时刻"
+    assert h.slot(CODE_STORM).start == 2 * h.window
+    h.advance(h.window)  # 第三窗口 无重复
+    assert h.take() == [] and h.slot(CODE_STORM) is None, "无合并次数 释放记录槽"
+    h.advance(50)
+    h.emit(CODE_STORM)
+    assert h.take() == [(CODE_STORM, 1, 0)], "释放后 首次直接上送"
+    assert h.stat.dict() == dict(emit=7, coalesced=5, summary=2, dropped=0, untracked=0), h.stat.dict()
+
+
+def test_rollover_late_deal(h):
+    h.reset()
+    h.emit(CODE_STORM)
+    h.advance(h.window + 50, deal=False)  # 窗口已结束 error_Rate_Deal 未执行
+    h.emit(CODE_STORM)
+    assert h.take() == [(CODE_STORM, 1, 0), (CODE_STORM, 1, 0)], "无合并次数 窗口结束后重复 开启新窗口"
+    assert h.slot(CODE_STORM).start == h.window + 50
+    h.advance(10, deal=False)
+    h.emit(CODE_STORM)
+    h.advance(2 * h.window, deal=False)
+    h.emit(CODE_STORM)
+    assert h.take() == [] and h.slot(CODE_STORM).count == 2, "有合并次数 须等待合并上送 不得开启新窗口"
+    h.deal()
+    span = h.tick.value - (h.window + 50)
+    assert h.take() == [(CODE_STORM, 2, span)], "合并时段按实际间隔"
+
+
+def test_saturate(h):
+    h.reset()
+    for _ in range(70000):
+        h.lib.error_Emit(CODE_STORM)
+    h.advance(70000, deal=False)
+    h.deal()
+    assert h.take() == [(CODE_STORM, 1, 0), (CODE_STORM, 0xFFFF, 0xFFFF)], "合并次数与时段 饱和于 65535"
+    assert h.stat.coalesced == 69999 and h.stat.emit == 70000
+
+
+def test_slot_full(h):
+    h.reset(capacity=QUEUE_LOG)
+    codes = [200 + i for i in range(h.slot_num + 2)]
+    for code in codes:
+        h.emit(code)
+    assert h.stat.untracked == 2 and all(h.slot(c) for c in codes[:h.slot_num]), "记录槽满 超出部分不限流"
+    for code in codes:
+        h.emit(code)
+    items = h.take()
+    extra = codes[h.slot_num:]
+    assert items == [(c, 1, 0) for c in codes] + [(c, 1, 0) for c in extra], "不限流 每次直接上送单次帧"
+    assert h.stat.dict() == dict(emit=2 * len(codes), coalesced=h.slot_num, summary=0, dropped=0, untracked=4), h.stat.dict()
+    h.advance(h.window)
+    assert sorted(h.take()) == [(c, 1, h.window) for c in codes[:h.slot_num]], "记录槽内的错误码 窗口结束合并上送"
+    h.advance(h.window)
+    assert all(h.slots[i].code == 0 for i in range(h.slot_num)), "无合并次数 全部释放"
+    h.emit(extra[0])
+    h.emit(extra[0])
+    assert h.take() == [(extra[0], 1, 0)] and h.stat.untracked == 4, "释放后 原超出错误码进入限流"
+
+
+def test_queue_full(h):
+    h.reset(capacity=2, debug=1)
+    for code in (200, 201, 202):
+        h.emit(code)
+    assert h.stat.dropped == 2, "第三帧 主串口 外串口 各丢弃一次"
+    for _ in range(5):
+        h.emit(200)
+    h.advance(h.window)
+    assert h.stat.summary == 1 and h.stat.dropped == 4, "合并帧 队列满同样计入丢弃"
+    assert h.queues[MAIN].lost == 1 + 5 and h.queues[OUT].lost == 1 + 5, "丢弃项所含次数"
+    assert h.take(MAIN) == [(200, 1, 0), (201, 1, 0)]
+
+
+def test_out_mark(h):
+    for debug in (0, 1):
+        h.reset(debug=debug)
+        h.emit(CODE_MAIN_ONLY)
+        h.emit(CODE_OUT_ONLY)
+        h.emit(CODE_DEBUG)
+        assert h.take(MAIN) == [(CODE_MAIN_ONLY, 1, 0)], "外串口故障不上送主串口 调试错误不上送"
+        assert h.take(OUT) == ([(CODE_OUT_ONLY, 1, 0)] if debug else []), "外串口 仅错误上送调试使能时"
+        assert h.stat.emit == 2, "不上送的错误码 不计入统计"
+
+
+def test_isr(h):
+    h.reset(debug=1)
+    h.emit(CODE_ISR, isr=True)
+    for _ in range(2000):
+        h.emit(CODE_ISR, isr=True)
+    assert h.queues[MAIN].isr == 1 and h.queues[OUT].isr == 1, "中断版本入队"
+    assert h.stat.coalesced == 2000 and h.critical_max.value == 1, "临界区不嵌套"
+    h.advance(h.window)
+    assert h.take(MAIN) == [(CODE_ISR, 1, 0), (CODE_ISR, 2000, h.window)]
+
+
+def test_stat_pack(h):
+    h.reset(capacity=1)
+    for code in (200, 200, 201):
+        h.emit(code)
+    buf = (ctypes.c_uint8 * 32)()
+    length = h.lib.error_Stat_Pack(buf)
+    stat = h.stat.dict()
+    expect = bytes((0x0E,)) + b"".join(stat[k].to_bytes(4, "little") for k in ("emit", "coalesced", "summary", "dropped", "untracked"))
+    assert bytes(buf[:length]) == expect, "统计打包 标识 + 5 x 4 字节"
+    assert stat == dict(emit=3, coalesced=1, summary=0, dropped=1, untracked=0), stat
+    h.lib.error_Stat_Clear()
+    assert h.stat.dict() == dict(emit=0, coalesced=0, summary=0, dropped=0, untracked=0), "清零"
+
+
+def test_storm(h, rng, args):
+    """持续风暴 周期故障 中断突发 种类溢出 主串口每 --drain mS 发送一帧"""
+    h.reset(debug=1)
+    distinct = [c for c in range(200, 250) if c not in (CODE_STORM, 219, 220, 221, 227, 228, 229)][:2 * h.slot_num]
+    emitted = {}
+    storm_end = 1000 + args.storm_ms
+    next_storm = 1000.0
+
+    def emit(code, isr=False):
+        h.emit(code, isr)
+        emitted[code] = emitted.get(code, 0) + 1
+
+    got = {}
+    frames = 0
+    while h.tick.value < args.duration + 2 * h.window:
+        now = h.tick.value
+        if now < args.duration:
+            while 1000 <= next_storm <= now and next_storm < storm_end:
+                emit(CODE_STORM, rng.random() < 0.5)
+                next_storm += 1000 / args.storm_rate
+            if now % 100 == 0:
+                for code in CODE_PERIODIC:
+                    emit(code)
+            if 3000 <= now < 3200:
+                for _ in range(10):
+                    emit(CODE_ISR, True)
+            if now == 8000:
+                for code in distinct:
+                    emit(code)
+        if now % args.drain == 0:
+            for code, count, _ in h.take(MAIN, 1):
+                got[code] = got.get(code, 0) + count
+                frames += 1
+        h.advance(1)
+    for code, count, _ in h.take(MAIN):
+        got[code] = got.get(code, 0) + count
+        frames += 1
+
+    stat = h.stat.dict()
+    codes = len(emitted)
+    bound = codes * (1 + int(args.duration // h.window) + 2)
+    lost = h.queues[MAIN].lost
+    assert stat["emit"] == sum(emitted.values()), "提交次数"
+    assert sum(got.values()) + lost == stat["emit"], "收到次数 {} + 丢弃次数 {} != 提交次数 {}".format(sum(got.values()), lost, stat["emit"])
+    assert all(got.get(c, 0) <= n for c, n in emitted.items()), "各错误码 收到次数不超过提交次数"
+    assert lost or all(got.get(c, 0) == n for c, n in emitted.items()), "无丢弃时 各错误码次数完整"
+    assert stat["untracked"] >= len(distinct) - h.slot_num, "种类溢出 不限流"
+    assert frames <= bound, "错误帧 {} 超过上限 {}".format(frames, bound)
+    return "提交 {emit} 错误帧 {frames} (不限流时 {emit}) 合并 {coalesced} 合并帧 {summary} 丢弃 {dropped} 未限流 {untracked}".format(frames=frames, **stat)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="故障上送 限流合并测试 (Src/error.c 桩队列)")
+    parser.add_argument("--duration", type=int, default=20000, help="风暴测试时长 mS")
+    parser.add_argument("--storm-rate", type=float, default=500, help="持续风暴 次/S")
+    parser.add_argument("--storm-ms", type=int, default=5000, help="持续风暴 时长 mS")
+    parser.add_argument("--drain", type=int, default=2, help="主串口 每 N mS 发送一帧错误信息")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+    rng = random.Random(args.seed)
+
+    with tempfile.TemporaryDirectory() as workdir:
+        h = Harness(build_library(workdir))
+        tests = (
+            ("单次上送", lambda: test_single(h)),
+            ("窗口内合并", lambda: test_coalesce(h)),
+            ("窗口滚动", lambda: test_rollover(h)),
+            ("窗口结束未处理", lambda: test_rollover_late_deal(h)),
+            ("次数时段饱和", lambda: test_saturate(h)),
+            ("记录槽满", lambda: test_slot_full(h)),
+            ("队列满", lambda: test_queue_full(h)),
+            ("上送串口", lambda: test_out_mark(h)),
+            ("中断版本", lambda: test_isr(h)),
+            ("统计打包", lambda: test_stat_pack(h)),
+            ("风暴", lambda: test_storm(h, rng, args)),
+        )
+        failed = 0
+        for title, fun in tests:
+            try:
+                extra = fun()
+                print("通过 {}{}".format(title, " " + extra if extra else ""))
+            except AssertionError as e:
+                failed += 1
+                print("失败 {} {}".format(title, e))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,366 @@
+/**
+ * @file    protocol_bench.c
+ * @brief   主机构建 0x69 0xAA 串口协议 吞吐与延时基准
+ *
+ * 固件 main 在主机上运行 发送队列 发送任务 重发 ACK 等待 与接收中断拼包 均为固件源码与 FreeRTOS 队列
+ *     启动就绪 (版本信息帧) 后 生产者事件按给定速率 (0 为队列有空位即投入) 调用 comm_*_SendTask_QueueEmitWithBuild_FromISR
+ *     数据帧为采集数据帧 (0xB3) 数据前 2 字节为序号 (小端) 对端按序号去重与计时
+ *     对端按丢帧率丢弃数据帧 (不回应) 按 ACK 丢失率收下但不回应 其余帧 (温度 错误 版本) 照常回应
+ * 统计 (虚拟时间)
+ *     帧/S          对端收下的不同序号帧数 / 时长 时长为首帧投入至最后一帧有结果
+ *     有效载荷速率  对端去重后收到的数据字节 / 时长
+ *     ACK 延时      首次发出至 ACK 到达控制板 p50 p99 (含重发)
+ *     排队延时      投入队列至 ACK 到达控制板 p50 p99
+ *     重发 失败     对端收到的副本数 - 帧数 3 次均无 ACK 的帧数 对端收下的重复帧
+ *     线路占用      控制板发出字节 * 字节时间 / 时长
+ * 选项 -l 串口 out (UART5 默认) main (USART1) -f 帧数 (默认 2000) -p 数据长度 (默认 32 2～248) -r 速率 帧/S (默认 0)
+ *      -L 丢帧率 % -A ACK 丢失率 % -s 随机种子
+ * 结果按行输出 JSON 无丢失时 要求全部帧一次送达 有丢失时 要求全部帧有结果
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "main.h"
+#include "protocol.h"
+#include "comm_out.h"
+#include "comm_main.h"
+#include "host_model.h"
+
+/* Private define ------------------------------------------------------------*/
+#define PROTOCOL_BENCH_SETTLE (500 * HOST_NS_PER_MS) /* 版本信息帧后 开始投入前等待 */
+#define PROTOCOL_BENCH_POLL (1 * HOST_NS_PER_MS)     /* 队列满时 再次尝试间隔 */
+#define PROTOCOL_BENCH_RETRY_NUM 3                   /* 发送任务 重发次数 与 COMM_*_SER_TX_RETRY_NUM 一致 */
+#define PROTOCOL_BENCH_FRAMES_MAX 65535              /* 序号 2 字节 */
+#define PROTOCOL_BENCH_ACK_LENGTH 8                  /* ACK 帧长度 */
+
+/* Private typedef -----------------------------------------------------------*/
+/* 单帧记录 */
+typedef struct {
+    uint64_t enqueue; /* 投入队列时刻 */
+    uint64_t first;   /* 首个副本发出时刻 */
+    uint64_t ack;     /* ACK 到达控制板时刻 */
+    uint8_t copies;   /* 对端收到副本数 */
+    uint8_t accepted; /* 对端收下次数 */
+} sProtocol_Bench_Frame;
+
+/* 串口 */
+typedef struct {
+    const char * name;
+    USART_TypeDef * uart;
+    UBaseType_t (*free)(void);
+    BaseType_t (*emit)(uint8_t cmdType, uint8_t * pData, uint8_t length);
+} sProtocol_Bench_Link;
+
+/* Private constants ---------------------------------------------------------*/
+static const sProtocol_Bench_Link cProtocol_Bench_Links[] = {
+    {"out", UART5, comm_Out_SendTask_Queue_GetFree_FromISR, comm_Out_SendTask_QueueEmitWithBuild_FromISR},
+    {"main", USART1, comm_Main_SendTask_Queue_GetFree_FromISR, comm_Main_SendTask_QueueEmitWithBuild_FromISR},
+};
+
+/* Private variables ---------------------------------------------------------*/
+static const sProtocol_Bench_Link * gProtocol_Bench_Link = &cProtocol_Bench_Links[0];
+static sHost_Peer gProtocol_Bench_Peer;
+static sProtocol_Bench_Frame * gProtocol_Bench_Frames = NULL;
+static uint32_t gProtocol_Bench_Total = 2000;
+static uint8_t gProtocol_Bench_Payload = 32;
+static double gProtocol_Bench_Rate = 0;       /* 帧/S 0 为尽快 */
+static double gProtocol_Bench_Loss = 0;       /* 丢帧率 % */
+static double gProtocol_Bench_Ack_Loss = 0;   /* ACK 丢失率 % */
+static uint64_t gProtocol_Bench_Start = 0;    /* 首帧投入时刻 */
+static uint64_t gProtocol_Bench_End = 0;      /* 最后一帧有结果时刻 */
+static uint32_t gProtocol_Bench_Sent = 0;     /* 已投入帧数 */
+static uint32_t gProtocol_Bench_Done = 0;     /* 已有结果帧数 */
+static uint64_t gProtocol_Bench_Bytes = 0;    /* 控制板发出字节数 */
+static uint64_t gProtocol_Bench_Goodput = 0;  /* 去重后数据字节 */
+static uint32_t gProtocol_Bench_Dropped = 0;  /* 对端丢弃数据帧 */
+static uint32_t gProtocol_Bench_Ack_Lost = 0; /* 对端未回应 ACK */
+static uint32_t gProtocol_Bench_Others = 0;   /* 非数据帧 */
+static clock_t gProtocol_Bench_Cpu = 0;       /* 主机处理器时间 起点 */
+
+/* Private function prototypes -----------------------------------------------*/
+int firmware_main(void);
+
+/* Private user code ---------------------------------------------------------*/
+
+/**
+ * @brief  概率事件
+ * @param  percent 概率 %
+ * @retval 1 发生
+ */
+static uint8_t protocol_Bench_Chance(double percent)
+{
+    return percent > 0 && rand() < percent / 100 * ((double)RAND_MAX + 1);
+}
+
+/**
+ * @brief  排序比较
+ * @param  a 元素
+ * @param  b 元素
+ * @retval 比较结果
+ */
+static int protocol_Bench_Compare(const void * a, const void * b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief  百分位
+ * @param  pValues 已排序数值
+ * @param  num 个数
+ * @param  p 百分位 0～1
+ * @retval 数值 mS
+ */
+static double protocol_Bench_Percentile(const uint64_t * pValues, uint32_t num, double p)
+{
+    uint32_t i = num * p;
+
+    if (num == 0) {
+        return 0;
+    }
+    return pValues[(i < num) ? (i) : (num - 1)] / 1e6;
+}
+
+/**
+ * @brief  结束
+ * @param  pass 1 通过
+ * @param  reason 失败原因
+ * @retval None
+ */
+static void protocol_Bench_Finish(uint8_t pass, const char * reason)
+{
+    sProtocol_Bench_Frame * pFrame;
+    uint64_t *pAck, *pQueue;
+    uint32_t i, acked = 0, delivered = 0, copies = 0, failed = 0, dup = 0;
+    double elapsed;
+
+    pAck = malloc(sizeof(uint64_t) * gProtocol_Bench_Total);
+    pQueue = malloc(sizeof(uint64_t) * gProtocol_Bench_Total);
+    for (i = 0; i < gProtocol_Bench_Sent; ++i) {
+        pFrame = &gProtocol_Bench_Frames[i];
+        copies += pFrame->copies;
+        if (pFrame->accepted == 0) {
+            failed += (pFrame->copies >= PROTOCOL_BENCH_RETRY_NUM);
+            continue;
+        }
+        ++delivered;
+        dup += pFrame->accepted - 1;
+        if (pFrame->ack > 0) {
+            pAck[acked] = pFrame->ack - pFrame->first;
+            pQueue[acked] = pFrame->ack - pFrame->enqueue;
+            ++acked;
+        }
+    }
+    qsort(pAck, acked, sizeof(uint64_t), protocol_Bench_Compare);
+    qsort(pQueue, acked, sizeof(uint64_t), protocol_Bench_Compare);
+    if (gProtocol_Bench_End <= gProtocol_Bench_Start) {
+        gProtocol_Bench_End = host_Time_Now();
+    }
+    elapsed = (gProtocol_Bench_End > gProtocol_Bench_Start) ? ((gProtocol_Bench_End - gProtocol_Bench_Start) / 1e9) : (1);
+
+    printf("{\"bench\": \"protocol\", \"pass\": %s, \"link\": \"%s\", \"frames\": %u, \"payload\": %u, \"rate\": %.1f, \"loss\": %.2f, \"ack_loss\": %.2f, "
+           "\"elapsed_s\": %.3f, \"fps\": %.1f, \"goodput\": %.0f, \"ack_p50_ms\": %.3f, \"ack_p99_ms\": %.3f, \"queue_p50_ms\": %.3f, "
+           "\"queue_p99_ms\": %.3f, \"retrans\": %u, \"failed\": %u, \"dup\": %u, \"dropped\": %u, \"ack_lost\": %u, \"others\": %u, \"util\": %.4f, "
+           "\"cpu_ms\": %.1f, \"crc_errors\": %u, \"reason\": \"%s\"}\n",
+           pass ? "true" : "false", gProtocol_Bench_Link->name, gProtocol_Bench_Total, gProtocol_Bench_Payload, gProtocol_Bench_Rate, gProtocol_Bench_Loss,
+           gProtocol_Bench_Ack_Loss, elapsed, delivered / elapsed, gProtocol_Bench_Goodput / elapsed, protocol_Bench_Percentile(pAck, acked, 0.5),
+           protocol_Bench_Percentile(pAck, acked, 0.99), protocol_Bench_Percentile(pQueue, acked, 0.5), protocol_Bench_Percentile(pQueue, acked, 0.99),
+           copies - gProtocol_Bench_Sent, failed, dup, gProtocol_Bench_Dropped, gProtocol_Bench_Ack_Lost, gProtocol_Bench_Others,
+           gProtocol_Bench_Bytes * host_Uart_Byte_Time(gProtocol_Bench_Link->uart) / 1e9 / elapsed,
+           (clock() - gProtocol_Bench_Cpu) * 1000.0 / CLOCKS_PER_SEC, gProtocol_Bench_Peer.crc_errors, reason);
+    free(pAck);
+    free(pQueue);
+    host_Board_Exit(pass ? 0 : 1);
+}
+
+/**
+ * @brief  帧有结果 (首次收下 或 最后一次重发被丢弃)
+ * @param  None
+ * @retval None
+ */
+static void protocol_Bench_Resolve(void)
+{
+    uint32_t i;
+
+    gProtocol_Bench_End = host_Time_Now();
+    if (++gProtocol_Bench_Done < gProtocol_Bench_Total) {
+        return;
+    }
+    if (gProtocol_Bench_Loss == 0 && gProtocol_Bench_Ack_Loss == 0) {
+        for (i = 0; i < gProtocol_Bench_Total; ++i) {
+            if (gProtocol_Bench_Frames[i].copies != 1) {
+                protocol_Bench_Finish(0, "retransmission without loss");
+            }
+        }
+    }
+    protocol_Bench_Finish(1, "");
+}
+
+/**
+ * @brief  生产者 投入一帧
+ * @param  arg 未使用
+ * @retval None
+ */
+static void protocol_Bench_Produce(void * arg)
+{
+    uint8_t data[COMM_OUT_SER_TX_SIZE];
+    uint8_t i;
+
+    if (gProtocol_Bench_Sent >= gProtocol_Bench_Total) {
+        return;
+    }
+    if (gProtocol_Bench_Link->free() == 0) { /* 队列满 */
+        host_Event_After(PROTOCOL_BENCH_POLL, protocol_Bench_Produce, NULL);
+        return;
+    }
+    data[0] = gProtocol_Bench_Sent & 0xFF;
+    data[1] = gProtocol_Bench_Sent >> 8;
+    for (i = 2; i < gProtocol_Bench_Payload; ++i) {
+        data[i] = gProtocol_Bench_Sent + i;
+    }
+    if (gProtocol_Bench_Link->emit(eProtocolRespPack_Client_SAMP_DATA, data, gProtocol_Bench_Payload) != pdPASS) {
+        host_Event_After(PROTOCOL_BENCH_POLL, protocol_Bench_Produce, NULL);
+        return;
+    }
+    if (gProtocol_Bench_Sent == 0) {
+        gProtocol_Bench_Start = host_Time_Now();
+    }
+    gProtocol_Bench_Frames[gProtocol_Bench_Sent++].enqueue = host_Time_Now();
+    host_Event_After((gProtocol_Bench_Rate > 0) ? ((uint64_t)(HOST_NS_PER_S / gProtocol_Bench_Rate)) : (0), protocol_Bench_Produce, NULL);
+}
+
+/**
+ * @brief  对端 收到帧
+ * @note   回调时刻为帧最后一字节到达 ACK 到达控制板再经 ACK 帧长度字节时间
+ * @param  arg 未使用
+ * @param  pFrame 帧
+ * @param  length 帧长度
+ * @retval None
+ */
+static void protocol_Bench_Peer_Frame(void * arg, const uint8_t * pFrame, uint16_t length)
+{
+    sProtocol_Bench_Frame * pBench;
+    uint64_t byte_time = host_Uart_Byte_Time(gProtocol_Bench_Link->uart);
+    uint16_t seq;
+
+    gProtocol_Bench_Bytes += length;
+    if (pFrame[5] == eProtocolRespPack_Client_ACK) {
+        return;
+    }
+    if (pFrame[5] == eProtocolRespPack_Client_VER && gProtocol_Bench_Sent == 0 && gProtocol_Bench_Start == 0) {
+        host_Event_Cancel(protocol_Bench_Produce, NULL);
+        host_Event_After(PROTOCOL_BENCH_SETTLE, protocol_Bench_Produce, NULL);
+    }
+    if (pFrame[5] != eProtocolRespPack_Client_SAMP_DATA || length != gProtocol_Bench_Payload + 7) {
+        ++gProtocol_Bench_Others;
+        host_Peer_Ack(&gProtocol_Bench_Peer, pFrame[3]);
+        return;
+    }
+
+    seq = pFrame[6] | (pFrame[7] << 8);
+    if (seq >= gProtocol_Bench_Sent) { /* 非本基准投入 */
+        ++gProtocol_Bench_Others;
+        host_Peer_Ack(&gProtocol_Bench_Peer, pFrame[3]);
+        return;
+    }
+    pBench = &gProtocol_Bench_Frames[seq];
+    if (pBench->copies++ == 0) {
+        pBench->first = host_Time_Now() - byte_time * length;
+    }
+    if (protocol_Bench_Chance(gProtocol_Bench_Loss)) { /* 丢帧 */
+        ++gProtocol_Bench_Dropped;
+        if (pBench->accepted == 0 && pBench->copies == PROTOCOL_BENCH_RETRY_NUM) {
+            protocol_Bench_Resolve();
+        }
+        return;
+    }
+    if (protocol_Bench_Chance(gProtocol_Bench_Ack_Loss)) { /* ACK 丢失 */
+        ++gProtocol_Bench_Ack_Lost;
+    } else {
+        host_Peer_Ack(&gProtocol_Bench_Peer, pFrame[3]);
+        pBench->ack = host_Time_Now() + byte_time * PROTOCOL_BENCH_ACK_LENGTH;
+    }
+    if (pBench->accepted++ == 0) {
+        gProtocol_Bench_Goodput += gProtocol_Bench_Payload;
+        protocol_Bench_Resolve();
+    }
+}
+
+/**
+ * @brief  超时
+ * @param  arg 未使用
+ * @retval None
+ */
+static void protocol_Bench_Timeout(void * arg)
+{
+    if (gProtocol_Bench_Sent == 0) {
+        protocol_Bench_Finish(0, "no version frame");
+    }
+    protocol_Bench_Finish(0, "frames unresolved");
+}
+
+int main(int argc, char * argv[])
+{
+    int opt, payload = gProtocol_Bench_Payload;
+    uint8_t i;
+
+    while ((opt = getopt(argc, argv, "l:f:p:r:L:A:s:")) != -1) {
+        switch (opt) {
+            case 'l':
+                for (i = 0; i < ARRAY_LEN(cProtocol_Bench_Links); ++i) {
+                    if (strcmp(optarg, cProtocol_Bench_Links[i].name) == 0) {
+                        gProtocol_Bench_Link = &cProtocol_Bench_Links[i];
+                        break;
+                    }
+                }
+                if (i >= ARRAY_LEN(cProtocol_Bench_Links)) {
+                    fprintf(stderr, "link out or main\n");
+                    return 2;
+                }
+                break;
+            case 'f':
+                gProtocol_Bench_Total = strtoul(optarg, NULL, 0);
+                break;
+            case 'p':
+                payload = atoi(optarg);
+                break;
+            case 'r':
+                gProtocol_Bench_Rate = atof(optarg);
+                break;
+            case 'L':
+                gProtocol_Bench_Loss = atof(optarg);
+                break;
+            case 'A':
+                gProtocol_Bench_Ack_Loss = atof(optarg);
+                break;
+            case 's':
+                srand(strtoul(optarg, NULL, 0));
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-l out|main] [-f frames] [-p payload] [-r rate] [-L loss%%] [-A ack_loss%%] [-s seed]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (gProtocol_Bench_Total == 0 || gProtocol_Bench_Total > PROTOCOL_BENCH_FRAMES_MAX || payload < 2 || payload > COMM_OUT_SER_TX_SIZE - 7 || /* 帧数 长度 */
+        gProtocol_Bench_Rate < 0 || gProtocol_Bench_Loss < 0 || gProtocol_Bench_Loss >= 100 ||                                              /* 速率 丢帧 */
+        gProtocol_Bench_Ack_Loss < 0 || gProtocol_Bench_Ack_Loss >= 100) {                                                                  /* ACK 丢失 */
+        fprintf(stderr, "frames 1..65535 payload 2..248 loss 0..100\n");
+        return 2;
+    }
+    gProtocol_Bench_Payload = payload;
+    gProtocol_Bench_Frames = calloc(gProtocol_Bench_Total, sizeof(sProtocol_Bench_Frame));
+
+    host_Board_Init();
+    host_W25q64_Attach();
+    host_Peer_Attach(&gProtocol_Bench_Peer, gProtocol_Bench_Link->uart, PROTOCOL_DEVICE_ID_MAIN, protocol_Bench_Peer_Frame, NULL);
+    gProtocol_Bench_Peer.auto_ack = 0;
+    host_Event_At((10 + gProtocol_Bench_Total) * HOST_NS_PER_S, protocol_Bench_Timeout, NULL);
+    gProtocol_Bench_Cpu = clock();
+    return firmware_main();
+}
@@ -0,0 +1,353 @@
+/**
+ * @file    sample_bench.c
+ * @brief   主机构建 采样数据记录 (comm_Data_Sample_Data_Commit) 耗时 与 整个测试耗时基准
+ *
+ * 固件 main 在主机上运行 采样板为 Tools/host/model/sample_board.c 模型 (数据格式 故障注入 见 sHost_Sample_Board_Conf)
+ *     上位机收到版本信息帧后发送开始测量帧 收到首个扫码信息帧后发送测试项信息帧 (6 通道 相同点数)
+ *     protocol.c 对 comm_Data_Sample_Data_Commit 的调用经链接选项 --wrap 计时 (主机单调时钟) 并按返回类型计数
+ *     采样完成帧 (0xB6) 后 在同一上下文连续调用 -N 次 (每次先复制数据帧 混合类型会改写数据帧) 得出单次耗时
+ * 统计
+ *     整个测试耗时  开始测量至采样完成 (虚拟时间)
+ *     首个数据      开始测量至首个采集数据帧到达上位机
+ *     记录          实际路径调用次数 各返回类型次数 平均 最大耗时 nS (主机)
+ *     连续调用      单次耗时 nS 次/S (主机)
+ * 选项 -f 数据格式 u16 u32 mix (默认 u16) -n 各通道点数 (默认 6) -N 连续调用次数 (默认 100000)
+ *      -d 每 N 个数据帧重复一次 -B 每 N 个数据帧长度异常 -O 第 N 次 PD 点数超出记录缓存 -E 第 N 次 PD 错误信息帧 -H 第 N 次 PD 起不再完成采样
+ * 结果按行输出 JSON 无故障注入 (或仅重复帧) 时 要求采样完成 各通道点数齐全 且无记录被拒绝 有故障注入时 要求采样完成 (采样板不再完成采样时 固件等待超时后继续)
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "main.h"
+#include "protocol.h"
+#include "comm_data.h"
+#include "host_model.h"
+
+/* Private define ------------------------------------------------------------*/
+#define SAMPLE_BENCH_CHANNELS 6
+#define SAMPLE_BENCH_TYPES (eComm_Data_Sample_Data_UNKNOW + 1)
+#define SAMPLE_BENCH_ERRORS 16
+
+/* Private constants ---------------------------------------------------------*/
+static const char * const cSample_Bench_Formats[] = {"u16", "u32", "mix"};
+static const uint8_t cSample_Bench_Point_Size[] = {2, 4, 10};    /* 各格式 每点字节数 */
+static const uint8_t cSample_Bench_Max_Points[] = {120, 60, 20}; /* 各格式 记录缓存可容纳点数 */
+
+/* Private variables ---------------------------------------------------------*/
+static sHost_Peer gSample_Bench_Main;
+static sHost_Sample_Board_Conf gSample_Bench_Conf = {0};
+static uint8_t gSample_Bench_Points = 6;
+static uint32_t gSample_Bench_Loops = 100000;
+static uint64_t gSample_Bench_Start = 0;                                  /* 开始测量 发出时刻 */
+static uint64_t gSample_Bench_First_Data = 0;                             /* 首个采集数据帧 时刻 */
+static uint8_t gSample_Bench_Barcodes = 0;                                /* 扫码信息帧数 */
+static uint8_t gSample_Bench_Channel_Points[SAMPLE_BENCH_CHANNELS] = {0}; /* 各通道已收到点数 */
+static uint32_t gSample_Bench_Data_Frames = 0;
+static uint16_t gSample_Bench_Errors[SAMPLE_BENCH_ERRORS];                /* 错误码 按收到顺序 */
+static uint8_t gSample_Bench_Error_Num = 0;
+static uint32_t gSample_Bench_Commits[SAMPLE_BENCH_TYPES] = {0};          /* 实际路径 各返回类型次数 */
+static uint64_t gSample_Bench_Commit_Ns = 0;                              /* 实际路径 累计耗时 */
+static uint64_t gSample_Bench_Commit_Max = 0;                             /* 实际路径 最大耗时 */
+
+/* Private function prototypes -----------------------------------------------*/
+int firmware_main(void);
+eComm_Data_Sample_Data __real_comm_Data_Sample_Data_Commit(uint8_t channel, uint8_t * pBuffer, uint8_t length, uint8_t replace);
+eComm_Data_Sample_Data __wrap_comm_Data_Sample_Data_Commit(uint8_t channel, uint8_t * pBuffer, uint8_t length, uint8_t replace);
+
+/* Private user code ---------------------------------------------------------*/
+
+/**
+ * @brief  主机单调时钟
+ * @param  None
+ * @retval 时刻 nS
+ */
+static uint64_t sample_Bench_Clock(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * @brief  protocol.c 调用的采样数据记录 计时后转入固件实现
+ * @param  channel 通道索引 1～6 pBuffer 数据输入指针 length 数据输入长度
+ * @param  replace 0 不替换 1 替换
+ * @retval 变换结果 eComm_Data_Sample_Data
+ */
+eComm_Data_Sample_Data __wrap_comm_Data_Sample_Data_Commit(uint8_t channel, uint8_t * pBuffer, uint8_t length, uint8_t replace)
+{
+    eComm_Data_Sample_Data result;
+    uint64_t start, spend;
+
+    start = sample_Bench_Clock();
+    result = __real_comm_Data_Sample_Data_Commit(channel, pBuffer, length, replace);
+    spend = sample_Bench_Clock() - start;
+    gSample_Bench_Commit_Ns += spend;
+    if (spend > gSample_Bench_Commit_Max) {
+        gSample_Bench_Commit_Max = spend;
+    }
+    if (result < SAMPLE_BENCH_TYPES) {
+        ++gSample_Bench_Commits[result];
+    }
+    return result;
+}
+
+/**
+ * @brief  连续调用 采样数据记录
+ * @note   通道 1 替换 每次先复制数据帧
+ * @param  None
+ * @retval 单次耗时 nS
+ */
+static double sample_Bench_Loop(void)
+{
+    static uint8_t frame[8 + 256], buffer[8 + 256];
+    uint8_t num, length;
+    uint16_t i;
+    uint32_t loop;
+    uint64_t start;
+
+    num = (gSample_Bench_Points > cSample_Bench_Max_Points[gSample_Bench_Conf.format]) ? (cSample_Bench_Max_Points[gSample_Bench_Conf.format])
+                                                                                        : (gSample_Bench_Points);
+    length = num * cSample_Bench_Point_Size[gSample_Bench_Conf.format];
+    frame[6] = num;
+    frame[7] = 1;
+    for (i = 0; i < length; ++i) {
+        frame[8 + i] = (uint8_t)(i * 7 + 0x35);
+    }
+
+    start = sample_Bench_Clock();
+    for (loop = 0; loop < gSample_Bench_Loops; ++loop) {
+        memcpy(buffer, frame, 8 + length);
+        __real_comm_Data_Sample_Data_Commit(1, buffer, length, 1);
+    }
+    return (gSample_Bench_Loops > 0) ? ((double)(sample_Bench_Clock() - start) / gSample_Bench_Loops) : (0);
+}
+
+/**
+ * @brief  距开始测量时长
+ * @param  time 时刻 0 为未发生
+ * @retval 时长 mS 未发生为 0
+ */
+static double sample_Bench_Elapsed_Ms(uint64_t time)
+{
+    return (time > gSample_Bench_Start) ? ((time - gSample_Bench_Start) / 1e6) : (0);
+}
+
+/**
+ * @brief  结束
+ * @param  pass 1 通过
+ * @param  loop_ns 连续调用 单次耗时 nS 0 为未执行
+ * @param  reason 失败原因
+ * @retval None
+ */
+static void sample_Bench_Finish(uint8_t pass, double loop_ns, const char * reason)
+{
+    uint32_t i, commits = 0;
+
+    for (i = 0; i < SAMPLE_BENCH_TYPES; ++i) {
+        commits += gSample_Bench_Commits[i];
+    }
+    printf("{\"bench\": \"sample\", \"pass\": %s, \"format\": \"%s\", \"points\": %u, \"dup\": %u, \"bad_length\": %u, \"oversize_at\": %u, "
+           "\"error_at\": %u, \"hang_at\": %u, \"end_ms\": %.3f, \"first_data_ms\": %.3f, \"data_frames\": %u, \"board_frames\": %u, "
+           "\"commits\": %u, \"commit_error\": %u, \"commit_u16\": %u, \"commit_u32\": %u, \"commit_mix\": %u, \"commit_unknow\": %u, "
+           "\"commit_avg_ns\": %.1f, \"commit_max_ns\": %lu, \"loops\": %u, \"loop_ns\": %.1f, \"loop_per_s\": %.0f, \"channels\": [",
+           pass ? "true" : "false", cSample_Bench_Formats[gSample_Bench_Conf.format], gSample_Bench_Points, gSample_Bench_Conf.dup,
+           gSample_Bench_Conf.bad_length, gSample_Bench_Conf.oversize_at, gSample_Bench_Conf.error_at, gSample_Bench_Conf.hang_at,
+           sample_Bench_Elapsed_Ms(host_Time_Now()), sample_Bench_Elapsed_Ms(gSample_Bench_First_Data), gSample_Bench_Data_Frames,
+           host_Sample_Board_Data_Frames(), commits, gSample_Bench_Commits[eComm_Data_Sample_Data_ERROR],
+           gSample_Bench_Commits[eComm_Data_Sample_Data_U16], gSample_Bench_Commits[eComm_Data_Sample_Data_U32],
+           gSample_Bench_Commits[eComm_Data_Sample_Data_MIX], gSample_Bench_Commits[eComm_Data_Sample_Data_UNKNOW],
+           (commits > 0) ? ((double)(gSample_Bench_Commit_Ns) / commits) : (0), (unsigned long)(gSample_Bench_Commit_Max),
+           (loop_ns > 0) ? (gSample_Bench_Loops) : (0), loop_ns, (loop_ns > 0) ? (1e9 / loop_ns) : (0));
+    for (i = 0; i < SAMPLE_BENCH_CHANNELS; ++i) {
+        printf("%s%u", (i > 0) ? ", " : "", gSample_Bench_Channel_Points[i]);
+    }
+    printf("], \"errors\": [");
+    for (i = 0; i < gSample_Bench_Error_Num; ++i) {
+        printf("%s%u", (i > 0) ? ", " : "", gSample_Bench_Errors[i]);
+    }
+    printf("], \"crc_errors\": %u, \"reason\": \"%s\"}\n", gSample_Bench_Main.crc_errors, reason);
+    host_Board_Exit(pass ? 0 : 1);
+}
+
+/**
+ * @brief  是否注入会丢失数据的故障
+ * @note   重复帧按帧号丢弃 不影响数据完整
+ * @param  None
+ * @retval 1 有故障注入
+ */
+static uint8_t sample_Bench_Faulty(void)
+{
+    return gSample_Bench_Conf.bad_length > 0 || gSample_Bench_Conf.oversize_at > 0 || gSample_Bench_Conf.error_at > 0 || gSample_Bench_Conf.hang_at > 0;
+}
+
+/**
+ * @brief  采样完成 检查结果 连续调用
+ * @param  None
+ * @retval None
+ */
+static void sample_Bench_Over(void)
+{
+    uint8_t i;
+    double loop_ns;
+
+    loop_ns = sample_Bench_Loop();
+    if (sample_Bench_Faulty()) {
+        sample_Bench_Finish(1, loop_ns, "");
+    }
+    for (i = 0; i < SAMPLE_BENCH_CHANNELS; ++i) {
+        if (gSample_Bench_Channel_Points[i] != gSample_Bench_Points) {
+            sample_Bench_Finish(0, loop_ns, "channel points incomplete");
+        }
+    }
+    if (gSample_Bench_Commits[eComm_Data_Sample_Data_ERROR] > 0) {
+        sample_Bench_Finish(0, loop_ns, "commit rejected");
+    }
+    sample_Bench_Finish(1, loop_ns, "");
+}
+
+/**
+ * @brief  发送测试项信息帧
+ * @note   6 通道 终点法 610nm 点数相同
+ * @param  None
+ * @retval None
+ */
+static void sample_Bench_Send_Config(void)
+{
+    uint8_t conf[3 * SAMPLE_BENCH_CHANNELS];
+    uint8_t i;
+
+    for (i = 0; i < SAMPLE_BENCH_CHANNELS; ++i) {
+        conf[3 * i + 0] = eComm_Data_Sample_Assay_EndPoint;
+        conf[3 * i + 1] = eComm_Data_Sample_Radiant_610;
+        conf[3 * i + 2] = gSample_Bench_Points;
+    }
+    host_Peer_Send(&gSample_Bench_Main, eProtocolEmitPack_Client_CMD_CONFIG, conf, sizeof(conf));
+}
+
+/**
+ * @brief  上位机 收到帧
+ * @param  arg 未使用
+ * @param  pFrame 帧
+ * @param  length 帧长度
+ * @retval None
+ */
+static void sample_Bench_Main_Frame(void * arg, const uint8_t * pFrame, uint16_t length)
+{
+    switch (pFrame[5]) {
+        case eProtocolRespPack_Client_VER:
+            if (gSample_Bench_Start == 0) {
+                gSample_Bench_Start = host_Time_Now();
+                host_Peer_Send(&gSample_Bench_Main, eProtocolEmitPack_Client_CMD_START, NULL, 0);
+            }
+            break;
+        case eProtocolRespPack_Client_BARCODE:
+            if (gSample_Bench_Barcodes++ == 0) {
+                sample_Bench_Send_Config();
+            }
+            break;
+        case eProtocolRespPack_Client_SAMP_DATA: /* 点数 通道 数据 */
+            if (gSample_Bench_First_Data == 0) {
+                gSample_Bench_First_Data = host_Time_Now();
+            }
+            ++gSample_Bench_Data_Frames;
+            if (pFrame[7] >= 1 && pFrame[7] <= SAMPLE_BENCH_CHANNELS) {
+                gSample_Bench_Channel_Points[pFrame[7] - 1] = pFrame[6];
+            }
+            break;
+        case eProtocolRespPack_Client_SAMP_OVER:
+            sample_Bench_Over();
+            break;
+        case eProtocolRespPack_Client_ERR: /* 错误码 小端 */
+            if (gSample_Bench_Error_Num < SAMPLE_BENCH_ERRORS) {
+                gSample_Bench_Errors[gSample_Bench_Error_Num++] = pFrame[6] | (pFrame[7] << 8);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief  超时
+ * @param  arg 未使用
+ * @retval None
+ */
+static void sample_Bench_Timeout(void * arg)
+{
+    if (gSample_Bench_Start == 0) {
+        sample_Bench_Finish(0, 0, "no version frame");
+    }
+    sample_Bench_Finish(0, 0, "sample over not received");
+}
+
+int main(int argc, char * argv[])
+{
+    int opt, points = gSample_Bench_Points;
+    uint8_t i;
+
+    while ((opt = getopt(argc, argv, "f:n:N:d:B:O:E:H:")) != -1) {
+        switch (opt) {
+            case 'f':
+                for (i = 0; i < ARRAY_LEN(cSample_Bench_Formats); ++i) {
+                    if (strcmp(optarg, cSample_Bench_Formats[i]) == 0) {
+                        gSample_Bench_Conf.format = i;
+                        break;
+                    }
+                }
+                if (i >= ARRAY_LEN(cSample_Bench_Formats)) {
+                    fprintf(stderr, "format u16 u32 or mix\n");
+                    return 2;
+                }
+                break;
+            case 'n':
+                points = atoi(optarg);
+                break;
+            case 'N':
+                gSample_Bench_Loops = strtoul(optarg, NULL, 0);
+                break;
+            case 'd':
+                gSample_Bench_Conf.dup = atoi(optarg);
+                break;
+            case 'B':
+                gSample_Bench_Conf.bad_length = atoi(optarg);
+                break;
+            case 'O':
+                gSample_Bench_Conf.oversize_at = atoi(optarg);
+                break;
+            case 'E':
+                gSample_Bench_Conf.error_at = atoi(optarg);
+                break;
+            case 'H':
+                gSample_Bench_Conf.hang_at = atoi(optarg);
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-f u16|u32|mix] [-n points] [-N loops] [-d dup] [-B bad_length] [-O oversize_at] [-E error_at] [-H hang_at]\n",
+                        argv[0]);
+                return 2;
+        }
+    }
+    if (points < 1 || points > cSample_Bench_Max_Points[gSample_Bench_Conf.format]) {
+        fprintf(stderr, "points 1..120 (u16) 1..60 (u32) 1..20 (mix)\n");
+        return 2;
+    }
+    gSample_Bench_Points = points;
+
+    host_Board_Init();
+    host_Gpio_Input(CARD_IN_GPIO_Port, CARD_IN_Pin, 1); /* ID 卡未插入 */
+    host_W25q64_Attach();
+    host_L6470_Attach();
+    host_Drv8824_Attach();
+    host_Se2707_Attach(NULL, "1415190701");
+    host_Sample_Board_Attach();
+    host_Sample_Board_Setup(&gSample_Bench_Conf);
+    host_Peer_Attach(&gSample_Bench_Main, USART1, PROTOCOL_DEVICE_ID_MAIN, sample_Bench_Main_Frame, NULL);
+    host_Event_At((60 + 12 * (uint64_t)gSample_Bench_Points) * HOST_NS_PER_S, sample_Bench_Timeout, NULL);
+    return firmware_main();
+}
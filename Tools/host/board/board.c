@@ -0,0 +1,922 @@
+/**
+ * @file    board.c
+ * @brief   主机构建 板级模型 寄存器窗口 虚拟时间 中断 GPIO 定时器
+ *
+ * 寄存器窗口 启动前按芯片地址映射 内部 Flash 填充 0xFF 其余清零
+ * 虚拟时间推进 (host_Board_Step) 以事件上下文执行 (IPSR 非零) 任务切换推迟到推进结束
+ *     定时器   按 CR1/PSC/ARR/RCR/CNT 寄存器计数 更新事件置 UIF 使能时触发中断 固件修改寄存器后重新计算
+ *     SysTick  按 CTRL/LOAD 寄存器产生节拍异常
+ *     事件     外设模型与对端设备 按时刻排序 同一时刻先到先执行
+ * 中断按 NVIC 使能/优先级 与 BASEPRI/PRIMASK 屏蔽响应 不可响应时挂起 下次推进时响应
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "host_board.h"
+#include "host_hal.h"
+
+/* Private define ------------------------------------------------------------*/
+#define HOST_EXCEPTION_NUM (16 + 96)         /* 异常数 内核 16 + 外部中断 */
+#define HOST_EVENT_EXCEPTION 0xFFFFFFFF      /* 事件上下文 IPSR */
+#define HOST_THREAD_PRIORITY 0x100           /* 线程模式 执行优先级 */
+#define HOST_SYSTICK_PRIORITY 0xF0           /* SysTick 优先级 与 ARM_CM3 移植层一致 最低 */
+#define HOST_GPIO_WATCH_MAX 32               /* GPIO 输出回调上限 */
+#define HOST_TIM_WATCH_MAX 16                /* 定时器更新回调上限 */
+
+/* Private typedef -----------------------------------------------------------*/
+/* 内存窗口 */
+typedef struct {
+    uintptr_t base;
+    size_t size;
+    uint8_t fill;
+} sHost_Window;
+
+/* 事件 */
+typedef struct {
+    uint64_t time;
+    uint64_t seq;
+    host_Event_Fun fun;
+    void * arg;
+} sHost_Event;
+
+/* 定时器 */
+typedef struct {
+    TIM_TypeDef * tim;
+    IRQn_Type irqn;       /* 更新中断 */
+    uint8_t advanced;     /* 高级定时器 有重复计数器 */
+    uint8_t running;      /* 计数中 */
+    uint64_t origin;      /* 计数起点时刻 */
+    uint64_t ticks;       /* 起点计数值 (含重复周期) */
+    uint64_t next;        /* 下次更新事件时刻 */
+    uint32_t psc;         /* 生效中的 PSC 更新事件时装载 */
+    uint32_t arr;         /* 生效中的 ARR 使能预装载时 更新事件时装载 */
+    uint32_t rcr;         /* 生效中的 RCR 更新事件时装载 */
+    uint32_t shadow_cnt;  /* 上次同步时的 CNT 不同时为固件写入 */
+    uint32_t shadow_arr;  /* 上次同步时的 ARR */
+} sHost_Tim;
+
+/* GPIO 输出回调 */
+typedef struct {
+    GPIO_TypeDef * port;
+    uint16_t pins;
+    host_Gpio_Watch_Fun fun;
+    void * arg;
+} sHost_Gpio_Watch;
+
+/* 定时器更新回调 */
+typedef struct {
+    TIM_TypeDef * tim;
+    host_Event_Fun fun;
+    void * arg;
+} sHost_Tim_Watch;
+
+/* Private constants ---------------------------------------------------------*/
+static const sHost_Window cHost_Windows[] = {
+    {FLASH_BASE, 0x100000, 0xFF},             /* 内部 Flash */
+    {0x1FFF0000, 0x10000, 0x00},              /* 系统存储区 OTP UID */
+    {PERIPH_BASE, 0x10070000, 0x00},          /* APB1 APB2 AHB1 AHB2 外设 备份SRAM */
+    {SCS_BASE & 0xFFF00000, 0x100000, 0x00}, /* 内核外设 NVIC SCB SysTick DWT */
+};
+
+/* Private variables ---------------------------------------------------------*/
+static uint64_t gHost_Now = 0;  /* 虚拟时间 nS */
+static uint64_t gHost_Seq = 0;  /* 事件序号 */
+static sHost_Event * gHost_Events = NULL;
+static uint32_t gHost_Event_Num = 0;
+static uint32_t gHost_Event_Cap = 0;
+
+static uint8_t gHost_Pending[HOST_EXCEPTION_NUM];
+static uint32_t gHost_Pending_Num = 0;
+static uint32_t gHost_Active_Priority = HOST_THREAD_PRIORITY;
+static uint8_t gHost_In_Step = 0;
+
+static uint64_t gHost_SysTick_Origin = 0;
+static uint64_t gHost_SysTick_Next = UINT64_MAX;
+static uint32_t gHost_SysTick_Ctrl = 0;
+static uint32_t gHost_SysTick_Load = 0;
+
+static sHost_Tim gHost_Tims[] = {
+    {TIM1, TIM1_UP_TIM10_IRQn, 1},  {TIM2, TIM2_IRQn, 0},          {TIM3, TIM3_IRQn, 0},           {TIM4, TIM4_IRQn, 0},
+    {TIM5, TIM5_IRQn, 0},           {TIM6, TIM6_DAC_IRQn, 0},      {TIM7, TIM7_IRQn, 0},           {TIM8, TIM8_UP_TIM13_IRQn, 1},
+    {TIM9, TIM1_BRK_TIM9_IRQn, 0},  {TIM10, TIM1_UP_TIM10_IRQn, 0}, {TIM11, TIM1_TRG_COM_TIM11_IRQn, 0},
+    {TIM12, TIM8_BRK_TIM12_IRQn, 0}, {TIM13, TIM8_UP_TIM13_IRQn, 0}, {TIM14, TIM8_TRG_COM_TIM14_IRQn, 0},
+};
+
+static sHost_Gpio_Watch gHost_Gpio_Watches[HOST_GPIO_WATCH_MAX];
+static uint8_t gHost_Gpio_Watch_Num = 0;
+static uint16_t gHost_Gpio_Driven[11]; /* GPIOA~GPIOK 外部驱动的引脚 */
+static sHost_Tim_Watch gHost_Tim_Watches[HOST_TIM_WATCH_MAX];
+static uint8_t gHost_Tim_Watch_Num = 0;
+
+uint32_t gHost_PCLK1 = HSI_VALUE; /* APB1 时钟 RCC 桩设置 */
+uint32_t gHost_PCLK2 = HSI_VALUE; /* APB2 时钟 RCC 桩设置 */
+
+/* Private function prototypes -----------------------------------------------*/
+void SysTick_Handler(void) __attribute__((weak));
+void EXTI0_IRQHandler(void) __attribute__((weak));
+void EXTI1_IRQHandler(void) __attribute__((weak));
+void EXTI2_IRQHandler(void) __attribute__((weak));
+void EXTI3_IRQHandler(void) __attribute__((weak));
+void EXTI4_IRQHandler(void) __attribute__((weak));
+void EXTI9_5_IRQHandler(void) __attribute__((weak));
+void EXTI15_10_IRQHandler(void) __attribute__((weak));
+void DMA1_Stream0_IRQHandler(void) __attribute__((weak));
+void DMA1_Stream1_IRQHandler(void) __attribute__((weak));
+void DMA1_Stream5_IRQHandler(void) __attribute__((weak));
+void DMA1_Stream6_IRQHandler(void) __attribute__((weak));
+void DMA1_Stream7_IRQHandler(void) __attribute__((weak));
+void DMA2_Stream0_IRQHandler(void) __attribute__((weak));
+void DMA2_Stream2_IRQHandler(void) __attribute__((weak));
+void DMA2_Stream5_IRQHandler(void) __attribute__((weak));
+void DMA2_Stream7_IRQHandler(void) __attribute__((weak));
+void TIM1_UP_TIM10_IRQHandler(void) __attribute__((weak));
+void TIM2_IRQHandler(void) __attribute__((weak));
+void TIM3_IRQHandler(void) __attribute__((weak));
+void TIM4_IRQHandler(void) __attribute__((weak));
+void TIM5_IRQHandler(void) __attribute__((weak));
+void TIM6_DAC_IRQHandler(void) __attribute__((weak));
+void TIM7_IRQHandler(void) __attribute__((weak));
+void TIM8_TRG_COM_TIM14_IRQHandler(void) __attribute__((weak));
+void USART1_IRQHandler(void) __attribute__((weak));
+void USART2_IRQHandler(void) __attribute__((weak));
+void USART3_IRQHandler(void) __attribute__((weak));
+void UART5_IRQHandler(void) __attribute__((weak));
+
+/* Private user code ---------------------------------------------------------*/
+
+/**
+ * @brief  中断处理函数
+ * @param  exception 异常号
+ * @retval 处理函数 未实现时为 NULL
+ */
+static void (*host_Vector(uint32_t exception))(void)
+{
+    switch ((int32_t)exception - 16) {
+        case SysTick_IRQn:
+            return SysTick_Handler;
+        case EXTI0_IRQn:
+            return EXTI0_IRQHandler;
+        case EXTI1_IRQn:
+            return EXTI1_IRQHandler;
+        case EXTI2_IRQn:
+            return EXTI2_IRQHandler;
+        case EXTI3_IRQn:
+            return EXTI3_IRQHandler;
+        case EXTI4_IRQn:
+            return EXTI4_IRQHandler;
+        case EXTI9_5_IRQn:
+            return EXTI9_5_IRQHandler;
+        case EXTI15_10_IRQn:
+            return EXTI15_10_IRQHandler;
+        case DMA1_Stream0_IRQn:
+            return DMA1_Stream0_IRQHandler;
+        case DMA1_Stream1_IRQn:
+            return DMA1_Stream1_IRQHandler;
+        case DMA1_Stream5_IRQn:
+            return DMA1_Stream5_IRQHandler;
+        case DMA1_Stream6_IRQn:
+            return DMA1_Stream6_IRQHandler;
+        case DMA1_Stream7_IRQn:
+            return DMA1_Stream7_IRQHandler;
+        case DMA2_Stream0_IRQn:
+            return DMA2_Stream0_IRQHandler;
+        case DMA2_Stream2_IRQn:
+            return DMA2_Stream2_IRQHandler;
+        case DMA2_Stream5_IRQn:
+            return DMA2_Stream5_IRQHandler;
+        case DMA2_Stream7_IRQn:
+            return DMA2_Stream7_IRQHandler;
+        case TIM1_UP_TIM10_IRQn:
+            return TIM1_UP_TIM10_IRQHandler;
+        case TIM2_IRQn:
+            return TIM2_IRQHandler;
+        case TIM3_IRQn:
+            return TIM3_IRQHandler;
+        case TIM4_IRQn:
+            return TIM4_IRQHandler;
+        case TIM5_IRQn:
+            return TIM5_IRQHandler;
+        case TIM6_DAC_IRQn:
+            return TIM6_DAC_IRQHandler;
+        case TIM7_IRQn:
+            return TIM7_IRQHandler;
+        case TIM8_TRG_COM_TIM14_IRQn:
+            return TIM8_TRG_COM_TIM14_IRQHandler;
+        case USART1_IRQn:
+            return USART1_IRQHandler;
+        case USART2_IRQn:
+            return USART2_IRQHandler;
+        case USART3_IRQn:
+            return USART3_IRQHandler;
+        case UART5_IRQn:
+            return UART5_IRQHandler;
+        default:
+            return NULL;
+    }
+}
+
+/**
+ * @brief  映射寄存器窗口
+ * @note   在固件任何代码运行前执行 地址冲突时 (如 ASan 影子内存) 跳过并提示
+ * @param  None
+ * @retval None
+ */
+__attribute__((constructor)) static void host_Board_Map(void)
+{
+    void * addr;
+    uint8_t i;
+
+    for (i = 0; i < ARRAY_LEN(cHost_Windows); ++i) {
+        addr = mmap((void *)cHost_Windows[i].base, cHost_Windows[i].size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE | MAP_NORESERVE, -1, 0);
+        if (addr != (void *)cHost_Windows[i].base) {
+            fprintf(stderr, "host board: window 0x%08lx unavailable\n", (unsigned long)cHost_Windows[i].base);
+            continue;
+        }
+        if (cHost_Windows[i].fill != 0) {
+            memset(addr, cHost_Windows[i].fill, cHost_Windows[i].size);
+        }
+    }
+}
+
+/**
+ * @brief  板级模型 初始化
+ * @note   复位值 在调用固件 main 前调用
+ * @param  None
+ * @retval None
+ */
+void host_Board_Init(void)
+{
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    *(__IO uint32_t *)&SCB->CPUID = 0x412FC230; /* Cortex-M3 r2p0 只读寄存器 */
+    RCC->CR = 0x00000083;
+    host_Uart_Init();
+}
+
+/**
+ * @brief  退出
+ * @param  code 进程返回值
+ * @retval None
+ */
+void host_Board_Exit(int code)
+{
+    fflush(stdout);
+    fflush(stderr);
+    exit(code);
+}
+
+/**
+ * @brief  虚拟时间
+ * @param  None
+ * @retval 当前时刻 nS
+ */
+uint64_t host_Time_Now(void)
+{
+    return gHost_Now;
+}
+
+/**
+ * @brief  事件 按时刻插入
+ * @param  time 时刻 nS 早于当前时刻时 按当前时刻执行
+ * @param  fun 回调
+ * @param  arg 参数
+ * @retval None
+ */
+void host_Event_At(uint64_t time, host_Event_Fun fun, void * arg)
+{
+    sHost_Event event, tmp;
+    uint32_t i, parent;
+
+    if (gHost_Event_Num == gHost_Event_Cap) {
+        gHost_Event_Cap = (gHost_Event_Cap == 0) ? (64) : (gHost_Event_Cap * 2);
+        gHost_Events = realloc(gHost_Events, gHost_Event_Cap * sizeof(sHost_Event));
+        if (gHost_Events == NULL) {
+            abort();
+        }
+    }
+    event.time = (time < gHost_Now) ? (gHost_Now) : (time);
+    event.seq = gHost_Seq++;
+    event.fun = fun;
+    event.arg = arg;
+
+    i = gHost_Event_Num++;
+    gHost_Events[i] = event;
+    while (i > 0) { /* 上浮 */
+        parent = (i - 1) / 2;
+        if (gHost_Events[parent].time < gHost_Events[i].time ||
+            (gHost_Events[parent].time == gHost_Events[i].time && gHost_Events[parent].seq < gHost_Events[i].seq)) {
+            break;
+        }
+        tmp = gHost_Events[parent];
+        gHost_Events[parent] = gHost_Events[i];
+        gHost_Events[i] = tmp;
+        i = parent;
+    }
+}
+
+/**
+ * @brief  事件 相对当前时刻插入
+ * @param  delay 延时 nS
+ * @param  fun 回调
+ * @param  arg 参数
+ * @retval None
+ */
+void host_Event_After(uint64_t delay, host_Event_Fun fun, void * arg)
+{
+    host_Event_At(gHost_Now + delay, fun, arg);
+}
+
+/**
+ * @brief  事件 比较
+ * @retval 1 a 先于 b
+ */
+static uint8_t host_Event_Before(const sHost_Event * a, const sHost_Event * b)
+{
+    return a->time < b->time || (a->time == b->time && a->seq < b->seq);
+}
+
+/**
+ * @brief  事件 移除指定位置
+ * @param  i 位置
+ * @retval 被移除的事件
+ */
+static sHost_Event host_Event_Remove(uint32_t i)
+{
+    sHost_Event event = gHost_Events[i], tmp;
+    uint32_t child;
+
+    gHost_Events[i] = gHost_Events[--gHost_Event_Num];
+    while (i > 0 && host_Event_Before(&gHost_Events[i], &gHost_Events[(i - 1) / 2])) { /* 上浮 */
+        tmp = gHost_Events[(i - 1) / 2];
+        gHost_Events[(i - 1) / 2] = gHost_Events[i];
+        gHost_Events[i] = tmp;
+        i = (i - 1) / 2;
+    }
+    for (;;) { /* 下沉 */
+        child = i * 2 + 1;
+        if (child >= gHost_Event_Num) {
+            break;
+        }
+        if (child + 1 < gHost_Event_Num && host_Event_Before(&gHost_Events[child + 1], &gHost_Events[child])) {
+            ++child;
+        }
+        if (host_Event_Before(&gHost_Events[i], &gHost_Events[child])) {
+            break;
+        }
+        tmp = gHost_Events[child];
+        gHost_Events[child] = gHost_Events[i];
+        gHost_Events[i] = tmp;
+        i = child;
+    }
+    return event;
+}
+
+/**
+ * @brief  事件 取消
+ * @note   取消所有回调与参数相同的事件
+ * @param  fun 回调
+ * @param  arg 参数
+ * @retval None
+ */
+void host_Event_Cancel(host_Event_Fun fun, void * arg)
+{
+    uint32_t i = 0;
+
+    while (i < gHost_Event_Num) {
+        if (gHost_Events[i].fun == fun && gHost_Events[i].arg == arg) {
+            host_Event_Remove(i);
+            i = 0;
+            continue;
+        }
+        ++i;
+    }
+}
+
+/**
+ * @brief  中断 优先级
+ * @param  exception 异常号
+ * @retval 优先级 (高4位)
+ */
+static uint32_t host_Irq_Priority(uint32_t exception)
+{
+    if (exception < 16) {
+        return HOST_SYSTICK_PRIORITY;
+    }
+    return NVIC->IP[exception - 16];
+}
+
+/**
+ * @brief  中断 是否使能
+ * @param  exception 异常号
+ * @retval 1 使能
+ */
+static uint8_t host_Irq_Enabled(uint32_t exception)
+{
+    uint32_t irqn;
+
+    if (exception < 16) {
+        return 1;
+    }
+    irqn = exception - 16;
+    return (NVIC->ISER[irqn >> 5] >> (irqn & 0x1F)) & 1;
+}
+
+/**
+ * @brief  响应挂起的中断
+ * @note   按优先级 抢占当前执行优先级 处理函数返回后继续检查 (咬尾)
+ * @param  None
+ * @retval None
+ */
+void host_Irq_Dispatch(void)
+{
+    uint32_t exception, best, priority, best_priority, saved_priority, saved_ipsr;
+    void (*handler)(void);
+
+    while (gHost_Pending_Num > 0) {
+        best = 0;
+        best_priority = HOST_THREAD_PRIORITY;
+        for (exception = 0; exception < HOST_EXCEPTION_NUM; ++exception) {
+            if (gHost_Pending[exception] == 0 || host_Irq_Enabled(exception) == 0) {
+                continue;
+            }
+            priority = host_Irq_Priority(exception);
+            if (priority < best_priority) {
+                best = exception;
+                best_priority = priority;
+            }
+        }
+        if (best == 0 || best_priority >= gHost_Active_Priority || ucPortHostIrqMasked(best_priority)) {
+            return;
+        }
+        gHost_Pending[best] = 0;
+        --gHost_Pending_Num;
+        if (best >= 16) {
+            NVIC->ISPR[(best - 16) >> 5] &= ~(1UL << ((best - 16) & 0x1F));
+        }
+        handler = host_Vector(best);
+        if (handler == NULL) {
+            continue;
+        }
+        saved_priority = gHost_Active_Priority;
+        gHost_Active_Priority = best_priority;
+        saved_ipsr = ulPortHostIsrEnter(best);
+        handler();
+        ulPortHostIsrEnter(saved_ipsr);
+        gHost_Active_Priority = saved_priority;
+    }
+}
+
+/**
+ * @brief  触发中断
+ * @note   置挂起 可响应时立即执行 事件上下文外调用时 任务切换在返回前执行
+ * @param  irqn 中断号
+ * @retval None
+ */
+void host_Irq_Raise(IRQn_Type irqn)
+{
+    uint32_t exception = (uint32_t)(irqn + 16), saved_ipsr;
+
+    if (gHost_Pending[exception] == 0) {
+        gHost_Pending[exception] = 1;
+        ++gHost_Pending_Num;
+    }
+    if (irqn >= 0) {
+        NVIC->ISPR[irqn >> 5] |= 1UL << (irqn & 0x1F);
+    }
+    if (gHost_In_Step) {
+        host_Irq_Dispatch();
+        return;
+    }
+    saved_ipsr = ulPortHostIsrEnter(HOST_EVENT_EXCEPTION);
+    host_Irq_Dispatch();
+    vPortHostIsrExit(saved_ipsr);
+}
+
+/**
+ * @brief  定时器 计数时钟
+ * @param  tim 定时器
+ * @retval 时钟 Hz APB 分频不为 1 时 定时器时钟为 APB 时钟 2 倍
+ */
+uint32_t host_Tim_Clock(TIM_TypeDef * tim)
+{
+    uint32_t pclk, div;
+
+    if ((uint32_t)tim >= APB2PERIPH_BASE) {
+        pclk = gHost_PCLK2;
+        div = (RCC->CFGR & RCC_CFGR_PPRE2) >> RCC_CFGR_PPRE2_Pos;
+    } else {
+        pclk = gHost_PCLK1;
+        div = (RCC->CFGR & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos;
+    }
+    return (div >= 4) ? (pclk * 2) : (pclk);
+}
+
+/**
+ * @brief  定时器 计数值对应时长
+ * @param  pTim 定时器
+ * @param  ticks 计数值
+ * @retval 时长 nS 向上取整
+ */
+static uint64_t host_Tim_Ticks_To_Ns(sHost_Tim * pTim, uint64_t ticks)
+{
+    unsigned __int128 ns;
+    uint32_t clock = host_Tim_Clock(pTim->tim);
+
+    ns = (unsigned __int128)ticks * (pTim->psc + 1) * HOST_NS_PER_S;
+    return (uint64_t)((ns + clock - 1) / clock);
+}
+
+/**
+ * @brief  定时器 时长对应计数值
+ * @param  pTim 定时器
+ * @param  ns 时长 nS
+ * @retval 计数值 向下取整
+ */
+static uint64_t host_Tim_Ns_To_Ticks(sHost_Tim * pTim, uint64_t ns)
+{
+    return (uint64_t)((unsigned __int128)ns * host_Tim_Clock(pTim->tim) / ((unsigned __int128)(pTim->psc + 1) * HOST_NS_PER_S));
+}
+
+/**
+ * @brief  定时器 更新周期计数值
+ * @param  pTim 定时器
+ * @retval 计数值 (ARR + 1) x (RCR + 1)
+ */
+static uint64_t host_Tim_Period(sHost_Tim * pTim)
+{
+    uint64_t period = (uint64_t)pTim->arr + 1;
+
+    if (pTim->advanced) {
+        period *= (pTim->rcr & 0xFF) + 1;
+    }
+    return period;
+}
+
+/**
+ * @brief  定时器 从指定计数值开始计数
+ * @param  pTim 定时器
+ * @param  ticks 计数值 (含重复周期)
+ * @retval None
+ */
+static void host_Tim_Restart(sHost_Tim * pTim, uint64_t ticks)
+{
+    uint64_t period = host_Tim_Period(pTim);
+
+    if (ticks >= period) { /* 计数值越过新周期 立即更新 */
+        ticks = period - 1;
+    }
+    pTim->running = 1;
+    pTim->origin = gHost_Now;
+    pTim->ticks = ticks;
+    pTim->next = gHost_Now + host_Tim_Ticks_To_Ns(pTim, period - ticks);
+}
+
+/**
+ * @brief  定时器 按寄存器同步计数状态
+ * @note   启动 写入 CNT 或未使能预装载时写入 ARR 从当前时刻重新计算下次更新时刻
+ *         PSC RCR 及使能预装载时的 ARR 在更新事件时生效 与硬件影子寄存器一致
+ * @param  pTim 定时器
+ * @retval None
+ */
+static void host_Tim_Sync(sHost_Tim * pTim)
+{
+    TIM_TypeDef * tim = pTim->tim;
+
+    if ((tim->CR1 & TIM_CR1_CEN) == 0) {
+        pTim->running = 0;
+        pTim->next = UINT64_MAX;
+        return;
+    }
+    if (pTim->running == 0) { /* 启动 */
+        pTim->psc = tim->PSC & 0xFFFF;
+        pTim->arr = tim->ARR;
+        pTim->rcr = tim->RCR;
+        host_Tim_Restart(pTim, tim->CNT);
+    } else if (tim->CNT != pTim->shadow_cnt) { /* 固件写入计数值 */
+        host_Tim_Restart(pTim, tim->CNT);
+    } else if (tim->ARR != pTim->shadow_arr && (tim->CR1 & TIM_CR1_ARPE) == 0) { /* 周期立即生效 保持当前计数 */
+        pTim->arr = tim->ARR;
+        host_Tim_Restart(pTim, pTim->ticks + host_Tim_Ns_To_Ticks(pTim, gHost_Now - pTim->origin));
+    }
+    pTim->shadow_cnt = tim->CNT;
+    pTim->shadow_arr = tim->ARR;
+}
+
+/**
+ * @brief  定时器 推进计数值到当前时刻
+ * @note   到达更新时刻的定时器 装载影子寄存器 置 UIF 调用回调 触发中断
+ * @param  None
+ * @retval None
+ */
+static void host_Tim_Advance(void)
+{
+    sHost_Tim * pTim;
+    uint64_t ticks;
+    uint8_t i, j;
+
+    for (i = 0; i < ARRAY_LEN(gHost_Tims); ++i) {
+        pTim = &gHost_Tims[i];
+        if (pTim->running == 0) {
+            continue;
+        }
+        if (pTim->next <= gHost_Now) { /* 更新事件 */
+            pTim->psc = pTim->tim->PSC & 0xFFFF;
+            pTim->arr = pTim->tim->ARR;
+            pTim->rcr = pTim->tim->RCR;
+            pTim->origin = pTim->next;
+            pTim->ticks = 0;
+            pTim->tim->CNT = 0;
+            pTim->shadow_cnt = 0;
+            pTim->tim->SR |= TIM_SR_UIF;
+            if (pTim->tim->CR1 & TIM_CR1_OPM) {
+                pTim->tim->CR1 &= ~TIM_CR1_CEN;
+            }
+            for (j = 0; j < gHost_Tim_Watch_Num; ++j) {
+                if (gHost_Tim_Watches[j].tim == pTim->tim) {
+                    gHost_Tim_Watches[j].fun(gHost_Tim_Watches[j].arg);
+                }
+            }
+            pTim->next = pTim->origin + host_Tim_Ticks_To_Ns(pTim, host_Tim_Period(pTim));
+            if (pTim->tim->DIER & TIM_DIER_UIE) {
+                host_Irq_Raise(pTim->irqn);
+            }
+            if ((pTim->tim->CR1 & TIM_CR1_CEN) == 0) {
+                pTim->running = 0;
+                pTim->next = UINT64_MAX;
+                continue;
+            }
+            host_Tim_Sync(pTim); /* 回调与中断中修改的寄存器 */
+            continue;
+        }
+        ticks = pTim->ticks + host_Tim_Ns_To_Ticks(pTim, gHost_Now - pTim->origin);
+        pTim->tim->CNT = ticks % ((uint64_t)pTim->arr + 1);
+        pTim->shadow_cnt = pTim->tim->CNT;
+    }
+}
+
+/**
+ * @brief  定时器 更新事件回调
+ * @note   更新事件时 在中断前调用 用于 ADC 触发 电机步进计数等
+ * @param  tim 定时器
+ * @param  fun 回调
+ * @param  arg 参数
+ * @retval None
+ */
+void host_Tim_Watch(TIM_TypeDef * tim, host_Event_Fun fun, void * arg)
+{
+    if (gHost_Tim_Watch_Num >= ARRAY_LEN(gHost_Tim_Watches)) {
+        abort();
+    }
+    gHost_Tim_Watches[gHost_Tim_Watch_Num].tim = tim;
+    gHost_Tim_Watches[gHost_Tim_Watch_Num].fun = fun;
+    gHost_Tim_Watches[gHost_Tim_Watch_Num].arg = arg;
+    ++gHost_Tim_Watch_Num;
+}
+
+/**
+ * @brief  SysTick 按寄存器同步
+ * @param  None
+ * @retval None
+ */
+static void host_SysTick_Sync(void)
+{
+    uint32_t mask = SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_TICKINT_Msk;
+
+    if ((SysTick->CTRL & mask) != mask || SystemCoreClock == 0) {
+        gHost_SysTick_Next = UINT64_MAX;
+        gHost_SysTick_Ctrl = 0;
+        return;
+    }
+    if (gHost_SysTick_Ctrl == (SysTick->CTRL & mask) && gHost_SysTick_Load == SysTick->LOAD) {
+        return;
+    }
+    gHost_SysTick_Ctrl = SysTick->CTRL & mask;
+    gHost_SysTick_Load = SysTick->LOAD;
+    gHost_SysTick_Origin = gHost_Now;
+    gHost_SysTick_Next = gHost_Now + (uint64_t)(SysTick->LOAD + 1) * HOST_NS_PER_S / SystemCoreClock;
+}
+
+/**
+ * @brief  同步外设状态 计算下一个事件时刻
+ * @param  None
+ * @retval 时刻 nS
+ */
+static uint64_t host_Board_Next(void)
+{
+    uint64_t next = UINT64_MAX;
+    uint8_t i;
+
+    for (i = 0; i < ARRAY_LEN(gHost_Tims); ++i) {
+        host_Tim_Sync(&gHost_Tims[i]);
+        if (gHost_Tims[i].next < next) {
+            next = gHost_Tims[i].next;
+        }
+    }
+    host_SysTick_Sync();
+    if (gHost_SysTick_Next < next) {
+        next = gHost_SysTick_Next;
+    }
+    if (gHost_Event_Num > 0 && gHost_Events[0].time < next) {
+        next = gHost_Events[0].time;
+    }
+    return next;
+}
+
+/**
+ * @brief  推进虚拟时间到指定时刻 执行到期的定时器 SysTick 与事件
+ * @param  time 时刻 不早于当前时刻
+ * @retval None
+ */
+static void host_Board_Advance(uint64_t time)
+{
+    sHost_Event event;
+    uint32_t saved_ipsr;
+
+    saved_ipsr = ulPortHostIsrEnter(HOST_EVENT_EXCEPTION);
+    gHost_In_Step = 1;
+
+    gHost_Now = time;
+    DWT->CYCCNT = (uint32_t)((unsigned __int128)gHost_Now * SystemCoreClock / HOST_NS_PER_S);
+    host_Tim_Advance();
+    if (gHost_SysTick_Next <= gHost_Now) {
+        gHost_SysTick_Next += (uint64_t)(SysTick->LOAD + 1) * HOST_NS_PER_S / SystemCoreClock;
+        SysTick->CTRL |= SysTick_CTRL_COUNTFLAG_Msk;
+        host_Irq_Raise(SysTick_IRQn);
+    }
+    while (gHost_Event_Num > 0 && gHost_Events[0].time <= gHost_Now) {
+        event = host_Event_Remove(0);
+        event.fun(event.arg);
+    }
+    host_Irq_Dispatch();
+
+    gHost_In_Step = 0;
+    vPortHostIsrExit(saved_ipsr);
+}
+
+/**
+ * @brief  推进虚拟时间到下一个事件
+ * @note   空闲钩子 WFI 调用
+ * @param  None
+ * @retval None
+ */
+void host_Board_Step(void)
+{
+    uint64_t next;
+
+    if (gHost_In_Step) { /* 中断处理函数中忙等 */
+        return;
+    }
+    next = host_Board_Next();
+    if (next == UINT64_MAX) {
+        fprintf(stderr, "host board: no pending event\n");
+        host_Board_Exit(2);
+    }
+    host_Board_Advance(next);
+}
+
+/**
+ * @brief  推进虚拟时间到指定时刻
+ * @note   途中的事件与中断依次执行 可被更高优先级任务抢占
+ * @param  time 时刻 nS
+ * @retval None
+ */
+void host_Time_Run_Until(uint64_t time)
+{
+    uint64_t next;
+
+    if (gHost_In_Step) {
+        return;
+    }
+    for (;;) {
+        next = host_Board_Next();
+        if (next > time) {
+            break;
+        }
+        host_Board_Advance(next);
+    }
+    if (time > gHost_Now) {
+        host_Board_Advance(time);
+    }
+}
+
+/**
+ * @brief  忙等 CPU 占用时长
+ * @note   阻塞传输 软件延时 期间中断照常响应
+ * @param  ns 时长 nS
+ * @retval None
+ */
+void host_Time_Busy(uint64_t ns)
+{
+    host_Time_Run_Until(gHost_Now + ns);
+}
+
+/**
+ * @brief  GPIO 外部输入
+ * @note   电平变化时按 EXTI 配置 (SYSCFG 端口选择 屏蔽 边沿) 置挂起并触发中断
+ * @param  port 端口
+ * @param  pin 引脚
+ * @param  level 电平
+ * @retval None
+ */
+void host_Gpio_Input(GPIO_TypeDef * port, uint16_t pin, uint8_t level)
+{
+    uint32_t line, before, port_index;
+    IRQn_Type irqn;
+
+    port_index = ((uint32_t)port - AHB1PERIPH_BASE) / 0x400;
+    gHost_Gpio_Driven[port_index] |= pin;
+    before = port->IDR & pin;
+    if (level) {
+        port->IDR |= pin;
+    } else {
+        port->IDR &= ~(uint32_t)pin;
+    }
+    if ((before != 0) == (level != 0)) {
+        return;
+    }
+    line = __builtin_ctz(pin);
+    if (((SYSCFG->EXTICR[line >> 2] >> ((line & 3) * 4)) & 0x0F) != port_index || (EXTI->IMR & pin) == 0) {
+        return;
+    }
+    if ((level && (EXTI->RTSR & pin)) || (level == 0 && (EXTI->FTSR & pin))) {
+        EXTI->PR |= pin;
+        if (line <= 4) {
+            irqn = (IRQn_Type)(EXTI0_IRQn + line);
+        } else if (line <= 9) {
+            irqn = EXTI9_5_IRQn;
+        } else {
+            irqn = EXTI15_10_IRQn;
+        }
+        host_Irq_Raise(irqn);
+    }
+}
+
+/**
+ * @brief  GPIO 是否被外部驱动
+ * @param  port 端口
+ * @param  pin 引脚
+ * @retval 1 由 host_Gpio_Input 驱动 上下拉配置不改变电平
+ */
+uint8_t host_Gpio_Is_Driven(GPIO_TypeDef * port, uint16_t pin)
+{
+    return (gHost_Gpio_Driven[((uint32_t)port - AHB1PERIPH_BASE) / 0x400] & pin) ? (1) : (0);
+}
+
+/**
+ * @brief  GPIO 输出变化回调
+ * @param  port 端口
+ * @param  pins 引脚
+ * @param  fun 回调 在写引脚的上下文中调用 只应修改模型状态或添加事件
+ * @param  arg 参数
+ * @retval None
+ */
+void host_Gpio_Watch(GPIO_TypeDef * port, uint16_t pins, host_Gpio_Watch_Fun fun, void * arg)
+{
+    if (gHost_Gpio_Watch_Num >= ARRAY_LEN(gHost_Gpio_Watches)) {
+        abort();
+    }
+    gHost_Gpio_Watches[gHost_Gpio_Watch_Num].port = port;
+    gHost_Gpio_Watches[gHost_Gpio_Watch_Num].pins = pins;
+    gHost_Gpio_Watches[gHost_Gpio_Watch_Num].fun = fun;
+    gHost_Gpio_Watches[gHost_Gpio_Watch_Num].arg = arg;
+    ++gHost_Gpio_Watch_Num;
+}
+
+/**
+ * @brief  GPIO 输出已变化
+ * @note   由 GPIO 桩调用 输出引脚的输入寄存器跟随输出 调用回调
+ * @param  port 端口
+ * @param  pins 写入的引脚
+ * @param  before 写入前输出寄存器
+ * @retval None
+ */
+void host_Gpio_Output_Changed(GPIO_TypeDef * port, uint16_t pins, uint16_t before)
+{
+    uint16_t changed, pin, output = 0;
+    uint8_t i;
+
+    for (i = 0; i < 16; ++i) {
+        if (((port->MODER >> (i * 2)) & GPIO_MODER_MODER0) == GPIO_MODER_MODER0_0) {
+            output |= 1U << i;
+        }
+    }
+    changed = (before ^ port->ODR) & pins;
+    port->IDR = (port->IDR & ~(uint32_t)(pins & output)) | (port->ODR & pins & output);
+    if (changed == 0) {
+        return;
+    }
+    for (i = 0; i < gHost_Gpio_Watch_Num; ++i) {
+        if (gHost_Gpio_Watches[i].port != port || (gHost_Gpio_Watches[i].pins & changed) == 0) {
+            continue;
+        }
+        for (pin = 1; pin != 0; pin <<= 1) {
+            if (gHost_Gpio_Watches[i].pins & changed & pin) {
+                gHost_Gpio_Watches[i].fun(gHost_Gpio_Watches[i].arg, port, pin, (port->ODR & pin) ? (1) : (0));
+            }
+        }
+    }
+}
@@ -0,0 +1,1495 @@
+/**
+ * @file    hal_stub.c
+ * @brief   主机构建 HAL 桩 (串口除外 见 uart.c)
+ *
+ * 与 HAL 同名同参 按 HAL 的寄存器与句柄状态约定实现 不等待硬件就绪位
+ *     时钟     按 RCC 配置计算 SystemCoreClock 与 APB 时钟 定时器时钟据此计算
+ *     GPIO     输出写 ODR 并回显到 IDR 中断模式配置 SYSCFG EXTI 寄存器
+ *     DMA      流寄存器 NDTR 与中断标志按传输更新 中断处理调用句柄回调
+ *     定时器   写 CR1 DIER CCER 等寄存器 计数与更新事件由板级模型产生 DMA 突发写在更新事件时执行
+ *     ADC      定时器 2 更新事件触发 按规则序列经 DMA 写入转换值 软件触发立即完成
+ *     SPI      按片选找到挂接的设备模型逐字节交换 按波特率忙等
+ *     Flash    内部 Flash 窗口直接读写 I2C 无器件应答
+ *     阻塞延时 HAL_Delay 忙等虚拟时间
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_hal.h"
+
+/* Private define ------------------------------------------------------------*/
+#define HOST_DMA_STREAM_NUM 16 /* DMA1 DMA2 各 8 个流 */
+#define HOST_SPI_DEVICE_MAX 4  /* SPI 设备上限 */
+#define HOST_ADC_RANK_MAX 16   /* 规则序列长度上限 */
+#define HOST_ADC_CHANNEL_NUM 19
+#define HOST_ADC_DEFAULT 2120 /* 27 ℃ NTC 对应转换值 */
+
+#define HOST_GPIO_MODE 0x00000003U /* stm32f2xx_hal_gpio.c */
+#define HOST_EXTI_MODE 0x10000000U
+#define HOST_GPIO_MODE_IT 0x00010000U
+#define HOST_GPIO_MODE_EVT 0x00020000U
+#define HOST_RISING_EDGE 0x00100000U
+#define HOST_FALLING_EDGE 0x00200000U
+
+/* Private typedef -----------------------------------------------------------*/
+/* DMA 流 */
+typedef struct {
+    DMA_HandleTypeDef * hdma;
+    uint8_t * pBuffer; /* 存储区 */
+    uint32_t length;   /* 传输数目 */
+    uint8_t active;    /* 传输中 */
+} sHost_Dma;
+
+/* SPI 设备 */
+typedef struct {
+    SPI_TypeDef * spi;
+    GPIO_TypeDef * cs_port;
+    uint16_t cs_pin;
+    sHost_Spi_Device device;
+} sHost_Spi;
+
+/* ADC */
+typedef struct {
+    ADC_HandleTypeDef * hadc;
+    uint32_t ranks[HOST_ADC_RANK_MAX];           /* 规则序列通道 */
+    uint16_t values[HOST_ADC_CHANNEL_NUM];       /* 通道转换值 */
+    uint8_t watched;                             /* 已挂接定时器触发 */
+} sHost_Adc;
+
+/* Private variables ---------------------------------------------------------*/
+__IO uint32_t uwTick;
+uint32_t uwTickPrio = (1UL << __NVIC_PRIO_BITS);
+HAL_TickFreqTypeDef uwTickFreq = HAL_TICK_FREQ_DEFAULT;
+
+static sHost_Dma gHost_Dmas[HOST_DMA_STREAM_NUM];
+static sHost_Spi gHost_Spis[HOST_SPI_DEVICE_MAX];
+static uint8_t gHost_Spi_Num = 0;
+static sHost_Adc gHost_Adcs[2];
+static TIM_HandleTypeDef * gHost_Tim_Bursts[2]; /* TIM1 TIM8 更新事件 DMA 突发 */
+static uint8_t gHost_Flash_Locked = 1;
+static RCC_OscInitTypeDef gHost_Osc;
+
+/* Private function prototypes -----------------------------------------------*/
+
+/* Private user code ---------------------------------------------------------*/
+
+/* 时钟 -----------------------------------------------------------------------*/
+
+/**
+ * @brief  HAL 初始化
+ * @note   中断分组 4 节拍定时器初始化 与 HAL 一致
+ * @param  None
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_Init(void)
+{
+    NVIC_SetPriorityGrouping(NVIC_PRIORITYGROUP_4);
+    HAL_InitTick(TICK_INT_PRIORITY);
+    HAL_MspInit();
+    return HAL_OK;
+}
+
+/**
+ * @brief  节拍递增
+ * @param  None
+ * @retval None
+ */
+void HAL_IncTick(void)
+{
+    uwTick += uwTickFreq;
+}
+
+/**
+ * @brief  节拍
+ * @param  None
+ * @retval 节拍计数 mS
+ */
+uint32_t HAL_GetTick(void)
+{
+    return uwTick;
+}
+
+/**
+ * @brief  阻塞延时
+ * @note   忙等虚拟时间 期间节拍中断照常递增 与 HAL 一致多等待一个节拍
+ * @param  Delay 延时 mS
+ * @retval None
+ */
+void HAL_Delay(__IO uint32_t Delay)
+{
+    uint32_t wait = Delay;
+
+    if (wait < HAL_MAX_DELAY) {
+        wait += (uint32_t)uwTickFreq;
+    }
+    host_Time_Busy((uint64_t)wait * HOST_NS_PER_MS);
+}
+
+/**
+ * @brief  振荡器配置
+ * @note   记录 PLL 参数 就绪位立即置位
+ * @param  RCC_OscInitStruct 配置
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef * RCC_OscInitStruct)
+{
+    gHost_Osc = *RCC_OscInitStruct;
+    if (RCC_OscInitStruct->HSEState == RCC_HSE_ON) {
+        RCC->CR |= RCC_CR_HSEON | RCC_CR_HSERDY;
+    }
+    if (RCC_OscInitStruct->PLL.PLLState == RCC_PLL_ON) {
+        RCC->PLLCFGR = RCC_OscInitStruct->PLL.PLLM | (RCC_OscInitStruct->PLL.PLLN << RCC_PLLCFGR_PLLN_Pos) |
+                       (((RCC_OscInitStruct->PLL.PLLP >> 1) - 1) << RCC_PLLCFGR_PLLP_Pos) | RCC_OscInitStruct->PLL.PLLSource |
+                       (RCC_OscInitStruct->PLL.PLLQ << RCC_PLLCFGR_PLLQ_Pos);
+        RCC->CR |= RCC_CR_PLLON | RCC_CR_PLLRDY;
+    }
+    return HAL_OK;
+}
+
+/**
+ * @brief  总线时钟配置
+ * @note   计算 SystemCoreClock 与 APB 时钟 按新时钟重新初始化节拍定时器 与 HAL 一致
+ * @param  RCC_ClkInitStruct 配置
+ * @param  FLatency Flash 等待周期
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef * RCC_ClkInitStruct, uint32_t FLatency)
+{
+    const uint8_t cAHB_Shift[16] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 6, 7, 8, 9};
+    const uint8_t cAPB_Shift[8] = {0, 0, 0, 0, 1, 2, 3, 4};
+    uint32_t sysclk, source;
+
+    if (RCC_ClkInitStruct->SYSCLKSource == RCC_SYSCLKSOURCE_PLLCLK) {
+        source = (gHost_Osc.PLL.PLLSource == RCC_PLLSOURCE_HSE) ? (HSE_VALUE) : (HSI_VALUE);
+        sysclk = (uint32_t)((uint64_t)source / gHost_Osc.PLL.PLLM * gHost_Osc.PLL.PLLN / gHost_Osc.PLL.PLLP);
+    } else if (RCC_ClkInitStruct->SYSCLKSource == RCC_SYSCLKSOURCE_HSE) {
+        sysclk = HSE_VALUE;
+    } else {
+        sysclk = HSI_VALUE;
+    }
+    RCC->CFGR = RCC_ClkInitStruct->AHBCLKDivider | RCC_ClkInitStruct->APB1CLKDivider | (RCC_ClkInitStruct->APB2CLKDivider << 3) |
+                (RCC_ClkInitStruct->SYSCLKSource << RCC_CFGR_SWS_Pos) | RCC_ClkInitStruct->SYSCLKSource;
+    FLASH->ACR = FLatency;
+
+    SystemCoreClock = sysclk >> cAHB_Shift[(RCC->CFGR & RCC_CFGR_HPRE) >> RCC_CFGR_HPRE_Pos];
+    gHost_PCLK1 = SystemCoreClock >> cAPB_Shift[(RCC->CFGR & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos];
+    gHost_PCLK2 = SystemCoreClock >> cAPB_Shift[(RCC->CFGR & RCC_CFGR_PPRE2) >> RCC_CFGR_PPRE2_Pos];
+    HAL_InitTick(uwTickPrio);
+    return HAL_OK;
+}
+
+/**
+ * @brief  总线时钟配置 读取
+ * @param  RCC_ClkInitStruct 配置
+ * @param  pFLatency Flash 等待周期
+ * @retval None
+ */
+void HAL_RCC_GetClockConfig(RCC_ClkInitTypeDef * RCC_ClkInitStruct, uint32_t * pFLatency)
+{
+    RCC_ClkInitStruct->ClockType = RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+    RCC_ClkInitStruct->SYSCLKSource = RCC->CFGR & RCC_CFGR_SW;
+    RCC_ClkInitStruct->AHBCLKDivider = RCC->CFGR & RCC_CFGR_HPRE;
+    RCC_ClkInitStruct->APB1CLKDivider = RCC->CFGR & RCC_CFGR_PPRE1;
+    RCC_ClkInitStruct->APB2CLKDivider = (RCC->CFGR & RCC_CFGR_PPRE2) >> 3;
+    *pFLatency = FLASH->ACR & FLASH_ACR_LATENCY;
+}
+
+/**
+ * @brief  APB1 时钟
+ * @param  None
+ * @retval 时钟 Hz
+ */
+uint32_t HAL_RCC_GetPCLK1Freq(void)
+{
+    return gHost_PCLK1;
+}
+
+/**
+ * @brief  APB2 时钟
+ * @param  None
+ * @retval 时钟 Hz
+ */
+uint32_t HAL_RCC_GetPCLK2Freq(void)
+{
+    return gHost_PCLK2;
+}
+
+/**
+ * @brief  时钟安全系统 使能
+ * @param  None
+ * @retval None
+ */
+void HAL_RCC_EnableCSS(void)
+{
+}
+
+/**
+ * @brief  时钟安全系统 中断处理
+ * @param  None
+ * @retval None
+ */
+void HAL_RCC_NMI_IRQHandler(void)
+{
+}
+
+/* NVIC -----------------------------------------------------------------------*/
+
+/**
+ * @brief  中断优先级设置
+ * @param  IRQn 中断号
+ * @param  PreemptPriority 抢占优先级
+ * @param  SubPriority 子优先级
+ * @retval None
+ */
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+    NVIC_SetPriority(IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), PreemptPriority, SubPriority));
+}
+
+/**
+ * @brief  中断使能
+ * @note   置位使能寄存器 (主机内存 写 1 不影响其他位需按位或)
+ * @param  IRQn 中断号
+ * @retval None
+ */
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    NVIC->ISER[IRQn >> 5] |= 1UL << (IRQn & 0x1F);
+    host_Irq_Dispatch(); /* 使能前已挂起 */
+}
+
+/**
+ * @brief  中断禁能
+ * @param  IRQn 中断号
+ * @retval None
+ */
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    NVIC->ISER[IRQn >> 5] &= ~(1UL << (IRQn & 0x1F));
+}
+
+/**
+ * @brief  系统复位
+ * @note   主机构建 退出进程
+ * @param  None
+ * @retval None
+ */
+void HAL_NVIC_SystemReset(void)
+{
+    fprintf(stderr, "host board: system reset\n");
+    host_Board_Exit(3);
+}
+
+/* GPIO -----------------------------------------------------------------------*/
+
+/**
+ * @brief  GPIO 初始化
+ * @note   模式 上下拉 EXTI 配置 与 HAL 一致 未被外部驱动的输入脚按上下拉设置电平
+ * @param  GPIOx 端口
+ * @param  GPIO_Init 配置
+ * @retval None
+ */
+void HAL_GPIO_Init(GPIO_TypeDef * GPIOx, GPIO_InitTypeDef * GPIO_Init)
+{
+    uint32_t position, pin, port_index;
+
+    port_index = ((uint32_t)GPIOx - AHB1PERIPH_BASE) / 0x400;
+    for (position = 0; position < 16; ++position) {
+        pin = 1UL << position;
+        if ((GPIO_Init->Pin & pin) == 0) {
+            continue;
+        }
+        GPIOx->MODER = (GPIOx->MODER & ~(GPIO_MODER_MODER0 << (position * 2))) | ((GPIO_Init->Mode & HOST_GPIO_MODE) << (position * 2));
+        GPIOx->PUPDR = (GPIOx->PUPDR & ~(GPIO_PUPDR_PUPDR0 << (position * 2))) | (GPIO_Init->Pull << (position * 2));
+        if ((GPIO_Init->Mode & HOST_GPIO_MODE) == GPIO_MODE_OUTPUT_PP) {
+            GPIOx->IDR = (GPIOx->IDR & ~pin) | (GPIOx->ODR & pin);
+        } else if (host_Gpio_Is_Driven(GPIOx, pin) == 0) {
+            GPIOx->IDR = (GPIO_Init->Pull == GPIO_PULLUP) ? (GPIOx->IDR | pin) : (GPIOx->IDR & ~pin);
+        }
+        if ((GPIO_Init->Mode & HOST_EXTI_MODE) == 0) {
+            continue;
+        }
+        SYSCFG->EXTICR[position >> 2] = (SYSCFG->EXTICR[position >> 2] & ~(0x0FUL << ((position & 3) * 4))) | (port_index << ((position & 3) * 4));
+        EXTI->IMR = (GPIO_Init->Mode & HOST_GPIO_MODE_IT) ? (EXTI->IMR | pin) : (EXTI->IMR & ~pin);
+        EXTI->EMR = (GPIO_Init->Mode & HOST_GPIO_MODE_EVT) ? (EXTI->EMR | pin) : (EXTI->EMR & ~pin);
+        EXTI->RTSR = (GPIO_Init->Mode & HOST_RISING_EDGE) ? (EXTI->RTSR | pin) : (EXTI->RTSR & ~pin);
+        EXTI->FTSR = (GPIO_Init->Mode & HOST_FALLING_EDGE) ? (EXTI->FTSR | pin) : (EXTI->FTSR & ~pin);
+    }
+}
+
+/**
+ * @brief  GPIO 复位
+ * @param  GPIOx 端口
+ * @param  GPIO_Pin 引脚
+ * @retval None
+ */
+void HAL_GPIO_DeInit(GPIO_TypeDef * GPIOx, uint32_t GPIO_Pin)
+{
+    uint32_t position, port_index;
+
+    port_index = ((uint32_t)GPIOx - AHB1PERIPH_BASE) / 0x400;
+    for (position = 0; position < 16; ++position) {
+        if ((GPIO_Pin & (1UL << position)) == 0) {
+            continue;
+        }
+        GPIOx->MODER &= ~(GPIO_MODER_MODER0 << (position * 2));
+        GPIOx->PUPDR &= ~(GPIO_PUPDR_PUPDR0 << (position * 2));
+        if (((SYSCFG->EXTICR[position >> 2] >> ((position & 3) * 4)) & 0x0F) == port_index) {
+            EXTI->IMR &= ~(1UL << position);
+            EXTI->EMR &= ~(1UL << position);
+            EXTI->RTSR &= ~(1UL << position);
+            EXTI->FTSR &= ~(1UL << position);
+        }
+    }
+}
+
+/**
+ * @brief  GPIO 读取
+ * @param  GPIOx 端口
+ * @param  GPIO_Pin 引脚
+ * @retval 电平
+ */
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef * GPIOx, uint16_t GPIO_Pin)
+{
+    return (GPIOx->IDR & GPIO_Pin) ? (GPIO_PIN_SET) : (GPIO_PIN_RESET);
+}
+
+/**
+ * @brief  GPIO 写入
+ * @param  GPIOx 端口
+ * @param  GPIO_Pin 引脚
+ * @param  PinState 电平
+ * @retval None
+ */
+void HAL_GPIO_WritePin(GPIO_TypeDef * GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    uint16_t before = GPIOx->ODR;
+
+    if (PinState != GPIO_PIN_RESET) {
+        GPIOx->ODR |= GPIO_Pin;
+    } else {
+        GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+    }
+    host_Gpio_Output_Changed(GPIOx, GPIO_Pin, before);
+}
+
+/**
+ * @brief  GPIO 翻转
+ * @param  GPIOx 端口
+ * @param  GPIO_Pin 引脚
+ * @retval None
+ */
+void HAL_GPIO_TogglePin(GPIO_TypeDef * GPIOx, uint16_t GPIO_Pin)
+{
+    uint16_t before = GPIOx->ODR;
+
+    GPIOx->ODR ^= GPIO_Pin;
+    host_Gpio_Output_Changed(GPIOx, GPIO_Pin, before);
+}
+
+/**
+ * @brief  EXTI 中断处理
+ * @note   清除挂起位 (主机内存 直接清零) 后调用回调
+ * @param  GPIO_Pin 引脚
+ * @retval None
+ */
+void HAL_GPIO_EXTI_IRQHandler(uint16_t GPIO_Pin)
+{
+    if (EXTI->PR & GPIO_Pin) {
+        EXTI->PR &= ~(uint32_t)GPIO_Pin;
+        HAL_GPIO_EXTI_Callback(GPIO_Pin);
+    }
+}
+
+/* DMA ------------------------------------------------------------------------*/
+
+/**
+ * @brief  DMA 流 编号
+ * @param  hdma DMA 句柄
+ * @retval 编号 DMA1 0~7 DMA2 8~15
+ */
+static uint8_t host_Dma_Index(DMA_HandleTypeDef * hdma)
+{
+    uint32_t stream = (uint32_t)hdma->Instance;
+
+    return (((stream & 0xFF) - 0x10) / 0x18) + (((stream & ~0xFFUL) == DMA2_BASE) ? (8) : (0));
+}
+
+/**
+ * @brief  DMA 流 中断标志位置
+ * @param  index 流编号
+ * @param  pISR 中断状态寄存器
+ * @retval 标志位偏移 FEIF 所在位
+ */
+static uint8_t host_Dma_Flag_Shift(uint8_t index, __IO uint32_t ** pISR)
+{
+    const uint8_t cShift[4] = {0, 6, 16, 22};
+    DMA_TypeDef * dma = (index < 8) ? (DMA1) : (DMA2);
+
+    *pISR = ((index & 7) < 4) ? (&dma->LISR) : (&dma->HISR);
+    return cShift[index & 3];
+}
+
+/**
+ * @brief  DMA 流 中断号
+ * @param  index 流编号
+ * @retval 中断号
+ */
+static IRQn_Type host_Dma_Irqn(uint8_t index)
+{
+    const IRQn_Type cIrqn[HOST_DMA_STREAM_NUM] = {
+        DMA1_Stream0_IRQn, DMA1_Stream1_IRQn, DMA1_Stream2_IRQn, DMA1_Stream3_IRQn, DMA1_Stream4_IRQn, DMA1_Stream5_IRQn, DMA1_Stream6_IRQn, DMA1_Stream7_IRQn,
+        DMA2_Stream0_IRQn, DMA2_Stream1_IRQn, DMA2_Stream2_IRQn, DMA2_Stream3_IRQn, DMA2_Stream4_IRQn, DMA2_Stream5_IRQn, DMA2_Stream6_IRQn, DMA2_Stream7_IRQn,
+    };
+
+    return cIrqn[index];
+}
+
+
+/**
+ * @brief  DMA 置中断标志 按使能触发中断
+ * @param  index 流编号
+ * @param  flags 标志 (流 0 位置) DMA_FLAG_HTIF0_4 / DMA_FLAG_TCIF0_4
+ * @retval None
+ */
+static void host_Dma_Flag(uint8_t index, uint32_t flags)
+{
+    DMA_Stream_TypeDef * stream = gHost_Dmas[index].hdma->Instance;
+    __IO uint32_t * pISR;
+    uint8_t shift;
+
+    shift = host_Dma_Flag_Shift(index, &pISR);
+    *pISR |= flags << shift;
+    if (((flags & DMA_FLAG_HTIF0_4) && (stream->CR & DMA_SxCR_HTIE)) || ((flags & DMA_FLAG_TCIF0_4) && (stream->CR & DMA_SxCR_TCIE))) {
+        host_Irq_Raise(host_Dma_Irqn(index));
+    }
+}
+
+/**
+ * @brief  DMA 启动传输
+ * @note   与 HAL_DMA_Start_IT 一致 使能传输完成中断 有半传输回调时使能半传输中断
+ * @param  hdma DMA 句柄
+ * @param  pBuffer 存储区
+ * @param  length 传输数目
+ * @retval None
+ */
+void host_Dma_Start(DMA_HandleTypeDef * hdma, void * pBuffer, uint32_t length)
+{
+    sHost_Dma * pDma = &gHost_Dmas[host_Dma_Index(hdma)];
+    __IO uint32_t * pISR;
+    uint8_t shift;
+
+    shift = host_Dma_Flag_Shift(host_Dma_Index(hdma), &pISR);
+    *pISR &= ~(0x3DUL << shift);
+    pDma->hdma = hdma;
+    pDma->pBuffer = pBuffer;
+    pDma->length = length;
+    pDma->active = 1;
+    hdma->State = HAL_DMA_STATE_BUSY;
+    hdma->Instance->NDTR = length;
+    hdma->Instance->CR |= DMA_SxCR_TCIE | DMA_SxCR_TEIE | DMA_SxCR_DMEIE | DMA_SxCR_EN;
+    if (hdma->XferHalfCpltCallback != NULL) {
+        hdma->Instance->CR |= DMA_SxCR_HTIE;
+    }
+}
+
+/**
+ * @brief  DMA 停止传输
+ * @note   剩余计数保持
+ * @param  hdma DMA 句柄
+ * @retval None
+ */
+void host_Dma_Stop(DMA_HandleTypeDef * hdma)
+{
+    gHost_Dmas[host_Dma_Index(hdma)].active = 0;
+    hdma->Instance->CR &= ~(DMA_SxCR_TCIE | DMA_SxCR_HTIE | DMA_SxCR_TEIE | DMA_SxCR_DMEIE | DMA_SxCR_EN);
+    hdma->State = HAL_DMA_STATE_READY;
+}
+
+/**
+ * @brief  DMA 是否传输中
+ * @param  hdma DMA 句柄
+ * @retval 1 传输中
+ */
+uint8_t host_Dma_Is_Active(DMA_HandleTypeDef * hdma)
+{
+    return gHost_Dmas[host_Dma_Index(hdma)].active;
+}
+
+/**
+ * @brief  DMA 传输一项后更新计数
+ * @note   半传输 传输完成 置标志 循环模式重新装载计数 否则停止
+ * @param  pDma DMA 流
+ * @param  index 流编号
+ * @retval None
+ */
+static void host_Dma_Count(sHost_Dma * pDma, uint8_t index)
+{
+    DMA_Stream_TypeDef * stream = pDma->hdma->Instance;
+
+    --stream->NDTR;
+    if (stream->NDTR == pDma->length / 2 && stream->NDTR > 0) {
+        host_Dma_Flag(index, DMA_FLAG_HTIF0_4);
+    }
+    if (stream->NDTR == 0) {
+        if (stream->CR & DMA_SxCR_CIRC) {
+            stream->NDTR = pDma->length;
+        } else {
+            pDma->active = 0;
+            stream->CR &= ~DMA_SxCR_EN;
+        }
+        host_Dma_Flag(index, DMA_FLAG_TCIF0_4);
+    }
+}
+
+/**
+ * @brief  DMA 外设到存储区 传输一项
+ * @param  hdma DMA 句柄
+ * @param  pItem 数据
+ * @param  width 数据宽度 字节
+ * @retval 1 已写入 0 未在传输中 数据丢弃
+ */
+uint8_t host_Dma_Put(DMA_HandleTypeDef * hdma, const void * pItem, uint8_t width)
+{
+    uint8_t index = host_Dma_Index(hdma);
+    sHost_Dma * pDma = &gHost_Dmas[index];
+
+    if (pDma->active == 0) {
+        return 0;
+    }
+    memcpy(&pDma->pBuffer[(pDma->length - hdma->Instance->NDTR) * width], pItem, width);
+    host_Dma_Count(pDma, index);
+    return 1;
+}
+
+/**
+ * @brief  DMA 存储区到外设 传输一项
+ * @param  hdma DMA 句柄
+ * @param  pItem 数据
+ * @param  width 数据宽度 字节
+ * @retval 1 已读出 0 未在传输中
+ */
+uint8_t host_Dma_Get(DMA_HandleTypeDef * hdma, void * pItem, uint8_t width)
+{
+    uint8_t index = host_Dma_Index(hdma);
+    sHost_Dma * pDma = &gHost_Dmas[index];
+
+    if (pDma->active == 0) {
+        return 0;
+    }
+    memcpy(pItem, &pDma->pBuffer[(pDma->length - hdma->Instance->NDTR) * width], width);
+    host_Dma_Count(pDma, index);
+    return 1;
+}
+
+/**
+ * @brief  DMA 存储区到外设 整块传输完成
+ * @note   串口发送 外设模型在发送结束时刻调用
+ * @param  hdma DMA 句柄
+ * @retval None
+ */
+void host_Dma_Done(DMA_HandleTypeDef * hdma)
+{
+    uint8_t index = host_Dma_Index(hdma);
+    sHost_Dma * pDma = &gHost_Dmas[index];
+
+    if (pDma->active == 0) {
+        return;
+    }
+    hdma->Instance->NDTR = 1;
+    host_Dma_Count(pDma, index);
+}
+
+/**
+ * @brief  DMA 初始化
+ * @note   写入流配置寄存器
+ * @param  hdma DMA 句柄
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef * hdma)
+{
+    hdma->Instance->CR = hdma->Init.Channel | hdma->Init.Direction | hdma->Init.PeriphInc | hdma->Init.MemInc | hdma->Init.PeriphDataAlignment |
+                         hdma->Init.MemDataAlignment | hdma->Init.Mode | hdma->Init.Priority;
+    hdma->ErrorCode = HAL_DMA_ERROR_NONE;
+    hdma->State = HAL_DMA_STATE_READY;
+    return HAL_OK;
+}
+
+/**
+ * @brief  DMA 复位
+ * @param  hdma DMA 句柄
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef * hdma)
+{
+    host_Dma_Stop(hdma);
+    hdma->Instance->CR = 0;
+    hdma->State = HAL_DMA_STATE_RESET;
+    return HAL_OK;
+}
+
+/**
+ * @brief  DMA 中断处理
+ * @note   与 HAL 一致 非循环模式传输完成后关闭中断 句柄就绪
+ * @param  hdma DMA 句柄
+ * @retval None
+ */
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef * hdma)
+{
+    uint8_t index = host_Dma_Index(hdma);
+    __IO uint32_t * pISR;
+    uint8_t shift;
+
+    shift = host_Dma_Flag_Shift(index, &pISR);
+    if ((*pISR & (DMA_FLAG_HTIF0_4 << shift)) && (hdma->Instance->CR & DMA_SxCR_HTIE)) {
+        *pISR &= ~(DMA_FLAG_HTIF0_4 << shift);
+        if ((hdma->Instance->CR & DMA_SxCR_CIRC) == 0) {
+            hdma->Instance->CR &= ~DMA_SxCR_HTIE;
+        }
+        if (hdma->XferHalfCpltCallback != NULL) {
+            hdma->XferHalfCpltCallback(hdma);
+        }
+    }
+    if ((*pISR & (DMA_FLAG_TCIF0_4 << shift)) && (hdma->Instance->CR & DMA_SxCR_TCIE)) {
+        *pISR &= ~(DMA_FLAG_TCIF0_4 << shift);
+        if ((hdma->Instance->CR & DMA_SxCR_CIRC) == 0) {
+            hdma->Instance->CR &= ~(DMA_SxCR_TCIE | DMA_SxCR_HTIE | DMA_SxCR_TEIE | DMA_SxCR_DMEIE);
+            hdma->State = HAL_DMA_STATE_READY;
+        }
+        if (hdma->XferCpltCallback != NULL) {
+            hdma->XferCpltCallback(hdma);
+        }
+    }
+}
+
+/* 定时器 ---------------------------------------------------------------------*/
+
+/**
+ * @brief  定时器 是否高级定时器
+ * @param  tim 定时器
+ * @retval 1 TIM1 TIM8
+ */
+static uint8_t host_Tim_Is_Advanced(TIM_TypeDef * tim)
+{
+    return tim == TIM1 || tim == TIM8;
+}
+
+/**
+ * @brief  定时器 基本配置
+ * @note   与 TIM_Base_SetConfig 一致 写入 PSC ARR RCR 立即生效
+ * @param  htim 定时器句柄
+ * @retval None
+ */
+static void host_Tim_Base_Config(TIM_HandleTypeDef * htim)
+{
+    TIM_TypeDef * tim = htim->Instance;
+
+    tim->CR1 = (tim->CR1 & ~(TIM_CR1_DIR | TIM_CR1_CMS | TIM_CR1_CKD | TIM_CR1_ARPE)) | htim->Init.CounterMode | htim->Init.ClockDivision |
+               htim->Init.AutoReloadPreload;
+    tim->ARR = htim->Init.Period;
+    tim->PSC = htim->Init.Prescaler;
+    if (host_Tim_Is_Advanced(tim)) {
+        tim->RCR = htim->Init.RepetitionCounter;
+    }
+    tim->EGR = TIM_EGR_UG;
+    htim->State = HAL_TIM_STATE_READY;
+}
+
+/**
+ * @brief  定时器 初始化
+ * @param  htim 定时器句柄
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef * htim)
+{
+    if (htim->State == HAL_TIM_STATE_RESET) {
+        htim->Lock = HAL_UNLOCKED;
+        HAL_TIM_Base_MspInit(htim);
+    }
+    host_Tim_Base_Config(htim);
+    return HAL_OK;
+}
+
+/**
+ * @brief  PWM 初始化
+ * @param  htim 定时器句柄
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_TIM_PWM_Init(TIM_HandleTypeDef * htim)
+{
+    if (htim->State == HAL_TIM_STATE_RESET) {
+        htim->Lock = HAL_UNLOCKED;
+        HAL_TIM_PWM_MspInit(htim);
+    }
+    host_Tim_Base_Config(htim);
+    return HAL_OK;
+}
+
+/**
+ * @brief  输入捕获 初始化
+ * @param  htim 定时器句柄
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_TIM_IC_Init(TIM_HandleTypeDef * htim)
+{
+    if (htim->State == HAL_TIM_STATE_RESET) {
+        htim->Lock = HAL_UNLOCKED;
+        HAL_TIM_IC_MspInit(htim);
+    }
+    host_Tim_Base_Config(htim);
+    return HAL_OK;
+}
+
+/**
+ * @brief  时钟源配置
+ * @note   仅内部时钟
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_TIM_ConfigClockSource(TIM_HandleTypeDef * htim, TIM_ClockConfigTypeDef * sClockSourceConfig)
+{
+    return HAL_OK;
+}
+
+/**
+ * @brief  主模式配置
+ * @note   写入 CR2 MMS ADC 触发按更新事件处理
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef * htim, TIM_MasterConfigTypeDef * sMasterConfig)
+{
+    htim->Instance->CR2 = (htim->Instance->CR2 & ~TIM_CR2_MMS) | sMasterConfig->MasterOutputTrigger;
+    return HAL_OK;
+}
+
+/**
+ * @brief  刹车与死区配置
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_TIMEx_ConfigBreakDeadTime(TIM_HandleTypeDef * htim, TIM_BreakDeadTimeConfigTypeDef * sBreakDeadTimeConfig)
+{
+    return HAL_OK;
+}
+
+/**
+ * @brief  比较寄存器
+ * @param  tim 定时器
+ * @param  Channel 通道
+ * @retval 寄存器地址
+ */
+static __IO uint32_t * host_Tim_CCR(TIM_TypeDef * tim, uint32_t Channel)
+{
+    return &tim->CCR1 + (Channel >> 2);
+}
+
+/**
+ * @brief  PWM 通道配置
+ * @note   写入比较值
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel(TIM_HandleTypeDef * htim, TIM_OC_InitTypeDef * sConfig, uint32_t Channel)
+{
+    *host_Tim_CCR(htim->Instance, Channel) = sConfig->Pulse;
+    return HAL_OK;
+}
+
+/**
+ * @brief  输入捕获 通道配置
+ * @note   通道选择为输入 (CCxS = 01)
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_TIM_IC_ConfigChannel(TIM_HandleTypeDef * htim, TIM_IC_InitTypeDef * sConfig, uint32_t Channel)
+{
+    __IO uint32_t * pCCMR = (Channel < TIM_CHANNEL_3) ? (&htim->Instance->CCMR1) : (&htim->Instance->CCMR2);
+    uint32_t shift = (Channel & TIM_CHANNEL_2) ? (8) : (0);
+
+    *pCCMR = (*pCCMR & ~(TIM_CCMR1_CC1S << shift)) | (sConfig->ICSelection << shift);
+    return HAL_OK;
+}
+
+/**
+ * @brief  定时器 启动
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef * htim)
+{
+    htim->State = HAL_TIM_STATE_BUSY;
+    htim->Instance->CR1 |= TIM_CR1_CEN;
+    htim->State = HAL_TIM_STATE_READY;
+    return HAL_OK;
+}
+
+/**
+ * @brief  定时器 启动 更新中断
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef * htim)
+{
+    htim->Instance->DIER |= TIM_DIER_UIE;
+    htim->Instance->CR1 |= TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+/**
+ * @brief  定时器 停止 更新中断
+ * @note   与 HAL 一致 所有通道关闭时才停止计数
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef * htim)
+{
+    htim->Instance->DIER &= ~TIM_DIER_UIE;
+    if ((htim->Instance->CCER & (TIM_CCER_CC1E | TIM_CCER_CC2E | TIM_CCER_CC3E | TIM_CCER_CC4E)) == 0) {
+        htim->Instance->CR1 &= ~TIM_CR1_CEN;
+    }
+    return HAL_OK;
+}
+
+/**
+ * @brief  PWM 启动
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef * htim, uint32_t Channel)
+{
+    htim->Instance->CCER |= TIM_CCER_CC1E << Channel;
+    if (host_Tim_Is_Advanced(htim->Instance)) {
+        htim->Instance->BDTR |= TIM_BDTR_MOE;
+    }
+    htim->Instance->CR1 |= TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+/**
+ * @brief  PWM 停止
+ * @note   与 HAL 一致 所有通道关闭时才停止计数
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_TIM_PWM_Stop(TIM_HandleTypeDef * htim, uint32_t Channel)
+{
+    htim->Instance->CCER &= ~(TIM_CCER_CC1E << Channel);
+    if ((htim->Instance->CCER & (TIM_CCER_CC1E | TIM_CCER_CC2E | TIM_CCER_CC3E | TIM_CCER_CC4E)) == 0) {
+        if (host_Tim_Is_Advanced(htim->Instance)) {
+            htim->Instance->BDTR &= ~TIM_BDTR_MOE;
+        }
+        htim->Instance->CR1 &= ~TIM_CR1_CEN;
+    }
+    return HAL_OK;
+}
+
+/**
+ * @brief  输入捕获 启动
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_TIM_IC_Start_IT(TIM_HandleTypeDef * htim, uint32_t Channel)
+{
+    htim->Instance->DIER |= TIM_DIER_CC1IE << (Channel >> 2);
+    htim->Instance->CCER |= TIM_CCER_CC1E << Channel;
+    htim->Instance->CR1 |= TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+/**
+ * @brief  输入捕获 停止
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_TIM_IC_Stop_IT(TIM_HandleTypeDef * htim, uint32_t Channel)
+{
+    htim->Instance->DIER &= ~(TIM_DIER_CC1IE << (Channel >> 2));
+    htim->Instance->CCER &= ~(TIM_CCER_CC1E << Channel);
+    if ((htim->Instance->CCER & (TIM_CCER_CC1E | TIM_CCER_CC2E | TIM_CCER_CC3E | TIM_CCER_CC4E)) == 0) {
+        htim->Instance->CR1 &= ~TIM_CR1_CEN;
+    }
+    return HAL_OK;
+}
+
+/**
+ * @brief  输入捕获值
+ * @param  htim 定时器句柄
+ * @param  Channel 通道
+ * @retval 捕获值
+ */
+uint32_t HAL_TIM_ReadCapturedValue(TIM_HandleTypeDef * htim, uint32_t Channel)
+{
+    return *host_Tim_CCR(htim->Instance, Channel);
+}
+
+/**
+ * @brief  定时器 中断处理
+ * @note   与 HAL 一致 比较捕获 1~4 更新事件 标志与中断使能同时置位时清除标志并回调
+ * @param  htim 定时器句柄
+ * @retval None
+ */
+void HAL_TIM_IRQHandler(TIM_HandleTypeDef * htim)
+{
+    const HAL_TIM_ActiveChannel cActive[4] = {HAL_TIM_ACTIVE_CHANNEL_1, HAL_TIM_ACTIVE_CHANNEL_2, HAL_TIM_ACTIVE_CHANNEL_3, HAL_TIM_ACTIVE_CHANNEL_4};
+    TIM_TypeDef * tim = htim->Instance;
+    uint32_t ccmr;
+    uint8_t i;
+
+    for (i = 0; i < 4; ++i) {
+        if ((tim->SR & (TIM_SR_CC1IF << i)) == 0 || (tim->DIER & (TIM_DIER_CC1IE << i)) == 0) {
+            continue;
+        }
+        tim->SR &= ~(TIM_SR_CC1IF << i);
+        htim->Channel = cActive[i];
+        ccmr = (i < 2) ? (tim->CCMR1) : (tim->CCMR2);
+        if ((ccmr >> ((i & 1) * 8)) & TIM_CCMR1_CC1S) {
+            HAL_TIM_IC_CaptureCallback(htim);
+        } else {
+            HAL_TIM_OC_DelayElapsedCallback(htim);
+            HAL_TIM_PWM_PulseFinishedCallback(htim);
+        }
+        htim->Channel = HAL_TIM_ACTIVE_CHANNEL_CLEARED;
+    }
+    if ((tim->SR & TIM_SR_UIF) && (tim->DIER & TIM_DIER_UIE)) {
+        tim->SR &= ~TIM_SR_UIF;
+        HAL_TIM_PeriodElapsedCallback(htim);
+    }
+}
+
+/**
+ * @brief  定时器 更新事件 DMA 突发写
+ * @note   更新事件时 按 DCR 从 DBA 起连续写入 DBL+1 个寄存器
+ * @param  arg 定时器句柄
+ * @retval None
+ */
+static void host_Tim_Burst_Update(void * arg)
+{
+    TIM_HandleTypeDef * htim = arg;
+    TIM_TypeDef * tim = htim->Instance;
+    DMA_HandleTypeDef * hdma = htim->hdma[TIM_DMA_ID_UPDATE];
+    uint32_t base, length, value, i;
+
+    if ((tim->DIER & TIM_DIER_UDE) == 0 || hdma == NULL || host_Dma_Is_Active(hdma) == 0) {
+        return;
+    }
+    base = tim->DCR & TIM_DCR_DBA;
+    length = ((tim->DCR & TIM_DCR_DBL) >> TIM_DCR_DBL_Pos) + 1;
+    for (i = 0; i < length; ++i) {
+        if (host_Dma_Get(hdma, &value, sizeof(value)) == 0) {
+            break;
+        }
+        (&tim->CR1)[base + i] = value;
+    }
+}
+
+/**
+ * @brief  定时器 DMA 完成回调
+ * @note   与 TIM_DMAPeriodElapsedCplt 一致
+ * @param  hdma DMA 句柄
+ * @retval None
+ */
+static void host_Tim_Dma_Cplt(DMA_HandleTypeDef * hdma)
+{
+    TIM_HandleTypeDef * htim = hdma->Parent;
+
+    htim->State = HAL_TIM_STATE_READY;
+    HAL_TIM_PeriodElapsedCallback(htim);
+}
+
+/**
+ * @brief  定时器 DMA 半完成回调
+ * @note   与 TIM_DMAPeriodElapsedHalfCplt 一致
+ * @param  hdma DMA 句柄
+ * @retval None
+ */
+static void host_Tim_Dma_Half_Cplt(DMA_HandleTypeDef * hdma)
+{
+    TIM_HandleTypeDef * htim = hdma->Parent;
+
+    htim->State = HAL_TIM_STATE_READY;
+    HAL_TIM_PeriodElapsedHalfCpltCallback(htim);
+}
+
+/**
+ * @brief  DMA 突发写 启动
+ * @note   仅支持更新事件请求 长度与 HAL 一致为一次突发 (DBL + 1)
+ * @retval HAL_OK HAL_BUSY HAL_ERROR
+ */
+HAL_StatusTypeDef HAL_TIM_DMABurst_WriteStart(TIM_HandleTypeDef * htim, uint32_t BurstBaseAddress, uint32_t BurstRequestSrc, uint32_t * BurstBuffer,
+                                              uint32_t BurstLength)
+{
+    uint8_t index = (htim->Instance == TIM1) ? (0) : (1);
+
+    if (BurstRequestSrc != TIM_DMA_UPDATE || host_Tim_Is_Advanced(htim->Instance) == 0) {
+        return HAL_ERROR;
+    }
+    if (htim->State == HAL_TIM_STATE_BUSY) {
+        return HAL_BUSY;
+    }
+    if (BurstBuffer == NULL && BurstLength > 0) {
+        return HAL_ERROR;
+    }
+    htim->State = HAL_TIM_STATE_BUSY;
+    if (gHost_Tim_Bursts[index] == NULL) {
+        gHost_Tim_Bursts[index] = htim;
+        host_Tim_Watch(htim->Instance, host_Tim_Burst_Update, htim);
+    }
+    htim->hdma[TIM_DMA_ID_UPDATE]->XferCpltCallback = host_Tim_Dma_Cplt;
+    htim->hdma[TIM_DMA_ID_UPDATE]->XferHalfCpltCallback = host_Tim_Dma_Half_Cplt;
+    host_Dma_Start(htim->hdma[TIM_DMA_ID_UPDATE], BurstBuffer, (BurstLength >> 8) + 1);
+    htim->Instance->DCR = BurstBaseAddress | BurstLength;
+    htim->Instance->DIER |= TIM_DIER_UDE;
+    return HAL_OK;
+}
+
+/**
+ * @brief  DMA 突发写 停止
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_TIM_DMABurst_WriteStop(TIM_HandleTypeDef * htim, uint32_t BurstRequestSrc)
+{
+    if (BurstRequestSrc == TIM_DMA_UPDATE && htim->hdma[TIM_DMA_ID_UPDATE] != NULL) {
+        host_Dma_Stop(htim->hdma[TIM_DMA_ID_UPDATE]);
+    }
+    htim->Instance->DIER &= ~BurstRequestSrc;
+    htim->State = HAL_TIM_STATE_READY;
+    return HAL_OK;
+}
+
+/* ADC ------------------------------------------------------------------------*/
+
+/**
+ * @brief  ADC 模型
+ * @param  adc ADC
+ * @retval 模型
+ */
+static sHost_Adc * host_Adc_Get(ADC_TypeDef * adc)
+{
+    sHost_Adc * pAdc = &gHost_Adcs[(adc == ADC1) ? (0) : (1)];
+    uint8_t i;
+
+    if (pAdc->values[0] == 0) {
+        for (i = 0; i < HOST_ADC_CHANNEL_NUM; ++i) {
+            pAdc->values[i] = HOST_ADC_DEFAULT;
+        }
+    }
+    return pAdc;
+}
+
+/**
+ * @brief  ADC 通道转换值 设置
+ * @param  adc ADC
+ * @param  channel 通道
+ * @param  value 转换值 12位
+ * @retval None
+ */
+void host_Adc_Set(ADC_TypeDef * adc, uint32_t channel, uint16_t value)
+{
+    host_Adc_Get(adc)->values[channel] = value & 0x0FFF;
+}
+
+/**
+ * @brief  ADC 规则序列转换 经 DMA 写入
+ * @note   触发定时器更新事件时调用
+ * @param  arg ADC 模型
+ * @retval None
+ */
+static void host_Adc_Trigger(void * arg)
+{
+    sHost_Adc * pAdc = arg;
+    ADC_HandleTypeDef * hadc = pAdc->hadc;
+    uint32_t i, value;
+
+    if ((hadc->Instance->CR2 & ADC_CR2_DMA) == 0 || hadc->DMA_Handle == NULL) {
+        return;
+    }
+    for (i = 0; i < hadc->Init.NbrOfConversion && i < HOST_ADC_RANK_MAX; ++i) {
+        value = pAdc->values[pAdc->ranks[i]];
+        hadc->Instance->DR = value;
+        host_Dma_Put(hadc->DMA_Handle, &value, sizeof(value));
+    }
+}
+
+/**
+ * @brief  ADC 初始化
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef * hadc)
+{
+    if (hadc->State == HAL_ADC_STATE_RESET) {
+        hadc->Lock = HAL_UNLOCKED;
+        HAL_ADC_MspInit(hadc);
+    }
+    host_Adc_Get(hadc->Instance)->hadc = hadc;
+    hadc->State = HAL_ADC_STATE_READY;
+    return HAL_OK;
+}
+
+/**
+ * @brief  ADC 通道配置
+ * @note   记录规则序列
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef * hadc, ADC_ChannelConfTypeDef * sConfig)
+{
+    if (sConfig->Rank >= 1 && sConfig->Rank <= HOST_ADC_RANK_MAX) {
+        host_Adc_Get(hadc->Instance)->ranks[sConfig->Rank - 1] = sConfig->Channel;
+    }
+    return HAL_OK;
+}
+
+/**
+ * @brief  ADC DMA 回调 转换完成
+ * @param  hdma DMA 句柄
+ * @retval None
+ */
+static void host_Adc_Dma_Cplt(DMA_HandleTypeDef * hdma)
+{
+    HAL_ADC_ConvCpltCallback(hdma->Parent);
+}
+
+/**
+ * @brief  ADC DMA 回调 转换一半
+ * @param  hdma DMA 句柄
+ * @retval None
+ */
+static void host_Adc_Dma_Half_Cplt(DMA_HandleTypeDef * hdma)
+{
+    HAL_ADC_ConvHalfCpltCallback(hdma->Parent);
+}
+
+/**
+ * @brief  ADC DMA 启动
+ * @note   外部触发为定时器 2 时 挂接更新事件
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef * hadc, uint32_t * pData, uint32_t Length)
+{
+    sHost_Adc * pAdc = host_Adc_Get(hadc->Instance);
+
+    pAdc->hadc = hadc;
+    hadc->DMA_Handle->XferCpltCallback = host_Adc_Dma_Cplt;
+    hadc->DMA_Handle->XferHalfCpltCallback = host_Adc_Dma_Half_Cplt;
+    host_Dma_Start(hadc->DMA_Handle, pData, Length);
+    hadc->Instance->CR2 |= ADC_CR2_DMA | ADC_CR2_ADON;
+    if (hadc->Init.ExternalTrigConv == ADC_EXTERNALTRIGCONV_T2_TRGO && pAdc->watched == 0) {
+        pAdc->watched = 1;
+        host_Tim_Watch(TIM2, host_Adc_Trigger, pAdc);
+    }
+    return HAL_OK;
+}
+
+/**
+ * @brief  ADC DMA 停止
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef * hadc)
+{
+    hadc->Instance->CR2 &= ~(ADC_CR2_DMA | ADC_CR2_ADON);
+    host_Dma_Stop(hadc->DMA_Handle);
+    return HAL_OK;
+}
+
+/**
+ * @brief  ADC 软件触发 启动
+ * @note   立即完成规则序列第一个通道
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_ADC_Start(ADC_HandleTypeDef * hadc)
+{
+    sHost_Adc * pAdc = host_Adc_Get(hadc->Instance);
+
+    hadc->Instance->CR2 |= ADC_CR2_ADON;
+    hadc->Instance->DR = pAdc->values[pAdc->ranks[0]];
+    hadc->Instance->SR |= ADC_SR_EOC;
+    return HAL_OK;
+}
+
+/**
+ * @brief  ADC 停止
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_ADC_Stop(ADC_HandleTypeDef * hadc)
+{
+    hadc->Instance->CR2 &= ~ADC_CR2_ADON;
+    return HAL_OK;
+}
+
+/**
+ * @brief  ADC 等待转换完成
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_ADC_PollForConversion(ADC_HandleTypeDef * hadc, uint32_t Timeout)
+{
+    return (hadc->Instance->SR & ADC_SR_EOC) ? (HAL_OK) : (HAL_TIMEOUT);
+}
+
+/**
+ * @brief  ADC 转换值
+ * @retval 转换值
+ */
+uint32_t HAL_ADC_GetValue(ADC_HandleTypeDef * hadc)
+{
+    hadc->Instance->SR &= ~ADC_SR_EOC;
+    return hadc->Instance->DR;
+}
+
+/* SPI ------------------------------------------------------------------------*/
+
+/**
+ * @brief  SPI 片选变化
+ * @param  arg SPI 设备
+ * @param  port 端口
+ * @param  pin 引脚
+ * @param  level 电平
+ * @retval None
+ */
+static void host_Spi_Cs_Changed(void * arg, GPIO_TypeDef * port, uint16_t pin, uint8_t level)
+{
+    sHost_Spi * pSpi = arg;
+
+    if (pSpi->device.select != NULL) {
+        pSpi->device.select(pSpi->device.arg, level == 0);
+    }
+}
+
+/**
+ * @brief  SPI 挂接设备
+ * @param  spi SPI
+ * @param  cs_port 片选端口
+ * @param  cs_pin 片选引脚 低有效
+ * @param  pDevice 设备
+ * @retval None
+ */
+void host_Spi_Attach(SPI_TypeDef * spi, GPIO_TypeDef * cs_port, uint16_t cs_pin, const sHost_Spi_Device * pDevice)
+{
+    sHost_Spi * pSpi;
+
+    if (gHost_Spi_Num >= ARRAY_LEN(gHost_Spis)) {
+        abort();
+    }
+    pSpi = &gHost_Spis[gHost_Spi_Num++];
+    pSpi->spi = spi;
+    pSpi->cs_port = cs_port;
+    pSpi->cs_pin = cs_pin;
+    pSpi->device = *pDevice;
+    host_Gpio_Watch(cs_port, cs_pin, host_Spi_Cs_Changed, pSpi);
+}
+
+/**
+ * @brief  SPI 初始化
+ * @note   写入 CR1 (波特率分频 时钟极性相位)
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef * hspi)
+{
+    if (hspi->State == HAL_SPI_STATE_RESET) {
+        hspi->Lock = HAL_UNLOCKED;
+        HAL_SPI_MspInit(hspi);
+    }
+    hspi->Instance->CR1 = hspi->Init.Mode | hspi->Init.Direction | hspi->Init.DataSize | hspi->Init.CLKPolarity | hspi->Init.CLKPhase |
+                          (hspi->Init.NSS & SPI_CR1_SSM) | hspi->Init.BaudRatePrescaler | hspi->Init.FirstBit | SPI_CR1_SPE;
+    hspi->ErrorCode = HAL_SPI_ERROR_NONE;
+    hspi->State = HAL_SPI_STATE_READY;
+    return HAL_OK;
+}
+
+/**
+ * @brief  SPI 全双工传输
+ * @note   逐字节与片选有效的设备交换 无设备时读回 0xFF 按波特率忙等
+ * @retval HAL_OK HAL_BUSY
+ */
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef * hspi, uint8_t * pTxData, uint8_t * pRxData, uint16_t Size, uint32_t Timeout)
+{
+    sHost_Spi * pSpi = NULL;
+    uint32_t pclk, div;
+    uint16_t i;
+    uint8_t j;
+
+    if (hspi->State != HAL_SPI_STATE_READY) {
+        return HAL_BUSY;
+    }
+    hspi->State = HAL_SPI_STATE_BUSY_TX_RX;
+    for (j = 0; j < gHost_Spi_Num; ++j) {
+        if (gHost_Spis[j].spi == hspi->Instance && (gHost_Spis[j].cs_port->ODR & gHost_Spis[j].cs_pin) == 0) {
+            pSpi = &gHost_Spis[j];
+            break;
+        }
+    }
+    for (i = 0; i < Size; ++i) {
+        pRxData[i] = (pSpi != NULL) ? (pSpi->device.swap(pSpi->device.arg, pTxData[i])) : (0xFF);
+    }
+    pclk = (hspi->Instance == SPI1) ? (gHost_PCLK2) : (gHost_PCLK1);
+    div = 2UL << ((hspi->Instance->CR1 & SPI_CR1_BR) >> SPI_CR1_BR_Pos);
+    hspi->State = HAL_SPI_STATE_READY;
+    host_Time_Busy((uint64_t)Size * 8 * div * HOST_NS_PER_S / pclk);
+    return HAL_OK;
+}
+
+/* I2C ------------------------------------------------------------------------*/
+
+/**
+ * @brief  I2C 初始化
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef * hi2c)
+{
+    if (hi2c->State == HAL_I2C_STATE_RESET) {
+        hi2c->Lock = HAL_UNLOCKED;
+        HAL_I2C_MspInit(hi2c);
+    }
+    hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+    hi2c->State = HAL_I2C_STATE_READY;
+    return HAL_OK;
+}
+
+/**
+ * @brief  I2C 主机发送
+ * @note   无器件 地址无应答
+ * @retval HAL_ERROR
+ */
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef * hi2c, uint16_t DevAddress, uint8_t * pData, uint16_t Size, uint32_t Timeout)
+{
+    host_Time_Busy(9 * HOST_NS_PER_S / hi2c->Init.ClockSpeed);
+    hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+    return HAL_ERROR;
+}
+
+/**
+ * @brief  I2C 主机接收
+ * @note   无器件 地址无应答
+ * @retval HAL_ERROR
+ */
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef * hi2c, uint16_t DevAddress, uint8_t * pData, uint16_t Size, uint32_t Timeout)
+{
+    host_Time_Busy(9 * HOST_NS_PER_S / hi2c->Init.ClockSpeed);
+    hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+    return HAL_ERROR;
+}
+
+/* Flash ----------------------------------------------------------------------*/
+
+/**
+ * @brief  内部 Flash 解锁
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+    gHost_Flash_Locked = 0;
+    return HAL_OK;
+}
+
+/**
+ * @brief  内部 Flash 上锁
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+    gHost_Flash_Locked = 1;
+    return HAL_OK;
+}
+
+/**
+ * @brief  内部 Flash 编程
+ * @note   与硬件一致 只能由 1 写为 0
+ * @retval HAL_OK HAL_ERROR
+ */
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+    const uint8_t cSize[4] = {1, 2, 4, 8};
+    uint8_t * pDst = (uint8_t *)(uintptr_t)Address;
+    uint8_t i;
+
+    if (gHost_Flash_Locked || Address < FLASH_BASE || Address + cSize[TypeProgram & 3] > FLASH_END + 1) {
+        return HAL_ERROR;
+    }
+    for (i = 0; i < cSize[TypeProgram & 3]; ++i) {
+        pDst[i] &= (uint8_t)(Data >> (i * 8));
+    }
+    host_Time_Busy(cSize[TypeProgram & 3] * 16 * HOST_NS_PER_US);
+    return HAL_OK;
+}
+
+/**
+ * @brief  内部 Flash 擦除
+ * @note   扇区 0~3 16K 4 64K 5~11 128K
+ * @retval HAL_OK HAL_ERROR
+ */
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef * pEraseInit, uint32_t * SectorError)
+{
+    uint32_t sector, start, size;
+
+    if (gHost_Flash_Locked || pEraseInit->TypeErase != FLASH_TYPEERASE_SECTORS) {
+        return HAL_ERROR;
+    }
+    *SectorError = 0xFFFFFFFFU;
+    for (sector = pEraseInit->Sector; sector < pEraseInit->Sector + pEraseInit->NbSectors && sector < 12; ++sector) {
+        if (sector < 4) {
+            start = sector * 0x4000;
+            size = 0x4000;
+        } else if (sector == 4) {
+            start = 0x10000;
+            size = 0x10000;
+        } else {
+            start = (sector - 4) * 0x20000;
+            size = 0x20000;
+        }
+        memset((void *)(uintptr_t)(FLASH_BASE + start), 0xFF, size);
+        host_Time_Busy(size / 0x4000 * 250 * HOST_NS_PER_MS);
+    }
+    return HAL_OK;
+}
+
+/* 默认回调 -------------------------------------------------------------------*/
+
+__weak void HAL_MspInit(void)
+{
+}
+
+__weak void HAL_ADC_MspInit(ADC_HandleTypeDef * hadc)
+{
+}
+
+__weak void HAL_I2C_MspInit(I2C_HandleTypeDef * hi2c)
+{
+}
+
+__weak void HAL_SPI_MspInit(SPI_HandleTypeDef * hspi)
+{
+}
+
+__weak void HAL_TIM_Base_MspInit(TIM_HandleTypeDef * htim)
+{
+}
+
+__weak void HAL_TIM_PWM_MspInit(TIM_HandleTypeDef * htim)
+{
+}
+
+__weak void HAL_TIM_IC_MspInit(TIM_HandleTypeDef * htim)
+{
+}
+
+__weak void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+}
+
+__weak void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef * hadc)
+{
+}
+
+__weak void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef * hadc)
+{
+}
+
+__weak void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef * htim)
+{
+}
+
+__weak void HAL_TIM_PeriodElapsedHalfCpltCallback(TIM_HandleTypeDef * htim)
+{
+}
+
+__weak void HAL_TIM_OC_DelayElapsedCallback(TIM_HandleTypeDef * htim)
+{
+}
+
+__weak void HAL_TIM_PWM_PulseFinishedCallback(TIM_HandleTypeDef * htim)
+{
+}
+
+__weak void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef * htim)
+{
+}
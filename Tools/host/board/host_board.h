@@ -0,0 +1,71 @@
+/**
+ * @file    host_board.h
+ * @brief   主机构建 板级模型
+ *
+ * 外设寄存器 映射为主机内存窗口 (地址与 STM32F207 一致) 固件寄存器宏直接读写
+ * HAL 函数为桩 (hal_stub.c) 按寄存器与句柄状态驱动外设模型
+ * 虚拟时间 单位 nS 仅在 空闲钩子 / HAL_Delay 等忙等 / 阻塞传输 中推进 任务运行不消耗虚拟时间
+ * 外设模型与对端设备 以事件形式挂在时间轴上 事件中调用固件中断处理函数
+ */
+
+#ifndef __HOST_BOARD_H
+#define __HOST_BOARD_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "stm32f2xx.h"
+
+/* Exported macro ------------------------------------------------------------*/
+#define HOST_NS_PER_US 1000ULL
+#define HOST_NS_PER_MS 1000000ULL
+#define HOST_NS_PER_S 1000000000ULL
+
+/* Exported types ------------------------------------------------------------*/
+typedef void (*host_Event_Fun)(void * arg);
+
+/* GPIO 输出变化回调 */
+typedef void (*host_Gpio_Watch_Fun)(void * arg, GPIO_TypeDef * port, uint16_t pin, uint8_t level);
+
+/* 串口 控制板发出数据回调 整块发送结束时刻调用 */
+typedef void (*host_Uart_Tx_Fun)(void * arg, const uint8_t * pData, uint16_t length);
+
+/* SPI 设备 片选期间逐字节交换 */
+typedef struct {
+    uint8_t (*swap)(void * arg, uint8_t mosi); /* 交换一个字节 */
+    void (*select)(void * arg, uint8_t active); /* 片选变化 */
+    void * arg;
+} sHost_Spi_Device;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void host_Board_Init(void);
+void host_Board_Step(void);
+void host_Board_Exit(int code);
+
+uint64_t host_Time_Now(void);
+void host_Time_Busy(uint64_t ns);
+void host_Time_Run_Until(uint64_t time);
+
+void host_Event_At(uint64_t time, host_Event_Fun fun, void * arg);
+void host_Event_After(uint64_t delay, host_Event_Fun fun, void * arg);
+void host_Event_Cancel(host_Event_Fun fun, void * arg);
+
+void host_Irq_Raise(IRQn_Type irqn);
+void host_Irq_Dispatch(void);
+
+void host_Gpio_Input(GPIO_TypeDef * port, uint16_t pin, uint8_t level);
+void host_Gpio_Watch(GPIO_TypeDef * port, uint16_t pins, host_Gpio_Watch_Fun fun, void * arg);
+void host_Gpio_Output_Changed(GPIO_TypeDef * port, uint16_t pins, uint16_t before);
+
+uint32_t host_Tim_Clock(TIM_TypeDef * tim);
+void host_Tim_Watch(TIM_TypeDef * tim, host_Event_Fun fun, void * arg);
+
+void host_Uart_Connect(USART_TypeDef * uart, host_Uart_Tx_Fun fun, void * arg);
+void host_Uart_Send(USART_TypeDef * uart, const uint8_t * pData, uint16_t length);
+uint64_t host_Uart_Byte_Time(USART_TypeDef * uart);
+uint8_t host_Uart_Is_Idle(USART_TypeDef * uart);
+
+void host_Adc_Set(ADC_TypeDef * adc, uint32_t channel, uint16_t value);
+
+void host_Spi_Attach(SPI_TypeDef * spi, GPIO_TypeDef * cs_port, uint16_t cs_pin, const sHost_Spi_Device * pDevice);
+
+#endif
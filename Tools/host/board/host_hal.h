@@ -0,0 +1,35 @@
+/**
+ * @file    host_hal.h
+ * @brief   主机构建 HAL 桩 内部接口
+ *
+ * 板级模型各文件之间共享 测试与外设模型使用 host_board.h
+ */
+
+#ifndef __HOST_HAL_H
+#define __HOST_HAL_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "host_board.h"
+
+/* Exported variables --------------------------------------------------------*/
+extern uint32_t gHost_PCLK1;
+extern uint32_t gHost_PCLK2;
+
+/* Exported functions prototypes ---------------------------------------------*/
+uint32_t ulPortHostIsrEnter(uint32_t ulException);
+void vPortHostIsrExit(uint32_t ulOriginal);
+uint8_t ucPortHostIrqMasked(int32_t lPriority);
+
+void host_Uart_Init(void);
+
+void host_Dma_Start(DMA_HandleTypeDef * hdma, void * pBuffer, uint32_t length);
+void host_Dma_Stop(DMA_HandleTypeDef * hdma);
+uint8_t host_Dma_Is_Active(DMA_HandleTypeDef * hdma);
+uint8_t host_Dma_Put(DMA_HandleTypeDef * hdma, const void * pItem, uint8_t width);
+void host_Dma_Done(DMA_HandleTypeDef * hdma);
+uint8_t host_Dma_Get(DMA_HandleTypeDef * hdma, void * pItem, uint8_t width);
+
+uint8_t host_Gpio_Is_Driven(GPIO_TypeDef * port, uint16_t pin);
+
+#endif
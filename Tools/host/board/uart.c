@@ -0,0 +1,511 @@
+/**
+ * @file    uart.c
+ * @brief   主机构建 串口 HAL 桩与线路模型
+ *
+ * 对端数据 (host_Uart_Send) 按波特率逐字节到达
+ *     DMA 接收中 经 DMA 写入存储区 否则写入 DR 置 RXNE (未读取时置 ORE)
+ *     最后一个字节后一个字节时间无数据 置 IDLE 使能空闲中断时触发串口中断
+ * 控制板发出数据 整块发送结束时刻交给对端回调 (host_Uart_Connect)
+ *     DMA 发送 结束时 DMA 传输完成中断 -> 使能 TC 中断 -> 串口中断 -> 发送完成回调 与 HAL 一致
+ *     中断发送 结束时 串口中断 -> 发送完成回调
+ *     阻塞收发 忙等虚拟时间 期间中断照常响应
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_hal.h"
+
+/* Private define ------------------------------------------------------------*/
+#define HOST_UART_NUM 4           /* USART1 USART2 USART3 UART5 */
+#define HOST_UART_RX_FIFO 0x4000  /* 对端待发送数据 */
+#define HOST_UART_TX_MAX 0x400    /* 控制板单次发送长度上限 */
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    USART_TypeDef * uart;
+    IRQn_Type irqn;
+    UART_HandleTypeDef * huart;
+    host_Uart_Tx_Fun tx_fun; /* 对端接收 */
+    void * tx_arg;
+    uint8_t tx_buffer[HOST_UART_TX_MAX]; /* 发送中数据 */
+    uint16_t tx_length;
+    uint8_t tx_dma; /* DMA 发送 */
+    uint8_t rx_fifo[HOST_UART_RX_FIFO];
+    uint32_t rx_head;
+    uint32_t rx_tail;
+    uint8_t rx_busy;  /* 字节传输中 */
+    uint8_t rx_since; /* 上次空闲后已接收 */
+} sHost_Uart;
+
+/* Private variables ---------------------------------------------------------*/
+static sHost_Uart gHost_Uarts[HOST_UART_NUM];
+
+/* Private function prototypes -----------------------------------------------*/
+static void host_Uart_Rx_Byte(void * arg);
+
+/* Private user code ---------------------------------------------------------*/
+
+/**
+ * @brief  串口模型 初始化
+ * @param  None
+ * @retval None
+ */
+void host_Uart_Init(void)
+{
+    const USART_TypeDef * cUarts[HOST_UART_NUM] = {USART1, USART2, USART3, UART5};
+    const IRQn_Type cIrqns[HOST_UART_NUM] = {USART1_IRQn, USART2_IRQn, USART3_IRQn, UART5_IRQn};
+    uint8_t i;
+
+    memset(gHost_Uarts, 0, sizeof(gHost_Uarts));
+    for (i = 0; i < HOST_UART_NUM; ++i) {
+        gHost_Uarts[i].uart = (USART_TypeDef *)cUarts[i];
+        gHost_Uarts[i].irqn = cIrqns[i];
+    }
+}
+
+/**
+ * @brief  串口模型
+ * @param  uart 串口
+ * @retval 模型
+ */
+static sHost_Uart * host_Uart_Get(USART_TypeDef * uart)
+{
+    uint8_t i;
+
+    for (i = 0; i < HOST_UART_NUM; ++i) {
+        if (gHost_Uarts[i].uart == uart) {
+            return &gHost_Uarts[i];
+        }
+    }
+    fprintf(stderr, "host uart: unknown instance %p\n", (void *)uart);
+    abort();
+}
+
+/**
+ * @brief  串口 字节时间
+ * @note   8N1 10 位
+ * @param  uart 串口
+ * @retval 时间 nS
+ */
+uint64_t host_Uart_Byte_Time(USART_TypeDef * uart)
+{
+    sHost_Uart * pUart = host_Uart_Get(uart);
+    uint32_t baud = (pUart->huart != NULL) ? (pUart->huart->Init.BaudRate) : (115200);
+
+    return 10 * HOST_NS_PER_S / baud;
+}
+
+/**
+ * @brief  串口 对端接收回调
+ * @param  uart 串口
+ * @param  fun 回调 控制板整块发送结束时刻调用
+ * @param  arg 参数
+ * @retval None
+ */
+void host_Uart_Connect(USART_TypeDef * uart, host_Uart_Tx_Fun fun, void * arg)
+{
+    sHost_Uart * pUart = host_Uart_Get(uart);
+
+    pUart->tx_fun = fun;
+    pUart->tx_arg = arg;
+}
+
+/**
+ * @brief  串口 对端发送
+ * @note   排入线路 紧接已排队数据按字节时间到达
+ * @param  uart 串口
+ * @param  pData 数据
+ * @param  length 长度
+ * @retval None
+ */
+void host_Uart_Send(USART_TypeDef * uart, const uint8_t * pData, uint16_t length)
+{
+    sHost_Uart * pUart = host_Uart_Get(uart);
+    uint16_t i;
+
+    if (pUart->rx_tail - pUart->rx_head + length > HOST_UART_RX_FIFO) {
+        fprintf(stderr, "host uart: line fifo overflow\n");
+        abort();
+    }
+    for (i = 0; i < length; ++i) {
+        pUart->rx_fifo[(pUart->rx_tail++) % HOST_UART_RX_FIFO] = pData[i];
+    }
+    if (pUart->rx_busy == 0 && length > 0) {
+        pUart->rx_busy = 1;
+        host_Event_After(host_Uart_Byte_Time(uart), host_Uart_Rx_Byte, pUart);
+    }
+}
+
+/**
+ * @brief  串口 对端线路是否空闲
+ * @param  uart 串口
+ * @retval 1 排队数据已全部到达
+ */
+uint8_t host_Uart_Is_Idle(USART_TypeDef * uart)
+{
+    sHost_Uart * pUart = host_Uart_Get(uart);
+
+    return pUart->rx_busy == 0;
+}
+
+/**
+ * @brief  串口 字节到达 / 空闲检测
+ * @param  arg 串口模型
+ * @retval None
+ */
+static void host_Uart_Rx_Byte(void * arg)
+{
+    sHost_Uart * pUart = arg;
+    USART_TypeDef * uart = pUart->uart;
+    uint8_t data;
+
+    if (pUart->rx_head == pUart->rx_tail) { /* 一个字节时间无数据 */
+        pUart->rx_busy = 0;
+        if (pUart->rx_since) {
+            pUart->rx_since = 0;
+            uart->SR |= USART_SR_IDLE;
+            if (uart->CR1 & USART_CR1_IDLEIE) {
+                host_Irq_Raise(pUart->irqn);
+            }
+        }
+        return;
+    }
+    data = pUart->rx_fifo[(pUart->rx_head++) % HOST_UART_RX_FIFO];
+    pUart->rx_since = 1;
+    host_Event_After(host_Uart_Byte_Time(uart), host_Uart_Rx_Byte, pUart);
+    if ((uart->CR1 & USART_CR1_RE) == 0) {
+        return;
+    }
+    if ((uart->CR3 & USART_CR3_DMAR) && pUart->huart != NULL && pUart->huart->hdmarx != NULL && host_Dma_Is_Active(pUart->huart->hdmarx)) {
+        uart->DR = data;
+        host_Dma_Put(pUart->huart->hdmarx, &data, 1);
+        return;
+    }
+    if (uart->SR & USART_SR_RXNE) {
+        uart->SR |= USART_SR_ORE;
+    } else {
+        uart->DR = data;
+        uart->SR |= USART_SR_RXNE;
+    }
+}
+
+/**
+ * @brief  串口 发送结束
+ * @param  arg 串口模型
+ * @retval None
+ */
+static void host_Uart_Tx_End(void * arg)
+{
+    sHost_Uart * pUart = arg;
+    UART_HandleTypeDef * huart = pUart->huart;
+
+    if (pUart->tx_fun != NULL) {
+        pUart->tx_fun(pUart->tx_arg, pUart->tx_buffer, pUart->tx_length);
+    }
+    if (pUart->tx_dma) {
+        host_Dma_Done(huart->hdmatx); /* DMA 传输完成中断 */
+        return;
+    }
+    huart->TxXferCount = 0;
+    pUart->uart->SR |= USART_SR_TC;
+    pUart->uart->CR1 |= USART_CR1_TCIE;
+    host_Irq_Raise(pUart->irqn);
+}
+
+/**
+ * @brief  串口 开始发送
+ * @param  pUart 串口模型
+ * @param  pData 数据
+ * @param  Size 长度
+ * @param  dma DMA 发送
+ * @retval None
+ */
+static void host_Uart_Tx_Start(sHost_Uart * pUart, const uint8_t * pData, uint16_t Size, uint8_t dma)
+{
+    if (Size > HOST_UART_TX_MAX) {
+        fprintf(stderr, "host uart: transmit %u bytes over model limit\n", Size);
+        abort();
+    }
+    memcpy(pUart->tx_buffer, pData, Size);
+    pUart->tx_length = Size;
+    pUart->tx_dma = dma;
+    pUart->uart->SR &= ~USART_SR_TC;
+    host_Event_After(host_Uart_Byte_Time(pUart->uart) * Size, host_Uart_Tx_End, pUart);
+}
+
+/**
+ * @brief  串口 初始化
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef * huart)
+{
+    sHost_Uart * pUart = host_Uart_Get(huart->Instance);
+
+    if (huart->gState == HAL_UART_STATE_RESET) {
+        huart->Lock = HAL_UNLOCKED;
+        HAL_UART_MspInit(huart);
+    }
+    pUart->huart = huart;
+    huart->Instance->CR1 = huart->Init.WordLength | huart->Init.Parity | huart->Init.Mode | huart->Init.OverSampling | USART_CR1_UE;
+    huart->Instance->SR = USART_SR_TC | USART_SR_TXE;
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    huart->gState = HAL_UART_STATE_READY;
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+/**
+ * @brief  串口 DMA 发送完成
+ * @note   与 UART_DMATransmitCplt 一致 使能发送完成中断
+ * @param  hdma DMA 句柄
+ * @retval None
+ */
+static void host_Uart_Dma_Tx_Cplt(DMA_HandleTypeDef * hdma)
+{
+    UART_HandleTypeDef * huart = hdma->Parent;
+
+    huart->TxXferCount = 0;
+    huart->Instance->CR3 &= ~USART_CR3_DMAT;
+    huart->Instance->SR |= USART_SR_TC;
+    huart->Instance->CR1 |= USART_CR1_TCIE;
+    host_Irq_Raise(host_Uart_Get(huart->Instance)->irqn);
+}
+
+/**
+ * @brief  串口 DMA 发送
+ * @retval HAL_OK HAL_BUSY HAL_ERROR
+ */
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef * huart, uint8_t * pData, uint16_t Size)
+{
+    if (huart->gState != HAL_UART_STATE_READY) {
+        return HAL_BUSY;
+    }
+    if (pData == NULL || Size == 0) {
+        return HAL_ERROR;
+    }
+    huart->pTxBuffPtr = pData;
+    huart->TxXferSize = Size;
+    huart->TxXferCount = Size;
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    huart->hdmatx->XferCpltCallback = host_Uart_Dma_Tx_Cplt;
+    huart->hdmatx->XferHalfCpltCallback = NULL;
+    host_Dma_Start(huart->hdmatx, pData, Size);
+    huart->Instance->CR3 |= USART_CR3_DMAT;
+    host_Uart_Tx_Start(host_Uart_Get(huart->Instance), pData, Size, 1);
+    return HAL_OK;
+}
+
+/**
+ * @brief  串口 中断发送
+ * @retval HAL_OK HAL_BUSY HAL_ERROR
+ */
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef * huart, uint8_t * pData, uint16_t Size)
+{
+    if (huart->gState != HAL_UART_STATE_READY) {
+        return HAL_BUSY;
+    }
+    if (pData == NULL || Size == 0) {
+        return HAL_ERROR;
+    }
+    huart->pTxBuffPtr = pData;
+    huart->TxXferSize = Size;
+    huart->TxXferCount = Size;
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    host_Uart_Tx_Start(host_Uart_Get(huart->Instance), pData, Size, 0);
+    return HAL_OK;
+}
+
+/**
+ * @brief  串口 阻塞发送
+ * @note   忙等发送时长 超时按已写入数据寄存器部分交给对端
+ *         与 HAL 一致 逐字节等待 TXE 后写入 末尾等待 TC 首字节直接进入移位寄存器
+ *         超时时已写入的字节 (至多超时内发完的字节数 + 2) 仍会发出 仅 TC 等待超时时全部发出
+ * @retval HAL_OK HAL_BUSY HAL_ERROR HAL_TIMEOUT
+ */
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef * huart, uint8_t * pData, uint16_t Size, uint32_t Timeout)
+{
+    sHost_Uart * pUart = host_Uart_Get(huart->Instance);
+    uint64_t byte_time = host_Uart_Byte_Time(huart->Instance);
+    uint64_t limit = (uint64_t)Timeout * HOST_NS_PER_MS;
+    uint16_t sent = Size;
+    HAL_StatusTypeDef status = HAL_OK;
+
+    if (huart->gState != HAL_UART_STATE_READY) {
+        return HAL_BUSY;
+    }
+    if (pData == NULL || Size == 0) {
+        return HAL_ERROR;
+    }
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    if (Timeout != HAL_MAX_DELAY && byte_time * Size > limit) {
+        if (limit / byte_time + 2 < Size) {
+            sent = limit / byte_time + 2;
+        }
+        status = HAL_TIMEOUT;
+    }
+    host_Time_Busy((status == HAL_TIMEOUT) ? (limit) : (byte_time * sent));
+    if (pUart->tx_fun != NULL && sent > 0) {
+        pUart->tx_fun(pUart->tx_arg, pData, sent);
+    }
+    huart->gState = HAL_UART_STATE_READY;
+    return status;
+}
+
+/**
+ * @brief  串口 阻塞接收
+ * @note   轮询 RXNE 直至收满或超时
+ * @retval HAL_OK HAL_BUSY HAL_ERROR HAL_TIMEOUT
+ */
+HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef * huart, uint8_t * pData, uint16_t Size, uint32_t Timeout)
+{
+    uint64_t step = host_Uart_Byte_Time(huart->Instance) / 4;
+    uint64_t deadline = host_Time_Now() + (uint64_t)Timeout * HOST_NS_PER_MS;
+    uint16_t i;
+
+    if (huart->RxState != HAL_UART_STATE_READY) {
+        return HAL_BUSY;
+    }
+    if (pData == NULL || Size == 0) {
+        return HAL_ERROR;
+    }
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    for (i = 0; i < Size; ++i) {
+        while ((huart->Instance->SR & USART_SR_RXNE) == 0) {
+            if (Timeout != HAL_MAX_DELAY && host_Time_Now() >= deadline) {
+                huart->RxState = HAL_UART_STATE_READY;
+                return HAL_TIMEOUT;
+            }
+            host_Time_Busy(step);
+        }
+        pData[i] = huart->Instance->DR;
+        huart->Instance->SR &= ~(USART_SR_RXNE | USART_SR_ORE);
+    }
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+/**
+ * @brief  串口 DMA 接收完成
+ * @note   与 UART_DMAReceiveCplt 一致 非循环模式停止 DMA 请求 接收就绪
+ * @param  hdma DMA 句柄
+ * @retval None
+ */
+static void host_Uart_Dma_Rx_Cplt(DMA_HandleTypeDef * hdma)
+{
+    UART_HandleTypeDef * huart = hdma->Parent;
+
+    if ((hdma->Instance->CR & DMA_SxCR_CIRC) == 0) {
+        huart->RxXferCount = 0;
+        huart->Instance->CR3 &= ~(USART_CR3_DMAR | USART_CR3_EIE);
+        huart->Instance->CR1 &= ~USART_CR1_PEIE;
+        huart->RxState = HAL_UART_STATE_READY;
+    }
+    HAL_UART_RxCpltCallback(huart);
+}
+
+/**
+ * @brief  串口 DMA 接收一半
+ * @param  hdma DMA 句柄
+ * @retval None
+ */
+static void host_Uart_Dma_Rx_Half_Cplt(DMA_HandleTypeDef * hdma)
+{
+    HAL_UART_RxHalfCpltCallback(hdma->Parent);
+}
+
+/**
+ * @brief  串口 DMA 接收
+ * @note   与 HAL 一致 启动前清除溢出 (同时清除空闲) 标志
+ * @retval HAL_OK HAL_BUSY HAL_ERROR
+ */
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef * huart, uint8_t * pData, uint16_t Size)
+{
+    if (huart->RxState != HAL_UART_STATE_READY) {
+        return HAL_BUSY;
+    }
+    if (pData == NULL || Size == 0) {
+        return HAL_ERROR;
+    }
+    huart->pRxBuffPtr = pData;
+    huart->RxXferSize = Size;
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    huart->hdmarx->XferCpltCallback = host_Uart_Dma_Rx_Cplt;
+    huart->hdmarx->XferHalfCpltCallback = host_Uart_Dma_Rx_Half_Cplt;
+    host_Dma_Start(huart->hdmarx, pData, Size);
+    huart->Instance->SR &= ~(USART_SR_ORE | USART_SR_IDLE | USART_SR_RXNE);
+    huart->Instance->CR1 |= USART_CR1_PEIE;
+    huart->Instance->CR3 |= USART_CR3_EIE | USART_CR3_DMAR;
+    return HAL_OK;
+}
+
+/**
+ * @brief  串口 停止接收
+ * @note   停止 DMA 剩余计数保持
+ * @retval HAL_OK
+ */
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef * huart)
+{
+    huart->Instance->CR1 &= ~(USART_CR1_RXNEIE | USART_CR1_PEIE);
+    huart->Instance->CR3 &= ~(USART_CR3_EIE | USART_CR3_DMAR);
+    if (huart->hdmarx != NULL) {
+        huart->hdmarx->XferAbortCallback = NULL;
+        host_Dma_Stop(huart->hdmarx);
+    }
+    huart->RxXferCount = 0;
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+/**
+ * @brief  串口 错误码
+ * @retval 错误码
+ */
+uint32_t HAL_UART_GetError(UART_HandleTypeDef * huart)
+{
+    return huart->ErrorCode;
+}
+
+/**
+ * @brief  串口 中断处理
+ * @note   清除空闲 接收 溢出标志 (主机内存 读序列不清除) 发送完成中断 -> 发送完成回调
+ * @param  huart 串口句柄
+ * @retval None
+ */
+void HAL_UART_IRQHandler(UART_HandleTypeDef * huart)
+{
+    USART_TypeDef * uart = huart->Instance;
+
+    uart->SR &= ~USART_SR_IDLE;
+    if ((uart->SR & USART_SR_TC) && (uart->CR1 & USART_CR1_TCIE)) {
+        uart->CR1 &= ~USART_CR1_TCIE;
+        huart->gState = HAL_UART_STATE_READY;
+        HAL_UART_TxCpltCallback(huart);
+    }
+}
+
+__weak void HAL_UART_MspInit(UART_HandleTypeDef * huart)
+{
+}
+
+__weak void HAL_UART_TxCpltCallback(UART_HandleTypeDef * huart)
+{
+}
+
+__weak void HAL_UART_RxCpltCallback(UART_HandleTypeDef * huart)
+{
+}
+
+__weak void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef * huart)
+{
+}
+
+__weak void HAL_UART_ErrorCallback(UART_HandleTypeDef * huart)
+{
+}
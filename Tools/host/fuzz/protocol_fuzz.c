@@ -0,0 +1,669 @@
+/**
+ * @file    protocol_fuzz.c
+ * @brief   主机构建 串口拼包/协议解析 模糊测试
+ *
+ * 对象 固件 serial.c serialGenerateDealRecv serialGenerateCallback 与 protocol.c protocol_has_head/has_tail/is_comp
+ *     接收缓存与外串口一致 (DMA 环形 COMM_OUT_DMA_RX_SIZE 拼包 COMM_OUT_SER_RX_SIZE) 每个输入单独分配 越界由 ASan 检出
+ *     输入首字节决定分段 0 整体到达 其余按伪随机长度 1～首字节 分段 段尾为空闲中断 DMA 半满/满 位置另有中断
+ *     输入之后紧接整帧到达的有效帧 未全部收到计为失步 (拼包设计 长度字节错误时可能等待至缓存满 不视为失败)
+ * 判定 (abort 由 libFuzzer/AFL 记为崩溃)
+ *     越界    ASan/UBSan
+ *     短帧    提交给解析函数的帧 长度 < 7 或 包头 长度字节 CRC 不符
+ *     超时    单次中断 工作量 (包头包尾判定次数 + CRC 字节数) 超过 PROTOCOL_FUZZ_WORK_LIMIT
+ *     丢帧    输入全部由有效帧组成 (单帧不超过 PROTOCOL_FUZZ_FRAME_MAX) 时 按任意分段到达均应全部收到
+ * 构建
+ *     Clang  protocol_fuzz 为 libFuzzer 目标 (-fsanitize=fuzzer) 用法同 libFuzzer
+ *     GCC    自带驱动 回放 / 随机变异 (无覆盖率引导) 也可由 AFL (afl-gcc-fast 构建 afl-fuzz ... -- protocol_fuzz @@) 驱动
+ *            protocol_fuzz 文件或目录...        回放 任一输入失败时 abort
+ *            protocol_fuzz -n 次数 [-s 种子] [-o 目录] [语料...]   随机变异 失败输入写入目录 (默认当前目录) 后 abort
+ *            protocol_fuzz                      由标准输入读取单个输入
+ * 回归语料 Tools/host/fuzz/corpus/protocol 由 ctest 回放
+ * ASan 下 板级模型内核外设窗口 (0xE0000000) 位于影子间隙 无法映射 本目标不运行板级模型 启动提示可忽略
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <dirent.h>
+#include <sanitizer/common_interface_defs.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "main.h"
+#include "protocol.h"
+#include "serial.h"
+#include "comm_out.h"
+
+/* Private define ------------------------------------------------------------*/
+#define PROTOCOL_FUZZ_INPUT_MAX 1024  /* 单个输入长度上限 */
+#define PROTOCOL_FUZZ_WORK_LIMIT 4096 /* 单次中断工作量上限 正常拼包不超过约 500 */
+#define PROTOCOL_FUZZ_FRAME_MAX 240   /* 丢帧判定 单帧长度上限 拼包缓存需容纳 DMA 半满分段前后两部分 */
+#define PROTOCOL_FUZZ_CORPUS_MAX 4096 /* 随机变异 语料上限 */
+#define PROTOCOL_FUZZ_RESYNC_NUM 3    /* 失步检测 有效帧数 */
+
+/* Private typedef -----------------------------------------------------------*/
+/* 单个输入 运行结果 */
+typedef struct {
+    uint32_t work;     /* 单次中断最大工作量 */
+    uint16_t frames;   /* 提交给解析函数的帧数 */
+    uint16_t expected; /* 输入全部由有效帧组成时 帧数 否则为 0 */
+    uint8_t lost;      /* 失步 未收到的有效帧数 */
+} sProtocol_Fuzz_Result;
+
+/* 语料项 */
+typedef struct {
+    uint8_t * pData;
+    uint16_t length;
+} sProtocol_Fuzz_Input;
+
+/* Private variables ---------------------------------------------------------*/
+static uint32_t gProtocol_Fuzz_Work = 0;              /* 本次中断工作量 */
+static sProtocol_Fuzz_Result gProtocol_Fuzz_Result;
+static uint8_t gProtocol_Fuzz_Resync = 0;             /* 正在送入失步检测帧 */
+static uint16_t gProtocol_Fuzz_Resync_Got = 0;        /* 失步检测帧 收到位 */
+static const uint8_t * gProtocol_Fuzz_Current = NULL; /* 当前输入 失败时保存 */
+static size_t gProtocol_Fuzz_Current_Length = 0;
+static const char * gProtocol_Fuzz_Out_Dir = NULL;    /* 失败输入保存目录 NULL 不保存 */
+
+/* 失步检测帧 数据长度 0 5 20 */
+static uint8_t gProtocol_Fuzz_Resync_Frames[PROTOCOL_FUZZ_RESYNC_NUM][27];
+static uint8_t gProtocol_Fuzz_Resync_Lengths[PROTOCOL_FUZZ_RESYNC_NUM];
+
+/* Private function prototypes -----------------------------------------------*/
+int LLVMFuzzerTestOneInput(const uint8_t * pData, size_t size);
+
+/* Private user code ---------------------------------------------------------*/
+
+/**
+ * @brief  保存当前输入
+ * @param  reason 原因 用于文件名
+ * @retval None
+ */
+static void protocol_Fuzz_Save(const char * reason)
+{
+    char path[512];
+    FILE * pFile;
+
+    if (gProtocol_Fuzz_Out_Dir != NULL && gProtocol_Fuzz_Current != NULL) {
+        snprintf(path, sizeof(path), "%s/crash-%s.bin", gProtocol_Fuzz_Out_Dir, reason);
+        pFile = fopen(path, "wb");
+        if (pFile != NULL) {
+            fwrite(gProtocol_Fuzz_Current, 1, gProtocol_Fuzz_Current_Length, pFile);
+            fclose(pFile);
+            fprintf(stderr, "protocol_fuzz: input saved to %s\n", path);
+        }
+    }
+}
+
+/**
+ * @brief  ASan/UBSan 报错退出前 保存当前输入
+ * @param  None
+ * @retval None
+ */
+static void protocol_Fuzz_Death(void)
+{
+    protocol_Fuzz_Save("sanitizer");
+}
+
+/**
+ * @brief  失败 保存当前输入后 abort
+ * @param  reason 原因
+ * @retval None
+ */
+static void protocol_Fuzz_Fail(const char * reason)
+{
+    fprintf(stderr, "protocol_fuzz: %s\n", reason);
+    protocol_Fuzz_Save(reason);
+    abort();
+}
+
+/**
+ * @brief  伪随机数 xorshift32
+ * @param  pState 状态 非零
+ * @retval 随机数
+ */
+static uint32_t protocol_Fuzz_Random(uint32_t * pState)
+{
+    uint32_t x = *pState;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *pState = x;
+    return x;
+}
+
+/**
+ * @brief  构造有效帧
+ * @param  pOut 输出 长度至少 length + 7
+ * @param  cmd 命令字
+ * @param  pData 数据 NULL 时按序号填充
+ * @param  length 数据长度
+ * @retval 帧长度
+ */
+static uint16_t protocol_Fuzz_Build(uint8_t * pOut, uint8_t cmd, const uint8_t * pData, uint8_t length)
+{
+    uint8_t i;
+
+    pOut[0] = 0x69;
+    pOut[1] = 0xAA;
+    pOut[2] = 3 + length;
+    pOut[3] = 1;
+    pOut[4] = PROTOCOL_DEVICE_ID_TEST;
+    pOut[5] = cmd;
+    for (i = 0; i < length; ++i) {
+        pOut[6 + i] = (pData != NULL) ? (pData[i]) : (i);
+    }
+    pOut[6 + length] = CRC8(&pOut[4], 2 + length);
+    return length + 7;
+}
+
+/**
+ * @brief  输入全部由有效帧组成时 帧数
+ * @param  pData 数据
+ * @param  length 长度
+ * @retval 帧数 含其他内容 或单帧超过 PROTOCOL_FUZZ_FRAME_MAX 时为 0
+ */
+static uint16_t protocol_Fuzz_Valid_Frames(const uint8_t * pData, size_t length)
+{
+    size_t pos = 0;
+    uint16_t tail, count = 0;
+
+    while (pos < length) {
+        if (length - pos < 7 || pData[pos] != 0x69 || pData[pos + 1] != 0xAA) {
+            return 0;
+        }
+        tail = pData[pos + 2] + 4;
+        if (tail < 7 || tail > PROTOCOL_FUZZ_FRAME_MAX || tail > length - pos || CRC8((uint8_t *)&pData[pos + 4], tail - 5) != pData[pos + tail - 1]) {
+            return 0;
+        }
+        pos += tail;
+        ++count;
+    }
+    return count;
+}
+
+/**
+ * @brief  包头判定 计入工作量
+ * @param  pBuff 数据指针
+ * @param  length 数据长度
+ * @retval 0 非包头 1 包头
+ */
+static uint8_t protocol_Fuzz_Has_Head(uint8_t * pBuff, uint16_t length)
+{
+    ++gProtocol_Fuzz_Work;
+    return protocol_has_head(pBuff, length);
+}
+
+/**
+ * @brief  包尾检测 计入工作量
+ * @param  pBuff 数据指针
+ * @param  length 数据长度
+ * @retval 包尾位置 无包尾时返回0
+ */
+static uint16_t protocol_Fuzz_Has_Tail(uint8_t * pBuff, uint16_t length)
+{
+    ++gProtocol_Fuzz_Work;
+    return protocol_has_tail(pBuff, length);
+}
+
+/**
+ * @brief  完整性判断 CRC 字节数计入工作量
+ * @param  pBuff 数据指针
+ * @param  length 数据长度
+ * @retval 0 不完整 1 完整
+ */
+static uint8_t protocol_Fuzz_Is_Comp(uint8_t * pBuff, uint16_t length)
+{
+    gProtocol_Fuzz_Work += length;
+    return protocol_is_comp(pBuff, length);
+}
+
+/**
+ * @brief  解析函数 检查提交的帧
+ * @param  pBuff 帧
+ * @param  length 帧长度
+ * @retval 0
+ */
+static uint8_t protocol_Fuzz_Parse(uint8_t * pBuff, uint16_t length)
+{
+    uint16_t i;
+
+    if (length < 7 || pBuff[0] != 0x69 || pBuff[1] != 0xAA || pBuff[2] + 4 != length || CRC8(pBuff + 4, length - 5) != pBuff[length - 1]) {
+        fprintf(stderr, "protocol_fuzz: frame length %u:", length);
+        for (i = 0; i < length && i < 16; ++i) {
+            fprintf(stderr, " %02X", pBuff[i]);
+        }
+        fprintf(stderr, "\n");
+        protocol_Fuzz_Fail("short");
+    }
+    if (gProtocol_Fuzz_Resync == 0) {
+        ++gProtocol_Fuzz_Result.frames;
+        return 0;
+    }
+    for (i = 0; i < PROTOCOL_FUZZ_RESYNC_NUM; ++i) {
+        if (length == gProtocol_Fuzz_Resync_Lengths[i] && memcmp(pBuff, gProtocol_Fuzz_Resync_Frames[i], length) == 0) {
+            gProtocol_Fuzz_Resync_Got |= 1 << i;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief  送入一段数据 与 DMA 循环接收一致 半满 满 位置与段尾 进入接收处理
+ * @param  pDMA_Record DMA接收信息
+ * @param  phdma DMA句柄
+ * @param  psrd 拼包信息
+ * @param  pData 数据
+ * @param  length 长度
+ * @retval None
+ */
+static void protocol_Fuzz_Feed(sDMA_Record * pDMA_Record, DMA_HandleTypeDef * phdma, sSerialRecord * psrd, const uint8_t * pData, size_t length)
+{
+    uint16_t pos;
+    size_t i;
+
+    for (i = 0; i < length; ++i) {
+        pos = pDMA_Record->buffLength - phdma->Instance->NDTR;
+        pDMA_Record->pDMA_Buff[pos++] = pData[i];
+        phdma->Instance->NDTR = (pos == pDMA_Record->buffLength) ? (pDMA_Record->buffLength) : (pDMA_Record->buffLength - pos);
+        if (pos != pDMA_Record->buffLength / 2 && pos != pDMA_Record->buffLength && i + 1 < length) {
+            continue;
+        }
+        gProtocol_Fuzz_Work = 0; /* 半满 满 空闲 中断 */
+        serialGenerateDealRecv(NULL, pDMA_Record, phdma, psrd);
+        if (gProtocol_Fuzz_Work > gProtocol_Fuzz_Result.work) {
+            gProtocol_Fuzz_Result.work = gProtocol_Fuzz_Work;
+        }
+        if (gProtocol_Fuzz_Work > PROTOCOL_FUZZ_WORK_LIMIT) {
+            protocol_Fuzz_Fail("slow");
+        }
+    }
+}
+
+/**
+ * @brief  运行单个输入
+ * @param  pData 输入 首字节为分段方式
+ * @param  size 长度
+ * @retval None
+ */
+static void protocol_Fuzz_Run(const uint8_t * pData, size_t size)
+{
+    DMA_Stream_TypeDef stream;
+    DMA_HandleTypeDef hdma;
+    sDMA_Record dma_record;
+    sSerialRecord serial_record;
+    uint32_t state;
+    size_t pos = 1, n;
+    uint8_t i, mode;
+
+    memset(&gProtocol_Fuzz_Result, 0, sizeof(gProtocol_Fuzz_Result));
+    if (size == 0) {
+        return;
+    }
+    if (size > PROTOCOL_FUZZ_INPUT_MAX) {
+        size = PROTOCOL_FUZZ_INPUT_MAX;
+    }
+    gProtocol_Fuzz_Current = pData;
+    gProtocol_Fuzz_Current_Length = size;
+
+    memset(&stream, 0, sizeof(stream));
+    memset(&hdma, 0, sizeof(hdma));
+    hdma.Instance = &stream;
+    stream.NDTR = COMM_OUT_DMA_RX_SIZE;
+
+    memset(&dma_record, 0, sizeof(dma_record));
+    dma_record.pDMA_Buff = malloc(COMM_OUT_DMA_RX_SIZE); /* 单独分配 越界由 ASan 检出 */
+    dma_record.buffLength = COMM_OUT_DMA_RX_SIZE;
+    dma_record.callback = serialGenerateCallback;
+
+    memset(&serial_record, 0, sizeof(serial_record));
+    serial_record.pSerialBuff = malloc(COMM_OUT_SER_RX_SIZE);
+    serial_record.maxLength = COMM_OUT_SER_RX_SIZE;
+    serial_record.minLength = 7;
+    serial_record.has_head = protocol_Fuzz_Has_Head;
+    serial_record.has_tail = protocol_Fuzz_Has_Tail;
+    serial_record.is_cmop = protocol_Fuzz_Is_Comp;
+    serial_record.callback = protocol_Fuzz_Parse;
+
+    mode = pData[0];
+    state = mode | 0x100;
+    gProtocol_Fuzz_Result.expected = protocol_Fuzz_Valid_Frames(&pData[1], size - 1);
+    gProtocol_Fuzz_Resync = 0;
+    while (pos < size) {
+        n = (mode == 0) ? (size - pos) : (1 + protocol_Fuzz_Random(&state) % mode);
+        if (n > size - pos) {
+            n = size - pos;
+        }
+        protocol_Fuzz_Feed(&dma_record, &hdma, &serial_record, &pData[pos], n);
+        pos += n;
+    }
+    if (gProtocol_Fuzz_Result.expected > 0 && gProtocol_Fuzz_Result.frames != gProtocol_Fuzz_Result.expected) {
+        protocol_Fuzz_Fail("lost");
+    }
+
+    gProtocol_Fuzz_Resync = 1;
+    gProtocol_Fuzz_Resync_Got = 0;
+    for (i = 0; i < PROTOCOL_FUZZ_RESYNC_NUM; ++i) {
+        protocol_Fuzz_Feed(&dma_record, &hdma, &serial_record, gProtocol_Fuzz_Resync_Frames[i], gProtocol_Fuzz_Resync_Lengths[i]);
+    }
+    for (i = 0; i < PROTOCOL_FUZZ_RESYNC_NUM; ++i) {
+        gProtocol_Fuzz_Result.lost += ((gProtocol_Fuzz_Resync_Got & (1 << i)) == 0);
+    }
+
+    free(dma_record.pDMA_Buff);
+    free(serial_record.pSerialBuff);
+    gProtocol_Fuzz_Current = NULL;
+}
+
+/**
+ * @brief  初始化 失步检测帧
+ * @param  None
+ * @retval None
+ */
+static void protocol_Fuzz_Init(void)
+{
+    static const uint8_t lengths[PROTOCOL_FUZZ_RESYNC_NUM] = {0, 5, 20};
+    uint8_t i;
+
+    for (i = 0; i < PROTOCOL_FUZZ_RESYNC_NUM; ++i) {
+        gProtocol_Fuzz_Resync_Lengths[i] = protocol_Fuzz_Build(gProtocol_Fuzz_Resync_Frames[i], 0xD0, NULL, lengths[i]);
+    }
+}
+
+/**
+ * @brief  libFuzzer 入口
+ * @param  pData 输入
+ * @param  size 长度
+ * @retval 0
+ */
+int LLVMFuzzerTestOneInput(const uint8_t * pData, size_t size)
+{
+    if (gProtocol_Fuzz_Resync_Lengths[0] == 0) {
+        protocol_Fuzz_Init();
+    }
+    protocol_Fuzz_Run(pData, size);
+    return 0;
+}
+
+#ifndef PROTOCOL_FUZZ_LIBFUZZER
+
+/**
+ * @brief  读取文件
+ * @param  path 路径 NULL 为标准输入
+ * @param  pInput 输出 长度不超过 PROTOCOL_FUZZ_INPUT_MAX
+ * @retval 0 成功
+ */
+static int protocol_Fuzz_Load(const char * path, sProtocol_Fuzz_Input * pInput)
+{
+    FILE * pFile = (path != NULL) ? (fopen(path, "rb")) : (stdin);
+
+    if (pFile == NULL) {
+        fprintf(stderr, "protocol_fuzz: cannot open %s\n", path);
+        return -1;
+    }
+    pInput->pData = malloc(PROTOCOL_FUZZ_INPUT_MAX);
+    pInput->length = fread(pInput->pData, 1, PROTOCOL_FUZZ_INPUT_MAX, pFile);
+    if (path != NULL) {
+        fclose(pFile);
+    }
+    return 0;
+}
+
+/**
+ * @brief  收集语料 文件或目录 (不递归)
+ * @param  path 路径
+ * @param  pCorpus 语料
+ * @param  pNum 语料数
+ * @param  names 文件名 回放时输出 可为 NULL
+ * @retval 0 成功
+ */
+static int protocol_Fuzz_Collect(const char * path, sProtocol_Fuzz_Input * pCorpus, uint32_t * pNum, char ** names)
+{
+    struct dirent ** ppList;
+    struct stat st;
+    char file[512];
+    int i, n;
+
+    if (stat(path, &st) != 0) {
+        fprintf(stderr, "protocol_fuzz: cannot open %s\n", path);
+        return -1;
+    }
+    if (S_ISDIR(st.st_mode) == 0) {
+        if (*pNum >= PROTOCOL_FUZZ_CORPUS_MAX || protocol_Fuzz_Load(path, &pCorpus[*pNum]) != 0) {
+            return -1;
+        }
+        if (names != NULL) {
+            names[*pNum] = strdup(path);
+        }
+        ++*pNum;
+        return 0;
+    }
+    n = scandir(path, &ppList, NULL, alphasort); /* 按名称排序 回放顺序固定 */
+    for (i = 0; i < n; ++i) {
+        if (ppList[i]->d_name[0] != '.') {
+            snprintf(file, sizeof(file), "%s/%s", path, ppList[i]->d_name);
+            if (protocol_Fuzz_Collect(file, pCorpus, pNum, names) != 0) {
+                return -1;
+            }
+        }
+        free(ppList[i]);
+    }
+    free(ppList);
+    return 0;
+}
+
+/**
+ * @brief  变异
+ * @param  pState 随机状态
+ * @param  pCorpus 语料
+ * @param  num 语料数
+ * @param  pOut 输出 长度 PROTOCOL_FUZZ_INPUT_MAX
+ * @retval 长度
+ */
+static uint16_t protocol_Fuzz_Mutate(uint32_t * pState, const sProtocol_Fuzz_Input * pCorpus, uint32_t num, uint8_t * pOut)
+{
+    static const uint8_t special[] = {0x00, 0x01, 0x02, 0x03, 0x69, 0xAA, 0xFE, 0xFF};
+    static const uint8_t modes[] = {0, 1, 2, 3, 7, 16, 64, 255};
+    const sProtocol_Fuzz_Input * pBase = &pCorpus[protocol_Fuzz_Random(pState) % num];
+    const sProtocol_Fuzz_Input * pOther;
+    uint8_t piece[PROTOCOL_FUZZ_INPUT_MAX];
+    uint16_t length = pBase->length, pos, n, piece_length;
+    uint8_t i, ops;
+
+    memcpy(pOut, pBase->pData, length);
+    ops = 1 + protocol_Fuzz_Random(pState) % 4;
+    for (i = 0; i < ops; ++i) {
+        pos = protocol_Fuzz_Random(pState) % (length + 1);
+        piece_length = 0;
+        switch (protocol_Fuzz_Random(pState) % 8) {
+            case 0: /* 位翻转 */
+                if (length > 0) {
+                    pOut[protocol_Fuzz_Random(pState) % length] ^= 1 << (protocol_Fuzz_Random(pState) % 8);
+                }
+                break;
+            case 1: /* 关键字节 */
+                if (length > 0) {
+                    pOut[protocol_Fuzz_Random(pState) % length] = special[protocol_Fuzz_Random(pState) % sizeof(special)];
+                }
+                break;
+            case 2: /* 包头 + 长度字节 */
+                piece[0] = 0x69;
+                piece[1] = 0xAA;
+                piece[2] = (protocol_Fuzz_Random(pState) & 1) ? (special[protocol_Fuzz_Random(pState) % 4]) : (protocol_Fuzz_Random(pState));
+                piece_length = 3;
+                break;
+            case 3: /* 有效帧 */
+                piece_length = protocol_Fuzz_Build(piece, protocol_Fuzz_Random(pState), NULL, protocol_Fuzz_Random(pState) % 8);
+                break;
+            case 4: /* 删除 */
+                if (length > 2) {
+                    n = 1 + protocol_Fuzz_Random(pState) % 16;
+                    n = (n > length - pos) ? (length - pos) : (n);
+                    memmove(&pOut[pos], &pOut[pos + n], length - pos - n);
+                    length -= n;
+                }
+                break;
+            case 5: /* 拼接其他语料 */
+                pOther = &pCorpus[protocol_Fuzz_Random(pState) % num];
+                if (pOther->length > 1) {
+                    piece_length = 1 + protocol_Fuzz_Random(pState) % 64;
+                    piece_length = (piece_length > pOther->length - 1) ? (pOther->length - 1) : (piece_length);
+                    memcpy(piece, &pOther->pData[1], piece_length);
+                }
+                break;
+            case 6: /* 重复 */
+                n = 1 + protocol_Fuzz_Random(pState) % 32;
+                n = (n > pos) ? (pos) : (n);
+                for (piece_length = 0; piece_length + n <= 128 && n > 0 && (protocol_Fuzz_Random(pState) & 3) != 0;) {
+                    memcpy(&piece[piece_length], &pOut[pos - n], n);
+                    piece_length += n;
+                }
+                break;
+            default: /* 分段方式 */
+                if (length > 0) {
+                    pOut[0] = modes[protocol_Fuzz_Random(pState) % sizeof(modes)];
+                }
+                break;
+        }
+        if (piece_length > PROTOCOL_FUZZ_INPUT_MAX - length) {
+            piece_length = PROTOCOL_FUZZ_INPUT_MAX - length;
+        }
+        if (piece_length > 0) {
+            memmove(&pOut[pos + piece_length], &pOut[pos], length - pos);
+            memcpy(&pOut[pos], piece, piece_length);
+            length += piece_length;
+        }
+    }
+    if (length == 0) {
+        pOut[length++] = 0;
+    }
+    return length;
+}
+
+/**
+ * @brief  内置种子 常见帧 整体与分段到达
+ * @param  pCorpus 语料
+ * @param  pNum 语料数
+ * @retval None
+ */
+static void protocol_Fuzz_Seeds(sProtocol_Fuzz_Input * pCorpus, uint32_t * pNum)
+{
+    static const uint8_t cmds[] = {0xAA, 0xB3, 0xD7, 0x07};
+    static const uint8_t lengths[] = {1, 30, 200, 0};
+    static const uint8_t modes[] = {0, 7, 3};
+    uint8_t frames[512];
+    uint16_t length = 0;
+    uint8_t i;
+
+    for (i = 0; i < sizeof(cmds); ++i) {
+        length += protocol_Fuzz_Build(&frames[length], cmds[i], NULL, lengths[i]);
+    }
+    for (i = 0; i < sizeof(modes); ++i) {
+        pCorpus[*pNum].pData = malloc(PROTOCOL_FUZZ_INPUT_MAX);
+        pCorpus[*pNum].pData[0] = modes[i];
+        memcpy(&pCorpus[*pNum].pData[1], frames, length);
+        pCorpus[*pNum].length = length + 1;
+        ++*pNum;
+    }
+}
+
+/**
+ * @brief  释放语料
+ * @param  pCorpus 语料
+ * @param  names 文件名
+ * @param  num 语料数
+ * @retval None
+ */
+static void protocol_Fuzz_Free(sProtocol_Fuzz_Input * pCorpus, char ** names, uint32_t num)
+{
+    uint32_t i;
+
+    for (i = 0; i < num; ++i) {
+        free(pCorpus[i].pData);
+        free(names[i]);
+    }
+    free(pCorpus);
+    free(names);
+}
+
+int main(int argc, char * argv[])
+{
+    sProtocol_Fuzz_Input * pCorpus;
+    char ** names;
+    uint8_t * pInput;
+    uint32_t num = 0, iterations = 0, seed = 1, state, n, i, worst = 0, lost = 0;
+    uint16_t length;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:s:o:")) != -1) {
+        switch (opt) {
+            case 'n':
+                iterations = strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                seed = strtoul(optarg, NULL, 0);
+                break;
+            case 'o':
+                gProtocol_Fuzz_Out_Dir = optarg;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-n iterations] [-s seed] [-o dir] [file|dir ...]\n", argv[0]);
+                return 2;
+        }
+    }
+    protocol_Fuzz_Init();
+    __sanitizer_set_death_callback(protocol_Fuzz_Death);
+    pCorpus = calloc(PROTOCOL_FUZZ_CORPUS_MAX, sizeof(sProtocol_Fuzz_Input));
+    names = calloc(PROTOCOL_FUZZ_CORPUS_MAX, sizeof(char *));
+
+    if (iterations == 0 && optind >= argc) { /* 标准输入 单个输入 (AFL) */
+        if (protocol_Fuzz_Load(NULL, &pCorpus[0]) != 0) {
+            return 2;
+        }
+        protocol_Fuzz_Run(pCorpus[0].pData, pCorpus[0].length);
+        protocol_Fuzz_Free(pCorpus, names, 1);
+        return 0;
+    }
+    for (; optind < argc; ++optind) {
+        if (protocol_Fuzz_Collect(argv[optind], pCorpus, &num, names) != 0) {
+            return 2;
+        }
+    }
+
+    if (iterations == 0) { /* 回放 */
+        for (i = 0; i < num; ++i) {
+            protocol_Fuzz_Run(pCorpus[i].pData, pCorpus[i].length);
+            printf("%s  work %u  frames %u  lost %u\n", names[i], gProtocol_Fuzz_Result.work, gProtocol_Fuzz_Result.frames, gProtocol_Fuzz_Result.lost);
+        }
+        printf("replayed %u inputs\n", num);
+        protocol_Fuzz_Free(pCorpus, names, num);
+        return 0;
+    }
+
+    if (gProtocol_Fuzz_Out_Dir == NULL) {
+        gProtocol_Fuzz_Out_Dir = ".";
+    }
+    protocol_Fuzz_Seeds(pCorpus, &num);
+    state = (seed != 0) ? (seed) : (1);
+    pInput = malloc(PROTOCOL_FUZZ_INPUT_MAX);
+    for (n = 0; n < iterations; ++n) {
+        length = protocol_Fuzz_Mutate(&state, pCorpus, num, pInput);
+        protocol_Fuzz_Run(pInput, length);
+        lost += (gProtocol_Fuzz_Result.lost > 0);
+        if (gProtocol_Fuzz_Result.work > worst && num < PROTOCOL_FUZZ_CORPUS_MAX) { /* 更慢的输入加入语料 */
+            worst = gProtocol_Fuzz_Result.work;
+            pCorpus[num].pData = malloc(PROTOCOL_FUZZ_INPUT_MAX);
+            memcpy(pCorpus[num].pData, pInput, length);
+            pCorpus[num].length = length;
+            ++num;
+        }
+    }
+    printf("iterations %u  corpus %u  worst work %u  resync lost %u\n", iterations, num, worst, lost);
+    free(pInput);
+    protocol_Fuzz_Free(pCorpus, names, num);
+    return 0;
+}
+
+#endif
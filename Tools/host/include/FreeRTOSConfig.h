@@ -0,0 +1,33 @@
+/**
+ * @file    FreeRTOSConfig.h
+ * @brief   主机构建 FreeRTOS 配置
+ *
+ * 包含固件配置 Inc/FreeRTOSConfig.h 后 仅覆盖与移植层相关的项
+ *     断言      abort 便于测试定位 固件为关中断死循环
+ *     空闲钩子  推进虚拟时间 见 Tools/host/port/port.c
+ *     中断名称  取消 SVC/PendSV 处理函数映射 主机移植层无异常向量 SysTick 映射保留
+ * 其余 (优先级 节拍 静态分配 堆大小 运行统计 跟踪宏) 与固件一致
+ */
+
+#ifndef HOST_FREERTOS_CONFIG_H
+#define HOST_FREERTOS_CONFIG_H
+
+#include_next "FreeRTOSConfig.h"
+
+#undef configUSE_IDLE_HOOK
+#define configUSE_IDLE_HOOK 1 /* 空闲钩子 推进虚拟时间 */
+
+#undef configUSE_PORT_OPTIMISED_TASK_SELECTION
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 0 /* 通用任务选择 */
+
+#undef configASSERT
+#define configASSERT(x)                                                                                                                                        \
+    if ((x) == 0) {                                                                                                                                            \
+        vPortAssert(__FILE__, __LINE__);                                                                                                                       \
+    }
+void vPortAssert(const char * file, int line);
+
+#undef vPortSVCHandler
+#undef xPortPendSVHandler
+
+#endif /* HOST_FREERTOS_CONFIG_H */
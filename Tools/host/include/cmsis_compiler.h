@@ -0,0 +1,62 @@
+/**
+ * @file    cmsis_compiler.h
+ * @brief   主机构建 CMSIS 编译器相关定义
+ *
+ * 代替 CMSIS cmsis_compiler.h / cmsis_gcc.h (内联汇编) 内核指令由主机移植层实现
+ *     __disable_irq/__enable_irq  PRIMASK 由主机移植层记录 屏蔽期间推迟中断与任务切换
+ *     __get_IPSR                  中断上下文中为 当前中断号 + 16
+ *     __WFI                       虚拟时间推进到下一个外设事件
+ *     __DSB/__ISB/__DMB           编译器屏障
+ */
+
+#ifndef __CMSIS_COMPILER_H
+#define __CMSIS_COMPILER_H
+
+#include <stdint.h>
+
+#ifndef __has_builtin
+#define __has_builtin(x) (0)
+#endif
+
+#define __ASM __asm
+#define __INLINE inline
+#define __STATIC_INLINE static inline
+#define __STATIC_FORCEINLINE __attribute__((always_inline)) static inline
+#define __NO_RETURN __attribute__((__noreturn__))
+#define __USED __attribute__((used))
+#define __WEAK __attribute__((weak))
+#define __PACKED __attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT struct __attribute__((packed, aligned(1)))
+#define __PACKED_UNION union __attribute__((packed, aligned(1)))
+#define __ALIGNED(x) __attribute__((aligned(x)))
+#define __RESTRICT __restrict
+
+#define __UNALIGNED_UINT16_READ(addr) (*(const uint16_t *)(const void *)(addr))
+#define __UNALIGNED_UINT16_WRITE(addr, val) (void)(*(uint16_t *)(void *)(addr) = (val))
+#define __UNALIGNED_UINT32_READ(addr) (*(const uint32_t *)(const void *)(addr))
+#define __UNALIGNED_UINT32_WRITE(addr, val) (void)(*(uint32_t *)(void *)(addr) = (val))
+#define __UNALIGNED_UINT32(x) (*(uint32_t *)(x))
+
+void vPortHostIrqDisable(void);
+void vPortHostIrqEnable(void);
+uint32_t ulPortHostGetPrimask(void);
+uint32_t ulPortHostGetBasepri(void);
+uint32_t ulPortHostGetIpsr(void);
+void vPortHostWaitForInterrupt(void);
+
+#define __enable_irq() vPortHostIrqEnable()
+#define __disable_irq() vPortHostIrqDisable()
+#define __get_PRIMASK() ulPortHostGetPrimask()
+#define __get_BASEPRI() ulPortHostGetBasepri()
+#define __get_IPSR() ulPortHostGetIpsr()
+#define __WFI() vPortHostWaitForInterrupt()
+#define __WFE() vPortHostWaitForInterrupt()
+#define __SEV()
+#define __NOP() __asm volatile("nop")
+#define __DSB() __asm volatile("" ::: "memory")
+#define __ISB() __asm volatile("" ::: "memory")
+#define __DMB() __asm volatile("" ::: "memory")
+#define __CLZ(x) (uint8_t)(((x) == 0) ? (32) : (__builtin_clz(x)))
+#define __REV(x) __builtin_bswap32(x)
+
+#endif /* __CMSIS_COMPILER_H */
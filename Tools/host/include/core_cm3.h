@@ -0,0 +1,16 @@
+/**
+ * @file    core_cm3.h
+ * @brief   主机构建 Cortex-M3 内核头文件
+ *
+ * 内核指令见 cmsis_compiler.h
+ * 内核寄存器 (NVIC SCB SysTick DWT) 位于主机映射的内存窗口 见 Tools/host/board/board.c
+ */
+
+#ifndef HOST_CORE_CM3_H
+#define HOST_CORE_CM3_H
+
+#include "cmsis_compiler.h"
+
+#include_next <core_cm3.h>
+
+#endif /* HOST_CORE_CM3_H */
@@ -0,0 +1,145 @@
+/**
+ * @file    drv8824.c
+ * @brief   主机构建 步进电机驱动 DRV8824 模型 白板电机 与 上加热体电机
+ *
+ * 两片共用 TIM1 CH1 (PE9) 步进脉冲 片选 PC13 (白板) PE12 (上加热体) 低有效 方向 PB9 PE13
+ * 每个更新周期输出 RCR + 1 个脉冲 (CC1E MOE CEN 有效 且 CCR1 非零) 于下一更新事件计入使能的电机
+ *     周期中途停止的不计入 (重新启动后的首个更新事件晚于该周期结束时刻)
+ *     TIM1 更新回调需先于固件 DMA 突发写注册 在固件启动前挂接 读到的 RCR CCR1 为本周期生效值
+ * 故障脚 PC14 PE15 保持高 (无故障)
+ * 机构位置 距机械零点脉冲数 到达零点或行程末端后堵转
+ *     白板 方向脚高 向外 (WH) 位置增加 收起光耦 PE4 伸出光耦 PD0
+ *     上加热体 方向脚高 向上 位置减少 上位光耦 PE3 (EXTI3 停车)
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+
+#include "main.h"
+#include "host_model.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* 机构与引脚配置 */
+typedef struct {
+    GPIO_TypeDef * ncs_port; /* 使能 低有效 */
+    uint16_t ncs_pin;
+    GPIO_TypeDef * dir_port;
+    uint16_t dir_pin;
+    GPIO_TypeDef * flag_port;
+    uint16_t flag_pin;
+    int8_t dir_high;         /* 方向脚高时 位置变化方向 */
+    GPIO_TypeDef * low_port; /* 零点侧光耦 遮挡范围 [0, low_edge) */
+    uint16_t low_pin;
+    int32_t low_edge;
+    GPIO_TypeDef * high_port; /* 末端侧光耦 遮挡范围 (high_edge, limit] 无则为 NULL */
+    uint16_t high_pin;
+    int32_t high_edge;
+    int32_t limit;   /* 行程末端 */
+    int32_t initial; /* 上电时机构位置 */
+} sDrv8824_Axis;
+
+typedef struct {
+    int32_t position[2]; /* 机构位置 */
+    uint32_t pending;    /* 本周期脉冲数 下一更新事件计入 */
+    uint64_t end;        /* 本周期结束时刻 期间停止过的周期不计入 */
+} sDrv8824;
+
+/* Private constants ---------------------------------------------------------*/
+static const sDrv8824_Axis cDrv8824_Axes[2] = {
+    /* 白板电机 向外 300 x 8 脉冲 */
+    {STEP_NCS1_GPIO_Port, STEP_NCS1_Pin, STEP_DIR1_GPIO_Port, STEP_DIR1_Pin, STEP_NFLG1_GPIO_Port, STEP_NFLG1_Pin, 1, OPTSW_OUT4_GPIO_Port, OPTSW_OUT4_Pin,
+     100, OPTSW_OUT5_GPIO_Port, OPTSW_OUT5_Pin, 2300, 2600, 1200},
+    /* 上加热体电机 向下 72 x 25 脉冲 */
+    {STEP_NCS2_GPIO_Port, STEP_NCS2_Pin, STEP_DIR2_GPIO_Port, STEP_DIR2_Pin, STEP_NFLG2_GPIO_Port, STEP_NFLG2_Pin, -1, OPTSW_OUT3_GPIO_Port, OPTSW_OUT3_Pin,
+     60, NULL, 0, 0, 2000, 1000},
+};
+
+/* Private variables ---------------------------------------------------------*/
+static sDrv8824 gDrv8824;
+
+/* Private user code ---------------------------------------------------------*/
+
+/**
+ * @brief  光耦 按机构位置更新
+ * @param  index 电机索引
+ * @retval None
+ */
+static void drv8824_Opt_Update(uint8_t index)
+{
+    const sDrv8824_Axis * pAxis = &cDrv8824_Axes[index];
+    int32_t position = gDrv8824.position[index];
+
+    host_Gpio_Input(pAxis->low_port, pAxis->low_pin, position >= pAxis->low_edge);
+    if (pAxis->high_port != NULL) {
+        host_Gpio_Input(pAxis->high_port, pAxis->high_pin, position <= pAxis->high_edge);
+    }
+}
+
+/**
+ * @brief  TIM1 更新事件
+ * @note   上一周期脉冲计入使能的电机 记录本周期脉冲数
+ * @param  arg 未使用
+ * @retval None
+ */
+static void drv8824_Update(void * arg)
+{
+    const sDrv8824_Axis * pAxis;
+    int32_t position;
+    uint64_t ticks;
+    uint8_t i;
+
+    if (host_Time_Now() > gDrv8824.end + HOST_NS_PER_US) { /* 上一周期未完成即停止 */
+        gDrv8824.pending = 0;
+    }
+    for (i = 0; i < ARRAY_LEN(cDrv8824_Axes) && gDrv8824.pending > 0; ++i) {
+        pAxis = &cDrv8824_Axes[i];
+        if (pAxis->ncs_port->ODR & pAxis->ncs_pin) { /* 未使能 */
+            continue;
+        }
+        position = gDrv8824.position[i];
+        position += (pAxis->dir_port->ODR & pAxis->dir_pin) ? (pAxis->dir_high * (int32_t)gDrv8824.pending) : (-pAxis->dir_high * (int32_t)gDrv8824.pending);
+        if (position < 0) {
+            position = 0;
+        } else if (position > pAxis->limit) {
+            position = pAxis->limit;
+        }
+        gDrv8824.position[i] = position;
+        drv8824_Opt_Update(i);
+    }
+
+    gDrv8824.pending = 0;
+    if ((TIM1->CR1 & TIM_CR1_CEN) && (TIM1->CCER & TIM_CCER_CC1E) && (TIM1->BDTR & TIM_BDTR_MOE) && TIM1->CCR1 > 0) {
+        gDrv8824.pending = (TIM1->RCR & 0xFF) + 1;
+        ticks = (uint64_t)((TIM1->ARR & 0xFFFF) + 1) * ((TIM1->PSC & 0xFFFF) + 1) * gDrv8824.pending;
+        gDrv8824.end = host_Time_Now() + ticks * HOST_NS_PER_S / host_Tim_Clock(TIM1);
+    }
+}
+
+/**
+ * @brief  挂接到 TIM1
+ * @note   需在固件启动前调用
+ * @param  None
+ * @retval None
+ */
+void host_Drv8824_Attach(void)
+{
+    uint8_t i;
+
+    memset(&gDrv8824, 0, sizeof(gDrv8824));
+    for (i = 0; i < ARRAY_LEN(cDrv8824_Axes); ++i) {
+        gDrv8824.position[i] = cDrv8824_Axes[i].initial;
+        host_Gpio_Input(cDrv8824_Axes[i].flag_port, cDrv8824_Axes[i].flag_pin, 1);
+        drv8824_Opt_Update(i);
+    }
+    host_Tim_Watch(TIM1, drv8824_Update, NULL);
+}
+
+/**
+ * @brief  机构位置
+ * @param  index 0 白板电机 1 上加热体电机
+ * @retval 距机械零点脉冲数
+ */
+int32_t host_Drv8824_Position(uint8_t index)
+{
+    return gDrv8824.position[index];
+}
@@ -0,0 +1,74 @@
+/**
+ * @file    host_model.h
+ * @brief   主机构建 板上器件与对端设备模型
+ */
+
+#ifndef __HOST_MODEL_H
+#define __HOST_MODEL_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "host_board.h"
+
+/* Exported macro ------------------------------------------------------------*/
+#define HOST_W25Q64_SIZE (8 * 1024 * 1024)
+#define HOST_PEER_BUFFER 512
+
+/* Exported types ------------------------------------------------------------*/
+/* 协议对端 收到完整帧回调 */
+typedef void (*host_Peer_Frame_Fun)(void * arg, const uint8_t * pFrame, uint16_t length);
+
+/* 协议对端 (上位机 外接板 采样板) 帧格式 69 AA 长度 帧号 设备ID 命令 数据 CRC8 */
+typedef struct {
+    USART_TypeDef * uart;
+    uint8_t device_id;   /* 本端设备ID */
+    uint8_t auto_ack;    /* 自动回应非 ACK 帧 */
+    uint8_t index;       /* 本端帧号 */
+    uint8_t buffer[HOST_PEER_BUFFER];
+    uint16_t length;
+    uint32_t frames;     /* 收到完整帧数 */
+    uint32_t crc_errors; /* 校验错误数 */
+    host_Peer_Frame_Fun fun;
+    void * arg;
+} sHost_Peer;
+
+/* 采样板模型 采集数据帧 (0xB3) 数据格式 */
+typedef enum {
+    eHost_Sample_Board_Format_U16, /* u16 x 点数 */
+    eHost_Sample_Board_Format_U32, /* u32 x 点数 */
+    eHost_Sample_Board_Format_Mix, /* (PD u32 白板 u32 采样值 u16) x 点数 */
+} eHost_Sample_Board_Format;
+
+/* 采样板模型 数据格式与故障注入 N 均从 1 起计 0 为不注入 */
+typedef struct {
+    uint8_t format;      /* eHost_Sample_Board_Format */
+    uint8_t dup;         /* 每 N 个数据帧 以相同帧号重复发送一次 */
+    uint8_t bad_length;  /* 每 N 个数据帧 数据多 1 字节 (类型无法识别) */
+    uint8_t oversize_at; /* 第 N 次 PD 数据帧点数超出记录缓存 */
+    uint8_t error_at;    /* 第 N 次 PD 以错误信息帧 (0xB5) 代替数据帧 */
+    uint8_t hang_at;     /* 第 N 次 PD 起不再通知采样完成 */
+} sHost_Sample_Board_Conf;
+
+/* Exported functions prototypes ---------------------------------------------*/
+void host_W25q64_Attach(void);
+uint8_t * host_W25q64_Memory(void);
+
+void host_Peer_Attach(sHost_Peer * pPeer, USART_TypeDef * uart, uint8_t device_id, host_Peer_Frame_Fun fun, void * arg);
+uint8_t host_Peer_Build(sHost_Peer * pPeer, uint8_t * pOut, uint8_t cmd, const uint8_t * pData, uint8_t length);
+void host_Peer_Send(sHost_Peer * pPeer, uint8_t cmd, const uint8_t * pData, uint8_t length);
+void host_Peer_Ack(sHost_Peer * pPeer, uint8_t index);
+
+void host_L6470_Attach(void);
+int32_t host_L6470_Position(uint8_t index);
+
+void host_Drv8824_Attach(void);
+int32_t host_Drv8824_Position(uint8_t index);
+
+void host_Se2707_Attach(const char * pQr, const char * pBar);
+uint32_t host_Se2707_Scans(void);
+
+void host_Sample_Board_Attach(void);
+void host_Sample_Board_Setup(const sHost_Sample_Board_Conf * pConf);
+uint32_t host_Sample_Board_Pulses(void);
+uint32_t host_Sample_Board_Data_Frames(void);
+
+#endif
@@ -0,0 +1,563 @@
+/**
+ * @file    l6470.c
+ * @brief   主机构建 步进电机驱动 L6470 模型 扫码电机 与 托盘电机
+ *
+ * SPI2 片选 PD8 (扫码) PD9 (托盘) 固件每字节翻转一次片选 命令状态跨片选保持 与器件一致
+ * 命令 读写参数 Run Move GoTo GoTo_DIR GoUntil GoHome GoMark ResetPos ResetDevice Soft/HardStop Soft/HardHiZ GetStatus
+ * 运动按梯形曲线 每 1mS 积分一次 速度单位 整步/S 位置单位 按 STEP_MODE 细分
+ * BUSY 脚运动期间拉低 FLAG 脚保持高 (无告警) 复位脚 PB12 拉低时两片同时复位
+ * 机构 原点光耦 (PE0 扫码 PE1 托盘) 同时作为 SW 输入 托盘扫码位置光耦 PE2 按机构位置遮挡
+ * 机构位置 距机械零点微步数 FWD 方向朝向原点 到达零点或行程末端后堵转 驱动步数照常计数
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+
+#include "main.h"
+#include "m_l6470.h"
+#include "host_model.h"
+
+/* Private define ------------------------------------------------------------*/
+#define L6470_TICK (1 * HOST_NS_PER_MS) /* 运动积分周期 */
+
+#define L6470_MAX_SPEED_UNIT 15.25 /* MAX_SPEED 寄存器 整步/S */
+#define L6470_ACC_UNIT 14.55       /* ACC DEC 寄存器 整步/S^2 */
+#define L6470_SPEED_UNIT 0.0149    /* SPEED 及 Run GoUntil 参数 整步/S */
+#define L6470_SPEED_FLOOR 10.0     /* 定长运动减速末段 最低速度 整步/S */
+
+#define L6470_POS_MASK 0x3FFFFF /* ABS_POS 22 位 */
+
+#define L6470_STATUS_HEALTHY 0x7E00 /* 低有效告警位 全部无告警 */
+
+/* Private typedef -----------------------------------------------------------*/
+typedef enum {
+    eL6470_Mode_Stop,     /* 停止 */
+    eL6470_Mode_Move,     /* 定长运动 */
+    eL6470_Mode_Run,      /* 持续运动 */
+    eL6470_Mode_Stopping, /* 减速停车 */
+} eL6470_Mode;
+
+/* 机构与引脚配置 */
+typedef struct {
+    GPIO_TypeDef * cs_port;
+    uint16_t cs_pin;
+    GPIO_TypeDef * busy_port;
+    uint16_t busy_pin;
+    GPIO_TypeDef * flag_port;
+    uint16_t flag_pin;
+    GPIO_TypeDef * home_port; /* 原点光耦 */
+    uint16_t home_pin;
+    GPIO_TypeDef * scan_port; /* 位置光耦 无则为 NULL */
+    uint16_t scan_pin;
+    int32_t home_edge; /* 原点光耦遮挡范围 [0, home_edge) */
+    int32_t scan_low;  /* 位置光耦遮挡范围 [scan_low, scan_high] */
+    int32_t scan_high;
+    int32_t limit;   /* 行程末端 */
+    int32_t initial; /* 上电时机构位置 */
+} sL6470_Axis;
+
+typedef struct {
+    const sL6470_Axis * pAxis;
+    uint32_t regs[32];   /* 参数寄存器 按地址 */
+    int32_t abs_pos;     /* 驱动步数 ABS_POS */
+    int32_t phys;        /* 机构位置 */
+    eL6470_Mode mode;    /* 运动状态 */
+    uint8_t dir;         /* 方向 FWD REV */
+    uint8_t until;       /* GoUntil 等待 SW */
+    uint8_t action;      /* GoUntil 动作 0 重置 ABS_POS 0x08 复制到 MARK */
+    uint8_t hiz;         /* 桥臂高阻 */
+    uint8_t accel;       /* 本周期速度变化 0 恒速 1 加速 2 减速 */
+    uint8_t ticking;     /* 积分事件已挂起 */
+    double speed;        /* 当前速度 整步/S */
+    double run_speed;    /* Run GoUntil 目标速度 整步/S */
+    double frac;         /* 不足一步的位移 */
+    uint32_t remain;     /* 定长运动剩余步数 */
+    uint8_t command;     /* 当前命令 */
+    uint8_t need;        /* 剩余参数或应答字节数 */
+    uint32_t value;      /* 已收到参数 */
+    uint32_t reply;      /* 应答 高字节先出 */
+} sL6470;
+
+/* Private constants ---------------------------------------------------------*/
+static const sL6470_Axis cL6470_Axes[2] = {
+    /* 扫码电机 原点光耦 PE0 行程 idx6 4664 步 */
+    {MOT_NCS1_GPIO_Port, MOT_NCS1_Pin, MOT_NBUSY1_GPIO_Port, MOT_NBUSY1_Pin, MOT_NFLG1_GPIO_Port, MOT_NFLG1_Pin, OPTSW_OUT0_GPIO_Port, OPTSW_OUT0_Pin, NULL, 0,
+     250, 0, 0, 5400, 2000},
+    /* 托盘电机 原点光耦 PE1 扫码位置光耦 PE2 行程 idx2 6600 步 */
+    {MOT_NCS2_GPIO_Port, MOT_NCS2_Pin, MOT_NBUSY2_GPIO_Port, MOT_NBUSY2_Pin, MOT_NFLG2_GPIO_Port, MOT_NFLG2_Pin, OPTSW_OUT1_GPIO_Port, OPTSW_OUT1_Pin,
+     OPTSW_OUT2_GPIO_Port, OPTSW_OUT2_Pin, 250, 1150, 1500, 7200, 3000},
+};
+
+/* Private variables ---------------------------------------------------------*/
+static sL6470 gL6470s[2];
+
+/* Private function prototypes -----------------------------------------------*/
+static void l6470_Tick(void * arg);
+
+/* Private user code ---------------------------------------------------------*/
+
+/**
+ * @brief  参数寄存器宽度
+ * @note   与固件 dSPIN_Get_Param / dSPIN_Set_Param 一致
+ * @param  reg 寄存器地址
+ * @retval 字节数
+ */
+static uint8_t l6470_Width(uint8_t reg)
+{
+    switch (reg) {
+        case dSPIN_ABS_POS:
+        case dSPIN_MARK:
+        case dSPIN_SPEED:
+            return 3;
+        case dSPIN_EL_POS:
+        case dSPIN_ACC:
+        case dSPIN_DEC:
+        case dSPIN_MAX_SPEED:
+        case dSPIN_MIN_SPEED:
+        case dSPIN_FS_SPD:
+        case dSPIN_INT_SPD:
+        case dSPIN_CONFIG:
+        case dSPIN_STATUS:
+            return 2;
+        default:
+            return 1;
+    }
+}
+
+/**
+ * @brief  22 位补码 符号扩展
+ * @param  value 寄存器值
+ * @retval 有符号值
+ */
+static int32_t l6470_Sign_Extend(uint32_t value)
+{
+    return ((int32_t)(value << 10)) >> 10;
+}
+
+/**
+ * @brief  原点光耦是否遮挡
+ * @param  pL6470 器件
+ * @retval 1 遮挡
+ */
+static uint8_t l6470_Is_Home(sL6470 * pL6470)
+{
+    return pL6470->phys < pL6470->pAxis->home_edge;
+}
+
+/**
+ * @brief  输出引脚与光耦 按当前状态更新
+ * @param  pL6470 器件
+ * @retval None
+ */
+static void l6470_Pins(sL6470 * pL6470)
+{
+    const sL6470_Axis * pAxis = pL6470->pAxis;
+
+    host_Gpio_Input(pAxis->busy_port, pAxis->busy_pin, pL6470->mode == eL6470_Mode_Stop);
+    host_Gpio_Input(pAxis->flag_port, pAxis->flag_pin, 1);
+    host_Gpio_Input(pAxis->home_port, pAxis->home_pin, l6470_Is_Home(pL6470) == 0);
+    if (pAxis->scan_port != NULL) {
+        host_Gpio_Input(pAxis->scan_port, pAxis->scan_pin, pL6470->phys < pAxis->scan_low || pL6470->phys > pAxis->scan_high);
+    }
+}
+
+/**
+ * @brief  复位
+ * @note   寄存器恢复数据手册默认值 停止并进入高阻 机构位置不变
+ * @param  pL6470 器件
+ * @retval None
+ */
+static void l6470_Reset(sL6470 * pL6470)
+{
+    memset(pL6470->regs, 0, sizeof(pL6470->regs));
+    pL6470->regs[dSPIN_ACC] = 0x08A;
+    pL6470->regs[dSPIN_DEC] = 0x08A;
+    pL6470->regs[dSPIN_MAX_SPEED] = 0x041;
+    pL6470->regs[dSPIN_FS_SPD] = 0x027;
+    pL6470->regs[dSPIN_KVAL_HOLD] = 0x29;
+    pL6470->regs[dSPIN_KVAL_RUN] = 0x29;
+    pL6470->regs[dSPIN_KVAL_ACC] = 0x29;
+    pL6470->regs[dSPIN_KVAL_DEC] = 0x29;
+    pL6470->regs[dSPIN_INT_SPD] = 0x0408;
+    pL6470->regs[dSPIN_ST_SLP] = 0x19;
+    pL6470->regs[dSPIN_FN_SLP_ACC] = 0x29;
+    pL6470->regs[dSPIN_FN_SLP_DEC] = 0x29;
+    pL6470->regs[dSPIN_OCD_TH] = 0x08;
+    pL6470->regs[dSPIN_STALL_TH] = 0x40;
+    pL6470->regs[dSPIN_STEP_MODE] = 0x07;
+    pL6470->regs[dSPIN_ALARM_EN] = 0xFF;
+    pL6470->regs[dSPIN_CONFIG] = 0x2E88;
+    pL6470->abs_pos = 0;
+    pL6470->mode = eL6470_Mode_Stop;
+    pL6470->speed = 0;
+    pL6470->frac = 0;
+    pL6470->hiz = 1;
+    pL6470->need = 0;
+    l6470_Pins(pL6470);
+}
+
+/**
+ * @brief  状态寄存器
+ * @param  pL6470 器件
+ * @retval 状态
+ */
+static uint16_t l6470_Status(sL6470 * pL6470)
+{
+    uint16_t status = L6470_STATUS_HEALTHY;
+
+    if (pL6470->hiz) {
+        status |= dSPIN_STATUS_HIZ;
+    }
+    if (pL6470->mode == eL6470_Mode_Stop) {
+        status |= dSPIN_STATUS_BUSY;
+    } else if (pL6470->accel == 1) {
+        status |= dSPIN_STATUS_MOT_STATUS_ACCELERATION;
+    } else if (pL6470->accel == 2) {
+        status |= dSPIN_STATUS_MOT_STATUS_DECELERATION;
+    } else {
+        status |= dSPIN_STATUS_MOT_STATUS_CONST_SPD;
+    }
+    if (l6470_Is_Home(pL6470)) {
+        status |= dSPIN_STATUS_SW_F;
+    }
+    if (pL6470->dir == FWD) {
+        status |= dSPIN_STATUS_DIR;
+    }
+    return status;
+}
+
+/**
+ * @brief  停止
+ * @param  pL6470 器件
+ * @retval None
+ */
+static void l6470_Stop(sL6470 * pL6470)
+{
+    pL6470->mode = eL6470_Mode_Stop;
+    pL6470->speed = 0;
+    pL6470->frac = 0;
+    pL6470->until = 0;
+    l6470_Pins(pL6470);
+}
+
+/**
+ * @brief  开始运动
+ * @param  pL6470 器件
+ * @param  mode 运动状态
+ * @param  dir 方向
+ * @retval None
+ */
+static void l6470_Start(sL6470 * pL6470, eL6470_Mode mode, uint8_t dir)
+{
+    if (mode == eL6470_Mode_Move && pL6470->remain == 0) {
+        return;
+    }
+    if (pL6470->mode != eL6470_Mode_Stop && pL6470->dir != dir) { /* 换向 从静止开始 */
+        pL6470->speed = 0;
+    }
+    pL6470->mode = mode;
+    pL6470->dir = dir;
+    pL6470->hiz = 0;
+    l6470_Pins(pL6470);
+    if (pL6470->ticking == 0) {
+        pL6470->ticking = 1;
+        host_Event_After(L6470_TICK, l6470_Tick, pL6470);
+    }
+}
+
+/**
+ * @brief  运动到绝对位置
+ * @param  pL6470 器件
+ * @param  target 目标 ABS_POS
+ * @param  dir 方向 0xFF 取最短路径
+ * @retval None
+ */
+static void l6470_Go_To(sL6470 * pL6470, uint32_t target, uint8_t dir)
+{
+    int32_t diff = l6470_Sign_Extend((target - (uint32_t)pL6470->abs_pos) & L6470_POS_MASK);
+
+    if (dir == 0xFF) {
+        dir = (diff >= 0) ? (FWD) : (REV);
+    }
+    pL6470->remain = (((dir == FWD) ? (diff) : (-diff)) & L6470_POS_MASK);
+    l6470_Start(pL6470, eL6470_Mode_Move, dir);
+}
+
+/**
+ * @brief  走步
+ * @note   驱动步数照常计数 机构位置限制在行程内
+ * @param  pL6470 器件
+ * @param  steps 步数
+ * @retval None
+ */
+static void l6470_Step(sL6470 * pL6470, uint32_t steps)
+{
+    if (pL6470->dir == FWD) {
+        pL6470->abs_pos = l6470_Sign_Extend((pL6470->abs_pos + steps) & L6470_POS_MASK);
+        pL6470->phys -= steps;
+    } else {
+        pL6470->abs_pos = l6470_Sign_Extend((pL6470->abs_pos - steps) & L6470_POS_MASK);
+        pL6470->phys += steps;
+    }
+    if (pL6470->phys < 0) {
+        pL6470->phys = 0;
+    } else if (pL6470->phys > pL6470->pAxis->limit) {
+        pL6470->phys = pL6470->pAxis->limit;
+    }
+}
+
+/**
+ * @brief  运动积分
+ * @param  arg 器件
+ * @retval None
+ */
+static void l6470_Tick(void * arg)
+{
+    sL6470 * pL6470 = arg;
+    double dt = (double)L6470_TICK / HOST_NS_PER_S, target, max, acc, dec, distance;
+    uint32_t micro, steps;
+
+    pL6470->ticking = 0;
+    if (pL6470->mode == eL6470_Mode_Stop) {
+        return;
+    }
+    micro = 1U << (pL6470->regs[dSPIN_STEP_MODE] & 0x07);
+    max = (pL6470->regs[dSPIN_MAX_SPEED] & 0x3FF) * L6470_MAX_SPEED_UNIT;
+    acc = (pL6470->regs[dSPIN_ACC] & 0xFFF) * L6470_ACC_UNIT;
+    dec = (pL6470->regs[dSPIN_DEC] & 0xFFF) * L6470_ACC_UNIT;
+
+    switch (pL6470->mode) {
+        case eL6470_Mode_Run:
+            target = (pL6470->run_speed < max) ? (pL6470->run_speed) : (max);
+            break;
+        case eL6470_Mode_Move: /* 剩余距离不足减速距离时减速 */
+            target = ((double)pL6470->remain / micro <= pL6470->speed * pL6470->speed / (2 * dec)) ? (0) : (max);
+            break;
+        default:
+            target = 0;
+            break;
+    }
+    if (pL6470->speed < target) {
+        pL6470->speed = (pL6470->speed + acc * dt < target) ? (pL6470->speed + acc * dt) : (target);
+        pL6470->accel = 1;
+    } else if (pL6470->speed > target) {
+        pL6470->speed = (pL6470->speed - dec * dt > target) ? (pL6470->speed - dec * dt) : (target);
+        pL6470->accel = 2;
+    } else {
+        pL6470->accel = 0;
+    }
+    if (pL6470->mode == eL6470_Mode_Move && pL6470->speed < L6470_SPEED_FLOOR) {
+        pL6470->speed = L6470_SPEED_FLOOR;
+    }
+
+    distance = pL6470->speed * dt * micro + pL6470->frac;
+    steps = (uint32_t)distance;
+    pL6470->frac = distance - steps;
+    if (pL6470->mode == eL6470_Mode_Move && steps >= pL6470->remain) {
+        steps = pL6470->remain;
+    }
+    l6470_Step(pL6470, steps);
+
+    if (pL6470->mode == eL6470_Mode_Move) {
+        pL6470->remain -= steps;
+        if (pL6470->remain == 0) {
+            l6470_Stop(pL6470);
+            return;
+        }
+    } else if (pL6470->mode == eL6470_Mode_Stopping && pL6470->speed <= 0) {
+        l6470_Stop(pL6470);
+        return;
+    }
+    if (pL6470->until && l6470_Is_Home(pL6470)) { /* GoUntil SW 下降沿 执行动作后减速停车 */
+        pL6470->until = 0;
+        if (pL6470->action) {
+            pL6470->regs[dSPIN_MARK] = pL6470->abs_pos & L6470_POS_MASK;
+        } else {
+            pL6470->abs_pos = 0;
+        }
+        pL6470->mode = eL6470_Mode_Stopping;
+    }
+    l6470_Pins(pL6470);
+    pL6470->ticking = 1;
+    host_Event_After(L6470_TICK, l6470_Tick, pL6470);
+}
+
+/**
+ * @brief  命令参数收齐 执行
+ * @param  pL6470 器件
+ * @retval None
+ */
+static void l6470_Execute(sL6470 * pL6470)
+{
+    uint8_t command = pL6470->command, reg = command & 0x1F;
+
+    if ((command & 0xE0) == dSPIN_SET_PARAM) {
+        if (reg == dSPIN_ABS_POS) {
+            pL6470->abs_pos = l6470_Sign_Extend(pL6470->value & L6470_POS_MASK);
+        } else if (reg != dSPIN_NOP && reg != dSPIN_SPEED && reg != dSPIN_STATUS && reg != dSPIN_ADC_OUT) {
+            pL6470->regs[reg] = pL6470->value;
+        }
+        return;
+    }
+    if ((command & 0xFE) == dSPIN_RUN) {
+        pL6470->run_speed = (pL6470->value & 0xFFFFF) * L6470_SPEED_UNIT;
+        pL6470->until = 0;
+        l6470_Start(pL6470, eL6470_Mode_Run, command & 0x01);
+    } else if ((command & 0xFE) == dSPIN_MOVE) {
+        pL6470->remain = pL6470->value & L6470_POS_MASK;
+        pL6470->until = 0;
+        l6470_Start(pL6470, eL6470_Mode_Move, command & 0x01);
+    } else if (command == dSPIN_GO_TO) {
+        l6470_Go_To(pL6470, pL6470->value, 0xFF);
+    } else if ((command & 0xFE) == dSPIN_GO_TO_DIR) {
+        l6470_Go_To(pL6470, pL6470->value, command & 0x01);
+    } else if ((command & 0xF6) == dSPIN_GO_UNTIL) {
+        pL6470->run_speed = (pL6470->value & 0xFFFFF) * L6470_SPEED_UNIT;
+        pL6470->until = 1;
+        pL6470->action = command & 0x08;
+        l6470_Start(pL6470, eL6470_Mode_Run, command & 0x01);
+    } else if (command == dSPIN_GO_HOME) {
+        l6470_Go_To(pL6470, 0, 0xFF);
+    } else if (command == dSPIN_GO_MARK) {
+        l6470_Go_To(pL6470, pL6470->regs[dSPIN_MARK], 0xFF);
+    } else if (command == dSPIN_RESET_POS) {
+        pL6470->abs_pos = 0;
+    } else if (command == dSPIN_RESET_DEVICE) {
+        l6470_Reset(pL6470);
+    } else if (command == dSPIN_SOFT_STOP) {
+        if (pL6470->mode != eL6470_Mode_Stop) {
+            pL6470->mode = eL6470_Mode_Stopping;
+            pL6470->until = 0;
+        }
+    } else if (command == dSPIN_HARD_STOP) {
+        l6470_Stop(pL6470);
+    } else if (command == dSPIN_SOFT_HIZ || command == dSPIN_HARD_HIZ) {
+        l6470_Stop(pL6470);
+        pL6470->hiz = 1;
+    }
+}
+
+/**
+ * @brief  命令字节 解码
+ * @note   ReleaseSW StepClock 未使用 视为无参数命令忽略
+ * @param  pL6470 器件
+ * @param  command 命令字节
+ * @retval 后续字节数
+ */
+static uint8_t l6470_Decode(sL6470 * pL6470, uint8_t command)
+{
+    uint8_t reg = command & 0x1F;
+
+    if ((command & 0xE0) == dSPIN_SET_PARAM) {
+        return (reg == dSPIN_NOP) ? (0) : (l6470_Width(reg));
+    }
+    if ((command & 0xE0) == dSPIN_GET_PARAM) {
+        switch (reg) {
+            case dSPIN_ABS_POS:
+                pL6470->reply = pL6470->abs_pos & L6470_POS_MASK;
+                break;
+            case dSPIN_SPEED:
+                pL6470->reply = (uint32_t)(pL6470->speed / L6470_SPEED_UNIT) & 0xFFFFF;
+                break;
+            case dSPIN_STATUS:
+                pL6470->reply = l6470_Status(pL6470);
+                break;
+            default:
+                pL6470->reply = pL6470->regs[reg];
+                break;
+        }
+        return l6470_Width(reg);
+    }
+    if (command == dSPIN_GET_STATUS) {
+        pL6470->reply = l6470_Status(pL6470);
+        return 2;
+    }
+    if ((command & 0xFE) == dSPIN_RUN || (command & 0xFE) == dSPIN_MOVE || command == dSPIN_GO_TO || (command & 0xFE) == dSPIN_GO_TO_DIR ||
+        (command & 0xF6) == dSPIN_GO_UNTIL) {
+        return 3;
+    }
+    return 0;
+}
+
+/**
+ * @brief  交换一个字节
+ * @param  arg 器件
+ * @param  mosi 主机输出
+ * @retval 器件输出 命令字节期间为 0
+ */
+static uint8_t l6470_Swap(void * arg, uint8_t mosi)
+{
+    sL6470 * pL6470 = arg;
+    uint8_t miso;
+
+    if (pL6470->need > 0) {
+        --pL6470->need;
+        miso = (pL6470->reply >> (8 * pL6470->need)) & 0xFF;
+        pL6470->value = (pL6470->value << 8) | mosi;
+        if (pL6470->need == 0) {
+            l6470_Execute(pL6470);
+        }
+        return miso;
+    }
+    pL6470->command = mosi;
+    pL6470->value = 0;
+    pL6470->reply = 0;
+    pL6470->need = l6470_Decode(pL6470, mosi);
+    if (pL6470->need == 0) {
+        l6470_Execute(pL6470);
+    }
+    return 0;
+}
+
+/**
+ * @brief  复位脚变化
+ * @param  arg 未使用
+ * @param  port 端口
+ * @param  pin 引脚
+ * @param  level 电平
+ * @retval None
+ */
+static void l6470_Reset_Pin(void * arg, GPIO_TypeDef * port, uint16_t pin, uint8_t level)
+{
+    uint8_t i;
+
+    if (level) {
+        return;
+    }
+    for (i = 0; i < ARRAY_LEN(gL6470s); ++i) {
+        l6470_Reset(&gL6470s[i]);
+    }
+}
+
+/**
+ * @brief  挂接到 SPI2
+ * @note   机构位置取上电位置 不在原点
+ * @param  None
+ * @retval None
+ */
+void host_L6470_Attach(void)
+{
+    sHost_Spi_Device device = {l6470_Swap, NULL, NULL}; /* 命令状态跨片选保持 不关心片选变化 */
+    uint8_t i;
+
+    for (i = 0; i < ARRAY_LEN(gL6470s); ++i) {
+        memset(&gL6470s[i], 0, sizeof(gL6470s[i]));
+        gL6470s[i].pAxis = &cL6470_Axes[i];
+        gL6470s[i].phys = cL6470_Axes[i].initial;
+        gL6470s[i].dir = FWD;
+        l6470_Reset(&gL6470s[i]);
+        device.arg = &gL6470s[i];
+        host_Spi_Attach(SPI2, cL6470_Axes[i].cs_port, cL6470_Axes[i].cs_pin, &device);
+    }
+    host_Gpio_Watch(MOT_NRST_GPIO_Port, MOT_NRST_Pin, l6470_Reset_Pin, NULL);
+}
+
+/**
+ * @brief  机构位置
+ * @param  index 0 扫码电机 1 托盘电机
+ * @retval 距机械零点微步数
+ */
+int32_t host_L6470_Position(uint8_t index)
+{
+    return gL6470s[index].phys;
+}
@@ -0,0 +1,159 @@
+/**
+ * @file    peer.c
+ * @brief   主机构建 协议对端模型
+ *
+ * 接收控制板发出的字节流 按帧头与长度拼包 CRC8 (固件 protocol.c) 校验后回调
+ * 自动回应时 对非 ACK 帧回 ACK (数据为对方帧号) 与上位机行为一致
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+
+#include "main.h"
+#include "protocol.h"
+#include "host_model.h"
+
+/* Private user code ---------------------------------------------------------*/
+
+/**
+ * @brief  构造帧
+ * @param  pPeer 对端
+ * @param  pOut 输出 长度至少 length + 7
+ * @param  cmd 命令字
+ * @param  pData 数据
+ * @param  length 数据长度
+ * @retval 帧长度
+ */
+uint8_t host_Peer_Build(sHost_Peer * pPeer, uint8_t * pOut, uint8_t cmd, const uint8_t * pData, uint8_t length)
+{
+    if (++pPeer->index == 0) { /* 固件以 0 为初始上一帧号 */
+        pPeer->index = 1;
+    }
+    pOut[0] = 0x69;
+    pOut[1] = 0xAA;
+    pOut[2] = 3 + length;
+    pOut[3] = pPeer->index;
+    pOut[4] = pPeer->device_id;
+    pOut[5] = cmd;
+    if (length > 0) {
+        memcpy(&pOut[6], pData, length);
+    }
+    pOut[6 + length] = CRC8(&pOut[4], 2 + length);
+    return length + 7;
+}
+
+/**
+ * @brief  发送帧
+ * @param  pPeer 对端
+ * @param  cmd 命令字
+ * @param  pData 数据
+ * @param  length 数据长度
+ * @retval None
+ */
+void host_Peer_Send(sHost_Peer * pPeer, uint8_t cmd, const uint8_t * pData, uint8_t length)
+{
+    uint8_t frame[262];
+
+    host_Uart_Send(pPeer->uart, frame, host_Peer_Build(pPeer, frame, cmd, pData, length));
+}
+
+/**
+ * @brief  回应 ACK
+ * @note   ACK 不占用帧号
+ * @param  pPeer 对端
+ * @param  index 对方帧号
+ * @retval None
+ */
+void host_Peer_Ack(sHost_Peer * pPeer, uint8_t index)
+{
+    uint8_t ack[8];
+
+    ack[0] = 0x69;
+    ack[1] = 0xAA;
+    ack[2] = 4;
+    ack[3] = pPeer->index;
+    ack[4] = pPeer->device_id;
+    ack[5] = eProtocolRespPack_Client_ACK;
+    ack[6] = index;
+    ack[7] = CRC8(&ack[4], 3);
+    host_Uart_Send(pPeer->uart, ack, sizeof(ack));
+}
+
+/**
+ * @brief  处理一个完整帧
+ * @param  pPeer 对端
+ * @param  pFrame 帧
+ * @param  length 帧长度
+ * @retval None
+ */
+static void host_Peer_Frame(sHost_Peer * pPeer, uint8_t * pFrame, uint16_t length)
+{
+    if (CRC8(&pFrame[4], length - 5) != pFrame[length - 1]) {
+        ++pPeer->crc_errors;
+        return;
+    }
+    ++pPeer->frames;
+    if (pPeer->auto_ack && pFrame[5] != eProtocolRespPack_Client_ACK) {
+        host_Peer_Ack(pPeer, pFrame[3]);
+    }
+    if (pPeer->fun != NULL) {
+        pPeer->fun(pPeer->arg, pFrame, length);
+    }
+}
+
+/**
+ * @brief  控制板发出数据
+ * @param  arg 对端
+ * @param  pData 数据
+ * @param  length 长度
+ * @retval None
+ */
+static void host_Peer_Receive(void * arg, const uint8_t * pData, uint16_t length)
+{
+    sHost_Peer * pPeer = arg;
+    uint16_t i, need;
+
+    for (i = 0; i < length; ++i) {
+        if (pPeer->length >= sizeof(pPeer->buffer)) {
+            pPeer->length = 0;
+        }
+        pPeer->buffer[pPeer->length++] = pData[i];
+        if (pPeer->buffer[0] != 0x69 || (pPeer->length >= 2 && pPeer->buffer[1] != 0xAA)) { /* 帧头错位 丢弃首字节 */
+            memmove(pPeer->buffer, pPeer->buffer + 1, --pPeer->length);
+            continue;
+        }
+        if (pPeer->length < 3) {
+            continue;
+        }
+        need = pPeer->buffer[2] + 4;
+        if (need < 7) {
+            pPeer->length = 0;
+            continue;
+        }
+        if (pPeer->length == need) {
+            host_Peer_Frame(pPeer, pPeer->buffer, need);
+            pPeer->length = 0;
+        }
+    }
+}
+
+/**
+ * @brief  挂接对端
+ * @note   默认自动回应
+ * @param  pPeer 对端
+ * @param  uart 串口
+ * @param  device_id 本端设备ID
+ * @param  fun 完整帧回调
+ * @param  arg 参数
+ * @retval None
+ */
+void host_Peer_Attach(sHost_Peer * pPeer, USART_TypeDef * uart, uint8_t device_id, host_Peer_Frame_Fun fun, void * arg)
+{
+    memset(pPeer, 0, sizeof(*pPeer));
+    pPeer->uart = uart;
+    pPeer->device_id = device_id;
+    pPeer->auto_ack = 1;
+    pPeer->fun = fun;
+    pPeer->arg = arg;
+    host_Uart_Connect(uart, host_Peer_Receive, pPeer);
+}
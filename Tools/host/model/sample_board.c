@@ -0,0 +1,292 @@
+/**
+ * @file    sample_board.c
+ * @brief   主机构建 采样板模型
+ *
+ * USART2 协议对端 (设备ID 0x46) 收到测试项信息帧 (0x26) 记录各通道点数 点数全零视为清除配置
+ *     LED 电压读取 (0x32) 回应 0x32 校正偏移量读取 (0x36) 回应 0xB4 白板放大倍数读取 (0x37) 回应 0x37
+ *     杂散光采集 (0x28) 一次采样时间后回应采集数据完成帧 (0x34) 其余命令仅回应 ACK
+ * 已配置时 跟随采样输出脚 PD7 变化 (下降沿 白板 上升沿 PD) 在采样输入脚 PD4 上给出采样脉冲
+ *     上升沿 采样开始 下降沿 采样完成 固件于下降沿推进采样流程
+ *     PD 采样时 脉冲期间按通道发出采集数据帧 (0xB3) [点数 通道 数据 x 点数] 点数为已完成 PD 次数 不超过该通道配置点数
+ *     数据格式 u16 / u32 / 混合 (PD u32 白板 u32 采样值 u16) 见 host_Sample_Board_Setup
+ * 故障注入 重复帧 (相同帧号) 长度异常 (数据多 1 字节) 点数超出记录缓存 错误信息帧 (0xB5) 不再通知采样完成
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+
+#include "main.h"
+#include "protocol.h"
+#include "comm_data.h"
+#include "host_model.h"
+
+/* Private define ------------------------------------------------------------*/
+#define SAMPLE_BOARD_CHANNELS 6
+#define SAMPLE_BOARD_RISE_DELAY (5 * HOST_NS_PER_MS) /* 采样输出脚变化至采样开始 */
+#define SAMPLE_BOARD_PULSE (100 * HOST_NS_PER_MS)    /* 最短采样时间 */
+#define SAMPLE_BOARD_FRAME_GAP (2 * HOST_NS_PER_MS)  /* 数据帧间隔 */
+#define SAMPLE_BOARD_DATA_MAX 248                    /* 数据帧 数据长度上限 */
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    sHost_Peer peer;
+    uint8_t points[SAMPLE_BOARD_CHANNELS]; /* 各通道配置点数 */
+    uint8_t configured;                    /* 已收到有效配置 */
+    uint8_t pd_count;                      /* 已完成 PD 采样次数 */
+    uint8_t channel;                       /* 待发数据帧 通道索引 */
+    uint32_t pulses;                       /* 采样脉冲次数 */
+    uint32_t data_frames;                  /* 已发数据帧数 */
+    sHost_Sample_Board_Conf conf;          /* 数据格式与故障注入 */
+} sSample_Board;
+
+/* Private constants ---------------------------------------------------------*/
+static const uint8_t cSample_Board_Point_Size[] = {2, 4, 10};                               /* 各格式 每点字节数 */
+static const uint8_t cSample_Board_Max_Points[] = {120, 60, 20};                            /* 各格式 记录缓存 (240 字节) 可容纳点数 混合类型每点记录 12 字节 */
+static const uint8_t cSample_Board_Oversize[] = {121, 61, 24};                              /* 各格式 超出记录缓存的点数 */
+static const uint8_t cSample_Board_Error[] = {0x01, 0x00};                                  /* 错误信息帧 错误码 小端 */
+static const uint16_t cSample_Board_LED[] = {1500, 1800, 2100};                             /* LED 电压 610 550 405 */
+static const uint16_t cSample_Board_Offset[] = {220, 215, 230, 210, 225, 218};              /* 校正偏移量 各通道 */
+static const uint32_t cSample_Board_Magnify[] = {10000, 10000, 10000, 10000, 10000, 10000}; /* 白板放大倍数 各通道 */
+
+/* Private variables ---------------------------------------------------------*/
+static sSample_Board gSample_Board;
+
+/* Private user code ---------------------------------------------------------*/
+
+/**
+ * @brief  采样读数
+ * @note   按通道与点序号逐点递增 相邻点偏差大 不触发提前结束
+ * @param  channel 通道索引 1～6
+ * @param  idx 点序号
+ * @retval 读数
+ */
+static uint16_t sample_Board_Value(uint8_t channel, uint8_t idx)
+{
+    return 10000 + channel * 100 + idx * 500;
+}
+
+/**
+ * @brief  采样完成 采样输入脚拉低
+ * @param  arg 未使用
+ * @retval None
+ */
+static void sample_Board_Fall(void * arg)
+{
+    host_Gpio_Input(FRONT_TRIG_IN_GPIO_Port, FRONT_TRIG_IN_Pin, 0);
+}
+
+/**
+ * @brief  填充一点数据
+ * @param  pOut 输出
+ * @param  channel 通道索引 1～6
+ * @param  idx 点序号
+ * @retval 字节数
+ */
+static uint8_t sample_Board_Point(uint8_t * pOut, uint8_t channel, uint8_t idx)
+{
+    uint16_t value = sample_Board_Value(channel, idx);
+    uint32_t pd = value * 16, white = 600000 + channel * 1000;
+
+    switch (gSample_Board.conf.format) {
+        case eHost_Sample_Board_Format_U32:
+            memcpy(pOut, &pd, 4); /* 小端 */
+            break;
+        case eHost_Sample_Board_Format_Mix:
+            memcpy(pOut, &pd, 4);
+            memcpy(pOut + 4, &white, 4);
+            memcpy(pOut + 8, &value, 2);
+            break;
+        default:
+            memcpy(pOut, &value, 2);
+            break;
+    }
+    return cSample_Board_Point_Size[gSample_Board.conf.format];
+}
+
+/**
+ * @brief  发出下一通道数据帧 全部发完后结束采样
+ * @note   第 hang_at 次 PD 起不再结束采样
+ * @param  arg 未使用
+ * @retval None
+ */
+static void sample_Board_Data(void * arg)
+{
+    uint8_t data[2 + SAMPLE_BOARD_DATA_MAX], frame[SAMPLE_BOARD_DATA_MAX + 9];
+    uint8_t i, num, length, frame_length;
+
+    while (gSample_Board.channel < SAMPLE_BOARD_CHANNELS && gSample_Board.points[gSample_Board.channel] == 0) {
+        ++gSample_Board.channel;
+    }
+    if (gSample_Board.channel >= SAMPLE_BOARD_CHANNELS) {
+        if (gSample_Board.conf.hang_at == 0 || gSample_Board.pd_count < gSample_Board.conf.hang_at) {
+            host_Event_After(SAMPLE_BOARD_FRAME_GAP, sample_Board_Fall, NULL);
+        }
+        return;
+    }
+
+    num = gSample_Board.pd_count;
+    if (num > gSample_Board.points[gSample_Board.channel]) {
+        num = gSample_Board.points[gSample_Board.channel];
+    }
+    if (num > cSample_Board_Max_Points[gSample_Board.conf.format]) {
+        num = cSample_Board_Max_Points[gSample_Board.conf.format];
+    }
+    if (gSample_Board.pd_count == gSample_Board.conf.oversize_at) { /* 点数超出记录缓存 */
+        num = cSample_Board_Oversize[gSample_Board.conf.format];
+    }
+    data[0] = num;
+    data[1] = gSample_Board.channel + 1;
+    for (i = 0, length = 2; i < num; ++i) {
+        length += sample_Board_Point(data + length, gSample_Board.channel + 1, i);
+    }
+    if (gSample_Board.conf.bad_length > 0 && (gSample_Board.data_frames + 1) % gSample_Board.conf.bad_length == 0) { /* 数据多 1 字节 */
+        data[length++] = 0;
+    }
+    frame_length = host_Peer_Build(&gSample_Board.peer, frame, eComm_Data_Inbound_CMD_DATA, data, length);
+    host_Uart_Send(USART2, frame, frame_length);
+    ++gSample_Board.data_frames;
+    if (gSample_Board.conf.dup > 0 && gSample_Board.data_frames % gSample_Board.conf.dup == 0) { /* 相同帧号 重复发送 */
+        host_Uart_Send(USART2, frame, frame_length);
+    }
+    ++gSample_Board.channel;
+    host_Event_After(host_Uart_Byte_Time(USART2) * frame_length + SAMPLE_BOARD_FRAME_GAP, sample_Board_Data, NULL);
+}
+
+/**
+ * @brief  采样开始 采样输入脚拉高
+ * @param  arg NULL 白板 非 NULL PD
+ * @retval None
+ */
+static void sample_Board_Rise(void * arg)
+{
+    ++gSample_Board.pulses;
+    host_Gpio_Input(FRONT_TRIG_IN_GPIO_Port, FRONT_TRIG_IN_Pin, 1);
+    if (arg == NULL) {
+        host_Event_After(SAMPLE_BOARD_PULSE, sample_Board_Fall, NULL);
+        return;
+    }
+    ++gSample_Board.pd_count;
+    gSample_Board.channel = 0;
+    if (gSample_Board.pd_count == gSample_Board.conf.error_at) { /* 错误信息帧代替数据帧 */
+        host_Peer_Send(&gSample_Board.peer, eComm_Data_Inbound_CMD_ERROR, cSample_Board_Error, sizeof(cSample_Board_Error));
+        host_Event_After(SAMPLE_BOARD_PULSE, sample_Board_Fall, NULL);
+        return;
+    }
+    host_Event_After(SAMPLE_BOARD_PULSE, sample_Board_Data, NULL);
+}
+
+/**
+ * @brief  杂散光采集完成
+ * @param  arg 未使用
+ * @retval None
+ */
+static void sample_Board_Stray(void * arg)
+{
+    host_Peer_Send(&gSample_Board.peer, eComm_Data_Inbound_CMD_OVER, NULL, 0);
+}
+
+/**
+ * @brief  采样输出脚变化
+ * @param  arg 未使用
+ * @param  port 端口
+ * @param  pin 引脚
+ * @param  level 电平 0 白板 1 PD
+ * @retval None
+ */
+static void sample_Board_Status(void * arg, GPIO_TypeDef * port, uint16_t pin, uint8_t level)
+{
+    if (gSample_Board.configured == 0) {
+        return;
+    }
+    host_Event_After(SAMPLE_BOARD_RISE_DELAY, sample_Board_Rise, (level) ? (&gSample_Board) : (NULL));
+}
+
+/**
+ * @brief  收到控制板帧
+ * @param  arg 未使用
+ * @param  pFrame 帧
+ * @param  length 帧长度
+ * @retval None
+ */
+static void sample_Board_Frame(void * arg, const uint8_t * pFrame, uint16_t length)
+{
+    uint8_t i;
+
+    switch (pFrame[5]) {
+        case eComm_Data_Outbound_CMD_CONF:
+            if (length < 6 + 3 * SAMPLE_BOARD_CHANNELS + 1) {
+                break;
+            }
+            gSample_Board.configured = 0;
+            gSample_Board.pd_count = 0;
+            for (i = 0; i < SAMPLE_BOARD_CHANNELS; ++i) {
+                gSample_Board.points[i] = pFrame[6 + 3 * i + 2];
+                if (gSample_Board.points[i] > 0) {
+                    gSample_Board.configured = 1;
+                }
+            }
+            break;
+        case eComm_Data_Outbound_CMD_LED_GET:
+            host_Peer_Send(&gSample_Board.peer, eComm_Data_Inbound_CMD_LED_GET, (const uint8_t *)cSample_Board_LED, sizeof(cSample_Board_LED));
+            break;
+        case eComm_Data_Outbound_CMD_OFFSET_GET:
+            host_Peer_Send(&gSample_Board.peer, eComm_Data_Inbound_CMD_OFFSET_GET, (const uint8_t *)cSample_Board_Offset, sizeof(cSample_Board_Offset));
+            break;
+        case eComm_Data_Outbound_CMD_WHITE_MAGNIFY_GET:
+            host_Peer_Send(&gSample_Board.peer, eComm_Data_Inbound_CMD_WHITE_MAGNIFY_GET, (const uint8_t *)cSample_Board_Magnify,
+                           sizeof(cSample_Board_Magnify));
+            break;
+        case eComm_Data_Outbound_CMD_STRAY:
+            host_Event_After(SAMPLE_BOARD_PULSE, sample_Board_Stray, NULL);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief  挂接到 USART2
+ * @param  None
+ * @retval None
+ */
+void host_Sample_Board_Attach(void)
+{
+    memset(&gSample_Board, 0, sizeof(gSample_Board));
+    host_Peer_Attach(&gSample_Board.peer, USART2, PROTOCOL_DEVICE_ID_SAMP, sample_Board_Frame, NULL);
+    host_Gpio_Input(FRONT_TRIG_IN_GPIO_Port, FRONT_TRIG_IN_Pin, 0);
+    host_Gpio_Watch(FRONT_STATUS_GPIO_Port, FRONT_STATUS_Pin, sample_Board_Status, NULL);
+}
+
+/**
+ * @brief  设置数据格式与故障注入
+ * @note   挂接后调用 未调用时为 u16 无故障
+ * @param  pConf 配置
+ * @retval None
+ */
+void host_Sample_Board_Setup(const sHost_Sample_Board_Conf * pConf)
+{
+    gSample_Board.conf = *pConf;
+    if (gSample_Board.conf.format > eHost_Sample_Board_Format_Mix) {
+        gSample_Board.conf.format = eHost_Sample_Board_Format_U16;
+    }
+}
+
+/**
+ * @brief  采样脉冲次数
+ * @param  None
+ * @retval 次数
+ */
+uint32_t host_Sample_Board_Pulses(void)
+{
+    return gSample_Board.pulses;
+}
+
+/**
+ * @brief  已发数据帧数
+ * @param  None
+ * @retval 帧数
+ */
+uint32_t host_Sample_Board_Data_Frames(void)
+{
+    return gSample_Board.data_frames;
+}
@@ -0,0 +1,253 @@
+/**
+ * @file    se2707.c
+ * @brief   主机构建 扫码头 SE2707 模型
+ *
+ * USART3 SSI 报文 [长度 命令 来源 状态 负载 校验高 校验低] 控制板先发 00 00 唤醒 再发报文
+ *     PARAM_REQUEST 回复 PARAM_SEND (曝光时间为 3 字节参数编号 2 字节值) PARAM_SEND PARAM_DEFAULTS 及其他命令回复 ACK
+ * 触发脚 PE14 拉低后 经解码时间发出条码原始内容 (无帧格式) 触发脚提前释放时不发出
+ *     扫码电机机构位置 (host_L6470_Position) 在二维码位置附近时为二维码内容 其余为一维码内容 内容为空时不发出
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+
+#include "main.h"
+#include "se2707.h"
+#include "host_model.h"
+
+/* Private define ------------------------------------------------------------*/
+#define SE2707_REPLY_DELAY (5 * HOST_NS_PER_MS)    /* 报文应答延时 */
+#define SE2707_DECODE_DELAY (120 * HOST_NS_PER_MS) /* 触发至发出条码 */
+#define SE2707_QR_POSITION 4400                    /* 扫码电机机构位置 此位置之后为二维码 */
+
+/* Private typedef -----------------------------------------------------------*/
+/* 参数项 */
+typedef struct {
+    uint32_t param; /* 参数编号 超过 16 位时应答为 3 字节编号 2 字节值 */
+    uint16_t value;
+    uint16_t value_default;
+} sSE2707_Param;
+
+typedef struct {
+    uint8_t buffer[SE2707_PACK_MAX_LENGTH];
+    uint16_t length;
+    uint8_t reply[16]; /* 待发应答 */
+    uint8_t reply_length;
+    const char * pQr; /* 条码内容 */
+    const char * pBar;
+    uint32_t scans; /* 发出条码次数 */
+} sSE2707;
+
+/* Private variables ---------------------------------------------------------*/
+/* 出厂值与固件配置值不同 上电配置流程完整执行 */
+static sSE2707_Param gSE2707_Params[] = {
+    {Decode_Aiming_Pattern, 1, 1},
+    {Illumination_Brightness, 10, 10},
+    {Decoding_Autoexposure, 1, 1},
+    {Exposure_Time, 100, 100},
+};
+
+static sSE2707 gSE2707;
+
+/* Private user code ---------------------------------------------------------*/
+
+/**
+ * @brief  按编号低 16 位查找参数项
+ * @param  param 参数编号
+ * @retval 参数项 未找到为 NULL
+ */
+static sSE2707_Param * se2707_Param_Find(uint16_t param)
+{
+    uint8_t i;
+
+    for (i = 0; i < ARRAY_LEN(gSE2707_Params); ++i) {
+        if ((gSE2707_Params[i].param & 0xFFFF) == param) {
+            return &gSE2707_Params[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief  组包 来源为扫码头
+ * @param  cmd 命令字
+ * @param  pPayload 负载
+ * @param  length 负载长度
+ * @retval None
+ */
+static void se2707_Reply_Build(uint8_t cmd, const uint8_t * pPayload, uint8_t length)
+{
+    uint16_t checksum;
+
+    gSE2707.reply[0] = length + 4;
+    gSE2707.reply[1] = cmd;
+    gSE2707.reply[2] = 0x00;
+    gSE2707.reply[3] = 0x00;
+    if (length > 0) {
+        memcpy(&gSE2707.reply[4], pPayload, length);
+    }
+    checksum = se2707_checksum_gen(gSE2707.reply, gSE2707.reply[0]);
+    gSE2707.reply[length + 4] = checksum >> 8;
+    gSE2707.reply[length + 5] = checksum & 0xFF;
+    gSE2707.reply_length = length + 6;
+}
+
+/**
+ * @brief  发出应答
+ * @param  arg 未使用
+ * @retval None
+ */
+static void se2707_Reply_Send(void * arg)
+{
+    host_Uart_Send(USART3, gSE2707.reply, gSE2707.reply_length);
+}
+
+/**
+ * @brief  处理一个完整报文
+ * @param  pPack 报文
+ * @retval None
+ */
+static void se2707_Pack(const uint8_t * pPack)
+{
+    sSE2707_Param * pParam;
+    uint8_t payload[6];
+    uint8_t i;
+
+    switch (pPack[1]) {
+        case PARAM_REQUEST:
+            pParam = se2707_Param_Find((pPack[4] << 8) + pPack[5]);
+            if (pParam == NULL) {
+                se2707_Reply_Build(CMD_NAK, NULL, 0);
+                break;
+            }
+            payload[0] = 0xFF;
+            if (pParam->param > 0xFFFF) {
+                payload[1] = pParam->param >> 16;
+                payload[2] = pParam->param >> 8;
+                payload[3] = pParam->param;
+                payload[4] = pParam->value >> 8;
+                payload[5] = pParam->value;
+                se2707_Reply_Build(PARAM_SEND, payload, 6);
+            } else {
+                payload[1] = pParam->param >> 8;
+                payload[2] = pParam->param;
+                payload[3] = pParam->value;
+                se2707_Reply_Build(PARAM_SEND, payload, 4);
+            }
+            break;
+        case PARAM_SEND: /* FF 编号高 编号低 值 */
+            pParam = (pPack[0] >= 8) ? (se2707_Param_Find((pPack[5] << 8) + pPack[6])) : (NULL);
+            if (pParam != NULL) {
+                pParam->value = pPack[7];
+            }
+            se2707_Reply_Build(CMD_ACK, NULL, 0);
+            break;
+        case PARAM_DEFAULTS:
+            for (i = 0; i < ARRAY_LEN(gSE2707_Params); ++i) {
+                gSE2707_Params[i].value = gSE2707_Params[i].value_default;
+            }
+            se2707_Reply_Build(CMD_ACK, NULL, 0);
+            break;
+        case CMD_ACK:
+        case CMD_NAK:
+            return;
+        default:
+            se2707_Reply_Build(CMD_ACK, NULL, 0);
+            break;
+    }
+    host_Event_After(SE2707_REPLY_DELAY, se2707_Reply_Send, NULL);
+}
+
+/**
+ * @brief  控制板发出数据
+ * @note   丢弃唤醒字节 按长度字节拼包 校验错误时丢弃
+ * @param  arg 未使用
+ * @param  pData 数据
+ * @param  length 长度
+ * @retval None
+ */
+static void se2707_Receive(void * arg, const uint8_t * pData, uint16_t length)
+{
+    uint16_t i, need;
+
+    for (i = 0; i < length; ++i) {
+        if (gSE2707.length == 0 && pData[i] < 4) { /* 唤醒字节 */
+            continue;
+        }
+        gSE2707.buffer[gSE2707.length++] = pData[i];
+        need = gSE2707.buffer[0] + 2;
+        if (gSE2707.length < need) {
+            continue;
+        }
+        if (se2707_checksum_check(gSE2707.buffer, need) == 0) {
+            se2707_Pack(gSE2707.buffer);
+        }
+        gSE2707.length = 0;
+    }
+}
+
+/**
+ * @brief  解码完成 发出条码
+ * @param  arg 条码内容
+ * @retval None
+ */
+static void se2707_Decode(void * arg)
+{
+    const char * pContent = arg;
+
+    ++gSE2707.scans;
+    host_Uart_Send(USART3, (const uint8_t *)pContent, strlen(pContent));
+}
+
+/**
+ * @brief  触发脚变化
+ * @param  arg 未使用
+ * @param  port 端口
+ * @param  pin 引脚
+ * @param  level 电平
+ * @retval None
+ */
+static void se2707_Trigger(void * arg, GPIO_TypeDef * port, uint16_t pin, uint8_t level)
+{
+    const char * pContent;
+
+    host_Event_Cancel(se2707_Decode, (void *)gSE2707.pQr);
+    host_Event_Cancel(se2707_Decode, (void *)gSE2707.pBar);
+    if (level) { /* 释放 */
+        return;
+    }
+    pContent = (host_L6470_Position(0) >= SE2707_QR_POSITION) ? (gSE2707.pQr) : (gSE2707.pBar);
+    if (pContent != NULL && pContent[0] != '\0') {
+        host_Event_After(SE2707_DECODE_DELAY, se2707_Decode, (void *)pContent);
+    }
+}
+
+/**
+ * @brief  挂接到 USART3
+ * @param  pQr 二维码内容 NULL 或空串时 二维码位置无结果
+ * @param  pBar 一维码内容 NULL 或空串时 一维码位置无结果
+ * @retval None
+ */
+void host_Se2707_Attach(const char * pQr, const char * pBar)
+{
+    uint8_t i;
+
+    memset(&gSE2707, 0, sizeof(gSE2707));
+    gSE2707.pQr = pQr;
+    gSE2707.pBar = pBar;
+    for (i = 0; i < ARRAY_LEN(gSE2707_Params); ++i) {
+        gSE2707_Params[i].value = gSE2707_Params[i].value_default;
+    }
+    host_Uart_Connect(USART3, se2707_Receive, NULL);
+    host_Gpio_Watch(BC_TRIG_N_GPIO_Port, BC_TRIG_N_Pin, se2707_Trigger, NULL);
+}
+
+/**
+ * @brief  发出条码次数
+ * @param  None
+ * @retval 次数
+ */
+uint32_t host_Se2707_Scans(void)
+{
+    return gSE2707.scans;
+}
@@ -0,0 +1,185 @@
+/**
+ * @file    w25q64.c
+ * @brief   主机构建 SPI Flash W25Q64BV 模型
+ *
+ * SPI1 片选 PA15 命令 读ID 读 页编程 扇区擦除 整片擦除 写使能/禁止 读写状态寄存器
+ * 编程与擦除期间状态寄存器 WIP 置位 按典型时长清除 编程只能由 1 写为 0
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+
+#include "main.h"
+#include "host_model.h"
+
+/* Private define ------------------------------------------------------------*/
+#define W25Q64_SECTOR_SIZE 4096
+#define W25Q64_PAGE_SIZE 256
+
+#define W25Q64_TIME_PAGE (700 * HOST_NS_PER_US)  /* 页编程 典型值 */
+#define W25Q64_TIME_SECTOR (45 * HOST_NS_PER_MS) /* 扇区擦除 典型值 */
+#define W25Q64_TIME_CHIP (20 * HOST_NS_PER_S)    /* 整片擦除 典型值 */
+
+#define W25Q64_SR_WIP 0x01
+#define W25Q64_SR_WEL 0x02
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    uint8_t memory[HOST_W25Q64_SIZE];
+    uint8_t status;      /* 状态寄存器 */
+    uint64_t busy_until; /* WIP 清除时刻 */
+    uint8_t command;     /* 当前命令 */
+    uint32_t count;      /* 当前命令已交换字节数 */
+    uint32_t address;
+} sW25q64;
+
+/* Private variables ---------------------------------------------------------*/
+static sW25q64 gW25q64;
+
+/* Private user code ---------------------------------------------------------*/
+
+/**
+ * @brief  状态寄存器
+ * @param  None
+ * @retval 状态
+ */
+static uint8_t w25q64_Status(void)
+{
+    if ((gW25q64.status & W25Q64_SR_WIP) && host_Time_Now() >= gW25q64.busy_until) {
+        gW25q64.status &= ~(W25Q64_SR_WIP | W25Q64_SR_WEL);
+    }
+    return gW25q64.status;
+}
+
+/**
+ * @brief  开始内部操作
+ * @param  duration 时长 nS
+ * @retval None
+ */
+static void w25q64_Busy(uint64_t duration)
+{
+    gW25q64.status |= W25Q64_SR_WIP;
+    gW25q64.busy_until = host_Time_Now() + duration;
+}
+
+/**
+ * @brief  片选变化
+ * @note   片选释放时执行擦除命令
+ * @param  arg 未使用
+ * @param  active 1 片选有效
+ * @retval None
+ */
+static void w25q64_Select(void * arg, uint8_t active)
+{
+    uint32_t sector;
+
+    if (active) {
+        gW25q64.command = 0;
+        gW25q64.count = 0;
+        gW25q64.address = 0;
+        return;
+    }
+    if ((w25q64_Status() & (W25Q64_SR_WIP | W25Q64_SR_WEL)) != W25Q64_SR_WEL) {
+        return;
+    }
+    switch (gW25q64.command) {
+        case 0x20: /* 扇区擦除 */
+            if (gW25q64.count == 4) {
+                sector = gW25q64.address & ~(W25Q64_SECTOR_SIZE - 1) & (HOST_W25Q64_SIZE - 1);
+                memset(&gW25q64.memory[sector], 0xFF, W25Q64_SECTOR_SIZE);
+                w25q64_Busy(W25Q64_TIME_SECTOR);
+            }
+            break;
+        case 0xC7: /* 整片擦除 */
+        case 0x60:
+            memset(gW25q64.memory, 0xFF, sizeof(gW25q64.memory));
+            w25q64_Busy(W25Q64_TIME_CHIP);
+            break;
+        case 0x02: /* 页编程 */
+            if (gW25q64.count > 4) {
+                w25q64_Busy(W25Q64_TIME_PAGE);
+            }
+            break;
+        case 0x01: /* 写状态寄存器 */
+            w25q64_Busy(10 * HOST_NS_PER_MS);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief  交换一个字节
+ * @param  arg 未使用
+ * @param  mosi 主机输出
+ * @retval 器件输出
+ */
+static uint8_t w25q64_Swap(void * arg, uint8_t mosi)
+{
+    const uint8_t cID[3] = {0xEF, 0x40, 0x17};
+    uint32_t index = gW25q64.count++;
+    uint8_t busy = w25q64_Status() & W25Q64_SR_WIP;
+
+    if (index == 0) {
+        gW25q64.command = mosi;
+        if (busy == 0 && mosi == 0x06) {
+            gW25q64.status |= W25Q64_SR_WEL;
+        } else if (busy == 0 && mosi == 0x04) {
+            gW25q64.status &= ~W25Q64_SR_WEL;
+        }
+        return 0xFF;
+    }
+    switch (gW25q64.command) {
+        case 0x05: /* 读状态寄存器 */
+            return w25q64_Status();
+        case 0x9F: /* 读ID */
+            return (busy == 0 && index <= 3) ? (cID[index - 1]) : (0xFF);
+        case 0x03: /* 读 */
+            if (busy || index < 4) {
+                gW25q64.address = (gW25q64.address << 8) | mosi;
+                return 0xFF;
+            }
+            return gW25q64.memory[(gW25q64.address + index - 4) & (HOST_W25Q64_SIZE - 1)];
+        case 0x02: /* 页编程 地址在页内回绕 */
+            if (index < 4) {
+                gW25q64.address = (gW25q64.address << 8) | mosi;
+            } else if (busy == 0 && (gW25q64.status & W25Q64_SR_WEL)) {
+                gW25q64.memory[((gW25q64.address & ~(W25Q64_PAGE_SIZE - 1)) | ((gW25q64.address + index - 4) & (W25Q64_PAGE_SIZE - 1))) &
+                               (HOST_W25Q64_SIZE - 1)] &= mosi;
+            }
+            return 0xFF;
+        case 0x20: /* 扇区擦除 */
+            if (index < 4) {
+                gW25q64.address = (gW25q64.address << 8) | mosi;
+            }
+            return 0xFF;
+        default:
+            return 0xFF;
+    }
+}
+
+/**
+ * @brief  挂接到 SPI1
+ * @note   初始内容全 0xFF
+ * @param  None
+ * @retval None
+ */
+void host_W25q64_Attach(void)
+{
+    const sHost_Spi_Device cDevice = {w25q64_Swap, w25q64_Select, NULL};
+
+    memset(&gW25q64, 0, sizeof(gW25q64));
+    memset(gW25q64.memory, 0xFF, sizeof(gW25q64.memory));
+    host_Spi_Attach(SPI1, SPI1_NSS_GPIO_Port, SPI1_NSS_Pin, &cDevice);
+}
+
+/**
+ * @brief  存储内容
+ * @note   测试预置或检查内容
+ * @param  None
+ * @retval 存储区
+ */
+uint8_t * host_W25q64_Memory(void)
+{
+    return gW25q64.memory;
+}
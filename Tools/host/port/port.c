@@ -0,0 +1,435 @@
+/**
+ * @file    port.c
+ * @brief   FreeRTOS 主机移植层
+ *
+ * 参照 FreeRTOS POSIX 移植层 所有任务与中断运行在同一个主机线程中
+ *     任务      ucontext 上下文 主机栈独立分配 (映射在低 4G 固件存在指针与 uint32_t 互转)
+ *               FreeRTOS 任务栈仅在栈顶保存上下文编号 栈余量统计不反映主机上的实际用量
+ *     任务切换  portYIELD 置位切换请求 未屏蔽 (BASEPRI PRIMASK 中断上下文) 时立即切换 否则推迟到解除屏蔽 与 PendSV 一致
+ *     中断      虚拟时间推进时 由 Tools/host/board 在当前任务上下文中直接调用固件中断处理函数
+ *     系统节拍  板级模型按 SysTick 寄存器配置产生节拍中断 xPortSysTickHandler (映射为 SysTick_Handler)
+ *     空闲      空闲钩子推进虚拟时间到下一个事件 任务运行不消耗虚拟时间
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "host_board.h"
+
+/* Private define ------------------------------------------------------------*/
+#define portHOST_TASK_MAX 32                /* 任务数上限 */
+#define portHOST_STACK_SIZE (256 * 1024)    /* 主机栈大小 */
+#define portINITIAL_CRITICAL_NESTING 0xaaaaaaaa /* 调度器启动前 退出临界区不开中断 */
+
+#define portNVIC_SYSTICK_CLK_BIT (1UL << 2UL)
+#define portNVIC_SYSTICK_INT_BIT (1UL << 1UL)
+#define portNVIC_SYSTICK_ENABLE_BIT (1UL << 0UL)
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    ucontext_t context;    /* 主机上下文 */
+    TaskFunction_t pxCode; /* 任务函数 */
+    void * pvParameters;   /* 任务参数 */
+    void * pvStack;        /* 主机栈 */
+    uint8_t ucUsed;        /* 占用标志 */
+} xHostTask;
+
+/* Private variables ---------------------------------------------------------*/
+static xHostTask xHostTasks[portHOST_TASK_MAX];
+static ucontext_t xHostMainContext;
+
+static UBaseType_t uxCriticalNesting = portINITIAL_CRITICAL_NESTING;
+static uint32_t ulBasepri = 0;                 /* BASEPRI */
+static uint32_t ulPrimask = 0;                 /* PRIMASK */
+static uint32_t ulIpsr = 0;                    /* 当前异常号 0 为线程模式 */
+static BaseType_t xSwitchPending = pdFALSE;    /* 任务切换请求 */
+static BaseType_t xSchedulerRunning = pdFALSE; /* 调度器已启动 */
+
+extern void * volatile pxCurrentTCB;
+
+/* Private function prototypes -----------------------------------------------*/
+static void prvTaskEntry(int index);
+
+/* Private user code ---------------------------------------------------------*/
+
+/**
+ * @brief  当前任务 主机上下文编号
+ * @note   TCB 首个成员为栈顶指针 栈顶保存上下文编号
+ * @param  None
+ * @retval 上下文编号
+ */
+static int prvCurrentIndex(void)
+{
+    return (int)(**(StackType_t **)pxCurrentTCB);
+}
+
+/**
+ * @brief  任务入口
+ * @param  index 上下文编号
+ * @retval None
+ */
+static void prvTaskEntry(int index)
+{
+    xHostTasks[index].pxCode(xHostTasks[index].pvParameters);
+    vPortAssert(__FILE__, __LINE__); /* 任务函数不应返回 */
+}
+
+/**
+ * @brief  执行任务切换
+ * @note   仅在未屏蔽时调用
+ * @param  None
+ * @retval None
+ */
+static void prvSwitchContext(void)
+{
+    int from, to;
+
+    from = prvCurrentIndex();
+    vTaskSwitchContext();
+    to = prvCurrentIndex();
+    if (from != to) {
+        swapcontext(&xHostTasks[from].context, &xHostTasks[to].context);
+    }
+}
+
+/**
+ * @brief  处理推迟的任务切换请求
+ * @param  None
+ * @retval None
+ */
+static void prvYieldIfPending(void)
+{
+    while (xSwitchPending && xSchedulerRunning && ulIpsr == 0 && ulBasepri == 0 && ulPrimask == 0) {
+        xSwitchPending = pdFALSE;
+        prvSwitchContext();
+    }
+}
+
+/**
+ * @brief  初始化任务栈
+ * @note   分配主机上下文 编号写入 FreeRTOS 栈顶
+ * @param  pxTopOfStack 栈顶
+ * @param  pxCode 任务函数
+ * @param  pvParameters 任务参数
+ * @retval 栈顶指针
+ */
+StackType_t * pxPortInitialiseStack(StackType_t * pxTopOfStack, TaskFunction_t pxCode, void * pvParameters)
+{
+    xHostTask * pxTask;
+    int index;
+
+    for (index = 0; index < portHOST_TASK_MAX; ++index) {
+        if (xHostTasks[index].ucUsed == 0) {
+            break;
+        }
+    }
+    if (index == portHOST_TASK_MAX) {
+        vPortAssert(__FILE__, __LINE__);
+    }
+    pxTask = &xHostTasks[index];
+    if (pxTask->pvStack == NULL) {
+        pxTask->pvStack = mmap(NULL, portHOST_STACK_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+        if (pxTask->pvStack == MAP_FAILED) {
+            vPortAssert(__FILE__, __LINE__);
+        }
+    }
+    pxTask->pxCode = pxCode;
+    pxTask->pvParameters = pvParameters;
+    pxTask->ucUsed = 1;
+
+    getcontext(&pxTask->context);
+    pxTask->context.uc_stack.ss_sp = pxTask->pvStack;
+    pxTask->context.uc_stack.ss_size = portHOST_STACK_SIZE;
+    pxTask->context.uc_link = NULL;
+    makecontext(&pxTask->context, (void (*)(void))prvTaskEntry, 1, index);
+
+    *pxTopOfStack = (StackType_t)index;
+    return pxTopOfStack;
+}
+
+/**
+ * @brief  释放任务主机上下文
+ * @note   主机栈保留 供后续任务复用
+ * @param  pxTCB 任务控制块
+ * @retval None
+ */
+void vPortCleanUpTCB(void * pxTCB)
+{
+    xHostTasks[**(StackType_t **)pxTCB].ucUsed = 0;
+}
+
+/**
+ * @brief  启动调度器
+ * @note   按 ARM_CM3 移植层配置 SysTick 寄存器 板级模型据此产生节拍中断
+ * @param  None
+ * @retval 不返回
+ */
+BaseType_t xPortStartScheduler(void)
+{
+    SysTick->LOAD = (configCPU_CLOCK_HZ / configTICK_RATE_HZ) - 1UL;
+    SysTick->VAL = 0;
+    SysTick->CTRL = portNVIC_SYSTICK_CLK_BIT | portNVIC_SYSTICK_INT_BIT | portNVIC_SYSTICK_ENABLE_BIT;
+
+    uxCriticalNesting = 0;
+    ulBasepri = 0;
+    ulPrimask = 0;
+    xSchedulerRunning = pdTRUE;
+    swapcontext(&xHostMainContext, &xHostTasks[prvCurrentIndex()].context);
+    return 0;
+}
+
+/**
+ * @brief  停止调度器
+ * @note   主机构建不支持
+ * @param  None
+ * @retval None
+ */
+void vPortEndScheduler(void)
+{
+    vPortAssert(__FILE__, __LINE__);
+}
+
+/**
+ * @brief  任务切换请求
+ * @param  None
+ * @retval None
+ */
+void vPortYield(void)
+{
+    xSwitchPending = pdTRUE;
+    prvYieldIfPending();
+}
+
+/**
+ * @brief  中断中的任务切换请求
+ * @note   中断退出时执行
+ * @param  None
+ * @retval None
+ */
+void vPortYieldFromISR(void)
+{
+    xSwitchPending = pdTRUE;
+    prvYieldIfPending();
+}
+
+/**
+ * @brief  进入临界区
+ * @param  None
+ * @retval None
+ */
+void vPortEnterCritical(void)
+{
+    vPortRaiseBASEPRI();
+    ++uxCriticalNesting;
+}
+
+/**
+ * @brief  退出临界区
+ * @param  None
+ * @retval None
+ */
+void vPortExitCritical(void)
+{
+    configASSERT(uxCriticalNesting);
+    --uxCriticalNesting;
+    if (uxCriticalNesting == 0) {
+        vPortSetBASEPRI(0);
+    }
+}
+
+/**
+ * @brief  屏蔽可调用系统接口的中断
+ * @param  None
+ * @retval None
+ */
+void vPortRaiseBASEPRI(void)
+{
+    ulBasepri = configMAX_SYSCALL_INTERRUPT_PRIORITY;
+}
+
+/**
+ * @brief  屏蔽可调用系统接口的中断
+ * @param  None
+ * @retval 原屏蔽值
+ */
+uint32_t ulPortRaiseBASEPRI(void)
+{
+    uint32_t ulOriginal = ulBasepri;
+
+    ulBasepri = configMAX_SYSCALL_INTERRUPT_PRIORITY;
+    return ulOriginal;
+}
+
+/**
+ * @brief  恢复中断屏蔽值
+ * @note   解除屏蔽后响应挂起的中断
+ * @param  ulNewMaskValue 屏蔽值
+ * @retval None
+ */
+void vPortSetBASEPRI(uint32_t ulNewMaskValue)
+{
+    ulBasepri = ulNewMaskValue;
+    host_Irq_Dispatch(); /* 屏蔽期间挂起的中断 */
+    prvYieldIfPending();
+}
+
+/**
+ * @brief  关中断 PRIMASK
+ * @param  None
+ * @retval None
+ */
+void vPortHostIrqDisable(void)
+{
+    ulPrimask = 1;
+}
+
+/**
+ * @brief  开中断 PRIMASK
+ * @param  None
+ * @retval None
+ */
+void vPortHostIrqEnable(void)
+{
+    ulPrimask = 0;
+    host_Irq_Dispatch(); /* 屏蔽期间挂起的中断 */
+    prvYieldIfPending();
+}
+
+/**
+ * @brief  PRIMASK
+ * @param  None
+ * @retval PRIMASK
+ */
+uint32_t ulPortHostGetPrimask(void)
+{
+    return ulPrimask;
+}
+
+/**
+ * @brief  BASEPRI
+ * @param  None
+ * @retval BASEPRI
+ */
+uint32_t ulPortHostGetBasepri(void)
+{
+    return ulBasepri;
+}
+
+/**
+ * @brief  IPSR
+ * @param  None
+ * @retval 当前异常号 0 为线程模式
+ */
+uint32_t ulPortHostGetIpsr(void)
+{
+    return ulIpsr;
+}
+
+/**
+ * @brief  是否在中断上下文中
+ * @param  None
+ * @retval pdTRUE 中断上下文
+ */
+BaseType_t xPortIsInsideInterrupt(void)
+{
+    return (ulIpsr != 0) ? (pdTRUE) : (pdFALSE);
+}
+
+/**
+ * @brief  进入中断上下文
+ * @param  ulException 异常号 中断号 + 16
+ * @retval 原异常号 退出时恢复
+ */
+uint32_t ulPortHostIsrEnter(uint32_t ulException)
+{
+    uint32_t ulOriginal = ulIpsr;
+
+    ulIpsr = ulException;
+    return ulOriginal;
+}
+
+/**
+ * @brief  退出中断上下文
+ * @note   回到线程模式时处理推迟的任务切换请求
+ * @param  ulOriginal 原异常号
+ * @retval None
+ */
+void vPortHostIsrExit(uint32_t ulOriginal)
+{
+    ulIpsr = ulOriginal;
+    prvYieldIfPending();
+}
+
+/**
+ * @brief  中断是否被屏蔽
+ * @param  lPriority 中断优先级 (高4位已移位) 负数为内核异常
+ * @retval 1 屏蔽 0 可响应
+ */
+uint8_t ucPortHostIrqMasked(int32_t lPriority)
+{
+    if (ulPrimask) {
+        return 1;
+    }
+    if (ulBasepri != 0 && lPriority >= 0 && (uint32_t)lPriority >= ulBasepri) {
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief  等待中断
+ * @note   推进虚拟时间到下一个事件
+ * @param  None
+ * @retval None
+ */
+void vPortHostWaitForInterrupt(void)
+{
+    host_Board_Step();
+}
+
+/**
+ * @brief  系统节拍中断
+ * @note   FreeRTOSConfig.h 映射为 SysTick_Handler 与固件一致
+ * @param  None
+ * @retval None
+ */
+void xPortSysTickHandler(void)
+{
+    uint32_t ulOriginal;
+
+    ulOriginal = ulPortRaiseBASEPRI();
+    if (xTaskIncrementTick() != pdFALSE) {
+        xSwitchPending = pdTRUE;
+    }
+    vPortSetBASEPRI(ulOriginal);
+}
+
+/**
+ * @brief  空闲钩子
+ * @note   推进虚拟时间到下一个事件 事件中的中断唤醒任务后 中断退出时切换
+ * @param  None
+ * @retval None
+ */
+void vApplicationIdleHook(void)
+{
+    host_Board_Step();
+}
+
+/**
+ * @brief  断言失败
+ * @param  file 文件
+ * @param  line 行号
+ * @retval None
+ */
+void vPortAssert(const char * file, int line)
+{
+    fprintf(stderr, "assert failed %s:%d\n", file, line);
+    fflush(stdout);
+    abort();
+}
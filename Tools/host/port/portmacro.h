@@ -0,0 +1,91 @@
+/**
+ * @file    portmacro.h
+ * @brief   FreeRTOS 主机移植层 宏定义
+ *
+ * 参照 FreeRTOS POSIX 移植层 所有任务运行在同一个主机线程中 以 ucontext 切换 不使用信号与多线程
+ * 类型宽度与 ARM_CM3 移植层一致 (StackType_t TickType_t 32位) 固件中的位宽假设保持不变
+ * BASEPRI/PRIMASK/中断上下文 由移植层记录 屏蔽期间 任务切换请求推迟到解除屏蔽时执行 与 PendSV 行为一致
+ * 无节拍空闲 不定义 portSUPPRESS_TICKS_AND_SLEEP 空闲钩子逐个节拍推进虚拟时间
+ */
+
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* Type definitions ----------------------------------------------------------*/
+#define portCHAR char
+#define portFLOAT float
+#define portDOUBLE double
+#define portLONG long
+#define portSHORT short
+#define portSTACK_TYPE uint32_t
+#define portBASE_TYPE long
+
+typedef portSTACK_TYPE StackType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#if (configUSE_16_BIT_TICKS == 1)
+typedef uint16_t TickType_t;
+#define portMAX_DELAY (TickType_t)0xffff
+#else
+typedef uint32_t TickType_t;
+#define portMAX_DELAY (TickType_t)0xffffffffUL
+#define portTICK_TYPE_IS_ATOMIC 1
+#endif
+
+/* Architecture specifics ----------------------------------------------------*/
+#define portSTACK_GROWTH (-1)
+#define portTICK_PERIOD_MS ((TickType_t)1000 / configTICK_RATE_HZ)
+#define portBYTE_ALIGNMENT 8
+
+/* Scheduler utilities -------------------------------------------------------*/
+void vPortYield(void);
+void vPortYieldFromISR(void);
+
+#define portYIELD() vPortYield()
+#define portEND_SWITCHING_ISR(xSwitchRequired)                                                                                                                 \
+    if ((xSwitchRequired) != pdFALSE)                                                                                                                          \
+    vPortYieldFromISR()
+#define portYIELD_FROM_ISR(x) portEND_SWITCHING_ISR(x)
+
+/* Critical section management -----------------------------------------------*/
+void vPortEnterCritical(void);
+void vPortExitCritical(void);
+void vPortRaiseBASEPRI(void);
+uint32_t ulPortRaiseBASEPRI(void);
+void vPortSetBASEPRI(uint32_t ulNewMaskValue);
+
+#define portSET_INTERRUPT_MASK_FROM_ISR() ulPortRaiseBASEPRI()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR(x) vPortSetBASEPRI(x)
+#define portDISABLE_INTERRUPTS() vPortRaiseBASEPRI()
+#define portENABLE_INTERRUPTS() vPortSetBASEPRI(0)
+#define portENTER_CRITICAL() vPortEnterCritical()
+#define portEXIT_CRITICAL() vPortExitCritical()
+
+/* Task function macros ------------------------------------------------------*/
+#define portTASK_FUNCTION_PROTO(vFunction, pvParameters) void vFunction(void * pvParameters)
+#define portTASK_FUNCTION(vFunction, pvParameters) void vFunction(void * pvParameters)
+
+/* Task control block --------------------------------------------------------*/
+void vPortCleanUpTCB(void * pxTCB);
+#define portCLEAN_UP_TCB(pxTCB) vPortCleanUpTCB(pxTCB)
+
+#define portNOP()
+#define portINLINE __inline
+#ifndef portFORCE_INLINE
+#define portFORCE_INLINE inline __attribute__((always_inline))
+#endif
+
+BaseType_t xPortIsInsideInterrupt(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PORTMACRO_H */
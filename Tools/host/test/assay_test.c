@@ -0,0 +1,236 @@
+/**
+ * @file    assay_test.c
+ * @brief   主机构建 完整测试流程
+ *
+ * 固件 main 在主机上运行 托盘 扫码 白板 上加热体电机 扫码头 采样板 均为 Tools/host/model 模型
+ *     上位机收到版本信息帧后发送开始测量帧 (0x01) 收到首个扫码信息帧 (0xB2) 后发送测试项信息帧 (0x03)
+ *     固件完成 扫码 入仓 预先点灯 白板/PD 交替采样 转发采集数据帧 (0xB3) 后发出采样完成帧 (0xB6)
+ * 选项 -n 各通道点数 (默认 3) -m 测试方法 (默认 2 终点法) -w 波长 (默认 1 610nm 405nm 仅通道 1) -q 二维码内容 (默认无) -b 一维码内容
+ * 结果按行输出 JSON 采样完成且各通道点数齐全时通过 否则返回非零
+ *     温度无模型 温度不在范围内提示 (114 115) 照常记录
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "main.h"
+#include "protocol.h"
+#include "comm_data.h"
+#include "error.h"
+#include "host_model.h"
+
+/* Private define ------------------------------------------------------------*/
+#define ASSAY_TEST_CHANNELS 6
+#define ASSAY_TEST_ERRORS 16
+
+/* Private variables ---------------------------------------------------------*/
+static sHost_Peer gAssay_Test_Main;
+static uint8_t gAssay_Test_Points = 3;
+static uint8_t gAssay_Test_Method = eComm_Data_Sample_Assay_EndPoint;
+static uint8_t gAssay_Test_Wave = eComm_Data_Sample_Radiant_610;
+static uint64_t gAssay_Test_Start = 0;                                /* 开始测量 发出时刻 */
+static uint64_t gAssay_Test_Barcode = 0;                              /* 首个扫码信息帧 时刻 */
+static uint64_t gAssay_Test_First_Data = 0;                           /* 首个采集数据帧 时刻 */
+static uint8_t gAssay_Test_Barcodes = 0;                              /* 扫码信息帧数 */
+static uint8_t gAssay_Test_Channel_Points[ASSAY_TEST_CHANNELS] = {0}; /* 各通道已收到点数 */
+static uint32_t gAssay_Test_Data_Frames = 0;
+static uint16_t gAssay_Test_Errors[ASSAY_TEST_ERRORS];                /* 错误码 按收到顺序 */
+static uint8_t gAssay_Test_Error_Num = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+int firmware_main(void);
+
+/* Private user code ---------------------------------------------------------*/
+
+/**
+ * @brief  距开始测量时长
+ * @param  time 时刻 0 为未发生
+ * @retval 时长 mS 未发生为 0
+ */
+static double assay_Test_Elapsed_Ms(uint64_t time)
+{
+    return (time > gAssay_Test_Start) ? ((time - gAssay_Test_Start) / 1e6) : (0);
+}
+
+/**
+ * @brief  结束
+ * @param  pass 1 通过
+ * @param  reason 失败原因
+ * @retval None
+ */
+static void assay_Test_Finish(uint8_t pass, const char * reason)
+{
+    uint8_t i;
+
+    printf("{\"test\": \"assay\", \"pass\": %s, \"points\": %u, \"method\": %u, \"wave\": %u, \"barcode_ms\": %.3f, \"first_data_ms\": %.3f, "
+           "\"end_ms\": %.3f, \"barcodes\": %u, \"scans\": %u, \"data_frames\": %u, \"board_pulses\": %u, \"board_frames\": %u, \"tray\": %d, "
+           "\"white\": %d, \"heat\": %d, \"channels\": [",
+           pass ? "true" : "false", gAssay_Test_Points, gAssay_Test_Method, gAssay_Test_Wave, assay_Test_Elapsed_Ms(gAssay_Test_Barcode),
+           assay_Test_Elapsed_Ms(gAssay_Test_First_Data), assay_Test_Elapsed_Ms(host_Time_Now()), gAssay_Test_Barcodes, host_Se2707_Scans(),
+           gAssay_Test_Data_Frames, host_Sample_Board_Pulses(), host_Sample_Board_Data_Frames(), host_L6470_Position(1), host_Drv8824_Position(0),
+           host_Drv8824_Position(1));
+    for (i = 0; i < ASSAY_TEST_CHANNELS; ++i) {
+        printf("%s%u", (i > 0) ? ", " : "", gAssay_Test_Channel_Points[i]);
+    }
+    printf("], \"errors\": [");
+    for (i = 0; i < gAssay_Test_Error_Num; ++i) {
+        printf("%s%u", (i > 0) ? ", " : "", gAssay_Test_Errors[i]);
+    }
+    printf("], \"crc_errors\": %u, \"reason\": \"%s\"}\n", gAssay_Test_Main.crc_errors, reason);
+    host_Board_Exit(pass ? 0 : 1);
+}
+
+/**
+ * @brief  发送测试项信息帧
+ * @note   6 通道 方法 波长 点数 相同
+ * @param  None
+ * @retval None
+ */
+static void assay_Test_Send_Config(void)
+{
+    uint8_t conf[3 * ASSAY_TEST_CHANNELS];
+    uint8_t i;
+
+    for (i = 0; i < ASSAY_TEST_CHANNELS; ++i) {
+        conf[3 * i + 0] = gAssay_Test_Method;
+        conf[3 * i + 1] = gAssay_Test_Wave;
+        conf[3 * i + 2] = gAssay_Test_Points;
+    }
+    host_Peer_Send(&gAssay_Test_Main, eProtocolEmitPack_Client_CMD_CONFIG, conf, sizeof(conf));
+}
+
+/**
+ * @brief  采样完成 检查各通道点数
+ * @note   通道 2～6 没有 405nm 固件清除其配置
+ * @param  None
+ * @retval None
+ */
+static void assay_Test_Over(void)
+{
+    uint8_t i, expect;
+
+    for (i = 0; i < ASSAY_TEST_CHANNELS; ++i) {
+        expect = (i > 0 && gAssay_Test_Wave == eComm_Data_Sample_Radiant_405) ? (0) : (gAssay_Test_Points);
+        if (gAssay_Test_Channel_Points[i] != expect) {
+            assay_Test_Finish(0, "channel points incomplete");
+        }
+    }
+    assay_Test_Finish(1, "");
+}
+
+/**
+ * @brief  上位机 收到帧
+ * @param  arg 未使用
+ * @param  pFrame 帧
+ * @param  length 帧长度
+ * @retval None
+ */
+static void assay_Test_Main_Frame(void * arg, const uint8_t * pFrame, uint16_t length)
+{
+    uint16_t code;
+
+    switch (pFrame[5]) {
+        case eProtocolRespPack_Client_VER:
+            if (gAssay_Test_Start == 0) {
+                gAssay_Test_Start = host_Time_Now();
+                host_Peer_Send(&gAssay_Test_Main, eProtocolEmitPack_Client_CMD_START, NULL, 0);
+            }
+            break;
+        case eProtocolRespPack_Client_BARCODE:
+            if (gAssay_Test_Barcodes++ == 0) {
+                gAssay_Test_Barcode = host_Time_Now();
+                assay_Test_Send_Config();
+            }
+            break;
+        case eProtocolRespPack_Client_SAMP_DATA: /* 点数 通道 数据 */
+            if (gAssay_Test_First_Data == 0) {
+                gAssay_Test_First_Data = host_Time_Now();
+            }
+            ++gAssay_Test_Data_Frames;
+            if (pFrame[7] >= 1 && pFrame[7] <= ASSAY_TEST_CHANNELS) {
+                gAssay_Test_Channel_Points[pFrame[7] - 1] = pFrame[6];
+            }
+            break;
+        case eProtocolRespPack_Client_SAMP_OVER:
+            assay_Test_Over();
+            break;
+        case eProtocolRespPack_Client_ERR: /* 错误码 小端 */
+            code = pFrame[6] | (pFrame[7] << 8);
+            if (gAssay_Test_Error_Num < ASSAY_TEST_ERRORS) {
+                gAssay_Test_Errors[gAssay_Test_Error_Num++] = code;
+            }
+            if (code == eError_Barcode_Content_Empty) {
+                assay_Test_Finish(0, "barcode content empty");
+            } else if (code == eError_Comm_Data_Not_Conf) {
+                assay_Test_Finish(0, "sample board not configured");
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief  超时
+ * @param  arg 未使用
+ * @retval None
+ */
+static void assay_Test_Timeout(void * arg)
+{
+    if (gAssay_Test_Start == 0) {
+        assay_Test_Finish(0, "no version frame");
+    }
+    if (gAssay_Test_Barcodes == 0) {
+        assay_Test_Finish(0, "no barcode frame");
+    }
+    assay_Test_Finish(0, "sample over not received");
+}
+
+int main(int argc, char * argv[])
+{
+    const char * pQr = NULL;
+    const char * pBar = "1415190701";
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:m:w:q:b:")) != -1) {
+        switch (opt) {
+            case 'n':
+                gAssay_Test_Points = atoi(optarg);
+                break;
+            case 'm':
+                gAssay_Test_Method = atoi(optarg);
+                break;
+            case 'w':
+                gAssay_Test_Wave = atoi(optarg);
+                break;
+            case 'q':
+                pQr = optarg;
+                break;
+            case 'b':
+                pBar = optarg;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-n points] [-m method] [-w wave] [-q qr] [-b bar]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (gAssay_Test_Points == 0 || gAssay_Test_Points > 120 ||                                                             /* 点数 */
+        gAssay_Test_Method < eComm_Data_Sample_Assay_Continuous || gAssay_Test_Method > eComm_Data_Sample_Assay_Fixed || /* 方法 */
+        gAssay_Test_Wave < eComm_Data_Sample_Radiant_610 || gAssay_Test_Wave > eComm_Data_Sample_Radiant_405) {         /* 波长 */
+        fprintf(stderr, "points 1..120 method 1..3 wave 1..3\n");
+        return 2;
+    }
+
+    host_Board_Init();
+    host_Gpio_Input(CARD_IN_GPIO_Port, CARD_IN_Pin, 1); /* ID 卡未插入 */
+    host_W25q64_Attach();
+    host_L6470_Attach();
+    host_Drv8824_Attach();
+    host_Se2707_Attach(pQr, pBar);
+    host_Sample_Board_Attach();
+    host_Peer_Attach(&gAssay_Test_Main, USART1, PROTOCOL_DEVICE_ID_MAIN, assay_Test_Main_Frame, NULL);
+    host_Event_At((60 + 12 * (uint64_t)gAssay_Test_Points) * HOST_NS_PER_S, assay_Test_Timeout, NULL);
+    return firmware_main();
+}
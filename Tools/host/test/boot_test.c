@@ -0,0 +1,128 @@
+/**
+ * @file    boot_test.c
+ * @brief   主机构建 上电启动测试
+ *
+ * 固件 main 在主机上运行 (外设为 Tools/host/board 模型 SPI Flash 为 W25Q64 模型)
+ *     启动就绪后 版本信息帧 (0xB7) 由 USART1 (上位机) 与 UART5 (外接板) 发出
+ *     上位机发送状态查询帧 (0x07) 控制板回应 ACK 并回复 温度 版本 托盘状态 帧
+ * 结果按行输出 JSON 失败时返回非零
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+
+#include "main.h"
+#include "protocol.h"
+#include "host_model.h"
+
+/* Private define ------------------------------------------------------------*/
+#define BOOT_TEST_TIMEOUT (10 * HOST_NS_PER_S)
+
+/* Private variables ---------------------------------------------------------*/
+static sHost_Peer gBoot_Test_Main;
+static sHost_Peer gBoot_Test_Out;
+static uint64_t gBoot_Test_Ver_Main = 0;  /* 版本信息帧 时刻 */
+static uint64_t gBoot_Test_Ver_Out = 0;
+static uint64_t gBoot_Test_Query = 0;     /* 状态查询 发出时刻 */
+static uint8_t gBoot_Test_Query_Index = 0;
+static uint8_t gBoot_Test_Reply = 0;      /* 状态查询 已收到回复 位 0 ACK 1 温度 2 版本 3 托盘 */
+
+/* Private function prototypes -----------------------------------------------*/
+int firmware_main(void);
+
+/* Private user code ---------------------------------------------------------*/
+
+/**
+ * @brief  结束
+ * @param  pass 1 通过
+ * @param  reason 失败原因
+ * @retval None
+ */
+static void boot_Test_Finish(uint8_t pass, const char * reason)
+{
+    printf("{\"test\": \"boot\", \"pass\": %s, \"ver_main_ms\": %.3f, \"ver_out_ms\": %.3f, \"status_reply_ms\": %.3f, \"reply_mask\": %u, "
+           "\"crc_errors\": %u, \"reason\": \"%s\"}\n",
+           pass ? "true" : "false", gBoot_Test_Ver_Main / 1e6, gBoot_Test_Ver_Out / 1e6, (host_Time_Now() - gBoot_Test_Query) / 1e6, gBoot_Test_Reply,
+           gBoot_Test_Main.crc_errors + gBoot_Test_Out.crc_errors, reason);
+    host_Board_Exit(pass ? 0 : 1);
+}
+
+/**
+ * @brief  上位机 收到帧
+ * @param  arg 未使用
+ * @param  pFrame 帧
+ * @param  length 帧长度
+ * @retval None
+ */
+static void boot_Test_Main_Frame(void * arg, const uint8_t * pFrame, uint16_t length)
+{
+    switch (pFrame[5]) {
+        case eProtocolRespPack_Client_VER:
+            if (gBoot_Test_Ver_Main == 0) {
+                gBoot_Test_Ver_Main = host_Time_Now();
+                gBoot_Test_Query = host_Time_Now();
+                host_Peer_Send(&gBoot_Test_Main, eProtocolEmitPack_Client_CMD_STATUS, NULL, 0);
+                gBoot_Test_Query_Index = gBoot_Test_Main.index;
+            } else if (gBoot_Test_Query > 0) {
+                gBoot_Test_Reply |= 1 << 2;
+            }
+            break;
+        case eProtocolRespPack_Client_ACK:
+            if (gBoot_Test_Query > 0 && pFrame[6] == gBoot_Test_Query_Index) {
+                gBoot_Test_Reply |= 1 << 0;
+            }
+            break;
+        case eProtocolRespPack_Client_TMP:
+            if (gBoot_Test_Query > 0) {
+                gBoot_Test_Reply |= 1 << 1;
+            }
+            break;
+        case eProtocolRespPack_Client_DISH:
+            if (gBoot_Test_Query > 0) {
+                gBoot_Test_Reply |= 1 << 3;
+            }
+            break;
+        default:
+            break;
+    }
+    if (gBoot_Test_Reply == 0x0F && gBoot_Test_Ver_Out > 0) {
+        boot_Test_Finish(1, "");
+    }
+}
+
+/**
+ * @brief  外接板 收到帧
+ * @param  arg 未使用
+ * @param  pFrame 帧
+ * @param  length 帧长度
+ * @retval None
+ */
+static void boot_Test_Out_Frame(void * arg, const uint8_t * pFrame, uint16_t length)
+{
+    if (pFrame[5] == eProtocolRespPack_Client_VER && gBoot_Test_Ver_Out == 0) {
+        gBoot_Test_Ver_Out = host_Time_Now();
+    }
+}
+
+/**
+ * @brief  超时
+ * @param  arg 未使用
+ * @retval None
+ */
+static void boot_Test_Timeout(void * arg)
+{
+    if (gBoot_Test_Ver_Main == 0 || gBoot_Test_Ver_Out == 0) {
+        boot_Test_Finish(0, "no version frame");
+    }
+    boot_Test_Finish(0, "status query not answered");
+}
+
+int main(void)
+{
+    host_Board_Init();
+    host_W25q64_Attach();
+    host_Peer_Attach(&gBoot_Test_Main, USART1, PROTOCOL_DEVICE_ID_MAIN, boot_Test_Main_Frame, NULL);
+    host_Peer_Attach(&gBoot_Test_Out, UART5, PROTOCOL_DEVICE_ID_MAIN, boot_Test_Out_Frame, NULL);
+    host_Event_At(BOOT_TEST_TIMEOUT, boot_Test_Timeout, NULL);
+    return firmware_main();
+}
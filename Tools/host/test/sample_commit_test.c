@@ -0,0 +1,220 @@
+/**
+ * @file    sample_commit_test.c
+ * @brief   主机构建 采样数据记录 (comm_Data_Sample_Data_Commit) 边界测试
+ *
+ * 固件 main 在主机上运行 收到版本信息帧 (启动就绪 事件组已创建) 后直接调用 comm_Data_Sample_Data_Commit
+ *     数据帧格式与 protocol.c 一致 [69 AA 长度 帧号 设备ID B3 点数 通道 数据] 数据长度 = 帧长度 - 9
+ *     记录缓存 raw_datas 240 字节 u16 120 点 u32 60 点 混合类型 20 点 (每点补充校正值后 12 字节) 为上限
+ *     超出上限 (u32 61 点 混合 21 点 混合 24 点 未知长度 241 字节 等) 必须返回 ERROR 且本通道与相邻通道记录不变
+ *     未超出时 返回对应类型 记录内容与输入一致
+ * 结果按行输出 JSON 失败时返回非零
+ */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+
+#include "main.h"
+#include "protocol.h"
+#include "comm_data.h"
+#include "host_model.h"
+
+/* Private define ------------------------------------------------------------*/
+#define SAMPLE_COMMIT_TEST_TIMEOUT (10 * HOST_NS_PER_S)
+#define SAMPLE_COMMIT_TEST_CHANNEL 1  /* 被测通道 */
+#define SAMPLE_COMMIT_TEST_NEIGHBOR 2 /* 相邻通道 记录紧随被测通道 */
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    const char * name;
+    uint8_t num;     /* 点数 */
+    uint8_t length;  /* 数据长度 */
+    uint8_t replace; /* 0 不替换 1 替换 */
+    uint8_t expect;  /* eComm_Data_Sample_Data */
+} sSample_Commit_Test_Case;
+
+/* Private constants ---------------------------------------------------------*/
+static const sSample_Commit_Test_Case cSample_Commit_Test_Cases[] = {
+    {"u16 120 points", 120, 240, 1, eComm_Data_Sample_Data_U16},
+    {"u16 121 points", 121, 242, 1, eComm_Data_Sample_Data_ERROR},
+    {"u32 60 points", 60, 240, 1, eComm_Data_Sample_Data_U32},
+    {"u32 61 points", 61, 244, 1, eComm_Data_Sample_Data_ERROR},
+    {"u32 62 points", 62, 248, 1, eComm_Data_Sample_Data_ERROR},
+    {"mix 20 points", 20, 200, 1, eComm_Data_Sample_Data_MIX},
+    {"mix 21 points", 21, 210, 1, eComm_Data_Sample_Data_ERROR},
+    {"mix 24 points", 24, 240, 1, eComm_Data_Sample_Data_ERROR},
+    {"unknow 240 bytes", 7, 240, 1, eComm_Data_Sample_Data_UNKNOW},
+    {"unknow 241 bytes", 7, 241, 1, eComm_Data_Sample_Data_ERROR},
+    {"unknow 255 bytes", 0, 255, 1, eComm_Data_Sample_Data_ERROR},
+    {"u16 no replace", 3, 6, 0, eComm_Data_Sample_Data_ERROR},
+};
+
+/* Private variables ---------------------------------------------------------*/
+static sHost_Peer gSample_Commit_Test_Main;
+static uint8_t gSample_Commit_Test_Done = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+int firmware_main(void);
+
+/* Private user code ---------------------------------------------------------*/
+
+/**
+ * @brief  结束
+ * @param  pass 1 通过
+ * @param  cases 已执行用例数
+ * @param  reason 失败原因
+ * @retval None
+ */
+static void sample_Commit_Test_Finish(uint8_t pass, uint8_t cases, const char * reason)
+{
+    printf("{\"test\": \"sample_commit\", \"pass\": %s, \"cases\": %u, \"total\": %u, \"reason\": \"%s\"}\n", pass ? "true" : "false", cases,
+           (unsigned)ARRAY_LEN(cSample_Commit_Test_Cases), reason);
+    host_Board_Exit(pass ? 0 : 1);
+}
+
+/**
+ * @brief  构造数据帧
+ * @param  pFrame 输出 长度至少 8 + 256
+ * @param  channel 通道索引
+ * @param  num 点数
+ * @param  length 数据长度
+ * @retval None
+ */
+static void sample_Commit_Test_Build(uint8_t * pFrame, uint8_t channel, uint8_t num, uint8_t length)
+{
+    uint16_t i;
+
+    memset(pFrame, 0, 8 + 256);
+    pFrame[0] = 0x69;
+    pFrame[1] = 0xAA;
+    pFrame[2] = length + 5;
+    pFrame[4] = PROTOCOL_DEVICE_ID_SAMP;
+    pFrame[5] = eComm_Data_Inbound_CMD_DATA;
+    pFrame[6] = num;
+    pFrame[7] = channel;
+    for (i = 0; i < length; ++i) {
+        pFrame[8 + i] = (uint8_t)(i * 7 + num + channel);
+    }
+}
+
+/**
+ * @brief  检查已接受用例的记录内容
+ * @param  pCase 用例
+ * @param  pFrame 提交后的数据帧 混合类型时数据部分已改写为记录内容
+ * @param  pInput 提交前的数据部分
+ * @param  pRecord 读出记录 [点数 通道 数据]
+ * @param  record_length 读出长度
+ * @retval 0 一致 1 不一致
+ */
+static uint8_t sample_Commit_Test_Check_Record(sSample_Commit_Test_Case const * pCase, const uint8_t * pFrame, const uint8_t * pInput,
+                                               const uint8_t * pRecord, uint8_t record_length)
+{
+    uint8_t i;
+
+    if (pRecord[0] != pCase->num || pRecord[1] != SAMPLE_COMMIT_TEST_CHANNEL) {
+        return 1;
+    }
+    switch (pCase->expect) {
+        case eComm_Data_Sample_Data_U16:
+        case eComm_Data_Sample_Data_U32:
+            return record_length != pCase->length + 2 || memcmp(pRecord + 2, pInput, pCase->length) != 0;
+        case eComm_Data_Sample_Data_MIX: /* 每点 原始 10 字节 + 校正值 2 字节 */
+            if (record_length != pCase->num * 12 + 2 || memcmp(pRecord + 2, pFrame + 8, pCase->num * 12) != 0) {
+                return 1;
+            }
+            for (i = 0; i < pCase->num; ++i) {
+                if (memcmp(pRecord + 2 + 12 * i, pInput + 10 * i, 10) != 0) {
+                    return 1;
+                }
+            }
+            return 0;
+        default: /* 原封不动复制 读出长度按 1 字节每点 */
+            return record_length != pCase->num + 2 || memcmp(pRecord + 2, pInput, pCase->num) != 0;
+    }
+}
+
+/**
+ * @brief  执行全部用例
+ * @note   事件上下文 (相当于中断) 与固件调用环境一致
+ * @param  None
+ * @retval None
+ */
+static void sample_Commit_Test_Run(void)
+{
+    static uint8_t frame[8 + 256], input[256];
+    static uint8_t neighbor[256], neighbor_now[256], before[256], after[256];
+    static char reason[96];
+    uint8_t i, result, neighbor_length, length, before_length, after_length;
+    sSample_Commit_Test_Case const * pCase;
+
+    sample_Commit_Test_Build(frame, SAMPLE_COMMIT_TEST_NEIGHBOR, 5, 10); /* 相邻通道 u16 5 点 */
+    if (comm_Data_Sample_Data_Commit(SAMPLE_COMMIT_TEST_NEIGHBOR, frame, 10, 1) != eComm_Data_Sample_Data_U16) {
+        sample_Commit_Test_Finish(0, 0, "neighbor commit");
+    }
+    comm_Data_Sample_Data_Fetch(SAMPLE_COMMIT_TEST_NEIGHBOR, neighbor, &neighbor_length);
+    sample_Commit_Test_Build(frame, SAMPLE_COMMIT_TEST_CHANNEL, 3, 6); /* 被测通道 u16 3 点 */
+    comm_Data_Sample_Data_Commit(SAMPLE_COMMIT_TEST_CHANNEL, frame, 6, 1);
+
+    for (i = 0; i < ARRAY_LEN(cSample_Commit_Test_Cases); ++i) {
+        pCase = &cSample_Commit_Test_Cases[i];
+        comm_Data_Sample_Data_Fetch(SAMPLE_COMMIT_TEST_CHANNEL, before, &before_length);
+        sample_Commit_Test_Build(frame, SAMPLE_COMMIT_TEST_CHANNEL, pCase->num, pCase->length);
+        memcpy(input, frame + 8, pCase->length);
+        result = comm_Data_Sample_Data_Commit(SAMPLE_COMMIT_TEST_CHANNEL, frame, pCase->length, pCase->replace);
+        comm_Data_Sample_Data_Fetch(SAMPLE_COMMIT_TEST_CHANNEL, after, &after_length);
+        comm_Data_Sample_Data_Fetch(SAMPLE_COMMIT_TEST_NEIGHBOR, neighbor_now, &length);
+
+        if (result != pCase->expect) {
+            snprintf(reason, sizeof(reason), "%s: result %u expect %u", pCase->name, result, pCase->expect);
+            sample_Commit_Test_Finish(0, i, reason);
+        }
+        if (length != neighbor_length || memcmp(neighbor_now, neighbor, length) != 0) {
+            snprintf(reason, sizeof(reason), "%s: neighbor channel changed", pCase->name);
+            sample_Commit_Test_Finish(0, i, reason);
+        }
+        if (result == eComm_Data_Sample_Data_ERROR) {
+            if (after_length != before_length || memcmp(after, before, after_length) != 0) {
+                snprintf(reason, sizeof(reason), "%s: rejected frame changed record", pCase->name);
+                sample_Commit_Test_Finish(0, i, reason);
+            }
+        } else if (sample_Commit_Test_Check_Record(pCase, frame, input, after, after_length)) {
+            snprintf(reason, sizeof(reason), "%s: record mismatch", pCase->name);
+            sample_Commit_Test_Finish(0, i, reason);
+        }
+    }
+    sample_Commit_Test_Finish(1, i, "");
+}
+
+/**
+ * @brief  上位机 收到帧
+ * @param  arg 未使用
+ * @param  pFrame 帧
+ * @param  length 帧长度
+ * @retval None
+ */
+static void sample_Commit_Test_Main_Frame(void * arg, const uint8_t * pFrame, uint16_t length)
+{
+    if (pFrame[5] == eProtocolRespPack_Client_VER && gSample_Commit_Test_Done == 0) {
+        gSample_Commit_Test_Done = 1;
+        sample_Commit_Test_Run();
+    }
+}
+
+/**
+ * @brief  超时
+ * @param  arg 未使用
+ * @retval None
+ */
+static void sample_Commit_Test_Timeout(void * arg)
+{
+    sample_Commit_Test_Finish(0, 0, "no version frame");
+}
+
+int main(void)
+{
+    host_Board_Init();
+    host_W25q64_Attach();
+    host_Peer_Attach(&gSample_Commit_Test_Main, USART1, PROTOCOL_DEVICE_ID_MAIN, sample_Commit_Test_Main_Frame, NULL);
+    host_Event_At(SAMPLE_COMMIT_TEST_TIMEOUT, sample_Commit_Test_Timeout, NULL);
+    return firmware_main();
+}
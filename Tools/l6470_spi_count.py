@@ -0,0 +1,100 @@
+"""
+扫码电机 L6470 SPI访问计数 一次扫码流程 原有实现 与 影子寄存器 + 单次获取总线 对比
+
+扫码流程 原点 -> 二维码(6) -> 一维条码 5 4 3 2 1 -> 原点(0 复归)
+L6470 非菊花链 每字节单独片选 一次片选即一次SPI传输
+    原有  barcode_Motor_Calculate 获取/释放总线读取位置 运动前无总线保护 写 ACC DEC MAX_SPEED
+    现有  运动前获取总线 m_l6470_Set_Param 与影子寄存器相同时跳过写入 位置由内存读取
+状态轮询 dSPIN_Busy_SW 每5mS读取状态寄存器 兼作清除报警标志 两种实现相同
+
+python l6470_spi_count.py          # 计数对比
+python l6470_spi_count.py -v       # 打印各段运动明细
+"""
+
+import argparse
+
+from motor_schedule_sim import l6470_move_time
+
+POLL_PERIOD = 0.005  # barcode_Motor_Run 状态查询周期
+
+# eBarcodeIndex 32细分步
+SLOT_POS = {0: 0, 1: 3156, 2: 6312, 3: 9468, 4: 12624, 5: 15780, 6: 18680}
+ROUTE = (6, 5, 4, 3, 2, 1, 0)
+
+NORMAL = (120, 120, 50)  # ACC DEC MAX_SPEED
+FAST = (120 * 8 // 4, 120 * 8 // 4, 50 * 10 // 8)  # 两道之内加快运动速度
+
+BYTES_SET_PARAM = 3  # 命令 + 12位参数
+BYTES_MOVE = 4
+BYTES_GO_UNTIL = 4
+BYTES_STATUS = 3
+BYTES_HARD_STOP = 1
+BYTES_ABS_POS = 4
+
+
+def move_speed(src, dst):
+    step = abs(((SLOT_POS[dst] >> 5) << 3) - ((SLOT_POS[src] >> 5) << 3))
+    fast = dst != 0 and step <= ((SLOT_POS[1] - SLOT_POS[0]) >> 5) << 4
+    return step, fast
+
+
+def polls(step, speed):
+    return int(l6470_move_time(step / 8, speed[2], speed[0]) / POLL_PERIOD) + 1
+
+
+class Count:
+    def __init__(self):
+        self.spi = 0
+        self.acquire = 0
+        self.param = 0
+        self.skip = 0
+
+    def add(self, other):
+        for key in vars(self):
+            setattr(self, key, getattr(self, key) + getattr(other, key))
+
+
+def run(cached, verbose):
+    total, shadow, pos = Count(), None, 0
+    for dst in ROUTE:
+        step, fast = move_speed(pos, dst)
+        speed = FAST if fast else NORMAL
+        c = Count()
+        if not cached:
+            c.acquire += 1  # barcode_Motor_Calculate 读取位置
+            c.spi += BYTES_ABS_POS
+        c.acquire += 1  # 运动 barcode_Motor_Enter
+        for i, value in enumerate(speed if dst != 0 else NORMAL):
+            if cached and shadow is not None and shadow[i] == value:
+                c.skip += 1
+                continue
+            c.param += 1
+            c.spi += BYTES_SET_PARAM
+        shadow = speed if dst != 0 else NORMAL
+        c.spi += BYTES_GO_UNTIL if dst == 0 else BYTES_MOVE
+        n = polls(step, speed)
+        c.spi += n * BYTES_STATUS + BYTES_HARD_STOP + BYTES_ABS_POS + BYTES_STATUS  # 轮询 停止 读取位置 处理状态
+        if verbose:
+            print("  {} -> {} 步数 {:5d} {} 获取 {} 参数写入 {} 跳过 {} 轮询 {:3d} SPI {:4d}".format(
+                pos, dst, step, "快速" if fast else "常速", c.acquire, c.param, c.skip, n, c.spi))
+        total.add(c)
+        pos = dst
+    return total
+
+
+def main():
+    parser = argparse.ArgumentParser(description="扫码电机 L6470 SPI访问计数")
+    parser.add_argument("-v", "--verbose", action="store_true")
+    args = parser.parse_args()
+
+    for title, cached in (("原有", False), ("现有", True)):
+        if args.verbose:
+            print(title)
+        c = run(cached, args.verbose)
+        print("{} 获取总线 {:3d} 参数写入 {:3d} 跳过 {:3d} 参数字节 {:3d} SPI传输 {:5d}".format(
+            title, c.acquire, c.param, c.skip, c.param * BYTES_SET_PARAM, c.spi))
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
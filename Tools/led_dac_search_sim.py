@@ -0,0 +1,306 @@
+"""
+采样板LED电压校正 主机端仿真 原有步进搜索 与 区间割线/二分搜索 对比
+
+新搜索 从 Src/comm_data.c 抽取 comm_Data_LED_Voltage_Seed / comm_Data_LED_Search_Next / comm_Data_Check_LED
+以桩代替采样数据及存储任务 编译为动态库 通过 ctypes 调用
+原有搜索 为原 comm_Data_Check_LED 的 Python 移植 起始值固定为默认值
+
+LED/PD 模型 各波长 PD = 目标值 * ((dac - d0) / (dac_t - d0)) ^ gamma  通道增益差异 测量噪声 24位饱和
+    d0 gamma 由 comm_Data_Check_LED 注释中的实测数据估算 dac_t 为达到目标值的DAC值 在默认起始值附近随机
+    上次校正结果 = dac_t * (1 + 漂移) 作为新搜索的起始值
+每次测试耗时 设置电压 600mS (电压未变化时新搜索不设置) + 等待回应 300mS + 白板运动/采样/上送
+
+python led_dac_search_sim.py                    # 默认 1000 台
+python led_dac_search_sim.py --drift 0.1 -v     # 上次结果漂移10% 打印首台明细
+python led_dac_search_sim.py --no-seed          # 新搜索也从默认值开始
+"""
+
+import argparse
+import ctypes
+import os
+import random
+import re
+import subprocess
+import tempfile
+
+REPO = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+
+RADIANTS = {1: "610", 2: "550", 3: "405"}
+MODEL = {  # d0 相对 dac_t 比例 gamma 默认起始值附近 dac_t 范围
+    1: (0.07, 0.95, (110, 210)),
+    2: (0.11, 1.00, (550, 850)),
+    3: (0.10, 0.98, (30, 60)),
+}
+
+STUB_C = r"""
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+#define ARRAY_LEN(x) (sizeof(x) / sizeof((x)[0]))
+
+%(defines)s
+
+typedef enum {
+    eComm_Data_Sample_Radiant_610 = 1,
+    eComm_Data_Sample_Radiant_550 = 2,
+    eComm_Data_Sample_Radiant_405 = 3,
+} eComm_Data_Sample_Radiant;
+
+typedef struct {
+    uint8_t num;
+    uint8_t data_type;
+    uint8_t raw_datas[240];
+} sComm_Data_Sample;
+
+%(typedef)s
+
+sComm_Data_Sample gComm_Data_Samples[6];
+static sComm_Data_LED_Search gComm_Data_LED_Search;
+int16_t gComm_Data_LED_Voltage_Interval = 1;
+uint16_t stub_seed[4];
+
+void storge_Sample_LED_PD_Set(eComm_Data_Sample_Radiant radian, uint8_t idx, uint32_t pd_data, uint16_t dac) {}
+uint16_t storge_Sample_LED_DAC_Get(eComm_Data_Sample_Radiant radian) { return stub_seed[radian & 3]; }
+int16_t gComm_Data_LED_Voltage_Interval_Get(void) { return gComm_Data_LED_Voltage_Interval; }
+void gComm_Data_LED_Voltage_Interval_Set(int16_t interval) { gComm_Data_LED_Voltage_Interval = interval; }
+void gComm_Data_LED_Voltage_Points_Set(uint8_t points) {}
+
+void stub_set_sample(uint8_t idx, uint32_t value)
+{
+    gComm_Data_Samples[idx].data_type = 4;
+    gComm_Data_Samples[idx].num = value ? 1 : 0;
+    memcpy(gComm_Data_Samples[idx].raw_datas, &value, 4);
+}
+
+%(code)s
+"""
+
+
+def extract(text, name):
+    """按函数名抽取定义 大括号配对"""
+    m = re.search(r"^[^\n;]*\b%s\(([^;{]*)\)\s*\{" % re.escape(name), text, re.M)
+    if m is None:
+        raise SystemExit("{} not found".format(name))
+    depth, pos = 0, m.end() - 1
+    while True:
+        depth += {"{": 1, "}": -1}.get(text[pos], 0)
+        if depth == 0:
+            return text[m.start() : pos + 1]
+        pos += 1
+
+
+def build(tmp):
+    source = open(os.path.join(REPO, "Src", "comm_data.c"), encoding="utf-8").read()
+    header = open(os.path.join(REPO, "Inc", "comm_data.h"), encoding="utf-8").read()
+    defines = "\n".join(re.findall(r"^#define COMM_DATA_LED_\w+ .*$", header, re.M))
+    typedef = re.search(r"typedef struct \{[^}]*\} sComm_Data_LED_Search;", source).group(0)
+    code = "\n\n".join(extract(source, n) for n in ("comm_Data_LED_Voltage_Seed", "comm_Data_LED_Search_Next", "comm_Data_Check_LED"))
+    src, lib = os.path.join(tmp, "led_search.c"), os.path.join(tmp, "led_search.so")
+    with open(src, "w", encoding="utf-8") as f:
+        f.write(STUB_C.replace("%(defines)s", defines).replace("%(typedef)s", typedef).replace("%(code)s", code))
+    subprocess.check_call(["gcc", "-O2", "-shared", "-fPIC", "-Wall", "-fshort-enums", "-o", lib, src, "-lm"])
+    dll = ctypes.CDLL(lib)
+    dll.comm_Data_Check_LED.restype = ctypes.c_uint8
+    dll.comm_Data_LED_Voltage_Seed.restype = ctypes.c_uint16
+    consts = {k: int(v) for k, v in re.findall(r"^#define (COMM_DATA_LED_\w+) (\d+)", header, re.M)}
+    return dll, consts
+
+
+class Device:
+    """LED/PD 响应模型"""
+
+    def __init__(self, rng, radiant, noise, channels):
+        d0_ratio, gamma, (lo, hi) = MODEL[radiant]
+        self.rng = rng
+        self.dac_t = rng.uniform(lo, hi)
+        self.d0 = self.dac_t * d0_ratio
+        self.gamma = gamma
+        self.noise = noise
+        self.gains = [rng.gauss(1, 0.03) for _ in range(channels)]
+
+    def measure(self, dac):
+        x = max(0.0, (dac - self.d0) / (self.dac_t - self.d0))
+        return [min(0xFFFFFF, max(0, int(13000000 * x ** self.gamma * g * self.rng.gauss(1, self.noise)))) for g in self.gains]
+
+
+class Legacy:
+    """原 comm_Data_Check_LED 移植 含整数除法等细节"""
+
+    UNIT = {1: 4, 2: 16, 3: 2}
+
+    def __init__(self):
+        self.interval = 1
+        self.last_bias = -0x80000000
+        self.record = [[0, 0], [0, 0], [0, 0]]
+
+    def check(self, radiant, dac, idx, values):
+        bias, j, mx, temp = 0, 0, 0, 0
+        for v in values:
+            temp = v
+            if v == 0:
+                continue
+            j += 1
+            mx = max(mx, v)
+            bias += v - 13000000
+        if idx < 3:
+            self.record[idx % 3] = [dac, temp]
+        else:
+            self.record = self.record[1:] + [[dac, temp]]
+        if j == 0 or -20000 < bias < 20000:
+            self.interval = 0
+            self.last_bias = -0x80000000
+            return 0
+        bias = int(bias / j)
+        if mx >= 15000000:
+            sign = int(self.interval / 2)
+            if sign == 0:
+                self.interval = -1
+                self.last_bias = -0x80000000
+                return 0 if mx != 0xFFFFFF else 1
+            self.interval = -abs(sign)
+            bias = 0x7FFFFFFF
+            self.last_bias = bias
+            return 1
+        if idx == 0:
+            self.interval = (1 if bias < 0 else -1) * self.UNIT[radiant]
+            self.last_bias = bias
+            return 1
+        result = 1
+        if (bias < 0) != (self.last_bias < 0):
+            sign = int(-1 * self.interval / 2)
+            if -1.5 < sign < 1.5:
+                self.interval = -1
+                self.last_bias = -0x80000000
+                result = 0
+            else:
+                self.interval = sign
+        elif idx >= 2:
+            d_dac = self.record[2][0] - self.record[1][0]
+            d_adc = self.record[2][1] - self.record[1][1]
+            cal = float(int(d_adc / d_dac)) if d_dac != 0 else 0.0  # C 整数除法
+            if cal == 0:
+                cal = float("inf")  # 软件浮点除零 结果为无穷 步长为0
+            cal = (-1 * bias) / cal * 0.8
+            cal += 0.5 if cal > 0 else -0.5
+            if abs(cal) > 2:
+                self.interval = int(max(-200, min(200, cal)))
+            elif abs(cal) < 1:
+                self.interval = 0
+                self.last_bias = -0x80000000
+                return 0
+        self.last_bias = bias
+        return result
+
+
+def run_legacy(dev, radiant, init, args, trace=None):
+    algo = Legacy()
+    algo.interval = Legacy.UNIT[radiant]
+    dac, t, steps = init, 0.6, 0
+    for i in range(30):
+        steps += 1
+        t += 0.3 + args.sample_time
+        values = dev.measure(dac)
+        stage = algo.check(radiant, dac, i, values)
+        if trace is not None:
+            trace.append((dac, sum(v for v in values if v) / max(1, sum(1 for v in values if v))))
+        dac += algo.interval
+        if dac > 1200 or dac < 0:
+            return steps, t, None
+        t += 0.6
+        if stage == 0:
+            return steps, t, dac
+    return steps, t, None
+
+
+def run_search(dll, consts, dev, radiant, seed, args, trace=None):
+    dll.stub_seed[radiant] = seed
+    dac = dll.comm_Data_LED_Voltage_Seed(radiant)
+    t, steps = 0.6, 0
+    interval = ctypes.c_int16.in_dll(dll, "gComm_Data_LED_Voltage_Interval")
+    for i in range(consts["COMM_DATA_LED_SEARCH_MAX"]):
+        steps += 1
+        t += 0.3 + args.sample_time
+        values = dev.measure(dac)
+        for ch in range(6):
+            dll.stub_set_sample(ch, values[ch] if ch < len(values) else 0)
+        stage = dll.comm_Data_Check_LED(radiant, dac, i)
+        if trace is not None:
+            trace.append((dac, sum(v for v in values if v) / max(1, sum(1 for v in values if v))))
+        if stage == 3:
+            return steps, t, None
+        if interval.value != 0:
+            dac += interval.value
+            t += 0.6
+        if stage == 0:
+            return steps, t, dac
+    return steps, t, None
+
+
+def final_error(dev, dac):
+    """最终电压下 无噪声均值相对偏差"""
+    if dac is None:
+        return None
+    noise, dev.noise = dev.noise, 0
+    values = dev.measure(dac)
+    dev.noise = noise
+    return sum(values) / len(values) / 13000000 - 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description="采样板LED电压校正搜索仿真")
+    parser.add_argument("--devices", type=int, default=1000, help="仿真台数")
+    parser.add_argument("--drift", type=float, default=0.03, help="上次校正结果相对漂移 标准差")
+    parser.add_argument("--noise", type=float, default=0.0005, help="PD测量相对噪声 标准差")
+    parser.add_argument("--sample-time", type=float, default=2.5, help="每次测试 白板运动/采样/上送耗时 秒")
+    parser.add_argument("--no-seed", action="store_true", help="新搜索不使用上次校正结果")
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("-v", "--verbose", action="store_true")
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    with tempfile.TemporaryDirectory() as tmp:
+        dll, consts = build(tmp)
+        dll.stub_seed = (ctypes.c_uint16 * 4).in_dll(dll, "stub_seed")
+        inits = {r: consts["COMM_DATA_LED_VOLTAGE_INIT_" + RADIANTS[r]] for r in RADIANTS}
+        total = {"legacy": 0.0, "search": 0.0}
+        for radiant, name in RADIANTS.items():
+            stats = {"legacy": [], "search": []}
+            fails = {"legacy": 0, "search": 0}
+            errors = {"legacy": [], "search": []}
+            for n in range(args.devices):
+                dev = Device(random.Random(rng.random()), radiant, args.noise, 1 if radiant == 3 else 6)
+                seed = 0 if args.no_seed else int(round(dev.dac_t * rng.gauss(1, args.drift)))
+                trace_l, trace_s = ([], []) if (args.verbose and n == 0) else (None, None)
+                for key, fun in (
+                    ("legacy", lambda: run_legacy(dev, radiant, inits[radiant], args, trace_l)),
+                    ("search", lambda: run_search(dll, consts, dev, radiant, seed, args, trace_s)),
+                ):
+                    steps, t, dac = fun()
+                    stats[key].append((steps, t))
+                    if dac is None:
+                        fails[key] += 1
+                    else:
+                        errors[key].append(abs(final_error(dev, dac)))
+                if trace_l is not None:
+                    print("{} dac_t {:.1f} 上次结果 {}".format(name, dev.dac_t, seed))
+                    print("  原有 " + " ".join("{}:{:.2f}M".format(d, v / 1e6) for d, v in trace_l))
+                    print("  新   " + " ".join("{}:{:.2f}M".format(d, v / 1e6) for d, v in trace_s))
+            for key, title in (("legacy", "原有"), ("search", "新  ")):
+                steps = [s for s, _ in stats[key]]
+                times = [t for _, t in stats[key]]
+                total[key] += sum(times) / len(times)
+                err = errors[key]
+                print(
+                    "{} {} 测试次数 平均 {:5.2f} 最大 {:2d}  耗时 平均 {:6.2f} s 最大 {:6.2f} s  失败 {:4d}  最终偏差 平均 {:.3%} 最大 {:.3%}".format(
+                        name, title, sum(steps) / len(steps), max(steps), sum(times) / len(times), max(times), fails[key],
+                        sum(err) / max(1, len(err)), max(err) if err else 0,
+                    )
+                )
+        print("三个波长合计 平均耗时 原有 {:.2f} s 新 {:.2f} s 缩短 {:.2f} s".format(total["legacy"], total["search"], total["legacy"] - total["search"]))
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
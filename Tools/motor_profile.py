@@ -0,0 +1,184 @@
+"""
+DRV8824 运动曲线 主机端计算/绘图工具
+
+与 Src/motor_profile.c 的ARR表生成算法保持一致 对比原有S型函数曲线(white_motor.c heat_motor.c)
+输出每条曲线的总运动时长 并绘制 每个burst周期 及 速度-时间 曲线
+
+python motor_profile.py                                # 默认参数 全部曲线
+python motor_profile.py --profile white_pd --type scurve --fmax 12000 --acc 600000 --jerk 6e7 --frame
+"""
+
+import argparse
+import math
+import struct
+from collections import namedtuple
+
+TIM_CLK = 108000000.0
+FREQ_FLOOR = TIM_CLK / 0xFFFF
+TYPE_SIGMOID, TYPE_TRAPEZOID, TYPE_SCURVE = 0, 1, 2
+TYPE_NAMES = {"sigmoid": TYPE_SIGMOID, "trapezoid": TYPE_TRAPEZOID, "scurve": TYPE_SCURVE}
+
+Axis = namedtuple("Axis", "index name unt sum sigmoid")
+Conf = namedtuple("Conf", "type dec freq_min freq_max acc jerk")
+
+
+def sigmoid_white_pd(idx):
+    return TIM_CLK / (3600.0 + (9200.0 - 3600.0) / (1 + math.exp(-0.4 * idx + 4.0)))
+
+
+def sigmoid_white_wh(idx):
+    if idx < 300 / 2:
+        freq = 2000.0 + (4400.0 - 2000.0) / (1 + math.exp(-0.1 * idx + 6))
+    else:
+        freq = 2000.0 + (4400.0 - 2000.0) / (1 + math.exp(0.1 * (idx - 300) - 6))
+    return TIM_CLK / freq
+
+
+def sigmoid_heat_up(idx):
+    fmin, fmax = TIM_CLK / 48000, TIM_CLK / 40000
+    return TIM_CLK / (fmin + (fmax - fmin) / (1 + math.exp(-0.3 * idx + 2)))
+
+
+def sigmoid_heat_down(idx):
+    fmin, fmax = TIM_CLK / 36000, TIM_CLK / 30000
+    return TIM_CLK / (fmin + (fmax - fmin) / (1 + math.exp(-0.4 * idx + 4)))
+
+
+AXES = {
+    "white_pd": Axis(0, "白板电机 PD方向", 8, 308, sigmoid_white_pd),
+    "white_wh": Axis(1, "白板电机 白板方向", 8, 300, sigmoid_white_wh),
+    "heat_up": Axis(2, "上加热体电机 向上", 60, 32, sigmoid_heat_up),
+    "heat_down": Axis(3, "上加热体电机 向下", 24, 72, sigmoid_heat_down),
+}
+
+DEFAULT_CONFS = {
+    "white_pd": Conf(TYPE_SCURVE, 1, 3600.0, 9200.0, 400000.0, 40000000.0),
+    "white_wh": Conf(TYPE_SCURVE, 1, 2000.0, 4400.0, 40000.0, 4000000.0),
+    "heat_up": Conf(TYPE_SCURVE, 0, TIM_CLK / 48000, TIM_CLK / 40000, 20000.0, 2000000.0),
+    "heat_down": Conf(TYPE_SCURVE, 1, TIM_CLK / 36000, TIM_CLK / 30000, 20000.0, 2000000.0),
+}
+
+
+def build_table(conf, axis):
+    """加速段ARR表 同 motor_Profile_Build"""
+    table = []
+    freq, acc = conf.freq_min, 0.0
+    for _ in range(axis.sum):
+        table.append(int(TIM_CLK / freq) & 0xFFFF)
+        for _ in range(axis.unt):
+            if freq >= conf.freq_max:
+                freq = conf.freq_max
+                break
+            if conf.type == TYPE_TRAPEZOID:
+                freq = math.sqrt(freq * freq + 2 * conf.acc)
+                continue
+            dt = 1 / freq
+            if acc * acc / (2 * conf.jerk) >= conf.freq_max - freq:
+                acc = max(acc - conf.jerk * dt, 0.0)
+            else:
+                acc = min(acc + conf.jerk * dt, conf.acc)
+            freq += acc * dt
+    return table
+
+
+def period_lookup(table, conf, cnt):
+    """同 motor_Profile_Period"""
+    total = len(table)
+    if cnt >= total:
+        return table[0] if conf.dec else table[-1]
+    if not conf.dec:
+        return table[cnt]
+    return max(table[cnt], table[total - 1 - cnt])
+
+
+def periods_of(conf, axis):
+    if conf.type == TYPE_SIGMOID:
+        return [int(axis.sigmoid(i)) for i in range(axis.sum)]
+    table = build_table(conf, axis)
+    return [period_lookup(table, conf, i) for i in range(axis.sum)]
+
+
+def duration_us(periods, axis):
+    return sum(axis.unt * p / (TIM_CLK / 1000000) for p in periods)
+
+
+def config_frame(axis, conf, pack_index=0x01):
+    """0xD1 设置帧 69 AA len ack 13 D1 idx type dec fmin fmax acc jerk crc8"""
+    payload = struct.pack("<BBBffff", axis.index, conf.type, conf.dec, conf.freq_min, conf.freq_max, conf.acc, conf.jerk)
+    body = struct.pack("BBBB", len(payload) + 3, pack_index, 0x13, 0xD1) + payload
+    crc = 0
+    for b in body[2:]:
+        crc ^= b
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0x8C if crc & 0x01 else crc >> 1
+    return b"\x69\xAA" + body + bytes((crc,))
+
+
+def report(name, conf):
+    axis = AXES[name]
+    legacy = periods_of(Conf(TYPE_SIGMOID, 0, 0, 0, 0, 0), axis)
+    current = periods_of(conf, axis)
+    t_legacy, t_current = duration_us(legacy, axis), duration_us(current, axis)
+    print(
+        "{:<20s} burst {:>3d} x {:>2d} 原有曲线 {:>9.1f} ms  新曲线 {:>9.1f} ms  节省 {:>+7.1f}%  最短周期 {} 最长周期 {}".format(
+            axis.name, axis.sum, axis.unt, t_legacy / 1000, t_current / 1000, 100 * (t_legacy - t_current) / t_legacy, min(current), max(current)
+        )
+    )
+    return axis, legacy, current
+
+
+def plot(results):
+    try:
+        import matplotlib.pyplot as plt
+    except ImportError:
+        print("未安装 matplotlib 跳过绘图")
+        return
+    fig, axes = plt.subplots(len(results), 2, figsize=(12, 3 * len(results)), squeeze=False)
+    for row, (axis, legacy, current) in enumerate(results):
+        for label, periods in (("sigmoid", legacy), ("profile", current)):
+            axes[row][0].plot(periods, label=label)
+            ts, vs, t = [], [], 0.0
+            for p in periods:
+                ts.append(t * 1000)
+                vs.append(TIM_CLK / p)
+                t += axis.unt * p / TIM_CLK
+            axes[row][1].step(ts, vs, where="post", label=label)
+        axes[row][0].set_title("{} ARR / burst".format(axis.name))
+        axes[row][1].set_title("{} step/s - ms".format(axis.name))
+        axes[row][0].legend()
+        axes[row][1].legend()
+    fig.tight_layout()
+    plt.show()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="DRV8824 运动曲线计算")
+    parser.add_argument("--profile", choices=AXES.keys(), help="仅计算单条曲线")
+    parser.add_argument("--type", choices=TYPE_NAMES.keys())
+    parser.add_argument("--dec", type=int, choices=(0, 1))
+    parser.add_argument("--fmin", type=float)
+    parser.add_argument("--fmax", type=float)
+    parser.add_argument("--acc", type=float)
+    parser.add_argument("--jerk", type=float)
+    parser.add_argument("--frame", action="store_true", help="输出调试串口 0xD1 设置帧")
+    parser.add_argument("--no-plot", action="store_true")
+    args = parser.parse_args()
+
+    results = []
+    for name in [args.profile] if args.profile else AXES.keys():
+        conf = DEFAULT_CONFS[name]._asdict()
+        for key, value in (("type", TYPE_NAMES.get(args.type)), ("dec", args.dec), ("freq_min", args.fmin), ("freq_max", args.fmax), ("acc", args.acc), ("jerk", args.jerk)):
+            if value is not None:
+                conf[key] = value
+        conf = Conf(**conf)
+        if conf.type != TYPE_SIGMOID and not (FREQ_FLOOR <= conf.freq_min <= conf.freq_max):
+            parser.error("{} 频率范围非法 最低 {:.1f}".format(name, FREQ_FLOOR))
+        results.append(report(name, conf))
+        if args.frame:
+            print("  " + " ".join("{:02X}".format(b) for b in config_frame(AXES[name], conf)))
+    if not args.no_plot:
+        plot(results)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,463 @@
+"""
+电机运动调度 主机端时序仿真
+
+按 Src/motor_sched.c 的资源声明及联锁规则 仿真采样前扫码入仓(motor_Sample_Barcode_Scan)
+与采样结束出仓(motor_Sample_Owari)的运动序列 对比原有串行流程的耗时 并检查全过程联锁是否被违反
+
+资源 PWM    TIM1 DMA 白板电机 上加热体电机共用
+     SPI    L6470 SPI总线 托盘电机 扫码电机共用
+     HEATER 上加热体位置 托盘运动期间不可改变
+     TRAY   托盘位置 上加热体砸下期间不可改变
+联锁 托盘运动时上加热体必须抬起 上加热体砸下时托盘必须在原点
+
+python motor_schedule_sim.py                  # 默认时间模型
+python motor_schedule_sim.py --qr 1.2 -v      # 扫码耗时1.2秒 打印时序
+python motor_schedule_sim.py --no-interlock   # 不获取资源直接并行 验证联锁检查有效
+python motor_schedule_sim.py --split-pwm      # 假设白板电机与上加热体电机各自独立PWM 评估收益
+
+两路 DRV8824 共用 STEP 管脚 PE9(TIM1_CH1) 仅以使能管脚区分 现有硬件无法同时运动
+--split-pwm 用于评估改板(第二路STEP接独立定时器)对 采样(motor_Sample_Deal) 入仓/出仓 等流程的收益
+"""
+
+import argparse
+import heapq
+import itertools
+import random
+
+from motor_profile import AXES, Conf, TYPE_SIGMOID, duration_us, periods_of
+
+RES_PWM, RES_SPI, RES_HEATER, RES_TRAY = 1 << 0, 1 << 1, 1 << 2, 1 << 3
+RES_PWM_WHITE = 1 << 4  # 假设 白板电机独立PWM
+RES_ALL = RES_PWM | RES_SPI | RES_HEATER | RES_TRAY | RES_PWM_WHITE
+
+# 与 cMotor_Sched_Jobs 一致
+JOB_RES = {
+    "tray": RES_SPI | RES_HEATER | RES_TRAY,
+    "white_pd": RES_PWM,
+    "white_wh": RES_PWM,
+    "white_cycle": RES_PWM,
+    "heat_up": RES_PWM | RES_HEATER,
+    "heat_down": RES_PWM | RES_HEATER | RES_TRAY,
+}
+
+# 假设 白板电机与上加热体电机各自使用独立PWM
+JOB_RES_SPLIT = dict(JOB_RES, white_pd=RES_PWM_WHITE, white_wh=RES_PWM_WHITE, white_cycle=RES_PWM_WHITE)
+
+# L6470 寄存器换算 tick 250ns
+L6470_SPEED_UNIT = 2 ** -18 / 250e-9
+L6470_ACC_UNIT = 2 ** -40 / (250e-9 ** 2)
+
+
+def l6470_move_time(full_steps, max_speed_reg, acc_reg):
+    """L6470 梯形速度曲线运动时长 秒"""
+    vmax, acc = max_speed_reg * L6470_SPEED_UNIT, acc_reg * L6470_ACC_UNIT
+    if full_steps * acc <= vmax * vmax:  # 三角形
+        return 2 * (full_steps / acc) ** 0.5
+    return vmax / acc + full_steps / vmax
+
+
+def drv8824_time(name):
+    axis = AXES[name]
+    return duration_us(periods_of(Conf(TYPE_SIGMOID, 0, 0, 0, 0, 0), axis), axis) / 1e6
+
+
+def build_timing(args):
+    tray = lambda steps: l6470_move_time(steps / 32, 65, 138) + args.tray_overhead  # Index_1 32细分位置
+    scan = lambda steps: l6470_move_time(steps / 32, 50, 120) + args.scan_overhead  # Index_0
+    return {
+        "tray_scan": tray(26400 - 4400),
+        "tray_in": tray(4400),
+        "tray_out": tray(26400),
+        "scan_origin": scan(18680),
+        "scan_qr_pos": scan(18680),
+        "qr": args.qr,
+        "white_pd": drv8824_time("white_pd"),
+        "white_wh": drv8824_time("white_wh"),
+        "heat_up": drv8824_time("heat_up"),
+        "heat_down": drv8824_time("heat_down"),
+        "sample": args.sample_point,
+    }
+
+
+class Sim:
+    """最小离散事件仿真 进程为生成器 产出 (命令, 参数)"""
+
+    def __init__(self, timing, interlock=True, verbose=False, split_pwm=False):
+        self.timing = timing
+        self.split_pwm = split_pwm
+        self.job_res = JOB_RES_SPLIT if split_pwm else JOB_RES
+        self.interlock = interlock
+        self.verbose = verbose
+        self.now = 0.0
+        self.free = RES_ALL
+        self.heap = []
+        self.seq = itertools.count()
+        self.blocked = []  # (mask, clear, proc)
+        self.queue = []
+        self.executor = None
+        self.state = {"heater": "up", "tray": "out", "white": "wh", "scan": "qr"}
+        self.moving = set()
+        self.violations = []
+        self.trace = []
+
+    # 进程管理
+    def spawn(self, gen, delay=0.0):
+        heapq.heappush(self.heap, (self.now + delay, next(self.seq), gen, None))
+
+    def run(self):
+        while self.heap:
+            self.now, _, gen, value = heapq.heappop(self.heap)
+            self.step(gen, value)
+        return self.now
+
+    def step(self, gen, value):
+        try:
+            cmd, arg = gen.send(value)
+        except StopIteration:
+            return
+        if cmd == "delay":
+            heapq.heappush(self.heap, (self.now + arg, next(self.seq), gen, None))
+        elif cmd in ("claim", "idle"):
+            mask = arg if self.interlock else 0
+            if self.free & mask == mask:
+                if cmd == "claim":
+                    self.free &= ~mask
+                self.spawn_value(gen)
+            else:
+                self.blocked.append((mask, cmd == "claim", gen))
+        elif cmd == "release":
+            self.free |= arg if self.interlock else 0
+            self.wake()
+            self.spawn_value(gen)
+        elif cmd == "put":
+            self.queue.append(arg)
+            if self.executor is not None:
+                gen_exec, self.executor = self.executor, None
+                self.spawn_value(gen_exec, self.queue.pop(0))
+            self.spawn_value(gen)
+        elif cmd == "get":
+            if self.queue:
+                self.spawn_value(gen, self.queue.pop(0))
+            else:
+                self.executor = gen
+
+    def spawn_value(self, gen, value=None):
+        heapq.heappush(self.heap, (self.now, next(self.seq), gen, value))
+
+    def wake(self):
+        pending, self.blocked = self.blocked, []
+        for mask, clear, gen in pending:
+            if self.free & mask == mask:
+                if clear:
+                    self.free &= ~mask
+                self.spawn_value(gen)
+            else:
+                self.blocked.append((mask, clear, gen))
+
+    # 运动模型
+    def motion(self, axis, name, target):
+        self.log("{:<6s} {:<12s} start".format(axis, name))
+        self.moving.add(axis)
+        self.state[axis] = "moving_" + target
+        self.check(axis)
+        yield ("delay", self.timing[name])
+        self.moving.discard(axis)
+        self.state[axis] = target
+        self.check(axis)
+        self.log("{:<6s} {:<12s} done".format(axis, name))
+
+    def check(self, axis):
+        """物理联锁 及 共用驱动资源检查"""
+        rules = (
+            ("tray" in self.moving and self.state["heater"] != "up", "托盘运动时上加热体未抬起"),
+            (self.state["heater"] in ("moving_down", "down") and self.state["tray"] != "in", "上加热体砸下时托盘不在原点"),
+            ({"white", "heater"} <= self.moving and not self.split_pwm, "白板电机与上加热体电机同时使用PWM"),
+            ({"tray", "scan"} <= self.moving, "托盘电机与扫码电机同时使用SPI"),
+        )
+        for broken, text in rules:
+            if broken and (text, self.now) not in self.violations:
+                self.violations.append((text, self.now))
+                self.log("!!! " + text)
+
+    def log(self, text):
+        self.trace.append((self.now, text))
+        if self.verbose:
+            print("{:8.3f}  {}".format(self.now, text))
+
+
+# 任务侧原语 与 motor_sched.c 对应
+def job_body(sim, job):
+    if job == "white_pd":
+        yield from sim.motion("white", "white_pd", "pd")
+    elif job == "white_wh":
+        yield from sim.motion("white", "white_wh", "wh")
+    elif job == "white_cycle":
+        yield from sim.motion("white", "white_pd", "pd")
+        yield from sim.motion("white", "white_wh", "wh")
+    elif job == "heat_up":
+        if sim.state["heater"] != "up":
+            yield from sim.motion("heater", "heat_up", "up")
+    elif job == "heat_down":
+        if sim.interlock and sim.state["tray"] != "in":
+            sim.log("interlock refused heat_down")
+            return
+        yield from sim.motion("heater", "heat_down", "down")
+
+
+def sched_run(sim, job):
+    yield ("claim", sim.job_res[job])
+    yield from job_body(sim, job)
+    yield ("release", sim.job_res[job])
+
+
+def sched_start(sim, job):
+    if not sim.interlock:  # 无调度 各运动直接并行
+        sim.spawn(job_body(sim, job))
+        return
+    yield ("claim", sim.job_res[job])
+    yield ("put", job)
+
+
+def sched_wait(sim, mask=RES_ALL):
+    yield ("idle", mask)
+
+
+def sched_executor(sim):
+    while True:
+        job = yield ("get", None)
+        yield from job_body(sim, job)
+        yield ("release", sim.job_res[job])
+
+
+def tray_move(sim, name, target):
+    """motor_Tray_Move_By_Index 先抬起上加热体 再获取托盘资源"""
+    if sim.state["heater"] != "up":
+        yield from sched_run(sim, "heat_up")
+    yield ("claim", sim.job_res["tray"])
+    yield from sim.motion("tray", name, target)
+    yield ("release", sim.job_res["tray"])
+
+
+def scan_move(sim, name, target):
+    yield from sim.motion("scan", name, target)
+
+
+# 运动序列
+def legacy_barcode_scan(sim):
+    """原有流程 仅白板电机由杂项任务并行"""
+    yield from tray_move(sim, "tray_scan", "scan")
+    yield from scan_move(sim, "qr", "qr")
+    yield from tray_move(sim, "tray_in", "in")
+    yield from job_body(sim, "heat_down")
+    sim.spawn(job_body(sim, "white_cycle"))  # Miscellaneous_Task_Notify(0)
+    yield from scan_move(sim, "scan_origin", "origin")
+
+
+def legacy_owari(sim):
+    yield from job_body(sim, "white_wh")
+    yield from tray_move(sim, "tray_out", "out")
+    yield from scan_move(sim, "scan_origin", "origin")
+    yield from scan_move(sim, "scan_qr_pos", "qr")
+
+
+def sched_barcode_scan(sim):
+    """motor_Sample_Barcode_Scan"""
+    yield from tray_move(sim, "tray_scan", "scan")
+    yield from sched_start(sim, "white_cycle")
+    yield from scan_move(sim, "qr", "qr")
+    yield from tray_move(sim, "tray_in", "in")
+    yield from sched_start(sim, "heat_down")
+    yield from scan_move(sim, "scan_origin", "origin")
+    yield from sched_wait(sim)
+
+
+def sched_owari(sim):
+    """motor_Sample_Owari"""
+    yield from sched_wait(sim)
+    yield from tray_move(sim, "tray_out", "out")
+    yield from sched_run(sim, "heat_up")
+    yield from sched_start(sim, "white_wh")
+    yield from scan_move(sim, "scan_origin", "origin")
+    yield from scan_move(sim, "scan_qr_pos", "qr")
+    yield from sched_wait(sim)
+
+
+def sched_sample_deal(sim):
+    """motor_Sample_Deal 每轮采集完成后白板电机在PD/白板位置间切换 上加热体保持砸下"""
+    for i in range(sim.rounds):
+        yield ("delay", sim.timing["sample"])
+        yield from sched_run(sim, "white_pd" if i % 2 == 0 else "white_wh")
+    yield ("delay", sim.timing["sample"])
+
+
+def sched_fun_in(sim):
+    """eMotor_Fun_In"""
+    yield from sched_run(sim, "heat_up")
+    yield from tray_move(sim, "tray_in", "in")
+    yield from sched_run(sim, "heat_down")
+
+
+def sched_fun_out(sim):
+    """eMotor_Fun_Out"""
+    yield from tray_move(sim, "tray_out", "out")
+
+
+def split_barcode_scan(sim):
+    """独立PWM 白板电机不必等待托盘到达扫码位置"""
+    yield from sched_start(sim, "white_cycle")
+    yield from tray_move(sim, "tray_scan", "scan")
+    yield from scan_move(sim, "qr", "qr")
+    yield from tray_move(sim, "tray_in", "in")
+    yield from sched_start(sim, "heat_down")
+    yield from scan_move(sim, "scan_origin", "origin")
+    yield from sched_wait(sim)
+
+
+def split_owari(sim):
+    """独立PWM 白板电机与上加热体抬起同时运动"""
+    yield from sched_wait(sim)
+    yield from sched_start(sim, "white_wh")
+    yield from tray_move(sim, "tray_out", "out")
+    yield from scan_move(sim, "scan_origin", "origin")
+    yield from scan_move(sim, "scan_qr_pos", "qr")
+    yield from sched_wait(sim)
+
+
+def simulate(timing, sequence, init, interlock=True, verbose=False, with_executor=True, split_pwm=False, rounds=0):
+    sim = Sim(timing, interlock, verbose, split_pwm)
+    sim.rounds = rounds
+    sim.state.update(init)
+    if with_executor:
+        sim.spawn(sched_executor(sim))
+    sim.spawn(sequence(sim))
+    return sim.run(), sim
+
+
+CASES = (
+    ("扫码入仓", legacy_barcode_scan, sched_barcode_scan, {"heater": "up", "tray": "out", "white": "wh", "scan": "qr"}),
+    ("采样结束出仓", legacy_owari, sched_owari, {"heater": "down", "tray": "in", "white": "pd", "scan": "origin"}),
+)
+
+
+def run_cases(timing, interlock=True, verbose=False):
+    """返回 [(标题, 原有耗时, 调度耗时, 问题列表)]"""
+    results = []
+    for title, legacy, sched, init in CASES:
+        if verbose:
+            print("--- {} 原有流程".format(title))
+        t_legacy, sim_legacy = simulate(timing, legacy, init, True, verbose, with_executor=False)
+        if verbose:
+            print("--- {} 调度流程".format(title))
+        t_sched, sim_sched = simulate(timing, sched, init, interlock, verbose)
+        problems = ["{:8.3f} s {}".format(when, text) for sim in (sim_legacy, sim_sched) for text, when in sim.violations]
+        if sim_sched.state != sim_legacy.state:
+            problems.append("终止状态不一致 原有 {} 调度 {}".format(sim_legacy.state, sim_sched.state))
+        results.append((title, t_legacy, t_sched, problems))
+    return results
+
+
+SPLIT_CASES = (
+    ("扫码入仓", sched_barcode_scan, split_barcode_scan, {"heater": "up", "tray": "out", "white": "wh", "scan": "qr"}),
+    ("采样结束出仓", sched_owari, split_owari, {"heater": "down", "tray": "in", "white": "pd", "scan": "origin"}),
+    ("采样", sched_sample_deal, sched_sample_deal, {"heater": "down", "tray": "in", "white": "wh", "scan": "origin"}),
+    ("入仓", sched_fun_in, sched_fun_in, {"heater": "up", "tray": "out", "white": "wh", "scan": "origin"}),
+    ("出仓", sched_fun_out, sched_fun_out, {"heater": "down", "tray": "in", "white": "wh", "scan": "origin"}),
+)
+
+
+def run_split_cases(timing, rounds, verbose=False):
+    """返回 [(标题, 共用PWM耗时, 独立PWM耗时, 问题列表)]"""
+    results = []
+    for title, shared, split, init in SPLIT_CASES:
+        if verbose:
+            print("--- {} 共用PWM".format(title))
+        t_shared, sim_shared = simulate(timing, shared, init, True, verbose, rounds=rounds)
+        if verbose:
+            print("--- {} 独立PWM".format(title))
+        t_split, sim_split = simulate(timing, split, init, True, verbose, split_pwm=True, rounds=rounds)
+        problems = ["{:8.3f} s {}".format(when, text) for sim in (sim_shared, sim_split) for text, when in sim.violations]
+        if sim_split.state != sim_shared.state:
+            problems.append("终止状态不一致 共用 {} 独立 {}".format(sim_shared.state, sim_split.state))
+        results.append((title, t_shared, t_split, problems))
+    return results
+
+
+def split_main(args, timing):
+    """评估白板电机与上加热体电机独立PWM的收益"""
+    rounds = args.sample_points * 2
+    failed = 0
+    for title, t_shared, t_split, problems in run_split_cases(timing, rounds, args.verbose):
+        print("{:<8s} 共用PWM {:7.3f} s  独立PWM {:7.3f} s  缩短 {:6.3f} s".format(title, t_shared, t_split, t_shared - t_split))
+        for text in problems:
+            print("  联锁违反 " + text)
+        failed += len(problems)
+
+    rng = random.Random(args.seed)
+    gains = {case[0]: [] for case in SPLIT_CASES}
+    for _ in range(args.runs):
+        for title, t_shared, t_split, problems in run_split_cases(jitter_timing(timing, rng, args.jitter), rounds):
+            gains[title].append(t_shared - t_split)
+            failed += len(problems)
+    if args.runs:
+        for title, values in gains.items():
+            print("随机时序 {:<8s} 缩短 最小 {:.3f} s 平均 {:.3f} s 最大 {:.3f} s".format(title, min(values), sum(values) / len(values), max(values)))
+    print("联锁检查 {} 违反 {} 次".format("失败" if failed else "通过", failed))
+    return 1 if failed else 0
+
+
+def jitter_timing(timing, rng, jitter):
+    return {k: v * rng.uniform(1 - jitter, 1 + jitter) for k, v in timing.items()}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="电机运动调度时序仿真")
+    parser.add_argument("--qr", type=float, default=0.6, help="二维码扫描耗时 秒")
+    parser.add_argument("--tray-overhead", type=float, default=0.15, help="托盘每次运动附加耗时 秒 复位/轮询")
+    parser.add_argument("--scan-overhead", type=float, default=0.05, help="扫码电机每次运动附加耗时 秒")
+    parser.add_argument("--runs", type=int, default=500, help="随机时序仿真次数")
+    parser.add_argument("--jitter", type=float, default=0.8, help="随机时序 各运动耗时相对波动范围")
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("--no-interlock", action="store_true", help="不获取资源 不检查联锁 直接并行")
+    parser.add_argument("--split-pwm", action="store_true", help="假设白板电机与上加热体电机各自独立PWM 对比收益")
+    parser.add_argument("--sample-point", type=float, default=1.0, help="采样每轮采集耗时 秒")
+    parser.add_argument("--sample-points", type=int, default=6, help="采样点数 白板电机每点往返一次")
+    parser.add_argument("-v", "--verbose", action="store_true")
+    args = parser.parse_args()
+
+    timing = build_timing(args)
+    print("时间模型(秒) " + " ".join("{}={:.3f}".format(k, v) for k, v in timing.items()))
+    if args.split_pwm:
+        return split_main(args, timing)
+
+    failed = 0
+    total_legacy = total_sched = 0.0
+    for title, t_legacy, t_sched, problems in run_cases(timing, not args.no_interlock, args.verbose):
+        total_legacy += t_legacy
+        total_sched += t_sched
+        print("{:<8s} 原有 {:6.3f} s  调度 {:6.3f} s  缩短 {:6.3f} s ({:+.1f}%)".format(
+            title, t_legacy, t_sched, t_legacy - t_sched, 100 * (t_sched - t_legacy) / t_legacy))
+        for text in problems:
+            print("  联锁违反 " + text)
+        failed += len(problems)
+    print("合计     原有 {:6.3f} s  调度 {:6.3f} s  缩短 {:6.3f} s".format(total_legacy, total_sched, total_legacy - total_sched))
+
+    rng = random.Random(args.seed)
+    gains, worst = [], None
+    for _ in range(args.runs):
+        results = run_cases(jitter_timing(timing, rng, args.jitter), not args.no_interlock)
+        gains.append(sum(r[1] - r[2] for r in results))
+        for title, _, _, problems in results:
+            if problems and worst is None:
+                worst = (title, problems[0])
+            failed += len(problems)
+    if gains:
+        print("随机时序 {} 次 波动 ±{:.0%} 缩短 最小 {:.3f} s 平均 {:.3f} s 最大 {:.3f} s".format(
+            args.runs, args.jitter, min(gains), sum(gains) / len(gains), max(gains)))
+    if worst:
+        print("首个违反 {} {}".format(*worst))
+    print("联锁检查 {} 违反 {} 次".format("失败" if failed else "通过", failed))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -0,0 +1,71 @@
+"""
+0x69 0xAA 串口协议 吞吐 与 延时 基准
+
+运行主机构建 (CMakeLists.txt) protocol_bench 实际固件源码 (发送队列 发送任务 重发 ACK 等待 接收拼包) + FreeRTOS 主机移植 虚拟时间
+控制板端 生产者按给定速率 (0 为尽快) 投入发送队列 对端按丢帧率丢弃数据帧 按 ACK 丢失率不回应
+统计 (详见 Tools/host/bench/protocol_bench.c)
+    帧/S          对端收下的不同帧数 / 时间
+    有效载荷速率  对端去重后收到的数据字节 / 时间
+    ACK 延时      首次发送至收到 ACK p50 p99 (含重发)
+    排队延时      入队至收到 ACK p50 p99
+    重发 失败     重发次数 3 次均无 ACK 的帧数 对端收到的重复帧
+    线路占用      控制板发送字节时间 / 时间
+    处理器        主机处理器时间 mS
+
+python protocol_bench.py                                         # 外串口 饱和 32 字节
+python protocol_bench.py --loss 0 1 5 --ack-loss 1               # 丢帧率扫描 每个值一行
+python protocol_bench.py --link main --rate 20 --payload 8 248   # 主串口 20 帧/S 数据长度扫描
+"""
+
+import argparse
+import json
+import os
+import subprocess
+
+HOST_BIN = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "_gate_build", "protocol_bench")
+
+
+def bench(args, loss, payload):
+    cmd = [args.host_bin, "-l", args.link, "-f", str(args.frames), "-p", str(payload), "-r", str(args.rate)]
+    cmd += ["-L", str(loss * 100), "-A", str(args.ack_loss * 100), "-s", str(args.seed)]
+    proc = subprocess.run(cmd, capture_output=True, text=True)
+    lines = [line for line in proc.stdout.splitlines() if line.startswith("{")]
+    if not lines:
+        raise SystemExit(f"{args.host_bin} 无结果 (返回 {proc.returncode}) {proc.stderr.strip()}")
+    return json.loads(lines[-1])
+
+
+def main():
+    parser = argparse.ArgumentParser(description="0x69 0xAA 串口协议 吞吐与延时基准 (主机构建)")
+    parser.add_argument("--host-bin", default=HOST_BIN, help="主机构建 protocol_bench 路径")
+    parser.add_argument("--link", choices=("out", "main"), default="out", help="外串口 (UART5) / 主串口 (USART1)")
+    parser.add_argument("--loss", type=float, nargs="+", default=[0.0], help="丢帧率 多个值时逐个测试")
+    parser.add_argument("--ack-loss", type=float, default=0.0, help="ACK 丢失率")
+    parser.add_argument("--frames", type=int, default=2000, help="发送帧数")
+    parser.add_argument("--payload", type=int, nargs="+", default=[32], help="数据长度 多个值时逐个测试 2～248")
+    parser.add_argument("--rate", type=float, default=0, help="投入速率 帧/S 0 为尽快")
+    parser.add_argument("--seed", type=int, default=1, help="随机种子")
+    args = parser.parse_args()
+    if min(args.payload) < 2 or max(args.payload) > 248:
+        parser.error("数据长度 2～248 (序号 2 字节 帧长 255)")
+    if not os.path.exists(args.host_bin):
+        parser.error(f"{args.host_bin} 不存在 先构建主机构建 (cmake -S . -B _gate_build && cmake --build _gate_build)")
+
+    print(f"串口 {args.link} ACK 丢失 {args.ack_loss:.1%} 帧数 {args.frames} 速率 {args.rate or '饱和'}")
+    print(
+        f"{'丢帧':>6} {'数据':>4} {'帧/S':>8} {'载荷B/S':>9} {'ACK p50':>8} {'p99':>8} {'排队p50':>8} {'p99':>8} "
+        f"{'重发':>6} {'失败':>5} {'重复':>5} {'其他':>5} {'占用':>6} {'处理器':>8}"
+    )
+    for loss in args.loss:
+        for payload in args.payload:
+            r = bench(args, loss, payload)
+            print(
+                f"{loss:6.1%} {payload:4d} {r['fps']:8.1f} {r['goodput']:9.0f} {r['ack_p50_ms']:8.2f} {r['ack_p99_ms']:8.2f} "
+                f"{r['queue_p50_ms']:8.1f} {r['queue_p99_ms']:8.1f} {r['retrans']:6d} {r['failed']:5d} {r['dup']:5d} {r['others']:5d} "
+                f"{r['util']:6.1%} {r['cpu_ms']:8.1f}{'' if r['pass'] else '  ' + r['reason']}"
+            )
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
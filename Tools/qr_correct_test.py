@@ -0,0 +1,341 @@
+"""
+定标二维码解析 主机端测试 及 耗时对比
+
+从 Src/barcode_scan.c 抽取 barcode_Char_2_Hex / barcode_Str_2_Int / barcode_Correct_Info_Parse / barcode_Scan_Decode_Correct_Info
+从 Src/protocol.c 抽取 CRC8 以桩代替存储任务 编译为动态库 通过 ctypes 调用
+    有效条码 各定标段 16进制大小写 杂散光条码 make_barcode 样例对照 405 定标点各通道共用
+    无效条码 长度 非法字符 CRC 定标段越限 失败时不得改动校正标准值
+    耗时 与原有逐字段转换实现对比 主机上的相对值
+
+python qr_correct_test.py               # 全部测试
+python qr_correct_test.py --rounds 5000 --bench 200000
+"""
+
+import argparse
+import ctypes
+import os
+import random
+import re
+import subprocess
+import sys
+import tempfile
+
+from collections import namedtuple
+
+REPO = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+
+Criterion = namedtuple("Criterion", "batch date stage list_610 list_550 list_405")  # 同 make_barcode.py
+
+STUB_C = r"""
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+
+#define ARRAY_LEN(x) (sizeof(x) / sizeof((x)[0]))
+#define BARCODE_QR_LENGTH 65
+
+typedef struct {
+    uint32_t branch;
+    uint32_t date;
+    uint8_t stage;
+    uint16_t i_values[13];
+    uint32_t check;
+} sBarcodeCorrectInfo;
+
+static sBarcodeCorrectInfo gBarcodeCorrectInfo;
+
+uint32_t stub_stage = 0xFF;
+uint32_t stub_values[18];
+uint32_t stub_commit = 0;
+
+void storge_Param_Illumine_CC_Set_Stage(uint8_t stage, uint32_t const * pValues)
+{
+    stub_stage = stage;
+    memcpy(stub_values, pValues, sizeof(stub_values));
+    ++stub_commit;
+}
+
+/* 原有实现 逐项写入 */
+void storge_Param_Illumine_CC_Set_Single(uint32_t idx, uint32_t data)
+{
+    stub_values[idx % 18] = data;
+}
+
+uint8_t stub_get_stage(void)
+{
+    return gBarcodeCorrectInfo.stage;
+}
+
+%(crc)s
+
+%(decode)s
+
+/* 原有实现 逐字段转换 */
+static uint32_t legacy_Base_10(uint8_t * pBuffer, uint8_t length)
+{
+    uint8_t i;
+    uint32_t result = 0;
+
+    for (i = 0; i < length; ++i) {
+        result *= 10;
+        if (pBuffer[i] >= '0' && pBuffer[i] <= '9') {
+            result += pBuffer[i] - '0';
+        } else {
+            return 0;
+        }
+    }
+    return result;
+}
+
+static uint32_t legacy_Base_16(uint8_t * pBuffer, uint8_t length)
+{
+    uint8_t i;
+    uint32_t result = 0;
+
+    for (i = 0; i < length; ++i) {
+        result *= 16;
+        if (pBuffer[i] >= '0' && pBuffer[i] <= '9') {
+            result += pBuffer[i] - '0';
+        } else if (pBuffer[i] >= 'a' && pBuffer[i] <= 'f') {
+            result += pBuffer[i] - 'a' + 10;
+        } else if (pBuffer[i] >= 'A' && pBuffer[i] <= 'F') {
+            result += pBuffer[i] - 'A' + 10;
+        } else {
+            return 0;
+        }
+    }
+    return result;
+}
+
+uint8_t legacy_Decode(uint8_t * pBuffer, uint8_t length)
+{
+    uint8_t i, ao = 0, wave;
+
+    if (pBuffer == NULL || length != 65) {
+        return 1;
+    }
+    gBarcodeCorrectInfo.branch = legacy_Base_10(pBuffer, 4);
+    gBarcodeCorrectInfo.date = legacy_Base_10(pBuffer + 4, 6);
+    gBarcodeCorrectInfo.stage = legacy_Base_10(pBuffer + 10, 1);
+    for (i = 0; i < 13; ++i) {
+        gBarcodeCorrectInfo.i_values[i] = legacy_Base_16(pBuffer + 11 + 4 * i, 4);
+        if (ao == 0 && gBarcodeCorrectInfo.i_values[i] > 0) {
+            ao = 1;
+        }
+    }
+    gBarcodeCorrectInfo.check = legacy_Base_16(pBuffer + 63, 2);
+    if (CRC8(pBuffer, length - 2) != gBarcodeCorrectInfo.check) {
+        return 2;
+    }
+    if (gBarcodeCorrectInfo.stage == 9 && ao == 0) {
+        return 0xFF;
+    } else if (gBarcodeCorrectInfo.stage > 5) {
+        return 2;
+    }
+    for (i = 0; i < 6; ++i) {
+        for (wave = 0; wave < 2; ++wave) { /* 405 原有实现越界读取 不计入 */
+            storge_Param_Illumine_CC_Set_Single(wave * 6 + i + gBarcodeCorrectInfo.stage, gBarcodeCorrectInfo.i_values[wave * 6 + i]);
+        }
+    }
+    return 0;
+}
+
+double stub_bench(uint8_t legacy, uint8_t * pBuffer, uint32_t rounds)
+{
+    struct timespec t0, t1;
+    uint32_t i;
+    volatile uint8_t result = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (i = 0; i < rounds; ++i) {
+        result += legacy ? legacy_Decode(pBuffer, 65) : barcode_Scan_Decode_Correct_Info(pBuffer, 65);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    return ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / rounds;
+}
+"""
+
+
+def extract(path, names):
+    """按函数名抽取定义 含前置注释 大括号配对"""
+    text = open(path, encoding="utf-8").read()
+    parts = []
+    for name in names:
+        m = re.search(r"^[^\n;]*\b%s\(([^;{]*)\)\s*\{" % re.escape(name), text, re.M)
+        if m is None:
+            raise SystemExit("{} not found in {}".format(name, path))
+        depth, pos = 0, m.end() - 1
+        while True:
+            if text[pos] == "{":
+                depth += 1
+            elif text[pos] == "}":
+                depth -= 1
+                if depth == 0:
+                    break
+            pos += 1
+        parts.append(text[m.start() : pos + 1])
+    return "\n\n".join(parts)
+
+
+def crc_source():
+    text = open(os.path.join(REPO, "Src", "protocol.c"), encoding="utf-8").read()
+    table = re.search(r"static const unsigned char CRC8Table\[256\] = \{.*?\};", text, re.S).group(0)
+    return table + "\n\n" + extract(os.path.join(REPO, "Src", "protocol.c"), ["CRC8"])
+
+
+def build(tmp):
+    decode = extract(
+        os.path.join(REPO, "Src", "barcode_scan.c"), ["barcode_Char_2_Hex", "barcode_Str_2_Int", "barcode_Correct_Info_Parse", "barcode_Scan_Decode_Correct_Info"]
+    )
+    src = os.path.join(tmp, "qr_correct.c")
+    lib = os.path.join(tmp, "qr_correct.so")
+    with open(src, "w", encoding="utf-8") as f:
+        f.write(STUB_C.replace("%(crc)s", crc_source()).replace("%(decode)s", decode))
+    subprocess.check_call(["gcc", "-O2", "-shared", "-fPIC", "-Wall", "-Wno-unused-function", "-o", lib, src])
+    dll = ctypes.CDLL(lib)
+    dll.barcode_Scan_Decode_Correct_Info.restype = ctypes.c_uint8
+    dll.legacy_Decode.restype = ctypes.c_uint8
+    dll.stub_get_stage.restype = ctypes.c_uint8
+    dll.stub_bench.restype = ctypes.c_double
+    dll.stub_bench.argtypes = (ctypes.c_uint8, ctypes.c_char_p, ctypes.c_uint32)
+    return dll
+
+
+class Decoder:
+    def __init__(self, dll):
+        self.dll = dll
+        dll.CRC8.restype = ctypes.c_uint8
+        self.values = (ctypes.c_uint32 * 18).in_dll(dll, "stub_values")
+        self.commit = ctypes.c_uint32.in_dll(dll, "stub_commit")
+        self.stage = ctypes.c_uint32.in_dll(dll, "stub_stage")
+
+    def decode(self, text):
+        data = text.encode("ascii") if isinstance(text, str) else text
+        buf = ctypes.create_string_buffer(data, len(data))
+        return self.dll.barcode_Scan_Decode_Correct_Info(buf, len(data))
+
+
+def make_barcode(dll, c, lower=False):
+    """同 make_barcode.py 校验位由固件 CRC8 计算 不依赖 bytes_helper"""
+    text = "".join(f"{i:04X}" for i in list(c.list_610) + list(c.list_550) + list(c.list_405))
+    payload = f"{c.batch:04d}{c.date:06d}{c.stage:d}{text.lower() if lower else text}".encode("ascii")
+    return (payload + "{:02X}".format(dll.CRC8(payload, len(payload))).encode("ascii")).decode("ascii")
+
+
+def random_criterion(rng, stage=None):
+    return Criterion(
+        rng.randrange(10000),
+        rng.randrange(1000000),
+        rng.randrange(6) if stage is None else stage,
+        [rng.randrange(0x10000) for _ in range(6)],
+        [rng.randrange(0x10000) for _ in range(6)],
+        [rng.randrange(0x10000)],
+    )
+
+
+def expect_values(c):
+    return list(c.list_610) + list(c.list_550) + [c.list_405[0]] * 6
+
+
+def test_valid(dec, rng, rounds):
+    for n in range(rounds):
+        c = random_criterion(rng)
+        text = make_barcode(dec.dll, c, n % 2 == 1)  # 16进制大小写
+        commit = dec.commit.value
+        assert dec.decode(text) == 0, text
+        assert dec.commit.value == commit + 1, "一次解析只提交一次"
+        assert dec.stage.value == c.stage
+        assert list(dec.values) == expect_values(c), text
+        assert dec.dll.stub_get_stage() == c.stage
+
+
+def test_stary(dec):
+    c = Criterion(2, 200609, 9, [0] * 6, [0] * 6, [0])
+    commit = dec.commit.value
+    assert dec.decode(make_barcode(dec.dll, c)) == 0xFF
+    assert dec.commit.value == commit, "杂散光条码不提交校正标准值"
+    assert dec.dll.stub_get_stage() == 9
+    c = Criterion(2, 200609, 9, [0] * 6, [0] * 6, [1])
+    assert dec.decode(make_barcode(dec.dll, c)) == 2, "段索引9 定标点非0"
+    for stage in (6, 7, 8):
+        assert dec.decode(make_barcode(dec.dll, random_criterion(random.Random(stage), stage))) == 2
+
+
+def test_invalid(dec, rng, rounds):
+    base = make_barcode(dec.dll, random_criterion(rng))
+    assert dec.decode(base) == 0
+    commit, values = dec.commit.value, list(dec.values)
+
+    assert dec.decode(base[:-1]) == 1
+    assert dec.decode(base + "0") == 1
+    assert dec.decode("") == 1
+    for n in range(rounds):
+        pos = rng.randrange(65)
+        text = list(base)
+        kind = n % 3
+        if kind == 0:  # 非法字符
+            text[pos] = rng.choice("GgZz:/@` -" if pos >= 11 else "AaFfGz:/ -")
+            expect = (1,)
+        elif kind == 1:  # 合法字符替换 单字节差错 CRC8 必然检出
+            alphabet = "0123456789" if pos < 11 else "0123456789ABCDEF"
+            text[pos] = rng.choice(alphabet.replace(text[pos].upper(), ""))
+            expect = (2,)
+        else:  # 交换相邻字符 可能跨越字段进制边界 或 CRC 碰撞
+            if pos >= 64 or text[pos] == text[pos + 1]:
+                continue
+            text[pos], text[pos + 1] = text[pos + 1], text[pos]
+            expect = (1, 2, 0)
+        text = "".join(text)
+        result = dec.decode(text)
+        assert result in expect, (text, result)
+        if result == 0:  # CRC 碰撞 仍为合法条码
+            dec.decode(base)
+        assert dec.commit.value in (commit, commit + 1)
+        commit = dec.commit.value
+        assert list(dec.values) == values, "失败不得改动校正标准值"
+
+
+def test_reference(dec):
+    """与 make_barcode 内置样例对照"""
+    r = "12342012050123443213456654356788765789AA987951717399371258074105B"
+    assert dec.decode(r) == 0
+    assert list(dec.values)[:12] == [0x1234, 0x4321, 0x3456, 0x6543, 0x5678, 0x8765, 0x789A, 0xA987, 0x9517, 0x1739, 0x9371, 0x2580]
+    assert list(dec.values)[12:] == [0x7410] * 6
+    assert dec.stage.value == 0
+
+
+def bench(dll, rounds):
+    text = make_barcode(dll, random_criterion(random.Random(0))).encode("ascii")
+    buf = ctypes.create_string_buffer(text, len(text))
+    new = dll.stub_bench(0, buf, rounds)
+    old = dll.stub_bench(1, buf, rounds)
+    print("解析耗时 主机 原有 {:.1f} nS  单次遍历 {:.1f} nS  ({:+.1f}%)".format(old, new, 100 * (new - old) / old))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="定标二维码解析 主机端测试")
+    parser.add_argument("--rounds", type=int, default=2000, help="随机测试次数")
+    parser.add_argument("--bench", type=int, default=100000, help="耗时测试次数 0 不测试")
+    parser.add_argument("--seed", type=int, default=0)
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    with tempfile.TemporaryDirectory() as tmp:
+        dll = build(tmp)
+        dec = Decoder(dll)
+        for name, fun in (
+            ("参考样例", lambda: test_reference(dec)),
+            ("有效条码", lambda: test_valid(dec, rng, args.rounds)),
+            ("杂散光条码", lambda: test_stary(dec)),
+            ("无效条码", lambda: test_invalid(dec, rng, args.rounds)),
+        ):
+            fun()
+            print("{} 通过".format(name))
+        if args.bench > 0:
+            bench(dll, args.bench)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -18,6 +18,7 @@ from math import log10, nan
 
 import numpy as np
 import pyperclip
+import pyqtgraph as pg
 import requests
 import serial
 import serial.tools.list_ports
@@ -53,6 +54,8 @@ from PyQt5.QtWidgets import (
     QSpacerItem,
     QSpinBox,
     QStatusBar,
+    QTableWidget,
+    QTableWidgetItem,
     QTabWidget,
     QTextEdit,
     QVBoxLayout,
@@ -93,6 +96,15 @@ TEMP_RAW_SYMBOL_CONFIG = (("o", 4, "b"), ("s", 4, "g"), ("t", 4, "r"), ("d", 4,
 METHOD_NAMES = ("无项目", "速率法", "终点法", "两点终点法")
 WAVE_NAMES = ("610", "550", "405")
 SampleConf = namedtuple("SampleConf", "method wave point_num set_info")
+TaskStat = namedtuple("TaskStat", "number name state priority cpu stack")
+TASK_STATES = {0: "运行", 1: "就绪", 2: "阻塞", 3: "挂起", 4: "删除"}
+IRQ_NAMES = (
+    "EXTI2", "EXTI3", "EXTI4", "DMA1_S0", "DMA1_S1", "DMA1_S5", "DMA1_S6", "TIM1_UP_TIM10", "USART1", "USART2",
+    "USART3", "TIM8_TIM14", "DMA1_S7", "TIM5", "UART5", "TIM6_DAC", "TIM7", "DMA2_S0", "DMA2_S2", "DMA2_S5",
+    "DMA2_S7",
+)  # 与 Inc/sys_stat.h eSys_Stat_IRQ 对应
+IRQ_BUCKET_EDGES = (1, 2, 5, 10, 20, 50, 100)  # 直方图分档边界 uS
+QUEUE_NAMES = ("", "Out发送", "Out错误", "OutACK", "Main发送", "Main错误", "MainACK", "Data发送", "DataACK")  # 与 Inc/sys_stat.h eSys_Stat_Queue 对应
 HEATER_PID_FQ = 1000 / 100
 HEATER_PID_PS = [1, HEATER_PID_FQ, 1 / HEATER_PID_FQ, 1, 1, 1]
 
@@ -255,6 +267,7 @@ class MainWindow(QMainWindow):
         self.createSysConf()
         self.createStorgeDialog()
         self.createSelfCheckDialog()
+        self.createTaskStatDialog()
         widget = QWidget()
         layout = QHBoxLayout(widget)
 
@@ -1681,6 +1694,8 @@ class MainWindow(QMainWindow):
             self.updateDebugFlag(info)
         elif cmd_type == 0xDA:
             self.updateSelfCheckDialog(info)
+        elif cmd_type == 0xDC:
+            self.updateDebugSystem(info)
         elif cmd_type == 0xDD:
             self.updateOutFlashParam(info)
         elif cmd_type == 0xEE:
@@ -3203,6 +3218,7 @@ class MainWindow(QMainWindow):
         self.selftest_bt = QPushButton("自检", maximumWidth=50)
         self.selftest_bt.mousePressEvent = self.onSelfCheck  # 区分鼠标按键
         self.debugtest_bt = QPushButton("定标", maximumWidth=50, clicked=self.onDebugTest)
+        self.task_stat_bt = QPushButton("任务", maximumWidth=50, clicked=self.onTaskStatDialogShow)
         self.debug_aging_sleep_sp = QSpinBox(minimum=0, maximum=255, value=10, maximumWidth=50, suffix="S", valueChanged=self.on_debug_aging_sleep_sp)
         self.debugtest_cnt = 0
         boot_ly.addWidget(self.upgrade_bt)
@@ -3211,10 +3227,230 @@ class MainWindow(QMainWindow):
         boot_ly.addWidget(self.reboot_bt)
         boot_ly.addWidget(self.selftest_bt)
         boot_ly.addWidget(self.debugtest_bt)
+        boot_ly.addWidget(self.task_stat_bt)
         boot_ly.addWidget(QLabel("间隔", maximumWidth=50))
         boot_ly.addWidget(self.debug_aging_sleep_sp)
         sys_conf_ly.addLayout(boot_ly)
 
+    def createTaskStatDialog(self):
+        """任务运行统计 0xDC 子参数 10 占用率为两次查询间隔内"""
+        self.task_stat_dg = QDialog(self)
+        self.task_stat_dg.setWindowTitle("任务运行统计")
+        self.task_stat_dg.resize(520, 560)
+        task_stat_ly = QVBoxLayout(self.task_stat_dg)
+        task_stat_ly.setContentsMargins(5, 5, 5, 5)
+        task_stat_ly.setSpacing(5)
+
+        self.task_stat_tw = QTableWidget(0, 6)
+        self.task_stat_tw.setHorizontalHeaderLabels(("编号", "名称", "状态", "优先级", "CPU %", "栈余量(字)"))
+        self.task_stat_tw.verticalHeader().setVisible(False)
+        self.task_stat_tw.setEditTriggers(QTableWidget.NoEditTriggers)
+        self.task_stat_plot = pg.PlotWidget()
+        self.task_stat_plot.setLabel("left", "CPU %")
+        self.task_stat_plot.showGrid(y=True)
+        self.task_stat_bar = pg.BarGraphItem(x=[], height=[], width=0.6, brush="g")
+        self.task_stat_plot.addItem(self.task_stat_bar)
+        self.res_stat_lb = QLabel("堆 *** 队列 ***", wordWrap=True)
+        self.power_stat_lb = QLabel("休眠 ***", wordWrap=True)
+        self.wheel_stat_lb = QLabel("时间轮 ***", wordWrap=True)
+        self.boot_stat_lb = QLabel("启动 ***", wordWrap=True)
+        self.irq_stat_te = QTextEdit(readOnly=True)
+        self.irq_stat_te.setFont(QFont("Consolas", 9))
+
+        temp_ly = QHBoxLayout()
+        temp_ly.setContentsMargins(0, 0, 0, 0)
+        temp_ly.setSpacing(5)
+        self.task_stat_interval_lb = QLabel("间隔 ***")
+        self.task_stat_refresh_bt = QPushButton("刷新", clicked=self.onTaskStatRefresh)
+        self.task_stat_auto_cb = QCheckBox("定时", clicked=self.onTaskStatAuto)
+        self.task_stat_auto_sp = QSpinBox(minimum=1, maximum=60, value=2, suffix="S", maximumWidth=60)
+        self.task_stat_timer = QTimer(self)
+        self.task_stat_timer.timeout.connect(self.onTaskStatRefresh)
+        temp_ly.addWidget(self.task_stat_interval_lb)
+        temp_ly.addStretch(1)
+        temp_ly.addWidget(self.task_stat_auto_cb)
+        temp_ly.addWidget(self.task_stat_auto_sp)
+        temp_ly.addWidget(self.task_stat_refresh_bt)
+        temp_ly.addWidget(QPushButton("中断", clicked=lambda: self._serialSendPack(0xDC, (11,))))
+        temp_ly.addWidget(QPushButton("余量", clicked=lambda: self._serialSendPack(0xDC, (13,))))
+        self.res_stat_period_sp = QSpinBox(minimum=0, maximum=255, value=0, suffix="S", maximumWidth=60, toolTip="余量周期上送 随温度上送 0 关闭")
+        self.res_stat_period_sp.valueChanged.connect(lambda v: self._serialSendPack(0xDC, (14, v)))
+        temp_ly.addWidget(self.res_stat_period_sp)
+        temp_ly.addWidget(QPushButton("中断清零", clicked=lambda: self._serialSendPack(0xDC, (12,))))
+        temp_ly.addWidget(QPushButton("休眠", clicked=lambda: self._serialSendPack(0xDC, (15,))))
+        temp_ly.addWidget(QPushButton("休眠清零", clicked=lambda: self._serialSendPack(0xDC, (16,))))
+        temp_ly.addWidget(QPushButton("时间轮", clicked=lambda: self._serialSendPack(0xDC, (19,))))
+        temp_ly.addWidget(QPushButton("时间轮清零", clicked=lambda: self._serialSendPack(0xDC, (20,))))
+        temp_ly.addWidget(QPushButton("启动", clicked=lambda: self._serialSendPack(0xDC, (21,))))
+
+        task_stat_ly.addWidget(self.task_stat_tw, stretch=1)
+        task_stat_ly.addWidget(self.task_stat_plot, stretch=1)
+        task_stat_ly.addWidget(self.res_stat_lb)
+        task_stat_ly.addWidget(self.power_stat_lb)
+        task_stat_ly.addWidget(self.wheel_stat_lb)
+        task_stat_ly.addWidget(self.boot_stat_lb)
+        task_stat_ly.addWidget(self.irq_stat_te, stretch=1)
+        task_stat_ly.addLayout(temp_ly)
+        self.task_stat_dg = ModernDialog(self.task_stat_dg, self)
+
+    def onTaskStatDialogShow(self, event):
+        self.task_stat_dg.show()
+        self.onTaskStatRefresh()
+
+    def onTaskStatRefresh(self):
+        if not self.task_stat_dg.isVisible():  # 窗口关闭后停止定时刷新
+            self.task_stat_timer.stop()
+            self.task_stat_auto_cb.setChecked(False)
+            return
+        self._serialSendPack(0xDC, (10,))
+
+    def onTaskStatAuto(self, event):
+        if self.task_stat_auto_cb.isChecked():
+            self.task_stat_timer.start(self.task_stat_auto_sp.value() * 1000)
+        else:
+            self.task_stat_timer.stop()
+
+    def updateDebugSystem(self, info):
+        payload = info.content[6:-1]
+        if len(payload) > 0 and payload[0] == 0x0A:
+            self.updateTaskStat(payload)
+        elif len(payload) > 0 and payload[0] == 0x0B:
+            self.updateIRQStat(payload)
+        elif len(payload) > 0 and payload[0] == 0x0C:
+            self.updateResourceStat(payload)
+        elif len(payload) == 23 and payload[0] == 0x0D:
+            self.updatePowerStat(payload)
+        elif len(payload) == 15 and payload[0] == 0x0F:
+            self.updateWheelStat(payload)
+        elif len(payload) == 30 and payload[0] == 0x10:
+            self.updateBootStat(payload)
+        else:
+            logger.info(f"get debug system | {bytesPuttyPrint(payload)}")
+
+    def decodeTaskStat(self, payload):
+        """标识 0x0A + 统计间隔 u32 10uS + 任务数 + 每任务 编号 状态 优先级 占用率u16千分比 栈余量u16字 名称长度 名称"""
+        interval, num = struct.unpack_from("<IB", payload, 1)
+        tasks = []
+        offset = 6
+        for _ in range(num):
+            if offset + 8 > len(payload):
+                raise ValueError(f"task stat pack too short | {bytesPuttyPrint(payload)}")
+            number, state, priority, permille, stack, name_len = struct.unpack_from("<BBBHHB", payload, offset)
+            offset += 8
+            name = payload[offset : offset + name_len].decode("ascii", errors="replace")
+            offset += name_len
+            tasks.append(TaskStat(number, name, TASK_STATES.get(state, str(state)), priority, permille / 10, stack))
+        if offset != len(payload):
+            raise ValueError(f"task stat pack length mismatch | {offset} | {len(payload)}")
+        return interval * 10 / 1000, tasks
+
+    def updateTaskStat(self, payload):
+        try:
+            interval, tasks = self.decodeTaskStat(payload)
+        except (ValueError, struct.error):
+            logger.error(f"decode task stat failed\n{stackprinter.format()}")
+            return
+        tasks.sort(key=lambda t: t.number)
+        self.task_stat_interval_lb.setText(f"间隔 {interval:.1f} mS 合计 {sum(t.cpu for t in tasks):.1f} %")
+        self.task_stat_tw.setRowCount(len(tasks))
+        for row, task in enumerate(tasks):
+            for col, value in enumerate((task.number, task.name, task.state, task.priority, f"{task.cpu:.1f}", task.stack)):
+                self.task_stat_tw.setItem(row, col, QTableWidgetItem(str(value)))
+        self.task_stat_bar.setOpts(x=list(range(len(tasks))), height=[t.cpu for t in tasks])
+        self.task_stat_plot.getAxis("bottom").setTicks([[(i, t.name) for i, t in enumerate(tasks)]])
+        logger.debug(f"task stat | {interval:.1f} mS | {tasks}")
+
+    def decodeIRQStat(self, payload):
+        """标识 0x0B + 帧序号 + 中断数 + 每中断 索引 次数u32 时长最小/最大u16 阻塞次数u16 延迟最大u16 阻塞者 时长直方图8*u16 延迟直方图8*u16 单位0.1uS"""
+        frame, num = payload[1], payload[2]
+        fmt = "<BIHHHHB8H8H"
+        size = struct.calcsize(fmt)
+        if len(payload) != 3 + num * size:
+            raise ValueError(f"irq stat pack length mismatch | {len(payload)} | {num}")
+        irqs = []
+        for i in range(num):
+            v = struct.unpack_from(fmt, payload, 3 + i * size)
+            irqs.append(dict(idx=v[0], count=v[1], dur_min=v[2] / 10, dur_max=v[3] / 10, lat_count=v[4], lat_max=v[5] / 10, lat_by=v[6], dur_hist=v[7:15], lat_hist=v[15:23]))
+        return frame, irqs
+
+    def updateIRQStat(self, payload):
+        try:
+            frame, irqs = self.decodeIRQStat(payload)
+        except (ValueError, struct.error):
+            logger.error(f"decode irq stat failed\n{stackprinter.format()}")
+            return
+        if frame == 0:
+            edges = "".join(f"{f'<{e}':>7s}" for e in IRQ_BUCKET_EDGES) + f"{f'>={IRQ_BUCKET_EDGES[-1]}':>7s}"
+            self.irq_stat_te.setPlainText(f"{'中断':14s}{'次数':>10s}{'最短uS':>9s}{'最长uS':>9s}{'阻塞':>8s}{'最大延迟':>9s}  阻塞者 | 直方图 uS {edges}")
+        for s in irqs:
+            name = IRQ_NAMES[s["idx"]] if s["idx"] < len(IRQ_NAMES) else str(s["idx"])
+            by = IRQ_NAMES[s["lat_by"]] if s["lat_by"] < len(IRQ_NAMES) else "-"
+            self.irq_stat_te.append(f"{name:14s}{s['count']:>10d}{s['dur_min']:>9.1f}{s['dur_max']:>9.1f}{s['lat_count']:>8d}{s['lat_max']:>9.1f}  {by:14s}")
+            self.irq_stat_te.append(f"{'':14s} 时长 {' '.join(f'{h:6d}' for h in s['dur_hist'])}")
+            if s["lat_count"]:
+                self.irq_stat_te.append(f"{'':14s} 延迟 {' '.join(f'{h:6d}' for h in s['lat_hist'])}")
+        logger.debug(f"irq stat | frame {frame} | {irqs}")
+
+    def decodeResourceStat(self, payload):
+        """标识 0x0C + 堆剩余u32 + 堆历史最小u32 + 任务数 + 每任务 编号 栈余量u16 + 队列数 + 每队列 编号 长度 当前深度 峰值深度"""
+        heap, heap_min, num = struct.unpack_from("<IIB", payload, 1)
+        offset = 10
+        stacks = {}
+        for _ in range(num):
+            number, stack = struct.unpack_from("<BH", payload, offset)
+            stacks[number] = stack
+            offset += 3
+        num = payload[offset]
+        offset += 1
+        if offset + num * 4 != len(payload):
+            raise ValueError(f"resource stat pack length mismatch | {len(payload)}")
+        queues = [tuple(payload[offset + i * 4 : offset + i * 4 + 4]) for i in range(num)]
+        return heap, heap_min, stacks, queues
+
+    def updateResourceStat(self, payload):
+        try:
+            heap, heap_min, stacks, queues = self.decodeResourceStat(payload)
+        except (ValueError, IndexError, struct.error):
+            logger.error(f"decode resource stat failed\n{stackprinter.format()}")
+            return
+        for row in range(self.task_stat_tw.rowCount()):  # 按任务编号更新栈余量
+            item = self.task_stat_tw.item(row, 0)
+            if item is not None and int(item.text()) in stacks:
+                self.task_stat_tw.setItem(row, 5, QTableWidgetItem(str(stacks[int(item.text())])))
+        queue_text = " ".join(f"{QUEUE_NAMES[q[0]] if q[0] < len(QUEUE_NAMES) else q[0]} {q[3]}/{q[1]}" for q in queues)
+        self.res_stat_lb.setText(f"堆剩余 {heap} 历史最小 {heap_min} 字节 | 队列峰值 {queue_text}")
+        logger.debug(f"resource stat | heap {heap} min {heap_min} | stacks {stacks} | queues {queues}")
+
+    def updatePowerStat(self, payload):
+        """标识 0x0D + 统计间隔u32 + 休眠时间u32 + WFI时间u32 10uS + 休眠次数u32 + 放弃次数u16 + 加热定时器回调间隔 最小u16 最大u16 10uS"""
+        interval, sleep, wfi, count, abort, heater_min, heater_max = struct.unpack_from("<IIIIHHH", payload, 1)
+        if interval == 0:
+            return
+        seconds = interval / 100000
+        self.power_stat_lb.setText(
+            f"休眠 {sleep / interval:.1%} (DWT {wfi / interval:.1%}) 唤醒 {count / seconds:.1f}/S 放弃 {abort} | "
+            f"加热回调间隔 {heater_min / 100:.2f} ~ {heater_max / 100:.2f} mS | 间隔 {seconds:.1f} S"
+        )
+        logger.debug(f"power stat | interval {interval} sleep {sleep} wfi {wfi} count {count} abort {abort} heater {heater_min} {heater_max}")
+
+    def updateWheelStat(self, payload):
+        """标识 0x0F + 统计时长u32 mS + 唤醒次数u32 + 回调次数u32 + 回调延后最大值u16 mS"""
+        elapsed, wake, runs, late = struct.unpack_from("<IIIH", payload, 1)
+        if elapsed == 0:
+            return
+        seconds = elapsed / 1000
+        self.wheel_stat_lb.setText(f"杂项任务 唤醒 {wake / seconds:.1f}/S 回调 {runs / seconds:.1f}/S 延后最大 {late} mS | 时长 {seconds:.1f} S")
+        logger.debug(f"wheel stat | elapsed {elapsed} wake {wake} runs {runs} late {late}")
+
+    def updateBootStat(self, payload):
+        """标识 0x10 + 已完成事件位 + 调度器启动 参数 温度 加热 扫码 电机 就绪帧 时刻u32 mS 0 为未完成"""
+        bits = payload[1]
+        times = struct.unpack_from("<7I", payload, 2)
+        names = ("调度器", "参数", "温度", "加热", "扫码", "电机", "就绪帧")
+        text = " ".join(f"{name} {t}" if t else f"{name} --" for name, t in zip(names, times))
+        self.boot_stat_lb.setText(f"启动 mS | {text} | 事件 0x{bits:02X}")
+        logger.debug(f"boot stat | bits 0x{bits:02X} | {times}")
+
     def on_debug_aging_sleep_sp(self, event):
         self._serialSendPack(0xD4, (event,))
 
@@ -3254,6 +3490,9 @@ class MainWindow(QMainWindow):
         msg.close_callback.connect(self.on_warn_msgbox_close)
         msg.setIcon(level)
         msg.setWindowTitle(f"故障信息 | {datetime.now()}")
+        if len(info.content) >= 13:  # 合并上送 错误码 + 次数 + 时段
+            count, span = struct.unpack("HH", info.content[8:12])
+            error_content = f"{error_content}\n最近 {span} mS 内发生 {count} 次"
         msg.setText(f"故障码 {error_code}\n{error_content}")
         msg.show()
 
@@ -0,0 +1,133 @@
+"""
+链接映射文件 RAM 占用统计 与 对比
+
+解析 GNU ld 生成的 .map 文件 (STM32CubeIDE Debug/stm32f207VET6_B.map)
+统计 RAM 区域 (0x20000000 ~ 0x20020000 STM32F207VETX_FLASH.ld) 各输出段大小 及 占用最大的符号
+给出两个映射文件时 逐段 逐符号 对比 用于评估 RTOS 对象静态分配 / 堆大小调整 等改动
+
+python ram_map.py Debug/stm32f207VET6_B.map                   # 单个文件 段大小 + 前 30 个符号
+python ram_map.py before.map after.map --top 40               # 对比 按变化量排序
+"""
+
+import argparse
+import re
+
+RAM_START = 0x20000000
+RAM_SIZE = 128 * 1024
+
+SECTION_RE = re.compile(r"^(\.\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")  # 输出段 同一行
+SECTION_NAME_RE = re.compile(r"^(\.\S+)\s*$")  # 输出段 名称过长时 地址大小在下一行
+INPUT_RE = re.compile(r"^ (\.\S+|COMMON)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S+)")  # 输入段 同一行
+INPUT_NAME_RE = re.compile(r"^ (\.\S+|COMMON)\s*$")  # 输入段 名称过长时 地址大小在下一行
+INPUT_TAIL_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s*(\S*)")
+
+
+def in_ram(addr):
+    return RAM_START <= addr < RAM_START + RAM_SIZE
+
+
+def parse(path):
+    """返回 (输出段 {名称: 大小}, 符号 {名称: 大小})"""
+    sections, symbols = {}, {}
+    started = False
+    pending = None
+    pending_section = None
+    with open(path, "r", encoding="utf-8", errors="replace") as f:
+        for line in f:
+            if not started:
+                started = line.startswith("Linker script and memory map")
+                continue
+            line = line.rstrip("\n")
+            if pending_section is not None:
+                m = INPUT_TAIL_RE.match(line)
+                if m:
+                    add_section(sections, pending_section, int(m.group(1), 16), int(m.group(2), 16))
+                pending_section = None
+                continue
+            m = SECTION_RE.match(line)
+            if m:
+                add_section(sections, m.group(1), int(m.group(2), 16), int(m.group(3), 16))
+                pending = None
+                continue
+            m = SECTION_NAME_RE.match(line)
+            if m:
+                pending_section = m.group(1)
+                pending = None
+                continue
+            if pending is not None:
+                m = INPUT_TAIL_RE.match(line)
+                if m:
+                    add_symbol(symbols, pending, int(m.group(1), 16), int(m.group(2), 16), m.group(3))
+                pending = None
+                continue
+            m = INPUT_RE.match(line)
+            if m:
+                add_symbol(symbols, m.group(1), int(m.group(2), 16), int(m.group(3), 16), m.group(4))
+                continue
+            m = INPUT_NAME_RE.match(line)
+            if m:
+                pending = m.group(1)
+    return sections, symbols
+
+
+def add_section(sections, name, addr, size):
+    if in_ram(addr) and size:
+        sections[name] = sections.get(name, 0) + size
+
+
+def add_symbol(symbols, name, addr, size, obj):
+    if not in_ram(addr) or size == 0:
+        return
+    for prefix in (".bss.", ".data.", ".noinit."):
+        if name.startswith(prefix):
+            name = name[len(prefix) :]
+            break
+    else:
+        name = f"{name} ({obj.replace(chr(92), '/').split('/')[-1]})"
+    symbols[name] = symbols.get(name, 0) + size
+
+
+def show_one(path, top):
+    sections, symbols = parse(path)
+    total = sum(sections.values())
+    print(f"{path}  RAM 合计 {total} 字节 ({total / RAM_SIZE:.1%})")
+    for name, size in sorted(sections.items(), key=lambda x: -x[1]):
+        print(f"  {name:24s} {size:8d}")
+    print(f"  占用最大的 {top} 个符号")
+    for name, size in sorted(symbols.items(), key=lambda x: -x[1])[:top]:
+        print(f"  {name:48s} {size:8d}")
+
+
+def show_diff(before, after, top):
+    sec_b, sym_b = parse(before)
+    sec_a, sym_a = parse(after)
+    total_b, total_a = sum(sec_b.values()), sum(sec_a.values())
+    print(f"RAM 合计 {total_b} -> {total_a} 字节  变化 {total_a - total_b:+d}")
+    for name in sorted(set(sec_b) | set(sec_a)):
+        b, a = sec_b.get(name, 0), sec_a.get(name, 0)
+        print(f"  {name:24s} {b:8d} -> {a:8d}  {a - b:+8d}")
+    changes = [(name, sym_b.get(name, 0), sym_a.get(name, 0)) for name in set(sym_b) | set(sym_a)]
+    changes = [c for c in changes if c[1] != c[2]]
+    changes.sort(key=lambda c: -abs(c[2] - c[1]))
+    print(f"  变化最大的 {top} 个符号 (共 {len(changes)} 个)")
+    for name, b, a in changes[:top]:
+        print(f"  {name:48s} {b:8d} -> {a:8d}  {a - b:+8d}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="链接映射文件 RAM 占用统计 与 对比")
+    parser.add_argument("maps", nargs="+", help="映射文件 一个为统计 两个为对比 (改动前 改动后)")
+    parser.add_argument("--top", type=int, default=30, help="列出符号个数")
+    args = parser.parse_args()
+
+    if len(args.maps) == 1:
+        show_one(args.maps[0], args.top)
+    elif len(args.maps) == 2:
+        show_diff(args.maps[0], args.maps[1], args.top)
+    else:
+        parser.error("最多两个映射文件")
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
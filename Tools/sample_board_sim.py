@@ -0,0 +1,287 @@
+"""
+采样板 (USART2 对端) 模拟器 与 采样数据记录 / 整个测试 耗时基准
+
+采样板行为 (与 comm_data.c 约定一致 主机模型见 Tools/host/model/sample_board.c)
+    回应 ACK  配置帧 0x26 记录 6 通道 [测试方法 波长 点数] 点数全 0 视为清除
+    LED 电压读取 0x32 回应 0x32  校正偏移量读取 0x36 回应 0xB4  白板放大倍数读取 0x37 回应 0x37  其余命令仅回应 ACK
+    杂散光 0x28 采样完成后 回应 0x34
+    采样触发 控制板 FRONT_STATUS 下降沿 白板 上升沿 PD  采样 --sample-ms 后 FRONT_TRIG_IN 下降沿 通知采样完成
+    每次 PD 采样完成 对未满点数的已配置通道 发送 0xB3 [点数 通道 累计数据]
+    数据格式 u16 u32 混合 (每点 PD u32 + 白板 u32 + 采样值 u16)
+故障注入 (N 从 1 起计 0 不注入)
+    --dup N           每 N 个 0xB3 以相同帧号重复发送一次
+    --bad-length N    每 N 个 0xB3 数据多 1 字节 (类型无法识别)
+    --oversize-at N   第 N 次 PD 的 0xB3 点数超出记录缓存 (u16 121 点 / u32 61 点 / 混合 24 点)
+    --error-at N      第 N 次 PD 以 0xB5 错误帧代替数据
+    --hang-at N       第 N 次 PD 起不再通知采样完成
+模式
+    缺省 主机构建 (CMakeLists.txt) sample_bench 实际固件源码 + FreeRTOS 主机移植 + 外设与器件模型 虚拟时间
+         protocol.c 调用 comm_Data_Sample_Data_Commit 经 --wrap 计时 每种格式一行
+         统计 整个测试耗时 首个数据 记录次数与返回类型 单次记录耗时 (实际路径 连续调用 主机 nS)
+    --port 实际串口 (pyserial) 连接控制板 USART2
+         FRONT_STATUS 接 CTS FRONT_TRIG_IN 接 RTS  无 GPIO 连线时 --trigger timer 按白板周期自行发送数据
+
+python sample_board_sim.py                                     # 三种格式 6 通道 各 6 点
+python sample_board_sim.py --format mix --points 20 --dup 3 --oversize-at 2
+python sample_board_sim.py --port COM5 --trigger timer --format u16
+"""
+
+import argparse
+import json
+import math
+import os
+import random
+import struct
+import subprocess
+import threading
+import time
+
+CMD_CONF = 0x26
+CMD_STRAY = 0x28
+CMD_LED_GET = 0x32
+CMD_OVER = 0x34
+CMD_OFFSET_GET = 0x36
+CMD_WHITE_MAGNIFY_GET = 0x37
+CMD_DATA = 0xB3
+CMD_OFFSET_RESP = 0xB4
+CMD_ERR = 0xB5
+
+DEVICE_ID_SAMP = 0x46
+
+FORMATS = ("u16", "u32", "mix")
+LIMIT = {"u16": 120, "u32": 60, "mix": 20}  # sComm_Data_Sample.raw_datas 240 字节 混合类型每点记录 12 字节
+OVERSIZE = {"u16": 121, "u32": 61, "mix": 24}
+
+HOST_BIN = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "_gate_build", "sample_bench")
+
+
+class SampleBoard:
+    """采样板 协议与采样行为 (实际串口)
+
+    send(cmd, data, dup) 发送接口 later(ms, fn) 定时接口 由传输方式提供
+    """
+
+    def __init__(self, fmt, rng, args, send, later):
+        self.fmt = fmt
+        self.rng = rng
+        self.args = args
+        self.send = send
+        self.later = later
+        self.conf = [(0, 0, 0)] * 6
+        self.series = [[] for _ in range(6)]
+        self.pd_count = 0
+        self.whites = [0] * 6
+        self.frames = 0
+        self.faults = dict(dup=0, bad_length=0, oversize=0, error=0, hang=0)
+        self.kinetics = [(rng.uniform(8000, 14000), rng.uniform(6000, 16000), rng.uniform(30000, 120000)) for _ in range(6)]
+
+    # 命令处理 对应 采样板固件 ---------------------------------------------------
+    def on_frame(self, frame):
+        cmd, data = frame[5], frame[6:-1]
+        if cmd == CMD_CONF and len(data) >= 18:
+            self.conf = [tuple(data[3 * i : 3 * i + 3]) for i in range(6)]
+            self.series = [[] for _ in range(6)]
+            self.pd_count = 0
+        elif cmd == CMD_LED_GET:
+            self.send(CMD_LED_GET, struct.pack("<3H", 1500, 1800, 2100))
+        elif cmd == CMD_OFFSET_GET:
+            self.send(CMD_OFFSET_RESP, struct.pack("<6H", *(self.rng.randint(180, 260) for _ in range(6))))
+        elif cmd == CMD_WHITE_MAGNIFY_GET:
+            self.send(CMD_WHITE_MAGNIFY_GET, struct.pack("<6I", *([10000] * 6)))
+        elif cmd == CMD_STRAY:
+            self.later(self.args.sample_ms, lambda: self.send(CMD_OVER, b""))
+
+    def trigger(self, white, done):
+        """FRONT_STATUS 边沿 white 下降沿白板 否则 上升沿 PD  done() FRONT_TRIG_IN 下降沿"""
+        if not white:
+            self.pd_count += 1
+        if self.args.hang_at and self.pd_count >= self.args.hang_at:
+            self.faults["hang"] += not white
+            return
+        jitter = self.rng.uniform(0, self.args.jitter)
+        self.later(self.args.sample_ms + jitter, lambda: self._sampled(white, done))
+
+    def _sampled(self, white, done):
+        if white:
+            for i in range(6):
+                self.whites[i] = 0x00400000 + self.rng.randint(-2000, 2000)
+        elif self.args.error_at and self.pd_count == self.args.error_at:
+            self.faults["error"] += 1
+            self.send(CMD_ERR, bytes([0x01, 0x00]))
+        else:
+            for i in range(6):
+                if self.conf[i][2] and len(self.series[i]) < min(self.conf[i][2], LIMIT[self.fmt]):
+                    self.series[i].append(self._point(i))
+                    self._send_series(i)
+        done()
+
+    def _point(self, i):
+        base, amp, tau = self.kinetics[i]
+        t = len(self.series[i]) * self.args.period
+        value = base + amp * (1 - math.exp(-t / tau)) + self.rng.gauss(0, 8)
+        return int(value * 256), self.whites[i], max(0, min(0xFFFF, int(value)))
+
+    def _send_series(self, i):
+        series = self.series[i]
+        num = len(series)
+        if self.args.oversize_at and self.pd_count == self.args.oversize_at:
+            self.faults["oversize"] += 1
+            num = OVERSIZE[self.fmt]
+            series = (series * num)[:num]
+        if self.fmt == "u16":
+            body = b"".join(struct.pack("<H", p[2]) for p in series)
+        elif self.fmt == "u32":
+            body = b"".join(struct.pack("<I", p[0]) for p in series)
+        else:
+            body = b"".join(struct.pack("<IIH", *p) for p in series)
+        self.frames += 1
+        if self.args.bad_length and self.frames % self.args.bad_length == 0:
+            self.faults["bad_length"] += 1
+            body += b"\x00"
+        dup = bool(self.args.dup) and self.frames % self.args.dup == 0
+        self.faults["dup"] += dup
+        self.send(CMD_DATA, bytes([num, i + 1]) + body, dup)
+
+
+def run_host(args, formats):
+    """主机构建 sample_bench 每种格式一行"""
+    if not os.path.exists(args.host_bin):
+        raise SystemExit(f"{args.host_bin} 不存在 先构建主机构建 (cmake -S . -B _gate_build && cmake --build _gate_build)")
+    print(
+        f"点数 {args.points} 故障注入 重复 {args.dup} 长度异常 {args.bad_length} 超出 {args.oversize_at} 错误帧 {args.error_at} 无响应 {args.hang_at}"
+    )
+    print(
+        f"{'格式':>4} {'测试S':>8} {'首个数据S':>9} {'记录':>5} {'拒绝':>5} {'未知':>5} {'平均nS':>7} {'最大nS':>7} {'连续nS':>7} {'次/S':>10}  错误码"
+    )
+    failed = 0
+    for fmt in formats:
+        points = min(args.points, LIMIT[fmt])
+        cmd = [args.host_bin, "-f", fmt, "-n", str(points), "-N", str(args.loops)]
+        cmd += ["-d", str(args.dup), "-B", str(args.bad_length), "-O", str(args.oversize_at), "-E", str(args.error_at), "-H", str(args.hang_at)]
+        proc = subprocess.run(cmd, capture_output=True, text=True)
+        lines = [line for line in proc.stdout.splitlines() if line.startswith("{")]
+        if not lines:
+            raise SystemExit(f"{args.host_bin} 无结果 (返回 {proc.returncode}) {proc.stderr.strip()}")
+        r = json.loads(lines[-1])
+        failed += not r["pass"]
+        print(
+            f"{fmt:>4} {r['end_ms'] / 1000:8.1f} {r['first_data_ms'] / 1000:9.1f} {r['commits']:5d} {r['commit_error']:5d} {r['commit_unknow']:5d} "
+            f"{r['commit_avg_ns']:7.0f} {r['commit_max_ns']:7d} {r['loop_ns']:7.0f} {r['loop_per_s']:10.0f}  {r['errors']}"
+            f"{'' if r['pass'] else '  ' + r['reason']}"
+        )
+    return 1 if failed else 0
+
+
+def run_port(args, fmt):
+    """实际串口 控制板 USART2 对端"""
+    jobs = []
+    cond = threading.Condition()
+
+    def on_frame(now, frame):  # 接收线程 不得在此等待 ACK
+        with cond:
+            jobs.append(frame)
+            cond.notify()
+
+    link = None
+
+    def send(cmd, data=b"", dup=False):
+        link.send(cmd, data)
+        if dup:
+            with link.lock:
+                link.ser.write(link.build(cmd, data, link.index))  # 相同帧号
+
+    def later(ms, fn):
+        timer = threading.Timer(ms / 1000, lambda: jobs_put(fn))
+        timer.daemon = True
+        timer.start()
+
+    def jobs_put(fn):
+        with cond:
+            jobs.append(fn)
+            cond.notify()
+
+    import assay_scenario  # PortLink
+
+    link = assay_scenario.PortLink(args.port, args.baud, on_frame, DEVICE_ID_SAMP)
+    board = SampleBoard(fmt, random.Random(args.seed), args, send, later)
+    link.ser.rts = False  # FRONT_TRIG_IN 空闲低电平
+    cts = link.ser.cts if args.trigger == "cts" else None
+    next_white = None
+    deadline = time.monotonic() + args.timeout
+
+    def done():
+        link.ser.rts = True  # 上升沿 开始 / 下降沿 完成
+        time.sleep(0.002)
+        link.ser.rts = False
+
+    print(f"采样板模拟 {args.port} {args.baud} 格式 {fmt} 触发 {args.trigger}  Ctrl+C 结束")
+    try:
+        while time.monotonic() < deadline:
+            with cond:
+                cond.wait(0.002)
+                pending, jobs[:] = jobs[:], []
+            for job in pending:
+                if callable(job):
+                    job()
+                    continue
+                board.on_frame(job)
+                if job[5] == CMD_CONF:
+                    print(f"{link.now() / 1000:8.2f} S 配置 {list(board.conf)}")
+                    if args.trigger == "timer" and any(c[2] for c in board.conf):
+                        next_white = time.monotonic() + args.pre_light / 1000
+            if args.trigger == "cts":
+                level = link.ser.cts
+                if level != cts:
+                    board.trigger(not level, done)  # 下降沿 白板 上升沿 PD
+                    cts = level
+            elif next_white is not None and time.monotonic() >= next_white:
+                board.trigger(True, lambda: None)
+                board.later(args.pd_delay, lambda: board.trigger(False, lambda: None))
+                next_white += args.period / 1000
+                if all(len(board.series[i]) >= min(board.conf[i][2], LIMIT[fmt]) for i in range(6)):
+                    next_white = None
+    except KeyboardInterrupt:
+        pass
+    finally:
+        link.close()
+    print(f"0xB3 发送 {board.frames} 帧 PD {board.pd_count} 次 重发 {link.retrans} 收到重复帧 {link.dup}")
+    print(f"故障注入 {' '.join(f'{k} {v}' for k, v in board.faults.items() if v) or '无'}")
+    if link.ack_latency:
+        lat = sorted(link.ack_latency)
+        print(f"ACK 延时 p50 {lat[len(lat) // 2]:.1f} mS 最大 {lat[-1]:.1f} mS")
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="采样板 (USART2 对端) 模拟器 与 采样数据记录基准")
+    parser.add_argument("--format", choices=FORMATS + ("all",), default="all", help="0xB3 数据格式")
+    parser.add_argument("--host-bin", default=HOST_BIN, help="主机构建 sample_bench 路径")
+    parser.add_argument("--points", type=int, default=6, help="主机构建 各通道点数 超出格式上限时取上限")
+    parser.add_argument("--loops", type=int, default=100000, help="主机构建 连续调用次数")
+    parser.add_argument("--port", help="串口名 或 pyserial URL 缺省使用主机构建")
+    parser.add_argument("--baud", type=int, default=115200, help="波特率 huart2")
+    parser.add_argument("--trigger", choices=("cts", "timer"), default="cts", help="实际串口 采样触发来源")
+    parser.add_argument("--timeout", type=float, default=3600, help="实际串口 运行时长 S")
+    parser.add_argument("--pre-light", type=float, default=15000, help="实际串口 定时触发 预先点灯 mS COMM_DATA_PRE_LIGHT_DEFAULT")
+    parser.add_argument("--period", type=float, default=10000, help="白板周期 mS COMM_DATA_WH_PERIOD_DEFAULT")
+    parser.add_argument("--pd-delay", type=float, default=400, help="实际串口 定时触发 白板至PD间隔 mS COMM_DATA_PD_DELAY_DEFAULT")
+    parser.add_argument("--sample-ms", type=float, default=120, help="实际串口 采样板单次采样耗时 mS")
+    parser.add_argument("--jitter", type=float, default=10, help="实际串口 采样耗时抖动 mS")
+    parser.add_argument("--dup", type=int, default=0, help="每 N 个 0xB3 重复发送一次")
+    parser.add_argument("--bad-length", type=int, default=0, help="每 N 个 0xB3 长度异常")
+    parser.add_argument("--oversize-at", type=int, default=0, help="第 N 次 PD 点数超出记录缓存")
+    parser.add_argument("--error-at", type=int, default=0, help="第 N 次 PD 发送错误帧")
+    parser.add_argument("--hang-at", type=int, default=0, help="第 N 次 PD 起不再通知采样完成")
+    parser.add_argument("--seed", type=int, default=1, help="实际串口 随机种子")
+    args = parser.parse_args()
+    if args.points < 1 or min(args.dup, args.bad_length, args.oversize_at, args.error_at, args.hang_at) < 0:
+        parser.error("点数至少 1 故障注入参数不小于 0")
+
+    formats = FORMATS if args.format == "all" else (args.format,)
+    if args.port:
+        return run_port(args, formats[0])
+    return run_host(args, formats)
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
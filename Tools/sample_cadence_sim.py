@@ -0,0 +1,129 @@
+"""
+采样节奏 提前结束 回放仿真 固定点数 与 读数稳定提前结束 对比
+
+判定规则与 Src/comm_data.c comm_Data_Sample_Stable_Check 一致
+    最近 N 组相邻点 |v[i] - v[i-1]| * 1000 <= v[i-1] * 千分比 视为稳定
+    全部通道稳定后 下一次白板采样时结束 (多采一次白板 不计点)
+耗时 = 预先点灯 + 点数 * 白板周期
+
+数据来源
+    --db  qt_frame 记录的 sqlite 数据库 (sample_data.py sample_datas 表 u16 数据) 逐条回放
+    缺省  合成曲线 终点法 指数趋近平台 速率法 线性 两点终点法 指数趋近 + 测量噪声 每条曲线重复 --repeat 次估计结果离散度
+
+结果值 取最后一点读数 (终点法) 速率法/两点终点法 同样列出 用于观察提前结束对其影响
+
+python sample_cadence_sim.py                            # 合成曲线 N=3 千分比 5
+python sample_cadence_sim.py --stable 4 --permille 3    # 更严格
+python sample_cadence_sim.py --db data/db.sqlite3       # 回放记录数据
+"""
+
+import argparse
+import math
+import random
+import sqlite3
+import statistics
+import struct
+
+METHODS = {1: "速率法", 2: "终点法", 3: "两点终点法"}
+METHOD_DB = {"rate": 1, "end_point": 2, "two_point": 3}
+
+
+def stable_stop(values, stable, permille):
+    """返回提前结束时的点数 不满足时返回总点数"""
+    if stable == 0:
+        return len(values)
+    for num in range(stable + 1, len(values) + 1):
+        ok = True
+        for i in range(num - stable, num):
+            prev, curr = values[i - 1], values[i]
+            if abs(curr - prev) * 1000 > prev * permille:
+                ok = False
+                break
+        if ok:
+            return num
+    return len(values)
+
+
+def load_db(path):
+    series = []
+    with sqlite3.connect(path) as conn:
+        for method, total, raw in conn.execute("SELECT method, total, raw_data FROM sample_datas"):
+            if method not in METHOD_DB or not total or raw is None or len(raw) != total * 2:
+                continue
+            series.append((METHOD_DB[method], [list(struct.unpack("<{}H".format(total), raw))]))
+    return series
+
+
+def synth(rng, args):
+    series = []
+    for n in range(args.curves):
+        method = (1, 2, 3)[n % 3]
+        points = 12 if method != 3 else 30
+        base, amp = rng.uniform(2000, 4000), rng.uniform(2000, 15000)
+        tau = rng.uniform(15, 120)
+        slope = rng.uniform(0, 40)
+        reps = []
+        for _ in range(args.repeat):
+            values = []
+            for i in range(points):
+                t = (i + 1) * args.period / 1000
+                if method == 1:
+                    v = base + slope * t
+                else:
+                    v = base + amp * (1 - math.exp(-t / tau))
+                values.append(max(0, int(round(v + rng.gauss(0, args.noise)))))
+            reps.append(values)
+        series.append((method, reps))
+    return series
+
+
+def main():
+    parser = argparse.ArgumentParser(description="采样节奏 提前结束 回放仿真")
+    parser.add_argument("--db", help="qt_frame 记录的 sqlite 数据库")
+    parser.add_argument("--stable", type=int, default=3, help="连续稳定点数 N")
+    parser.add_argument("--permille", type=int, default=5, help="相邻点相对偏差 千分比")
+    parser.add_argument("--period", type=int, default=10000, help="白板周期 mS")
+    parser.add_argument("--pre-light", type=int, default=15000, help="预先点灯 mS")
+    parser.add_argument("--curves", type=int, default=300, help="合成曲线条数")
+    parser.add_argument("--repeat", type=int, default=20, help="合成曲线 每条重复次数")
+    parser.add_argument("--noise", type=float, default=4.0, help="合成曲线 测量噪声 标准差")
+    parser.add_argument("--seed", type=int, default=0)
+    args = parser.parse_args()
+
+    series = load_db(args.db) if args.db else synth(random.Random(args.seed), args)
+    if not series:
+        print("无可回放数据")
+        return 1
+
+    for method, name in METHODS.items():
+        rows = [reps for m, reps in series if m == method]
+        if not rows:
+            continue
+        t_full, t_stop, stopped, total, bias, cv_full, cv_stop = 0.0, 0.0, 0, 0, [], [], []
+        for reps in rows:
+            full_res, stop_res = [], []
+            for values in reps:
+                num = stable_stop(values, args.stable, args.permille)
+                total += 1
+                stopped += num < len(values)
+                t_full += (args.pre_light + len(values) * args.period) / 1000
+                t_stop += (args.pre_light + num * args.period) / 1000
+                full_res.append(values[-1])
+                stop_res.append(values[num - 1])
+                if values[-1]:
+                    bias.append(values[num - 1] / values[-1] - 1)
+            if len(reps) > 1 and statistics.mean(full_res) > 0:
+                cv_full.append(statistics.pstdev(full_res) / statistics.mean(full_res))
+                cv_stop.append(statistics.pstdev(stop_res) / statistics.mean(stop_res))
+        line = "{:6s} 曲线 {:5d} 提前结束 {:6.1%}  平均耗时 {:6.1f} s -> {:6.1f} s  结果偏差 平均 {:+.3%} 最大 {:.3%}".format(
+            name, total, stopped / total, t_full / total, t_stop / total,
+            statistics.mean(bias) if bias else 0, max(abs(b) for b in bias) if bias else 0,
+        )
+        if cv_full:
+            line += "  重复CV {:.3%} -> {:.3%}".format(statistics.mean(cv_full), statistics.mean(cv_stop))
+        print(line)
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
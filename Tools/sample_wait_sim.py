@@ -0,0 +1,92 @@
+"""
+等待采样板数据 comm_Data_Wait_Data 主机端仿真 原有轮询 与 事件组唤醒 对比
+
+调用处 motor_Self_Check_PD / eMotor_Fun_SP_LED 每轮 motor_Sample_Deal 返回后 运动白板电机至白板位置 再等待上送
+    白板位置运动 已在白板位置时立即返回 (--move)
+    采样板上送 最后一次采样完成后 处理延时 (--latency) + 6个通道(405仅通道1)数据帧 115200 8N1 串行发送
+原有  检查一次 未到齐 vTaskDelay(200) 后 (循环条件反向) 直接返回 可能数据未到齐
+现有  采样数据帧处理中置位事件组 全部到齐即唤醒 超时 1200mS
+
+一次完整校正 = 三个波长 (610 550 6通道 405 1通道) PD自检各1轮 + LED校正 每波长 --led-rounds 轮
+正常测试流程 (motor_Sample_Deal 后直接由通知驱动) 不调用 comm_Data_Wait_Data 不受影响
+
+python sample_wait_sim.py                        # 默认 10000 次
+python sample_wait_sim.py --latency 100 300      # 采样板处理较慢
+"""
+
+import argparse
+import random
+
+BAUD = 115200
+FRAME_OVERHEAD = 7 + 2 + 1  # 帧头/长度/命令 通道/点数 校验
+TIMEOUT = 1.2
+POLL = 0.2
+CHANNELS = {"610": 6, "550": 6, "405": 1}
+
+
+def arrival(rng, args, channels, points):
+    """最后一帧到达时间 相对 motor_Sample_Deal 返回"""
+    frame = (FRAME_OVERHEAD + points * 2) * 10 / BAUD
+    return rng.uniform(*args.latency) / 1000 + channels * frame * (1 + rng.random() * args.gap)
+
+
+def wait_legacy(move, t):
+    """返回 (等待耗时 数据是否到齐)"""
+    if t <= move:
+        return 0.0, True
+    return POLL, t <= move + POLL
+
+
+def wait_event(move, t):
+    if t <= move:
+        return 0.0, True
+    if t - move > TIMEOUT:
+        return TIMEOUT, False
+    return t - move, True
+
+
+def run(rng, args):
+    rounds = []
+    for channels in CHANNELS.values():
+        rounds.append((channels, 1))  # PD自检 1点
+        rounds.extend([(channels, args.points)] * args.led_rounds)  # LED校正
+    result = {"legacy": [0.0, 0], "event": [0.0, 0]}
+    for channels, points in rounds:
+        move = args.move / 1000
+        t = arrival(rng, args, channels, points)
+        for key, fun in (("legacy", wait_legacy), ("event", wait_event)):
+            cost, ok = fun(move, t)
+            result[key][0] += cost
+            result[key][1] += 0 if ok else 1
+    return len(rounds), result
+
+
+def main():
+    parser = argparse.ArgumentParser(description="等待采样板数据 轮询/事件组 仿真")
+    parser.add_argument("--runs", type=int, default=10000, help="仿真次数")
+    parser.add_argument("--latency", type=float, nargs=2, default=(20, 120), help="采样板处理延时范围 毫秒")
+    parser.add_argument("--move", type=float, default=0, help="白板位置运动耗时 毫秒")
+    parser.add_argument("--points", type=int, default=1, help="LED校正点数")
+    parser.add_argument("--led-rounds", type=int, default=3, help="LED校正 每波长测试次数")
+    parser.add_argument("--gap", type=float, default=0.5, help="帧间隔 相对帧长 最大比例")
+    parser.add_argument("--seed", type=int, default=0)
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    total = {"legacy": [0.0, 0], "event": [0.0, 0]}
+    n = 0
+    for _ in range(args.runs):
+        rounds, result = run(rng, args)
+        n += rounds
+        for key in total:
+            total[key][0] += result[key][0]
+            total[key][1] += result[key][1]
+    for key, title in (("legacy", "原有轮询"), ("event", "事件唤醒")):
+        print("{} 每次完整校正 等待合计 {:6.1f} mS  每轮平均 {:6.1f} mS  数据未到齐 {:.2%}".format(
+            title, total[key][0] / args.runs * 1000, total[key][0] / n * 1000, total[key][1] / n))
+    print("每次完整校正 ({} 轮) 缩短 {:.1f} mS".format(n // args.runs, (total["legacy"][0] - total["event"][0]) / args.runs * 1000))
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -0,0 +1,342 @@
+"""
+se2707 ssi 报文解析 主机端测试
+
+以桩代替 HAL 及 FreeRTOS 将 Src/se2707.c 编译为动态库 通过 ctypes 调用
+    解析器 se2707_parser_feed / se2707_parser_idle 分段输入 干扰字节 校验错误 最大长度报文
+    异步接收 模拟DMA非循环模式写入 空闲中断及接收满回调 se2707_recv_pack 取得应答
+
+python se2707_parser_test.py             # 全部测试
+python se2707_parser_test.py --rounds 2000 --seed 3
+"""
+
+import argparse
+import ctypes
+import os
+import random
+import subprocess
+import sys
+import tempfile
+
+REPO = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+
+STUB_MAIN_H = r"""
+#ifndef __MAIN_H
+#define __MAIN_H
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define ARRAY_LEN(x) (sizeof(x) / sizeof((x)[0]))
+
+typedef enum { HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+typedef struct { uint32_t counter; } DMA_HandleTypeDef;
+typedef struct { DMA_HandleTypeDef * hdmarx; uint16_t RxXferCount; } UART_HandleTypeDef;
+
+typedef long BaseType_t;
+typedef void * SemaphoreHandle_t;
+typedef struct { uint32_t dummy; } StaticSemaphore_t;
+#define pdFALSE 0
+#define pdPASS 1
+#define pdMS_TO_TICKS(x) (x)
+
+extern uint32_t stub_sem;
+extern uint32_t stub_delay;
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef * huart, uint8_t * pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef * huart, uint8_t * pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef * huart, uint8_t * pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef * huart);
+BaseType_t stub_sem_take(void);
+
+#define HAL_Delay(x) (stub_delay += (x))
+#define vTaskDelay(x) (stub_delay += (x))
+#define __HAL_UART_FLUSH_DRREGISTER(h)
+#define __HAL_UART_CLEAR_OREFLAG(h)
+#define __HAL_UART_ENABLE_IT(h, it)
+#define __HAL_UART_DISABLE_IT(h, it)
+#define __HAL_DMA_GET_COUNTER(h) ((h)->counter)
+#define xSemaphoreCreateBinary() ((SemaphoreHandle_t)&stub_sem)
+#define xSemaphoreCreateBinaryStatic(b) ((void)(b), (SemaphoreHandle_t)&stub_sem)
+#define xSemaphoreTake(s, t) stub_sem_take()
+#define xSemaphoreGiveFromISR(s, w) (stub_sem = 1)
+#define portYIELD_FROM_ISR(x) ((void)(x))
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+#endif
+"""
+
+STUB_C = r"""
+#include "main.h"
+
+uint32_t stub_sem = 0;
+uint32_t stub_delay = 0;
+uint8_t * stub_dma_buffer = NULL;
+uint16_t stub_dma_size = 0;
+uint8_t stub_tx[512];
+uint16_t stub_tx_length = 0;
+DMA_HandleTypeDef stub_hdma = {0};
+UART_HandleTypeDef stub_huart = {&stub_hdma, 0};
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef * huart, uint8_t * pData, uint16_t Size, uint32_t Timeout)
+{
+    while (Size-- > 0 && stub_tx_length < sizeof(stub_tx)) {
+        stub_tx[stub_tx_length++] = *pData++;
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef * huart, uint8_t * pData, uint16_t Size, uint32_t Timeout)
+{
+    huart->RxXferCount = Size;
+    return HAL_TIMEOUT;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef * huart, uint8_t * pData, uint16_t Size)
+{
+    stub_dma_buffer = pData;
+    stub_dma_size = Size;
+    huart->hdmarx->counter = Size;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef * huart)
+{
+    return HAL_OK;
+}
+
+BaseType_t stub_sem_take(void)
+{
+    if (stub_sem) {
+        stub_sem = 0;
+        return pdPASS;
+    }
+    return pdFALSE;
+}
+"""
+
+PACK_MAX_LENGTH = 255 + 2
+CALLBACK = ctypes.CFUNCTYPE(None, ctypes.POINTER(ctypes.c_uint8), ctypes.c_uint16)
+
+
+class Parser(ctypes.Structure):
+    _fields_ = [("buffer", ctypes.c_uint8 * PACK_MAX_LENGTH), ("index", ctypes.c_uint16)]
+
+
+def build_library(workdir):
+    with open(os.path.join(workdir, "main.h"), "w") as f:
+        f.write(STUB_MAIN_H)
+    stub = os.path.join(workdir, "stub.c")
+    with open(stub, "w") as f:
+        f.write(STUB_C)
+    target = os.path.join(workdir, "libse2707.so")
+    cmd = ["gcc", "-shared", "-fPIC", "-fshort-enums", "-Wall", "-Werror", "-I", workdir, "-I", os.path.join(REPO, "Inc"),
+           os.path.join(REPO, "Src", "se2707.c"), stub, "-o", target]
+    subprocess.run(cmd, check=True)
+    return ctypes.CDLL(target)
+
+
+def checksum(data):
+    value = (0x10000 - sum(data)) & 0xFFFF
+    return bytes((value >> 8, value & 0xFF))
+
+
+def make_pack(cmd, status, payload=b""):
+    head = bytes((len(payload) + 4, cmd, 0x00, status)) + payload
+    return head + checksum(head)
+
+
+class Harness:
+    def __init__(self, lib):
+        self.lib = lib
+        self.packs = []
+        self.callback = CALLBACK(self.on_pack)
+        self.parser = Parser()
+        lib.se2707_parser_feed.restype = ctypes.c_uint16
+        lib.se2707_parser_idle.restype = ctypes.c_uint16
+        lib.se2707_recv_pack.restype = ctypes.c_uint16
+        lib.se2707_build_pack.restype = ctypes.c_uint16
+        lib.se2707_async_start.restype = ctypes.c_uint8
+        lib.se2707_async_is_active.restype = ctypes.c_uint8
+
+    def on_pack(self, pPack, length):
+        self.packs.append(bytes(pPack[:length]))
+
+    def reset(self):
+        self.packs = []
+        self.lib.se2707_parser_reset(ctypes.byref(self.parser))
+
+    def feed(self, data):
+        buf = (ctypes.c_uint8 * max(len(data), 1)).from_buffer_copy(data or b"\0")
+        return self.lib.se2707_parser_feed(ctypes.byref(self.parser), buf, len(data), self.callback)
+
+    def idle(self):
+        return self.lib.se2707_parser_idle(ctypes.byref(self.parser), self.callback)
+
+
+def fragments(data, rng, max_chunk):
+    pos = 0
+    while pos < len(data):
+        size = rng.randint(1, max_chunk)
+        yield data[pos:pos + size]
+        pos += size
+
+
+def test_build_pack(h):
+    out = (ctypes.c_uint8 * 16)()
+    payload = (ctypes.c_uint8 * 4)(0xFF, 0xF0, 0x32, 0x00)
+    length = h.lib.se2707_build_pack(0xC6, 0x08, payload, 4, out)
+    expect = bytes((0x08, 0xC6, 0x04, 0x08, 0xFF, 0xF0, 0x32, 0x00))
+    assert bytes(out[:length]) == expect + checksum(expect), "组包与参考实现不一致"
+
+
+def test_single(h):
+    ack = bytes((0x04, 0xD0, 0x00, 0x00, 0xFF, 0x2C))  # cSe2707_ACK_PACK
+    h.reset()
+    assert h.feed(ack) == 1 and h.packs == [ack]
+    h.reset()
+    assert sum(h.feed(ack[i:i + 1]) for i in range(len(ack))) == 1 and h.packs == [ack], "逐字节输入"
+
+
+def test_bad_checksum(h):
+    good = make_pack(0xC6, 0x00, bytes((0xFF, 0xF0, 0x32, 0x00)))
+    bad = bytearray(good)
+    bad[-1] ^= 0x5A
+    h.reset()
+    h.feed(bytes(bad) + good)
+    h.idle()
+    assert h.packs == [good], "校验错误后重新同步"
+
+
+def test_length_byte_garbage(h):
+    ack = make_pack(0xD0, 0x00)
+    h.reset()
+    h.feed(bytes((0x00, 0x01, 0x03)) + ack)
+    assert h.packs == [ack], "长度字节过小的干扰"
+    h.reset()
+    h.feed(bytes((0xF0,)) + ack)
+    assert h.packs == [], "长长度干扰 等待后续数据"
+    assert h.idle() == 1 and h.packs == [ack], "线路空闲后找回报文"
+    h.reset()
+    h.feed(ack[:3])
+    assert h.idle() == 0 and h.parser.index == 3, "未完整报文线路空闲时保留"
+    h.feed(ack[3:])
+    assert h.packs == [ack]
+
+
+def test_max_length(h, rng):
+    pack = make_pack(0xF3, 0x00, bytes(rng.randrange(256) for _ in range(251)))
+    assert len(pack) == PACK_MAX_LENGTH
+    h.reset()
+    for chunk in fragments(pack * 2, rng, 13):
+        h.feed(chunk)
+    assert h.packs == [pack, pack], "最大长度报文"
+
+
+def random_stream(rng, count):
+    packs, stream = [], b""
+    for _ in range(count):
+        if rng.random() < 0.3:  # 不足4的干扰字节 或 校验错误的报文
+            if rng.random() < 0.5:
+                stream += bytes(rng.randrange(4) for _ in range(rng.randint(1, 3)))
+            else:
+                bad = bytearray(make_pack(0xC6, 0x00, bytes(rng.randrange(256) for _ in range(rng.randint(0, 8)))))
+                bad[rng.randrange(1, len(bad))] ^= 1 << rng.randrange(8)
+                stream += bytes(bad[:-rng.randint(0, 1) or None])
+        pack = make_pack(rng.choice((0xD0, 0xD1, 0xC6, 0xF6, 0xA4)), rng.choice((0x00, 0x08)),
+                         bytes(rng.randrange(256) for _ in range(rng.randint(0, 20))))
+        packs.append(pack)
+        stream += pack
+    return packs, stream
+
+
+def check_stream(packs, stream, result):
+    """输出报文必须是流中连续且校验正确的字节 流中报文只在与偶然通过校验的干扰报文重叠时允许丢失"""
+    extra = []
+    for p in result:
+        assert p in stream and sum(p[:-2]) + (p[-2] << 8) + p[-1] & 0xFFFF == 0, "不得产生流中不存在的报文"
+        if p not in packs:
+            extra.append(p)
+    missing = [p for p in packs if p not in result]
+    assert len(missing) <= len(extra), "报文丢失 {}".format(stream.hex())
+    return len(extra)
+
+
+def test_random_fragments(h, rng, rounds):
+    extra = 0
+    for _ in range(rounds):
+        packs, stream = random_stream(rng, rng.randint(1, 8))
+        h.reset()
+        for chunk in fragments(stream, rng, 17):
+            h.feed(chunk)
+            if rng.random() < 0.2:
+                h.idle()
+        h.idle()
+        extra += check_stream(packs, stream, h.packs)
+    return extra
+
+
+def test_async(h, rng, rounds):
+    lib = h.lib
+    huart = ctypes.c_void_p.in_dll(lib, "stub_huart")
+    huart = ctypes.addressof(huart)
+    assert lib.se2707_async_start(ctypes.c_void_p(huart), h.callback) == 0
+    assert lib.se2707_async_is_active(ctypes.c_void_p(huart)) == 1
+    dma_buffer = ctypes.POINTER(ctypes.c_uint8).in_dll(lib, "stub_dma_buffer")
+    dma_size = ctypes.c_uint16.in_dll(lib, "stub_dma_size").value
+    counter = ctypes.c_uint32.in_dll(lib, "stub_hdma")
+    out = (ctypes.c_uint8 * 32)()
+    extra = 0
+
+    for _ in range(rounds):
+        h.packs = []
+        packs, stream = random_stream(rng, rng.randint(1, 6))
+        pos = dma_size - counter.value  # DMA 当前写入位置
+        for chunk in fragments(stream, rng, 11):
+            for byte in chunk:
+                dma_buffer[pos] = byte
+                pos += 1
+                counter.value = dma_size - pos
+                if pos == dma_size:  # 接收满 中断内重新启动
+                    lib.se2707_async_rx_cplt_FromISR()
+                    pos = 0
+            lib.se2707_async_rx_idle_FromISR()
+        extra += check_stream(packs, stream, h.packs)
+        length = lib.se2707_recv_pack(ctypes.c_void_p(huart), out, 32, 100)
+        assert bytes(out[:length]) == h.packs[-1][:32], "se2707_recv_pack 取得最近的报文"
+        assert lib.se2707_recv_pack(ctypes.c_void_p(huart), out, 32, 100) == 0, "无新报文时超时"
+
+    lib.se2707_async_stop()
+    assert lib.se2707_async_is_active(ctypes.c_void_p(huart)) == 0
+    return extra
+
+
+def main():
+    parser = argparse.ArgumentParser(description="se2707 ssi 报文解析测试")
+    parser.add_argument("--rounds", type=int, default=500, help="随机分段测试次数")
+    parser.add_argument("--seed", type=int, default=0)
+    args = parser.parse_args()
+    rng = random.Random(args.seed)
+
+    with tempfile.TemporaryDirectory() as workdir:
+        h = Harness(build_library(workdir))
+        tests = (
+            ("组包", lambda: test_build_pack(h)),
+            ("单个报文", lambda: test_single(h)),
+            ("校验错误", lambda: test_bad_checksum(h)),
+            ("干扰字节", lambda: test_length_byte_garbage(h)),
+            ("最大长度", lambda: test_max_length(h, rng)),
+            ("随机分段", lambda: test_random_fragments(h, rng, args.rounds)),
+            ("异步接收", lambda: test_async(h, rng, args.rounds)),
+        )
+        failed = 0
+        for title, fun in tests:
+            try:
+                extra = fun()
+                print("通过 {}{}".format(title, " 偶然通过校验的干扰报文 {}".format(extra) if extra else ""))
+            except AssertionError as e:
+                failed += 1
+                print("失败 {} {}".format(title, e))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())